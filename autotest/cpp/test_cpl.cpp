@@ -30,6 +30,7 @@
 #include <gdal_common.h>
 #include <string>
 #include <fstream>
+#include "cpl_atomic_ops.h"
 #include "cpl_list.h"
 #include "cpl_hash_set.h"
 #include "cpl_string.h"
@@ -833,4 +834,78 @@ namespace tut
         ensure( VSIGetDiskFreeSpace(".") == -1 || VSIGetDiskFreeSpace(".") >= 0 );
     }
 
+    // Test CPLAtomicAdd64()
+    template<>
+    template<>
+    void object::test<14>()
+    {
+        volatile GIntBig nVal = 0;
+        ensure_equals( CPLAtomicAdd64(&nVal, 1), 1 );
+        ensure_equals( CPLAtomicAdd64(&nVal, GINTBIG_MAX - 1), GINTBIG_MAX );
+        ensure_equals( CPLAtomicAdd64(&nVal, -GINTBIG_MAX), 0 );
+        ensure_equals( CPLAtomicAdd64(&nVal, -1), -1 );
+        ensure_equals( CPLAtomicAdd64(&nVal, 0), -1 );
+    }
+
+    // Test VSIReadDirCached()
+    template<>
+    template<>
+    void object::test<15>()
+    {
+        const char* pszDir = "/vsimem/test_cpl_15";
+        VSIMkdir(pszDir, 0755);
+        VSIFCloseL(VSIFOpenL(CPLFormFilename(pszDir, "a", NULL), "wb"));
+
+        CPLSetConfigOption("GDAL_READDIR_CACHE_TTL", "3600");
+        char** papszFiles = VSIReadDirCached(pszDir, 0);
+        ensure_equals( CSLCount(papszFiles), 1 );
+        CSLDestroy(papszFiles);
+
+        // Creation through VSIFileFromMemBuffer() invalidates the listing
+        VSIFCloseL(VSIFileFromMemBuffer(CPLFormFilename(pszDir, "b", NULL),
+                                        NULL, 0, FALSE));
+        papszFiles = VSIReadDirCached(pszDir, 0);
+        ensure_equals( CSLCount(papszFiles), 2 );
+        CSLDestroy(papszFiles);
+
+        // A different limit is a different listing
+        papszFiles = VSIReadDirCached(pszDir, 100);
+        ensure_equals( CSLCount(papszFiles), 2 );
+        CSLDestroy(papszFiles);
+
+        // Creation through VSIFOpenL() invalidates the listing
+        VSIFCloseL(VSIFOpenL(CPLFormFilename(pszDir, "c", NULL), "wb"));
+        papszFiles = VSIReadDirCached(pszDir, 100);
+        ensure_equals( CSLCount(papszFiles), 3 );
+        CSLDestroy(papszFiles);
+
+        // So do VSIUnlink() and VSIRename()
+        VSIUnlink(CPLFormFilename(pszDir, "a", NULL));
+        papszFiles = VSIReadDirCached(pszDir, 100);
+        ensure_equals( CSLCount(papszFiles), 2 );
+        ensure( CSLFindString(papszFiles, "a") < 0 );
+        CSLDestroy(papszFiles);
+        VSIRename(CPLFormFilename(pszDir, "b", NULL),
+                  CPLFormFilename(pszDir, "d", NULL));
+        papszFiles = VSIReadDirCached(pszDir, 100);
+        ensure_equals( CSLCount(papszFiles), 2 );
+        ensure( CSLFindString(papszFiles, "d") >= 0 );
+        CSLDestroy(papszFiles);
+
+        // Without TTL, the directory is always read
+        VSIFCloseL(VSIFileFromMemBuffer(CPLFormFilename(pszDir, "e", NULL),
+                                        NULL, 0, FALSE));
+        CPLSetConfigOption("GDAL_READDIR_CACHE_TTL", NULL);
+        papszFiles = VSIReadDirCached(pszDir, 100);
+        ensure_equals( CSLCount(papszFiles), 3 );
+        CSLDestroy(papszFiles);
+
+        VSIFlushReadDirCache();
+        papszFiles = VSIReadDir(pszDir);
+        for( char** papszIter = papszFiles; papszIter && *papszIter; ++papszIter )
+            VSIUnlink(CPLFormFilename(pszDir, *papszIter, NULL));
+        CSLDestroy(papszFiles);
+        VSIRmdir(pszDir);
+    }
+
 } // namespace tut
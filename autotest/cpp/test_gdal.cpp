@@ -33,9 +33,15 @@
 #include <tut.h>
 #include <gdal.h>
 #include <gdal_priv.h>
+#include <gdal_alg.h>
 #include <gdal_utils.h>
+#include <gdal_proxy.h>
+#include <ogr_srs_api.h>
+#include <cpl_multiproc.h>
 #include <string>
 #include <limits>
+#include <vector>
+#include <algorithm>
 
 namespace tut
 {
@@ -282,4 +288,1307 @@ namespace tut
         GetGDALDriverManager()->DeregisterDriver( poDriver );
         delete poDriver;
     }
+
+    // Test per-dataset block cache quota
+    template<> template<> void object::test<10>()
+    {
+        GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName("MEM");
+        ensure(poDriver != NULL);
+        // 256 blocks of 256 bytes
+        GDALDataset* poDS = poDriver->Create("", 256, 256, 1, GDT_Byte, NULL);
+        ensure(poDS != NULL);
+        GDALRasterBand* poBand = poDS->GetRasterBand(1);
+        ensure_equals(poDS->GetCacheQuota(), 0);
+        ensure_equals(poDS->GetCacheUsed(), 0);
+        for( int i = 0; i < 64; i++ )
+        {
+            GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, i);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+        }
+        ensure_equals(poDS->GetCacheUsed(), 64 * 256);
+
+        // Lowering the quota evicts blocks immediately
+        poDS->SetCacheQuota(16 * 256);
+        ensure_equals(poDS->GetCacheQuota(), 16 * 256);
+        ensure_equals(poDS->GetCacheUsed(), 16 * 256);
+
+        // And new blocks never make the dataset exceed its quota
+        for( int i = 64; i < 256; i++ )
+        {
+            GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, i);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+            ensure(poDS->GetCacheUsed() <= 16 * 256);
+        }
+        ensure_equals(poDS->GetCacheUsed(), 16 * 256);
+
+        poBand->FlushCache();
+        ensure_equals(poDS->GetCacheUsed(), 0);
+        GDALClose(poDS);
+
+        // Generic open options
+        const char* const apszOptions[] = { "CACHE_QUOTA=1", "CACHE_PRIORITY=LOW", NULL };
+        GDALDatasetH hDS = GDALOpenEx("../gcore/data/byte.tif", GDAL_OF_RASTER,
+                                      NULL, apszOptions, NULL);
+        ensure(hDS != NULL);
+        ensure_equals(GDALDatasetGetCacheQuota(hDS), 1024 * 1024);
+        ensure_equals(GDALDatasetGetCachePriority(hDS), GCPRIO_LOW);
+        GDALClose(hDS);
+    }
+
+    // Test block cache priority classes
+    template<> template<> void object::test<11>()
+    {
+        const GIntBig nOldCacheMax = GDALGetCacheMax64();
+        GDALSetCacheMax64(64 * 256);
+
+        GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName("MEM");
+        ensure(poDriver != NULL);
+        GDALDataset* poLowDS = poDriver->Create("", 256, 256, 1, GDT_Byte, NULL);
+        GDALDataset* poHighDS = poDriver->Create("", 256, 256, 1, GDT_Byte, NULL);
+        ensure(poLowDS != NULL);
+        ensure(poHighDS != NULL);
+        poLowDS->SetCachePriority(GCPRIO_LOW);
+        poHighDS->SetCachePriority(GCPRIO_HIGH);
+        ensure_equals(poHighDS->GetCachePriority(), GCPRIO_HIGH);
+
+        for( int i = 0; i < 32; i++ )
+        {
+            GDALRasterBlock* poBlock =
+                poHighDS->GetRasterBand(1)->GetLockedBlockRef(0, i);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+        }
+        // Scan a dataset that would flush the whole cache on its own
+        for( int i = 0; i < 256; i++ )
+        {
+            GDALRasterBlock* poBlock =
+                poLowDS->GetRasterBand(1)->GetLockedBlockRef(0, i);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+        }
+        ensure_equals(poHighDS->GetCacheUsed(), 32 * 256);
+        ensure(poLowDS->GetCacheUsed() <= 32 * 256);
+
+        // Cached blocks move to the new class of their dataset when used again
+        poHighDS->SetCachePriority(GCPRIO_LOW);
+        for( int i = 0; i < 32; i++ )
+        {
+            GDALRasterBlock* poBlock =
+                poHighDS->GetRasterBand(1)->GetLockedBlockRef(0, i);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+        }
+        GDALDataset* poNormalDS = poDriver->Create("", 256, 256, 1, GDT_Byte, NULL);
+        ensure(poNormalDS != NULL);
+        for( int i = 0; i < 256; i++ )
+        {
+            GDALRasterBlock* poBlock =
+                poNormalDS->GetRasterBand(1)->GetLockedBlockRef(0, i);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+        }
+        ensure(poHighDS->GetCacheUsed() < 32 * 256);
+        GDALClose(poNormalDS);
+
+        GDALClose(poLowDS);
+        GDALClose(poHighDS);
+        GDALSetCacheMax64(nOldCacheMax);
+    }
+
+    // Test block cache statistics
+    template<> template<> void object::test<12>()
+    {
+        const GIntBig nOldCacheMax = GDALGetCacheMax64();
+        GDALSetCacheMax64(64 * 256);
+
+        GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName("MEM");
+        ensure(poDriver != NULL);
+        GDALDataset* poDS = poDriver->Create("", 256, 256, 1, GDT_Byte, NULL);
+        ensure(poDS != NULL);
+        GDALRasterBand* poBand = poDS->GetRasterBand(1);
+
+        GDALCacheStatistics sStats;
+        poBand->GetCacheStatistics(&sStats);
+        ensure_equals(sStats.nHits, 0);
+        ensure_equals(sStats.nMisses, 0);
+
+        GDALResetCacheStatistics();
+        for( int i = 0; i < 2; i++ )
+        {
+            GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, 0);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+        }
+        GDALGetRasterBandCacheStatistics((GDALRasterBandH)poBand, &sStats);
+        ensure_equals(sStats.nHits, 1);
+        ensure_equals(sStats.nMisses, 1);
+        ensure_equals(sStats.nBytesRead, 256);
+        ensure_equals(sStats.nEvictions, 0);
+
+        // Read more blocks than the cache can hold
+        for( int i = 1; i < 128; i++ )
+        {
+            GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, i);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+        }
+        poBand->GetCacheStatistics(&sStats);
+        ensure_equals(sStats.nMisses, 128);
+        ensure_equals(sStats.nBytesRead, 128 * 256);
+        ensure_equals(sStats.nEvictions, 64);
+
+        GDALCacheStatistics sGlobalStats;
+        GDALGetCacheStatistics(&sGlobalStats);
+        ensure_equals(sGlobalStats.nHits, sStats.nHits);
+        ensure_equals(sGlobalStats.nMisses, sStats.nMisses);
+        ensure_equals(sGlobalStats.nEvictions, sStats.nEvictions);
+
+        GDALResetCacheStatistics();
+        GDALGetCacheStatistics(&sGlobalStats);
+        ensure_equals(sGlobalStats.nMisses, 0);
+        poBand->GetCacheStatistics(&sStats);
+        ensure_equals(sStats.nMisses, 128);
+
+        GDALClose(poDS);
+        GDALSetCacheMax64(nOldCacheMax);
+    }
+
+    static int CPL_STDCALL StopAfterFirstSwathProgress( double dfComplete,
+                                                        const char*, void* )
+    {
+        return dfComplete == 0.0;
+    }
+
+    // Test pipelined GDALDatasetCopyWholeRaster()
+    template<> template<> void object::test<13>()
+    {
+        GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName("MEM");
+        ensure(poDriver != NULL);
+        GDALDataset* poSrcDS = poDriver->Create("", 1000, 2000, 2, GDT_Byte, NULL);
+        ensure(poSrcDS != NULL);
+        for( int iBand = 0; iBand < 2; iBand++ )
+        {
+            GByte abyLine[1000];
+            for( int iY = 0; iY < 2000; iY++ )
+            {
+                for( int iX = 0; iX < 1000; iX++ )
+                    abyLine[iX] = (GByte)(iX * iY + iBand);
+                ensure_equals(poSrcDS->GetRasterBand(iBand + 1)->RasterIO(
+                    GF_Write, 0, iY, 1000, 1, abyLine, 1000, 1, GDT_Byte,
+                    0, 0, NULL), CE_None);
+            }
+        }
+
+        const char* const apszInterleaves[] = { "BAND", "PIXEL" };
+        const char* const apszThreads[] = { "2", "4" };
+        for( int i = 0; i < 2; i++ )
+        {
+            for( int j = 0; j < 2; j++ )
+            {
+                GDALDataset* poDstDS = poDriver->Create("", 1000, 2000, 2,
+                                                        GDT_Float32, NULL);
+                ensure(poDstDS != NULL);
+                char** papszOptions = NULL;
+                papszOptions = CSLSetNameValue(papszOptions, "INTERLEAVE",
+                                               apszInterleaves[i]);
+                papszOptions = CSLSetNameValue(papszOptions, "NUM_THREADS",
+                                               apszThreads[j]);
+                ensure_equals(GDALDatasetCopyWholeRaster(
+                    (GDALDatasetH)poSrcDS, (GDALDatasetH)poDstDS,
+                    papszOptions, NULL, NULL), CE_None);
+                for( int iBand = 0; iBand < 2; iBand++ )
+                {
+                    ensure_equals(GDALChecksumImage(
+                        poDstDS->GetRasterBand(iBand + 1), 0, 0, 1000, 2000),
+                        GDALChecksumImage(
+                        poSrcDS->GetRasterBand(iBand + 1), 0, 0, 1000, 2000));
+                }
+
+                // Interruption must not leave threads behind
+                CPLPushErrorHandler(CPLQuietErrorHandler);
+                ensure_equals(GDALDatasetCopyWholeRaster(
+                    (GDALDatasetH)poSrcDS, (GDALDatasetH)poDstDS,
+                    papszOptions, StopAfterFirstSwathProgress, NULL),
+                    CE_Failure);
+                CPLPopErrorHandler();
+                ensure_equals(CPLGetLastErrorNo(), CPLE_UserInterrupt);
+                CPLErrorReset();
+
+                CSLDestroy(papszOptions);
+                GDALClose(poDstDS);
+            }
+        }
+        GDALClose(poSrcDS);
+    }
+
+    // Test GDALRasterBandGetLockedWindow()
+    template<> template<> void object::test<14>()
+    {
+        GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName("GTiff");
+        ensure(poDriver != NULL);
+        char** papszOptions = CSLSetNameValue(NULL, "TILED", "YES");
+        GDALDataset* poDS = poDriver->Create("/vsimem/test_gdal_14.tif",
+                                             300, 300, 1, GDT_UInt16,
+                                             papszOptions);
+        CSLDestroy(papszOptions);
+        ensure(poDS != NULL);
+        GUInt16 anLine[300];
+        for( int iY = 0; iY < 300; iY++ )
+        {
+            for( int iX = 0; iX < 300; iX++ )
+                anLine[iX] = (GUInt16)(iX + iY * 300);
+            ensure_equals(poDS->GetRasterBand(1)->RasterIO(
+                GF_Write, 0, iY, 300, 1, anLine, 300, 1, GDT_UInt16,
+                0, 0, NULL), CE_None);
+        }
+        GDALClose(poDS);
+
+        GDALRasterBandH hBand;
+        GDALDatasetH hDS = GDALOpen("/vsimem/test_gdal_14.tif", GA_ReadOnly);
+        ensure(hDS != NULL);
+        hBand = GDALGetRasterBand(hDS, 1);
+
+        // Window in the partial bottom right tile
+        GSpacing nPixelSpace = 0;
+        GSpacing nLineSpace = 0;
+        void* hLock = NULL;
+        const GByte* pabyData = (const GByte*)GDALRasterBandGetLockedWindow(
+            hBand, 260, 270, 30, 20, &nPixelSpace, &nLineSpace, &hLock);
+        ensure(pabyData != NULL);
+        ensure(hLock != NULL);
+        ensure_equals(nPixelSpace, 2);
+        ensure_equals(nLineSpace, 256 * 2);
+        for( int iY = 0; iY < 20; iY++ )
+        {
+            for( int iX = 0; iX < 30; iX++ )
+            {
+                ensure_equals(*(const GUInt16*)(pabyData + iY * nLineSpace +
+                                                iX * nPixelSpace),
+                              (GUInt16)(260 + iX + (270 + iY) * 300));
+            }
+        }
+
+        // The block is pinned while the window is in use
+        GDALRasterBlock* poBlock = (GDALRasterBlock*)hLock;
+        ensure_equals(poBlock->AddLock(), 2);
+        poBlock->DropLock();
+        GDALRasterBandReleaseLockedWindow(hLock);
+        ensure_equals(poBlock->AddLock(), 1);
+        poBlock->DropLock();
+
+        // Another window of the same block is served from the cache
+        GDALCacheStatistics sStats;
+        GDALGetRasterBandCacheStatistics(hBand, &sStats);
+        const GIntBig nHits = sStats.nHits;
+        pabyData = (const GByte*)GDALRasterBandGetLockedWindow(
+            hBand, 256, 256, 1, 1, &nPixelSpace, &nLineSpace, &hLock);
+        ensure(pabyData != NULL);
+        ensure_equals(*(const GUInt16*)pabyData, (GUInt16)(256 + 256 * 300));
+        GDALRasterBandReleaseLockedWindow(hLock);
+        GDALGetRasterBandCacheStatistics(hBand, &sStats);
+        ensure_equals(sStats.nHits, nHits + 1);
+
+        // Window spanning several blocks: fallback to RasterIO()
+        CPLErrorReset();
+        pabyData = (const GByte*)GDALRasterBandGetLockedWindow(
+            hBand, 250, 0, 10, 1, &nPixelSpace, &nLineSpace, &hLock);
+        ensure(pabyData == NULL);
+        ensure(hLock == NULL);
+        ensure_equals(CPLGetLastErrorType(), CE_None);
+
+        // Invalid window
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        pabyData = (const GByte*)GDALRasterBandGetLockedWindow(
+            hBand, 290, 0, 11, 1, &nPixelSpace, &nLineSpace, &hLock);
+        CPLPopErrorHandler();
+        ensure(pabyData == NULL);
+        ensure_equals(CPLGetLastErrorType(), CE_Failure);
+        CPLErrorReset();
+
+        GDALClose(hDS);
+        VSIUnlink("/vsimem/test_gdal_14.tif");
+    }
+
+    // Compute the checksums of the overviews of hSrcDS regenerated in MEM
+    // datasets, band by band or with GDALRegenerateOverviewsMultiBand()
+    static std::vector<int> GetOverviewChecksums(GDALDatasetH hSrcDS,
+                                                 const char* pszResampling,
+                                                 bool bMultiBand)
+    {
+        const int nOvrCount = 3;
+        const int nBands = GDALGetRasterCount(hSrcDS);
+        GDALDriverH hMEMDrv = GDALGetDriverByName("MEM");
+        GDALDatasetH ahOvrDS[nOvrCount];
+        for( int i = 0; i < nOvrCount; i++ )
+        {
+            ahOvrDS[i] = GDALCreate(hMEMDrv, "",
+                                    (GDALGetRasterXSize(hSrcDS) + (2 << i) - 1) / (2 << i),
+                                    (GDALGetRasterYSize(hSrcDS) + (2 << i) - 1) / (2 << i),
+                                    nBands,
+                                    GDALGetRasterDataType(GDALGetRasterBand(hSrcDS, 1)),
+                                    NULL);
+        }
+
+        CPLErr eErr = CE_None;
+        if( bMultiBand )
+        {
+            std::vector<GDALRasterBand*> apoSrcBands;
+            std::vector< std::vector<GDALRasterBand*> > aapoOvrBands(nBands);
+            std::vector<GDALRasterBand**> apapoOvrBands;
+            for( int iBand = 0; iBand < nBands; iBand++ )
+            {
+                apoSrcBands.push_back(
+                    (GDALRasterBand*)GDALGetRasterBand(hSrcDS, iBand + 1));
+                for( int i = 0; i < nOvrCount; i++ )
+                    aapoOvrBands[iBand].push_back(
+                        (GDALRasterBand*)GDALGetRasterBand(ahOvrDS[i], iBand + 1));
+                apapoOvrBands.push_back(&aapoOvrBands[iBand][0]);
+            }
+            eErr = GDALRegenerateOverviewsMultiBand(nBands, &apoSrcBands[0],
+                                                    nOvrCount, &apapoOvrBands[0],
+                                                    pszResampling, NULL, NULL);
+        }
+        else
+        {
+            for( int iBand = 0; iBand < nBands && eErr == CE_None; iBand++ )
+            {
+                GDALRasterBandH ahOvrBands[nOvrCount];
+                for( int i = 0; i < nOvrCount; i++ )
+                    ahOvrBands[i] = GDALGetRasterBand(ahOvrDS[i], iBand + 1);
+                eErr = GDALRegenerateOverviews(GDALGetRasterBand(hSrcDS, iBand + 1),
+                                               nOvrCount, ahOvrBands,
+                                               pszResampling, NULL, NULL);
+            }
+        }
+        ensure_equals(eErr, CE_None);
+
+        std::vector<int> anChecksums;
+        for( int i = 0; i < nOvrCount; i++ )
+        {
+            for( int iBand = 0; iBand < nBands; iBand++ )
+            {
+                GDALRasterBandH hBand = GDALGetRasterBand(ahOvrDS[i], iBand + 1);
+                anChecksums.push_back(GDALChecksumImage(hBand, 0, 0,
+                                                        GDALGetRasterBandXSize(hBand),
+                                                        GDALGetRasterBandYSize(hBand)));
+            }
+            GDALClose(ahOvrDS[i]);
+        }
+        return anChecksums;
+    }
+
+    // Test that multi-threaded overview generation gives the same result
+    // as the single-threaded one
+    template<> template<> void object::test<15>()
+    {
+        GDALDriverH hMEMDrv = GDALGetDriverByName("MEM");
+        const int nXSize = 517;
+        const int nYSize = 1031;
+        GDALDatasetH hSrcDS = GDALCreate(hMEMDrv, "", nXSize, nYSize, 2,
+                                         GDT_Byte, NULL);
+        std::vector<GByte> abyLine(nXSize);
+        unsigned int nSeed = 1;
+        for( int iBand = 0; iBand < 2; iBand++ )
+        {
+            for( int iY = 0; iY < nYSize; iY++ )
+            {
+                for( int iX = 0; iX < nXSize; iX++ )
+                {
+                    nSeed = nSeed * 1103515245U + 12345U;
+                    abyLine[iX] = (GByte)((iX + iY + (nSeed >> 16)) & 255);
+                }
+                ensure_equals(
+                    GDALRasterIO(GDALGetRasterBand(hSrcDS, iBand + 1), GF_Write,
+                                 0, iY, nXSize, 1, &abyLine[0], nXSize, 1,
+                                 GDT_Byte, 0, 0), CE_None);
+            }
+        }
+
+        const char* apszResampling[] = { "NEAREST", "AVERAGE", "GAUSS",
+                                         "CUBIC", "MODE" };
+        for( int iNoData = 0; iNoData < 2; iNoData++ )
+        {
+            if( iNoData == 1 )
+            {
+                GDALSetRasterNoDataValue(GDALGetRasterBand(hSrcDS, 1), 0);
+                GDALSetRasterNoDataValue(GDALGetRasterBand(hSrcDS, 2), 0);
+            }
+            for( size_t i = 0;
+                 i < sizeof(apszResampling) / sizeof(apszResampling[0]); i++ )
+            {
+                for( int iMultiBand = 0; iMultiBand < 2; iMultiBand++ )
+                {
+                    const bool bMultiBand = iMultiBand == 1;
+                    // MODE is not supported by the multiband code path
+                    if( bMultiBand && EQUAL(apszResampling[i], "MODE") )
+                        continue;
+
+                    CPLSetConfigOption("GDAL_NUM_THREADS", NULL);
+                    std::vector<int> anRef = GetOverviewChecksums(
+                        hSrcDS, apszResampling[i], bMultiBand);
+                    CPLSetConfigOption("GDAL_NUM_THREADS", "4");
+                    std::vector<int> anMT = GetOverviewChecksums(
+                        hSrcDS, apszResampling[i], bMultiBand);
+                    CPLSetConfigOption("GDAL_NUM_THREADS", NULL);
+                    ensure(CPLSPrintf("%s, multiband=%d, nodata=%d",
+                                      apszResampling[i], iMultiBand, iNoData),
+                           anRef == anMT);
+                }
+            }
+        }
+
+        GDALClose(hSrcDS);
+    }
+
+    // Test that the single pass generation of cascaded overviews gives
+    // the same result as the level by level generation
+    template<> template<> void object::test<16>()
+    {
+        GDALDriverH hGTiffDrv = GDALGetDriverByName("GTiff");
+        const int nXSize = 1000;
+        const int nYSize = 777;
+        const GDALDataType aeTypes[] = { GDT_Byte, GDT_UInt16, GDT_Float32 };
+        for( size_t iType = 0; iType < sizeof(aeTypes) / sizeof(aeTypes[0]);
+             iType++ )
+        {
+            char** papszOptions = CSLSetNameValue(NULL, "TILED", "YES");
+            GDALDatasetH hSrcDS = GDALCreate(hGTiffDrv,
+                                             "/vsimem/test_gdal_16.tif",
+                                             nXSize, nYSize, 1, aeTypes[iType],
+                                             papszOptions);
+            CSLDestroy(papszOptions);
+            ensure(hSrcDS != NULL);
+            std::vector<float> afLine(nXSize);
+            unsigned int nSeed = 1;
+            for( int iY = 0; iY < nYSize; iY++ )
+            {
+                for( int iX = 0; iX < nXSize; iX++ )
+                {
+                    nSeed = nSeed * 1103515245U + 12345U;
+                    afLine[iX] = (float)((iX * iY / 16 + (nSeed >> 16)) % 255);
+                }
+                ensure_equals(
+                    GDALRasterIO(GDALGetRasterBand(hSrcDS, 1), GF_Write,
+                                 0, iY, nXSize, 1, &afLine[0], nXSize, 1,
+                                 GDT_Float32, 0, 0), CE_None);
+            }
+
+            const char* apszResampling[] = { "AVERAGE", "GAUSS", "CUBIC",
+                                             "BILINEAR", "LANCZOS" };
+            for( size_t i = 0;
+                 i < sizeof(apszResampling) / sizeof(apszResampling[0]); i++ )
+            {
+                CPLSetConfigOption("GDAL_OVR_STREAMING", "NO");
+                std::vector<int> anRef = GetOverviewChecksums(
+                    hSrcDS, apszResampling[i], false);
+                CPLSetConfigOption("GDAL_OVR_STREAMING", NULL);
+                std::vector<int> anStreaming = GetOverviewChecksums(
+                    hSrcDS, apszResampling[i], false);
+                ensure(CPLSPrintf("%s, %s", apszResampling[i],
+                                  GDALGetDataTypeName(aeTypes[iType])),
+                       anRef == anStreaming);
+            }
+
+            GDALClose(hSrcDS);
+        }
+        VSIUnlink("/vsimem/test_gdal_16.tif");
+    }
+
+    static int nSignatureDriverOpenCount = 0;
+
+    static GDALDataset* SignatureDriverOpen(GDALOpenInfo*)
+    {
+        nSignatureDriverOpenCount ++;
+        return NULL;
+    }
+
+    // Test that GDALOpenEx() only tries drivers whose signature matches
+    template<> template<> void object::test<17>()
+    {
+        GDALDriver* poDriver = new GDALDriver();
+        poDriver->SetDescription("TestSignature");
+        poDriver->SetMetadataItem(GDAL_DCAP_RASTER, "YES");
+        poDriver->SetMetadataItem(GDAL_DMD_SIGNATURES, "DEADBEEF CAFE");
+        poDriver->pfnOpen = SignatureDriverOpen;
+        GetGDALDriverManager()->RegisterDriver( poDriver );
+
+        const GByte abyContent[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0, 0, 0, 0 };
+        VSIFCloseL(VSIFileFromMemBuffer("/vsimem/test_gdal_17.bin",
+                                        (GByte*)abyContent,
+                                        sizeof(abyContent), FALSE));
+
+        nSignatureDriverOpenCount = 0;
+        GDALDatasetH hDS = GDALOpen("/vsimem/test_gdal_17.bin", GA_ReadOnly);
+        ensure(hDS == NULL);
+        ensure_equals(nSignatureDriverOpenCount, 1);
+
+        // Header not matching the signature
+        hDS = GDALOpen("../gcore/data/byte.tif", GA_ReadOnly);
+        ensure(hDS != NULL);
+        GDALClose(hDS);
+        ensure_equals(nSignatureDriverOpenCount, 1);
+
+        // Header too short for DEADBEEF, but matching CAFE
+        const GByte abyShort[] = { 0xCA, 0xFE, 0xDE };
+        VSIFCloseL(VSIFileFromMemBuffer("/vsimem/test_gdal_17.bin",
+                                        (GByte*)abyShort,
+                                        sizeof(abyShort), FALSE));
+        hDS = GDALOpen("/vsimem/test_gdal_17.bin", GA_ReadOnly);
+        ensure(hDS == NULL);
+        ensure_equals(nSignatureDriverOpenCount, 2);
+
+        // Non existing file: all drivers are tried
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        hDS = GDALOpen("/vsimem/i_do_not_exist.bin", GA_ReadOnly);
+        CPLPopErrorHandler();
+        ensure(hDS == NULL);
+        ensure_equals(nSignatureDriverOpenCount, 3);
+
+        // Unrecognized file, with and without linear scan of all drivers
+        const GByte abyUnknown[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        VSIFCloseL(VSIFileFromMemBuffer("/vsimem/test_gdal_17.bin",
+                                        (GByte*)abyUnknown,
+                                        sizeof(abyUnknown), FALSE));
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        hDS = GDALOpen("/vsimem/test_gdal_17.bin", GA_ReadOnly);
+        ensure(hDS == NULL);
+        ensure_equals(nSignatureDriverOpenCount, 3);
+        CPLSetConfigOption("GDAL_OPEN_USE_SIGNATURES", "NO");
+        hDS = GDALOpen("/vsimem/test_gdal_17.bin", GA_ReadOnly);
+        CPLSetConfigOption("GDAL_OPEN_USE_SIGNATURES", NULL);
+        CPLPopErrorHandler();
+        ensure(hDS == NULL);
+        ensure_equals(nSignatureDriverOpenCount, 4);
+
+        // Candidates for a TIFF header
+        const GByte abyTIFF[] = { 'I', 'I', 42, 0 };
+        std::vector<GDALDriver*> apoDrivers;
+        GetGDALDriverManager()->GetOpenCandidateDrivers(abyTIFF, 4, apoDrivers);
+        ensure(std::find(apoDrivers.begin(), apoDrivers.end(),
+                         (GDALDriver*)GDALGetDriverByName("GTiff")) != apoDrivers.end());
+        ensure(std::find(apoDrivers.begin(), apoDrivers.end(),
+                         poDriver) == apoDrivers.end());
+        if( GDALGetDriverByName("PNG") )
+            ensure(std::find(apoDrivers.begin(), apoDrivers.end(),
+                             (GDALDriver*)GDALGetDriverByName("PNG")) == apoDrivers.end());
+        ensure(std::find(apoDrivers.begin(), apoDrivers.end(),
+                         (GDALDriver*)GDALGetDriverByName("MEM")) != apoDrivers.end());
+
+        GetGDALDriverManager()->DeregisterDriver( poDriver );
+        delete poDriver;
+
+        // Once deregistered, the driver is no longer indexed
+        const GByte abyDEADBEEF[] = { 0xDE, 0xAD, 0xBE, 0xEF };
+        const GByte abyZero[] = { 0, 0, 0, 0 };
+        GetGDALDriverManager()->GetOpenCandidateDrivers(abyDEADBEEF, 4, apoDrivers);
+        const size_t nCandidates = apoDrivers.size();
+        GetGDALDriverManager()->GetOpenCandidateDrivers(abyZero, 4, apoDrivers);
+        ensure_equals(nCandidates, apoDrivers.size());
+
+        VSIUnlink("/vsimem/test_gdal_17.bin");
+    }
+
+    static int nInitMetadataCount = 0;
+
+    static void LazyDriverInitMetadata(GDALDriver* poDriver)
+    {
+        nInitMetadataCount ++;
+        poDriver->SetMetadataItem(GDAL_DMD_LONGNAME, "Lazy driver");
+        poDriver->SetMetadataItem(GDAL_DMD_CREATIONOPTIONLIST,
+                                  "<CreationOptionList/>");
+    }
+
+    static void LazyDriverReadMetadata(void* pData)
+    {
+        GDALDriver* poDriver = static_cast<GDALDriver*>(pData);
+        for( int i = 0; i < 100; i++ )
+        {
+            poDriver->GetMetadataItem(GDAL_DCAP_RASTER);
+            if( poDriver->GetMetadataItem(GDAL_DMD_CREATIONOPTIONLIST) == NULL )
+                nInitMetadataCount = -1000;
+        }
+    }
+
+    // Test deferred initialization of driver metadata
+    template<> template<> void object::test<18>()
+    {
+        GDALDriver* poDriver = new GDALDriver();
+        poDriver->SetDescription("TestLazyMetadata");
+        poDriver->SetMetadataItem(GDAL_DCAP_RASTER, "YES");
+        poDriver->pfnOpen = SignatureDriverOpen;
+        poDriver->pfnInitMetadata = LazyDriverInitMetadata;
+        nInitMetadataCount = 0;
+        GetGDALDriverManager()->RegisterDriver( poDriver );
+        ensure_equals(nInitMetadataCount, 0);
+
+        // Capabilities do not trigger the initialization
+        ensure(poDriver->GetMetadataItem(GDAL_DCAP_RASTER) != NULL);
+        ensure(poDriver->GetMetadataItem(GDAL_DCAP_VECTOR) == NULL);
+        ensure(poDriver->GetMetadataItem(GDAL_DMD_SIGNATURES) == NULL);
+        ensure_equals(nInitMetadataCount, 0);
+
+        ensure_equals(std::string(GDALGetDriverLongName(poDriver)),
+                      std::string("Lazy driver"));
+        ensure_equals(nInitMetadataCount, 1);
+        ensure(CSLFetchNameValue(poDriver->GetMetadata(),
+                                 GDAL_DMD_CREATIONOPTIONLIST) != NULL);
+        ensure(CSLFetchNameValue(poDriver->GetMetadata(),
+                                 GDAL_DCAP_OPEN) != NULL);
+        ensure_equals(nInitMetadataCount, 1);
+
+        GetGDALDriverManager()->DeregisterDriver( poDriver );
+        delete poDriver;
+
+        // Items set before the initialization are not overwritten by it
+        poDriver = new GDALDriver();
+        poDriver->SetDescription("TestLazyMetadata");
+        poDriver->SetMetadataItem(GDAL_DCAP_RASTER, "YES");
+        poDriver->pfnOpen = SignatureDriverOpen;
+        poDriver->pfnInitMetadata = LazyDriverInitMetadata;
+        nInitMetadataCount = 0;
+        GetGDALDriverManager()->RegisterDriver( poDriver );
+        poDriver->SetMetadataItem(GDAL_DMD_LONGNAME, "Renamed driver");
+        ensure_equals(nInitMetadataCount, 1);
+        ensure_equals(std::string(GDALGetDriverLongName(poDriver)),
+                      std::string("Renamed driver"));
+        ensure_equals(nInitMetadataCount, 1);
+        GetGDALDriverManager()->DeregisterDriver( poDriver );
+        delete poDriver;
+
+        // Concurrent readers initialize the metadata once
+        poDriver = new GDALDriver();
+        poDriver->SetDescription("TestLazyMetadata");
+        poDriver->SetMetadataItem(GDAL_DCAP_RASTER, "YES");
+        poDriver->pfnOpen = SignatureDriverOpen;
+        poDriver->pfnInitMetadata = LazyDriverInitMetadata;
+        nInitMetadataCount = 0;
+        GetGDALDriverManager()->RegisterDriver( poDriver );
+        CPLJoinableThread* ahThreads[4];
+        for( int i = 0; i < 4; i++ )
+            ahThreads[i] = CPLCreateJoinableThread(LazyDriverReadMetadata,
+                                                   poDriver);
+        for( int i = 0; i < 4; i++ )
+            CPLJoinThread(ahThreads[i]);
+        ensure_equals(nInitMetadataCount, 1);
+        ensure_equals(std::string(GDALGetDriverLongName(poDriver)),
+                      std::string("Lazy driver"));
+        GetGDALDriverManager()->DeregisterDriver( poDriver );
+        delete poDriver;
+
+        // Lazily initialized drivers expose the same metadata as before
+        GDALDriverH hGTiff = GDALGetDriverByName("GTiff");
+        ensure(hGTiff != NULL);
+        ensure(GDALGetMetadataItem(hGTiff, GDAL_DMD_CREATIONOPTIONLIST,
+                                   NULL) != NULL);
+        ensure(GDALGetMetadataItem(hGTiff, GDAL_DMD_SIGNATURES, NULL) != NULL);
+        ensure_equals(std::string(GDALGetDriverLongName(hGTiff)),
+                      std::string("GeoTIFF"));
+    }
+
+    // Test ComputeStatistics(), ComputeRasterMinMax() and GetHistogram()
+    // against a brute force computation, single and multi-threaded
+    template<> template<> void object::test<19>()
+    {
+        GDALDriverH hDriver = GDALGetDriverByName("MEM");
+        ensure(hDriver != NULL);
+
+        const GDALDataType aeTypes[] = { GDT_Byte, GDT_UInt16, GDT_Int16,
+                                         GDT_Int32, GDT_Float32 };
+        const int nXSize = 1001;
+        const int nYSize = 700;
+        for( size_t iType = 0; iType < sizeof(aeTypes) / sizeof(aeTypes[0]);
+             iType++ )
+        {
+            const GDALDataType eDT = aeTypes[iType];
+            GDALDatasetH hDS = GDALCreate(hDriver, "", nXSize, nYSize, 1,
+                                          eDT, NULL);
+            ensure(hDS != NULL);
+            GDALRasterBandH hBand = GDALGetRasterBand(hDS, 1);
+
+            std::vector<double> adfValues(nXSize * nYSize);
+            for( int i = 0; i < nXSize * nYSize; i++ )
+            {
+                const int nValue = (int)((i * 7919U + (i / 13) * 104729U) % 65536);
+                if( eDT == GDT_Byte )
+                    adfValues[i] = nValue % 256;
+                else if( eDT == GDT_UInt16 )
+                    adfValues[i] = nValue;
+                else if( eDT == GDT_Int16 )
+                    adfValues[i] = nValue - 32768;
+                else if( eDT == GDT_Int32 )
+                    adfValues[i] = (nValue - 32768) * 1000;
+                else
+                    adfValues[i] = (nValue - 32768) / 16.0;
+            }
+            const double dfNoData = adfValues[12345];
+            GDALSetRasterNoDataValue(hBand, dfNoData);
+            if( eDT == GDT_Float32 )
+                adfValues[17] = std::numeric_limits<double>::quiet_NaN();
+            ensure_equals(GDALRasterIO(hBand, GF_Write, 0, 0, nXSize, nYSize,
+                                       &adfValues[0], nXSize, nYSize,
+                                       GDT_Float64, 0, 0), CE_None);
+
+            // Brute force
+            double dfMin = 0, dfMax = 0, dfSum = 0;
+            int nCount = 0;
+            for( int i = 0; i < nXSize * nYSize; i++ )
+            {
+                const double dfValue = adfValues[i];
+                if( CPLIsNan(dfValue) || dfValue == dfNoData )
+                    continue;
+                if( nCount == 0 || dfValue < dfMin )
+                    dfMin = dfValue;
+                if( nCount == 0 || dfValue > dfMax )
+                    dfMax = dfValue;
+                dfSum += dfValue;
+                nCount++;
+            }
+            const double dfMean = dfSum / nCount;
+            double dfM2 = 0;
+            const int nBuckets = 100;
+            const double dfHistMin = dfMin + (dfMax - dfMin) / 10;
+            const double dfHistMax = dfMax - (dfMax - dfMin) / 10;
+            std::vector<GUIntBig> anHistogram(nBuckets);
+            for( int i = 0; i < nXSize * nYSize; i++ )
+            {
+                const double dfValue = adfValues[i];
+                if( CPLIsNan(dfValue) || dfValue == dfNoData )
+                    continue;
+                dfM2 += (dfValue - dfMean) * (dfValue - dfMean);
+                int nIndex = (int)floor((dfValue - dfHistMin) * nBuckets /
+                                        (dfHistMax - dfHistMin));
+                anHistogram[MAX(0, MIN(nBuckets - 1, nIndex))] ++;
+            }
+            const double dfStdDev = sqrt(dfM2 / nCount);
+
+            double adfStats[2][4];
+            double adfMinMax[2][2];
+            std::vector<GUIntBig> anComputedHistogram[2];
+            for( int iRun = 0; iRun < 2; iRun++ )
+            {
+                CPLSetConfigOption("GDAL_NUM_THREADS", iRun == 0 ? "1" : "4");
+                ensure_equals(GDALComputeRasterStatistics(hBand, FALSE,
+                                &adfStats[iRun][0], &adfStats[iRun][1],
+                                &adfStats[iRun][2], &adfStats[iRun][3],
+                                NULL, NULL), CE_None);
+                GDALComputeRasterMinMax(hBand, FALSE, adfMinMax[iRun]);
+                anComputedHistogram[iRun].resize(nBuckets);
+                ensure_equals(GDALGetRasterHistogramEx(hBand, dfHistMin,
+                                dfHistMax, nBuckets,
+                                &anComputedHistogram[iRun][0], TRUE, FALSE,
+                                NULL, NULL), CE_None);
+                CPLSetConfigOption("GDAL_NUM_THREADS", NULL);
+
+                ensure_equals(adfStats[iRun][0], dfMin);
+                ensure_equals(adfStats[iRun][1], dfMax);
+                ensure_distance(adfStats[iRun][2], dfMean,
+                                1e-10 * MAX(1.0, fabs(dfMean)));
+                ensure_distance(adfStats[iRun][3], dfStdDev, 1e-10 * dfStdDev);
+                ensure_equals(adfMinMax[iRun][0], dfMin);
+                ensure_equals(adfMinMax[iRun][1], dfMax);
+                ensure(anComputedHistogram[iRun] == anHistogram);
+            }
+
+            // Results do not depend on the number of threads
+            for( int i = 0; i < 4; i++ )
+                ensure_equals(adfStats[1][i], adfStats[0][i]);
+
+            GDALClose(hDS);
+        }
+    }
+
+
+    // Test GDALQuantileSketch, ComputeSampledStatistics() and
+    // GetApproxQuantiles()
+    template<> template<> void object::test<20>()
+    {
+        const double adfProbabilities[] = { 0.1, 0.25, 0.5, 0.75, 0.9 };
+        const int nQuantiles = 5;
+
+        // Rank error of the sketch, alone and merged
+        const int nValues = 100000;
+        GDALQuantileSketch oSketch, oSketch1, oSketch2;
+        for( int i = 0; i < nValues; i++ )
+        {
+            const double dfValue = (i * 7919) % nValues;
+            oSketch.Insert(dfValue);
+            if( i % 3 == 0 )
+                oSketch1.Insert(dfValue);
+            else
+                oSketch2.Insert(dfValue);
+        }
+        oSketch1.Merge(oSketch2);
+        ensure_equals(oSketch1.GetCount(), (GUIntBig)nValues);
+        ensure_equals(oSketch.GetQuantile(0.0), 0.0);
+        ensure_equals(oSketch.GetQuantile(1.0), (double)(nValues - 1));
+        for( int i = 0; i < nQuantiles; i++ )
+        {
+            ensure_distance(oSketch.GetQuantile(adfProbabilities[i]) / nValues,
+                            adfProbabilities[i], 0.02);
+            ensure_distance(oSketch1.GetQuantile(adfProbabilities[i]) / nValues,
+                            adfProbabilities[i], 0.02);
+        }
+
+        // Serialization round trip
+        GDALQuantileSketch oSketch3;
+        ensure(oSketch3.Deserialize(oSketch1.Serialize()));
+        ensure(oSketch3.Serialize() == oSketch1.Serialize());
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure(!oSketch3.Deserialize("KLL1 200 10 0 1 1 0 3 0 1"));
+        CPLPopErrorHandler();
+        ensure_equals(oSketch3.GetCount(), (GUIntBig)0);
+
+        // Sampled statistics of a raster with a trend along rows
+        GDALDriverH hDriver = GDALGetDriverByName("MEM");
+        ensure(hDriver != NULL);
+        const int nXSize = 1000;
+        const int nYSize = 1000;
+        GDALDatasetH hSrcDS = GDALCreate(hDriver, "", nXSize, nYSize, 1,
+                                         GDT_Float32, NULL);
+        ensure(hSrcDS != NULL);
+        std::vector<float> afValues(nXSize * nYSize);
+        for( int i = 0; i < nXSize * nYSize; i++ )
+        {
+            afValues[i] = (float)((i * 7919U + (i / 13) * 104729U) % 1000 +
+                                  (i / nXSize) * 0.1);
+        }
+        ensure_equals(GDALRasterIO(GDALGetRasterBand(hSrcDS, 1), GF_Write,
+                                   0, 0, nXSize, nYSize, &afValues[0],
+                                   nXSize, nYSize, GDT_Float32, 0, 0),
+                      CE_None);
+        double dfSum = 0;
+        for( int i = 0; i < nXSize * nYSize; i++ )
+            dfSum += afValues[i];
+        const double dfMean = dfSum / (nXSize * nYSize);
+        std::sort(afValues.begin(), afValues.end());
+
+        const char* pszFilename = "/vsimem/test_gdal_20.tif";
+        GDALDatasetH hDS = GDALCreateCopy(GDALGetDriverByName("GTiff"),
+                                          pszFilename, hSrcDS, FALSE,
+                                          NULL, NULL, NULL);
+        ensure(hDS != NULL);
+        GDALClose(hDS);
+        GDALClose(hSrcDS);
+
+        hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure(hDS != NULL);
+        GDALRasterBandH hBand = GDALGetRasterBand(hDS, 1);
+        double adfQuantiles[nQuantiles];
+        ensure_equals(GDALGetRasterApproxQuantiles(hBand, nQuantiles,
+                        adfProbabilities, adfQuantiles, FALSE, NULL, NULL),
+                      CE_Warning);
+
+        double dfSampledMean = 0, dfStdDev = 0;
+        double dfMeanError = 0, dfStdDevError = 0;
+        ensure_equals(GDALComputeRasterSampledStatistics(hBand, 50000,
+                        NULL, NULL, &dfSampledMean, &dfStdDev,
+                        &dfMeanError, &dfStdDevError, NULL, NULL), CE_None);
+        ensure(dfMeanError > 0);
+        ensure(dfStdDevError > 0);
+        ensure(fabs(dfSampledMean - dfMean) <= 2 * dfMeanError);
+
+        ensure_equals(GDALGetRasterApproxQuantiles(hBand, nQuantiles,
+                        adfProbabilities, adfQuantiles, FALSE, NULL, NULL),
+                      CE_None);
+        for( int i = 0; i < nQuantiles; i++ )
+        {
+            const double dfRank = (std::lower_bound(afValues.begin(),
+                    afValues.end(), (float)adfQuantiles[i]) - afValues.begin())
+                / (double)afValues.size();
+            ensure_distance(dfRank, adfProbabilities[i], 0.03);
+        }
+        GDALClose(hDS);
+
+        // Reopen: the sketch and the statistics were saved in the .aux.xml,
+        // but are not returned when exact statistics are requested.
+        hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure(hDS != NULL);
+        hBand = GDALGetRasterBand(hDS, 1);
+        double adfQuantiles2[nQuantiles];
+        ensure_equals(GDALGetRasterApproxQuantiles(hBand, nQuantiles,
+                        adfProbabilities, adfQuantiles2, FALSE, NULL, NULL),
+                      CE_None);
+        for( int i = 0; i < nQuantiles; i++ )
+            ensure_equals(adfQuantiles2[i], adfQuantiles[i]);
+        double dfStatsMean = 0;
+        ensure_equals(GDALGetRasterStatistics(hBand, TRUE, FALSE,
+                                              NULL, NULL, &dfStatsMean, NULL),
+                      CE_None);
+        ensure_distance(dfStatsMean, dfSampledMean, 1e-8 * dfSampledMean);
+        ensure_equals(GDALGetRasterStatistics(hBand, FALSE, FALSE,
+                                              NULL, NULL, &dfStatsMean, NULL),
+                      CE_Warning);
+
+        // Exact statistics replace the approximate ones
+        ensure_equals(GDALComputeRasterStatistics(hBand, FALSE, NULL, NULL,
+                                                  &dfStatsMean, NULL,
+                                                  NULL, NULL), CE_None);
+        ensure(GDALGetMetadataItem(hBand, "STATISTICS_APPROXIMATE", NULL)
+               == NULL);
+        ensure(GDALGetMetadataItem(hBand, "STATISTICS_MEAN_ERROR", NULL)
+               == NULL);
+        ensure(GDALGetMetadataItem(hBand, "KLL", "STATISTICS_SKETCH") == NULL);
+        ensure_equals(GDALGetRasterStatistics(hBand, FALSE, FALSE,
+                                              NULL, NULL, &dfStatsMean, NULL),
+                      CE_None);
+        ensure_distance(dfStatsMean, dfMean, 1e-6 * dfMean);
+
+        // A sample of all the blocks gives exact statistics
+        ensure_equals(GDALComputeRasterSampledStatistics(hBand,
+                        GDALGetRasterBandXSize(hBand) *
+                        GDALGetRasterBandYSize(hBand),
+                        NULL, NULL, &dfSampledMean, NULL,
+                        &dfMeanError, &dfStdDevError, NULL, NULL), CE_None);
+        ensure_equals(dfMeanError, 0.0);
+        ensure(GDALGetMetadataItem(hBand, "STATISTICS_APPROXIMATE", NULL)
+               == NULL);
+        ensure_distance(dfSampledMean, dfMean, 1e-6 * dfMean);
+        GDALClose(hDS);
+
+        GDALDeleteDataset(GDALGetDriverByName("GTiff"), pszFilename);
+    }
+
+    static volatile int nVRTOfManySourcesErrors = 0;
+
+    static int GetVRTOfManySourcesChecksum(const char* pszVRT)
+    {
+        GDALDatasetH hDS = GDALOpen(pszVRT, GA_ReadOnly);
+        if( hDS == NULL )
+            return -1;
+        int nChecksum = GDALChecksumImage(GDALGetRasterBand(hDS, 1), 0, 0,
+                                          GDALGetRasterXSize(hDS),
+                                          GDALGetRasterYSize(hDS));
+        GDALClose(hDS);
+        return nChecksum;
+    }
+
+    static void ReadVRTOfManySources(void* pData)
+    {
+        const char* pszVRT = (const char*)pData;
+        const int nExpectedChecksum = 7481;
+        for( int iIter = 0; iIter < 10; iIter++ )
+        {
+            if( GetVRTOfManySourcesChecksum(pszVRT) != nExpectedChecksum )
+                CPLAtomicInc(&nVRTOfManySourcesErrors);
+        }
+    }
+
+    // Test concurrent reads of a VRT with more sources than the size of
+    // the dataset pool
+    template<> template<> void object::test<21>()
+    {
+        const int nSources = 16;
+        CPLString osVRT("<VRTDataset rasterXSize=\"128\" rasterYSize=\"8\">"
+                        "<VRTRasterBand dataType=\"Byte\" band=\"1\">");
+        for( int i = 0; i < nSources; i++ )
+        {
+            CPLString osSrcName(CPLSPrintf("/vsimem/test_gdal_21_%d.tif", i));
+            GDALDatasetH hSrcDS = GDALCreate(GDALGetDriverByName("GTiff"),
+                                             osSrcName, 8, 8, 1, GDT_Byte,
+                                             NULL);
+            ensure(hSrcDS != NULL);
+            GDALFillRaster(GDALGetRasterBand(hSrcDS, 1), i + 1, 0);
+            GDALClose(hSrcDS);
+            osVRT += CPLSPrintf("<SimpleSource>"
+                                "<SourceFilename>%s</SourceFilename>"
+                                "<SourceBand>1</SourceBand>"
+                                "<SourceProperties RasterXSize=\"8\" RasterYSize=\"8\" "
+                                "DataType=\"Byte\" BlockXSize=\"8\" BlockYSize=\"8\"/>"
+                                "<SrcRect xOff=\"0\" yOff=\"0\" xSize=\"8\" ySize=\"8\"/>"
+                                "<DstRect xOff=\"%d\" yOff=\"0\" xSize=\"8\" ySize=\"8\"/>"
+                                "</SimpleSource>", osSrcName.c_str(), i * 8);
+        }
+        osVRT += "</VRTRasterBand></VRTDataset>";
+
+        GIntBig nHitsBefore = 0, nMissesBefore = 0, nReopensBefore = 0;
+        GDALDatasetPoolGetStatistics(&nHitsBefore, &nMissesBefore,
+                                     &nReopensBefore);
+
+        CPLSetConfigOption("GDAL_MAX_DATASET_POOL_SIZE", "4");
+        const int nThreads = 4;
+        CPLJoinableThread* ahThreads[nThreads];
+        for( int i = 0; i < nThreads; i++ )
+            ahThreads[i] = CPLCreateJoinableThread(ReadVRTOfManySources,
+                                                   (void*)osVRT.c_str());
+        for( int i = 0; i < nThreads; i++ )
+            CPLJoinThread(ahThreads[i]);
+        CPLSetConfigOption("GDAL_MAX_DATASET_POOL_SIZE", NULL);
+        ensure_equals(nVRTOfManySourcesErrors, 0);
+
+        GIntBig nHits = 0, nMisses = 0, nReopens = 0;
+        GDALDatasetPoolGetStatistics(&nHits, &nMisses, &nReopens);
+        ensure(nMisses - nMissesBefore >= nThreads * nSources);
+        ensure(nReopens - nReopensBefore > 0);
+
+        for( int i = 0; i < nSources; i++ )
+            VSIUnlink(CPLSPrintf("/vsimem/test_gdal_21_%d.tif", i));
+    }
+
+    // Test the snapshots of metadata of files
+    template<> template<> void object::test<22>()
+    {
+        const char* pszFilename = "/vsimem/test_gdal_22.tif";
+        CPLSetConfigOption("GDAL_METADATA_SNAPSHOT_CACHE", "YES");
+
+        GDALDatasetH hDS = GDALCreate(GDALGetDriverByName("GTiff"),
+                                      pszFilename, 10, 10, 1, GDT_Byte, NULL);
+        ensure(hDS != NULL);
+        GDALSetProjection(hDS, SRS_WKT_WGS84);
+        GDALClose(hDS);
+
+        // Generic API: a snapshot is dropped when the file changes
+        CPLXMLNode* psSnapshot = CPLCreateXMLNode(NULL, CXT_Element, "Test");
+        GDALSetMetadataSnapshot(pszFilename, "Test", psSnapshot);
+        CPLDestroyXMLNode(psSnapshot);
+        psSnapshot = GDALGetMetadataSnapshot(pszFilename, "Test");
+        ensure(psSnapshot != NULL);
+        CPLDestroyXMLNode(psSnapshot);
+        ensure(GDALGetMetadataSnapshot(pszFilename, "Other") == NULL);
+        GDALInvalidateMetadataSnapshots(pszFilename);
+        ensure(GDALGetMetadataSnapshot(pszFilename, "Test") == NULL);
+
+        psSnapshot = CPLCreateXMLNode(NULL, CXT_Element, "Test");
+        GDALSetMetadataSnapshot(pszFilename, "Test", psSnapshot);
+        CPLDestroyXMLNode(psSnapshot);
+        VSILFILE* fp = VSIFOpenL(pszFilename, "ab");
+        ensure(fp != NULL);
+        VSIFWriteL("x", 1, 1, fp);
+        VSIFCloseL(fp);
+        ensure(GDALGetMetadataSnapshot(pszFilename, "Test") == NULL);
+
+        // Reopening gives the same georeferencing
+        std::string osWKT;
+        for( int i = 0; i < 2; i++ )
+        {
+            hDS = GDALOpen(pszFilename, GA_ReadOnly);
+            ensure(hDS != NULL);
+            if( i == 0 )
+                osWKT = GDALGetProjectionRef(hDS);
+            else
+                ensure_equals(GDALGetProjectionRef(hDS), osWKT);
+            ensure_equals(GDALGetMetadataItem(hDS, "AREA_OR_POINT", NULL),
+                          std::string("Area"));
+            GDALClose(hDS);
+        }
+        ensure(osWKT.find("WGS 84") != std::string::npos);
+
+        // Changes of the file and of its .aux.xml done within the same
+        // second are seen
+        hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure(hDS != NULL);
+        GDALSetMetadataItem(hDS, "FOO", "BAR", NULL);
+        GDALClose(hDS);
+        hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure(hDS != NULL);
+        ensure_equals(GDALGetMetadataItem(hDS, "FOO", NULL), std::string("BAR"));
+        GDALSetMetadataItem(hDS, "FOO", "BAZ", NULL);
+        GDALClose(hDS);
+
+        hDS = GDALOpen(pszFilename, GA_Update);
+        ensure(hDS != NULL);
+        GDALSetProjection(hDS, "");
+        GDALClose(hDS);
+
+        hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure(hDS != NULL);
+        ensure_equals(GDALGetMetadataItem(hDS, "FOO", NULL), std::string("BAZ"));
+        ensure_equals(GDALGetProjectionRef(hDS), std::string(""));
+        GDALClose(hDS);
+
+        CPLSetConfigOption("GDAL_METADATA_SNAPSHOT_CACHE", NULL);
+        GDALFlushMetadataSnapshots();
+        GDALDeleteDataset(GDALGetDriverByName("GTiff"), pszFilename);
+    }
+
+    // Test that statistics ignore the pixels masked by an alpha band, and
+    // are computed with a block cache smaller than the jobs of the threads
+    template<> template<> void object::test<23>()
+    {
+        const int nXSize = 500;
+        const int nYSize = 400;
+        GDALDatasetH hDS = GDALCreate(GDALGetDriverByName("MEM"), "",
+                                      nXSize, nYSize, 2, GDT_Byte, NULL);
+        ensure(hDS != NULL);
+        GDALRasterBandH hBand = GDALGetRasterBand(hDS, 1);
+        GDALRasterBandH hAlphaBand = GDALGetRasterBand(hDS, 2);
+        GDALSetRasterColorInterpretation(hAlphaBand, GCI_AlphaBand);
+
+        // Masked pixels are 250, the other ones are in [0, 99]
+        std::vector<GByte> abyValues(nXSize * nYSize);
+        std::vector<GByte> abyAlpha(nXSize * nYSize);
+        double dfSum = 0;
+        int nCount = 0;
+        for( int i = 0; i < nXSize * nYSize; i++ )
+        {
+            const bool bMasked = (i % 7) == 0;
+            abyValues[i] = bMasked ? 250 : static_cast<GByte>(i % 100);
+            abyAlpha[i] = bMasked ? 0 : 255;
+            if( !bMasked )
+            {
+                dfSum += abyValues[i];
+                nCount++;
+            }
+        }
+        ensure_equals(GDALRasterIO(hBand, GF_Write, 0, 0, nXSize, nYSize,
+                                   &abyValues[0], nXSize, nYSize,
+                                   GDT_Byte, 0, 0), CE_None);
+        ensure_equals(GDALRasterIO(hAlphaBand, GF_Write, 0, 0, nXSize, nYSize,
+                                   &abyAlpha[0], nXSize, nYSize,
+                                   GDT_Byte, 0, 0), CE_None);
+        ensure_equals(GDALGetMaskFlags(hBand), GMF_ALPHA | GMF_PER_DATASET);
+
+        const GIntBig nOldCacheMax = GDALGetCacheMax64();
+        GDALSetCacheMax64(20 * nXSize);
+        CPLSetConfigOption("GDAL_NUM_THREADS", "4");
+        double dfMin = 0, dfMax = 0, dfMean = 0, dfStdDev = 0;
+        const CPLErr eErr = GDALComputeRasterStatistics(hBand, FALSE,
+                                &dfMin, &dfMax, &dfMean, &dfStdDev,
+                                NULL, NULL);
+        GUIntBig anHistogram[2] = { 0, 0 };
+        const CPLErr eErrHist = GDALGetRasterHistogramEx(hBand, -0.5, 255.5, 2,
+                                        anHistogram, FALSE, FALSE, NULL, NULL);
+        CPLSetConfigOption("GDAL_NUM_THREADS", NULL);
+        GDALSetCacheMax64(nOldCacheMax);
+
+        ensure_equals(eErr, CE_None);
+        ensure_equals(dfMin, 0.0);
+        ensure_equals(dfMax, 99.0);
+        ensure_distance(dfMean, dfSum / nCount, 1e-10 * dfMean);
+        ensure_equals(eErrHist, CE_None);
+        ensure_equals(anHistogram[0], static_cast<GUIntBig>(nCount));
+        ensure_equals(anHistogram[1], static_cast<GUIntBig>(0));
+
+        // The statistics of the alpha band itself are not masked
+        ensure_equals(GDALComputeRasterStatistics(hAlphaBand, FALSE,
+                                &dfMin, &dfMax, NULL, NULL,
+                                NULL, NULL), CE_None);
+        ensure_equals(dfMin, 0.0);
+        ensure_equals(dfMax, 255.0);
+
+        GDALClose(hDS);
+    }
+
+    // Test that the single pass generation of cascaded overviews into an
+    // external .ovr gives the same result as the level by level generation,
+    // including with lossy compressions where it must not be used
+    template<> template<> void object::test<24>()
+    {
+        const char* pszFilename = "/vsimem/test_gdal_24.tif";
+        const int nXSize = 1000;
+        const int nYSize = 777;
+        GDALDatasetH hSrcDS = GDALCreate(GDALGetDriverByName("GTiff"),
+                                         pszFilename, nXSize, nYSize, 1,
+                                         GDT_Byte, NULL);
+        ensure(hSrcDS != NULL);
+        std::vector<GByte> abyLine(nXSize);
+        unsigned int nSeed = 1;
+        for( int iY = 0; iY < nYSize; iY++ )
+        {
+            for( int iX = 0; iX < nXSize; iX++ )
+            {
+                nSeed = nSeed * 1103515245U + 12345U;
+                abyLine[iX] = (GByte)((iX * iY / 16 + (nSeed >> 24)) % 255);
+            }
+            ensure_equals(
+                GDALRasterIO(GDALGetRasterBand(hSrcDS, 1), GF_Write,
+                             0, iY, nXSize, 1, &abyLine[0], nXSize, 1,
+                             GDT_Byte, 0, 0), CE_None);
+        }
+        GDALClose(hSrcDS);
+
+        // Compressed .ovr files are computed by
+        // GDALRegenerateOverviewsMultiBand(), so create empty overviews and
+        // compute them band by band.
+        const char* apszCompress[] = { NULL, "DEFLATE", "JPEG", "LERC" };
+        for( size_t iComp = 0;
+             iComp < sizeof(apszCompress) / sizeof(apszCompress[0]); iComp++ )
+        {
+            CPLSetConfigOption("COMPRESS_OVERVIEW", apszCompress[iComp]);
+            hSrcDS = GDALOpen(pszFilename, GA_ReadOnly);
+            ensure(hSrcDS != NULL);
+            int anLevels[] = { 2, 4, 8 };
+            const CPLErr eErr = GDALBuildOverviews(hSrcDS, "NONE", 3, anLevels,
+                                                   0, NULL, NULL, NULL);
+            CPLSetConfigOption("COMPRESS_OVERVIEW", NULL);
+            ensure_equals(eErr, CE_None);
+            GDALRasterBandH hBand = GDALGetRasterBand(hSrcDS, 1);
+            ensure_equals(GDALGetOverviewCount(hBand), 3);
+            GDALRasterBandH ahOvrBands[3];
+            for( int i = 0; i < 3; i++ )
+                ahOvrBands[i] = GDALGetOverview(hBand, i);
+
+            std::vector<int> aanChecksums[2];
+            for( int iStreaming = 0; iStreaming < 2; iStreaming++ )
+            {
+                CPLSetConfigOption("GDAL_OVR_STREAMING",
+                                   iStreaming ? NULL : "NO");
+                ensure_equals(GDALRegenerateOverviews(hBand, 3, ahOvrBands,
+                                                      "AVERAGE", NULL, NULL),
+                              CE_None);
+                CPLSetConfigOption("GDAL_OVR_STREAMING", NULL);
+                for( int i = 0; i < 3; i++ )
+                {
+                    aanChecksums[iStreaming].push_back(GDALChecksumImage(
+                        ahOvrBands[i], 0, 0,
+                        GDALGetRasterBandXSize(ahOvrBands[i]),
+                        GDALGetRasterBandYSize(ahOvrBands[i])));
+                }
+            }
+            GDALClose(hSrcDS);
+            VSIUnlink(CPLSPrintf("%s.ovr", pszFilename));
+            ensure(apszCompress[iComp] ? apszCompress[iComp] : "NONE",
+                   aanChecksums[0] == aanChecksums[1]);
+        }
+
+        GDALDeleteDataset(GDALGetDriverByName("GTiff"), pszFilename);
+    }
+
+    // Test that blocks are evicted in least recently used order, including
+    // among blocks that are used again while cached
+    template<> template<> void object::test<25>()
+    {
+        // 256 blocks of 256 bytes, over a buffer that we can change behind
+        // the back of the block cache
+        std::vector<GByte> abyBuffer(256 * 256, 0);
+        char szPtr[64];
+        int nRet = CPLPrintPointer(szPtr, &abyBuffer[0], sizeof(szPtr));
+        szPtr[nRet] = 0;
+        GDALDataset* poDS = (GDALDataset*)GDALOpen(
+            CPLSPrintf("MEM:::DATAPOINTER=%s,PIXELS=256,LINES=256", szPtr),
+            GA_ReadOnly);
+        ensure(poDS != NULL);
+        GDALRasterBand* poBand = poDS->GetRasterBand(1);
+        poDS->SetCacheQuota(3 * 256);
+
+        // Use blocks 0, 1 and 2, then 1 and 0 again, so that 2 is the least
+        // recently used one, and then 1
+        const int anBlocks[] = { 0, 1, 2, 1, 0, 3, 4 };
+        for( size_t i = 0; i < sizeof(anBlocks) / sizeof(anBlocks[0]); i++ )
+        {
+            GDALRasterBlock* poBlock =
+                poBand->GetLockedBlockRef(0, anBlocks[i]);
+            ensure(poBlock != NULL);
+            poBlock->DropLock();
+        }
+
+        // Blocks still cached have kept the old content. Check them before
+        // the evicted ones, whose reading evicts other blocks.
+        memset(&abyBuffer[0], 1, abyBuffer.size());
+        const int anOrder[] = { 0, 3, 4, 1, 2 };
+        for( int i = 0; i < 5; i++ )
+        {
+            GDALRasterBlock* poBlock =
+                poBand->GetLockedBlockRef(0, anOrder[i]);
+            ensure(poBlock != NULL);
+            ensure_equals(CPLSPrintf("block %d", anOrder[i]),
+                          static_cast<int>(
+                              static_cast<GByte*>(poBlock->GetDataRef())[0]),
+                          (i < 3) ? 0 : 1);
+            poBlock->DropLock();
+        }
+        GDALClose(poDS);
+    }
+
 } // namespace tut
@@ -268,4 +268,555 @@ namespace tut
         GDALClose(ds);
     }
 
+    // Test that reading with decompression in worker threads gives the
+    // same result as in the calling thread
+    template<>
+    template<>
+    void object::test<8>()
+    {
+        const char* pszFilename = "/vsimem/test_gtiff_8.tif";
+        const int nXSize = 300;
+        const int nYSize = 250;
+        const char* const apszCompress[] = { "DEFLATE", "LZW", "PACKBITS" };
+        const char* const apszInterleave[] = { "PIXEL", "BAND" };
+        for( size_t iCompress = 0; iCompress < 3; iCompress++ )
+        {
+            for( size_t iInterleave = 0; iInterleave < 2; iInterleave++ )
+            {
+                char** papszOptions = NULL;
+                papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+                papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE", "64");
+                papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "64");
+                papszOptions = CSLSetNameValue(papszOptions, "COMPRESS",
+                                               apszCompress[iCompress]);
+                papszOptions = CSLSetNameValue(papszOptions, "INTERLEAVE",
+                                               apszInterleave[iInterleave]);
+                if( iCompress != 2 )
+                    papszOptions = CSLSetNameValue(papszOptions, "PREDICTOR", "2");
+                GDALDatasetH hDS = GDALCreate(drv_, pszFilename, nXSize, nYSize,
+                                              3, GDT_UInt16, papszOptions);
+                CSLDestroy(papszOptions);
+                ensure(hDS != NULL);
+                std::vector<GUInt16> anData(nXSize * nYSize * 3);
+                for( size_t i = 0; i < anData.size(); i++ )
+                    anData[i] = static_cast<GUInt16>((i * 7919) % 1000 + i / 5000);
+                ensure_equals(GDALDatasetRasterIO(hDS, GF_Write, 0, 0,
+                                                  nXSize, nYSize,
+                                                  &anData[0], nXSize, nYSize,
+                                                  GDT_UInt16, 3, NULL,
+                                                  0, 0, 0), CE_None);
+                GDALClose(hDS);
+
+                const char* const apszOpenOptions[] = { "NUM_THREADS=4", NULL };
+                hDS = GDALOpenEx(pszFilename, GDAL_OF_RASTER, NULL,
+                                 apszOpenOptions, NULL);
+                ensure(hDS != NULL);
+                std::vector<GUInt16> anRead(anData.size());
+                // Whole raster through the dataset, then a window of the
+                // second band
+                ensure_equals(GDALDatasetRasterIO(hDS, GF_Read, 0, 0,
+                                                  nXSize, nYSize,
+                                                  &anRead[0], nXSize, nYSize,
+                                                  GDT_UInt16, 3, NULL,
+                                                  0, 0, 0), CE_None);
+                ensure(CPLSPrintf("%s, %s", apszCompress[iCompress],
+                                  apszInterleave[iInterleave]),
+                       anRead == anData);
+                GDALFlushCache(hDS);
+                std::vector<GUInt16> anWindow(150 * 100);
+                ensure_equals(GDALRasterIO(GDALGetRasterBand(hDS, 2), GF_Read,
+                                           70, 130, 150, 100, &anWindow[0],
+                                           150, 100, GDT_UInt16, 0, 0),
+                              CE_None);
+                for( int iY = 0; iY < 100; iY++ )
+                {
+                    for( int iX = 0; iX < 150; iX++ )
+                    {
+                        ensure_equals(anWindow[iY * 150 + iX],
+                                      anData[nXSize * nYSize +
+                                             (130 + iY) * nXSize + 70 + iX]);
+                    }
+                }
+                GDALClose(hDS);
+            }
+        }
+        GDALDeleteDataset(drv_, pszFilename);
+    }
+
+    // Test that reading blocks fetched with a single multi-range read
+    // gives the same result as reading them one by one
+    template<>
+    template<>
+    void object::test<9>()
+    {
+        const char* pszFilename = "/vsimem/test_gtiff_9.tif";
+        const int nXSize = 300;
+        const int nYSize = 250;
+        const char* const apszCompress[] = { "NONE", "DEFLATE" };
+        const char* const apszInterleave[] = { "PIXEL", "BAND" };
+        const char* const apszThreads[] = { "1", "4" };
+        CPLSetConfigOption("GTIFF_MULTIRANGE", "YES");
+        for( int iCase = 0; iCase < 16; iCase++ )
+        {
+            const bool bTiled = (iCase & 1) != 0;
+            const char* pszCompress = apszCompress[(iCase >> 1) & 1];
+            const char* pszInterleave = apszInterleave[(iCase >> 2) & 1];
+            const char* pszThreads = apszThreads[(iCase >> 3) & 1];
+            char** papszOptions = NULL;
+            if( bTiled )
+            {
+                papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+                papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE", "32");
+                papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "32");
+            }
+            else
+            {
+                papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "10");
+            }
+            papszOptions = CSLSetNameValue(papszOptions, "COMPRESS", pszCompress);
+            papszOptions = CSLSetNameValue(papszOptions, "INTERLEAVE",
+                                           pszInterleave);
+            GDALDatasetH hDS = GDALCreate(drv_, pszFilename, nXSize, nYSize,
+                                          3, GDT_Byte, papszOptions);
+            CSLDestroy(papszOptions);
+            ensure(hDS != NULL);
+            std::vector<GByte> abyData(nXSize * nYSize * 3);
+            for( size_t i = 0; i < abyData.size(); i++ )
+                abyData[i] = static_cast<GByte>((i * 7919) % 251);
+            ensure_equals(GDALDatasetRasterIO(hDS, GF_Write, 0, 0,
+                                              nXSize, nYSize,
+                                              &abyData[0], nXSize, nYSize,
+                                              GDT_Byte, 3, NULL,
+                                              0, 0, 0), CE_None);
+            GDALClose(hDS);
+
+            const char* apszOpenOptions[] = { NULL, NULL };
+            apszOpenOptions[0] = CPLSPrintf("NUM_THREADS=%s", pszThreads);
+            hDS = GDALOpenEx(pszFilename, GDAL_OF_RASTER, NULL,
+                             apszOpenOptions, NULL);
+            ensure(hDS != NULL);
+            std::string osCase(CPLSPrintf("%s, %s, %s, %s threads",
+                                          bTiled ? "tiled" : "stripped",
+                                          pszCompress, pszInterleave,
+                                          pszThreads));
+            std::vector<GByte> abyWindow(150 * 100);
+            ensure_equals(GDALRasterIO(GDALGetRasterBand(hDS, 3), GF_Read,
+                                       70, 130, 150, 100, &abyWindow[0],
+                                       150, 100, GDT_Byte, 0, 0),
+                          CE_None);
+            for( int iY = 0; iY < 100; iY++ )
+            {
+                for( int iX = 0; iX < 150; iX++ )
+                {
+                    ensure(osCase,
+                           abyWindow[iY * 150 + iX] ==
+                               abyData[2 * nXSize * nYSize +
+                                       (130 + iY) * nXSize + 70 + iX]);
+                }
+            }
+            // Whole raster, with some blocks already in the cache
+            std::vector<GByte> abyRead(abyData.size());
+            ensure_equals(GDALDatasetRasterIO(hDS, GF_Read, 0, 0,
+                                              nXSize, nYSize,
+                                              &abyRead[0], nXSize, nYSize,
+                                              GDT_Byte, 3, NULL,
+                                              0, 0, 0), CE_None);
+            ensure(osCase, abyRead == abyData);
+            GDALClose(hDS);
+        }
+        CPLSetConfigOption("GTIFF_MULTIRANGE", NULL);
+        GDALDeleteDataset(drv_, pszFilename);
+    }
+
+    // Test that the strip/tile offsets and bytecounts loaded on demand in
+    // read-only mode match those loaded at once in update mode
+    template<>
+    template<>
+    void object::test<10>()
+    {
+        const char* pszFilename = "/vsimem/test_gtiff_10.tif";
+        const int nXSize = 2048;
+        const int nYSize = 1040;
+        const char* const apszEndianness[] = { "LITTLE", "BIG" };
+        const char* const apszBigTIFF[] = { "NO", "YES" };
+        for( int iCase = 0; iCase < 8; iCase++ )
+        {
+            const bool bTiled = (iCase & 1) != 0;
+            const char* pszEndianness = apszEndianness[(iCase >> 1) & 1];
+            const char* pszBigTIFF = apszBigTIFF[(iCase >> 2) & 1];
+            char** papszOptions = NULL;
+            if( bTiled )
+            {
+                papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+                papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE", "16");
+                papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "16");
+            }
+            else
+            {
+                papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "1");
+            }
+            papszOptions = CSLSetNameValue(papszOptions, "COMPRESS", "DEFLATE");
+            papszOptions = CSLSetNameValue(papszOptions, "ENDIANNESS",
+                                           pszEndianness);
+            papszOptions = CSLSetNameValue(papszOptions, "BIGTIFF", pszBigTIFF);
+            GDALDatasetH hDS = GDALCreate(drv_, pszFilename, nXSize, nYSize,
+                                          1, GDT_Byte, papszOptions);
+            CSLDestroy(papszOptions);
+            ensure(hDS != NULL);
+            std::vector<GByte> abyData(nXSize * nYSize);
+            for( size_t i = 0; i < abyData.size(); i++ )
+                abyData[i] = static_cast<GByte>((i * 7919 + i / 3000) % 251);
+            ensure_equals(GDALRasterIO(GDALGetRasterBand(hDS, 1), GF_Write,
+                                       0, 0, nXSize, nYSize, &abyData[0],
+                                       nXSize, nYSize, GDT_Byte, 0, 0),
+                          CE_None);
+            GDALClose(hDS);
+
+            std::string osCase(CPLSPrintf("%s, %s, BIGTIFF=%s",
+                                          bTiled ? "tiled" : "stripped",
+                                          pszEndianness, pszBigTIFF));
+            GDALDatasetH hDSUpdate = GDALOpen(pszFilename, GA_Update);
+            GDALDatasetH hDSRead = GDALOpen(pszFilename, GA_ReadOnly);
+            ensure(hDSUpdate != NULL && hDSRead != NULL);
+            GDALRasterBandH hBandUpdate = GDALGetRasterBand(hDSUpdate, 1);
+            GDALRasterBandH hBandRead = GDALGetRasterBand(hDSRead, 1);
+            int nBlockXSize = 0;
+            int nBlockYSize = 0;
+            GDALGetBlockSize(hBandRead, &nBlockXSize, &nBlockYSize);
+            // Blocks spread over several pages, last one included
+            const int anBlocks[][2] = { { 0, 0 }, { 100, 40 }, { 5, 1039 },
+                                        { 127, 64 }, { 0, 700 } };
+            for( size_t i = 0; i < sizeof(anBlocks) / sizeof(anBlocks[0]); i++ )
+            {
+                const int nBlockXOff = anBlocks[i][0] % (nXSize / nBlockXSize);
+                const int nBlockYOff = anBlocks[i][1] %
+                                    ((nYSize + nBlockYSize - 1) / nBlockYSize);
+                CPLString osOffset(CPLSPrintf("BLOCK_OFFSET_%d_%d",
+                                              nBlockXOff, nBlockYOff));
+                CPLString osSize(CPLSPrintf("BLOCK_SIZE_%d_%d",
+                                            nBlockXOff, nBlockYOff));
+                const char* pszOffset =
+                    GDALGetMetadataItem(hBandRead, osOffset, "TIFF");
+                ensure(osCase, pszOffset != NULL);
+                ensure_equals(osCase.c_str(), std::string(pszOffset),
+                    std::string(GDALGetMetadataItem(hBandUpdate, osOffset,
+                                                    "TIFF")));
+                const char* pszSize =
+                    GDALGetMetadataItem(hBandRead, osSize, "TIFF");
+                ensure(osCase, pszSize != NULL);
+                ensure_equals(osCase.c_str(), std::string(pszSize),
+                    std::string(GDALGetMetadataItem(hBandUpdate, osSize,
+                                                    "TIFF")));
+            }
+            std::vector<GByte> abyRead(abyData.size());
+            ensure_equals(GDALRasterIO(hBandRead, GF_Read,
+                                       0, 0, nXSize, nYSize, &abyRead[0],
+                                       nXSize, nYSize, GDT_Byte, 0, 0),
+                          CE_None);
+            ensure(osCase, abyRead == abyData);
+            GDALClose(hDSRead);
+            GDALClose(hDSUpdate);
+        }
+        GDALDeleteDataset(drv_, pszFilename);
+    }
+
+    // Test round-trips through the ZSTD and LERC codecs, with and without
+    // worker threads
+    template<>
+    template<>
+    void object::test<11>()
+    {
+        const char* pszFilename = "/vsimem/test_gtiff_11.tif";
+        const int nXSize = 120;
+        const int nYSize = 100;
+        const char* pszCreationOptions =
+            GDALGetMetadataItem(drv_, GDAL_DMD_CREATIONOPTIONLIST, NULL);
+        const char* const apszCompress[] = { "ZSTD", "LERC", "LERC_DEFLATE",
+                                             "LERC_ZSTD" };
+        const char* const apszThreads[] = { "1", "4" };
+        for( int iCase = 0; iCase < 8; iCase++ )
+        {
+            const char* pszCompress = apszCompress[iCase & 3];
+            const char* pszThreads = apszThreads[(iCase >> 2) & 1];
+            if( strstr(pszCreationOptions,
+                       CPLSPrintf("<Value>%s</Value>", pszCompress)) == NULL )
+                continue;
+            // Plain LERC is tested in lossy mode, the other ones losslessly
+            const bool bLossy = EQUAL(pszCompress, "LERC");
+            const double dfMaxZError = bLossy ? 0.01 : 0.0;
+            char** papszOptions = NULL;
+            papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+            papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE", "32");
+            papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "32");
+            papszOptions = CSLSetNameValue(papszOptions, "COMPRESS", pszCompress);
+            papszOptions = CSLSetNameValue(papszOptions, "NUM_THREADS",
+                                           pszThreads);
+            if( EQUAL(pszCompress, "ZSTD") )
+                papszOptions = CSLSetNameValue(papszOptions, "PREDICTOR", "3");
+            if( bLossy )
+                papszOptions = CSLSetNameValue(papszOptions, "MAX_Z_ERROR",
+                                               CPLSPrintf("%g", dfMaxZError));
+            GDALDatasetH hDS = GDALCreate(drv_, pszFilename, nXSize, nYSize,
+                                          3, GDT_Float32, papszOptions);
+            CSLDestroy(papszOptions);
+            ensure(hDS != NULL);
+            std::vector<float> afData(nXSize * nYSize * 3);
+            for( size_t i = 0; i < afData.size(); i++ )
+            {
+                if( (i % 97) == 0 )
+                    afData[i] = static_cast<float>(CPLAtof("nan"));
+                else
+                    afData[i] = static_cast<float>((i * 7919) % 251) / 3.0f;
+            }
+            ensure_equals(GDALDatasetRasterIO(hDS, GF_Write, 0, 0,
+                                              nXSize, nYSize,
+                                              &afData[0], nXSize, nYSize,
+                                              GDT_Float32, 3, NULL,
+                                              0, 0, 0), CE_None);
+            GDALClose(hDS);
+
+            const char* apszOpenOptions[] = { NULL, NULL };
+            apszOpenOptions[0] = CPLSPrintf("NUM_THREADS=%s", pszThreads);
+            hDS = GDALOpenEx(pszFilename, GDAL_OF_RASTER, NULL,
+                             apszOpenOptions, NULL);
+            ensure(hDS != NULL);
+            std::string osCase(CPLSPrintf("%s, %s threads",
+                                          pszCompress, pszThreads));
+            ensure_equals(osCase.c_str(), std::string(
+                GDALGetMetadataItem(hDS, "COMPRESSION", "IMAGE_STRUCTURE")),
+                std::string(pszCompress));
+            // LERC only handles one sample per blob
+            if( !EQUAL(pszCompress, "ZSTD") )
+            {
+                ensure_equals(osCase.c_str(), std::string(
+                    GDALGetMetadataItem(hDS, "INTERLEAVE", "IMAGE_STRUCTURE")),
+                    std::string("BAND"));
+            }
+            std::vector<float> afRead(afData.size());
+            ensure_equals(GDALDatasetRasterIO(hDS, GF_Read, 0, 0,
+                                              nXSize, nYSize,
+                                              &afRead[0], nXSize, nYSize,
+                                              GDT_Float32, 3, NULL,
+                                              0, 0, 0), CE_None);
+            for( size_t i = 0; i < afData.size(); i++ )
+            {
+                if( CPLIsNan(afData[i]) )
+                    ensure(osCase, CPLIsNan(afRead[i]));
+                else if( bLossy )
+                    ensure(osCase,
+                           fabs(afRead[i] - afData[i]) <= dfMaxZError);
+                else
+                    ensure(osCase, afRead[i] == afData[i]);
+            }
+            GDALClose(hDS);
+        }
+
+        // CreateCopy(), losslessly and with a maximum error
+        GDALDatasetH hSrcDS = GDALCreate(GDALGetDriverByName("MEM"), "",
+                                         nXSize, nYSize, 1, GDT_Float32, NULL);
+        ensure(hSrcDS != NULL);
+        std::vector<float> afData(nXSize * nYSize);
+        for( size_t i = 0; i < afData.size(); i++ )
+            afData[i] = static_cast<float>((i * 7919) % 251) / 3.0f;
+        ensure_equals(GDALDatasetRasterIO(hSrcDS, GF_Write, 0, 0,
+                                          nXSize, nYSize,
+                                          &afData[0], nXSize, nYSize,
+                                          GDT_Float32, 1, NULL,
+                                          0, 0, 0), CE_None);
+        const char* const apszCopyCompress[] = { "LERC_DEFLATE", "LERC_ZSTD" };
+        const double adfMaxZError[] = { 0.0, 0.5 };
+        for( int iCase = 0; iCase < 4; iCase++ )
+        {
+            const char* pszCompress = apszCopyCompress[iCase & 1];
+            const double dfMaxZError = adfMaxZError[(iCase >> 1) & 1];
+            if( strstr(pszCreationOptions,
+                       CPLSPrintf("<Value>%s</Value>", pszCompress)) == NULL )
+                continue;
+            char** papszOptions = NULL;
+            papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+            papszOptions = CSLSetNameValue(papszOptions, "COMPRESS", pszCompress);
+            papszOptions = CSLSetNameValue(papszOptions, "MAX_Z_ERROR",
+                                           CPLSPrintf("%g", dfMaxZError));
+            GDALDatasetH hDS = GDALCreateCopy(drv_, pszFilename, hSrcDS, FALSE,
+                                              papszOptions, NULL, NULL);
+            CSLDestroy(papszOptions);
+            ensure(hDS != NULL);
+            GDALClose(hDS);
+
+            hDS = GDALOpen(pszFilename, GA_ReadOnly);
+            ensure(hDS != NULL);
+            std::string osCase(CPLSPrintf("CreateCopy, %s, MAX_Z_ERROR=%g",
+                                          pszCompress, dfMaxZError));
+            ensure_equals(osCase.c_str(), std::string(
+                GDALGetMetadataItem(hDS, "COMPRESSION", "IMAGE_STRUCTURE")),
+                std::string(pszCompress));
+            std::vector<float> afRead(afData.size());
+            ensure_equals(GDALDatasetRasterIO(hDS, GF_Read, 0, 0,
+                                              nXSize, nYSize,
+                                              &afRead[0], nXSize, nYSize,
+                                              GDT_Float32, 1, NULL,
+                                              0, 0, 0), CE_None);
+            bool bExact = true;
+            for( size_t i = 0; i < afData.size(); i++ )
+            {
+                ensure(osCase, fabs(afRead[i] - afData[i]) <= dfMaxZError);
+                if( afRead[i] != afData[i] )
+                    bExact = false;
+            }
+            // The error bound has really been used by the encoder
+            ensure(osCase, bExact == (dfMaxZError == 0.0));
+            GDALClose(hDS);
+        }
+        GDALClose(hSrcDS);
+        GDALDeleteDataset(drv_, pszFilename);
+    }
+
+    // Returns the smallest and largest block offsets of a band
+    static void GetBlockOffsetRange(GDALRasterBandH hBand,
+                                    GIntBig& nMinOffset, GIntBig& nMaxOffset)
+    {
+        int nBlockXSize = 0;
+        int nBlockYSize = 0;
+        GDALGetBlockSize(hBand, &nBlockXSize, &nBlockYSize);
+        const int nXBlocks = DIV_ROUND_UP(GDALGetRasterBandXSize(hBand),
+                                          nBlockXSize);
+        const int nYBlocks = DIV_ROUND_UP(GDALGetRasterBandYSize(hBand),
+                                          nBlockYSize);
+        nMinOffset = -1;
+        nMaxOffset = -1;
+        for( int j = 0; j < nYBlocks; j++ )
+        {
+            for( int i = 0; i < nXBlocks; i++ )
+            {
+                const char* pszOffset = GDALGetMetadataItem(hBand,
+                    CPLSPrintf("BLOCK_OFFSET_%d_%d", i, j), "TIFF");
+                ensure(pszOffset != NULL);
+                const GIntBig nOffset = CPLAtoGIntBig(pszOffset);
+                if( nMinOffset < 0 || nOffset < nMinOffset )
+                    nMinOffset = nOffset;
+                if( nOffset > nMaxOffset )
+                    nMaxOffset = nOffset;
+            }
+        }
+    }
+
+    // Test CreateCopy() with CLOUD_OPTIMIZED=YES
+    template<>
+    template<>
+    void object::test<12>()
+    {
+        const char* pszSrcFilename = "/vsimem/test_gtiff_12_src.tif";
+        const char* pszFilename = "/vsimem/test_gtiff_12.tif";
+        const int nXSize = 300;
+        const int nYSize = 200;
+        GDALDatasetH hSrcDS = GDALCreate(drv_, pszSrcFilename, nXSize, nYSize,
+                                         1, GDT_Byte, NULL);
+        ensure(hSrcDS != NULL);
+        std::vector<GByte> abyData(nXSize * nYSize);
+        for( size_t i = 0; i < abyData.size(); i++ )
+            abyData[i] = static_cast<GByte>((i * 7919) % 251);
+        ensure_equals(GDALDatasetRasterIO(hSrcDS, GF_Write, 0, 0,
+                                          nXSize, nYSize,
+                                          &abyData[0], nXSize, nYSize,
+                                          GDT_Byte, 1, NULL,
+                                          0, 0, 0), CE_None);
+
+        char** papszOptions = NULL;
+        papszOptions = CSLSetNameValue(papszOptions, "CLOUD_OPTIMIZED", "YES");
+        papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE", "64");
+        papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "64");
+        papszOptions = CSLSetNameValue(papszOptions, "COMPRESS", "DEFLATE");
+        GDALDatasetH hDS = GDALCreateCopy(drv_, pszFilename, hSrcDS, FALSE,
+                                          papszOptions, NULL, NULL);
+        CSLDestroy(papszOptions);
+        ensure(hDS != NULL);
+        GDALClose(hDS);
+
+        // The ghost area follows the classic TIFF header
+        vsi_l_offset nFileSize = 0;
+        GByte* pabyFile = VSIGetMemFileBuffer(pszFilename, &nFileSize, FALSE);
+        ensure(pabyFile != NULL);
+        ensure(nFileSize > 8 + 43);
+        ensure_equals(std::string(reinterpret_cast<const char*>(pabyFile) + 8,
+                                  strlen("GDAL_STRUCTURAL_METADATA_SIZE=")),
+                      std::string("GDAL_STRUCTURAL_METADATA_SIZE="));
+
+        // Walk the IFD chain to find where the last IFD ends
+        GUInt32 nIFDOffset = 0;
+        memcpy(&nIFDOffset, pabyFile + 4, 4);
+        CPL_LSBPTR32(&nIFDOffset);
+        GIntBig nIFDsEnd = 0;
+        int nIFDCount = 0;
+        while( nIFDOffset != 0 && nIFDOffset + 2 <= nFileSize )
+        {
+            GUInt16 nEntries = 0;
+            memcpy(&nEntries, pabyFile + nIFDOffset, 2);
+            CPL_LSBPTR16(&nEntries);
+            const GUInt32 nNextOffsetPos = nIFDOffset + 2 + 12 * nEntries;
+            ensure(nNextOffsetPos + 4 <= nFileSize);
+            if( nNextOffsetPos + 4 > nIFDsEnd )
+                nIFDsEnd = nNextOffsetPos + 4;
+            memcpy(&nIFDOffset, pabyFile + nNextOffsetPos, 4);
+            CPL_LSBPTR32(&nIFDOffset);
+            nIFDCount++;
+        }
+
+        hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure(hDS != NULL);
+        ensure_equals(std::string(
+            GDALGetMetadataItem(hDS, "LAYOUT", "IMAGE_STRUCTURE")),
+            std::string("COG"));
+        GDALRasterBandH hBand = GDALGetRasterBand(hDS, 1);
+        // 150x100, 75x50 and 38x25: the last level fits into one block
+        ensure_equals(GDALGetOverviewCount(hBand), 3);
+        ensure_equals(nIFDCount, 4);
+
+        // Blocks come from the smallest overview to the full resolution,
+        // all after the IFDs
+        GIntBig nPrevMaxOffset = -1;
+        for( int iOvr = 2; iOvr >= -1; iOvr-- )
+        {
+            GDALRasterBandH hLevelBand =
+                (iOvr < 0) ? hBand : GDALGetOverview(hBand, iOvr);
+            int nBlockXSize = 0;
+            int nBlockYSize = 0;
+            GDALGetBlockSize(hLevelBand, &nBlockXSize, &nBlockYSize);
+            ensure_equals(nBlockXSize, 64);
+            ensure_equals(nBlockYSize, 64);
+            GIntBig nMinOffset = 0;
+            GIntBig nMaxOffset = 0;
+            GetBlockOffsetRange(hLevelBand, nMinOffset, nMaxOffset);
+            ensure(nMinOffset >= nIFDsEnd);
+            ensure(nMinOffset > nPrevMaxOffset);
+            nPrevMaxOffset = nMaxOffset;
+        }
+
+        ensure_equals(GDALChecksumImage(hBand, 0, 0, nXSize, nYSize),
+                      GDALChecksumImage(GDALGetRasterBand(hSrcDS, 1), 0, 0,
+                                        nXSize, nYSize));
+        GDALClose(hDS);
+        GDALClose(hSrcDS);
+        GDALDeleteDataset(drv_, pszSrcFilename);
+
+        // Modifying the file flags the layout as broken
+        hDS = GDALOpen(pszFilename, GA_Update);
+        ensure(hDS != NULL);
+        ensure_equals(GDALDatasetRasterIO(hDS, GF_Write, 0, 0, 64, 64,
+                                          &abyData[0], 64, 64,
+                                          GDT_Byte, 1, NULL,
+                                          0, 0, 0), CE_None);
+        GDALClose(hDS);
+        hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure(hDS != NULL);
+        ensure(GDALGetMetadataItem(hDS, "LAYOUT", "IMAGE_STRUCTURE") == NULL);
+        GDALClose(hDS);
+        pabyFile = VSIGetMemFileBuffer(pszFilename, &nFileSize, FALSE);
+        ensure(pabyFile != NULL);
+        const std::string osGhost(reinterpret_cast<const char*>(pabyFile) + 8,
+                                  100);
+        ensure(osGhost.find("KNOWN_INCOMPATIBLE_EDITION=YES\n") !=
+               std::string::npos);
+        GDALDeleteDataset(drv_, pszFilename);
+    }
+
  } // namespace tut
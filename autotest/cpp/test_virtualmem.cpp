@@ -183,6 +183,106 @@ static void test_raw_auto(int bFileMapping)
 
 }
 
+static void test_zero_copy_thread(void* p)
+{
+    CPLVirtualMem* ctxt = (CPLVirtualMem*)p;
+    GByte* pBase = (GByte*) CPLVirtualMemGetAddr(ctxt);
+    CPLVirtualMemDeclareThread(ctxt);
+    for(int i=0;i<10*1000;i++)
+    {
+        size_t nOffset = ((size_t)i * 4099) % CPLVirtualMemGetSize(ctxt);
+        assert(pBase[nOffset] == (GByte)(nOffset / 4096 + 1));
+    }
+    CPLVirtualMemUnDeclareThread(ctxt);
+}
+
+static void test_zero_copy(int bTiled)
+{
+    printf("test_zero_copy(bTiled=%d)\n", bTiled);
+    if( CPLGetPageSize() != 4096 )
+        return;
+
+    GDALAllRegister();
+
+    /* Blocks of 4096 bytes, i.e. one page on most systems */
+    char** papszOptions = NULL;
+    if( bTiled )
+    {
+        papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+        papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE", "64");
+        papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "64");
+    }
+    else
+        papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "32");
+    GDALDatasetH hDS = GDALCreate(GDALGetDriverByName("GTiff"),
+                                  "/vsimem/test_zero_copy.tif",
+                                  128, 128, 1, GDT_Byte, papszOptions );
+    CSLDestroy(papszOptions);
+    assert(hDS);
+    GDALRasterBandH hBand = GDALGetRasterBand(hDS, 1);
+
+    /* Fill each block with its index + 1 */
+    GByte abyBlock[4096];
+    int nBlockXSize, nBlockYSize;
+    GDALGetBlockSize(hBand, &nBlockXSize, &nBlockYSize);
+    for(int j=0;j<128/nBlockYSize;j++)
+    {
+        for(int i=0;i<128/nBlockXSize;i++)
+        {
+            memset(abyBlock, j * (128/nBlockXSize) + i + 1, sizeof(abyBlock));
+            CPLErr eErr = GDALWriteBlock(hBand, i, j, abyBlock);
+            assert(eErr == CE_None);
+        }
+    }
+    GDALFlushCache(hDS);
+
+    CPLVirtualMem* pVMem;
+    if( bTiled )
+        pVMem = GDALRasterBandGetTiledVirtualMem(hBand, GF_Write, 0, 0,
+                                                 128, 128, 64, 64, GDT_Byte,
+                                                 4096 * 2, FALSE, NULL);
+    else
+        pVMem = GDALRasterBandGetVirtualMem(hBand, GF_Write, 0, 0, 128, 128,
+                                            128, 128, GDT_Byte, 1, 128,
+                                            4096 * 2, 0, FALSE, NULL);
+    assert(pVMem);
+
+    /* Pages follow the blocks in both layouts */
+    GByte* pBase = (GByte*) CPLVirtualMemGetAddr(pVMem);
+    for(size_t i=0;i<CPLVirtualMemGetSize(pVMem);i++)
+        assert(pBase[i] == (GByte)(i / 4096 + 1));
+
+    CPLJoinableThread* hThread = CPLCreateJoinableThread(test_zero_copy_thread,
+                                                         pVMem);
+    test_zero_copy_thread(pVMem);
+    CPLJoinThread(hThread);
+
+    /* Writes in a mapped page are immediately visible in the block cache */
+    pBase[4096 + 1] = 255;
+    GByte byVal = 0;
+    CPLErr eErr = GDALRasterIO(hBand, GF_Read,
+                        bTiled ? 64 + 1 : 1, bTiled ? 0 : 32, 1, 1, &byVal, 1, 1,
+                        GDT_Byte, 0, 0);
+    assert(eErr == CE_None);
+    assert(byVal == 255);
+
+    CPLVirtualMemFree(pVMem);
+    GDALClose(hDS);
+
+    hDS = GDALOpen("/vsimem/test_zero_copy.tif", GA_ReadOnly);
+    assert(hDS);
+    hBand = GDALGetRasterBand(hDS, 1);
+    byVal = 0;
+    eErr = GDALRasterIO(hBand, GF_Read,
+                        bTiled ? 64 + 1 : 1, bTiled ? 0 : 32, 1, 1, &byVal, 1, 1,
+                        GDT_Byte, 0, 0);
+    assert(eErr == CE_None);
+    assert(byVal == 255);
+    GDALClose(hDS);
+
+    VSIUnlink("/vsimem/test_zero_copy.tif");
+}
+
 int main(int /* argc */, char* /* argv */[])
 {
     /*printf("test_huge_mapping\n");
@@ -217,6 +317,9 @@ int main(int /* argc */, char* /* argv */[])
     test_raw_auto(TRUE);
     test_raw_auto(FALSE);
 
+    test_zero_copy(FALSE);
+    test_zero_copy(TRUE);
+
     CPLVirtualMemManagerTerminate();
     GDALDestroyDriverManager();
 
@@ -44,7 +44,7 @@ void Usage()
 {
     printf("Usage: testblockcache [-threads X] [-loops X] [-max_requests X] [-strategy random|line|block]\n");
     printf("                      [-migrate] [ filename |\n");
-    printf("                       [[-xsize val] [-ysize val] [-bands val] [-co key=value]*\n");
+    printf("                       [[-xsize val] [-ysize val] [-bands val] [-co key=value]* [-overview]\n");
     printf("                       [[-memdriver] | [-ondisk]] [-check]] ]\n");
     exit(1);
 }
@@ -52,6 +52,7 @@ void Usage()
 int nLoops = 1;
 const char* pszDataset = NULL;
 int bCheck = FALSE;
+int bOverview = FALSE;
 
 typedef enum
 {
@@ -65,6 +66,7 @@ struct _Request
 {
     int nXOff, nYOff, nXWin, nYWin;
     int nBands;
+    int bOverview;
     Request* psNext;
 };
 
@@ -96,8 +98,10 @@ int myrand_r(unsigned long* pseed) {
     return((unsigned)((*pseed/65536UL) % (MYRAND_MAX+1)));
 }
 
+/* nFactor is the decimation factor of the overview read, 1 for the full */
+/* resolution */
 static void Check(GByte* pBuffer, int nXSize, int nYSize, int nBands,
-                  int nXOff, int nYOff, int nXWin, int nYWin)
+                  int nXOff, int nYOff, int nXWin, int nYWin, int nFactor)
 {
     for(int iBand=0;iBand<nBands;iBand++)
     {
@@ -105,7 +109,8 @@ static void Check(GByte* pBuffer, int nXSize, int nYSize, int nBands,
         {
             for(int iX=0;iX<nXWin;iX++)
             {
-                unsigned long seed = iBand * nXSize * nYSize + (iY + nYOff) * nXSize + iX + nXOff;
+                unsigned long seed = iBand * nXSize * nYSize +
+                    (iY + nYOff) * nFactor * nXSize + (iX + nXOff) * nFactor;
                 GByte expected = (GByte)(myrand_r(&seed) & 0xff);
                 assert( pBuffer[iBand * nXWin * nYWin + iY * nXWin + iX] == expected );
                 (void)expected;
@@ -115,9 +120,17 @@ static void Check(GByte* pBuffer, int nXSize, int nYSize, int nBands,
 }
 
 static void ReadRaster(GDALDataset* poDS, int nXSize, int nYSize, int nBands,
-                       GByte* pBuffer, int nXOff, int nYOff, int nXWin, int nYWin)
+                       GByte* pBuffer, int nXOff, int nYOff, int nXWin, int nYWin,
+                       int bOverviewRequest)
 {
-    CPL_IGNORE_RET_VAL(poDS->RasterIO(GF_Read, nXOff, nYOff, nXWin, nYWin,
+    GDALDataset* poReadDS = poDS;
+    int nFactor = 1;
+    if( bOverviewRequest )
+    {
+        poReadDS = poDS->GetRasterBand(1)->GetOverview(0)->GetDataset();
+        nFactor = nXSize / poReadDS->GetRasterXSize();
+    }
+    CPL_IGNORE_RET_VAL(poReadDS->RasterIO(GF_Read, nXOff, nYOff, nXWin, nYWin,
                     pBuffer, nXWin, nYWin,
                     GDT_Byte,
                     nBands, NULL,
@@ -129,12 +142,13 @@ static void ReadRaster(GDALDataset* poDS, int nXSize, int nYSize, int nBands,
     if( bCheck )
     {
         Check(pBuffer, nXSize, nYSize, nBands,
-              nXOff, nYOff, nXWin, nYWin);
+              nXOff, nYOff, nXWin, nYWin, nFactor);
     }
 }
 
 static void AddRequest(Request*& psRequestList, Request*& psRequestLast,
-                       int nXOff, int nYOff, int nXWin, int nYWin, int nBands)
+                       int nXOff, int nYOff, int nXWin, int nYWin, int nBands,
+                       int bOverviewRequest = FALSE)
 {
     Request* psRequest = (Request*)CPLMalloc(sizeof(Request));
     psRequest->nXOff = nXOff;
@@ -142,6 +156,7 @@ static void AddRequest(Request*& psRequestList, Request*& psRequestLast,
     psRequest->nXWin = nXWin;
     psRequest->nYWin = nYWin;
     psRequest->nBands = nBands;
+    psRequest->bOverview = bOverviewRequest;
     if( psRequestLast )
         psRequestLast->psNext = psRequest;
     else
@@ -201,7 +216,8 @@ static void ThreadFuncDedicatedDataset(void* _psThreadDescription)
     {
         Request* psRequest = GetNextRequest(psThreadDescription->psRequestList);
         ReadRaster(psThreadDescription->poDS, nXSize, nYSize, psRequest->nBands,
-                   (GByte*)pBuffer, psRequest->nXOff, psRequest->nYOff, psRequest->nXWin, psRequest->nYWin);
+                   (GByte*)pBuffer, psRequest->nXOff, psRequest->nYOff, psRequest->nXWin, psRequest->nYWin,
+                   psRequest->bOverview);
         CPLFree(psRequest);
     }
     CPLFree(pBuffer);
@@ -218,7 +234,8 @@ static void ThreadFuncWithMigration(void* /* _unused */)
         int nYSize = psResource->poDS->GetRasterYSize();
         ReadRaster(psResource->poDS, nXSize, nYSize, psRequest->nBands,
                    (GByte*)psResource->pBuffer,
-                   psRequest->nXOff, psRequest->nYOff, psRequest->nXWin, psRequest->nYWin);
+                   psRequest->nXOff, psRequest->nYOff, psRequest->nXWin, psRequest->nYWin,
+                   psRequest->bOverview);
         CPLFree(psRequest);
         PutResourceAtEnd(psResource);
     }
@@ -276,6 +293,11 @@ static int CreateLineStrategyRequests(GDALDataset* poDS,
             }
             AddRequest(psRequestList, psRequestLast, 0, nYOff, nXSize, 1, nQueriedBands);
             nRequests ++;
+            // Interleave the lines of the overview, so that both are read
+            // sequentially.
+            if( bOverview && (nYOff % 2) == 0 )
+                AddRequest(psRequestList, psRequestLast, 0, nYOff / 2, nXSize / 2, 1,
+                           nQueriedBands, TRUE);
         }
     }
     return nQueriedBands * nXSize;
@@ -401,6 +423,11 @@ int main(int argc, char* argv[])
             bCheck = TRUE;
             bNewDatasetOption = TRUE;
         }
+        else if( EQUAL(argv[i], "-overview"))
+        {
+            bOverview = TRUE;
+            bNewDatasetOption = TRUE;
+        }
         else if( EQUAL(argv[i], "-memdriver"))
         {
             bMemDriver = TRUE;
@@ -420,6 +447,8 @@ int main(int argc, char* argv[])
 
     if( pszDataset != NULL && bNewDatasetOption )
         Usage();
+    if( bOverview && (bMemDriver || eStrategy != STRATEGY_LINE) )
+        Usage();
 
     CPLDebug("TEST", "Using %d threads", nThreads);
 
@@ -458,6 +487,13 @@ int main(int argc, char* argv[])
             }
             VSIFree(pabyLine);
         }
+        if( bOverview )
+        {
+            // Internal overview, sharing the TIFF handle of the dataset.
+            int nOvrLevel = 2;
+            CPL_IGNORE_RET_VAL(poDS->BuildOverviews("NEAREST", 1, &nOvrLevel,
+                                                    0, NULL, NULL, NULL));
+        }
         if( bMemDriver ) 
             poMEMDS = poDS;
         else
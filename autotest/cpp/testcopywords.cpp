@@ -469,6 +469,93 @@ void check_GDT_CFloat32and64()
     }
 }
 
+/* Check that converting many words at once, which may use SIMD code paths, */
+/* gives the same result as converting them one at a time */
+void check_vectorized_paths()
+{
+    const double adfValues[] = { 0, 0.49, 0.5, 0.51, 1.5, -0.49, -0.5, -0.51,
+        -1.5, -1, 127.5, 254.5, 255.4, 255.5, 256, 32766.5, 32767.4, 32767.5,
+        -32768.4, -32768.5, -32769, 65534.5, 65535.4, 65535.5, 65536,
+        2147483647.0, 2147483647.5, -2147483648.0, -2147483648.6, 3e9, -3e9,
+        1e30, -1e30, HUGE_VAL, -HUGE_VAL };
+    const int nValues = (int)(sizeof(adfValues) / sizeof(adfValues[0]));
+    const int nWordCount = 101;
+    const int nMaxStride = 3 * 8;
+    GByte* pabySrc = (GByte*)malloc(nWordCount * nMaxStride);
+    GByte* pabyDst = (GByte*)malloc(nWordCount * nMaxStride);
+    GByte* pabyRef = (GByte*)malloc(nWordCount * nMaxStride);
+    unsigned int nSeed = 1;
+
+    for( int intype = GDT_Byte; intype <= GDT_Float64; intype++ )
+    {
+        const int nInSize = GDALGetDataTypeSize((GDALDataType)intype) / 8;
+        for( int i = 0; i < nWordCount; i++ )
+        {
+            double dfVal;
+            if( (i % 2) == 0 )
+                dfVal = adfValues[(i / 2) % nValues];
+            else
+            {
+                nSeed = nSeed * 1103515245U + 12345U;
+                dfVal = ((int)((nSeed >> 8) % 140001) - 70000) / 4.0;
+            }
+            GDALCopyWords(&dfVal, GDT_Float64, 0,
+                          pabySrc + i * nInSize, (GDALDataType)intype, 0, 1);
+        }
+
+        for( int outtype = GDT_Byte; outtype <= GDT_Float64; outtype++ )
+        {
+            const int nOutSize = GDALGetDataTypeSize((GDALDataType)outtype) / 8;
+            for( int iStride = 0; iStride < 4; iStride++ )
+            {
+                /* Packed and pixel-interleaved sources and destinations */
+                const int nSrcStride = (iStride & 1) ? 3 * nInSize : nInSize;
+                const int nDstStride = (iStride & 2) ? 3 * nOutSize : nOutSize;
+                if( nSrcStride != nInSize )
+                {
+                    for( int i = nWordCount - 1; i >= 0; i-- )
+                        memmove(pabySrc + i * nSrcStride,
+                                pabySrc + i * nInSize, nInSize);
+                }
+                memset(pabyDst, 0xff, nWordCount * nMaxStride);
+                memset(pabyRef, 0xff, nWordCount * nMaxStride);
+
+                GDALCopyWords(pabySrc, (GDALDataType)intype, nSrcStride,
+                              pabyDst, (GDALDataType)outtype, nDstStride,
+                              nWordCount);
+                for( int i = 0; i < nWordCount; i++ )
+                {
+                    GDALCopyWords(pabySrc + i * nSrcStride,
+                                  (GDALDataType)intype, 0,
+                                  pabyRef + i * nDstStride,
+                                  (GDALDataType)outtype, 0, 1);
+                }
+                if( memcmp(pabyDst, pabyRef, nWordCount * nMaxStride) != 0 )
+                {
+                    std::cout << "Bulk conversion mismatch (intype=" <<
+                        GDALGetDataTypeName((GDALDataType)intype) <<
+                        ",outtype=" <<
+                        GDALGetDataTypeName((GDALDataType)outtype) <<
+                        ",srcstride=" << nSrcStride <<
+                        ",dststride=" << nDstStride << ")" << std::endl;
+                    bErr = TRUE;
+                }
+
+                if( nSrcStride != nInSize )
+                {
+                    for( int i = 0; i < nWordCount; i++ )
+                        memmove(pabySrc + i * nInSize,
+                                pabySrc + i * nSrcStride, nInSize);
+                }
+            }
+        }
+    }
+
+    free(pabySrc);
+    free(pabyDst);
+    free(pabyRef);
+}
+
 int main(int /* argc */, char* /* argv */ [])
 {
     pIn = (char*)malloc(128);
@@ -483,6 +570,7 @@ int main(int /* argc */, char* /* argv */ [])
     check_GDT_CInt16();
     check_GDT_CInt32();
     check_GDT_CFloat32and64();
+    check_vectorized_paths();
 
     free(pIn);
     free(pOut);
@@ -0,0 +1,347 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Benchmark lock contention of the global block cache
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <vector>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cpl_conv.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+#include "gdal_priv.h"
+
+static const char* pszFilename = "/vsimem/testperfblockcache.tif";
+static int nRasterSize = 2048;
+static int nBlockSize = 64;
+static int nIterations = 1000000;
+static int nMaxThreads = 64;
+static bool bShared = false;
+static bool bCheck = false;
+static bool bMemory = false;
+
+typedef struct
+{
+    GDALDataset* poDS;
+    int          nSeed;
+    int          nIterations;
+} ThreadData;
+
+static void Usage()
+{
+    printf("Usage: testperfblockcache [-max_threads X] [-iterations X]\n");
+    printf("                          [-size X] [-blocksize X] [-shared]\n");
+    printf("                          [-check] [-memory]\n");
+    printf("\n");
+    printf("-shared: all threads read the same dataset handle, whose blocks\n");
+    printf("are all loaded in the cache before, so that the benchmark only\n");
+    printf("measures concurrent cache hits on the same blocks.\n");
+    printf("-check: check the content of the blocks that are fetched.\n");
+    printf("-memory: report the resident memory of the process (Linux only)\n");
+    printf("and the memory reserved for the block buffers after each run.\n");
+    printf("\n");
+    printf("Use --config GDAL_RB_CACHE_SHARDS X to select the number of\n");
+    printf("block cache shards, --config GDAL_RB_CACHE_POLICY LRU|CLOCK|2Q\n");
+    printf("to select the eviction policy, and --config GDAL_CACHEMAX X to\n");
+    printf("make the benchmark exercise eviction rather than only cache hits.\n");
+    printf("Use --cache-stats to also report the time spent waiting for the\n");
+    printf("block cache locks, and --config GDAL_RB_LOCK_FREE_HITS YES to\n");
+    printf("make cache hits skip the lock of the block cache.\n");
+    printf("Use --config GDAL_RB_ALLOCATOR SLAB to allocate the block buffers\n");
+    printf("from slabs, and --config GDAL_RB_HUGE_PAGES YES to back them\n");
+    printf("with transparent huge pages.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                            GetWallTime()                             */
+/************************************************************************/
+
+static double GetWallTime()
+{
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+/************************************************************************/
+/*                         GetResidentMemory()                          */
+/************************************************************************/
+
+static GIntBig GetResidentMemory()
+{
+    GIntBig nRSS = 0;
+    FILE* f = fopen("/proc/self/status", "rb");
+    if( f != NULL )
+    {
+        char szLine[256];
+        while( fgets(szLine, sizeof(szLine), f) != NULL )
+        {
+            if( STARTS_WITH(szLine, "VmRSS:") )
+            {
+                nRSS = CPLAtoGIntBig(szLine + strlen("VmRSS:")) * 1024;
+                break;
+            }
+        }
+        fclose(f);
+    }
+    return nRSS;
+}
+
+/************************************************************************/
+/*                             ThreadFunc()                             */
+/************************************************************************/
+
+static void ThreadFunc(void* pData)
+{
+    ThreadData* psData = static_cast<ThreadData*>(pData);
+    GDALRasterBand* poBand = psData->poDS->GetRasterBand(1);
+    const int nBlocksPerRow = nRasterSize / nBlockSize;
+    unsigned int nSeed = static_cast<unsigned int>(psData->nSeed);
+
+    for( int i = 0; i < psData->nIterations; i++ )
+    {
+        // Simple LCG, to avoid rand() which can be serialized by the libc.
+        nSeed = nSeed * 1103515245U + 12345U;
+        const int nXBlock = static_cast<int>((nSeed >> 8) % nBlocksPerRow);
+        nSeed = nSeed * 1103515245U + 12345U;
+        const int nYBlock = static_cast<int>((nSeed >> 8) % nBlocksPerRow);
+
+        GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(nXBlock, nYBlock);
+        assert(poBlock);
+        if( bCheck )
+        {
+            const GByte* pabyData =
+                static_cast<const GByte*>(poBlock->GetDataRef());
+            const GByte nExpected =
+                static_cast<GByte>((nXBlock + nYBlock * nBlocksPerRow) & 0xff);
+            if( pabyData[0] != nExpected ||
+                pabyData[nBlockSize * nBlockSize - 1] != nExpected )
+            {
+                fprintf(stderr, "Wrong content for block (%d,%d)\n",
+                        nXBlock, nYBlock);
+                exit(1);
+            }
+        }
+        poBlock->DropLock();
+    }
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char* argv[])
+{
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-max_threads") && i + 1 < argc )
+            nMaxThreads = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-iterations") && i + 1 < argc )
+            nIterations = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-size") && i + 1 < argc )
+            nRasterSize = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-blocksize") && i + 1 < argc )
+            nBlockSize = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-shared") )
+            bShared = true;
+        else if( EQUAL(argv[i], "-check") )
+            bCheck = true;
+        else if( EQUAL(argv[i], "-memory") )
+            bMemory = true;
+        else
+            Usage();
+    }
+    if( nMaxThreads < 1 || nIterations < 1 || nBlockSize < 1 ||
+        nRasterSize < nBlockSize )
+        Usage();
+
+    GDALAllRegister();
+
+    GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName("GTiff");
+    assert(poDriver);
+    char** papszOptions = NULL;
+    papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+    papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE",
+                                   CPLSPrintf("%d", nBlockSize));
+    papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE",
+                                   CPLSPrintf("%d", nBlockSize));
+    GDALDataset* poDS = poDriver->Create(pszFilename, nRasterSize, nRasterSize,
+                                         1, GDT_Byte, papszOptions);
+    CSLDestroy(papszOptions);
+    assert(poDS);
+    // Each block is filled with its index, modulo 256
+    const int nBlocksPerRow = nRasterSize / nBlockSize;
+    std::vector<GByte> abyBlock(static_cast<size_t>(nBlockSize) * nBlockSize);
+    for( int nYBlock = 0; nYBlock < nBlocksPerRow; nYBlock++ )
+    {
+        for( int nXBlock = 0; nXBlock < nBlocksPerRow; nXBlock++ )
+        {
+            std::fill(abyBlock.begin(), abyBlock.end(),
+                static_cast<GByte>((nXBlock + nYBlock * nBlocksPerRow) & 0xff));
+            CPLErr eErr = poDS->GetRasterBand(1)->WriteBlock(
+                nXBlock, nYBlock, &abyBlock[0]);
+            assert(eErr == CE_None);
+        }
+    }
+    GDALClose(poDS);
+
+    // In -shared mode, a cache miss would call the driver concurrently on
+    // the same dataset, so all the blocks must remain in the cache.
+    if( bShared && GDALGetCacheMax64() <
+            2 * static_cast<GIntBig>(nBlocksPerRow) * nBlocksPerRow *
+                nBlockSize * nBlockSize )
+    {
+        fprintf(stderr, "-shared requires GDAL_CACHEMAX to be at least "
+                "twice the size of the raster\n");
+        exit(1);
+    }
+
+    printf("GDAL_RB_CACHE_SHARDS = %s\n",
+           CPLGetConfigOption("GDAL_RB_CACHE_SHARDS", "1"));
+    printf("GDAL_RB_CACHE_POLICY = %s\n",
+           CPLGetConfigOption("GDAL_RB_CACHE_POLICY", "LRU"));
+    printf("GDAL_CACHEMAX = " CPL_FRMT_GIB " MB\n",
+           GDALGetCacheMax64() / (1024 * 1024));
+    printf("GDAL_RB_LOCK_FREE_HITS = %s\n",
+           CPLGetConfigOption("GDAL_RB_LOCK_FREE_HITS", "NO"));
+    printf("GDAL_RB_ALLOCATOR = %s\n",
+           CPLGetConfigOption("GDAL_RB_ALLOCATOR", "MALLOC"));
+
+    GDALDataset* poSharedDS = NULL;
+    if( bShared )
+    {
+        poSharedDS = (GDALDataset*)GDALOpen(pszFilename, GA_ReadOnly);
+        assert(poSharedDS);
+        GDALRasterBand* poBand = poSharedDS->GetRasterBand(1);
+        for( int nYBlock = 0; nYBlock < nBlocksPerRow; nYBlock++ )
+        {
+            for( int nXBlock = 0; nXBlock < nBlocksPerRow; nXBlock++ )
+            {
+                GDALRasterBlock* poBlock =
+                    poBand->GetLockedBlockRef(nXBlock, nYBlock);
+                assert(poBlock);
+                poBlock->DropLock();
+            }
+        }
+    }
+
+    for( int nThreads = 1; nThreads <= nMaxThreads; nThreads *= 2 )
+    {
+        // Each thread uses its own dataset handle, so that cache misses
+        // do not end up calling the driver concurrently on the same object.
+        std::vector<ThreadData> asData(nThreads);
+        for( int i = 0; i < nThreads; i++ )
+        {
+            if( bShared )
+                asData[i].poDS = poSharedDS;
+            else
+                asData[i].poDS = (GDALDataset*)GDALOpen(pszFilename, GA_ReadOnly);
+            assert(asData[i].poDS);
+            asData[i].nSeed = i + 1;
+            asData[i].nIterations = nIterations / nThreads;
+        }
+
+        GDALRasterBlock::ResetCacheStatistics();
+
+        std::vector<CPLJoinableThread*> ahThreads(nThreads);
+        const double dfStart = GetWallTime();
+        for( int i = 0; i < nThreads; i++ )
+            ahThreads[i] = CPLCreateJoinableThread(ThreadFunc, &asData[i]);
+        for( int i = 0; i < nThreads; i++ )
+            CPLJoinThread(ahThreads[i]);
+        const double dfEnd = GetWallTime();
+
+        GDALCacheStatistics sStats;
+        GDALRasterBlock::GetCacheStatistics(&sStats);
+        const GIntBig nHits = sStats.nHits;
+        const GIntBig nMisses = sStats.nMisses;
+
+        printf("%2d thread(s): %.3f s, %.0f lookups/s, hit rate %.1f %%\n",
+               nThreads, dfEnd - dfStart,
+               (dfEnd > dfStart) ? nIterations / (dfEnd - dfStart) : 0.0,
+               (nHits + nMisses > 0) ? 100.0 * nHits / (nHits + nMisses) : 0.0);
+
+        GIntBig nReserved = 0;
+        GIntBig nUsed = 0;
+        GIntBig nRequested = 0;
+        GDALRasterBlockAllocator::GetStatistics(&nReserved, &nUsed,
+                                                &nRequested);
+        if( bMemory )
+        {
+            printf("              RSS %.1f MB, slabs %.1f MB, "
+                   "%.1f MB in use, %.1f MB requested\n",
+                   GetResidentMemory() / (1024.0 * 1024),
+                   nReserved / (1024.0 * 1024), nUsed / (1024.0 * 1024),
+                   nRequested / (1024.0 * 1024));
+        }
+        if( bCheck && (nRequested > nUsed || nUsed > nReserved) )
+        {
+            fprintf(stderr, "Inconsistent block allocator statistics\n");
+            exit(1);
+        }
+
+        if( bShared )
+        {
+            if( nMisses != 0 )
+            {
+                fprintf(stderr, "Unexpected cache misses in -shared mode\n");
+                exit(1);
+            }
+        }
+        else
+        {
+            for( int i = 0; i < nThreads; i++ )
+                GDALClose(asData[i].poDS);
+        }
+    }
+    if( poSharedDS != NULL )
+        GDALClose(poSharedDS);
+
+    VSIUnlink(pszFilename);
+    GDALDestroyDriverManager();
+    CSLDestroy( argv );
+
+    return 0;
+}
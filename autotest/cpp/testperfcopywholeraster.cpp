@@ -0,0 +1,251 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Benchmark GDALDatasetCopyWholeRaster() with its NUM_THREADS option
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdal_alg.h"
+#include "gdal_priv.h"
+
+static const char* pszSrcFilename = "/vsimem/testperfcopywholeraster_src.tif";
+static const char* pszDstFilename = "/vsimem/testperfcopywholeraster_dst.tif";
+
+static void Usage()
+{
+    printf("Usage: testperfcopywholeraster [-size X] [-bands X] [-ot Type]\n");
+    printf("                               [-max_threads X] [-interleave BAND|PIXEL]\n");
+    printf("                               [-co NAME=VALUE]* [-ondisk] [-check]\n");
+    printf("\n");
+    printf("Copies a DEFLATE compressed GTiff into a new GTiff, created with\n");
+    printf("the -co options (default COMPRESS=DEFLATE, TILED=YES), with\n");
+    printf("NUM_THREADS=1,2,4,... up to -max_threads.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                            GetWallTime()                             */
+/************************************************************************/
+
+static double GetWallTime()
+{
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+/************************************************************************/
+/*                            GetChecksums()                            */
+/************************************************************************/
+
+static std::vector<int> GetChecksums(GDALDataset* poDS)
+{
+    std::vector<int> anChecksums;
+    for( int i = 0; i < poDS->GetRasterCount(); i++ )
+    {
+        GDALRasterBand* poBand = poDS->GetRasterBand(i + 1);
+        anChecksums.push_back(GDALChecksumImage((GDALRasterBandH)poBand,
+                                                0, 0,
+                                                poBand->GetXSize(),
+                                                poBand->GetYSize()));
+    }
+    return anChecksums;
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char* argv[])
+{
+    int nSize = 4096;
+    int nBands = 3;
+    int nMaxThreads = 8;
+    GDALDataType eDstDT = GDT_Byte;
+    const char* pszInterleave = NULL;
+    char** papszCreateOptions = NULL;
+    bool bCheck = false;
+
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-size") && i + 1 < argc )
+            nSize = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-bands") && i + 1 < argc )
+            nBands = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-max_threads") && i + 1 < argc )
+            nMaxThreads = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-ot") && i + 1 < argc )
+        {
+            eDstDT = GDALGetDataTypeByName(argv[++i]);
+            if( eDstDT == GDT_Unknown )
+                Usage();
+        }
+        else if( EQUAL(argv[i], "-interleave") && i + 1 < argc )
+            pszInterleave = argv[++i];
+        else if( EQUAL(argv[i], "-co") && i + 1 < argc )
+            papszCreateOptions = CSLAddString(papszCreateOptions, argv[++i]);
+        else if( EQUAL(argv[i], "-ondisk") )
+        {
+            pszSrcFilename = "testperfcopywholeraster_src.tif";
+            pszDstFilename = "testperfcopywholeraster_dst.tif";
+        }
+        else if( EQUAL(argv[i], "-check") )
+            bCheck = true;
+        else
+            Usage();
+    }
+    if( nSize < 1 || nBands < 1 || nMaxThreads < 1 )
+        Usage();
+    if( papszCreateOptions == NULL )
+    {
+        papszCreateOptions = CSLSetNameValue(papszCreateOptions, "COMPRESS", "DEFLATE");
+        papszCreateOptions = CSLSetNameValue(papszCreateOptions, "TILED", "YES");
+    }
+
+    GDALAllRegister();
+
+    GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName("GTiff");
+    assert(poDriver);
+
+/* -------------------------------------------------------------------- */
+/*      Create a compressed source with some not too compressible       */
+/*      content.                                                        */
+/* -------------------------------------------------------------------- */
+    char** papszSrcOptions = NULL;
+    papszSrcOptions = CSLSetNameValue(papszSrcOptions, "COMPRESS", "DEFLATE");
+    papszSrcOptions = CSLSetNameValue(papszSrcOptions, "TILED", "YES");
+    GDALDataset* poSrcDS = poDriver->Create(pszSrcFilename, nSize, nSize,
+                                            nBands, GDT_Byte, papszSrcOptions);
+    CSLDestroy(papszSrcOptions);
+    assert(poSrcDS);
+    std::vector<GByte> abyLine(nSize);
+    unsigned int nSeed = 1;
+    for( int iBand = 0; iBand < nBands; iBand++ )
+    {
+        for( int iY = 0; iY < nSize; iY++ )
+        {
+            for( int iX = 0; iX < nSize; iX++ )
+            {
+                nSeed = nSeed * 1103515245U + 12345U;
+                abyLine[iX] = static_cast<GByte>(((iX + iY) / 4 +
+                                                  ((nSeed >> 16) & 15)) & 255);
+            }
+            CPLErr eErr = poSrcDS->GetRasterBand(iBand + 1)->RasterIO(
+                GF_Write, 0, iY, nSize, 1, &abyLine[0], nSize, 1, GDT_Byte,
+                0, 0, NULL);
+            assert(eErr == CE_None);
+        }
+    }
+    GDALClose(poSrcDS);
+
+    poSrcDS = (GDALDataset*)GDALOpen(pszSrcFilename, GA_ReadOnly);
+    assert(poSrcDS);
+    std::vector<int> anRefChecksums;
+    if( bCheck )
+        anRefChecksums = GetChecksums(poSrcDS);
+
+    printf("%dx%dx%d, %s, GDAL_CACHEMAX = " CPL_FRMT_GIB " MB\n",
+           nSize, nSize, nBands, GDALGetDataTypeName(eDstDT),
+           GDALGetCacheMax64() / (1024 * 1024));
+
+    int nRet = 0;
+    for( int nThreads = 1; nThreads <= nMaxThreads; nThreads *= 2 )
+    {
+        // Start each copy with a cold cache
+        GDALClose(poSrcDS);
+        poSrcDS = (GDALDataset*)GDALOpen(pszSrcFilename, GA_ReadOnly);
+        assert(poSrcDS);
+
+        GDALDataset* poDstDS = poDriver->Create(pszDstFilename, nSize, nSize,
+                                                nBands, eDstDT,
+                                                papszCreateOptions);
+        assert(poDstDS);
+
+        char** papszCopyOptions = NULL;
+        papszCopyOptions = CSLSetNameValue(papszCopyOptions, "COMPRESSED", "YES");
+        papszCopyOptions = CSLSetNameValue(papszCopyOptions, "NUM_THREADS",
+                                           CPLSPrintf("%d", nThreads));
+        if( pszInterleave )
+            papszCopyOptions = CSLSetNameValue(papszCopyOptions, "INTERLEAVE",
+                                               pszInterleave);
+
+        const double dfStart = GetWallTime();
+        CPLErr eErr = GDALDatasetCopyWholeRaster((GDALDatasetH)poSrcDS,
+                                                 (GDALDatasetH)poDstDS,
+                                                 papszCopyOptions, NULL, NULL);
+        GDALClose(poDstDS);
+        const double dfEnd = GetWallTime();
+        CSLDestroy(papszCopyOptions);
+
+        printf("NUM_THREADS=%d: %.3f s\n", nThreads, dfEnd - dfStart);
+        if( eErr != CE_None )
+        {
+            printf("GDALDatasetCopyWholeRaster() failed\n");
+            nRet = 1;
+        }
+
+        if( bCheck )
+        {
+            poDstDS = (GDALDataset*)GDALOpen(pszDstFilename, GA_ReadOnly);
+            assert(poDstDS);
+            if( GetChecksums(poDstDS) != anRefChecksums )
+            {
+                printf("Checksum mismatch with NUM_THREADS=%d\n", nThreads);
+                nRet = 1;
+            }
+            GDALClose(poDstDS);
+        }
+        VSIUnlink(pszDstFilename);
+    }
+
+    GDALClose(poSrcDS);
+    VSIUnlink(pszSrcFilename);
+    CSLDestroy(papszCreateOptions);
+    GDALDestroyDriverManager();
+    CSLDestroy( argv );
+
+    return nRet;
+}
@@ -32,52 +32,111 @@
 #include <time.h>
 
 #include "gdal.h"
+#include "cpl_string.h"
 
-int main(int /* argc */, char* /* argv */ [])
+static void Usage()
 {
-    void* in = calloc(1, 256 * 256 * 16);
-    void* out = malloc(256 * 256 * 16);
+    printf("Usage: testperfcopywords [-iterations X] [-size X] [-it Type] [-ot Type]\n");
+    printf("                         [--config GDAL_USE_AVX2 NO]\n");
+    printf("\n");
+    printf("Times GDALCopyWords() for all input/output data type pairs, with\n");
+    printf("a stride of 16 bytes, packed, and pixel-interleaved (3 words) buffers.\n");
+    exit(1);
+}
 
-    int i;
-    int intype, outtype;
+static void Bench(void* in, GDALDataType intype, int instride,
+                  void* out, GDALDataType outtype, int outstride,
+                  int nWordCount, int nIterations, const char* pszSuffix)
+{
+    clock_t start = clock();
 
-    clock_t start, end;
+    for(int i=0;i<nIterations;i++)
+        GDALCopyWords(in, intype, instride, out, outtype, outstride, nWordCount);
 
-    for(intype=GDT_Byte;intype<=GDT_CFloat64;intype++)
+    clock_t end = clock();
+
+    printf("%s -> %s%s : %.2f s\n",
+           GDALGetDataTypeName(intype),
+           GDALGetDataTypeName(outtype),
+           pszSuffix,
+           (end - start) * 1.0 / CLOCKS_PER_SEC);
+}
+
+int main(int argc, char* argv[])
+{
+    int nIterations = 1000;
+    int nWordCount = 256 * 256;
+    GDALDataType eInType = GDT_Unknown;
+    GDALDataType eOutType = GDT_Unknown;
+
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int i = 1; i < argc; i++ )
     {
-        for(outtype=GDT_Byte;outtype<=GDT_CFloat64;outtype++)
+        if( EQUAL(argv[i], "-iterations") && i + 1 < argc )
+            nIterations = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-size") && i + 1 < argc )
+            nWordCount = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-it") && i + 1 < argc )
         {
-            start = clock();
-
-            for(i=0;i<1000;i++)
-                GDALCopyWords(in, (GDALDataType)intype, 16, out, (GDALDataType)outtype, 16, 256 * 256);
+            eInType = GDALGetDataTypeByName(argv[++i]);
+            if( eInType == GDT_Unknown )
+                Usage();
+        }
+        else if( EQUAL(argv[i], "-ot") && i + 1 < argc )
+        {
+            eOutType = GDALGetDataTypeByName(argv[++i]);
+            if( eOutType == GDT_Unknown )
+                Usage();
+        }
+        else
+            Usage();
+    }
+    if( nIterations < 1 || nWordCount < 1 )
+        Usage();
 
-            end = clock();
+    /* 16 bytes is the size of the largest data type, and 3 words are used */
+    /* for the pixel-interleaved case. */
+    void* in = calloc(1, (size_t)nWordCount * 16 * 3);
+    void* out = malloc((size_t)nWordCount * 16 * 3);
+    if( in == NULL || out == NULL )
+    {
+        printf("Out of memory\n");
+        exit(1);
+    }
 
-            printf("%s -> %s : %.2f s\n",
-                   GDALGetDataTypeName((GDALDataType)intype),
-                   GDALGetDataTypeName((GDALDataType)outtype),
-                   (end - start) * 1.0 / CLOCKS_PER_SEC);
+    int intype, outtype;
 
-            start = clock();
+    for(intype=GDT_Byte;intype<=GDT_CFloat64;intype++)
+    {
+        if( eInType != GDT_Unknown && intype != eInType )
+            continue;
+        const int nInSize = GDALGetDataTypeSize((GDALDataType)intype) / 8;
+        for(outtype=GDT_Byte;outtype<=GDT_CFloat64;outtype++)
+        {
+            if( eOutType != GDT_Unknown && outtype != eOutType )
+                continue;
+            const int nOutSize = GDALGetDataTypeSize((GDALDataType)outtype) / 8;
 
-            for(i=0;i<1000;i++)
-                GDALCopyWords(in,
-                              (GDALDataType)intype,
-                              GDALGetDataTypeSize((GDALDataType)intype) / 8,
-                              out,
-                              (GDALDataType)outtype, 
-                              GDALGetDataTypeSize((GDALDataType)outtype) / 8,
-                              256 * 256);
+            Bench(in, (GDALDataType)intype, 16,
+                  out, (GDALDataType)outtype, 16,
+                  nWordCount, nIterations, "");
 
-            end = clock();
+            Bench(in, (GDALDataType)intype, nInSize,
+                  out, (GDALDataType)outtype, nOutSize,
+                  nWordCount, nIterations, " (packed)");
 
-            printf("%s -> %s (packed) : %.2f s\n",
-                   GDALGetDataTypeName((GDALDataType)intype),
-                   GDALGetDataTypeName((GDALDataType)outtype),
-                   (end - start) * 1.0 / CLOCKS_PER_SEC);
+            Bench(in, (GDALDataType)intype, 3 * nInSize,
+                  out, (GDALDataType)outtype, 3 * nOutSize,
+                  nWordCount, nIterations, " (interleaved)");
         }
     }
 
+    free(in);
+    free(out);
+    CSLDestroy(argv);
+
     return 0;
 }
@@ -0,0 +1,330 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Benchmark the compression ratio and speed of the GTiff codecs
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <assert.h>
+#include <string.h>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "gdal_priv.h"
+
+static const char* pszFilename = "/vsimem/testperfgtiffcodecs.tif";
+
+static const char* const apszDefaultCodecs[] =
+    { "NONE", "PACKBITS", "LZW", "DEFLATE", "LZMA", "ZSTD",
+      "LERC", "LERC_DEFLATE", "LERC_ZSTD" };
+
+static void Usage()
+{
+    printf("Usage: testperfgtiffcodecs [-data elevation|imagery] [-size X]\n");
+    printf("                           [-codec NAME]* [-predictor] [-max_z_error X]\n");
+    printf("                           [-iterations X] [-co NAME=VALUE]* [-check]\n");
+    printf("\n");
+    printf("Writes synthetic elevation (Float32) or imagery (3 band Byte) data\n");
+    printf("to a tiled GTiff with each codec available, and reports the\n");
+    printf("compressed size and the encoding and decoding speeds.\n");
+    printf("-predictor applies the appropriate predictor to the LZW, DEFLATE\n");
+    printf("and ZSTD codecs. -max_z_error applies to the LERC codecs.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                            GetWallTime()                             */
+/************************************************************************/
+
+static double GetWallTime()
+{
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+/************************************************************************/
+/*                           GenerateData()                             */
+/*                                                                      */
+/*      Elevation is a smooth surface with some small scale roughness,  */
+/*      imagery is made of noisy gradients, as found on natural scenes. */
+/************************************************************************/
+
+static void GenerateData(bool bElevation, int nSize, int nBands,
+                         std::vector<GByte>& abyData)
+{
+    unsigned int nSeed = 1;
+    if( bElevation )
+    {
+        abyData.resize(static_cast<size_t>(nSize) * nSize * sizeof(float));
+        float* pafData = reinterpret_cast<float*>(&abyData[0]);
+        for( int iY = 0; iY < nSize; iY++ )
+        {
+            for( int iX = 0; iX < nSize; iX++ )
+            {
+                nSeed = nSeed * 1103515245U + 12345U;
+                const double dfNoise = ((nSeed >> 16) & 1023) / 1023.0 - 0.5;
+                pafData[static_cast<size_t>(iY) * nSize + iX] =
+                    static_cast<float>(
+                        1000.0 + 300.0 * sin(iX / 150.0) * cos(iY / 230.0) +
+                        40.0 * sin((iX + 2 * iY) / 35.0) + dfNoise);
+            }
+        }
+    }
+    else
+    {
+        abyData.resize(static_cast<size_t>(nSize) * nSize * nBands);
+        for( int iBand = 0; iBand < nBands; iBand++ )
+        {
+            for( int iY = 0; iY < nSize; iY++ )
+            {
+                for( int iX = 0; iX < nSize; iX++ )
+                {
+                    nSeed = nSeed * 1103515245U + 12345U;
+                    abyData[(static_cast<size_t>(iBand) * nSize + iY) * nSize +
+                            iX] = static_cast<GByte>(
+                        ((iX + iY) / 8 + iBand * 40 +
+                         ((nSeed >> 16) & 15)) & 255);
+                }
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char* argv[])
+{
+    int nSize = 2048;
+    int nIterations = 3;
+    bool bElevation = true;
+    bool bPredictor = false;
+    bool bCheck = false;
+    double dfMaxZError = 0.0;
+    std::vector<CPLString> aosCodecs;
+    char** papszCreateOptions = NULL;
+
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-data") && i + 1 < argc )
+        {
+            ++i;
+            if( EQUAL(argv[i], "elevation") )
+                bElevation = true;
+            else if( EQUAL(argv[i], "imagery") )
+                bElevation = false;
+            else
+                Usage();
+        }
+        else if( EQUAL(argv[i], "-size") && i + 1 < argc )
+            nSize = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-codec") && i + 1 < argc )
+            aosCodecs.push_back(argv[++i]);
+        else if( EQUAL(argv[i], "-predictor") )
+            bPredictor = true;
+        else if( EQUAL(argv[i], "-max_z_error") && i + 1 < argc )
+            dfMaxZError = CPLAtof(argv[++i]);
+        else if( EQUAL(argv[i], "-iterations") && i + 1 < argc )
+            nIterations = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-co") && i + 1 < argc )
+            papszCreateOptions = CSLAddString(papszCreateOptions, argv[++i]);
+        else if( EQUAL(argv[i], "-check") )
+            bCheck = true;
+        else
+            Usage();
+    }
+    if( nSize < 1 || nIterations < 1 || dfMaxZError < 0 )
+        Usage();
+
+    GDALAllRegister();
+
+    GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName("GTiff");
+    assert(poDriver);
+    const char* pszCreationOptionList =
+        poDriver->GetMetadataItem(GDAL_DMD_CREATIONOPTIONLIST);
+    if( aosCodecs.empty() )
+    {
+        for( size_t i = 0; i < sizeof(apszDefaultCodecs) /
+                                    sizeof(apszDefaultCodecs[0]); i++ )
+        {
+            if( strstr(pszCreationOptionList,
+                       CPLSPrintf("<Value>%s</Value>",
+                                  apszDefaultCodecs[i])) != NULL )
+                aosCodecs.push_back(apszDefaultCodecs[i]);
+        }
+    }
+
+    const int nBands = bElevation ? 1 : 3;
+    const GDALDataType eDT = bElevation ? GDT_Float32 : GDT_Byte;
+    const int nDTSize = GDALGetDataTypeSize(eDT) / 8;
+    std::vector<GByte> abyData;
+    GenerateData(bElevation, nSize, nBands, abyData);
+    const double dfRawMB = abyData.size() / (1024.0 * 1024.0);
+
+    printf("%s, %dx%dx%d, %s, %.1f MB uncompressed\n",
+           bElevation ? "elevation" : "imagery",
+           nSize, nSize, nBands, GDALGetDataTypeName(eDT), dfRawMB);
+    printf("%-14s %12s %8s %14s %14s\n",
+           "codec", "bytes", "ratio", "encode MB/s", "decode MB/s");
+
+    int nRet = 0;
+    std::vector<GByte> abyRead(abyData.size());
+    for( size_t iCodec = 0; iCodec < aosCodecs.size(); iCodec++ )
+    {
+        const char* pszCodec = aosCodecs[iCodec];
+        const bool bLerc = STARTS_WITH_CI(pszCodec, "LERC");
+        char** papszOptions = CSLDuplicate(papszCreateOptions);
+        if( CSLFetchNameValue(papszOptions, "TILED") == NULL )
+            papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+        papszOptions = CSLSetNameValue(papszOptions, "COMPRESS", pszCodec);
+        if( bPredictor && (EQUAL(pszCodec, "LZW") ||
+                           EQUAL(pszCodec, "DEFLATE") ||
+                           EQUAL(pszCodec, "ZSTD")) )
+        {
+            papszOptions = CSLSetNameValue(papszOptions, "PREDICTOR",
+                                           bElevation ? "3" : "2");
+        }
+        if( bLerc && dfMaxZError > 0 )
+        {
+            papszOptions = CSLSetNameValue(papszOptions, "MAX_Z_ERROR",
+                                           CPLSPrintf("%.18g", dfMaxZError));
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Encode.                                                         */
+/* -------------------------------------------------------------------- */
+        double dfEncodeTime = 0.0;
+        for( int iIter = 0; iIter < nIterations; iIter++ )
+        {
+            VSIUnlink(pszFilename);
+            const double dfStart = GetWallTime();
+            GDALDataset* poDS = poDriver->Create(pszFilename, nSize, nSize,
+                                                 nBands, eDT, papszOptions);
+            if( poDS == NULL )
+                break;
+            CPLErr eErr = poDS->RasterIO(GF_Write, 0, 0, nSize, nSize,
+                                         &abyData[0], nSize, nSize, eDT,
+                                         nBands, NULL, 0, 0, 0, NULL);
+            GDALClose(poDS);
+            const double dfTime = GetWallTime() - dfStart;
+            if( eErr != CE_None )
+            {
+                printf("Writing with COMPRESS=%s failed\n", pszCodec);
+                nRet = 1;
+            }
+            if( iIter == 0 || dfTime < dfEncodeTime )
+                dfEncodeTime = dfTime;
+        }
+        CSLDestroy(papszOptions);
+
+        VSIStatBufL sStat;
+        if( VSIStatL(pszFilename, &sStat) != 0 )
+        {
+            printf("%-14s %12s\n", pszCodec, "failed");
+            nRet = 1;
+            continue;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Decode.                                                         */
+/* -------------------------------------------------------------------- */
+        double dfDecodeTime = 0.0;
+        for( int iIter = 0; iIter < nIterations; iIter++ )
+        {
+            const double dfStart = GetWallTime();
+            GDALDataset* poDS = (GDALDataset*)GDALOpen(pszFilename,
+                                                       GA_ReadOnly);
+            assert(poDS);
+            CPLErr eErr = poDS->RasterIO(GF_Read, 0, 0, nSize, nSize,
+                                         &abyRead[0], nSize, nSize, eDT,
+                                         nBands, NULL, 0, 0, 0, NULL);
+            GDALClose(poDS);
+            const double dfTime = GetWallTime() - dfStart;
+            if( eErr != CE_None )
+            {
+                printf("Reading with COMPRESS=%s failed\n", pszCodec);
+                nRet = 1;
+            }
+            if( iIter == 0 || dfTime < dfDecodeTime )
+                dfDecodeTime = dfTime;
+        }
+
+        printf("%-14s %12d %8.2f %14.1f %14.1f\n",
+               pszCodec, static_cast<int>(sStat.st_size),
+               static_cast<double>(abyData.size()) / sStat.st_size,
+               dfRawMB / dfEncodeTime, dfRawMB / dfDecodeTime);
+
+        if( bCheck )
+        {
+            // LERC is allowed to be lossy within the requested error
+            const double dfTolerance = bLerc ? dfMaxZError : 0.0;
+            for( size_t i = 0; i < abyData.size() / nDTSize; i++ )
+            {
+                double dfDiff;
+                if( bElevation )
+                    dfDiff = fabs(reinterpret_cast<float*>(&abyRead[0])[i] -
+                                  reinterpret_cast<float*>(&abyData[0])[i]);
+                else
+                    dfDiff = fabs(static_cast<double>(abyRead[i]) -
+                                  abyData[i]);
+                if( !(dfDiff <= dfTolerance) )
+                {
+                    printf("Mismatch with COMPRESS=%s at value %d\n",
+                           pszCodec, static_cast<int>(i));
+                    nRet = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    VSIUnlink(pszFilename);
+    CSLDestroy(papszCreateOptions);
+    GDALDestroyDriverManager();
+    CSLDestroy( argv );
+
+    return nRet;
+}
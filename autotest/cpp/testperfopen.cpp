@@ -0,0 +1,252 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Benchmark the latency of GDALOpenEx() with and without the
+ *           driver signature index
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdal_priv.h"
+
+static void Usage()
+{
+    printf("Usage: testperfopen [-iterations X] [-check] [filename]*\n");
+    printf("\n");
+    printf("Opens each file X times (default 1000) with GDAL_OPEN_USE_SIGNATURES\n");
+    printf("set to NO and YES. Without filename, a corpus of small files in\n");
+    printf("various formats is generated in /vsimem.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                            GetWallTime()                             */
+/************************************************************************/
+
+static double GetWallTime()
+{
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+/************************************************************************/
+/*                            CreateCorpus()                            */
+/************************************************************************/
+
+static std::vector<CPLString> CreateCorpus()
+{
+    std::vector<CPLString> aosFiles;
+
+    GDALDriver* poMEMDriver = (GDALDriver*)GDALGetDriverByName("MEM");
+    if( poMEMDriver == NULL )
+        return aosFiles;
+    GDALDataset* poSrcDS = poMEMDriver->Create("", 16, 16, 1, GDT_Byte, NULL);
+    GByte abyData[16 * 16];
+    for( int i = 0; i < 16 * 16; i++ )
+        abyData[i] = (GByte)i;
+    if( poSrcDS->RasterIO(GF_Write, 0, 0, 16, 16, abyData, 16, 16, GDT_Byte,
+                          1, NULL, 0, 0, 0, NULL) != CE_None )
+    {
+        printf("Cannot write the source raster of the corpus\n");
+        GDALClose(poSrcDS);
+        return aosFiles;
+    }
+
+    const char* const apszFormats[] = { "GTiff", "tif", "PNG", "png",
+                                        "JPEG", "jpg", "GIF", "gif",
+                                        "BMP", "bmp", "HFA", "img",
+                                        "ENVI", "bin", "AAIGrid", "asc" };
+    for( size_t i = 0; i < sizeof(apszFormats) / sizeof(apszFormats[0]);
+         i += 2 )
+    {
+        GDALDriver* poDriver = (GDALDriver*)GDALGetDriverByName(apszFormats[i]);
+        if( poDriver == NULL )
+            continue;
+        CPLString osFilename(CPLSPrintf("/vsimem/testperfopen/test.%s",
+                                        apszFormats[i+1]));
+        GDALDataset* poDS = poDriver->CreateCopy(osFilename, poSrcDS, FALSE,
+                                                 NULL, NULL, NULL);
+        if( poDS == NULL )
+            continue;
+        GDALClose(poDS);
+        aosFiles.push_back(osFilename);
+    }
+    GDALClose(poSrcDS);
+
+    // A file that no driver recognizes
+    CPLString osFilename("/vsimem/testperfopen/unknown.dat");
+    VSILFILE* fp = VSIFOpenL(osFilename, "wb");
+    if( fp != NULL )
+    {
+        for( int i = 0; i < 1024; i++ )
+        {
+            GByte byVal = (GByte)((i * 37) & 255);
+            VSIFWriteL(&byVal, 1, 1, fp);
+        }
+        VSIFCloseL(fp);
+        aosFiles.push_back(osFilename);
+    }
+
+    return aosFiles;
+}
+
+/************************************************************************/
+/*                           GetDriverName()                            */
+/************************************************************************/
+
+static CPLString GetDriverName(const char* pszFilename)
+{
+    CPLString osDriver("(none)");
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    GDALDatasetH hDS = GDALOpenEx(pszFilename, GDAL_OF_RASTER | GDAL_OF_VECTOR,
+                                  NULL, NULL, NULL);
+    CPLPopErrorHandler();
+    if( hDS != NULL )
+    {
+        osDriver = GDALGetDriverShortName(GDALGetDatasetDriver(hDS));
+        GDALClose(hDS);
+    }
+    return osDriver;
+}
+
+/************************************************************************/
+/*                             TimeOpens()                              */
+/************************************************************************/
+
+static double TimeOpens(const char* pszFilename, int nIterations)
+{
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    const double dfStart = GetWallTime();
+    for( int i = 0; i < nIterations; i++ )
+    {
+        GDALDatasetH hDS = GDALOpenEx(pszFilename,
+                                      GDAL_OF_RASTER | GDAL_OF_VECTOR,
+                                      NULL, NULL, NULL);
+        if( hDS != NULL )
+            GDALClose(hDS);
+    }
+    const double dfEnd = GetWallTime();
+    CPLPopErrorHandler();
+    return (dfEnd - dfStart) * 1e6 / nIterations;
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char* argv[])
+{
+    int nIterations = 1000;
+    bool bCheck = false;
+    std::vector<CPLString> aosFiles;
+
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-iterations") && i + 1 < argc )
+            nIterations = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-check") )
+            bCheck = true;
+        else if( argv[i][0] == '-' )
+            Usage();
+        else
+            aosFiles.push_back(argv[i]);
+    }
+    if( nIterations < 1 )
+        Usage();
+
+    GDALAllRegister();
+
+    const bool bCorpus = aosFiles.empty();
+    if( bCorpus )
+        aosFiles = CreateCorpus();
+
+    printf("%d drivers registered, %d iterations\n",
+           GDALGetDriverCount(), nIterations);
+    printf("%-40s %-10s %12s %12s\n", "File", "Driver",
+           "linear (us)", "index (us)");
+
+    int nRet = 0;
+    if( bCheck && aosFiles.empty() )
+        nRet = 1;
+    double dfTotalLinear = 0.0;
+    double dfTotalIndex = 0.0;
+    for( size_t i = 0; i < aosFiles.size(); i++ )
+    {
+        const char* pszFilename = aosFiles[i].c_str();
+
+        CPLSetConfigOption("GDAL_OPEN_USE_SIGNATURES", "NO");
+        CPLString osDriverLinear = GetDriverName(pszFilename);
+        const double dfLinear = TimeOpens(pszFilename, nIterations);
+
+        CPLSetConfigOption("GDAL_OPEN_USE_SIGNATURES", "YES");
+        CPLString osDriverIndex = GetDriverName(pszFilename);
+        const double dfIndex = TimeOpens(pszFilename, nIterations);
+        CPLSetConfigOption("GDAL_OPEN_USE_SIGNATURES", NULL);
+
+        printf("%-40s %-10s %12.1f %12.1f\n", CPLGetFilename(pszFilename),
+               osDriverIndex.c_str(), dfLinear, dfIndex);
+        dfTotalLinear += dfLinear;
+        dfTotalIndex += dfIndex;
+
+        if( bCheck && osDriverLinear != osDriverIndex )
+        {
+            printf("Driver mismatch for %s: %s with linear scan, %s with index\n",
+                   pszFilename, osDriverLinear.c_str(), osDriverIndex.c_str());
+            nRet = 1;
+        }
+    }
+    printf("%-40s %-10s %12.1f %12.1f\n", "Total", "",
+           dfTotalLinear, dfTotalIndex);
+
+    if( bCorpus )
+    {
+        for( size_t i = 0; i < aosFiles.size(); i++ )
+            VSIUnlink(aosFiles[i]);
+    }
+    GDALDestroyDriverManager();
+    CSLDestroy( argv );
+
+    return nRet;
+}
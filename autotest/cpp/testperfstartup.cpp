@@ -0,0 +1,212 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Benchmark the cost of GDALAllRegister() followed by a first
+ *           GDALOpen(), with eager and lazy driver metadata
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdal_priv.h"
+
+static void Usage()
+{
+    printf("Usage: testperfstartup [-iterations X] [-check] [filename]\n");
+    printf("\n");
+    printf("Times X times (default 100) GDALAllRegister() followed by the\n");
+    printf("opening of filename (default ../gcore/data/byte.tif), with\n");
+    printf("GDAL_LAZY_DRIVER_METADATA set to NO and YES.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                            GetWallTime()                             */
+/************************************************************************/
+
+static double GetWallTime()
+{
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+/************************************************************************/
+/*                             TimeStartup()                            */
+/************************************************************************/
+
+static void TimeStartup(const char* pszFilename, const char* pszLazy,
+                        int nIterations,
+                        double& dfRegister, double& dfOpen, bool& bOpenOK)
+{
+    dfRegister = 0.0;
+    dfOpen = 0.0;
+    bOpenOK = true;
+    for( int i = 0; i < nIterations; i++ )
+    {
+        // GDALDestroyDriverManager() resets the configuration options
+        CPLSetConfigOption("GDAL_LAZY_DRIVER_METADATA", pszLazy);
+        const double dfStart = GetWallTime();
+        GDALAllRegister();
+        const double dfRegistered = GetWallTime();
+        GDALDatasetH hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        const double dfOpened = GetWallTime();
+        if( hDS == NULL )
+            bOpenOK = false;
+        else
+            GDALClose(hDS);
+        GDALDestroyDriverManager();
+
+        dfRegister += dfRegistered - dfStart;
+        dfOpen += dfOpened - dfRegistered;
+    }
+    dfRegister = dfRegister * 1e6 / nIterations;
+    dfOpen = dfOpen * 1e6 / nIterations;
+}
+
+/************************************************************************/
+/*                          CollectMetadata()                           */
+/*                                                                      */
+/*      Registers all drivers and returns their full default domain     */
+/*      metadata, by driver name.                                       */
+/************************************************************************/
+
+static std::map<CPLString, CPLString> CollectMetadata()
+{
+    std::map<CPLString, CPLString> oMap;
+    GDALAllRegister();
+    for( int i = 0; i < GDALGetDriverCount(); i++ )
+    {
+        GDALDriverH hDriver = GDALGetDriver(i);
+        CPLString osMD;
+        for( char** papszIter = GDALGetMetadata(hDriver, NULL);
+             papszIter && *papszIter; ++papszIter )
+        {
+            osMD += *papszIter;
+            osMD += "\n";
+        }
+        oMap[GDALGetDescription(hDriver)] = osMD;
+    }
+    GDALDestroyDriverManager();
+    return oMap;
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char* argv[])
+{
+    int nIterations = 100;
+    bool bCheck = false;
+    const char* pszFilename = "../gcore/data/byte.tif";
+
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-iterations") && i + 1 < argc )
+            nIterations = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-check") )
+            bCheck = true;
+        else if( argv[i][0] == '-' )
+            Usage();
+        else
+            pszFilename = argv[i];
+    }
+    if( nIterations < 1 )
+        Usage();
+
+    // GDALGeneralCmdLineProcessor() has registered the drivers
+    GDALDestroyDriverManager();
+
+    printf("%d iterations, opening %s\n", nIterations, pszFilename);
+    printf("%-10s %18s %18s %12s\n", "Metadata", "AllRegister (us)",
+           "first open (us)", "total (us)");
+
+    int nRet = 0;
+    const char* const apszModes[] = { "NO", "YES" };
+    for( int iMode = 0; iMode < 2; iMode++ )
+    {
+        double dfRegister = 0.0;
+        double dfOpen = 0.0;
+        bool bOpenOK = true;
+        TimeStartup(pszFilename, apszModes[iMode], nIterations,
+                    dfRegister, dfOpen, bOpenOK);
+        printf("%-10s %18.1f %18.1f %12.1f\n",
+               iMode == 0 ? "eager" : "lazy",
+               dfRegister, dfOpen, dfRegister + dfOpen);
+        if( bCheck && !bOpenOK )
+        {
+            printf("Cannot open %s\n", pszFilename);
+            nRet = 1;
+        }
+    }
+
+    if( bCheck )
+    {
+        CPLSetConfigOption("GDAL_LAZY_DRIVER_METADATA", "NO");
+        std::map<CPLString, CPLString> oEager = CollectMetadata();
+        CPLSetConfigOption("GDAL_LAZY_DRIVER_METADATA", "YES");
+        std::map<CPLString, CPLString> oLazy = CollectMetadata();
+        if( oEager.size() != oLazy.size() )
+        {
+            printf("Driver count mismatch: %d eager, %d lazy\n",
+                   (int)oEager.size(), (int)oLazy.size());
+            nRet = 1;
+        }
+        for( std::map<CPLString, CPLString>::iterator oIter = oEager.begin();
+             oIter != oEager.end(); ++oIter )
+        {
+            if( oLazy[oIter->first] != oIter->second )
+            {
+                printf("Metadata mismatch for driver %s\n",
+                       oIter->first.c_str());
+                nRet = 1;
+            }
+        }
+    }
+    CPLSetConfigOption("GDAL_LAZY_DRIVER_METADATA", NULL);
+
+    CSLDestroy( argv );
+
+    return nRet;
+}
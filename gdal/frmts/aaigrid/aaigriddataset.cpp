@@ -1306,27 +1306,18 @@ static CPLString OSR_GDS( char **papszNV, const char * pszField,
 }
 
 /************************************************************************/
-/*                        GDALRegister_AAIGrid()                        */
+/*                     AAIGridDriverInitMetadata()                      */
 /************************************************************************/
 
-void GDALRegister_AAIGrid()
+static void AAIGridDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "AAIGrid" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "AAIGrid" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Arc/Info ASCII Grid" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
                                "frmt_various.html#AAIGrid" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "asc" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte UInt16 Int16 Int32 Float32" );
-
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>\n"
 "   <Option name='FORCE_CELLSIZE' type='boolean' description='Force use of CELLSIZE, default is FALSE.'/>\n"
@@ -1341,14 +1332,45 @@ void GDALRegister_AAIGrid()
 "       <Value>Float64</Value>\n"
 "   </Option>\n"
 "</OpenOptionLists>\n" );
+}
+
+/************************************************************************/
+/*                        GDALRegister_AAIGrid()                        */
+/************************************************************************/
+
+void GDALRegister_AAIGrid()
+
+{
+    if( GDALGetDriverByName( "AAIGrid" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "AAIGrid" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
+
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = AAIGDataset::Open;
     poDriver->pfnIdentify = AAIGDataset::Identify;
     poDriver->pfnCreateCopy = AAIGDataset::CreateCopy;
+    poDriver->pfnInitMetadata = AAIGridDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
 
+/************************************************************************/
+/*                  GRASSASCIIGridDriverInitMetadata()                  */
+/************************************************************************/
+
+static void GRASSASCIIGridDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GRASS ASCII Grid" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#GRASSASCIIGrid" );
+}
+
 /************************************************************************/
 /*                   GDALRegister_GRASSASCIIGrid()                      */
 /************************************************************************/
@@ -1363,14 +1385,12 @@ void GDALRegister_GRASSASCIIGrid()
 
     poDriver->SetDescription( "GRASSASCIIGrid" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GRASS ASCII Grid" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#GRASSASCIIGrid" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = GRASSASCIIDataset::Open;
     poDriver->pfnIdentify = GRASSASCIIDataset::Identify;
+    poDriver->pfnInitMetadata = GRASSASCIIGridDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -2241,6 +2241,23 @@ void ADRGDataset::WriteTHFFile()
     }
 }
 
+/************************************************************************/
+/*                       ADRGDriverInitMetadata()                       */
+/************************************************************************/
+
+static void ADRGDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "ARC Digitized Raster Graphics" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#ADRG" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gen" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_ADRG()                          */
 /************************************************************************/
@@ -2255,18 +2272,11 @@ void GDALRegister_ADRG()
 
     poDriver->SetDescription( "ADRG" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "ARC Digitized Raster Graphics" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#ADRG" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gen" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ADRGDataset::Open;
     poDriver->pfnCreate = ADRGDataset::Create;
+    poDriver->pfnInitMetadata = ADRGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
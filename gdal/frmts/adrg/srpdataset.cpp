@@ -1616,6 +1616,20 @@ GDALDataset *SRPDataset::Open( GDALOpenInfo * poOpenInfo )
     return NULL;
 }
 
+/************************************************************************/
+/*                       SRPDriverInitMetadata()                        */
+/************************************************************************/
+
+static void SRPDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Standard Raster Product (ASRP/USRP)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#SRP" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "img" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_SRP()                          */
 /************************************************************************/
@@ -1630,14 +1644,10 @@ void GDALRegister_SRP()
 
     poDriver->SetDescription( "SRP" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Standard Raster Product (ASRP/USRP)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#SRP" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "img" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = SRPDataset::Open;
+    poDriver->pfnInitMetadata = SRPDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
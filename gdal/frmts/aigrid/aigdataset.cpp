@@ -1059,6 +1059,19 @@ static CPLErr AIGDelete( const char *pszDatasetname )
 /*                          GDALRegister_AIG()                          */
 /************************************************************************/
 
+/************************************************************************/
+/*                      AIGridDriverInitMetadata()                      */
+/************************************************************************/
+
+static void AIGridDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Arc/Info Binary Grid" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#AIG" );
+}
+
 void GDALRegister_AIGrid()
 
 {
@@ -1069,16 +1082,13 @@ void GDALRegister_AIGrid()
 
     poDriver->SetDescription( "AIG" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Arc/Info Binary Grid" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#AIG" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = AIGDataset::Open;
 
     poDriver->pfnRename = AIGRename;
     poDriver->pfnDelete = AIGDelete;
+    poDriver->pfnInitMetadata = AIGridDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -628,6 +628,18 @@ GDALDataset *AirSARDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                      AirSARDriverInitMetadata()                      */
+/************************************************************************/
+
+static void AirSARDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "AirSAR Polarimetric Image" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_airsar.html" );
+}
+
 /************************************************************************/
 /*                        GDALRegister_AirSAR()                         */
 /************************************************************************/
@@ -642,13 +654,11 @@ void GDALRegister_AirSAR()
 
     poDriver->SetDescription( "AirSAR" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "AirSAR Polarimetric Image" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_airsar.html" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = AirSARDataset::Open;
+    poDriver->pfnInitMetadata = AirSARDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -773,6 +773,19 @@ GDALDataset *ARGDataset::CreateCopy( const char *pszFilename,
     return reinterpret_cast<GDALDataset *>( GDALOpen( pszFilename, GA_ReadOnly ) );
 }
 
+/************************************************************************/
+/*                       ARGDriverInitMetadata()                        */
+/************************************************************************/
+
+static void ARGDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Azavea Raster Grid format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#ARG" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_ARG()                          */
 /************************************************************************/
@@ -786,15 +799,12 @@ void GDALRegister_ARG()
 
     poDriver->SetDescription( "ARG" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Azavea Raster Grid format" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#ARG" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnIdentify = ARGDataset::Identify;
     poDriver->pfnOpen = ARGDataset::Open;
     poDriver->pfnCreateCopy = ARGDataset::CreateCopy;
+    poDriver->pfnInitMetadata = ARGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -421,6 +421,20 @@ BLXCreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
 }
 
 
+/************************************************************************/
+/*                       BLXDriverInitMetadata()                        */
+/************************************************************************/
+
+static void BLXDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Magellan topo (.blx)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#BLX" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "blx" );
+}
+
 void GDALRegister_BLX()
 
 {
@@ -431,16 +445,12 @@ void GDALRegister_BLX()
 
     poDriver->SetDescription( "BLX" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Magellan topo (.blx)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#BLX" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "blx" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = BLXDataset::Open;
     poDriver->pfnCreateCopy = BLXCreateCopy;
+    poDriver->pfnInitMetadata = BLXDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1563,19 +1563,12 @@ GDALDataset *BMPDataset::Create( const char * pszFilename,
 }
 
 /************************************************************************/
-/*                        GDALRegister_BMP()                            */
+/*                       BMPDriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_BMP()
+static void BMPDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "BMP" ) != NULL )
-      return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "BMP" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "MS Windows Device Independent Bitmap" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
@@ -1586,12 +1579,29 @@ void GDALRegister_BMP()
 "<CreationOptionList>"
 "   <Option name='WORLDFILE' type='boolean' description='Write out world file'/>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                        GDALRegister_BMP()                            */
+/************************************************************************/
+
+void GDALRegister_BMP()
+
+{
+    if( GDALGetDriverByName( "BMP" ) != NULL )
+      return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "BMP" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = BMPDataset::Open;
     poDriver->pfnCreate = BMPDataset::Create;
     poDriver->pfnIdentify = BMPDataset::Identify;
+    poDriver->pfnInitMetadata = BMPDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1147,6 +1147,18 @@ BSBCreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
 }
 #endif
 
+/************************************************************************/
+/*                       BSBDriverInitMetadata()                        */
+/************************************************************************/
+
+static void BSBDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Maptech BSB Nautical Charts" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#BSB" );
+}
+
 /************************************************************************/
 /*                        GDALRegister_BSB()                            */
 /************************************************************************/
@@ -1161,9 +1173,6 @@ void GDALRegister_BSB()
 
     poDriver->SetDescription( "BSB" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Maptech BSB Nautical Charts" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#BSB" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 #ifdef BSB_CREATE
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte" );
@@ -1173,6 +1182,7 @@ void GDALRegister_BSB()
 #ifdef BSB_CREATE
     poDriver->pfnCreateCopy = BSBCreateCopy;
 #endif
+    poDriver->pfnInitMetadata = BSBDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
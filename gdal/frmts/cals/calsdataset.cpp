@@ -587,6 +587,20 @@ GDALDataset *CALSDataset::CreateCopy( const char *pszFilename,
     return Open(&oOpenInfo);
 }
 
+/************************************************************************/
+/*                       CALSDriverInitMetadata()                       */
+/************************************************************************/
+
+static void CALSDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "CALS (Type 1)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_cals.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, ".cal .ct1");
+}
+
 /************************************************************************/
 /*                        GDALRegister_CALS()                           */
 /************************************************************************/
@@ -601,16 +615,11 @@ void GDALRegister_CALS()
 
     poDriver->SetDescription( "CALS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "CALS (Type 1)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_cals.html" );
-
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, ".cal .ct1");
 
     poDriver->pfnIdentify = CALSDataset::Identify;
     poDriver->pfnOpen = CALSDataset::Open;
     poDriver->pfnCreateCopy = CALSDataset::CreateCopy;
+    poDriver->pfnInitMetadata = CALSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -224,6 +224,19 @@ GDALDataset *CEOSDataset::Open( GDALOpenInfo * poOpenInfo )
 /*                          GDALRegister_GTiff()                        */
 /************************************************************************/
 
+/************************************************************************/
+/*                       CEOSDriverInitMetadata()                       */
+/************************************************************************/
+
+static void CEOSDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "CEOS Image" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#CEOS" );
+}
+
 void GDALRegister_CEOS()
 
 {
@@ -234,13 +247,10 @@ void GDALRegister_CEOS()
 
     poDriver->SetDescription( "CEOS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "CEOS Image" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#CEOS" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = CEOSDataset::Open;
+    poDriver->pfnInitMetadata = CEOSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -2201,6 +2201,19 @@ ProcessData( VSILFILE *fp, int fileid, CeosSARVolume_t *sar, int max_records,
     return CE_None;
 }
 
+/************************************************************************/
+/*                     SAR_CEOSDriverInitMetadata()                     */
+/************************************************************************/
+
+static void SAR_CEOSDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "CEOS SAR Image" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#SAR_CEOS" );
+}
+
 /************************************************************************/
 /*                       GDALRegister_SAR_CEOS()                        */
 /************************************************************************/
@@ -2215,13 +2228,10 @@ void GDALRegister_SAR_CEOS()
 
     poDriver->SetDescription( "SAR_CEOS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "CEOS SAR Image" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#SAR_CEOS" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = SAR_CEOSDataset::Open;
+    poDriver->pfnInitMetadata = SAR_CEOSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
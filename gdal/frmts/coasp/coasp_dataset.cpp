@@ -529,6 +529,19 @@ GDALDataset *COASPDataset::Open( GDALOpenInfo *poOpenInfo )
 	return poDS;
 }
 
+/************************************************************************/
+/*                      COASPDriverInitMetadata()                       */
+/************************************************************************/
+
+static void COASPDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "DRDC COASP SAR Processor Raster" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION,
+                               "hdr" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_COASP()                         */
 /************************************************************************/
@@ -542,12 +555,9 @@ void GDALRegister_COASP()
 
     poDriver->SetDescription( "COASP" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "DRDC COASP SAR Processor Raster" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION,
-                               "hdr" );
     // poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_coasp.html");
     poDriver->pfnIdentify = COASPDataset::Identify;
     poDriver->pfnOpen = COASPDataset::Open;
+    poDriver->pfnInitMetadata = COASPDriverInitMetadata;
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
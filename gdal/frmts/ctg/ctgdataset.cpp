@@ -569,6 +569,19 @@ const char* CTGDataset::GetProjectionRef()
     return pszProjection;
 }
 
+/************************************************************************/
+/*                       CTGDriverInitMetadata()                        */
+/************************************************************************/
+
+static void CTGDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "USGS LULC Composite Theme Grid" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#CTG" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_CTG()                           */
 /************************************************************************/
@@ -583,15 +596,12 @@ void GDALRegister_CTG()
 
     poDriver->SetDescription( "CTG" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "USGS LULC Composite Theme Grid" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#CTG" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = CTGDataset::Open;
     poDriver->pfnIdentify = CTGDataset::Identify;
+    poDriver->pfnInitMetadata = CTGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
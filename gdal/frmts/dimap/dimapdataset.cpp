@@ -1129,6 +1129,19 @@ const GDAL_GCP *DIMAPDataset::GetGCPs()
     return pasGCPList;
 }
 
+/************************************************************************/
+/*                      DIMAPDriverInitMetadata()                       */
+/************************************************************************/
+
+static void DIMAPDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "SPOT DIMAP" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#DIMAP" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_DIMAP()                         */
 /************************************************************************/
@@ -1143,14 +1156,11 @@ void GDALRegister_DIMAP()
 
     poDriver->SetDescription( "DIMAP" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "SPOT DIMAP" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#DIMAP" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = DIMAPDataset::Open;
     poDriver->pfnIdentify = DIMAPDataset::Identify;
+    poDriver->pfnInitMetadata = DIMAPDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
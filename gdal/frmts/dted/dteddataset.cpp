@@ -888,6 +888,22 @@ DTEDCreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
     return poDS;
 }
 
+/************************************************************************/
+/*                       DTEDDriverInitMetadata()                       */
+/************************************************************************/
+
+static void DTEDDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "DTED Elevation Raster" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "dt0 dt1 dt2" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#DTED" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 UInt16" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_DTED()                          */
 /************************************************************************/
@@ -902,19 +918,13 @@ void GDALRegister_DTED()
 
     poDriver->SetDescription( "DTED" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "DTED Elevation Raster" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "dt0 dt1 dt2" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#DTED" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 UInt16" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = DTEDDataset::Open;
     poDriver->pfnIdentify = DTEDDataset::Identify;
     poDriver->pfnCreateCopy = DTEDCreateCopy;
+    poDriver->pfnInitMetadata = DTEDDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
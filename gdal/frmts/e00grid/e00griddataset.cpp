@@ -878,6 +878,20 @@ void E00GRIDDataset::ReadMetadata()
     }
 }
 
+/************************************************************************/
+/*                     E00GRIDDriverInitMetadata()                      */
+/************************************************************************/
+
+static void E00GRIDDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Arc/Info Export E00 GRID" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#E00GRID" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "e00" );
+}
+
 /************************************************************************/
 /*                       GDALRegister_E00GRID()                         */
 /************************************************************************/
@@ -892,16 +906,12 @@ void GDALRegister_E00GRID()
 
     poDriver->SetDescription( "E00GRID" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Arc/Info Export E00 GRID" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#E00GRID" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "e00" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = E00GRIDDataset::Open;
     poDriver->pfnIdentify = E00GRIDDataset::Identify;
+    poDriver->pfnInitMetadata = E00GRIDDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -676,6 +676,19 @@ CPLErr ELASDataset::SetGeoTransform( double * padfTransform )
 }
 
 
+/************************************************************************/
+/*                       ELASDriverInitMetadata()                       */
+/************************************************************************/
+
+static void ELASDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "ELAS" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Float32 Float64" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_ELAS()                         */
 /************************************************************************/
@@ -690,16 +703,13 @@ void GDALRegister_ELAS()
 
     poDriver->SetDescription( "ELAS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "ELAS" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Float32 Float64" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ELASDataset::Open;
     poDriver->pfnIdentify = ELASDataset::Identify;
     poDriver->pfnCreate = ELASDataset::Create;
+    poDriver->pfnInitMetadata = ELASDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1141,6 +1141,19 @@ GDALDataset *EnvisatDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                     EnvisatDriverInitMetadata()                      */
+/************************************************************************/
+
+static void EnvisatDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Envisat Image Format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#Envisat" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "n1" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_Envisat()                       */
 /************************************************************************/
@@ -1155,13 +1168,10 @@ void GDALRegister_Envisat()
 
     poDriver->SetDescription( "ESAT" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Envisat Image Format" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#Envisat" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "n1" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = EnvisatDataset::Open;
+    poDriver->pfnInitMetadata = EnvisatDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1417,25 +1417,17 @@ GDALDataset *ERSDataset::Create( const char * pszFilename,
 }
 
 /************************************************************************/
-/*                         GDALRegister_ERS()                           */
+/*                       ERSDriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_ERS()
+static void ERSDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "ERS" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "ERS" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ERMapper .ers Labelled" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_ers.html" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte Int16 UInt16 Int32 UInt32 "
                                "Float32 Float64" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "   <Option name='PIXELTYPE' type='string' description='By setting this to SIGNEDBYTE, a new Byte file can be forced to be written as signed byte'/>"
@@ -1446,12 +1438,29 @@ void GDALRegister_ERS()
 "       <Value>FEET</Value>"
 "   </Option>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_ERS()                           */
+/************************************************************************/
+
+void GDALRegister_ERS()
+
+{
+    if( GDALGetDriverByName( "ERS" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "ERS" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ERSDataset::Open;
     poDriver->pfnIdentify = ERSDataset::Identify;
     poDriver->pfnCreate = ERSDataset::Create;
+    poDriver->pfnInitMetadata = ERSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
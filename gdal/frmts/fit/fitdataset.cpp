@@ -1353,6 +1353,18 @@ static GDALDataset *FITCreateCopy(const char * pszFilename,
 //     return( CE_None );
 // }
 
+/************************************************************************/
+/*                       FITDriverInitMetadata()                        */
+/************************************************************************/
+
+static void FITDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "FIT Image" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_FIT()                          */
 /************************************************************************/
@@ -1367,9 +1379,6 @@ void GDALRegister_FIT()
 
     poDriver->SetDescription( "FIT" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "FIT Image" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = FITDataset::Open;
@@ -1379,6 +1388,7 @@ void GDALRegister_FIT()
                                "Byte UInt16 Int16 UInt32 Int32 "
                                "Float32 Float64" );
 #endif // FIT_WRITE
+    poDriver->pfnInitMetadata = FITDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -915,6 +915,18 @@ static void GDALDeregister_GRIB(GDALDriver* )
     }
 }
 
+/************************************************************************/
+/*                       GRIBDriverInitMetadata()                       */
+/************************************************************************/
+
+static void GRIBDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GRIdded Binary (.grb)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_grib.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grb" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_GRIB()                          */
 /************************************************************************/
@@ -929,14 +941,12 @@ void GDALRegister_GRIB()
 
     poDriver->SetDescription( "GRIB" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GRIdded Binary (.grb)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_grib.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grb" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = GRIBDataset::Open;
     poDriver->pfnIdentify = GRIBDataset::Identify;
     poDriver->pfnUnloadDriver = GDALDeregister_GRIB;
+    poDriver->pfnInitMetadata = GRIBDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1337,6 +1337,21 @@ GDALDataset *GS7BGDataset::CreateCopy( const char *pszFilename,
     return poDS;
 }
 
+/************************************************************************/
+/*                      GS7BGDriverInitMetadata()                       */
+/************************************************************************/
+
+static void GS7BGDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Golden Software 7 Binary Grid (.grd)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#GS7BG" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grd" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 UInt16 Float32 Float64" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_GS7BG()                        */
 /************************************************************************/
@@ -1350,18 +1365,13 @@ void GDALRegister_GS7BG()
 
     poDriver->SetDescription( "GS7BG" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Golden Software 7 Binary Grid (.grd)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#GS7BG" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grd" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 UInt16 Float32 Float64" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnIdentify = GS7BGDataset::Identify;
     poDriver->pfnOpen = GS7BGDataset::Open;
     poDriver->pfnCreate = GS7BGDataset::Create;
     poDriver->pfnCreateCopy = GS7BGDataset::CreateCopy;
+    poDriver->pfnInitMetadata = GS7BGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
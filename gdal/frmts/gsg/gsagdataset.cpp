@@ -1728,6 +1728,22 @@ GDALDataset *GSAGDataset::CreateCopy( const char *pszFilename,
     return poDS;
 }
 
+/************************************************************************/
+/*                       GSAGDriverInitMetadata()                       */
+/************************************************************************/
+
+static void GSAGDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Golden Software ASCII Grid (.grd)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#GSAG" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grd" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 UInt16 Int32 UInt32 "
+                               "Float32 Float64" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_GSAG()                         */
 /************************************************************************/
@@ -1742,18 +1758,12 @@ void GDALRegister_GSAG()
 
     poDriver->SetDescription( "GSAG" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Golden Software ASCII Grid (.grd)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#GSAG" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grd" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 UInt16 Int32 UInt32 "
-                               "Float32 Float64" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnIdentify = GSAGDataset::Identify;
     poDriver->pfnOpen = GSAGDataset::Open;
     poDriver->pfnCreateCopy = GSAGDataset::CreateCopy;
+    poDriver->pfnInitMetadata = GSAGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1132,6 +1132,21 @@ GDALDataset *GSBGDataset::CreateCopy( const char *pszFilename,
     return poDS;
 }
 
+/************************************************************************/
+/*                       GSBGDriverInitMetadata()                       */
+/************************************************************************/
+
+static void GSBGDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Golden Software Binary Grid (.grd)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#GSBG" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grd" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 UInt16 Float32" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_GSBG()                         */
 /************************************************************************/
@@ -1146,18 +1161,13 @@ void GDALRegister_GSBG()
 
     poDriver->SetDescription( "GSBG" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Golden Software Binary Grid (.grd)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#GSBG" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grd" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 UInt16 Float32" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnIdentify = GSBGDataset::Identify;
     poDriver->pfnOpen = GSBGDataset::Open;
     poDriver->pfnCreate = GSBGDataset::Create;
     poDriver->pfnCreateCopy = GSBGDataset::CreateCopy;
+    poDriver->pfnInitMetadata = GSBGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -38,6 +38,7 @@
 
 #include "cpl_port.h"  // Must be first.
 
+#include <algorithm>
 #include <set>
 
 #include "cpl_csv.h"
@@ -76,6 +77,27 @@ static int bGlobalStripIntegerOverflow = FALSE;
 #endif
 static bool bGlobalInExternalOvr = false;
 
+/* Size of the "GDAL_STRUCTURAL_METADATA_SIZE=XXXXXX bytes\n" line that */
+/* starts the ghost area of files written with CLOUD_OPTIMIZED=YES */
+#define GHOST_AREA_FIRST_LINE_SIZE      43
+
+/************************************************************************/
+/*                         GTiffGetHeaderSize()                         */
+/************************************************************************/
+
+/* Returns the size of the TIFF header, 8 bytes or 16 bytes for BigTIFF, */
+/* or 0 if it cannot be read */
+static toff_t GTiffGetHeaderSize( TIFF* hTIFF )
+{
+    thandle_t th = TIFFClientdata( hTIFF );
+    GByte abyHeader[4];
+    if( TIFFGetSeekProc( hTIFF )( th, 0, SEEK_SET ) != 0 ||
+        TIFFGetReadProc( hTIFF )( th, abyHeader, 4 ) != 4 )
+        return 0;
+    /* The version is 43 for BigTIFF, in either byte order */
+    return (abyHeader[2] == 43 || abyHeader[3] == 43) ? 16 : 8;
+}
+
 typedef enum
 {
     GTIFFTAGTYPE_STRING,
@@ -122,6 +144,46 @@ static bool IsPowerOfTwo(unsigned int i)
     return nBitSet == 1;
 }
 
+/************************************************************************/
+/*                        GTiffGetStrileOffset()                        */
+/*                                                                      */
+/*      Return the offset of a strip or tile. With the internal         */
+/*      libtiff, this only loads the part of the offsets array that     */
+/*      contains it when the file is opened in lazy loading mode.       */
+/************************************************************************/
+
+static vsi_l_offset GTiffGetStrileOffset( TIFF* hTIFF, int nBlockId )
+{
+#ifdef INTERNAL_LIBTIFF
+    return TIFFGetStrileOffset( hTIFF, nBlockId );
+#else
+    toff_t *panOffsets = NULL;
+    if( !TIFFGetField( hTIFF, TIFFIsTiled( hTIFF ) ? TIFFTAG_TILEOFFSETS :
+                       TIFFTAG_STRIPOFFSETS, &panOffsets ) ||
+        panOffsets == NULL )
+        return 0;
+    return panOffsets[nBlockId];
+#endif
+}
+
+/************************************************************************/
+/*                       GTiffGetStrileByteCount()                      */
+/************************************************************************/
+
+static vsi_l_offset GTiffGetStrileByteCount( TIFF* hTIFF, int nBlockId )
+{
+#ifdef INTERNAL_LIBTIFF
+    return TIFFGetStrileByteCount( hTIFF, nBlockId );
+#else
+    toff_t *panByteCounts = NULL;
+    if( !TIFFGetField( hTIFF, TIFFIsTiled( hTIFF ) ? TIFFTAG_TILEBYTECOUNTS :
+                       TIFFTAG_STRIPBYTECOUNTS, &panByteCounts ) ||
+        panByteCounts == NULL )
+        return 0;
+    return panByteCounts[nBlockId];
+#endif
+}
+
 /************************************************************************/
 /*                          GTIFFSetInExternalOvr()                     */
 /************************************************************************/
@@ -201,6 +263,23 @@ typedef struct
     int           bReady;
 } GTiffCompressionJob;
 
+typedef struct
+{
+    GTiffDataset *poDS;
+    int           bTIFFIsBigEndian;
+    uint16        nPredictor;
+    int           nBlockId;
+    int           nXBlockOff;
+    int           nYBlockOff;
+    int           nBand; /* 0 for a pixel interleaved block of all bands */
+
+    GByte        *pabyCompressedBuffer;
+    int           nCompressedBufferSize;
+    GByte        *pabyBuffer;
+    int           nReqSize;
+    int           bOK;
+} GTiffDecompressionJob;
+
 class GTiffDataset CPL_FINAL : public GDALPamDataset
 {
     friend class GTiffRasterBand;
@@ -353,8 +432,17 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
 
     int           bDontReloadFirstBlock; /* Hack for libtiff 3.X and #3633 */
 
+    /* Cloud optimized layout advertised in the ghost area after the header */
+    int           bLayoutIFDSBeforeData;
+    vsi_l_offset  nKnownIncompatibleEditionOffset;
+    void          ReadGhostArea();
+    void          InvalidateCloudOptimizedLayout();
+
     int           nZLevel;
     int           nLZMAPreset;
+    int           nZSTDLevel;
+    double        dfMaxZError;
+    int           nLercAddCompression;
     int           nJpegQuality;
     int           nJpegTablesMode;
 
@@ -363,7 +451,10 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
     int           bDebugDontWriteBlocks;
 
     CPLErr        RegisterNewOverviewDataset(toff_t nOverviewOffset);
-    CPLErr        CreateOverviewsFromSrcOverviews(GDALDataset* poSrcDS);
+    CPLErr        CreateOverviewsFromSrcOverviews(GDALDataset* poSrcDS,
+                                                  GDALDataset* poOvrDS,
+                                                  int nOvrBlockXSize,
+                                                  int nOvrBlockYSize);
     CPLErr        CreateInternalMaskOverviews(int nOvrBlockXSize,
                                               int nOvrBlockYSize);
 
@@ -394,6 +485,7 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
     CPLMutex      *hCompressThreadPoolMutex;
     void           InitCompressionThreads(char** papszOptions);
     void           InitCreationOrOpenOptions(char** papszOptions);
+    void           SetZSTDAndLercFields(TIFF* hTIFFIn);
     static void    ThreadCompressionFunc(void* pData);
     void           WaitCompletionForBlock(int nBlockId);
     void           WriteRawStripOrTile(int nStripOrTile,
@@ -402,6 +494,19 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
     int            SubmitCompressionJob(int nStripOrTile, GByte* pabyData,
                                         int cc, int nHeight);
 
+    int            nDecompressThreads;
+    CPLWorkerThreadPool *poDecompressThreadPool;
+    void           InitDecompressionThreads(char** papszOptions);
+    static void    ThreadDecompressionFunc(void* pData);
+    void           DecompressBlocksInParallel(int nXOff, int nYOff,
+                                              int nXSize, int nYSize,
+                                              int nBandCount, int *panBandMap);
+
+    void*          CacheMultiRange(int nXOff, int nYOff,
+                                   int nXSize, int nYSize,
+                                   int nBandCount, int *panBandMap);
+    void           ResetMultiRange(void* pBufferedData);
+
     int            GuessJPEGQuality(int& bOutHasQuantizationTable,
                                     int& bOutHasHuffmanTable);
 
@@ -713,30 +818,16 @@ CPLErr GTiffJPEGOverviewBand::IReadBlock( int nBlockXOff, int nBlockYOff, void *
     int nScaleFactor = 1 << poGDS->nOverviewLevel;
     if( poGDS->poJPEGDS == NULL || nBlockId != poGDS->nBlockId )
     {
-        toff_t *panByteCounts = NULL;
-        toff_t *panOffsets = NULL;
         vsi_l_offset nOffset = 0;
         vsi_l_offset nByteCount = 0;
 
         /* Find offset and size of the JPEG tile/strip */
         TIFF* hTIFF = poGDS->poParentDS->hTIFF;
-        if( (( TIFFIsTiled( hTIFF )
-            && TIFFGetField( hTIFF, TIFFTAG_TILEBYTECOUNTS, &panByteCounts )
-            && TIFFGetField( hTIFF, TIFFTAG_TILEOFFSETS, &panOffsets ) )
-            || ( !TIFFIsTiled( hTIFF )
-            && TIFFGetField( hTIFF, TIFFTAG_STRIPBYTECOUNTS, &panByteCounts )
-            && TIFFGetField( hTIFF, TIFFTAG_STRIPOFFSETS, &panOffsets ) )) &&
-            panByteCounts != NULL && panOffsets != NULL )
-        {
-            if( panByteCounts[nBlockId] < 2 )
-                return CE_Failure;
-            nOffset = panOffsets[nBlockId] + 2; /* skip leading 0xFF 0xF8 */
-            nByteCount = panByteCounts[nBlockId] - 2;
-        }
-        else
-        {
+        nByteCount = GTiffGetStrileByteCount( hTIFF, nBlockId );
+        if( nByteCount < 2 )
             return CE_Failure;
-        }
+        nOffset = GTiffGetStrileOffset( hTIFF, nBlockId ) + 2; /* skip leading 0xFF 0xF8 */
+        nByteCount -= 2;
 
         /* Special case for last strip that might be smaller than other strips */
         /* In which case we must invalidate the dataset */
@@ -961,6 +1052,7 @@ protected:
 
     void NullBlock( void *pData );
     CPLErr FillCacheForOtherBands( int nBlockXOff, int nBlockYOff );
+    int    IsBlockInCache( int nBlockXOff, int nBlockYOff );
 
 public:
                    GTiffRasterBand( GTiffDataset *, int );
@@ -1874,12 +1966,24 @@ CPLErr GTiffDataset::IRasterIO( GDALRWFlag eRWFlag,
             return (CPLErr)nErr;
     }
 
+    void* pBufferedData = NULL;
+    if( eRWFlag == GF_Read )
+    {
+        pBufferedData = CacheMultiRange(nXOff, nYOff, nXSize, nYSize,
+                                        nBandCount, panBandMap);
+        DecompressBlocksInParallel(nXOff, nYOff, nXSize, nYSize,
+                                   nBandCount, panBandMap);
+    }
+
     nJPEGOverviewVisibilityFlag ++;
     eErr =  GDALPamDataset::IRasterIO(
                 eRWFlag, nXOff, nYOff, nXSize, nYSize,
                 pData, nBufXSize, nBufYSize, eBufType,
                 nBandCount, panBandMap, nPixelSpace, nLineSpace, nBandSpace, psExtraArg);
     nJPEGOverviewVisibilityFlag --;
+
+    ResetMultiRange(pBufferedData);
+
     return eErr;
 }
 
@@ -3566,12 +3670,23 @@ CPLErr GTiffRasterBand::IRasterIO( GDALRWFlag eRWFlag,
         }
     }
 
+    void* pBufferedData = NULL;
+    if( eRWFlag == GF_Read )
+    {
+        pBufferedData = poGDS->CacheMultiRange(nXOff, nYOff, nXSize, nYSize,
+                                               1, &nBand);
+        poGDS->DecompressBlocksInParallel(nXOff, nYOff, nXSize, nYSize,
+                                          1, &nBand);
+    }
+
     poGDS->nJPEGOverviewVisibilityFlag ++;
     eErr = GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
                                         pData, nBufXSize, nBufYSize, eBufType,
                                         nPixelSpace, nLineSpace, psExtraArg);
     poGDS->nJPEGOverviewVisibilityFlag --;
 
+    poGDS->ResetMultiRange(pBufferedData);
+
     poGDS->bLoadingOtherBands = FALSE;
 
     return eErr;
@@ -3753,6 +3868,19 @@ CPLErr GTiffRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
 }
 
 
+/************************************************************************/
+/*                           IsBlockInCache()                           */
+/************************************************************************/
+
+int GTiffRasterBand::IsBlockInCache( int nBlockXOff, int nBlockYOff )
+{
+    GDALRasterBlock* poBlock = TryGetLockedBlockRef(nBlockXOff, nBlockYOff);
+    if( poBlock == NULL )
+        return FALSE;
+    poBlock->DropLock();
+    return TRUE;
+}
+
 /************************************************************************/
 /*                       FillCacheForOtherBands()                       */
 /************************************************************************/
@@ -4142,20 +4270,8 @@ const char *GTiffRasterBand::GetMetadataItem( const char * pszName,
                 return NULL;
             }
 
-            toff_t *panOffsets = NULL;
-            TIFF* hTIFF = poGDS->hTIFF;
-            if( (( TIFFIsTiled( hTIFF )
-                && TIFFGetField( hTIFF, TIFFTAG_TILEOFFSETS, &panOffsets ) )
-                || ( !TIFFIsTiled( hTIFF )
-                && TIFFGetField( hTIFF, TIFFTAG_STRIPOFFSETS, &panOffsets ) )) &&
-                panOffsets != NULL )
-            {
-                return CPLSPrintf(CPL_FRMT_GUIB, (GUIntBig)panOffsets[nBlockId]);
-            }
-            else
-            {
-                return NULL;
-            }
+            return CPLSPrintf(CPL_FRMT_GUIB,
+                (GUIntBig)GTiffGetStrileOffset(poGDS->hTIFF, nBlockId));
         }
         else if( sscanf(pszName, "BLOCK_SIZE_%d_%d", &nBlockXOff, &nBlockYOff) == 2 )
         {
@@ -4179,20 +4295,8 @@ const char *GTiffRasterBand::GetMetadataItem( const char * pszName,
                 return NULL;
             }
 
-            toff_t *panByteCounts = NULL;
-            TIFF* hTIFF = poGDS->hTIFF;
-            if( (( TIFFIsTiled( hTIFF )
-                && TIFFGetField( hTIFF, TIFFTAG_TILEBYTECOUNTS, &panByteCounts ) )
-                || ( !TIFFIsTiled( hTIFF )
-                && TIFFGetField( hTIFF, TIFFTAG_STRIPBYTECOUNTS, &panByteCounts ) )) &&
-                panByteCounts != NULL )
-            {
-                return CPLSPrintf(CPL_FRMT_GUIB, (GUIntBig)panByteCounts[nBlockId]);
-            }
-            else
-            {
-                return NULL;
-            }
+            return CPLSPrintf(CPL_FRMT_GUIB,
+                (GUIntBig)GTiffGetStrileByteCount(poGDS->hTIFF, nBlockId));
         }
     }
     return oGTiffMDMD.GetMetadataItem( pszName, pszDomain );
@@ -6021,6 +6125,8 @@ GTiffDataset::GTiffDataset() :
     fpL = NULL;
     bStreamingIn = FALSE;
     bStreamingOut = FALSE;
+    bLayoutIFDSBeforeData = FALSE;
+    nKnownIncompatibleEditionOffset = 0;
     fpToWrite = NULL;
     nLastWrittenBlockId = -1;
     bNeedsRewrite = FALSE;
@@ -6086,6 +6192,9 @@ GTiffDataset::GTiffDataset() :
 
     nZLevel = -1;
     nLZMAPreset = -1;
+    nZSTDLevel = -1;
+    dfMaxZError = 0.0;
+    nLercAddCompression = LERC_ADD_COMPRESSION_NONE;
     nJpegQuality = -1;
     nJpegTablesMode = -1;
 
@@ -6122,6 +6231,8 @@ GTiffDataset::GTiffDataset() :
     papszMetadataFiles = NULL;
     poCompressThreadPool = NULL;
     hCompressThreadPoolMutex = NULL;
+    nDecompressThreads = 0;
+    poDecompressThreadPool = NULL;
 
     m_pTempBufferForCommonDirectIO = NULL;
     m_nTempBufferForCommonDirectIOSize = 0;
@@ -6224,6 +6335,9 @@ int GTiffDataset::Finalize()
         CPLDestroyMutex(hCompressThreadPoolMutex);
     }
 
+    delete poDecompressThreadPool;
+    poDecompressThreadPool = NULL;
+
 /* -------------------------------------------------------------------- */
 /*      If there is still changed metadata, then presumably we want     */
 /*      to push it into PAM.                                            */
@@ -6289,6 +6403,10 @@ int GTiffDataset::Finalize()
             }
             fpL = NULL;
         }
+
+        /* The modification time may not have changed */
+        if( eAccess == GA_Update )
+            GDALInvalidateMetadataSnapshots( osFilename );
     }
 
     if( fpToWrite != NULL )
@@ -6425,6 +6543,11 @@ void GTiffDataset::FillEmptyTiles()
     if (!SetDirectory())
         return;
 
+    // The block of the pixel-interleaved buffer is not empty, even if
+    // not written yet
+    if( bLoadedBlockDirty && nLoadedBlock != -1 )
+        FlushBlockBuf();
+
 /* -------------------------------------------------------------------- */
 /*      How many blocks are there in this file?                         */
 /* -------------------------------------------------------------------- */
@@ -6475,6 +6598,10 @@ void GTiffDataset::FillEmptyTiles()
     {
         if( panByteCounts[iBlock] == 0 )
         {
+            // Nor is a block still being compressed by a worker thread
+            WaitCompletionForBlock( iBlock );
+            if( panByteCounts[iBlock] != 0 )
+                continue;
             if( WriteEncodedTileOrStrip( iBlock, pabyData, FALSE ) != CE_None )
                 break;
         }
@@ -6483,6 +6610,81 @@ void GTiffDataset::FillEmptyTiles()
     CPLFree( pabyData );
 }
 
+/************************************************************************/
+/*                           ReadGhostArea()                            */
+/*                                                                      */
+/*      Parse the structural metadata that CreateCopy() writes just     */
+/*      after the TIFF header when CLOUD_OPTIMIZED=YES is used.         */
+/************************************************************************/
+
+void GTiffDataset::ReadGhostArea()
+{
+    const toff_t nHeaderSize = GTiffGetHeaderSize( hTIFF );
+    thandle_t th = TIFFClientdata( hTIFF );
+    char szLine[GHOST_AREA_FIRST_LINE_SIZE + 1];
+    if( nHeaderSize == 0 ||
+        TIFFGetSeekProc( hTIFF )( th, nHeaderSize, SEEK_SET ) != nHeaderSize ||
+        TIFFGetReadProc( hTIFF )( th, szLine, GHOST_AREA_FIRST_LINE_SIZE )
+                                        != GHOST_AREA_FIRST_LINE_SIZE )
+        return;
+    szLine[GHOST_AREA_FIRST_LINE_SIZE] = '\0';
+    if( !STARTS_WITH(szLine, "GDAL_STRUCTURAL_METADATA_SIZE=") )
+        return;
+
+    const int nSize = atoi( szLine + strlen("GDAL_STRUCTURAL_METADATA_SIZE=") );
+    if( nSize <= 0 || nSize > 65535 )
+        return;
+    CPLString osGhost;
+    osGhost.resize( nSize );
+    if( TIFFGetReadProc( hTIFF )( th, &osGhost[0], nSize ) != nSize )
+        return;
+
+    const char* pszKIE = strstr( osGhost, "KNOWN_INCOMPATIBLE_EDITION=" );
+    if( strstr( osGhost, "LAYOUT=IFDS_BEFORE_DATA\n" ) == NULL ||
+        pszKIE == NULL )
+        return;
+    pszKIE += strlen("KNOWN_INCOMPATIBLE_EDITION=");
+    if( !STARTS_WITH(pszKIE, "NO\n") )
+        return;
+
+    bLayoutIFDSBeforeData = TRUE;
+    nKnownIncompatibleEditionOffset = nHeaderSize + GHOST_AREA_FIRST_LINE_SIZE +
+                                      (pszKIE - osGhost.c_str());
+    oGTiffMDMD.SetMetadataItem( "LAYOUT", "COG", "IMAGE_STRUCTURE" );
+}
+
+/************************************************************************/
+/*                   InvalidateCloudOptimizedLayout()                   */
+/*                                                                      */
+/*      Rewritten blocks are appended at the end of the file, so once   */
+/*      a file with a cloud optimized layout is modified, the ghost     */
+/*      area must no longer pretend that the layout holds.              */
+/************************************************************************/
+
+void GTiffDataset::InvalidateCloudOptimizedLayout()
+{
+    GTiffDataset* poMainDS = (poBaseDS != NULL) ? poBaseDS : this;
+    if( !poMainDS->bLayoutIFDSBeforeData )
+        return;
+    poMainDS->bLayoutIFDSBeforeData = FALSE;
+    poMainDS->oGTiffMDMD.SetMetadataItem( "LAYOUT", NULL, "IMAGE_STRUCTURE" );
+
+    CPLDebug( "GTiff", "Modifying a file with a cloud optimized layout: "
+              "setting KNOWN_INCOMPATIBLE_EDITION=YES" );
+
+    thandle_t th = TIFFClientdata( hTIFF );
+    const toff_t nOffset =
+        static_cast<toff_t>(poMainDS->nKnownIncompatibleEditionOffset);
+    char szYes[] = "YES\n";
+    if( TIFFGetSeekProc( hTIFF )( th, nOffset, SEEK_SET ) != nOffset ||
+        TIFFGetWriteProc( hTIFF )( th, szYes, 4 ) != 4 )
+    {
+        CPLError( CE_Warning, CPLE_FileIO,
+                  "Cannot update KNOWN_INCOMPATIBLE_EDITION in %s",
+                  poMainDS->osFilename.c_str() );
+    }
+}
+
 /************************************************************************/
 /*                        WriteEncodedTile()                            */
 /************************************************************************/
@@ -6490,6 +6692,8 @@ void GTiffDataset::FillEmptyTiles()
 bool GTiffDataset::WriteEncodedTile(uint32 tile, GByte *pabyData,
                                     int bPreserveDataBuffer)
 {
+    InvalidateCloudOptimizedLayout();
+
     int cc = static_cast<int>(TIFFTileSize( hTIFF ));
     bool bNeedTileFill = false;
     int iRow=0, iColumn=0;
@@ -6631,6 +6835,8 @@ bool GTiffDataset::WriteEncodedTile(uint32 tile, GByte *pabyData,
 bool GTiffDataset::WriteEncodedStrip(uint32 strip, GByte* pabyData,
                                      int bPreserveDataBuffer)
 {
+    InvalidateCloudOptimizedLayout();
+
     int cc = static_cast<int>(TIFFStripSize( hTIFF ));
 
 /* -------------------------------------------------------------------- */
@@ -6802,6 +7008,37 @@ void GTiffDataset::InitCreationOrOpenOptions(char** papszOptions)
     eGeoTIFFKeysFlavor = GetGTIFFKeysFlavor(papszOptions);
 }
 
+/************************************************************************/
+/*                       SetZSTDAndLercFields()                         */
+/*                                                                      */
+/*      Set the codec specific pseudo-tags of the ZSTD and LERC         */
+/*      codecs, which are not stored in the file.                       */
+/************************************************************************/
+
+void GTiffDataset::SetZSTDAndLercFields(TIFF* hTIFFIn)
+{
+    if( nCompression == COMPRESSION_ZSTD && nZSTDLevel > 0 )
+        TIFFSetField(hTIFFIn, TIFFTAG_ZSTD_LEVEL, nZSTDLevel);
+    else if( nCompression == COMPRESSION_LERC )
+    {
+        TIFFSetField(hTIFFIn, TIFFTAG_LERC_MAXZERROR, dfMaxZError);
+        // Changing the additional compression rewrites the LercParameters
+        // tag, so avoid dirtying the directory when it is already right.
+        int nCurAddCompression = LERC_ADD_COMPRESSION_NONE;
+        TIFFGetField(hTIFFIn, TIFFTAG_LERC_ADD_COMPRESSION,
+                     &nCurAddCompression);
+        if( nCurAddCompression != nLercAddCompression )
+            TIFFSetField(hTIFFIn, TIFFTAG_LERC_ADD_COMPRESSION,
+                         nLercAddCompression);
+        if( nLercAddCompression == LERC_ADD_COMPRESSION_DEFLATE &&
+            nZLevel > 0 )
+            TIFFSetField(hTIFFIn, TIFFTAG_ZIPQUALITY, nZLevel);
+        else if( nLercAddCompression == LERC_ADD_COMPRESSION_ZSTD &&
+                 nZSTDLevel > 0 )
+            TIFFSetField(hTIFFIn, TIFFTAG_ZSTD_LEVEL, nZSTDLevel);
+    }
+}
+
 /************************************************************************/
 /*                      ThreadCompressionFunc()                         */
 /************************************************************************/
@@ -6827,6 +7064,7 @@ void GTiffDataset::ThreadCompressionFunc(void* pData)
         TIFFSetField(hTIFFTmp, TIFFTAG_ZIPQUALITY, poDS->nZLevel);
     if( poDS->nLZMAPreset > 0 && poDS->nCompression == COMPRESSION_LZMA)
         TIFFSetField(hTIFFTmp, TIFFTAG_LZMAPRESET, poDS->nLZMAPreset);
+    poDS->SetZSTDAndLercFields(hTIFFTmp);
     TIFFSetField(hTIFFTmp, TIFFTAG_PHOTOMETRIC, poDS->nPhotometric);
     TIFFSetField(hTIFFTmp, TIFFTAG_SAMPLEFORMAT, poDS->nSampleFormat);
     TIFFSetField(hTIFFTmp, TIFFTAG_SAMPLESPERPIXEL, poDS->nSamplesPerPixel);
@@ -6964,7 +7202,9 @@ int GTiffDataset::SubmitCompressionJob(int nStripOrTile, GByte* pabyData,
            (nCompression == COMPRESSION_ADOBE_DEFLATE ||
             nCompression == COMPRESSION_LZW ||
             nCompression == COMPRESSION_PACKBITS ||
-            nCompression == COMPRESSION_LZMA) ) )
+            nCompression == COMPRESSION_LZMA ||
+            nCompression == COMPRESSION_ZSTD ||
+            nCompression == COMPRESSION_LERC) ) )
         return FALSE;
 
     int nNextCompressionJobAvail = -1;
@@ -7006,7 +7246,8 @@ int GTiffDataset::SubmitCompressionJob(int nStripOrTile, GByte* pabyData,
     psJob->nStripOrTile = nStripOrTile;
     psJob->nPredictor = PREDICTOR_NONE;
     if ( nCompression == COMPRESSION_LZW ||
-         nCompression == COMPRESSION_ADOBE_DEFLATE )
+         nCompression == COMPRESSION_ADOBE_DEFLATE ||
+         nCompression == COMPRESSION_ZSTD )
     {
         TIFFGetField( hTIFF, TIFFTAG_PREDICTOR, &psJob->nPredictor );
     }
@@ -7015,6 +7256,508 @@ int GTiffDataset::SubmitCompressionJob(int nStripOrTile, GByte* pabyData,
     return TRUE;
 }
 
+/************************************************************************/
+/*                       InitDecompressionThreads()                     */
+/************************************************************************/
+
+void GTiffDataset::InitDecompressionThreads(char** papszOptions)
+{
+    const char* pszValue = CSLFetchNameValue( papszOptions, "NUM_THREADS" );
+    if (pszValue == NULL)
+        pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", NULL);
+    if( pszValue == NULL )
+        return;
+
+    int nThreads;
+    if (EQUAL(pszValue, "ALL_CPUS"))
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszValue);
+    if( nThreads > 1 )
+    {
+        if( nCompression == COMPRESSION_ADOBE_DEFLATE ||
+            nCompression == COMPRESSION_DEFLATE ||
+            nCompression == COMPRESSION_LZW ||
+            nCompression == COMPRESSION_PACKBITS ||
+            nCompression == COMPRESSION_LZMA ||
+            nCompression == COMPRESSION_ZSTD ||
+            nCompression == COMPRESSION_LERC )
+        {
+            // The worker threads are only started by the first read
+            // spanning several blocks.
+            nDecompressThreads = nThreads;
+        }
+        else
+        {
+            CPLDebug("GTiff", "NUM_THREADS ignored with this compression");
+        }
+    }
+    else if (nThreads < 0 || (!EQUAL(pszValue, "0") && !EQUAL(pszValue, "1")) )
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "Invalid value for NUM_THREADS: %s", pszValue);
+    }
+}
+
+/************************************************************************/
+/*                      ThreadDecompressionFunc()                       */
+/*                                                                      */
+/*      Decode a strip or tile whose compressed bytes have already been */
+/*      read, by writing them as the single strip of a temporary TIFF   */
+/*      file with the same layout, and reading it back.                 */
+/************************************************************************/
+
+void GTiffDataset::ThreadDecompressionFunc(void* pData)
+{
+    GTiffDecompressionJob* psJob = (GTiffDecompressionJob*)pData;
+    GTiffDataset* poDS = psJob->poDS;
+
+    // Errors are reported when the block is read again by IReadBlock()
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+
+    CPLString osTmpFilename;
+    osTmpFilename.Printf("/vsimem/gtiff/thread/decompression/job/%p", psJob);
+
+    VSILFILE* fpTmp = VSIFOpenL(osTmpFilename, "wb+");
+    TIFF* hTIFFTmp = VSI_TIFFOpen(osTmpFilename,
+        (psJob->bTIFFIsBigEndian) ? "wb+" : "wl+", fpTmp);
+    CPLAssert( hTIFFTmp != NULL );
+    const int nSamples = (psJob->nBand == 0) ? poDS->nSamplesPerPixel : 1;
+    TIFFSetField(hTIFFTmp, TIFFTAG_IMAGEWIDTH, poDS->nBlockXSize);
+    TIFFSetField(hTIFFTmp, TIFFTAG_IMAGELENGTH, poDS->nBlockYSize);
+    TIFFSetField(hTIFFTmp, TIFFTAG_BITSPERSAMPLE, poDS->nBitsPerSample);
+    TIFFSetField(hTIFFTmp, TIFFTAG_COMPRESSION, poDS->nCompression);
+    if( psJob->nPredictor != PREDICTOR_NONE )
+        TIFFSetField(hTIFFTmp, TIFFTAG_PREDICTOR, psJob->nPredictor);
+    poDS->SetZSTDAndLercFields(hTIFFTmp);
+    TIFFSetField(hTIFFTmp, TIFFTAG_PHOTOMETRIC,
+                 (nSamples >= 3) ? poDS->nPhotometric : PHOTOMETRIC_MINISBLACK);
+    TIFFSetField(hTIFFTmp, TIFFTAG_SAMPLEFORMAT, poDS->nSampleFormat);
+    TIFFSetField(hTIFFTmp, TIFFTAG_SAMPLESPERPIXEL, nSamples);
+    TIFFSetField(hTIFFTmp, TIFFTAG_ROWSPERSTRIP, poDS->nBlockYSize);
+    TIFFSetField(hTIFFTmp, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+
+    bool bOK = TIFFWriteRawStrip(hTIFFTmp, 0, psJob->pabyCompressedBuffer,
+                                 psJob->nCompressedBufferSize) ==
+                                        psJob->nCompressedBufferSize;
+    XTIFFClose(hTIFFTmp);
+    if( VSIFCloseL(fpTmp) != 0 )
+        bOK = false;
+
+    if( bOK )
+    {
+        fpTmp = VSIFOpenL(osTmpFilename, "rb");
+        hTIFFTmp = (fpTmp != NULL) ?
+                        VSI_TIFFOpen(osTmpFilename, "r", fpTmp) : NULL;
+        bOK = hTIFFTmp != NULL &&
+              TIFFReadEncodedStrip(hTIFFTmp, 0, psJob->pabyBuffer,
+                                   psJob->nReqSize) != -1;
+        if( hTIFFTmp != NULL )
+            XTIFFClose(hTIFFTmp);
+        if( fpTmp != NULL )
+            VSIFCloseL(fpTmp);
+    }
+    VSIUnlink(osTmpFilename);
+
+    CPLPopErrorHandler();
+
+    psJob->bOK = bOK;
+}
+
+/************************************************************************/
+/*                     DecompressBlocksInParallel()                     */
+/*                                                                      */
+/*      Load into the block cache the blocks intersecting a window to   */
+/*      be read, by reading their compressed bytes in the calling       */
+/*      thread and decoding them in worker threads. Blocks that cannot  */
+/*      be handled here are left to IReadBlock().                       */
+/************************************************************************/
+
+void GTiffDataset::DecompressBlocksInParallel( int nXOff, int nYOff,
+                                               int nXSize, int nYSize,
+                                               int nBandCount,
+                                               int *panBandMap )
+{
+    // Overviews and masks use the threads of their main dataset
+    GTiffDataset* poMainDS = this;
+    while( poMainDS->poBaseDS != NULL )
+        poMainDS = poMainDS->poBaseDS;
+    if( poMainDS->nDecompressThreads <= 1 )
+        return;
+
+    if( eAccess != GA_ReadOnly || bStreamingIn ||
+        bTreatAsRGBA || bTreatAsSplit || bTreatAsSplitBitmap ||
+        nPhotometric == PHOTOMETRIC_YCBCR || nBands == 0 )
+        return;
+    if( !(nCompression == COMPRESSION_ADOBE_DEFLATE ||
+          nCompression == COMPRESSION_DEFLATE ||
+          nCompression == COMPRESSION_LZW ||
+          nCompression == COMPRESSION_PACKBITS ||
+          nCompression == COMPRESSION_LZMA ||
+          nCompression == COMPRESSION_ZSTD ||
+          nCompression == COMPRESSION_LERC) )
+        return;
+    const GDALDataType eDataType = GetRasterBand(1)->GetRasterDataType();
+    if( GDALGetDataTypeSize(eDataType) != nBitsPerSample ||
+        (nBitsPerSample % 8) != 0 )
+        return;
+
+    const int nBlockX1 = nXOff / nBlockXSize;
+    const int nBlockY1 = nYOff / nBlockYSize;
+    const int nBlockX2 = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nBlockY2 = (nYOff + nYSize - 1) / nBlockYSize;
+    if( nBlockX1 == nBlockX2 && nBlockY1 == nBlockY2 )
+        return;
+
+    if( !SetDirectory() )
+        return;
+
+    const bool bSeparate = (nPlanarConfig == PLANARCONFIG_SEPARATE);
+    const int nWordBytes = nBitsPerSample / 8;
+    const int nBlockBufSize = TIFFIsTiled(hTIFF) ?
+                                    static_cast<int>(TIFFTileSize(hTIFF)) :
+                                    static_cast<int>(TIFFStripSize(hTIFF));
+    if( static_cast<GIntBig>(nBlockBufSize) !=
+            static_cast<GIntBig>(nBlockXSize) * nBlockYSize * nWordBytes *
+                (bSeparate ? 1 : nBands) )
+        return;
+
+    // Do not decode more than the block cache can keep until the blocks
+    // are used by the caller
+    const int nXBlocks = nBlockX2 - nBlockX1 + 1;
+    const int nYBlocks = nBlockY2 - nBlockY1 + 1;
+    if( static_cast<GIntBig>(nXBlocks) * nYBlocks * nBlockBufSize *
+            (bSeparate ? nBandCount : 1) > GDALGetCacheMax64() / 4 )
+        return;
+
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, nBlockXSize);
+    uint16 nPredictor = PREDICTOR_NONE;
+    if( nCompression == COMPRESSION_LZW ||
+        nCompression == COMPRESSION_ADOBE_DEFLATE ||
+        nCompression == COMPRESSION_DEFLATE ||
+        nCompression == COMPRESSION_LZMA ||
+        nCompression == COMPRESSION_ZSTD )
+    {
+        TIFFGetField( hTIFF, TIFFTAG_PREDICTOR, &nPredictor );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Collect the blocks that are not yet in the cache.               */
+/* -------------------------------------------------------------------- */
+    std::vector<GTiffDecompressionJob> asJobs;
+    for( int iYBlock = nBlockY1; iYBlock <= nBlockY2; iYBlock++ )
+    {
+        for( int iXBlock = nBlockX1; iXBlock <= nBlockX2; iXBlock++ )
+        {
+            for( int i = 0; i < (bSeparate ? nBandCount : 1); i++ )
+            {
+                const int nBand = bSeparate ? panBandMap[i] : 0;
+                bool bMissing = false;
+                for( int iBand = 1; iBand <= nBands && !bMissing; iBand++ )
+                {
+                    if( bSeparate && iBand != nBand )
+                        continue;
+                    if( !static_cast<GTiffRasterBand*>(GetRasterBand(iBand))->
+                                    IsBlockInCache(iXBlock, iYBlock) )
+                        bMissing = true;
+                }
+                if( !bMissing )
+                    continue;
+
+                int nBlockId = iXBlock + iYBlock * nBlocksPerRow;
+                if( bSeparate )
+                    nBlockId += (nBand - 1) * nBlocksPerBand;
+                const vsi_l_offset nByteCount =
+                    GTiffGetStrileByteCount(hTIFF, nBlockId);
+                if( nBlockId == nLoadedBlock || nByteCount == 0 ||
+                    nByteCount > INT_MAX )
+                    continue;
+
+                GTiffDecompressionJob sJob;
+                memset(&sJob, 0, sizeof(sJob));
+                sJob.poDS = this;
+                sJob.bTIFFIsBigEndian = TIFFIsBigEndian(hTIFF);
+                sJob.nPredictor = nPredictor;
+                sJob.nBlockId = nBlockId;
+                sJob.nXBlockOff = iXBlock;
+                sJob.nYBlockOff = iYBlock;
+                sJob.nBand = nBand;
+                sJob.nCompressedBufferSize = static_cast<int>(nByteCount);
+                // Same as in IReadBlock(): the bottom most partial strips
+                // and tiles are sometimes only partially encoded
+                sJob.nReqSize = nBlockBufSize;
+                if( (iYBlock + 1) * static_cast<int>(nBlockYSize) >
+                                                            nRasterYSize )
+                {
+                    sJob.nReqSize = (nBlockBufSize / nBlockYSize) *
+                        (nBlockYSize -
+                         (((iYBlock + 1) * nBlockYSize) % nRasterYSize));
+                }
+                asJobs.push_back(sJob);
+            }
+        }
+    }
+    if( asJobs.size() < 2 )
+        return;
+
+    if( poMainDS->poDecompressThreadPool == NULL )
+    {
+        CPLDebug("GTiff", "Using %d threads for decompression",
+                 poMainDS->nDecompressThreads);
+        poMainDS->poDecompressThreadPool = new CPLWorkerThreadPool();
+        if( !poMainDS->poDecompressThreadPool->Setup(
+                            poMainDS->nDecompressThreads, NULL, NULL) )
+        {
+            delete poMainDS->poDecompressThreadPool;
+            poMainDS->poDecompressThreadPool = NULL;
+            poMainDS->nDecompressThreads = 0;
+            return;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Read the compressed bytes in this thread, as the TIFF handle    */
+/*      cannot be shared, and decode them in the worker threads.        */
+/* -------------------------------------------------------------------- */
+    bool bSubmitted = false;
+    for( size_t i = 0; i < asJobs.size(); i++ )
+    {
+        GTiffDecompressionJob* psJob = &asJobs[i];
+        psJob->pabyCompressedBuffer = static_cast<GByte*>(
+            VSIMalloc(psJob->nCompressedBufferSize));
+        psJob->pabyBuffer = static_cast<GByte*>(VSICalloc(1, nBlockBufSize));
+        if( psJob->pabyCompressedBuffer == NULL || psJob->pabyBuffer == NULL )
+            break;
+        const tmsize_t nRead = TIFFIsTiled(hTIFF) ?
+            TIFFReadRawTile(hTIFF, psJob->nBlockId,
+                            psJob->pabyCompressedBuffer,
+                            psJob->nCompressedBufferSize) :
+            TIFFReadRawStrip(hTIFF, psJob->nBlockId,
+                             psJob->pabyCompressedBuffer,
+                             psJob->nCompressedBufferSize);
+        if( nRead != psJob->nCompressedBufferSize )
+            continue;
+        poMainDS->poDecompressThreadPool->SubmitJob(
+                                        ThreadDecompressionFunc, psJob);
+        bSubmitted = true;
+    }
+    if( bSubmitted )
+        poMainDS->poDecompressThreadPool->WaitCompletion();
+
+/* -------------------------------------------------------------------- */
+/*      Put the decoded blocks in the cache.                            */
+/* -------------------------------------------------------------------- */
+    for( size_t i = 0; i < asJobs.size(); i++ )
+    {
+        GTiffDecompressionJob* psJob = &asJobs[i];
+        if( psJob->bOK )
+        {
+            for( int iBand = 1; iBand <= nBands; iBand++ )
+            {
+                if( psJob->nBand != 0 && iBand != psJob->nBand )
+                    continue;
+                GDALRasterBlock* poBlock = GetRasterBand(iBand)->
+                    GetLockedBlockRef(psJob->nXBlockOff, psJob->nYBlockOff,
+                                      TRUE);
+                if( poBlock == NULL )
+                    break;
+                if( psJob->nBand != 0 )
+                {
+                    memcpy(poBlock->GetDataRef(), psJob->pabyBuffer,
+                           nBlockBufSize);
+                }
+                else
+                {
+                    GDALCopyWords(psJob->pabyBuffer + (iBand - 1) * nWordBytes,
+                                  eDataType, nBands * nWordBytes,
+                                  poBlock->GetDataRef(), eDataType, nWordBytes,
+                                  nBlockXSize * nBlockYSize);
+                }
+                poBlock->DropLock();
+            }
+        }
+        VSIFree(psJob->pabyCompressedBuffer);
+        VSIFree(psJob->pabyBuffer);
+    }
+}
+
+/************************************************************************/
+/*                          CacheMultiRange()                           */
+/*                                                                      */
+/*      Fetch in one batch the encoded bytes of the blocks              */
+/*      intersecting a window to be read, merging close byte ranges,    */
+/*      so that the reads done by libtiff for those blocks are served   */
+/*      from memory instead of costing one request per block on         */
+/*      network file systems. Returns the buffer to pass to             */
+/*      ResetMultiRange() once the window has been read, or NULL.       */
+/************************************************************************/
+
+void* GTiffDataset::CacheMultiRange( int nXOff, int nYOff,
+                                     int nXSize, int nYSize,
+                                     int nBandCount, int *panBandMap )
+{
+    // Ranges separated by less than this are fetched as a single one, as
+    // reading a few more bytes is cheaper than an additional request
+    const vsi_l_offset nMergeGap = 16384;
+
+    if( eAccess != GA_ReadOnly || bStreamingIn || nBands == 0 )
+        return NULL;
+
+    const int nBlockX1 = nXOff / nBlockXSize;
+    const int nBlockY1 = nYOff / nBlockYSize;
+    const int nBlockX2 = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nBlockY2 = (nYOff + nYSize - 1) / nBlockYSize;
+    if( nBlockX1 == nBlockX2 && nBlockY1 == nBlockY2 )
+        return NULL;
+
+    // Enabled by default on the file systems where each read is a request
+    GTiffDataset* poMainDS = this;
+    while( poMainDS->poBaseDS != NULL )
+        poMainDS = poMainDS->poBaseDS;
+    const char* pszMultiRange = CPLGetConfigOption("GTIFF_MULTIRANGE", NULL);
+    if( pszMultiRange != NULL ? !CPLTestBool(pszMultiRange) :
+        !(STARTS_WITH(poMainDS->osFilename, "/vsicurl/") ||
+          STARTS_WITH(poMainDS->osFilename, "/vsis3/")) )
+        return NULL;
+
+    // Band IRasterIO() nested in a dataset IRasterIO() use the ranges
+    // already fetched
+    thandle_t th = TIFFClientdata( hTIFF );
+    if( VSI_TIFFHasCachedRanges(th) )
+        return NULL;
+
+    if( !SetDirectory() )
+        return NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Collect the ranges of the blocks that are not yet in the        */
+/*      cache, up to a reasonable amount of memory.                     */
+/* -------------------------------------------------------------------- */
+    const bool bSeparate = (nPlanarConfig == PLANARCONFIG_SEPARATE);
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, nBlockXSize);
+    const GIntBig nMaxSize = GDALGetCacheMax64() / 4;
+    GIntBig nTotalSize = 0;
+    std::vector< std::pair<vsi_l_offset, vsi_l_offset> > aoRanges;
+    for( int iYBlock = nBlockY1; iYBlock <= nBlockY2; iYBlock++ )
+    {
+        for( int iXBlock = nBlockX1; iXBlock <= nBlockX2; iXBlock++ )
+        {
+            for( int i = 0; i < (bSeparate ? nBandCount : 1); i++ )
+            {
+                bool bMissing = false;
+                for( int j = 0; j < nBandCount && !bMissing; j++ )
+                {
+                    if( bSeparate && j != i )
+                        continue;
+                    if( !static_cast<GTiffRasterBand*>(
+                            GetRasterBand(panBandMap[j]))->
+                                    IsBlockInCache(iXBlock, iYBlock) )
+                        bMissing = true;
+                }
+                if( !bMissing )
+                    continue;
+
+                int nBlockId = iXBlock + iYBlock * nBlocksPerRow;
+                if( bSeparate )
+                    nBlockId += (panBandMap[i] - 1) * nBlocksPerBand;
+                const vsi_l_offset nByteCount =
+                    GTiffGetStrileByteCount(hTIFF, nBlockId);
+                if( nBlockId == nLoadedBlock || nByteCount == 0 )
+                    continue;
+                if( nTotalSize + static_cast<GIntBig>(nByteCount) > nMaxSize )
+                    break;
+                nTotalSize += nByteCount;
+                const vsi_l_offset nOffset =
+                    GTiffGetStrileOffset(hTIFF, nBlockId);
+                aoRanges.push_back(std::pair<vsi_l_offset, vsi_l_offset>(
+                    nOffset, nOffset + nByteCount));
+            }
+        }
+    }
+    if( aoRanges.size() < 2 )
+        return NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Merge the ranges that are adjacent or close to each other.      */
+/* -------------------------------------------------------------------- */
+    std::sort(aoRanges.begin(), aoRanges.end());
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<size_t> anSizes;
+    vsi_l_offset nStart = aoRanges[0].first;
+    vsi_l_offset nEnd = aoRanges[0].second;
+    GIntBig nMergedSize = 0;
+    for( size_t i = 1; i <= aoRanges.size(); i++ )
+    {
+        if( i < aoRanges.size() && aoRanges[i].first <= nEnd + nMergeGap )
+        {
+            nEnd = std::max(nEnd, aoRanges[i].second);
+            continue;
+        }
+        anOffsets.push_back(nStart);
+        anSizes.push_back(static_cast<size_t>(nEnd - nStart));
+        nMergedSize += nEnd - nStart;
+        if( i < aoRanges.size() )
+        {
+            nStart = aoRanges[i].first;
+            nEnd = aoRanges[i].second;
+        }
+    }
+    if( nMergedSize > nMaxSize + static_cast<GIntBig>(nMergeGap) *
+                                    static_cast<GIntBig>(anOffsets.size()) ||
+        static_cast<GIntBig>(static_cast<size_t>(nMergedSize)) != nMergedSize )
+        return NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Fetch them in one call. On failure, the blocks are read one by  */
+/*      one by IReadBlock() as usual.                                   */
+/* -------------------------------------------------------------------- */
+    GByte* pabyBufferedData = static_cast<GByte*>(
+                            VSIMalloc(static_cast<size_t>(nMergedSize)));
+    if( pabyBufferedData == NULL )
+        return NULL;
+    std::vector<void*> apData;
+    size_t nAccSize = 0;
+    for( size_t i = 0; i < anOffsets.size(); i++ )
+    {
+        apData.push_back(pabyBufferedData + nAccSize);
+        nAccSize += anSizes[i];
+    }
+
+    VSILFILE* fp = VSI_TIFFGetVSILFile(th);
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    const int nRet = VSIFReadMultiRangeL(static_cast<int>(anOffsets.size()),
+                                         &apData[0], &anOffsets[0],
+                                         &anSizes[0], fp);
+    CPLPopErrorHandler();
+    if( nRet != 0 )
+    {
+        CPLDebug("GTiff", "VSIFReadMultiRangeL() failed: %s",
+                 CPLGetLastErrorMsg());
+        CPLErrorReset();
+        VSIFree(pabyBufferedData);
+        return NULL;
+    }
+
+    CPLDebug("GTiff", "Fetched %d blocks in %d range(s) of " CPL_FRMT_GIB
+             " bytes", static_cast<int>(aoRanges.size()),
+             static_cast<int>(anOffsets.size()), nMergedSize);
+    VSI_TIFFSetCachedRanges(th, static_cast<int>(anOffsets.size()),
+                            &apData[0], &anOffsets[0], &anSizes[0]);
+    return pabyBufferedData;
+}
+
+/************************************************************************/
+/*                          ResetMultiRange()                           */
+/************************************************************************/
+
+void GTiffDataset::ResetMultiRange( void* pBufferedData )
+{
+    if( pBufferedData == NULL )
+        return;
+    VSI_TIFFSetCachedRanges(TIFFClientdata( hTIFF ), 0, NULL, NULL, NULL);
+    VSIFree(pBufferedData);
+}
+
 /************************************************************************/
 /*                          DiscardLsb()                               */
 /************************************************************************/
@@ -7465,95 +8208,24 @@ void GTiffDataset::Crystalize()
             CPLPopErrorHandler();
         }
         else
-            TIFFSetDirectory( hTIFF, 0 );
-
-
-        // Now, reset zip and tiff quality and jpegcolormode.
-        if(jquality > 0)
-            TIFFSetField(hTIFF, TIFFTAG_JPEGQUALITY, jquality);
-        if(zquality > 0)
-            TIFFSetField(hTIFF, TIFFTAG_ZIPQUALITY, zquality);
-        if (nColorMode >= 0)
-            TIFFSetField(hTIFF, TIFFTAG_JPEGCOLORMODE, nColorMode);
-        if (nJpegTablesModeIn >= 0 )
-            TIFFSetField(hTIFF, TIFFTAG_JPEGTABLESMODE, nJpegTablesModeIn);
-
-        nDirOffset = TIFFCurrentDirOffset( hTIFF );
-    }
-}
-
-#ifdef INTERNAL_LIBTIFF
-
-#define IO_CACHE_PAGE_SIZE      4096
-
-static
-void GTiffCacheOffsetOrCount(VSILFILE* fp,
-                             vsi_l_offset nBaseOffset,
-                             int nBlockId,
-                             uint32 nstrips,
-                             uint64* panVals,
-                             size_t sizeofval)
-{
-    int i, iStartBefore;
-    vsi_l_offset nOffset, nOffsetStartPage, nOffsetEndPage;
-    GByte buffer[2 * IO_CACHE_PAGE_SIZE];
-
-    nOffset = nBaseOffset + sizeofval * nBlockId;
-    nOffsetStartPage = (nOffset / IO_CACHE_PAGE_SIZE) * IO_CACHE_PAGE_SIZE;
-    nOffsetEndPage = nOffsetStartPage + IO_CACHE_PAGE_SIZE;
-
-    if( nOffset + sizeofval > nOffsetEndPage )
-        nOffsetEndPage += IO_CACHE_PAGE_SIZE;
-    vsi_l_offset nLastStripOffset = nBaseOffset + nstrips * sizeofval;
-    if( nLastStripOffset < nOffsetEndPage )
-        nOffsetEndPage  = nLastStripOffset;
-    if( nOffsetStartPage >= nOffsetEndPage )
-    {
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "Cannot read offset/size for strile %d", nBlockId);
-        panVals[nBlockId] = 0;
-        return;
-    }
-    if( VSIFSeekL(fp, nOffsetStartPage, SEEK_SET) != 0 )
-    {
-        panVals[nBlockId] = 0;
-        return;
-    }
-    size_t nToRead = (size_t)(nOffsetEndPage - nOffsetStartPage);
-    size_t nRead = VSIFReadL(buffer, 1, nToRead, fp);
-    if( nRead < nToRead )
-    {
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "Cannot read offset/size for strile around ~%d", nBlockId);
-        memset(buffer + nRead, 0, nToRead - nRead);
-    }
-    iStartBefore = - (int)((nOffset - nOffsetStartPage) / sizeofval);
-    if( nBlockId + iStartBefore < 0 )
-        iStartBefore = -nBlockId;
-    for(i=iStartBefore; (uint32)(nBlockId + i) < nstrips &&
-        (GIntBig)nOffset + (i+1) * (int)sizeofval <= (GIntBig)nOffsetEndPage; i++)
-    {
-        if( sizeofval == 4 )
-        {
-            uint32 val;
-            memcpy(&val,
-                   buffer + (nOffset - nOffsetStartPage) + i * sizeof(val),
-                   sizeof(val));
-            panVals[nBlockId + i] = val;
-        }
-        else
-        {
-            uint64 val;
-            memcpy(&val,
-                   buffer + (nOffset - nOffsetStartPage) + i * sizeof(val),
-                   sizeof(val));
-            panVals[nBlockId + i] = val;
-        }
+            TIFFSetDirectory( hTIFF, 0 );
+
+
+        // Now, reset zip and tiff quality and jpegcolormode.
+        if(jquality > 0)
+            TIFFSetField(hTIFF, TIFFTAG_JPEGQUALITY, jquality);
+        if(zquality > 0)
+            TIFFSetField(hTIFF, TIFFTAG_ZIPQUALITY, zquality);
+        if (nColorMode >= 0)
+            TIFFSetField(hTIFF, TIFFTAG_JPEGCOLORMODE, nColorMode);
+        if (nJpegTablesModeIn >= 0 )
+            TIFFSetField(hTIFF, TIFFTAG_JPEGTABLESMODE, nJpegTablesModeIn);
+        SetZSTDAndLercFields(hTIFF);
+
+        nDirOffset = TIFFCurrentDirOffset( hTIFF );
     }
 }
 
-#endif /* INTERNAL_LIBTIFF */
-
 /************************************************************************/
 /*                          IsBlockAvailable()                          */
 /*                                                                      */
@@ -7565,127 +8237,7 @@ void GTiffCacheOffsetOrCount(VSILFILE* fp,
 int GTiffDataset::IsBlockAvailable( int nBlockId )
 
 {
-#ifdef INTERNAL_LIBTIFF
-#ifdef DEFER_STRILE_LOAD
-    /* Optimization to avoid fetching the whole Strip/TileCounts and Strip/TileOffsets arrays */
-    if( eAccess == GA_ReadOnly &&
-        !(hTIFF->tif_flags & TIFF_SWAB) &&
-        hTIFF->tif_dir.td_nstrips > 2 &&
-        (hTIFF->tif_dir.td_stripoffset_entry.tdir_type == TIFF_LONG ||
-         hTIFF->tif_dir.td_stripoffset_entry.tdir_type == TIFF_LONG8) &&
-        (hTIFF->tif_dir.td_stripbytecount_entry.tdir_type == TIFF_LONG ||
-         hTIFF->tif_dir.td_stripbytecount_entry.tdir_type == TIFF_LONG8) &&
-        !bStreamingIn )
-    {
-        if( hTIFF->tif_dir.td_stripoffset == NULL )
-        {
-            hTIFF->tif_dir.td_stripoffset =
-                (uint64*) _TIFFmalloc( sizeof(uint64) * hTIFF->tif_dir.td_nstrips );
-            hTIFF->tif_dir.td_stripbytecount =
-                (uint64*) _TIFFmalloc( sizeof(uint64) * hTIFF->tif_dir.td_nstrips );
-            if( hTIFF->tif_dir.td_stripoffset && hTIFF->tif_dir.td_stripbytecount )
-            {
-                memset(hTIFF->tif_dir.td_stripoffset, 0xFF,
-                       sizeof(uint64) * hTIFF->tif_dir.td_nstrips );
-                memset(hTIFF->tif_dir.td_stripbytecount, 0xFF,
-                       sizeof(uint64) * hTIFF->tif_dir.td_nstrips );
-            }
-            else
-            {
-                _TIFFfree(hTIFF->tif_dir.td_stripoffset);
-                hTIFF->tif_dir.td_stripoffset = NULL;
-                _TIFFfree(hTIFF->tif_dir.td_stripbytecount);
-                hTIFF->tif_dir.td_stripbytecount = NULL;
-            }
-        }
-        if( hTIFF->tif_dir.td_stripbytecount == NULL )
-            return FALSE;
-        if( ~(hTIFF->tif_dir.td_stripoffset[nBlockId]) == 0 ||
-            ~(hTIFF->tif_dir.td_stripbytecount[nBlockId]) == 0 )
-        {
-            VSILFILE* fp = VSI_TIFFGetVSILFile(TIFFClientdata( hTIFF ));
-            vsi_l_offset nCurOffset = VSIFTellL(fp);
-            if( ~(hTIFF->tif_dir.td_stripoffset[nBlockId]) == 0 )
-            {
-                vsi_l_offset l_nDirOffset;
-                if( hTIFF->tif_flags&TIFF_BIGTIFF )
-                    l_nDirOffset = hTIFF->tif_dir.td_stripoffset_entry.tdir_offset.toff_long8;
-                else
-                    l_nDirOffset = hTIFF->tif_dir.td_stripoffset_entry.tdir_offset.toff_long;
-
-                if( hTIFF->tif_dir.td_stripoffset_entry.tdir_type == TIFF_LONG )
-                {
-                    GTiffCacheOffsetOrCount(fp,
-                                            l_nDirOffset,
-                                            nBlockId,
-                                            hTIFF->tif_dir.td_nstrips,
-                                            hTIFF->tif_dir.td_stripoffset,
-                                            sizeof(uint32));
-                }
-                else
-                {
-                    GTiffCacheOffsetOrCount(fp,
-                                            l_nDirOffset,
-                                            nBlockId,
-                                            hTIFF->tif_dir.td_nstrips,
-                                            hTIFF->tif_dir.td_stripoffset,
-                                            sizeof(uint64));
-                }
-            }
-
-            if( ~(hTIFF->tif_dir.td_stripbytecount[nBlockId]) == 0 )
-            {
-                vsi_l_offset l_nDirOffset;
-                if( hTIFF->tif_flags&TIFF_BIGTIFF )
-                    l_nDirOffset = hTIFF->tif_dir.td_stripbytecount_entry.tdir_offset.toff_long8;
-                else
-                    l_nDirOffset = hTIFF->tif_dir.td_stripbytecount_entry.tdir_offset.toff_long;
-
-                if( hTIFF->tif_dir.td_stripbytecount_entry.tdir_type == TIFF_LONG )
-                {
-                    GTiffCacheOffsetOrCount(fp,
-                                            l_nDirOffset,
-                                            nBlockId,
-                                            hTIFF->tif_dir.td_nstrips,
-                                            hTIFF->tif_dir.td_stripbytecount,
-                                            sizeof(uint32));
-                }
-                else
-                {
-                    GTiffCacheOffsetOrCount(fp,
-                                            l_nDirOffset,
-                                            nBlockId,
-                                            hTIFF->tif_dir.td_nstrips,
-                                            hTIFF->tif_dir.td_stripbytecount,
-                                            sizeof(uint64));
-                }
-            }
-            if( VSIFSeekL(fp, nCurOffset, SEEK_SET) != 0 )
-            {
-                /* For some reason Coverity tells: */
-                /* Value of non-local "this->hTIFF->tif_dir.td_stripoffset" that was verified to be "NULL" is not restored as it was along other paths. */
-                /* coverity[end_of_path] */
-                return FALSE;
-            }
-        }
-        return hTIFF->tif_dir.td_stripbytecount[nBlockId] != 0;
-    }
-#endif /* DEFER_STRILE_LOAD */
-#endif /* INTERNAL_LIBTIFF */
-    toff_t *panByteCounts = NULL;
-
-    if( ( TIFFIsTiled( hTIFF )
-          && TIFFGetField( hTIFF, TIFFTAG_TILEBYTECOUNTS, &panByteCounts ) )
-        || ( !TIFFIsTiled( hTIFF )
-          && TIFFGetField( hTIFF, TIFFTAG_STRIPBYTECOUNTS, &panByteCounts ) ) )
-    {
-        if( panByteCounts == NULL )
-            return FALSE;
-        else
-            return panByteCounts[nBlockId] != 0;
-    }
-    else
-        return FALSE;
+    return GTiffGetStrileByteCount( hTIFF, nBlockId ) != 0;
 }
 
 /************************************************************************/
@@ -7901,6 +8453,8 @@ CPLErr GTiffDataset::RegisterNewOverviewDataset(toff_t nOverviewOffset)
     poODS->nJpegQuality = nJpegQuality;
     poODS->nZLevel = nZLevel;
     poODS->nLZMAPreset = nLZMAPreset;
+    poODS->nZSTDLevel = nZSTDLevel;
+    poODS->dfMaxZError = dfMaxZError;
 
     if( nCompression == COMPRESSION_JPEG )
     {
@@ -7920,21 +8474,55 @@ CPLErr GTiffDataset::RegisterNewOverviewDataset(toff_t nOverviewOffset)
     }
     else
     {
+        // The new directory was written with the default LERC parameters
+        poODS->nLercAddCompression = nLercAddCompression;
+
         nOverviewCount++;
         papoOverviewDS = (GTiffDataset **)
             CPLRealloc(papoOverviewDS,
                         nOverviewCount * (sizeof(void*)));
         papoOverviewDS[nOverviewCount-1] = poODS;
         poODS->poBaseDS = this;
+        poODS->SetFileHandleOwner(this);
         return CE_None;
     }
 }
 
+/************************************************************************/
+/*                      GTiffGetSrcOverviewBand()                       */
+/*                                                                      */
+/*      Overviews to copy are either those of the source dataset, or    */
+/*      the ones built by CreateCopy() in poOvrDS, whose full           */
+/*      resolution is the first overview level.                         */
+/************************************************************************/
+
+static GDALRasterBand* GTiffGetSrcOverviewBand( GDALDataset* poSrcDS,
+                                                GDALDataset* poOvrDS,
+                                                int iBand, int iOvrLevel )
+{
+    if( poOvrDS == NULL )
+        return poSrcDS->GetRasterBand(iBand)->GetOverview(iOvrLevel);
+    if( iOvrLevel == 0 )
+        return poOvrDS->GetRasterBand(iBand);
+    return poOvrDS->GetRasterBand(iBand)->GetOverview(iOvrLevel - 1);
+}
+
+static int GTiffGetSrcOverviewCount( GDALDataset* poSrcDS,
+                                     GDALDataset* poOvrDS )
+{
+    if( poOvrDS == NULL )
+        return poSrcDS->GetRasterBand(1)->GetOverviewCount();
+    return 1 + poOvrDS->GetRasterBand(1)->GetOverviewCount();
+}
+
 /************************************************************************/
 /*                  CreateOverviewsFromSrcOverviews()                   */
 /************************************************************************/
 
-CPLErr GTiffDataset::CreateOverviewsFromSrcOverviews(GDALDataset* poSrcDS)
+CPLErr GTiffDataset::CreateOverviewsFromSrcOverviews(GDALDataset* poSrcDS,
+                                                     GDALDataset* poOvrDS,
+                                                     int nOvrBlockXSize,
+                                                     int nOvrBlockYSize)
 {
     CPLAssert(poSrcDS->GetRasterCount() != 0);
     CPLAssert(nOverviewCount == 0);
@@ -8024,18 +8612,18 @@ CPLErr GTiffDataset::CreateOverviewsFromSrcOverviews(GDALDataset* poSrcDS)
 /* -------------------------------------------------------------------- */
     uint16 nPredictor = PREDICTOR_NONE;
     if ( nCompression == COMPRESSION_LZW ||
-         nCompression == COMPRESSION_ADOBE_DEFLATE )
+         nCompression == COMPRESSION_ADOBE_DEFLATE ||
+         nCompression == COMPRESSION_ZSTD )
         TIFFGetField( hTIFF, TIFFTAG_PREDICTOR, &nPredictor );
-    int nOvrBlockXSize, nOvrBlockYSize;
-    GTIFFGetOverviewBlockSize(&nOvrBlockXSize, &nOvrBlockYSize);
 
-    int nSrcOverviews = poSrcDS->GetRasterBand(1)->GetOverviewCount();
+    int nSrcOverviews = GTiffGetSrcOverviewCount(poSrcDS, poOvrDS);
     int i;
     CPLErr eErr = CE_None;
 
     for(i=0;i<nSrcOverviews && eErr == CE_None;i++)
     {
-        GDALRasterBand* poOvrBand = poSrcDS->GetRasterBand(1)->GetOverview(i);
+        GDALRasterBand* poOvrBand =
+            GTiffGetSrcOverviewBand(poSrcDS, poOvrDS, 1, i);
 
         int         nOXSize = poOvrBand->GetXSize(), nOYSize = poOvrBand->GetYSize();
 
@@ -8132,6 +8720,7 @@ CPLErr GTiffDataset::CreateInternalMaskOverviews(int nOvrBlockXSize,
                 {
                     poODS->bPromoteTo8Bits = CPLTestBool(CPLGetConfigOption("GDAL_TIFF_INTERNAL_MASK_TO_8BIT", "YES"));
                     poODS->poBaseDS = this;
+                    poODS->SetFileHandleOwner(this);
                     papoOverviewDS[i]->poMaskDS = poODS;
                     poMaskDS->nOverviewCount++;
                     poMaskDS->papoOverviewDS = (GTiffDataset **)
@@ -8377,7 +8966,8 @@ CPLErr GTiffDataset::IBuildOverviews(
 /* -------------------------------------------------------------------- */
     uint16 nPredictor = PREDICTOR_NONE;
     if ( nCompression == COMPRESSION_LZW ||
-         nCompression == COMPRESSION_ADOBE_DEFLATE )
+         nCompression == COMPRESSION_ADOBE_DEFLATE ||
+         nCompression == COMPRESSION_ZSTD )
         TIFFGetField( hTIFF, TIFFTAG_PREDICTOR, &nPredictor );
 
 /* -------------------------------------------------------------------- */
@@ -9585,6 +10175,7 @@ int GTiffDataset::SetDirectory( toff_t nNewOffset )
             TIFFSetField(hTIFF, TIFFTAG_ZIPQUALITY, nZLevel);
         if(nLZMAPreset > 0 && nCompression == COMPRESSION_LZMA)
             TIFFSetField(hTIFF, TIFFTAG_LZMAPRESET, nLZMAPreset);
+        SetZSTDAndLercFields(hTIFF);
     }
 
     return nSetDirResult;
@@ -9952,10 +10543,16 @@ GDALDataset *GTiffDataset::Open( GDALOpenInfo * poOpenInfo )
             return NULL;
     }
 
+    /* Load the strip/tile offsets and bytecounts on demand, except when */
+    /* streaming as we cannot seek back to them */
+    CPLString osOpenMode( ( poOpenInfo->eAccess == GA_ReadOnly ) ? "r" : "r+" );
+    if( poOpenInfo->eAccess == GA_ReadOnly && !bStreaming )
+        osOpenMode += "O";
+
     /* Store errors/warnings and emit them later */
     std::vector<GTIFFErrorStruct> aoErrors;
     CPLPushErrorHandlerEx(GTIFFErrorHandler, &aoErrors);
-    hTIFF = VSI_TIFFOpen( pszFilename, ( poOpenInfo->eAccess == GA_ReadOnly ) ? "rc" : "r+c",
+    hTIFF = VSI_TIFFOpen( pszFilename, (osOpenMode + "c").c_str(),
                           poOpenInfo->fpL );
     CPLPopErrorHandler();
 #if SIZEOF_VOIDP == 4
@@ -9964,7 +10561,7 @@ GDALDataset *GTiffDataset::Open( GDALOpenInfo * poOpenInfo )
         /* Case of one-strip file where the strip size is > 2GB (#5403) */
         if( bGlobalStripIntegerOverflow )
         {
-            hTIFF = VSI_TIFFOpen( pszFilename, ( poOpenInfo->eAccess == GA_ReadOnly ) ? "r" : "r+",
+            hTIFF = VSI_TIFFOpen( pszFilename, osOpenMode,
                                   poOpenInfo->fpL );
             bGlobalStripIntegerOverflow = FALSE;
         }
@@ -10052,7 +10649,7 @@ GDALDataset *GTiffDataset::Open( GDALOpenInfo * poOpenInfo )
         {
             CPLDebug("GTiff", "Reopen with strip chop enabled");
             XTIFFClose(hTIFF);
-            hTIFF = VSI_TIFFOpen( pszFilename, ( poOpenInfo->eAccess == GA_ReadOnly ) ? "r" : "r+",
+            hTIFF = VSI_TIFFOpen( pszFilename, osOpenMode,
                                   poOpenInfo->fpL );
             if( hTIFF == NULL )
                 return( NULL );
@@ -10086,6 +10683,13 @@ GDALDataset *GTiffDataset::Open( GDALOpenInfo * poOpenInfo )
     {
         poDS->InitCreationOrOpenOptions(poOpenInfo->papszOpenOptions);
     }
+    else
+    {
+        poDS->InitDecompressionThreads(poOpenInfo->papszOpenOptions);
+    }
+
+    if( !bStreaming )
+        poDS->ReadGhostArea();
 
     if( nCompression == COMPRESSION_JPEG && poOpenInfo->eAccess == GA_Update )
     {
@@ -10267,14 +10871,51 @@ void GTiffDataset::LookForProjection()
     if (!SetDirectory())
         return;
 
+    CPLFree( pszProjection );
+    pszProjection = NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Reuse the projection resolved when the file was last opened,    */
+/*      if the GDAL_METADATA_SNAPSHOT_CACHE cache is enabled.           */
+/* -------------------------------------------------------------------- */
+    const bool bReportCompdCS =
+        CPLTestBool( CPLGetConfigOption("GTIFF_REPORT_COMPD_CS", "NO") );
+    CPLString osSnapshotKey;
+    if( eAccess == GA_ReadOnly )
+    {
+        // The key includes the configuration options that change the
+        // resolution of the SRS (see gt_wkt_srs.cpp).
+        osSnapshotKey.Printf( "GTiff.SRS." CPL_FRMT_GUIB ".%d.%d.%d.%s",
+            static_cast<GUIntBig>(nDirOffset),
+            bReportCompdCS ? 1 : 0,
+            CPLTestBool(CPLGetConfigOption("GTIFF_ESRI_CITATION", "YES")) ? 1 : 0,
+            CPLTestBool(CPLGetConfigOption("GTIFF_IMPORT_FROM_EPSG", "YES")) ? 1 : 0,
+            CPLGetConfigOption("GTIFF_LINEAR_UNITS", "DEFAULT") );
+        CPLXMLNode* psSnapshot =
+            GDALGetMetadataSnapshot( osFilename, osSnapshotKey );
+        if( psSnapshot != NULL )
+        {
+            pszProjection = CPLStrdup(
+                CPLGetXMLValue( psSnapshot, "WKT", "" ) );
+            const char* pszAreaOrPoint =
+                CPLGetXMLValue( psSnapshot, "AreaOrPoint", NULL );
+            if( pszAreaOrPoint != NULL )
+                oGTiffMDMD.SetMetadataItem( GDALMD_AREA_OR_POINT,
+                                            pszAreaOrPoint );
+            CPLDestroyXMLNode( psSnapshot );
+
+            bGeoTIFFInfoChanged = FALSE;
+            bForceUnsetGTOrGCPs = FALSE;
+            bForceUnsetProjection = FALSE;
+            return;
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Capture the GeoTIFF projection, if available.                   */
 /* -------------------------------------------------------------------- */
     GTIF 	*hGTIF;
 
-    CPLFree( pszProjection );
-    pszProjection = NULL;
-
     hGTIF = GTIFNew(hTIFF);
 
     if ( !hGTIF )
@@ -10298,8 +10939,7 @@ void GTiffDataset::LookForProjection()
 
             // Should we simplify away vertical CS stuff?
             if( STARTS_WITH_CI(pszProjection, "COMPD_CS")
-                && !CPLTestBool( CPLGetConfigOption("GTIFF_REPORT_COMPD_CS",
-                                                       "NO") ) )
+                && !bReportCompdCS )
             {
                 OGRSpatialReference oSRS;
 
@@ -10334,6 +10974,20 @@ void GTiffDataset::LookForProjection()
         pszProjection = CPLStrdup( "" );
     }
 
+    if( !osSnapshotKey.empty() )
+    {
+        CPLXMLNode* psSnapshot =
+            CPLCreateXMLNode( NULL, CXT_Element, "GTiffSRS" );
+        CPLCreateXMLElementAndValue( psSnapshot, "WKT", pszProjection );
+        const char* pszAreaOrPoint =
+            oGTiffMDMD.GetMetadataItem( GDALMD_AREA_OR_POINT );
+        if( pszAreaOrPoint != NULL )
+            CPLCreateXMLElementAndValue( psSnapshot, "AreaOrPoint",
+                                         pszAreaOrPoint );
+        GDALSetMetadataSnapshot( osFilename, osSnapshotKey, psSnapshot );
+        CPLDestroyXMLNode( psSnapshot );
+    }
+
     bGeoTIFFInfoChanged = FALSE;
     bForceUnsetGTOrGCPs = FALSE;
     bForceUnsetProjection = FALSE;
@@ -10529,7 +11183,7 @@ GDALDataset *GTiffDataset::OpenDir( GDALOpenInfo * poOpenInfo )
     VSILFILE* fpL = VSIFOpenL(pszFilename, "r");
     if( fpL == NULL )
         return NULL;
-    hTIFF = VSI_TIFFOpen( pszFilename, "r", fpL );
+    hTIFF = VSI_TIFFOpen( pszFilename, "rO", fpL );
     if( hTIFF == NULL )
     {
         CPL_IGNORE_RET_VAL(VSIFCloseL(fpL));
@@ -11041,6 +11695,10 @@ CPLErr GTiffDataset::OpenOffset( TIFF *hTIFFIn,
     }
 #endif
 
+    if( nCompression == COMPRESSION_LERC )
+        TIFFGetField( hTIFF, TIFFTAG_LERC_ADD_COMPRESSION,
+                      &nLercAddCompression );
+
 /* -------------------------------------------------------------------- */
 /*      YCbCr JPEG compressed images should be translated on the fly    */
 /*      to RGB by libtiff/libjpeg unless specifically requested         */
@@ -11470,6 +12128,17 @@ CPLErr GTiffDataset::OpenOffset( TIFF *hTIFFIn,
         oGTiffMDMD.SetMetadataItem( "COMPRESSION", "JP2000", "IMAGE_STRUCTURE" );
     else if( nCompression == COMPRESSION_LZMA )
         oGTiffMDMD.SetMetadataItem( "COMPRESSION", "LZMA", "IMAGE_STRUCTURE" );
+    else if( nCompression == COMPRESSION_ZSTD )
+        oGTiffMDMD.SetMetadataItem( "COMPRESSION", "ZSTD", "IMAGE_STRUCTURE" );
+    else if( nCompression == COMPRESSION_LERC )
+    {
+        if( nLercAddCompression == LERC_ADD_COMPRESSION_DEFLATE )
+            oGTiffMDMD.SetMetadataItem( "COMPRESSION", "LERC_DEFLATE", "IMAGE_STRUCTURE" );
+        else if( nLercAddCompression == LERC_ADD_COMPRESSION_ZSTD )
+            oGTiffMDMD.SetMetadataItem( "COMPRESSION", "LERC_ZSTD", "IMAGE_STRUCTURE" );
+        else
+            oGTiffMDMD.SetMetadataItem( "COMPRESSION", "LERC", "IMAGE_STRUCTURE" );
+    }
 
     else
     {
@@ -11934,6 +12603,7 @@ void GTiffDataset::ScanDirectories()
                                nOverviewCount * (sizeof(void*)));
                 papoOverviewDS[nOverviewCount-1] = poODS;
                 poODS->poBaseDS = this;
+                poODS->SetFileHandleOwner(this);
             }
         }
 
@@ -11969,6 +12639,7 @@ void GTiffDataset::ScanDirectories()
             {
                 CPLDebug( "GTiff", "Opened band mask.\n");
                 poMaskDS->poBaseDS = this;
+                poMaskDS->SetFileHandleOwner(this);
 
                 poMaskDS->bPromoteTo8Bits = CPLTestBool(CPLGetConfigOption("GDAL_TIFF_INTERNAL_MASK_TO_8BIT", "YES"));
             }
@@ -12003,6 +12674,7 @@ void GTiffDataset::ScanDirectories()
                         ((GTiffDataset*)papoOverviewDS[i])->poMaskDS = poDS;
                         poDS->bPromoteTo8Bits = CPLTestBool(CPLGetConfigOption("GDAL_TIFF_INTERNAL_MASK_TO_8BIT", "YES"));
                         poDS->poBaseDS = this;
+                        poDS->SetFileHandleOwner(this);
                         break;
                     }
                 }
@@ -12087,6 +12759,57 @@ static int GTiffGetLZMAPreset(char** papszOptions)
 }
 
 
+static int GTiffGetZSTDLevel(char** papszOptions)
+{
+    int nZSTDLevel = -1;
+    const char* pszValue = CSLFetchNameValue( papszOptions, "ZSTD_LEVEL" );
+    if( pszValue  != NULL )
+    {
+        nZSTDLevel =  atoi( pszValue );
+        if (!(nZSTDLevel >= 1 && nZSTDLevel <= 22))
+        {
+            CPLError( CE_Warning, CPLE_IllegalArg,
+                    "ZSTD_LEVEL=%s value not recognised, ignoring.",
+                    pszValue );
+            nZSTDLevel = -1;
+        }
+    }
+    return nZSTDLevel;
+}
+
+
+static double GTiffGetLERCMaxZError(char** papszOptions)
+{
+    double dfMaxZError = 0.0;
+    const char* pszValue = CSLFetchNameValue( papszOptions, "MAX_Z_ERROR" );
+    if( pszValue  != NULL )
+    {
+        dfMaxZError = CPLAtof( pszValue );
+        if (!(dfMaxZError >= 0.0))
+        {
+            CPLError( CE_Warning, CPLE_IllegalArg,
+                    "MAX_Z_ERROR=%s value not recognised, ignoring.",
+                    pszValue );
+            dfMaxZError = 0.0;
+        }
+    }
+    return dfMaxZError;
+}
+
+
+/* The additional compression applied on the LERC blobs of COMPRESS=LERC_xxx */
+static int GTiffGetLercAddCompression(const char* pszCompress)
+{
+    if( pszCompress == NULL )
+        return LERC_ADD_COMPRESSION_NONE;
+    if( EQUAL(pszCompress, "LERC_DEFLATE") )
+        return LERC_ADD_COMPRESSION_DEFLATE;
+    if( EQUAL(pszCompress, "LERC_ZSTD") )
+        return LERC_ADD_COMPRESSION_ZSTD;
+    return LERC_ADD_COMPRESSION_NONE;
+}
+
+
 static int GTiffGetZLevel(char** papszOptions)
 {
     int nZLevel = -1;
@@ -12287,12 +13010,29 @@ TIFF *GTiffDataset::CreateLL( const char * pszFilename,
             return NULL;
     }
 
+    // LERC blobs hold a single sample, so each band needs its own plane
+    if( nCompression == COMPRESSION_LERC && nBands > 1 )
+    {
+        if( CSLFetchNameValue(papszParmList,"INTERLEAVE") == NULL )
+            nPlanar = PLANARCONFIG_SEPARATE;
+        else if( nPlanar == PLANARCONFIG_CONTIG )
+        {
+            CPLError( CE_Failure, CPLE_NotSupported,
+                      "COMPRESS=%s is only supported with INTERLEAVE=BAND "
+                      "for multi-band images.", pszValue );
+            return NULL;
+        }
+    }
+    const int nLercAddCompression = GTiffGetLercAddCompression(pszValue);
+
     pszValue = CSLFetchNameValue( papszParmList, "PREDICTOR" );
     if( pszValue  != NULL )
         nPredictor =  atoi( pszValue );
 
     int nZLevel = GTiffGetZLevel(papszParmList);
     int nLZMAPreset = GTiffGetLZMAPreset(papszParmList);
+    int nZSTDLevel = GTiffGetZSTDLevel(papszParmList);
+    double dfMaxZError = GTiffGetLERCMaxZError(papszParmList);
     int nJpegQuality = GTiffGetJpegQuality(papszParmList);
     int nJpegTablesMode = GTiffGetJpegTablesMode(papszParmList);
 
@@ -12330,6 +13070,12 @@ TIFF *GTiffDataset::CreateLL( const char * pszFilename,
         CPLError(CE_Failure, CPLE_NotSupported, "Streaming not supported with COPY_SRC_OVERVIEWS");
         return NULL;
     }
+    if( bStreaming &&
+        CSLFetchBoolean(papszParmList, "CLOUD_OPTIMIZED", FALSE) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported, "Streaming not supported with CLOUD_OPTIMIZED");
+        return NULL;
+    }
     if( bStreaming )
     {
         static int nCounter = 0;
@@ -12774,7 +13520,8 @@ TIFF *GTiffDataset::CreateLL( const char * pszFilename,
 /*      Set compression related tags.                                   */
 /* -------------------------------------------------------------------- */
     if ( nCompression == COMPRESSION_LZW ||
-         nCompression == COMPRESSION_ADOBE_DEFLATE )
+         nCompression == COMPRESSION_ADOBE_DEFLATE ||
+         nCompression == COMPRESSION_ZSTD )
         TIFFSetField( hTIFF, TIFFTAG_PREDICTOR, nPredictor );
     if (nCompression == COMPRESSION_ADOBE_DEFLATE
         && nZLevel != -1)
@@ -12784,6 +13531,20 @@ TIFF *GTiffDataset::CreateLL( const char * pszFilename,
         TIFFSetField( hTIFF, TIFFTAG_JPEGQUALITY, nJpegQuality );
     else if( nCompression == COMPRESSION_LZMA && nLZMAPreset != -1)
         TIFFSetField( hTIFF, TIFFTAG_LZMAPRESET, nLZMAPreset );
+    else if( nCompression == COMPRESSION_ZSTD && nZSTDLevel != -1 )
+        TIFFSetField( hTIFF, TIFFTAG_ZSTD_LEVEL, nZSTDLevel );
+    else if( nCompression == COMPRESSION_LERC )
+    {
+        TIFFSetField( hTIFF, TIFFTAG_LERC_MAXZERROR, dfMaxZError );
+        TIFFSetField( hTIFF, TIFFTAG_LERC_ADD_COMPRESSION,
+                      nLercAddCompression );
+        if( nLercAddCompression == LERC_ADD_COMPRESSION_DEFLATE &&
+            nZLevel != -1 )
+            TIFFSetField( hTIFF, TIFFTAG_ZIPQUALITY, nZLevel );
+        else if( nLercAddCompression == LERC_ADD_COMPRESSION_ZSTD &&
+                 nZSTDLevel != -1 )
+            TIFFSetField( hTIFF, TIFFTAG_ZSTD_LEVEL, nZSTDLevel );
+    }
 
     if( nCompression == COMPRESSION_JPEG )
         TIFFSetField( hTIFF, TIFFTAG_JPEGTABLESMODE, nJpegTablesMode );
@@ -13223,6 +13984,10 @@ GDALDataset *GTiffDataset::Create( const char * pszFilename,
 
     poDS->nZLevel = GTiffGetZLevel(papszParmList);
     poDS->nLZMAPreset = GTiffGetLZMAPreset(papszParmList);
+    poDS->nZSTDLevel = GTiffGetZSTDLevel(papszParmList);
+    poDS->dfMaxZError = GTiffGetLERCMaxZError(papszParmList);
+    poDS->nLercAddCompression = GTiffGetLercAddCompression(
+                        CSLFetchNameValue(papszParmList, "COMPRESS"));
     poDS->nJpegQuality = GTiffGetJpegQuality(papszParmList);
     poDS->nJpegTablesMode = GTiffGetJpegTablesMode(papszParmList);
     poDS->InitCreationOrOpenOptions(papszParmList);
@@ -13291,6 +14056,34 @@ GDALDataset *GTiffDataset::Create( const char * pszFilename,
     return( poDS );
 }
 
+/************************************************************************/
+/*                        GTiffWriteGhostArea()                         */
+/*                                                                      */
+/*      Write the structural metadata of the cloud optimized layout     */
+/*      just after the TIFF header, before any IFD. Readers can check   */
+/*      it with the first range request they issue anyway.              */
+/************************************************************************/
+
+static bool GTiffWriteGhostArea( TIFF* hTIFF )
+{
+    /* The trailing space leaves room to switch NO to YES in place */
+    const CPLString osStructuralMD(
+        "LAYOUT=IFDS_BEFORE_DATA\n"
+        "KNOWN_INCOMPATIBLE_EDITION=NO\n " );
+    CPLString osGhost;
+    osGhost.Printf( "GDAL_STRUCTURAL_METADATA_SIZE=%06d bytes\n",
+                    static_cast<int>(osStructuralMD.size()) );
+    CPLAssert( osGhost.size() == GHOST_AREA_FIRST_LINE_SIZE );
+    osGhost += osStructuralMD;
+
+    thandle_t th = TIFFClientdata( hTIFF );
+    const toff_t nHeaderSize = GTiffGetHeaderSize( hTIFF );
+    const tsize_t nGhostSize = static_cast<tsize_t>(osGhost.size());
+    return nHeaderSize != 0 &&
+           TIFFGetSeekProc( hTIFF )( th, nHeaderSize, SEEK_SET ) == nHeaderSize &&
+           TIFFGetWriteProc( hTIFF )( th, &osGhost[0], nGhostSize ) == nGhostSize;
+}
+
 /************************************************************************/
 /*                             CreateCopy()                             */
 /************************************************************************/
@@ -13437,10 +14230,48 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
         }
     }
 
+/* -------------------------------------------------------------------- */
+/*      The cloud optimized layout copies the source overviews like     */
+/*      COPY_SRC_OVERVIEWS, or builds them if there are none, down to   */
+/*      a level that fits into a single block.                          */
+/* -------------------------------------------------------------------- */
+    const int bCloudOptimized =
+        CSLFetchBoolean(papszOptions, "CLOUD_OPTIMIZED", FALSE);
+    const int bCopySrcOverviews = bCloudOptimized ||
+        CSLFetchBoolean(papszOptions, "COPY_SRC_OVERVIEWS", FALSE);
+    if( bCloudOptimized && CSLFetchNameValue(papszOptions, "TILED") == NULL )
+        papszCreateOptions =
+            CSLSetNameValue( papszCreateOptions, "TILED", "YES" );
+
     int nSrcOverviews = poSrcDS->GetRasterBand(1)->GetOverviewCount();
+    std::vector<int> anOverviewFactors;
+    if( bCloudOptimized && nSrcOverviews == 0 )
+    {
+        const int nTargetXSize =
+            atoi(CSLFetchNameValueDef(papszOptions, "BLOCKXSIZE", "256"));
+        const int nTargetYSize =
+            atoi(CSLFetchNameValueDef(papszOptions, "BLOCKYSIZE", "256"));
+        int nOvrFactor = 1;
+        while( nOvrFactor < INT_MAX / 2 &&
+               (DIV_ROUND_UP(nXSize, nOvrFactor) > nTargetXSize ||
+                DIV_ROUND_UP(nYSize, nOvrFactor) > nTargetYSize) )
+        {
+            nOvrFactor *= 2;
+            anOverviewFactors.push_back(nOvrFactor);
+        }
+    }
+
     double dfExtraSpaceForOverviews = 0;
-    if (nSrcOverviews != 0 &&
-        CSLFetchBoolean(papszOptions, "COPY_SRC_OVERVIEWS", FALSE))
+    for( size_t i = 0; i < anOverviewFactors.size(); i++ )
+    {
+        dfExtraSpaceForOverviews +=
+            ((double)DIV_ROUND_UP(nXSize, anOverviewFactors[i])) *
+            DIV_ROUND_UP(nYSize, anOverviewFactors[i]);
+    }
+    const double dfBuiltOverviewPixels = dfExtraSpaceForOverviews;
+    dfExtraSpaceForOverviews *= nBands * (GDALGetDataTypeSize(eType) / 8);
+
+    if (nSrcOverviews != 0 && bCopySrcOverviews)
     {
         for(int j=1;j<=nBands;j++)
         {
@@ -13949,6 +14780,18 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
     }
 #endif
 
+/* -------------------------------------------------------------------- */
+/*      The ghost area advertising the cloud optimized layout goes      */
+/*      right after the TIFF header. All the IFDs are appended after    */
+/*      it, and then the imagery.                                       */
+/* -------------------------------------------------------------------- */
+    if( bCloudOptimized && !GTiffWriteGhostArea( hTIFF ) )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Cannot write the structural metadata of %s", pszFilename );
+        eErr = CE_Failure;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Cleanup                                                         */
 /* -------------------------------------------------------------------- */
@@ -14056,6 +14899,10 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
 
     poDS->CloneInfo( poSrcDS, nCloneInfoFlags );
     poDS->papszCreationOptions = CSLDuplicate( papszOptions );
+
+    /* Writing the imagery below must not flag the layout as broken */
+    const int bLayoutIFDSBeforeData = poDS->bLayoutIFDSBeforeData;
+    poDS->bLayoutIFDSBeforeData = FALSE;
     poDS->bDontReloadFirstBlock = bDontReloadFirstBlock;
 
 /* -------------------------------------------------------------------- */
@@ -14134,6 +14981,8 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
 
     poDS->nZLevel = GTiffGetZLevel(papszOptions);
     poDS->nLZMAPreset = GTiffGetLZMAPreset(papszOptions);
+    poDS->nZSTDLevel = GTiffGetZSTDLevel(papszOptions);
+    poDS->dfMaxZError = GTiffGetLERCMaxZError(papszOptions);
     poDS->nJpegQuality = GTiffGetJpegQuality(papszOptions);
     poDS->nJpegTablesMode = GTiffGetJpegTablesMode(papszOptions);
     poDS->GetDiscardLsbOption(papszOptions);
@@ -14161,6 +15010,11 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
             TIFFSetField( hTIFF, TIFFTAG_LZMAPRESET, poDS->nLZMAPreset );
         }
     }
+    else if( nCompression == COMPRESSION_ZSTD ||
+             nCompression == COMPRESSION_LERC )
+    {
+        poDS->SetZSTDAndLercFields(hTIFF);
+    }
 
     /* Precreate (internal) mask, so that the IBuildOverviews() below */
     /* has a chance to create also the overviews of the mask */
@@ -14180,15 +15034,94 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
 /*  compressed stream.                                                  */
 /* -------------------------------------------------------------------- */
 
-    /* For scaled progress due to overview copying */
+    /* For scaled progress due to overview building and copying */
     double dfTotalPixels = ((double)nXSize) * nYSize;
     double dfCurPixels = 0;
+    if( bCopySrcOverviews )
+    {
+        for(int i=0;i<nSrcOverviews;i++)
+        {
+            GDALRasterBand* poOvrBand = poSrcDS->GetRasterBand(1)->GetOverview(i);
+            dfTotalPixels += ((double)poOvrBand->GetXSize()) *
+                                      poOvrBand->GetYSize();
+        }
+        /* Building overviews reads the whole source once more */
+        if( !anOverviewFactors.empty() )
+            dfTotalPixels += ((double)nXSize) * nYSize + dfBuiltOverviewPixels;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Build the overviews of the cloud optimized layout in a          */
+/*      temporary file, that is then copied like source overviews.      */
+/* -------------------------------------------------------------------- */
+    GDALDataset* poOvrDS = NULL;
+    GDALDataset* poMaskOvrDS = NULL;
+    CPLString osTmpOvrFilename, osTmpMaskOvrFilename;
+
+    if( eErr == CE_None && !anOverviewFactors.empty() )
+    {
+        const char* pszResampling =
+            CSLFetchNameValueDef(papszOptions, "OVERVIEW_RESAMPLING", "NEAREST");
+        std::vector<GDALRasterBand*> apoSrcBands;
+        for(int j=1;j<=nBands;j++)
+            apoSrcBands.push_back(poSrcDS->GetRasterBand(j));
+
+        dfCurPixels = ((double)nXSize) * nYSize;
+        void* pScaledData = GDALCreateScaledProgress( 0.0,
+                                      dfCurPixels / dfTotalPixels,
+                                      pfnProgress, pProgressData);
+
+        osTmpOvrFilename.Printf("%s.ovr.tmp", pszFilename);
+        eErr = GTIFFBuildOverviews( osTmpOvrFilename, nBands, &apoSrcBands[0],
+                                    static_cast<int>(anOverviewFactors.size()),
+                                    &anOverviewFactors[0], pszResampling,
+                                    GDALScaledProgress, pScaledData );
+        GDALDestroyScaledProgress(pScaledData);
+        if( eErr == CE_None )
+        {
+            poOvrDS = (GDALDataset*) GDALOpen( osTmpOvrFilename, GA_ReadOnly );
+            if( poOvrDS == NULL )
+                eErr = CE_Failure;
+        }
+
+        if( eErr == CE_None && poDS->poMaskDS != NULL )
+        {
+            GDALRasterBand* poSrcMaskBand =
+                poSrcDS->GetRasterBand(1)->GetMaskBand();
+            osTmpMaskOvrFilename.Printf("%s.msk.ovr.tmp", pszFilename);
+            eErr = GTIFFBuildOverviews( osTmpMaskOvrFilename, 1, &poSrcMaskBand,
+                                        static_cast<int>(anOverviewFactors.size()),
+                                        &anOverviewFactors[0], "NEAREST",
+                                        GDALDummyProgress, NULL );
+            if( eErr == CE_None )
+            {
+                poMaskOvrDS = (GDALDataset*) GDALOpen( osTmpMaskOvrFilename,
+                                                       GA_ReadOnly );
+                if( poMaskOvrDS == NULL )
+                    eErr = CE_Failure;
+            }
+        }
+    }
 
     if (eErr == CE_None &&
-        nSrcOverviews != 0 &&
-        CSLFetchBoolean(papszOptions, "COPY_SRC_OVERVIEWS", FALSE))
+        (nSrcOverviews != 0 || poOvrDS != NULL) &&
+        bCopySrcOverviews)
     {
-        eErr = poDS->CreateOverviewsFromSrcOverviews(poSrcDS);
+        int nOvrBlockXSize, nOvrBlockYSize;
+        if( bCloudOptimized && TIFFIsTiled(hTIFF) )
+        {
+            /* All levels share the block size, so that a reader needs */
+            /* the same number of requests whatever the level */
+            nOvrBlockXSize = poDS->nBlockXSize;
+            nOvrBlockYSize = poDS->nBlockYSize;
+        }
+        else
+            GTIFFGetOverviewBlockSize(&nOvrBlockXSize, &nOvrBlockYSize);
+
+        nSrcOverviews = GTiffGetSrcOverviewCount(poSrcDS, poOvrDS);
+        eErr = poDS->CreateOverviewsFromSrcOverviews(poSrcDS, poOvrDS,
+                                                     nOvrBlockXSize,
+                                                     nOvrBlockYSize);
 
         if (poDS->nOverviewCount != nSrcOverviews)
         {
@@ -14200,12 +15133,6 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
         }
 
         int i;
-        for(i=0;i<nSrcOverviews;i++)
-        {
-            GDALRasterBand* poOvrBand = poSrcDS->GetRasterBand(1)->GetOverview(i);
-            dfTotalPixels += ((double)poOvrBand->GetXSize()) *
-                                      poOvrBand->GetYSize();
-        }
 
         char* papszCopyWholeRasterOptions[2] = { NULL, NULL };
         if (nCompression != COMPRESSION_NONE)
@@ -14218,10 +15145,16 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
 
             /* Create a fake dataset with the source overview level so that */
             /* GDALDatasetCopyWholeRaster can cope with it */
-            GDALDataset* poSrcOvrDS = GDALCreateOverviewDataset(poSrcDS, iOvrLevel, TRUE, FALSE);
+            GDALDataset* poSrcOvrDS;
+            if( poOvrDS == NULL )
+                poSrcOvrDS = GDALCreateOverviewDataset(poSrcDS, iOvrLevel, TRUE, FALSE);
+            else if( iOvrLevel == 0 )
+                poSrcOvrDS = poOvrDS;
+            else
+                poSrcOvrDS = GDALCreateOverviewDataset(poOvrDS, iOvrLevel - 1, TRUE, FALSE);
 
             GDALRasterBand* poOvrBand =
-                    poSrcDS->GetRasterBand(1)->GetOverview(iOvrLevel);
+                    GTiffGetSrcOverviewBand(poSrcDS, poOvrDS, 1, iOvrLevel);
             double dfNextCurPixels = dfCurPixels +
                     ((double)poOvrBand->GetXSize()) * poOvrBand->GetYSize();
 
@@ -14237,13 +15170,17 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
             dfCurPixels = dfNextCurPixels;
             GDALDestroyScaledProgress(pScaledData);
 
-            delete poSrcOvrDS;
+            if( poSrcOvrDS != poOvrDS )
+                delete poSrcOvrDS;
             poDS->papoOverviewDS[iOvrLevel]->FlushCache();
 
             /* Copy mask of the overview */
             if (eErr == CE_None && poDS->poMaskDS != NULL)
             {
-                eErr = GDALRasterBandCopyWholeRaster( poOvrBand->GetMaskBand(),
+                GDALRasterBand* poOvrMaskBand = (poMaskOvrDS != NULL) ?
+                    GTiffGetSrcOverviewBand(NULL, poMaskOvrDS, 1, iOvrLevel) :
+                    poOvrBand->GetMaskBand();
+                eErr = GDALRasterBandCopyWholeRaster( poOvrMaskBand,
                                                     poDS->papoOverviewDS[iOvrLevel]->poMaskDS->GetRasterBand(1),
                                                     papszCopyWholeRasterOptions,
                                                     GDALDummyProgress, NULL);
@@ -14252,6 +15189,15 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
         }
     }
 
+    if( poOvrDS != NULL )
+        GDALClose( (GDALDatasetH) poOvrDS );
+    if( poMaskOvrDS != NULL )
+        GDALClose( (GDALDatasetH) poMaskOvrDS );
+    if( osTmpOvrFilename.size() )
+        VSIUnlink( osTmpOvrFilename );
+    if( osTmpMaskOvrFilename.size() )
+        VSIUnlink( osTmpMaskOvrFilename );
+
 /* -------------------------------------------------------------------- */
 /*      Copy actual imagery.                                            */
 /* -------------------------------------------------------------------- */
@@ -14381,13 +15327,22 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
     }
     else if (bTryCopy && eErr == CE_None)
     {
-        char* papszCopyWholeRasterOptions[2] = { NULL, NULL };
+        char* papszCopyWholeRasterOptions[3] = { NULL, NULL, NULL };
+        int iCopyOption = 0;
         if (nCompression != COMPRESSION_NONE)
-            papszCopyWholeRasterOptions[0] = (char*) "COMPRESSED=YES";
+            papszCopyWholeRasterOptions[iCopyOption++] = (char*) "COMPRESSED=YES";
         /* For streaming with separate, we really want that bands are written */
         /* after each other, even if the source is pixel interleaved */
         else if( bStreaming && poDS->nPlanarConfig == PLANARCONFIG_SEPARATE )
-            papszCopyWholeRasterOptions[0] = (char*) "INTERLEAVE=BAND";
+            papszCopyWholeRasterOptions[iCopyOption++] = (char*) "INTERLEAVE=BAND";
+        /* Also read the source in a separate thread while we compress */
+        CPLString osNumThreads;
+        const char* pszNumThreads = CSLFetchNameValue( papszOptions, "NUM_THREADS" );
+        if( pszNumThreads != NULL )
+        {
+            osNumThreads.Printf("NUM_THREADS=%s", pszNumThreads);
+            papszCopyWholeRasterOptions[iCopyOption++] = (char*) osNumThreads.c_str();
+        }
         eErr = GDALDatasetCopyWholeRaster( (GDALDatasetH) poSrcDS,
                                             (GDALDatasetH) poDS,
                                             papszCopyWholeRasterOptions,
@@ -14396,6 +15351,18 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
 
     GDALDestroyScaledProgress(pScaledData);
 
+    /* Write the blocks still being compressed by worker threads, so */
+    /* that the full resolution data is not interleaved with the mask */
+    if( eErr == CE_None && bCloudOptimized && poDS->poMaskDS != NULL &&
+        poDS->poCompressThreadPool != NULL )
+    {
+        poDS->FlushCache();
+        const int nBlocks = poDS->nBlocksPerBand *
+            ((poDS->nPlanarConfig == PLANARCONFIG_SEPARATE) ? nBands : 1);
+        for( int i = 0; i < nBlocks; i++ )
+            poDS->WaitCompletionForBlock(i);
+    }
+
     if (eErr == CE_None && !bStreaming)
     {
         if (poDS->poMaskDS)
@@ -14411,6 +15378,14 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
             eErr = GDALDriver::DefaultCopyMasks( poSrcDS, poDS, bStrict );
     }
 
+    if( eErr == CE_None && bCloudOptimized )
+    {
+        /* Make sure all blocks are written before further modifications */
+        /* of the returned dataset can invalidate the layout */
+        poDS->FlushCache();
+        poDS->bLayoutIFDSBeforeData = bLayoutIFDSBeforeData;
+    }
+
     if( eErr == CE_Failure )
     {
         delete poDS;
@@ -15075,6 +16050,7 @@ CPLErr GTiffDataset::CreateMaskBand(int nFlagsIn)
             poMaskDS = NULL;
             return CE_Failure;
         }
+        poMaskDS->SetFileHandleOwner(this);
 
         return CE_None;
     }
@@ -15341,6 +16317,12 @@ int GTIFFGetCompressionMethod(const char* pszValue, const char* pszVariableName)
         nCompression = COMPRESSION_CCITTRLE;
     else if( EQUAL( pszValue, "LZMA" ) )
         nCompression = COMPRESSION_LZMA;
+    else if( EQUAL( pszValue, "ZSTD" ) )
+        nCompression = COMPRESSION_ZSTD;
+    else if( EQUAL( pszValue, "LERC" ) ||
+             EQUAL( pszValue, "LERC_DEFLATE" ) ||
+             EQUAL( pszValue, "LERC_ZSTD" ) )
+        nCompression = COMPRESSION_LERC;
     else
         CPLError( CE_Warning, CPLE_IllegalArg,
                     "%s=%s value not recognised, ignoring.",
@@ -15356,27 +16338,40 @@ int GTIFFGetCompressionMethod(const char* pszValue, const char* pszVariableName)
     }
 #endif
 
+    const int nLercAddCompression = GTiffGetLercAddCompression(pszValue);
+    if( nCompression == COMPRESSION_LERC &&
+        ((nLercAddCompression == LERC_ADD_COMPRESSION_DEFLATE &&
+          !TIFFIsCODECConfigured(COMPRESSION_ADOBE_DEFLATE)) ||
+         (nLercAddCompression == LERC_ADD_COMPRESSION_ZSTD &&
+          !TIFFIsCODECConfigured(COMPRESSION_ZSTD))) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                "Cannot create TIFF file due to missing codec for %s.", pszValue );
+        return -1;
+    }
+
     return nCompression;
 }
 
 /************************************************************************/
-/*                          GDALRegister_GTiff()                        */
+/*                        GTiffDriverInitMetadata()                     */
+/*                                                                      */
+/*      Deferred until the metadata of the driver is first requested,   */
+/*      since probing the codecs and building the option lists is       */
+/*      the most costly part of the registration.                       */
 /************************************************************************/
 
-void GDALRegister_GTiff()
+static void GTiffDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "GTiff" ) != NULL )
-        return;
-
-    char szCreateOptions[5000];
+    char szCreateOptions[6000];
     char szOptionalCompressItems[500];
     bool bHasJPEG = false;
     bool bHasLZW = false;
     bool bHasDEFLATE = false;
     bool bHasLZMA = false;
-
-    GDALDriver *poDriver = new GDALDriver();
+    bool bHasZSTD = false;
+    bool bHasLERC = false;
 
 /* -------------------------------------------------------------------- */
 /*      Determine which compression codecs are available that we        */
@@ -15434,8 +16429,29 @@ void GDALRegister_GTiff()
             strcat( szOptionalCompressItems,
                     "       <Value>LZMA</Value>" );
         }
+        else if( c->scheme == COMPRESSION_ZSTD )
+        {
+            bHasZSTD = true;
+            strcat( szOptionalCompressItems,
+                    "       <Value>ZSTD</Value>" );
+        }
+        else if( c->scheme == COMPRESSION_LERC )
+            bHasLERC = true;
     }
     _TIFFfree( codecs );
+
+    // The LERC variants depend on the availability of the other codecs
+    if( bHasLERC )
+    {
+        strcat( szOptionalCompressItems,
+                "       <Value>LERC</Value>" );
+        if( bHasDEFLATE )
+            strcat( szOptionalCompressItems,
+                    "       <Value>LERC_DEFLATE</Value>" );
+        if( bHasZSTD )
+            strcat( szOptionalCompressItems,
+                    "       <Value>LERC_ZSTD</Value>" );
+    }
 #endif
 
 /* -------------------------------------------------------------------- */
@@ -15446,7 +16462,7 @@ void GDALRegister_GTiff()
               "   <Option name='COMPRESS' type='string-select'>",
               szOptionalCompressItems,
               "   </Option>");
-    if (bHasLZW || bHasDEFLATE)
+    if (bHasLZW || bHasDEFLATE || bHasZSTD)
         strcat( szCreateOptions, ""
 "   <Option name='PREDICTOR' type='int' description='Predictor Type (1=default, 2=horizontal differencing, 3=floating point prediction)'/>");
     strcat( szCreateOptions, ""
@@ -15467,6 +16483,12 @@ void GDALRegister_GTiff()
     if (bHasLZMA)
         strcat( szCreateOptions, ""
 "   <Option name='LZMA_PRESET' type='int' description='LZMA compression level 0(fast)-9(slow)' default='6'/>");
+    if (bHasZSTD)
+        strcat( szCreateOptions, ""
+"   <Option name='ZSTD_LEVEL' type='int' description='ZSTD compression level 1(fast)-22(slow)' default='9'/>");
+    if (bHasLERC)
+        strcat( szCreateOptions, ""
+"   <Option name='MAX_Z_ERROR' type='float' description='Maximum error for LERC compression' default='0'/>");
     strcat( szCreateOptions, ""
 "   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression. Can be set to ALL_CPUS' default='1'/>"
 "   <Option name='NBITS' type='int' description='BITS for sub-byte files (1-7), sub-uint16 (9-15), sub-uint32 (17-31)'/>"
@@ -15523,6 +16545,16 @@ void GDALRegister_GTiff()
 "       <Value>BIG</Value>"
 "   </Option>"
 "   <Option name='COPY_SRC_OVERVIEWS' type='boolean' default='NO' description='Force copy of overviews of source dataset (CreateCopy())'/>"
+"   <Option name='CLOUD_OPTIMIZED' type='boolean' default='NO' description='Write IFDs first and overviews before full resolution data, building overviews if needed (CreateCopy())'/>"
+"   <Option name='OVERVIEW_RESAMPLING' type='string-select' default='NEAREST' description='Resampling method for the overviews built with CLOUD_OPTIMIZED=YES'>"
+"       <Value>NEAREST</Value>"
+"       <Value>AVERAGE</Value>"
+"       <Value>BILINEAR</Value>"
+"       <Value>CUBIC</Value>"
+"       <Value>CUBICSPLINE</Value>"
+"       <Value>LANCZOS</Value>"
+"       <Value>MODE</Value>"
+"   </Option>"
 "   <Option name='SOURCE_ICC_PROFILE' type='string' description='ICC profile'/>"
 "   <Option name='SOURCE_PRIMARIES_RED' type='string' description='x,y,1.0 (xyY) red chromaticity'/>"
 "   <Option name='SOURCE_PRIMARIES_GREEN' type='string' description='x,y,1.0 (xyY) green chromaticity'/>"
@@ -15543,8 +16575,6 @@ void GDALRegister_GTiff()
 /* -------------------------------------------------------------------- */
 /*      Set the driver details.                                         */
 /* -------------------------------------------------------------------- */
-    poDriver->SetDescription( "GTiff" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GeoTIFF" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_gtiff.html" );
     poDriver->SetMetadataItem( GDAL_DMD_MIMETYPE, "image/tiff" );
@@ -15556,26 +16586,46 @@ void GDALRegister_GTiff()
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST, szCreateOptions );
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
-"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression. Can be set to ALL_CPUS' default='1'/>"
+"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression, or for decompression in read-only mode. Can be set to ALL_CPUS' default='1'/>"
 "   <Option name='GEOTIFF_KEYS_FLAVOR' type='string-select' default='STANDARD' description='Which flavor of GeoTIFF keys must be used (for writing)'>"
 "       <Value>STANDARD</Value>"
 "       <Value>ESRI_PE</Value>"
 "   </Option>"
 "</OpenOptionList>" );
     poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
 #ifdef INTERNAL_LIBTIFF
     poDriver->SetMetadataItem( "LIBTIFF", "INTERNAL" );
 #else
     poDriver->SetMetadataItem( "LIBTIFF", TIFFLIB_VERSION_STR );
 #endif
+}
+
+/************************************************************************/
+/*                          GDALRegister_GTiff()                        */
+/************************************************************************/
+
+void GDALRegister_GTiff()
+
+{
+    if( GDALGetDriverByName( "GTiff" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "GTiff" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
+    poDriver->SetMetadataItem( GDAL_DMD_SIGNATURES,
+                               "49492A00 4949002A 49492B00 4949002B "
+                               "4D4D2A00 4D4D002A 4D4D2B00 4D4D002B" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = GTiffDataset::Open;
     poDriver->pfnCreate = GTiffDataset::Create;
     poDriver->pfnCreateCopy = GTiffDataset::CreateCopy;
     poDriver->pfnUnloadDriver = GDALDeregister_GTiff;
     poDriver->pfnIdentify = GTiffDataset::Identify;
+    poDriver->pfnInitMetadata = GTiffDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
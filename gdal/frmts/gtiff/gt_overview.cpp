@@ -110,7 +110,8 @@ toff_t GTIFFWriteDirectory(TIFF *hTIFF, int nSubfileType, int nXSize, int nYSize
     }
 
     if ( nCompressFlag == COMPRESSION_LZW ||
-         nCompressFlag == COMPRESSION_ADOBE_DEFLATE )
+         nCompressFlag == COMPRESSION_ADOBE_DEFLATE ||
+         nCompressFlag == COMPRESSION_ZSTD )
         TIFFSetField( hTIFF, TIFFTAG_PREDICTOR, nPredictor );
 
 /* -------------------------------------------------------------------- */
@@ -467,7 +468,8 @@ GTIFFBuildOverviews( const char * pszFilename,
 /* -------------------------------------------------------------------- */
     int nPredictor = PREDICTOR_NONE;
     if ( nCompression == COMPRESSION_LZW ||
-         nCompression == COMPRESSION_ADOBE_DEFLATE )
+         nCompression == COMPRESSION_ADOBE_DEFLATE ||
+         nCompression == COMPRESSION_ZSTD )
     {
         const char* pszPredictor = CPLGetConfigOption( "PREDICTOR_OVERVIEW", NULL );
         if( pszPredictor  != NULL )
@@ -292,6 +292,7 @@
 #define TIFFAppendToStrip gdal_TIFFAppendToStrip
 #define TIFFCheckDirOffset gdal_TIFFCheckDirOffset
 #define _TIFFCheckMalloc gdal__TIFFCheckMalloc
+#define _TIFFCheckStriles gdal__TIFFCheckStriles
 #define TIFFCheckpointDirectory gdal_TIFFCheckpointDirectory
 #define TIFFCheckRead gdal_TIFFCheckRead
 #define _TIFFCheckRealloc gdal__TIFFCheckRealloc
@@ -356,6 +357,7 @@
 #define TIFFFlushData1 gdal_TIFFFlushData1
 #define _TIFFfree gdal__TIFFfree
 #define TIFFFreeDirectory gdal_TIFFFreeDirectory
+#define _TIFFFreeStrilePages gdal__TIFFFreeStrilePages
 #define TIFFGetBitRevTable gdal_TIFFGetBitRevTable
 #define TIFFGetClientInfo gdal_TIFFGetClientInfo
 #define TIFFGetCloseProc gdal_TIFFGetCloseProc
@@ -370,6 +372,8 @@
 #define TIFFGetReadProc gdal_TIFFGetReadProc
 #define TIFFGetSeekProc gdal_TIFFGetSeekProc
 #define TIFFGetSizeProc gdal_TIFFGetSizeProc
+#define TIFFGetStrileByteCount gdal_TIFFGetStrileByteCount
+#define TIFFGetStrileOffset gdal_TIFFGetStrileOffset
 #define TIFFGetTagListCount gdal_TIFFGetTagListCount
 #define TIFFGetTagListEntry gdal_TIFFGetTagListEntry
 #define TIFFGetUnmapFileProc gdal_TIFFGetUnmapFileProc
@@ -746,3 +750,9 @@
 #ifdef LZMA_SUPPORT
 #define TIFFInitLZMA gdal_TIFFInitLZMA
 #endif
+#ifdef ZSTD_SUPPORT
+#define TIFFInitZSTD gdal_TIFFInitZSTD
+#endif
+#ifdef LERC_SUPPORT
+#define TIFFInitLERC gdal_TIFFInitLERC
+#endif
@@ -101,6 +101,9 @@ typedef struct {
 #if defined(DEFER_STRILE_LOAD)
         TIFFDirEntry td_stripoffset_entry;    /* for deferred loading */
         TIFFDirEntry td_stripbytecount_entry; /* for deferred loading */
+        uint32   td_strilepagecount;          /* for lazy loading */
+        uint64** td_stripoffset_pages;        /* for lazy loading */
+        uint64** td_stripbytecount_pages;     /* for lazy loading */
 #endif
 	uint16  td_nsubifd;
 	uint64* td_subifd;
@@ -258,7 +261,9 @@ extern const TIFFFieldArray* _TIFFGetExifFields(void);
 extern void _TIFFSetupFields(TIFF* tif, const TIFFFieldArray* infoarray);
 extern void _TIFFPrintFieldInfo(TIFF*, FILE*);
 
-extern int _TIFFFillStriles(TIFF*);        
+extern int _TIFFFillStriles(TIFF*);
+extern int _TIFFCheckStriles(TIFF*);
+extern void _TIFFFreeStrilePages(TIFF*);        
 
 typedef enum {
 	tfiatImage,
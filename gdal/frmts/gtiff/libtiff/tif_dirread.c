@@ -5579,6 +5579,9 @@ int _TIFFFillStriles( TIFF *tif )
         if( td->td_stripoffset_entry.tdir_count == 0 )
                 return 0;
 
+        /* The pages loaded so far are superseded by the complete arrays */
+        _TIFFFreeStrilePages(tif);
+
         if (!TIFFFetchStripThing(tif,&(td->td_stripoffset_entry),
                                  td->td_nstrips,&td->td_stripoffset))
         {
@@ -5614,6 +5617,254 @@ int _TIFFFillStriles( TIFF *tif )
 #endif 
 }
 
+#if defined(DEFER_STRILE_LOAD)
+/* Number of StripOffsets/StripByteCounts values read at once when lazy */
+/* loading is enabled */
+#define STRILE_PAGE_SIZE 1024
+
+/*
+ * Read the values of a deferred StripOffsets or StripByteCounts entry,
+ * accepted by TIFFCanFetchStripThingPage(), for the striles
+ * [first, first + count[. Values beyond the count of the entry are set to
+ * zero, as done by TIFFFetchStripThing().
+ */
+static int
+TIFFFetchStripThingPage(TIFF* tif, TIFFDirEntry* dir, uint32 first,
+                        uint32 count, uint64* data)
+{
+	static const char module[] = "TIFFFetchStripThingPage";
+	enum TIFFReadDirEntryErr err;
+	int typesize;
+	uint32 nvalues;
+	uint32 i;
+	uint64 offset;
+	uint8* buf;
+
+	typesize=TIFFDataWidth(dir->tdir_type);
+	if (!(tif->tif_flags&TIFF_BIGTIFF))
+	{
+		uint32 offset32=dir->tdir_offset.toff_long;
+		if (tif->tif_flags&TIFF_SWAB)
+			TIFFSwabLong(&offset32);
+		offset=offset32;
+	}
+	else
+	{
+		offset=dir->tdir_offset.toff_long8;
+		if (tif->tif_flags&TIFF_SWAB)
+			TIFFSwabLong8(&offset);
+	}
+
+	_TIFFmemset(data,0,count*sizeof(uint64));
+	if ((uint64)first>=dir->tdir_count)
+		return(1);
+	nvalues=count;
+	if ((uint64)first+count>dir->tdir_count)
+		nvalues=(uint32)(dir->tdir_count-first);
+
+	buf=(uint8*)_TIFFCheckMalloc(tif,nvalues,typesize,"for strip array page");
+	if (buf==0)
+		return(0);
+	err=TIFFReadDirEntryData(tif,offset+(uint64)first*typesize,
+	    (tmsize_t)nvalues*typesize,buf);
+	if (err!=TIFFReadDirEntryErrOk)
+	{
+		const TIFFField* fip = TIFFFieldWithTag(tif,dir->tdir_tag);
+		TIFFReadDirEntryOutputErr(tif,err,module,fip ? fip->field_name : "unknown tagname",0);
+		_TIFFfree(buf);
+		return(0);
+	}
+	for (i=0; i<nvalues; i++)
+	{
+		switch (typesize)
+		{
+			case 2:
+			{
+				uint16 v;
+				_TIFFmemcpy(&v,buf+i*2,2);
+				if (tif->tif_flags&TIFF_SWAB)
+					TIFFSwabShort(&v);
+				data[i]=v;
+				break;
+			}
+			case 4:
+			{
+				uint32 v;
+				_TIFFmemcpy(&v,buf+i*4,4);
+				if (tif->tif_flags&TIFF_SWAB)
+					TIFFSwabLong(&v);
+				data[i]=v;
+				break;
+			}
+			default:
+			{
+				uint64 v;
+				_TIFFmemcpy(&v,buf+i*8,8);
+				if (tif->tif_flags&TIFF_SWAB)
+					TIFFSwabLong8(&v);
+				data[i]=v;
+				break;
+			}
+		}
+	}
+	_TIFFfree(buf);
+	return(1);
+}
+
+/*
+ * Return the value of a StripOffsets or StripByteCounts entry, by loading
+ * the page containing it if the arrays are lazily loaded.
+ */
+static uint64
+TIFFGetStrileValue(TIFF* tif, uint32 strile, TIFFDirEntry* dir,
+                   uint64*** ppapages)
+{
+	TIFFDirectory *td = &tif->tif_dir;
+	uint32 page;
+
+	if (td->td_strilepagecount==0)
+	{
+		td->td_strilepagecount=
+		    (td->td_nstrips+STRILE_PAGE_SIZE-1)/STRILE_PAGE_SIZE;
+	}
+	if (*ppapages==NULL)
+	{
+		*ppapages=(uint64**)_TIFFCheckMalloc(tif,td->td_strilepagecount,
+		    sizeof(uint64*),"for strip array pages");
+		if (*ppapages==NULL)
+			return 0;
+		_TIFFmemset(*ppapages,0,td->td_strilepagecount*sizeof(uint64*));
+	}
+	page=strile/STRILE_PAGE_SIZE;
+	if ((*ppapages)[page]==NULL)
+	{
+		uint32 first=page*STRILE_PAGE_SIZE;
+		uint32 count=td->td_nstrips-first;
+		uint64* data;
+		if (count>STRILE_PAGE_SIZE)
+			count=STRILE_PAGE_SIZE;
+		data=(uint64*)_TIFFCheckMalloc(tif,count,sizeof(uint64),
+		    "for strip array page");
+		if (data==NULL)
+			return 0;
+		if (!TIFFFetchStripThingPage(tif,dir,first,count,data))
+		{
+			_TIFFfree(data);
+			return 0;
+		}
+		(*ppapages)[page]=data;
+	}
+	return (*ppapages)[page][strile-page*STRILE_PAGE_SIZE];
+}
+
+/*
+ * Whether a deferred StripOffsets or StripByteCounts entry can be read
+ * by pages.
+ */
+static int
+TIFFCanFetchStripThingPage(TIFF* tif, TIFFDirEntry* dir)
+{
+	switch (dir->tdir_type)
+	{
+		case TIFF_SHORT:
+		case TIFF_LONG:
+		case TIFF_IFD:
+		case TIFF_LONG8:
+		case TIFF_IFD8:
+			break;
+		default:
+			return 0;
+	}
+	/* Small arrays stored in the entry itself are not worth paging */
+	return dir->tdir_count*TIFFDataWidth(dir->tdir_type)>
+	    ((tif->tif_flags&TIFF_BIGTIFF) ? 8U : 4U);
+}
+
+/*
+ * Whether the entries of the current directory can be loaded by pages.
+ */
+static int
+TIFFCanLoadStrilesLazily(TIFF* tif)
+{
+	TIFFDirectory *td = &tif->tif_dir;
+
+	return (tif->tif_flags&TIFF_LAZYSTRILELOAD) &&
+	    td->td_stripoffset==NULL &&
+	    TIFFCanFetchStripThingPage(tif,&td->td_stripoffset_entry) &&
+	    TIFFCanFetchStripThingPage(tif,&td->td_stripbytecount_entry);
+}
+
+void _TIFFFreeStrilePages( TIFF *tif )
+{
+	TIFFDirectory *td = &tif->tif_dir;
+	uint32 page;
+
+	for (page=0; page<td->td_strilepagecount; page++)
+	{
+		if (td->td_stripoffset_pages)
+			_TIFFfree(td->td_stripoffset_pages[page]);
+		if (td->td_stripbytecount_pages)
+			_TIFFfree(td->td_stripbytecount_pages[page]);
+	}
+	_TIFFfree(td->td_stripoffset_pages);
+	_TIFFfree(td->td_stripbytecount_pages);
+	td->td_stripoffset_pages=NULL;
+	td->td_stripbytecount_pages=NULL;
+	td->td_strilepagecount=0;
+}
+#endif /* defined(DEFER_STRILE_LOAD) */
+
+/*
+ * Make sure that the strip/tile offsets and bytecounts of the current
+ * directory can be fetched with TIFFGetStrileOffset() and
+ * TIFFGetStrileByteCount(), without loading the complete arrays when
+ * they can be lazily loaded.
+ */
+int _TIFFCheckStriles( TIFF *tif )
+{
+#if defined(DEFER_STRILE_LOAD)
+	if (TIFFCanLoadStrilesLazily(tif))
+		return 1;
+#endif
+	return _TIFFFillStriles(tif) && tif->tif_dir.td_stripbytecount!=NULL;
+}
+
+/*
+ * Return the offset of a strip or tile, or 0 if it is not available.
+ */
+uint64 TIFFGetStrileOffset(TIFF *tif, uint32 strile)
+{
+	TIFFDirectory *td = &tif->tif_dir;
+	if (strile>=td->td_nstrips)
+		return 0;
+#if defined(DEFER_STRILE_LOAD)
+	if (TIFFCanLoadStrilesLazily(tif))
+		return TIFFGetStrileValue(tif,strile,&td->td_stripoffset_entry,
+		    &td->td_stripoffset_pages);
+#endif
+	if (!_TIFFFillStriles(tif) || td->td_stripoffset==NULL)
+		return 0;
+	return td->td_stripoffset[strile];
+}
+
+/*
+ * Return the size in bytes of a strip or tile, or 0 if it is not available.
+ */
+uint64 TIFFGetStrileByteCount(TIFF *tif, uint32 strile)
+{
+	TIFFDirectory *td = &tif->tif_dir;
+	if (strile>=td->td_nstrips)
+		return 0;
+#if defined(DEFER_STRILE_LOAD)
+	if (TIFFCanLoadStrilesLazily(tif))
+		return TIFFGetStrileValue(tif,strile,&td->td_stripbytecount_entry,
+		    &td->td_stripbytecount_pages);
+#endif
+	if (!_TIFFFillStriles(tif) || td->td_stripbytecount==NULL)
+		return 0;
+	return td->td_stripbytecount[strile];
+}
+
 
 /* vim: set ts=8 sts=8 sw=8 noet: */
 /*
@@ -0,0 +1,885 @@
+/* $Id$ */
+
+/*
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that (i) the above copyright notices and this permission notice appear in
+ * all copies of the software and related documentation, and (ii) the names of
+ * Sam Leffler and Silicon Graphics may not be used in any advertising or
+ * publicity relating to the software without the specific, prior written
+ * permission of Sam Leffler and Silicon Graphics.
+ *
+ * THE SOFTWARE IS PROVIDED "AS-IS" AND WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS, IMPLIED OR OTHERWISE, INCLUDING WITHOUT LIMITATION, ANY
+ * WARRANTY OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * IN NO EVENT SHALL SAM LEFFLER OR SILICON GRAPHICS BE LIABLE FOR
+ * ANY SPECIAL, INCIDENTAL, INDIRECT OR CONSEQUENTIAL DAMAGES OF ANY KIND,
+ * OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER OR NOT ADVISED OF THE POSSIBILITY OF DAMAGE, AND ON ANY THEORY OF
+ * LIABILITY, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include "tiffiop.h"
+#ifdef LERC_SUPPORT
+/*
+ * TIFF Library.
+ *
+ * LERC Compression Support
+ *
+ * Uses the Lerc2 library, through its C interface (Lerc_c_api.h). See
+ * https://github.com/Esri/lerc for details.
+ *
+ * A strip or tile is encoded as a single Lerc2 blob, which is optionally
+ * further compressed with Deflate or ZSTD, as recorded in the
+ * LercParameters tag. Lerc2 only handles one sample per pixel, so
+ * PlanarConfiguration=Contig requires SamplesPerPixel=1.
+ *
+ * For floating point data, NaN values are stored as invalid pixels in the
+ * Lerc2 mask and restored as NaN on decoding.
+ */
+
+#include "Lerc_c_api.h"
+#ifdef ZIP_SUPPORT
+#include "zlib.h"
+#endif
+#ifdef ZSTD_SUPPORT
+#include "zstd.h"
+#endif
+
+#include <stdio.h>
+
+/*
+ * State block for each open TIFF file using LERC compression/decompression.
+ */
+typedef struct {
+	double          maxzerror;		/* max z error */
+	int             lerc_version;
+	int             additional_compression;
+	int             zstd_compress_level;	/* zstd */
+	int             zipquality;		/* deflate */
+	int             state;			/* state flags */
+#define LSTATE_INIT_DECODE 0x01
+#define LSTATE_INIT_ENCODE 0x02
+
+	uint32          segment_width;
+	uint32          segment_height;
+
+	unsigned int    uncompressed_size;
+	unsigned int    uncompressed_alloc;
+	uint8          *uncompressed_buffer;
+	unsigned int    uncompressed_offset;
+
+	unsigned int    mask_size;
+	uint8          *mask_buffer;
+
+	unsigned int    compressed_size;
+	uint8          *compressed_buffer;
+
+	TIFFVGetMethod  vgetparent;            /* super-class method */
+	TIFFVSetMethod  vsetparent;            /* super-class method */
+} LERCState;
+
+#define LState(tif)             ((LERCState*) (tif)->tif_data)
+#define DecoderState(tif)       LState(tif)
+#define EncoderState(tif)       LState(tif)
+
+static int LERCEncode(TIFF* tif, uint8* bp, tmsize_t cc, uint16 s);
+static int LERCDecode(TIFF* tif, uint8* op, tmsize_t occ, uint16 s);
+
+static int
+LERCFixupTags(TIFF* tif)
+{
+	(void) tif;
+	return 1;
+}
+
+static int
+LERCSetupDecode(TIFF* tif)
+{
+	LERCState* sp = DecoderState(tif);
+
+	assert(sp != NULL);
+
+	/* if we were last encoding, terminate this mode */
+	if (sp->state & LSTATE_INIT_ENCODE) {
+		sp->state = 0;
+	}
+
+	/* Lerc2 returns values in native byte order */
+	tif->tif_postdecode = _TIFFNoPostDecode;
+
+	sp->state |= LSTATE_INIT_DECODE;
+	return 1;
+}
+
+static int
+GetLercDataType(TIFF* tif)
+{
+	static const char module[] = "GetLercDataType";
+	TIFFDirectory *td = &tif->tif_dir;
+
+	if( td->td_sampleformat == SAMPLEFORMAT_INT ) {
+		switch( td->td_bitspersample ) {
+		case 8:  return LERC_DT_CHAR;
+		case 16: return LERC_DT_SHORT;
+		case 32: return LERC_DT_INT;
+		default: break;
+		}
+	}
+	else if( td->td_sampleformat == SAMPLEFORMAT_UINT ||
+		 td->td_sampleformat == SAMPLEFORMAT_VOID ) {
+		switch( td->td_bitspersample ) {
+		case 8:  return LERC_DT_BYTE;
+		case 16: return LERC_DT_USHORT;
+		case 32: return LERC_DT_UINT;
+		default: break;
+		}
+	}
+	else if( td->td_sampleformat == SAMPLEFORMAT_IEEEFP ) {
+		switch( td->td_bitspersample ) {
+		case 32: return LERC_DT_FLOAT;
+		case 64: return LERC_DT_DOUBLE;
+		default: break;
+		}
+	}
+
+	TIFFErrorExt(tif->tif_clientdata, module,
+		     "Unsupported combination of SampleFormat and BitsPerSample");
+	return -1;
+}
+
+/*
+ * Compute the dimensions of the current strip or tile and make sure the
+ * uncompressed and mask buffers are large enough for it.
+ */
+static int
+SetupUncompressedBuffer(TIFF* tif, LERCState* sp, const char* module)
+{
+	TIFFDirectory *td = &tif->tif_dir;
+	uint64 new_size_64;
+	uint64 new_alloc_64;
+	unsigned int new_size;
+	unsigned int new_alloc;
+
+	sp->uncompressed_offset = 0;
+
+	if( td->td_planarconfig == PLANARCONFIG_CONTIG &&
+	    td->td_samplesperpixel > 1 ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "LERC compression is only supported with "
+			     "PlanarConfiguration=Separate or SamplesPerPixel=1");
+		return 0;
+	}
+
+	if( isTiled(tif) ) {
+		sp->segment_width = td->td_tilewidth;
+		sp->segment_height = td->td_tilelength;
+	}
+	else {
+		sp->segment_width = td->td_imagewidth;
+		sp->segment_height = td->td_imagelength - tif->tif_row;
+		if( sp->segment_height > td->td_rowsperstrip )
+			sp->segment_height = td->td_rowsperstrip;
+	}
+
+	new_size_64 = (uint64)sp->segment_width * sp->segment_height *
+		      (td->td_bitspersample / 8);
+	/* Room for the Lerc2 blob after the additional decompression */
+	new_alloc_64 = 2 * new_size_64 + 1024;
+	if( new_size_64 == 0 || new_alloc_64 > 0x7FFFFFFFU ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "Too large uncompressed strip/tile");
+		return 0;
+	}
+	new_size = (unsigned int)new_size_64;
+	new_alloc = (unsigned int)new_alloc_64;
+	sp->uncompressed_size = new_size;
+
+	if( sp->uncompressed_alloc < new_size ) {
+		_TIFFfree(sp->uncompressed_buffer);
+		sp->uncompressed_buffer = (uint8*)_TIFFmalloc(new_size);
+		if( !sp->uncompressed_buffer ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Cannot allocate buffer");
+			sp->uncompressed_alloc = 0;
+			return 0;
+		}
+		sp->uncompressed_alloc = new_size;
+	}
+
+	if( td->td_sampleformat == SAMPLEFORMAT_IEEEFP &&
+	    sp->mask_size < sp->segment_width * sp->segment_height ) {
+		_TIFFfree(sp->mask_buffer);
+		sp->mask_size = 0;
+		sp->mask_buffer = (uint8*)_TIFFmalloc(
+				sp->segment_width * sp->segment_height);
+		if( !sp->mask_buffer ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Cannot allocate buffer");
+			return 0;
+		}
+		sp->mask_size = sp->segment_width * sp->segment_height;
+	}
+
+	if( sp->compressed_size < new_alloc ) {
+		_TIFFfree(sp->compressed_buffer);
+		sp->compressed_size = 0;
+		sp->compressed_buffer = (uint8*)_TIFFmalloc(new_alloc);
+		if( !sp->compressed_buffer ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Cannot allocate buffer");
+			return 0;
+		}
+		sp->compressed_size = new_alloc;
+	}
+
+	return 1;
+}
+
+static float
+LERCFloatNaN(void)
+{
+	const uint32 bits = 0x7FC00000U;
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+static double
+LERCDoubleNaN(void)
+{
+	const uint64 bits = ((uint64)0x7FF80000U) << 32;
+	double d;
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+/*
+ * Decode a whole strip or tile into the uncompressed buffer.
+ */
+static int
+LERCPreDecode(TIFF* tif, uint16 s)
+{
+	static const char module[] = "LERCPreDecode";
+	LERCState* sp = DecoderState(tif);
+	const uint8* lerc_data;
+	unsigned int lerc_data_size;
+	int lerc_data_type;
+	int use_mask;
+	lerc_status lerc_ret;
+
+	(void) s;
+	assert(sp != NULL);
+
+	if( (sp->state & LSTATE_INIT_DECODE) == 0 )
+		tif->tif_setupdecode(tif);
+
+	lerc_data_type = GetLercDataType(tif);
+	if( lerc_data_type < 0 )
+		return 0;
+
+	if( !SetupUncompressedBuffer(tif, sp, module) )
+		return 0;
+
+	if( (uint64)tif->tif_rawcc > 0x7FFFFFFFU ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "Too large compressed strip/tile");
+		return 0;
+	}
+
+	lerc_data = tif->tif_rawcp;
+	lerc_data_size = (unsigned int)tif->tif_rawcc;
+
+	if( sp->additional_compression == LERC_ADD_COMPRESSION_DEFLATE ) {
+#ifdef ZIP_SUPPORT
+		uLongf dest_len = sp->compressed_size;
+		int zlib_ret = uncompress(sp->compressed_buffer, &dest_len,
+					  tif->tif_rawcp, (uLong)tif->tif_rawcc);
+		if( zlib_ret != Z_OK ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Decoding error at scanline %lu: %s",
+				     (unsigned long) tif->tif_row,
+				     zlib_ret == Z_BUF_ERROR ?
+					"output buffer too small or truncated input" :
+					"zlib error");
+			return 0;
+		}
+		lerc_data = sp->compressed_buffer;
+		lerc_data_size = (unsigned int)dest_len;
+#else
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "LERC_ADD_COMPRESSION_DEFLATE requested, but "
+			     "ZIP_SUPPORT not available");
+		return 0;
+#endif
+	}
+	else if( sp->additional_compression == LERC_ADD_COMPRESSION_ZSTD ) {
+#ifdef ZSTD_SUPPORT
+		size_t zstd_ret = ZSTD_decompress(sp->compressed_buffer,
+						  sp->compressed_size,
+						  tif->tif_rawcp,
+						  (size_t)tif->tif_rawcc);
+		if( ZSTD_isError(zstd_ret) ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Error in ZSTD_decompress(): %s",
+				     ZSTD_getErrorName(zstd_ret));
+			return 0;
+		}
+		lerc_data = sp->compressed_buffer;
+		lerc_data_size = (unsigned int)zstd_ret;
+#else
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "LERC_ADD_COMPRESSION_ZSTD requested, but "
+			     "ZSTD_SUPPORT not available");
+		return 0;
+#endif
+	}
+	else if( sp->additional_compression != LERC_ADD_COMPRESSION_NONE ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "Unhandled additional compression");
+		return 0;
+	}
+
+	use_mask = (lerc_data_type == LERC_DT_FLOAT ||
+		    lerc_data_type == LERC_DT_DOUBLE);
+	lerc_ret = lerc_decode(lerc_data, lerc_data_size,
+			       use_mask ? sp->mask_buffer : NULL,
+			       (int)sp->segment_width, (int)sp->segment_height,
+			       (unsigned int)lerc_data_type,
+			       sp->uncompressed_buffer);
+	if( lerc_ret != LERC_OK ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "lerc_decode() failed");
+		return 0;
+	}
+
+	if( use_mask ) {
+		const unsigned int npixels =
+			sp->segment_width * sp->segment_height;
+		unsigned int i;
+		if( lerc_data_type == LERC_DT_FLOAT ) {
+			const float nan_value = LERCFloatNaN();
+			float* ptr = (float*)sp->uncompressed_buffer;
+			for( i = 0; i < npixels; i++ )
+				if( !sp->mask_buffer[i] )
+					ptr[i] = nan_value;
+		}
+		else {
+			const double nan_value = LERCDoubleNaN();
+			double* ptr = (double*)sp->uncompressed_buffer;
+			for( i = 0; i < npixels; i++ )
+				if( !sp->mask_buffer[i] )
+					ptr[i] = nan_value;
+		}
+	}
+
+	return 1;
+}
+
+static int
+LERCDecode(TIFF* tif, uint8* op, tmsize_t occ, uint16 s)
+{
+	static const char module[] = "LERCDecode";
+	LERCState* sp = DecoderState(tif);
+
+	(void) s;
+	assert(sp != NULL);
+	assert(sp->state == LSTATE_INIT_DECODE);
+
+	if( (uint64)sp->uncompressed_offset + (uint64)occ >
+	    sp->uncompressed_size ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "Too many bytes read");
+		return 0;
+	}
+
+	memcpy(op, sp->uncompressed_buffer + sp->uncompressed_offset, occ);
+	sp->uncompressed_offset += (unsigned int)occ;
+
+	return 1;
+}
+
+static int
+LERCSetupEncode(TIFF* tif)
+{
+	LERCState* sp = EncoderState(tif);
+
+	assert(sp != NULL);
+	if (sp->state & LSTATE_INIT_DECODE) {
+		sp->state = 0;
+	}
+
+	/* Lerc2 takes values in native byte order */
+	tif->tif_postdecode = _TIFFNoPostDecode;
+
+	sp->state |= LSTATE_INIT_ENCODE;
+	return 1;
+}
+
+/*
+ * Reset encoding state at the start of a strip.
+ */
+static int
+LERCPreEncode(TIFF* tif, uint16 s)
+{
+	static const char module[] = "LERCPreEncode";
+	LERCState *sp = EncoderState(tif);
+
+	(void) s;
+	assert(sp != NULL);
+	if( sp->state != LSTATE_INIT_ENCODE )
+		tif->tif_setupencode(tif);
+
+	if( GetLercDataType(tif) < 0 )
+		return 0;
+
+	return SetupUncompressedBuffer(tif, sp, module);
+}
+
+/*
+ * Accumulate a chunk of pixels into the uncompressed buffer.
+ */
+static int
+LERCEncode(TIFF* tif, uint8* bp, tmsize_t cc, uint16 s)
+{
+	static const char module[] = "LERCEncode";
+	LERCState *sp = EncoderState(tif);
+
+	(void)s;
+	assert(sp != NULL);
+	assert(sp->state == LSTATE_INIT_ENCODE);
+
+	if( (uint64)sp->uncompressed_offset + (uint64)cc >
+	    sp->uncompressed_size ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "Too many bytes written");
+		return 0;
+	}
+
+	memcpy(sp->uncompressed_buffer + sp->uncompressed_offset, bp, cc);
+	sp->uncompressed_offset += (unsigned int)cc;
+
+	return 1;
+}
+
+/*
+ * Copy encoded bytes to the strip/tile, flushing as needed.
+ */
+static int
+LERCWriteOutput(TIFF* tif, const uint8* data, tmsize_t size)
+{
+	while( size > 0 ) {
+		tmsize_t n = size;
+		if( n > tif->tif_rawdatasize )
+			n = tif->tif_rawdatasize;
+		_TIFFmemcpy(tif->tif_rawdata, data, n);
+		tif->tif_rawcc = n;
+		if( !TIFFFlushData1(tif) )
+			return 0;
+		data += n;
+		size -= n;
+	}
+	return 1;
+}
+
+/*
+ * Encode the accumulated strip/tile and write it.
+ */
+static int
+LERCPostEncode(TIFF* tif)
+{
+	static const char module[] = "LERCPostEncode";
+	LERCState *sp = EncoderState(tif);
+	int lerc_data_type;
+	const uint8* mask = NULL;
+	unsigned int numBytes = 0;
+	unsigned int numBytesWritten = 0;
+	lerc_status lerc_ret;
+	uint8* lerc_buffer;
+
+	if( sp->uncompressed_offset != sp->uncompressed_size ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "Unexpected number of bytes in the buffer");
+		return 0;
+	}
+
+	lerc_data_type = GetLercDataType(tif);
+	if( lerc_data_type < 0 )
+		return 0;
+
+	/* Mark NaN values as invalid pixels */
+	if( lerc_data_type == LERC_DT_FLOAT ||
+	    lerc_data_type == LERC_DT_DOUBLE ) {
+		const unsigned int npixels =
+			sp->segment_width * sp->segment_height;
+		unsigned int i;
+		int has_nan = 0;
+		if( lerc_data_type == LERC_DT_FLOAT ) {
+			const float* ptr = (const float*)sp->uncompressed_buffer;
+			for( i = 0; i < npixels; i++ ) {
+				sp->mask_buffer[i] = ptr[i] == ptr[i];
+				has_nan |= !sp->mask_buffer[i];
+			}
+		}
+		else {
+			const double* ptr = (const double*)sp->uncompressed_buffer;
+			for( i = 0; i < npixels; i++ ) {
+				sp->mask_buffer[i] = ptr[i] == ptr[i];
+				has_nan |= !sp->mask_buffer[i];
+			}
+		}
+		if( has_nan )
+			mask = sp->mask_buffer;
+	}
+
+	lerc_ret = lerc_computeCompressedSize(sp->uncompressed_buffer,
+					      (unsigned int)lerc_data_type,
+					      (int)sp->segment_width,
+					      (int)sp->segment_height,
+					      mask, sp->maxzerror, &numBytes);
+	if( lerc_ret != LERC_OK ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "lerc_computeCompressedSize() failed");
+		return 0;
+	}
+
+	/* With additional compression, keep the compressed buffer for the
+	 * second pass */
+	if( sp->additional_compression != LERC_ADD_COMPRESSION_NONE ) {
+		lerc_buffer = (uint8*)_TIFFmalloc(numBytes);
+		if( lerc_buffer == NULL ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Cannot allocate buffer");
+			return 0;
+		}
+	}
+	else {
+		if( numBytes > sp->compressed_size ) {
+			_TIFFfree(sp->compressed_buffer);
+			sp->compressed_size = 0;
+			sp->compressed_buffer = (uint8*)_TIFFmalloc(numBytes);
+			if( !sp->compressed_buffer ) {
+				TIFFErrorExt(tif->tif_clientdata, module,
+					     "Cannot allocate buffer");
+				return 0;
+			}
+			sp->compressed_size = numBytes;
+		}
+		lerc_buffer = sp->compressed_buffer;
+	}
+
+	lerc_ret = lerc_encode(sp->uncompressed_buffer,
+			       (unsigned int)lerc_data_type,
+			       (int)sp->segment_width, (int)sp->segment_height,
+			       mask, sp->maxzerror,
+			       lerc_buffer, numBytes, &numBytesWritten);
+	if( lerc_ret != LERC_OK ) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "lerc_encode() failed");
+		if( lerc_buffer != sp->compressed_buffer )
+			_TIFFfree(lerc_buffer);
+		return 0;
+	}
+	assert( numBytesWritten == numBytes );
+
+	if( sp->additional_compression == LERC_ADD_COMPRESSION_DEFLATE ) {
+#ifdef ZIP_SUPPORT
+		uLongf dest_len = compressBound(numBytesWritten);
+		int zlib_ret;
+		int ret;
+		if( dest_len > sp->compressed_size ) {
+			_TIFFfree(sp->compressed_buffer);
+			sp->compressed_size = 0;
+			sp->compressed_buffer = (uint8*)_TIFFmalloc(dest_len);
+			if( !sp->compressed_buffer ) {
+				TIFFErrorExt(tif->tif_clientdata, module,
+					     "Cannot allocate buffer");
+				_TIFFfree(lerc_buffer);
+				return 0;
+			}
+			sp->compressed_size = (unsigned int)dest_len;
+		}
+		zlib_ret = compress2(sp->compressed_buffer, &dest_len,
+				     lerc_buffer, numBytesWritten,
+				     sp->zipquality);
+		_TIFFfree(lerc_buffer);
+		if( zlib_ret != Z_OK ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Encoder error: zlib error %d", zlib_ret);
+			return 0;
+		}
+		ret = LERCWriteOutput(tif, sp->compressed_buffer,
+				      (tmsize_t)dest_len);
+		return ret;
+#else
+		_TIFFfree(lerc_buffer);
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "LERC_ADD_COMPRESSION_DEFLATE requested, but "
+			     "ZIP_SUPPORT not available");
+		return 0;
+#endif
+	}
+	else if( sp->additional_compression == LERC_ADD_COMPRESSION_ZSTD ) {
+#ifdef ZSTD_SUPPORT
+		size_t dest_len = ZSTD_compressBound(numBytesWritten);
+		size_t zstd_ret;
+		if( dest_len > sp->compressed_size ) {
+			_TIFFfree(sp->compressed_buffer);
+			sp->compressed_size = 0;
+			sp->compressed_buffer = (uint8*)_TIFFmalloc(dest_len);
+			if( !sp->compressed_buffer ) {
+				TIFFErrorExt(tif->tif_clientdata, module,
+					     "Cannot allocate buffer");
+				_TIFFfree(lerc_buffer);
+				return 0;
+			}
+			sp->compressed_size = (unsigned int)dest_len;
+		}
+		zstd_ret = ZSTD_compress(sp->compressed_buffer, dest_len,
+					 lerc_buffer, numBytesWritten,
+					 sp->zstd_compress_level);
+		_TIFFfree(lerc_buffer);
+		if( ZSTD_isError(zstd_ret) ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Error in ZSTD_compress(): %s",
+				     ZSTD_getErrorName(zstd_ret));
+			return 0;
+		}
+		return LERCWriteOutput(tif, sp->compressed_buffer,
+				       (tmsize_t)zstd_ret);
+#else
+		_TIFFfree(lerc_buffer);
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "LERC_ADD_COMPRESSION_ZSTD requested, but "
+			     "ZSTD_SUPPORT not available");
+		return 0;
+#endif
+	}
+	else if( sp->additional_compression != LERC_ADD_COMPRESSION_NONE ) {
+		_TIFFfree(lerc_buffer);
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "Unhandled additional compression");
+		return 0;
+	}
+
+	return LERCWriteOutput(tif, lerc_buffer, (tmsize_t)numBytesWritten);
+}
+
+static void
+LERCCleanup(TIFF* tif)
+{
+	LERCState* sp = LState(tif);
+
+	assert(sp != 0);
+
+	tif->tif_tagmethods.vgetfield = sp->vgetparent;
+	tif->tif_tagmethods.vsetfield = sp->vsetparent;
+
+	_TIFFfree(sp->uncompressed_buffer);
+	_TIFFfree(sp->compressed_buffer);
+	_TIFFfree(sp->mask_buffer);
+
+	_TIFFfree(sp);
+	tif->tif_data = NULL;
+
+	_TIFFSetDefaultCompressionState(tif);
+}
+
+static const TIFFField LERCFields[] = {
+	{ TIFFTAG_LERC_PARAMETERS, TIFF_VARIABLE2, TIFF_VARIABLE2,
+	  TIFF_LONG, 0, TIFF_SETGET_C32_UINT32, TIFF_SETGET_UNDEFINED,
+	  FIELD_CUSTOM, FALSE, TRUE, "LercParameters", NULL },
+	{ TIFFTAG_LERC_MAXZERROR, 0, 0, TIFF_ANY, 0, TIFF_SETGET_DOUBLE,
+	  TIFF_SETGET_UNDEFINED,
+	  FIELD_PSEUDO, TRUE, FALSE, "LercMaximumError", NULL },
+	{ TIFFTAG_LERC_VERSION, 0, 0, TIFF_ANY, 0, TIFF_SETGET_UINT32,
+	  TIFF_SETGET_UNDEFINED,
+	  FIELD_PSEUDO, FALSE, FALSE, "LercVersion", NULL },
+	{ TIFFTAG_LERC_ADD_COMPRESSION, 0, 0, TIFF_ANY, 0,
+	  TIFF_SETGET_UINT32, TIFF_SETGET_UNDEFINED,
+	  FIELD_PSEUDO, FALSE, FALSE, "LercAdditionalCompression", NULL },
+	{ TIFFTAG_ZSTD_LEVEL, 0, 0, TIFF_ANY, 0, TIFF_SETGET_INT,
+	  TIFF_SETGET_UNDEFINED,
+	  FIELD_PSEUDO, TRUE, FALSE, "ZSTD compression_level", NULL },
+	{ TIFFTAG_ZIPQUALITY, 0, 0, TIFF_ANY, 0, TIFF_SETGET_INT,
+	  TIFF_SETGET_UNDEFINED,
+	  FIELD_PSEUDO, TRUE, FALSE, "", NULL },
+};
+
+/*
+ * Forward a tag to the parent method, with arguments built here rather than
+ * taken from a va_list.
+ */
+static int
+LERCVSetFieldBase(TIFF* tif, uint32 tag, ...)
+{
+	LERCState* sp = LState(tif);
+	int ret;
+	va_list ap;
+	va_start(ap, tag);
+	ret = (*sp->vsetparent)(tif, tag, ap);
+	va_end(ap);
+	return ret;
+}
+
+static int
+LERCVSetField(TIFF* tif, uint32 tag, va_list ap)
+{
+	static const char module[] = "LERCVSetField";
+	LERCState* sp = LState(tif);
+	uint32 params[2];
+
+	switch (tag) {
+	case TIFFTAG_LERC_PARAMETERS:
+	{
+		uint32 count = (uint32) va_arg(ap, int);
+		uint32* in_params = va_arg(ap, uint32*);
+		if( count < 2 ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Invalid count for LercParameters: %u",
+				     count);
+			return 0;
+		}
+		sp->lerc_version = (int)in_params[0];
+		sp->additional_compression = (int)in_params[1];
+		return LERCVSetFieldBase(tif, TIFFTAG_LERC_PARAMETERS,
+					 count, in_params);
+	}
+	case TIFFTAG_LERC_MAXZERROR:
+		sp->maxzerror = va_arg(ap, double);
+		return 1;
+	case TIFFTAG_LERC_VERSION:
+	{
+		int version = va_arg(ap, int);
+		if( version != LERC_VERSION_2_4 ) {
+			TIFFErrorExt(tif->tif_clientdata, module,
+				     "Invalid value for LercVersion: %d",
+				     version);
+			return 0;
+		}
+		sp->lerc_version = version;
+		params[0] = (uint32)sp->lerc_version;
+		params[1] = (uint32)sp->additional_compression;
+		return LERCVSetFieldBase(tif, TIFFTAG_LERC_PARAMETERS,
+					 2, params);
+	}
+	case TIFFTAG_LERC_ADD_COMPRESSION:
+		sp->additional_compression = va_arg(ap, int);
+		params[0] = (uint32)sp->lerc_version;
+		params[1] = (uint32)sp->additional_compression;
+		return LERCVSetFieldBase(tif, TIFFTAG_LERC_PARAMETERS,
+					 2, params);
+	case TIFFTAG_ZSTD_LEVEL:
+		sp->zstd_compress_level = va_arg(ap, int);
+		return 1;
+	case TIFFTAG_ZIPQUALITY:
+		sp->zipquality = va_arg(ap, int);
+		return 1;
+	default:
+		return (*sp->vsetparent)(tif, tag, ap);
+	}
+	/*NOTREACHED*/
+}
+
+static int
+LERCVGetField(TIFF* tif, uint32 tag, va_list ap)
+{
+	LERCState* sp = LState(tif);
+
+	switch (tag) {
+	case TIFFTAG_LERC_MAXZERROR:
+		*va_arg(ap, double*) = sp->maxzerror;
+		break;
+	case TIFFTAG_LERC_VERSION:
+		*va_arg(ap, int*) = sp->lerc_version;
+		break;
+	case TIFFTAG_LERC_ADD_COMPRESSION:
+		*va_arg(ap, int*) = sp->additional_compression;
+		break;
+	case TIFFTAG_ZSTD_LEVEL:
+		*va_arg(ap, int*) = sp->zstd_compress_level;
+		break;
+	case TIFFTAG_ZIPQUALITY:
+		*va_arg(ap, int*) = sp->zipquality;
+		break;
+	default:
+		return (*sp->vgetparent)(tif, tag, ap);
+	}
+	return 1;
+}
+
+int
+TIFFInitLERC(TIFF* tif, int scheme)
+{
+	static const char module[] = "TIFFInitLERC";
+	LERCState* sp;
+	uint32 params[2];
+
+	assert( scheme == COMPRESSION_LERC );
+
+	/*
+	 * Merge codec-specific tag information.
+	 */
+	if (!_TIFFMergeFields(tif, LERCFields, TIFFArrayCount(LERCFields))) {
+		TIFFErrorExt(tif->tif_clientdata, module,
+			     "Merging LERC codec-specific tags failed");
+		return 0;
+	}
+
+	/*
+	 * Allocate state block so tag methods have storage to record values.
+	 */
+	tif->tif_data = (uint8*) _TIFFmalloc(sizeof(LERCState));
+	if (tif->tif_data == NULL)
+		goto bad;
+	sp = LState(tif);
+	_TIFFmemset(sp, 0, sizeof(LERCState));
+
+	/*
+	 * Override parent get/set field methods.
+	 */
+	sp->vgetparent = tif->tif_tagmethods.vgetfield;
+	tif->tif_tagmethods.vgetfield = LERCVGetField;	/* hook for codec tags */
+	sp->vsetparent = tif->tif_tagmethods.vsetfield;
+	tif->tif_tagmethods.vsetfield = LERCVSetField;	/* hook for codec tags */
+
+	/*
+	 * Install codec methods.
+	 */
+	tif->tif_fixuptags = LERCFixupTags;
+	tif->tif_setupdecode = LERCSetupDecode;
+	tif->tif_predecode = LERCPreDecode;
+	tif->tif_decoderow = LERCDecode;
+	tif->tif_decodestrip = LERCDecode;
+	tif->tif_decodetile = LERCDecode;
+	tif->tif_setupencode = LERCSetupEncode;
+	tif->tif_preencode = LERCPreEncode;
+	tif->tif_postencode = LERCPostEncode;
+	tif->tif_encoderow = LERCEncode;
+	tif->tif_encodestrip = LERCEncode;
+	tif->tif_encodetile = LERCEncode;
+	tif->tif_cleanup = LERCCleanup;
+
+	/* Default values for codec-specific fields */
+	sp->lerc_version = LERC_VERSION_2_4;
+	sp->additional_compression = LERC_ADD_COMPRESSION_NONE;
+	params[0] = (uint32)sp->lerc_version;
+	params[1] = (uint32)sp->additional_compression;
+	if( !LERCVSetFieldBase(tif, TIFFTAG_LERC_PARAMETERS, 2, params) )
+		return 0;
+	sp->maxzerror = 0.0;
+	sp->zstd_compress_level = 9;		/* default comp. level */
+	sp->zipquality = -1;			/* Z_DEFAULT_COMPRESSION */
+	sp->state = 0;
+
+	return 1;
+bad:
+	TIFFErrorExt(tif->tif_clientdata, module,
+		     "No space for LERC state block");
+	return 0;
+}
+#endif /* LERC_SUPPORT */
+
+/* vim: set ts=8 sts=8 sw=8 noet: */
@@ -181,6 +181,7 @@ TIFFClientOpen(
 	 * 'C' enable strip chopping support when reading
 	 * 'c' disable strip chopping support
 	 * 'h' read TIFF header only, do not load the first IFD
+	 * 'O' load strip/tile offsets and bytecounts on demand when reading
 	 * '4' ClassicTIFF for creating a file (default)
 	 * '8' BigTIFF for creating a file
 	 *
@@ -214,6 +215,13 @@ TIFFClientOpen(
 	 * application-transparent and as such can cause problems.  The 'c'
 	 * option permits applications that only want to look at the tags,
 	 * for example, to get the unadulterated TIFF tag information.
+	 *
+	 * The 'O' flag avoids reading the complete StripOffsets/TileOffsets
+	 * and StripByteCounts/TileByteCounts arrays, which can be huge,
+	 * when only a few strips or tiles are accessed. Their values are
+	 * then read by pages when requested through TIFFGetStrileOffset()
+	 * and TIFFGetStrileByteCount(). Getting the arrays with TIFFGetField()
+	 * still loads them completely.
 	 */
 	for (cp = mode; *cp; cp++)
 		switch (*cp) {
@@ -260,6 +268,10 @@ TIFFClientOpen(
 			case 'h':
 				tif->tif_flags |= TIFF_HEADERONLY;
 				break;
+			case 'O':
+				if (m == O_RDONLY)
+					tif->tif_flags |= TIFF_LAZYSTRILELOAD;
+				break;
 			case '8':
 				if (m&O_CREAT)
 					tif->tif_flags |= TIFF_BIGTIFF;
@@ -64,12 +64,45 @@ typedef struct
     vsi_l_offset nExpectedPos;
     GByte      *abyWriteBuffer;
     int         nWriteBufferSize;
+
+    // Ranges of the file already fetched by the caller, sorted by offset.
+    int           nCachedRanges;
+    void        **ppCachedData;
+    vsi_l_offset *panCachedOffsets;
+    size_t       *panCachedSizes;
 } GDALTiffHandle;
 
 static tsize_t
 _tiffReadProc(thandle_t th, tdata_t buf, tsize_t size)
 {
     GDALTiffHandle* psGTH = (GDALTiffHandle*) th;
+
+    if( psGTH->nCachedRanges > 0 && size > 0 )
+    {
+        // Find the last range starting at or before the current position
+        const vsi_l_offset nCurOffset = VSIFTellL( psGTH->fpL );
+        int nLow = 0;
+        int nHigh = psGTH->nCachedRanges - 1;
+        while( nLow < nHigh )
+        {
+            const int nMid = (nLow + nHigh + 1) / 2;
+            if( psGTH->panCachedOffsets[nMid] <= nCurOffset )
+                nLow = nMid;
+            else
+                nHigh = nMid - 1;
+        }
+        const vsi_l_offset nRangeOffset = psGTH->panCachedOffsets[nLow];
+        if( nCurOffset >= nRangeOffset &&
+            nCurOffset + size <= nRangeOffset + psGTH->panCachedSizes[nLow] )
+        {
+            memcpy( buf, static_cast<GByte*>(psGTH->ppCachedData[nLow]) +
+                            (nCurOffset - nRangeOffset), size );
+            if( VSIFSeekL( psGTH->fpL, nCurOffset + size, SEEK_SET ) != 0 )
+                return 0;
+            return size;
+        }
+    }
+
     return VSIFReadL( buf, 1, size, psGTH->fpL );
 }
 
@@ -184,6 +217,9 @@ _tiffCloseProc(thandle_t th)
     GDALTiffHandle* psGTH = (GDALTiffHandle*) th;
     GTHFlushBuffer(th);
     CPLFree(psGTH->abyWriteBuffer);
+    CPLFree(psGTH->ppCachedData);
+    CPLFree(psGTH->panCachedOffsets);
+    CPLFree(psGTH->panCachedSizes);
     CPLFree(psGTH);
     return 0;
 }
@@ -236,6 +272,40 @@ int VSI_TIFFFlushBufferedWrite(thandle_t th)
     return GTHFlushBuffer(th);
 }
 
+/*
+ * Install byte ranges of the file, already read by the caller, from which
+ * the reads of libtiff are served when they fall entirely within one of
+ * them. The ranges must be sorted by increasing offset and not overlap.
+ * The buffers remain owned by the caller, and must stay valid until the
+ * ranges are reset with nRanges = 0.
+ */
+void VSI_TIFFSetCachedRanges(thandle_t th, int nRanges,
+                             void ** ppData,
+                             const vsi_l_offset* panOffsets,
+                             const size_t* panSizes)
+{
+    GDALTiffHandle* psGTH = (GDALTiffHandle*) th;
+    psGTH->nCachedRanges = nRanges;
+    if( nRanges == 0 )
+        return;
+    psGTH->ppCachedData = (void**)
+        CPLRealloc(psGTH->ppCachedData, nRanges * sizeof(void*));
+    memcpy(psGTH->ppCachedData, ppData, nRanges * sizeof(void*));
+    psGTH->panCachedOffsets = (vsi_l_offset*)
+        CPLRealloc(psGTH->panCachedOffsets, nRanges * sizeof(vsi_l_offset));
+    memcpy(psGTH->panCachedOffsets, panOffsets,
+           nRanges * sizeof(vsi_l_offset));
+    psGTH->panCachedSizes = (size_t*)
+        CPLRealloc(psGTH->panCachedSizes, nRanges * sizeof(size_t));
+    memcpy(psGTH->panCachedSizes, panSizes, nRanges * sizeof(size_t));
+}
+
+int VSI_TIFFHasCachedRanges(thandle_t th)
+{
+    GDALTiffHandle* psGTH = (GDALTiffHandle*) th;
+    return psGTH->nCachedRanges > 0;
+}
+
 /*
  * Open a TIFF file for read/writing.
  */
@@ -280,6 +350,10 @@ TIFF* VSI_TIFFOpen(const char* name, const char* mode,
     psGTH->bAtEndOfFile = FALSE;
     psGTH->abyWriteBuffer = (bAllocBuffer) ? (GByte*)VSIMalloc(BUFFER_SIZE) : NULL;
     psGTH->nWriteBufferSize = 0;
+    psGTH->nCachedRanges = 0;
+    psGTH->ppCachedData = NULL;
+    psGTH->panCachedOffsets = NULL;
+    psGTH->panCachedSizes = NULL;
 
     tif = XTIFFClientOpen(name, mode,
                           (thandle_t) psGTH,
@@ -38,5 +38,10 @@
 TIFF* VSI_TIFFOpen(const char* name, const char* mode, VSILFILE* fp);
 VSILFILE* VSI_TIFFGetVSILFile(thandle_t th);
 int VSI_TIFFFlushBufferedWrite(thandle_t th);
+void VSI_TIFFSetCachedRanges(thandle_t th, int nRanges,
+                             void ** ppData,
+                             const vsi_l_offset* panOffsets,
+                             const size_t* panSizes);
+int VSI_TIFFHasCachedRanges(thandle_t th);
 
 #endif // TIFVSI_H_INCLUDED
@@ -375,6 +375,19 @@ GDALDataset *GXFDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       GXFDriverInitMetadata()                        */
+/************************************************************************/
+
+static void GXFDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "GeoSoft Grid Exchange Format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#GXF" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gxf" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_GXF()                          */
 /************************************************************************/
@@ -389,12 +402,9 @@ void GDALRegister_GXF()
 
     poDriver->SetDescription( "GXF" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "GeoSoft Grid Exchange Format" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#GXF" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gxf" );
 
     poDriver->pfnOpen = GXFDataset::Open;
+    poDriver->pfnInitMetadata = GXFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
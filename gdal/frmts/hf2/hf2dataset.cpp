@@ -1088,19 +1088,12 @@ GDALDataset* HF2Dataset::CreateCopy( const char * pszFilename,
 }
 
 /************************************************************************/
-/*                         GDALRegister_HF2()                           */
+/*                       HF2DriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_HF2()
+static void HF2DriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "HF2" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "HF2" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "HF2/HFZ heightfield raster" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_hf2.html" );
@@ -1111,12 +1104,29 @@ void GDALRegister_HF2()
 "   <Option name='COMPRESS' type='boolean' default='false' description='Set to true to produce a GZip compressed file.'/>"
 "   <Option name='BLOCKSIZE' type='int' default='256' description='Tile size.'/>"
 "</CreationOptionList>");
+}
+
+/************************************************************************/
+/*                         GDALRegister_HF2()                           */
+/************************************************************************/
+
+void GDALRegister_HF2()
+
+{
+    if( GDALGetDriverByName( "HF2" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "HF2" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = HF2Dataset::Open;
     poDriver->pfnIdentify = HF2Dataset::Identify;
     poDriver->pfnCreateCopy = HF2Dataset::CreateCopy;
+    poDriver->pfnInitMetadata = HF2DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -6057,26 +6057,18 @@ HFADataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
 }
 
 /************************************************************************/
-/*                          GDALRegister_HFA()                          */
+/*                       HFADriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_HFA()
+static void HFADriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "HFA" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "HFA" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "Erdas Imagine Images (.img)" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_hfa.html" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "img" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte Int16 UInt16 Int32 UInt32 Float32 Float64 CFloat32 CFloat64" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "   <Option name='BLOCKSIZE' type='integer' description='tile width/height (32-2048)' default='64'/>"
@@ -6090,6 +6082,22 @@ void GDALRegister_HFA()
 "   <Option name='DEPENDENT_FILE' type='string' description='Name of dependent file (must not have absolute path)'/>"
 "   <Option name='FORCETOPESTRING' type='boolean' description='Force use of ArcGIS PE String in file instead of Imagine coordinate system format'/>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                          GDALRegister_HFA()                          */
+/************************************************************************/
+
+void GDALRegister_HFA()
+
+{
+    if( GDALGetDriverByName( "HFA" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "HFA" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
@@ -6099,6 +6107,7 @@ void GDALRegister_HFA()
     poDriver->pfnIdentify = HFADataset::Identify;
     poDriver->pfnRename = HFADataset::Rename;
     poDriver->pfnCopyFiles = HFADataset::CopyFiles;
+    poDriver->pfnInitMetadata = HFADriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
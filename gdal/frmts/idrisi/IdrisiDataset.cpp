@@ -3279,6 +3279,18 @@ int  SaveAsCRLF(char **papszStrList, const char *pszFname)
     return nLines;
 }
 
+/************************************************************************/
+/*                      IDRISIDriverInitMetadata()                      */
+/************************************************************************/
+
+static void IDRISIDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_Idrisi.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 Float32" );
+}
+
 /************************************************************************/
 /*                        GDALRegister_IDRISI()                         */
 /************************************************************************/
@@ -3293,16 +3305,14 @@ void GDALRegister_IDRISI()
     poDriver->SetDescription( "RST" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, rstVERSION );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_Idrisi.html" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, extRST );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 Float32" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = IdrisiDataset::Open;
     poDriver->pfnCreate = IdrisiDataset::Create;
     poDriver->pfnCreateCopy = IdrisiDataset::CreateCopy;
+    poDriver->pfnInitMetadata = IDRISIDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
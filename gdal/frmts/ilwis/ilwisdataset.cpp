@@ -2028,6 +2028,19 @@ int ValueRange::iRaw(double rValueIn)
 }
 
 
+/************************************************************************/
+/*                      ILWISDriverInitMetadata()                       */
+/************************************************************************/
+
+static void ILWISDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ILWIS Raster Map" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "mpr/mpl" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 Int32 Float64" );
+}
+
 /************************************************************************/
 /*                    GDALRegister_ILWIS()                              */
 /************************************************************************/
@@ -2042,15 +2055,12 @@ void GDALRegister_ILWIS()
 
     poDriver->SetDescription( "ILWIS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ILWIS Raster Map" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "mpr/mpl" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 Int32 Float64" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ILWISDataset::Open;
     poDriver->pfnCreate = ILWISDataset::Create;
     poDriver->pfnCreateCopy = ILWISDataset::CreateCopy;
+    poDriver->pfnInitMetadata = ILWISDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -885,6 +885,20 @@ CPLErr IntergraphDataset::SetProjection( const char * /* pszProjString */ )
 //                                                           GDALRegister_INGR()
 //  ----------------------------------------------------------------------------
 
+/************************************************************************/
+/*                       INGRDriverInitMetadata()                       */
+/************************************************************************/
+
+static void INGRDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Intergraph Raster" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_IntergraphRaster.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 Int32 Float32 Float64" );
+}
+
 void GDALRegister_INGR()
 {
     if( GDALGetDriverByName( "INGR" ) != NULL )
@@ -894,16 +908,12 @@ void GDALRegister_INGR()
 
     poDriver->SetDescription( "INGR" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Intergraph Raster" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_IntergraphRaster.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 Int32 Float32 Float64" );
 
     poDriver->pfnOpen = IntergraphDataset::Open;
     poDriver->pfnCreate    = IntergraphDataset::Create;
     poDriver->pfnCreateCopy = IntergraphDataset::CreateCopy;
+    poDriver->pfnInitMetadata = INGRDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -956,6 +956,19 @@ GDALDataset *IRISDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       IRISDriverInitMetadata()                       */
+/************************************************************************/
+
+static void IRISDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "IRIS data (.PPI, .CAPPi etc)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#IRIS" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ppi" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_IRIS()                         */
 /************************************************************************/
@@ -970,14 +983,11 @@ void GDALRegister_IRIS()
 
     poDriver->SetDescription( "IRIS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "IRIS data (.PPI, .CAPPi etc)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#IRIS" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ppi" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = IRISDataset::Open;
     poDriver->pfnIdentify = IRISDataset::Identify;
+    poDriver->pfnInitMetadata = IRISDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -645,6 +645,18 @@ GDALDataset *PALSARJaxaDataset::Open( GDALOpenInfo * poOpenInfo ) {
     return poDS;
 }
 
+/************************************************************************/
+/*                    PALSARJaxaDriverInitMetadata()                    */
+/************************************************************************/
+
+static void PALSARJaxaDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "JAXA PALSAR Product Reader (Level 1.1/1.5)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_palsar.html" );
+}
+
 /************************************************************************/
 /*                      GDALRegister_PALSARJaxa()                       */
 /************************************************************************/
@@ -659,13 +671,11 @@ void GDALRegister_PALSARJaxa()
 
     poDriver->SetDescription( "JAXAPALSAR" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "JAXA PALSAR Product Reader (Level 1.1/1.5)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_palsar.html" );
 
     poDriver->pfnOpen = PALSARJaxaDataset::Open;
     poDriver->pfnIdentify = PALSARJaxaDataset::Identify;
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
+    poDriver->pfnInitMetadata = PALSARJaxaDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
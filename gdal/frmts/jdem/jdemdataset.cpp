@@ -360,6 +360,18 @@ GDALDataset *JDEMDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       JDEMDriverInitMetadata()                       */
+/************************************************************************/
+
+static void JDEMDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Japanese DEM (.mem)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#JDEM" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "mem" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_JDEM()                         */
 /************************************************************************/
@@ -374,13 +386,11 @@ void GDALRegister_JDEM()
 
     poDriver->SetDescription( "JDEM" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Japanese DEM (.mem)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#JDEM" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "mem" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = JDEMDataset::Open;
     poDriver->pfnIdentify = JDEMDataset::Identify;
+    poDriver->pfnInitMetadata = JDEMDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -3702,6 +3702,24 @@ const char *GDALJPGDriver::GetMetadataItem( const char * pszName,
     return GDALDriver::GetMetadataItem(pszName, pszDomain);
 }
 
+/************************************************************************/
+/*                       JPEGDriverInitMetadata()                       */
+/************************************************************************/
+
+static void JPEGDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "JPEG JFIF" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_jpeg.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "jpg" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "jpg jpeg" );
+    poDriver->SetMetadataItem( GDAL_DMD_MIMETYPE, "image/jpeg" );
+    poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
+"<OpenOptionList>\n"
+"   <Option name='USE_INTERNAL_OVERVIEWS' type='boolean' description='whether to use implicit internal overviews' default='YES'/>\n"
+"</OpenOptionList>\n");
+}
+
 void GDALRegister_JPEG()
 
 {
@@ -3712,11 +3730,7 @@ void GDALRegister_JPEG()
 
     poDriver->SetDescription( "JPEG" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "JPEG JFIF" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_jpeg.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "jpg" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "jpg jpeg" );
-    poDriver->SetMetadataItem( GDAL_DMD_MIMETYPE, "image/jpeg" );
+    poDriver->SetMetadataItem( GDAL_DMD_SIGNATURES, "FFD8FF" );
 
 #if defined(JPEG_LIB_MK1_OR_12BIT) || defined(JPEG_DUAL_MODE_8_12)
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte UInt16" );
@@ -3725,14 +3739,10 @@ void GDALRegister_JPEG()
 #endif
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
-    poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
-"<OpenOptionList>\n"
-"   <Option name='USE_INTERNAL_OVERVIEWS' type='boolean' description='whether to use implicit internal overviews' default='YES'/>\n"
-"</OpenOptionList>\n");
-
     poDriver->pfnIdentify = JPGDatasetCommon::Identify;
     poDriver->pfnOpen = JPGDatasetCommon::Open;
     poDriver->pfnCreateCopy = JPGDataset::CreateCopy;
+    poDriver->pfnInitMetadata = JPEGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -3499,6 +3499,19 @@ bad:
     return NULL;
 }
 
+/************************************************************************/
+/*                       L1BDriverInitMetadata()                        */
+/************************************************************************/
+
+static void L1BDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "NOAA Polar Orbiter Level 1b Data Set" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_l1b.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+}
+
 /************************************************************************/
 /*                        GDALRegister_L1B()                            */
 /************************************************************************/
@@ -3513,14 +3526,11 @@ void GDALRegister_L1B()
 
     poDriver->SetDescription( "L1B" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "NOAA Polar Orbiter Level 1b Data Set" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_l1b.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
 
     poDriver->pfnOpen = L1BDataset::Open;
     poDriver->pfnIdentify = L1BDataset::Identify;
+    poDriver->pfnInitMetadata = L1BDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1584,6 +1584,18 @@ GDALDataset *LevellerDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                     LevellerDriverInitMetadata()                     */
+/************************************************************************/
+
+static void LevellerDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ter" );
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Leveller heightfield" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_leveller.html" );
+}
+
 /************************************************************************/
 /*                        GDALRegister_Leveller()                       */
 /************************************************************************/
@@ -1598,13 +1610,11 @@ void GDALRegister_Leveller()
 
     poDriver->SetDescription( "Leveller" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ter" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Leveller heightfield" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_leveller.html" );
 
     poDriver->pfnIdentify = LevellerDataset::Identify;
     poDriver->pfnOpen = LevellerDataset::Open;
     poDriver->pfnCreate = LevellerDataset::Create;
+    poDriver->pfnInitMetadata = LevellerDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -475,6 +475,17 @@ char** MAPDataset::GetFileList()
     return papszFileList;
 }
 
+/************************************************************************/
+/*                       MAPDriverInitMetadata()                        */
+/************************************************************************/
+
+static void MAPDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "OziExplorer .MAP" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_map.html" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_MAP()                          */
 /************************************************************************/
@@ -489,13 +500,12 @@ void GDALRegister_MAP()
 
     poDriver->SetDescription( "MAP" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "OziExplorer .MAP" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_map.html" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = MAPDataset::Open;
     poDriver->pfnIdentify = MAPDataset::Identify;
+    poDriver->pfnInitMetadata = MAPDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1212,24 +1212,16 @@ static CPLErr MEMDatasetDelete(CPL_UNUSED const char* fileName)
 }
 
 /************************************************************************/
-/*                          GDALRegister_MEM()                          */
+/*                       MEMDriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_MEM()
+static void MEMDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "MEM" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "MEM" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "In Memory Raster" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte Int16 UInt16 Int32 UInt32 Float32 Float64 "
                                "CInt16 CInt32 CFloat32 CFloat64" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "   <Option name='INTERLEAVE' type='string-select' default='BAND'>"
@@ -1237,6 +1229,22 @@ void GDALRegister_MEM()
 "       <Value>PIXEL</Value>"
 "   </Option>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                          GDALRegister_MEM()                          */
+/************************************************************************/
+
+void GDALRegister_MEM()
+
+{
+    if( GDALGetDriverByName( "MEM" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "MEM" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     // Define GDAL_NO_OPEN_FOR_MEM_DRIVER macro to undefine Open() method for
     // MEM driver.  Otherwise, bad user input can trigger easily a GDAL crash
@@ -1249,6 +1257,7 @@ void GDALRegister_MEM()
 #endif
     poDriver->pfnCreate = MEMDataset::Create;
     poDriver->pfnDelete = MEMDatasetDelete;
+    poDriver->pfnInitMetadata = MEMDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
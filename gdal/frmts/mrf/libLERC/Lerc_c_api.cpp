@@ -0,0 +1,175 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+A local copy of the license and additional notices are located with the
+source distribution at:
+http://github.com/Esri/lerc/
+
+C interface to Lerc2
+*/
+
+#include "Lerc_c_api.h"
+#include "Lerc2.h"
+
+USING_NAMESPACE_LERC
+
+// -------------------------------------------------------------------------- ;
+
+static bool SetLercMask(Lerc2& lerc2, int nCols, int nRows,
+                        const unsigned char* pValidBytes)
+{
+  if (!pValidBytes)
+    return lerc2.Set(nCols, nRows);
+
+  BitMask2 bitMask(nCols, nRows);
+  if (bitMask.Size() == 0)
+    return false;
+  bitMask.SetAllValid();
+  for (int k = 0; k < nCols * nRows; k++)
+    if (!pValidBytes[k])
+      bitMask.SetInvalid(k);
+  return lerc2.Set(bitMask);
+}
+
+// -------------------------------------------------------------------------- ;
+
+template<class T>
+static lerc_status EncodeTempl(const T* arr, int nCols, int nRows,
+                               const unsigned char* pValidBytes, double maxZErr,
+                               unsigned char* pOutBuffer, unsigned int outBufferSize,
+                               unsigned int* nBytesWritten)
+{
+  Lerc2 lerc2;
+  if (!SetLercMask(lerc2, nCols, nRows, pValidBytes))
+    return LERC_FAILED;
+
+  unsigned int numBytes = lerc2.ComputeNumBytesNeededToWrite(arr, maxZErr, pValidBytes != NULL);
+  if (numBytes == 0)
+    return LERC_FAILED;
+  if (nBytesWritten)
+    *nBytesWritten = numBytes;
+  if (!pOutBuffer)
+    return LERC_OK;
+  if (numBytes > outBufferSize)
+    return LERC_BUFFER_TOO_SMALL;
+
+  // The bit stuffer may write a few bytes past the end of the blob
+  std::vector<Byte> buffer(numBytes + Lerc2::NumExtraBytesToAllocate());
+  Byte* ptr = &buffer[0];
+  if (!lerc2.Encode(arr, &ptr) || (unsigned int)(ptr - &buffer[0]) != numBytes)
+    return LERC_FAILED;
+  memcpy(pOutBuffer, &buffer[0], numBytes);
+  return LERC_OK;
+}
+
+// -------------------------------------------------------------------------- ;
+
+template<class T>
+static lerc_status DecodeTempl(const unsigned char* pLercBlob, unsigned int blobSize,
+                               unsigned char* pValidBytes, int nCols, int nRows,
+                               Lerc2::DataType dt, T* arr)
+{
+  Lerc2 lerc2;
+  Lerc2::HeaderInfo hdInfo;
+  if (blobSize < lerc2.ComputeNumBytesHeader() ||
+      !lerc2.GetHeaderInfo(pLercBlob, hdInfo))
+    return LERC_FAILED;
+  if (hdInfo.nCols != nCols || hdInfo.nRows != nRows || hdInfo.dt != dt ||
+      hdInfo.blobSize <= 0 || (unsigned int)hdInfo.blobSize > blobSize)
+    return LERC_FAILED;
+
+  // The bit stuffer may read a few bytes past the end of the blob
+  std::vector<Byte> buffer(hdInfo.blobSize + Lerc2::NumExtraBytesToAllocate());
+  memcpy(&buffer[0], pLercBlob, hdInfo.blobSize);
+  const Byte* ptr = &buffer[0];
+
+  BitMask2 bitMask(nCols, nRows);
+  if (bitMask.Size() == 0 || !lerc2.Decode(&ptr, arr, bitMask.Bits()))
+    return LERC_FAILED;
+
+  if (pValidBytes)
+    for (int k = 0; k < nCols * nRows; k++)
+      pValidBytes[k] = bitMask.IsValid(k);
+  return LERC_OK;
+}
+
+// -------------------------------------------------------------------------- ;
+
+lerc_status lerc_computeCompressedSize(const void* pData, unsigned int dataType,
+                                       int nCols, int nRows,
+                                       const unsigned char* pValidBytes,
+                                       double maxZErr,
+                                       unsigned int* numBytes)
+{
+  return lerc_encode(pData, dataType, nCols, nRows, pValidBytes, maxZErr,
+                     NULL, 0, numBytes);
+}
+
+// -------------------------------------------------------------------------- ;
+
+lerc_status lerc_encode(const void* pData, unsigned int dataType,
+                        int nCols, int nRows,
+                        const unsigned char* pValidBytes,
+                        double maxZErr,
+                        unsigned char* pOutBuffer, unsigned int outBufferSize,
+                        unsigned int* nBytesWritten)
+{
+  if (!pData || nCols <= 0 || nRows <= 0 || maxZErr < 0)
+    return LERC_WRONG_PARAM;
+
+  switch (dataType)
+  {
+#define ENCODE(T) return EncodeTempl(static_cast<const T*>(pData), nCols, nRows, \
+                                     pValidBytes, maxZErr, pOutBuffer, outBufferSize, \
+                                     nBytesWritten)
+    case LERC_DT_CHAR:    ENCODE(char);
+    case LERC_DT_BYTE:    ENCODE(Byte);
+    case LERC_DT_SHORT:   ENCODE(short);
+    case LERC_DT_USHORT:  ENCODE(unsigned short);
+    case LERC_DT_INT:     ENCODE(int);
+    case LERC_DT_UINT:    ENCODE(unsigned int);
+    case LERC_DT_FLOAT:   ENCODE(float);
+    case LERC_DT_DOUBLE:  ENCODE(double);
+#undef ENCODE
+    default:
+      return LERC_WRONG_PARAM;
+  }
+}
+
+// -------------------------------------------------------------------------- ;
+
+lerc_status lerc_decode(const unsigned char* pLercBlob, unsigned int blobSize,
+                        unsigned char* pValidBytes,
+                        int nCols, int nRows, unsigned int dataType,
+                        void* pData)
+{
+  if (!pLercBlob || !pData || nCols <= 0 || nRows <= 0)
+    return LERC_WRONG_PARAM;
+
+  switch (dataType)
+  {
+#define DECODE(T) return DecodeTempl(pLercBlob, blobSize, pValidBytes, nCols, nRows, \
+                                     static_cast<Lerc2::DataType>(dataType), \
+                                     static_cast<T*>(pData))
+    case LERC_DT_CHAR:    DECODE(char);
+    case LERC_DT_BYTE:    DECODE(Byte);
+    case LERC_DT_SHORT:   DECODE(short);
+    case LERC_DT_USHORT:  DECODE(unsigned short);
+    case LERC_DT_INT:     DECODE(int);
+    case LERC_DT_UINT:    DECODE(unsigned int);
+    case LERC_DT_FLOAT:   DECODE(float);
+    case LERC_DT_DOUBLE:  DECODE(double);
+#undef DECODE
+    default:
+      return LERC_WRONG_PARAM;
+  }
+}
+
+// -------------------------------------------------------------------------- ;
@@ -0,0 +1,75 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+A local copy of the license and additional notices are located with the
+source distribution at:
+http://github.com/Esri/lerc/
+
+C interface to Lerc2, for use by C code such as the libtiff LERC codec.
+Only single band (nDim = 1) rasters are handled, like Lerc2 itself.
+*/
+
+#ifndef LERC_C_API_H
+#define LERC_C_API_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int lerc_status;
+
+#define LERC_OK             0
+#define LERC_FAILED         1
+#define LERC_WRONG_PARAM    2
+#define LERC_BUFFER_TOO_SMALL 3
+
+/* Same values as Lerc2::DataType */
+#define LERC_DT_CHAR        0
+#define LERC_DT_BYTE        1
+#define LERC_DT_SHORT       2
+#define LERC_DT_USHORT      3
+#define LERC_DT_INT         4
+#define LERC_DT_UINT        5
+#define LERC_DT_FLOAT       6
+#define LERC_DT_DOUBLE      7
+
+/*
+ * pValidBytes, when not NULL, holds one byte per pixel, non zero for valid
+ * pixels. For integer data types, maxZErr is raised to at least 0.5, which
+ * is lossless.
+ */
+lerc_status lerc_computeCompressedSize(const void* pData, unsigned int dataType,
+                                       int nCols, int nRows,
+                                       const unsigned char* pValidBytes,
+                                       double maxZErr,
+                                       unsigned int* numBytes);
+
+lerc_status lerc_encode(const void* pData, unsigned int dataType,
+                        int nCols, int nRows,
+                        const unsigned char* pValidBytes,
+                        double maxZErr,
+                        unsigned char* pOutBuffer, unsigned int outBufferSize,
+                        unsigned int* nBytesWritten);
+
+/*
+ * Fails if the blob header does not match nCols, nRows and dataType.
+ * pValidBytes, when not NULL, receives one byte per pixel set to 1 for
+ * valid pixels and 0 otherwise. Invalid pixels are set to 0 in pData.
+ */
+lerc_status lerc_decode(const unsigned char* pLercBlob, unsigned int blobSize,
+                        unsigned char* pValidBytes,
+                        int nCols, int nRows, unsigned int dataType,
+                        void* pData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LERC_C_API_H */
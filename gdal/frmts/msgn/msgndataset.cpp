@@ -532,6 +532,19 @@ GDALDataset *MSGNDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       MSGNDriverInitMetadata()                       */
+/************************************************************************/
+
+static void MSGNDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "EUMETSAT Archive native (.nat)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_msgn.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "nat" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_MSGN()                         */
 /************************************************************************/
@@ -546,12 +559,9 @@ void GDALRegister_MSGN()
 
     poDriver->SetDescription( "MSGN" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "EUMETSAT Archive native (.nat)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_msgn.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "nat" );
 
     poDriver->pfnOpen = MSGNDataset::Open;
+    poDriver->pfnInitMetadata = MSGNDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -399,6 +399,19 @@ const char* NGSGEOIDDataset::GetProjectionRef()
     return SRS_WKT_WGS84;
 }
 
+/************************************************************************/
+/*                     NGSGEOIDDriverInitMetadata()                     */
+/************************************************************************/
+
+static void NGSGEOIDDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "NOAA NGS Geoid Height Grids" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_ngsgeoid.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "bin" );
+}
+
 /************************************************************************/
 /*                       GDALRegister_NGSGEOID()                        */
 /************************************************************************/
@@ -413,15 +426,12 @@ void GDALRegister_NGSGEOID()
 
     poDriver->SetDescription( "NGSGEOID" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "NOAA NGS Geoid Height Grids" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_ngsgeoid.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "bin" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = NGSGEOIDDataset::Open;
     poDriver->pfnIdentify = NGSGEOIDDataset::Identify;
+    poDriver->pfnInitMetadata = NGSGEOIDDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1130,6 +1130,20 @@ GDALDataset *ECRGTOCDataset::Open( GDALOpenInfo * poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                     ECRGTOCDriverInitMetadata()                      */
+/************************************************************************/
+
+static void ECRGTOCDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ECRG TOC format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#ECRGTOC" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "xml" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_ECRGTOC()                       */
 /************************************************************************/
@@ -1144,16 +1158,12 @@ void GDALRegister_ECRGTOC()
 
     poDriver->SetDescription( "ECRGTOC" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ECRG TOC format" );
 
     poDriver->pfnIdentify = ECRGTOCDataset::Identify;
     poDriver->pfnOpen = ECRGTOCDataset::Open;
 
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#ECRGTOC" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "xml" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+    poDriver->pfnInitMetadata = ECRGTOCDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -5620,7 +5620,7 @@ NITFWriteJPEGImage( GDALDataset *poSrcDS, VSILFILE *fp, vsi_l_offset nStartOffse
 #endif /* def JPEG_SUPPORTED */
 
 /************************************************************************/
-/*                          GDALRegister_NITF()                         */
+/*                       NITFDriverInitMetadata()                       */
 /************************************************************************/
 
 typedef struct
@@ -5698,12 +5698,9 @@ static const char * const apszFieldsBLOCKA[] = {
         "FRFC_LOC",       "97", "21",
         NULL,             NULL, NULL };
 
-void GDALRegister_NITF()
+static void NITFDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "NITF" ) != NULL )
-        return;
-
     CPLString osCreationOptions =
 "<CreationOptionList>"
 "   <Option name='IC' type='string-select' default='NC' description='Compression mode. NC=no compression. "
@@ -5779,10 +5776,6 @@ void GDALRegister_NITF()
 "   <Option name='SDE_TRE' type='boolean' description='Write GEOLOB and GEOPSB TREs (only geographic SRS for now)' default='NO'/>";
     osCreationOptions += "</CreationOptionList>";
 
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "NITF" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "National Imagery Transmission Format" );
 
@@ -5793,12 +5786,29 @@ void GDALRegister_NITF()
                                "Byte UInt16 Int16 UInt32 Int32 Float32" );
 
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST, osCreationOptions);
+}
+
+/************************************************************************/
+/*                          GDALRegister_NITF()                         */
+/************************************************************************/
+
+void GDALRegister_NITF()
+
+{
+    if( GDALGetDriverByName( "NITF" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "NITF" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnIdentify = NITFDataset::Identify;
     poDriver->pfnOpen = NITFDataset::Open;
     poDriver->pfnCreate = NITFDataset::NITFDatasetCreate;
     poDriver->pfnCreateCopy = NITFDataset::NITFCreateCopy;
+    poDriver->pfnInitMetadata = NITFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1272,6 +1272,21 @@ GDALDataset *RPFTOCDataset::Open( GDALOpenInfo * poOpenInfo )
 
 }
 
+/************************************************************************/
+/*                      RPFTOCDriverInitMetadata()                      */
+/************************************************************************/
+
+static void RPFTOCDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Raster Product Format TOC format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#RPFTOC" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "toc" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_RPFTOC()                       */
 /************************************************************************/
@@ -1286,17 +1301,12 @@ void GDALRegister_RPFTOC()
 
     poDriver->SetDescription( "RPFTOC" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Raster Product Format TOC format" );
 
     poDriver->pfnIdentify = RPFTOCDataset::Identify;
     poDriver->pfnOpen = RPFTOCDataset::Open;
 
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#RPFTOC" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "toc" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+    poDriver->pfnInitMetadata = RPFTOCDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
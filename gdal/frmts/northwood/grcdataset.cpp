@@ -400,6 +400,20 @@ GDALDataset *NWT_GRCDataset::Open( GDALOpenInfo * poOpenInfo )
 /*                          GDALRegister_GRC()                          */
 /************************************************************************/
 
+/************************************************************************/
+/*                     NWT_GRCDriverInitMetadata()                      */
+/************************************************************************/
+
+static void NWT_GRCDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Northwood Classified Grid Format .grc/.tab");
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#northwood_grc" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grc" );
+}
+
 void GDALRegister_NWT_GRC()
 
 {
@@ -410,15 +424,11 @@ void GDALRegister_NWT_GRC()
 
     poDriver->SetDescription( "NWT_GRC" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Northwood Classified Grid Format .grc/.tab");
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#northwood_grc" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grc" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = NWT_GRCDataset::Open;
     poDriver->pfnIdentify = NWT_GRCDataset::Identify;
+    poDriver->pfnInitMetadata = NWT_GRCDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
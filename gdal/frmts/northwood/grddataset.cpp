@@ -422,6 +422,19 @@ GDALDataset *NWT_GRDDataset::Open( GDALOpenInfo * poOpenInfo )
 /************************************************************************/
 /*                          GDALRegister_GRD()                          */
 /************************************************************************/
+/************************************************************************/
+/*                     NWT_GRDDriverInitMetadata()                      */
+/************************************************************************/
+
+static void NWT_GRDDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Northwood Numeric Grid Format .grd/.tab" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#grd");
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grd" );
+}
+
 void GDALRegister_NWT_GRD()
 {
     if( GDALGetDriverByName( "NWT_GRD" ) != NULL )
@@ -431,14 +444,11 @@ void GDALRegister_NWT_GRD()
 
     poDriver->SetDescription( "NWT_GRD" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Northwood Numeric Grid Format .grd/.tab" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#grd");
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "grd" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = NWT_GRDDataset::Open;
     poDriver->pfnIdentify = NWT_GRDDataset::Identify;
+    poDriver->pfnInitMetadata = NWT_GRDDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
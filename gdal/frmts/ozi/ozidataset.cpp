@@ -666,6 +666,17 @@ GDALDataset *OZIDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       OZIDriverInitMetadata()                        */
+/************************************************************************/
+
+static void OZIDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "OziExplorer Image File" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_ozi.html" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_OZI()                           */
 /************************************************************************/
@@ -683,12 +694,11 @@ void GDALRegister_OZI()
 
     poDriver->SetDescription( "OZI" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "OziExplorer Image File" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_ozi.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OZIDataset::Open;
     poDriver->pfnIdentify = OZIDataset::Identify;
+    poDriver->pfnInitMetadata = OZIDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
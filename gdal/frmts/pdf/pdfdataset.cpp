@@ -6743,42 +6743,16 @@ CPLString PDFSanitizeLayerName(const char* pszName)
 }
 
 /************************************************************************/
-/*                         GDALRegister_PDF()                           */
+/*                       PDFDriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_PDF()
+static void PDFDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( !GDAL_CHECK_VERSION( "PDF driver" ) )
-        return;
-
-    if( GDALGetDriverByName( "PDF" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "PDF" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Geospatial PDF" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_pdf.html" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "pdf" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte" );
-
-#if defined(HAVE_POPPLER) || defined(HAVE_PDFIUM)
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-#endif
-
-#ifdef HAVE_POPPLER
-    poDriver->SetMetadataItem( "HAVE_POPPLER", "YES" );
-#endif // HAVE_POPPLER
-#ifdef HAVE_PODOFO
-    poDriver->SetMetadataItem( "HAVE_PODOFO", "YES" );
-#endif // HAVE_PODOFO
-#ifdef HAVE_PDFIUM
-    poDriver->SetMetadataItem( "HAVE_PDFIUM", "YES" );
-#endif // HAVE_PDFIUM
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>\n"
 "   <Option name='COMPRESS' type='string-select' description='Compression method for raster data' default='DEFLATE'>\n"
@@ -6836,6 +6810,40 @@ void GDALRegister_PDF()
 "   <Option name='JAVASCRIPT' type='string' description='Javascript script to embed and run at file opening'/>\n"
 "   <Option name='JAVASCRIPT_FILE' type='string' description='Filename of the Javascript script to embed and run at file opening'/>\n"
 "</CreationOptionList>\n" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_PDF()                           */
+/************************************************************************/
+
+void GDALRegister_PDF()
+
+{
+    if( !GDAL_CHECK_VERSION( "PDF driver" ) )
+        return;
+
+    if( GDALGetDriverByName( "PDF" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "PDF" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
+#if defined(HAVE_POPPLER) || defined(HAVE_PDFIUM)
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
+#endif
+
+#ifdef HAVE_POPPLER
+    poDriver->SetMetadataItem( "HAVE_POPPLER", "YES" );
+#endif // HAVE_POPPLER
+#ifdef HAVE_PODOFO
+    poDriver->SetMetadataItem( "HAVE_PODOFO", "YES" );
+#endif // HAVE_PODOFO
+#ifdef HAVE_PDFIUM
+    poDriver->SetMetadataItem( "HAVE_PDFIUM", "YES" );
+#endif // HAVE_PDFIUM
 
 #if defined(HAVE_POPPLER) || defined(HAVE_PODOFO) || defined(HAVE_PDFIUM)
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST, szOpenOptionList );
@@ -6847,6 +6855,7 @@ void GDALRegister_PDF()
     poDriver->pfnCreateCopy = GDALPDFCreateCopy;
     poDriver->pfnCreate = PDFWritableVectorDataset::Create;
     poDriver->pfnUnloadDriver = GDALPDFUnloadDriver;
+    poDriver->pfnInitMetadata = PDFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1148,26 +1148,17 @@ int ISIS2Dataset::WriteLabel(
     }
 
 /************************************************************************/
-/*                         GDALRegister_ISIS2()                         */
+/*                      ISIS2DriverInitMetadata()                       */
 /************************************************************************/
 
-void GDALRegister_ISIS2()
+static void ISIS2DriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "ISIS2" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "ISIS2" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "USGS Astrogeology ISIS cube (Version 2)" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_isis2.html" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte Int16 UInt16 Float32 Float64");
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>\n"
 "   <Option name='LABELING_METHOD' type='string-select' default='ATTACHED'>\n"
@@ -1176,10 +1167,28 @@ void GDALRegister_ISIS2()
 "   </Option>"
 "   <Option name='IMAGE_EXTENSION' type='string' default='cub'/>\n"
 "</CreationOptionList>\n" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_ISIS2()                         */
+/************************************************************************/
+
+void GDALRegister_ISIS2()
+
+{
+    if( GDALGetDriverByName( "ISIS2" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "ISIS2" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnIdentify = ISIS2Dataset::Identify;
     poDriver->pfnOpen = ISIS2Dataset::Open;
     poDriver->pfnCreate = ISIS2Dataset::Create;
+    poDriver->pfnInitMetadata = ISIS2DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
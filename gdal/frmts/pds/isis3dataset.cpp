@@ -864,6 +864,19 @@ const char *ISIS3Dataset::GetKeywordSub( const char *pszPath,
 }
 
 
+/************************************************************************/
+/*                      ISIS3DriverInitMetadata()                       */
+/************************************************************************/
+
+static void ISIS3DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "USGS Astrogeology ISIS cube (Version 3)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_isis3.html" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_ISIS3()                         */
 /************************************************************************/
@@ -878,14 +891,11 @@ void GDALRegister_ISIS3()
 
     poDriver->SetDescription( "ISIS3" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "USGS Astrogeology ISIS cube (Version 3)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_isis3.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ISIS3Dataset::Open;
     poDriver->pfnIdentify = ISIS3Dataset::Identify;
+    poDriver->pfnInitMetadata = ISIS3DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
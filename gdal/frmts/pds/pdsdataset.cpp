@@ -1379,6 +1379,19 @@ void PDSDataset::CleanString( CPLString &osInput )
     osInput = pszWrk;
     CPLFree( pszWrk );
 }
+/************************************************************************/
+/*                       PDSDriverInitMetadata()                        */
+/************************************************************************/
+
+static void PDSDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "NASA Planetary Data System" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_pds.html" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_PDS()                           */
 /************************************************************************/
@@ -1393,14 +1406,11 @@ void GDALRegister_PDS()
 
     poDriver->SetDescription( "PDS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "NASA Planetary Data System" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_pds.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = PDSDataset::Open;
     poDriver->pfnIdentify = PDSDataset::Identify;
+    poDriver->pfnInitMetadata = PDSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
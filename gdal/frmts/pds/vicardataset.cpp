@@ -778,6 +778,17 @@ const char *VICARDataset::GetKeyword( const char *pszPath,
     return oKeywords.GetKeyword( pszPath, pszDefault );
 }
 
+/************************************************************************/
+/*                      VICARDriverInitMetadata()                       */
+/************************************************************************/
+
+static void VICARDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "MIPL VICAR file" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_vicar.html" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_VICAR()                         */
 /************************************************************************/
@@ -792,12 +803,11 @@ void GDALRegister_VICAR()
 
     poDriver->SetDescription( "VICAR" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "MIPL VICAR file" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_vicar.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = VICARDataset::Open;
     poDriver->pfnIdentify = VICARDataset::Identify;
+    poDriver->pfnInitMetadata = VICARDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
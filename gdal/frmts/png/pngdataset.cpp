@@ -2041,26 +2041,18 @@ static void png_gdal_warning( CPL_UNUSED png_structp png_ptr,
 }
 
 /************************************************************************/
-/*                          GDALRegister_PNG()                        */
+/*                       PNGDriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_PNG()
+static void PNGDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "PNG" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "PNG" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "Portable Network Graphics" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
                                "frmt_various.html#PNG" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "png" );
     poDriver->SetMetadataItem( GDAL_DMD_MIMETYPE, "image/png" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte UInt16" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
@@ -2081,6 +2073,24 @@ void GDALRegister_PNG()
 "   <Option name='WRITE_METADATA_AS_TEXT' type='boolean' description='Whether to write source dataset metadata in TEXT chunks' default='FALSE'/>\n"
 "   <Option name='NBITS' type='int' description='Force output bit depth: 1, 2 or 4'/>\n"
 "</CreationOptionList>\n" );
+}
+
+/************************************************************************/
+/*                          GDALRegister_PNG()                        */
+/************************************************************************/
+
+void GDALRegister_PNG()
+
+{
+    if( GDALGetDriverByName( "PNG" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "PNG" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
+    // png_sig_cmp() accepts files of at least 4 bytes
+    poDriver->SetMetadataItem( GDAL_DMD_SIGNATURES, "89504E47" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
@@ -2090,6 +2100,7 @@ void GDALRegister_PNG()
 #ifdef SUPPORT_CREATE
     poDriver->pfnCreate = PNGDataset::Create;
 #endif
+    poDriver->pfnInitMetadata = PNGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
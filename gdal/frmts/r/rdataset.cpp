@@ -582,19 +582,12 @@ GDALDataset *RDataset::Open( GDALOpenInfo * poOpenInfo )
 }
 
 /************************************************************************/
-/*                        GDALRegister_R()                              */
+/*                        RDriverInitMetadata()                         */
 /************************************************************************/
 
-void GDALRegister_R()
+static void RDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "R" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "R" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "R Object Data Store" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_r.html" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "rda" );
@@ -604,12 +597,29 @@ void GDALRegister_R()
 "   <Option name='ASCII' type='boolean' description='For ASCII output, default NO'/>"
 "   <Option name='COMPRESS' type='boolean' description='Produced Compressed output, default YES'/>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                        GDALRegister_R()                              */
+/************************************************************************/
+
+void GDALRegister_R()
+
+{
+    if( GDALGetDriverByName( "R" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "R" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = RDataset::Open;
     poDriver->pfnIdentify = RDataset::Identify;
     poDriver->pfnCreateCopy = RCreateCopy;
+    poDriver->pfnInitMetadata = RDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
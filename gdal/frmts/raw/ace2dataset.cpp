@@ -369,6 +369,18 @@ GDALDataset *ACE2Dataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       ACE2DriverInitMetadata()                       */
+/************************************************************************/
+
+static void ACE2DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ACE2" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#ACE2" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ACE2" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_ACE2()                         */
 /************************************************************************/
@@ -383,13 +395,11 @@ void GDALRegister_ACE2()
 
     poDriver->SetDescription( "ACE2" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ACE2" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#ACE2" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ACE2" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ACE2Dataset::Open;
     poDriver->pfnIdentify = ACE2Dataset::Identify;
+    poDriver->pfnInitMetadata = ACE2DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -932,6 +932,22 @@ GDALDataset *BTDataset::Create( const char * pszFilename,
     return (GDALDataset *) GDALOpen( pszFilename, GA_Update );
 }
 
+/************************************************************************/
+/*                        BTDriverInitMetadata()                        */
+/************************************************************************/
+
+static void BTDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                                   "VTP .bt (Binary Terrain) 1.3 Format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                                   "frmt_various.html#BT" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "bt" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Int16 Int32 Float32" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_BT()                           */
 /************************************************************************/
@@ -946,17 +962,11 @@ void GDALRegister_BT()
 
     poDriver->SetDescription( "BT" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                                   "VTP .bt (Binary Terrain) 1.3 Format" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                                   "frmt_various.html#BT" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "bt" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Int16 Int32 Float32" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = BTDataset::Open;
     poDriver->pfnCreate = BTDataset::Create;
+    poDriver->pfnInitMetadata = BTDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
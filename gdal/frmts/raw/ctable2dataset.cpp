@@ -434,6 +434,17 @@ GDALDataset *CTable2Dataset::Create( const char * pszFilename,
     return (GDALDataset *) GDALOpen( pszFilename, GA_Update );
 }
 
+/************************************************************************/
+/*                     CTable2DriverInitMetadata()                      */
+/************************************************************************/
+
+static void CTable2DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "CTable2 Datum Grid Shift" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Float32" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_CTable2()                       */
 /************************************************************************/
@@ -448,14 +459,12 @@ void GDALRegister_CTable2()
 
     poDriver->SetDescription( "CTable2" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "CTable2 Datum Grid Shift" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Float32" );
-
     poDriver->pfnOpen = CTable2Dataset::Open;
     poDriver->pfnIdentify = CTable2Dataset::Identify;
     poDriver->pfnCreate = CTable2Dataset::Create;
+    poDriver->pfnInitMetadata = CTable2DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
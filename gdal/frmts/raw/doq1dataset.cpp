@@ -335,6 +335,17 @@ GDALDataset *DOQ1Dataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       DOQ1DriverInitMetadata()                       */
+/************************************************************************/
+
+static void DOQ1DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "USGS DOQ (Old Style)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#DOQ1" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_DOQ1()                          */
 /************************************************************************/
@@ -349,11 +360,10 @@ void GDALRegister_DOQ1()
 
     poDriver->SetDescription( "DOQ1" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "USGS DOQ (Old Style)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#DOQ1" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = DOQ1Dataset::Open;
+    poDriver->pfnInitMetadata = DOQ1DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -433,6 +433,17 @@ GDALDataset *DOQ2Dataset::Open( GDALOpenInfo * poOpenInfo )
 /*                         GDALRegister_DOQ1()                          */
 /************************************************************************/
 
+/************************************************************************/
+/*                       DOQ2DriverInitMetadata()                       */
+/************************************************************************/
+
+static void DOQ2DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "USGS DOQ (New Style)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#DOQ2" );
+}
+
 void GDALRegister_DOQ2()
 
 {
@@ -443,11 +454,10 @@ void GDALRegister_DOQ2()
 
     poDriver->SetDescription( "DOQ2" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "USGS DOQ (New Style)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#DOQ2" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = DOQ2Dataset::Open;
+    poDriver->pfnInitMetadata = DOQ2DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
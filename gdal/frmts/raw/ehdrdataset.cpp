@@ -2077,34 +2077,43 @@ CPLErr EHdrRasterBand::SetColorTable( GDALColorTable *poNewCT )
 }
 
 /************************************************************************/
-/*                         GDALRegister_EHdr()                          */
+/*                       EHdrDriverInitMetadata()                       */
 /************************************************************************/
 
-void GDALRegister_EHdr()
+static void EHdrDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "EHdr" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "EHdr" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ESRI .hdr Labelled" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#EHdr" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte Int16 UInt16 Int32 UInt32 Float32" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "   <Option name='NBITS' type='int' description='Special pixel bits (1-7)'/>"
 "   <Option name='PIXELTYPE' type='string' description='By setting this to SIGNEDBYTE, a new Byte file can be forced to be written as signed byte'/>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_EHdr()                          */
+/************************************************************************/
+
+void GDALRegister_EHdr()
+
+{
+    if( GDALGetDriverByName( "EHdr" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "EHdr" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->pfnOpen = EHdrDataset::Open;
     poDriver->pfnCreate = EHdrDataset::Create;
     poDriver->pfnCreateCopy = EHdrDataset::CreateCopy;
+    poDriver->pfnInitMetadata = EHdrDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -532,6 +532,17 @@ GDALDataset *EIRDataset::Open( GDALOpenInfo * poOpenInfo )
 }
 
 
+/************************************************************************/
+/*                       EIRDriverInitMetadata()                        */
+/************************************************************************/
+
+static void EIRDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Erdas Imagine Raw" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#EIR" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_EIR()                           */
 /************************************************************************/
@@ -546,12 +557,11 @@ void GDALRegister_EIR()
 
     poDriver->SetDescription( "EIR" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Erdas Imagine Raw" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#EIR" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = EIRDataset::Open;
     poDriver->pfnIdentify = EIRDataset::Identify;
+    poDriver->pfnInitMetadata = EIRDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
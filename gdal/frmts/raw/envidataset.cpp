@@ -2711,18 +2711,12 @@ CPLErr ENVIRasterBand::SetCategoryNames( char ** papszCategoryNamesIn )
 }
 
 /************************************************************************/
-/*                         GDALRegister_ENVI()                          */
+/*                       ENVIDriverInitMetadata()                       */
 /************************************************************************/
 
-void GDALRegister_ENVI()
-{
-    if( GDALGetDriverByName( "ENVI" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
+static void ENVIDriverInitMetadata( GDALDriver* poDriver )
 
-    poDriver->SetDescription( "ENVI" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
+{
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ENVI .hdr Labelled" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#ENVI" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "" );
@@ -2740,10 +2734,26 @@ void GDALRegister_ENVI()
 "       <Value>BSQ</Value>"
 "   </Option>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_ENVI()                          */
+/************************************************************************/
+
+void GDALRegister_ENVI()
+{
+    if( GDALGetDriverByName( "ENVI" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "ENVI" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->pfnOpen = ENVIDataset::Open;
     poDriver->pfnCreate = ENVIDataset::Create;
+    poDriver->pfnInitMetadata = ENVIDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1116,6 +1116,19 @@ GDALDataset *FASTDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       FASTDriverInitMetadata()                       */
+/************************************************************************/
+
+static void FASTDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "EOSAT FAST Format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_fast.html" );
+}
+
 /************************************************************************/
 /*                        GDALRegister_FAST()                           */
 /************************************************************************/
@@ -1130,13 +1143,10 @@ void GDALRegister_FAST()
 
     poDriver->SetDescription( "FAST" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "EOSAT FAST Format" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_fast.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = FASTDataset::Open;
+    poDriver->pfnInitMetadata = FASTDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
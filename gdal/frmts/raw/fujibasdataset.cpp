@@ -215,6 +215,18 @@ GDALDataset *FujiBASDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                     FujiBASDriverInitMetadata()                      */
+/************************************************************************/
+
+static void FujiBASDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Fuji BAS Scanner Image" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#FujiBAS" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_FujiBAS()                       */
 /************************************************************************/
@@ -229,11 +241,9 @@ void GDALRegister_FujiBAS()
 
     poDriver->SetDescription( "FujiBAS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Fuji BAS Scanner Image" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#FujiBAS" );
 
     poDriver->pfnOpen = FujiBASDataset::Open;
+    poDriver->pfnInitMetadata = FujiBASDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
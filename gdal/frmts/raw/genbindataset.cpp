@@ -858,6 +858,19 @@ GDALDataset *GenBinDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                      GenBinDriverInitMetadata()                      */
+/************************************************************************/
+
+static void GenBinDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Generic Binary (.hdr Labelled)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#GenBin" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_GenBin()                        */
 /************************************************************************/
@@ -872,13 +885,10 @@ void GDALRegister_GenBin()
 
     poDriver->SetDescription( "GenBin" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Generic Binary (.hdr Labelled)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#GenBin" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = GenBinDataset::Open;
+    poDriver->pfnInitMetadata = GenBinDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
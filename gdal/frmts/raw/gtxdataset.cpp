@@ -377,6 +377,19 @@ GDALDataset *GTXDataset::Create( const char * pszFilename,
 }
 
 
+/************************************************************************/
+/*                       GTXDriverInitMetadata()                        */
+/************************************************************************/
+
+static void GTXDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "NOAA Vertical Datum .GTX" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gtx" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Float32" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_GTX()                          */
 /************************************************************************/
@@ -391,18 +404,14 @@ void GDALRegister_GTX()
 
     poDriver->SetDescription( "GTX" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "NOAA Vertical Datum .GTX" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gtx" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     // poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
     //                            "frmt_various.html#GTX" );
 
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Float32" );
-
     poDriver->pfnOpen = GTXDataset::Open;
     poDriver->pfnIdentify = GTXDataset::Identify;
     poDriver->pfnCreate = GTXDataset::Create;
+    poDriver->pfnInitMetadata = GTXDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
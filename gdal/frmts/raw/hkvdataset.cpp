@@ -1818,6 +1818,20 @@ HKVDataset::CreateCopy( const char * pszFilename,
 }
 
 
+/************************************************************************/
+/*                       HKVDriverInitMetadata()                        */
+/************************************************************************/
+
+static void HKVDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Vexcel MFF2 (HKV) Raster" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_mff2.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 UInt16 Int32 UInt32 CInt16 "
+                               "CInt32 Float32 Float64 CFloat32 CFloat64" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_HKV()                           */
 /************************************************************************/
@@ -1832,16 +1846,12 @@ void GDALRegister_HKV()
 
     poDriver->SetDescription( "MFF2" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Vexcel MFF2 (HKV) Raster" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_mff2.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 UInt16 Int32 UInt32 CInt16 "
-                               "CInt32 Float32 Float64 CFloat32 CFloat64" );
 
     poDriver->pfnOpen = HKVDataset::Open;
     poDriver->pfnCreate = HKVDataset::Create;
     poDriver->pfnDelete = HKVDataset::Delete;
     poDriver->pfnCreateCopy = HKVDataset::CreateCopy;
+    poDriver->pfnInitMetadata = HKVDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
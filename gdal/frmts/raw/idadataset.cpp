@@ -1089,6 +1089,20 @@ GDALDataset *IDADataset::Create( const char * pszFilename,
     return (GDALDataset *) GDALOpen( pszFilename, GA_Update );
 }
 
+/************************************************************************/
+/*                       IDADriverInitMetadata()                        */
+/************************************************************************/
+
+static void IDADriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Image Data and Analysis" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#IDA" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_IDA()                           */
 /************************************************************************/
@@ -1103,16 +1117,12 @@ void GDALRegister_IDA()
 
     poDriver->SetDescription( "IDA" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Image Data and Analysis" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#IDA" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = IDADataset::Open;
     poDriver->pfnCreate = IDADataset::Create;
+    poDriver->pfnInitMetadata = IDADriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
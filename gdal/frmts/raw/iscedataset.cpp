@@ -638,20 +638,12 @@ ISCERasterBand::ISCERasterBand( GDALDataset *poDSIn, int nBandIn, void *fpRawIn,
 }
 
 /************************************************************************/
-/*                         GDALRegister_ISCE()                          */
+/*                       ISCEDriverInitMetadata()                       */
 /************************************************************************/
 
-void GDALRegister_ISCE()
-{
-    if( !GDAL_CHECK_VERSION( "ISCE" ) )
-        return;
-
-    if( GDALGetDriverByName( "ISCE" ) != NULL )
-        return;
+static void ISCEDriverInitMetadata( GDALDriver* poDriver )
 
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "ISCE" );
+{
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ISCE raster" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#ISCE" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
@@ -666,11 +658,29 @@ void GDALRegister_ISCE()
 "       <Value>BSQ</Value>"
 "   </Option>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_ISCE()                          */
+/************************************************************************/
+
+void GDALRegister_ISCE()
+{
+    if( !GDAL_CHECK_VERSION( "ISCE" ) )
+        return;
+
+    if( GDALGetDriverByName( "ISCE" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "ISCE" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ISCEDataset::Open;
     poDriver->pfnCreate = ISCEDataset::Create;
+    poDriver->pfnInitMetadata = ISCEDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -299,6 +299,19 @@ GDALDataset *KRODataset::Create( const char * pszFilename,
     return reinterpret_cast<GDALDataset *>( GDALOpen( pszFilename, GA_Update ) );
 }
 
+/************************************************************************/
+/*                       KRODriverInitMetadata()                        */
+/************************************************************************/
+
+static void KRODriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "KOLOR Raw" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "kro" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte UInt16 Float32" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_KRO()                           */
 /************************************************************************/
@@ -313,15 +326,12 @@ void GDALRegister_KRO()
 
     poDriver->SetDescription( "KRO" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "KOLOR Raw" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "kro" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte UInt16 Float32" );
 
     poDriver->pfnIdentify = KRODataset::Identify;
     poDriver->pfnOpen = KRODataset::Open;
     poDriver->pfnCreate = KRODataset::Create;
+    poDriver->pfnInitMetadata = KRODriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1019,6 +1019,18 @@ GDALDataset *LANDataset::Create( const char * pszFilename,
     return (GDALDataset *) GDALOpen( pszFilename, GA_Update );
 }
 
+/************************************************************************/
+/*                       LANDriverInitMetadata()                        */
+/************************************************************************/
+
+static void LANDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Erdas .LAN/.GIS" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#LAN" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte Int16" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_LAN()                          */
 /************************************************************************/
@@ -1033,13 +1045,11 @@ void GDALRegister_LAN()
 
     poDriver->SetDescription( "LAN" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Erdas .LAN/.GIS" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#LAN" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte Int16" );
 
     poDriver->pfnOpen = LANDataset::Open;
     poDriver->pfnCreate = LANDataset::Create;
+    poDriver->pfnInitMetadata = LANDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1668,26 +1668,16 @@ const char *LCPDataset::GetProjectionRef()
 }
 
 /************************************************************************/
-/*                         GDALRegister_LCP()                           */
+/*                       LCPDriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_LCP()
+static void LCPDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "LCP" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "LCP" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "FARSITE v.4 Landscape File (.lcp)" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "lcp" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_lcp.html" );
-
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Int16" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
@@ -1749,10 +1739,29 @@ void GDALRegister_LCP()
 "   <Option name='LATITUDE' type='int' default='' description='Set the latitude for the dataset, this overrides the driver trying to set it programmatically in EPSG:4269'/>"
 "   <Option name='DESCRIPTION' type='string' default='LCP file created by GDAL' description='A short description of the lcp file'/>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_LCP()                           */
+/************************************************************************/
+
+void GDALRegister_LCP()
+
+{
+    if( GDALGetDriverByName( "LCP" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "LCP" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
+
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = LCPDataset::Open;
     poDriver->pfnCreateCopy = LCPDataset::CreateCopy;
     poDriver->pfnIdentify = LCPDataset::Identify;
+    poDriver->pfnInitMetadata = LCPDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
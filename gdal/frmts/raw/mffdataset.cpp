@@ -1561,6 +1561,20 @@ MFFDataset::CreateCopy( const char * pszFilename,
 }
 
 
+/************************************************************************/
+/*                       MFFDriverInitMetadata()                        */
+/************************************************************************/
+
+static void MFFDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Vexcel MFF Raster" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#MFF" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "hdr" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte UInt16 Float32 CInt16 CFloat32" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_MFF()                           */
 /************************************************************************/
@@ -1575,17 +1589,13 @@ void GDALRegister_MFF()
 
     poDriver->SetDescription( "MFF" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Vexcel MFF Raster" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#MFF" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "hdr" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte UInt16 Float32 CInt16 CFloat32" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = MFFDataset::Open;
     poDriver->pfnCreate = MFFDataset::Create;
     poDriver->pfnCreateCopy = MFFDataset::CreateCopy;
+    poDriver->pfnInitMetadata = MFFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
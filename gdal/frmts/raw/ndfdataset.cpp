@@ -418,6 +418,17 @@ GDALDataset *NDFDataset::Open( GDALOpenInfo * poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                       NDFDriverInitMetadata()                        */
+/************************************************************************/
+
+static void NDFDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "NLAPS Data Format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#NDF" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_NDF()                          */
 /************************************************************************/
@@ -432,11 +443,10 @@ void GDALRegister_NDF()
 
     poDriver->SetDescription( "NDF" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "NLAPS Data Format" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#NDF" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = NDFDataset::Open;
+    poDriver->pfnInitMetadata = NDFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -923,6 +923,19 @@ GDALDataset *NTv2Dataset::Create( const char * pszFilename,
         GDALOpen( osSubDSName, GA_Update ) );
 }
 
+/************************************************************************/
+/*                       NTv2DriverInitMetadata()                       */
+/************************************************************************/
+
+static void NTv2DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "NTv2 Datum Grid Shift" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gsb" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Float32" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_NTv2()                          */
 /************************************************************************/
@@ -937,15 +950,12 @@ void GDALRegister_NTv2()
 
     poDriver->SetDescription( "NTv2" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "NTv2 Datum Grid Shift" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gsb" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Float32" );
 
     poDriver->pfnOpen = NTv2Dataset::Open;
     poDriver->pfnIdentify = NTv2Dataset::Identify;
     poDriver->pfnCreate = NTv2Dataset::Create;
+    poDriver->pfnInitMetadata = NTv2DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
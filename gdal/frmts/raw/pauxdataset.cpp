@@ -1056,19 +1056,12 @@ static CPLErr PAuxDelete( const char * pszBasename )
 }
 
 /************************************************************************/
-/*                         GDALRegister_PAux()                          */
+/*                       PAuxDriverInitMetadata()                       */
 /************************************************************************/
 
-void GDALRegister_PAux()
+static void PAuxDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "PAux" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "PAux" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "PCI .aux Labelled" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#PAux" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
@@ -1081,10 +1074,27 @@ void GDALRegister_PAux()
 "       <Value>PIXEL</Value>"
 "   </Option>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_PAux()                          */
+/************************************************************************/
+
+void GDALRegister_PAux()
+
+{
+    if( GDALGetDriverByName( "PAux" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "PAux" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 
     poDriver->pfnOpen = PAuxDataset::Open;
     poDriver->pfnCreate = PAuxDataset::Create;
     poDriver->pfnDelete = PAuxDelete;
+    poDriver->pfnInitMetadata = PAuxDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
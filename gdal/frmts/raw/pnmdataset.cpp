@@ -406,19 +406,12 @@ GDALDataset *PNMDataset::Create( const char * pszFilename,
 }
 
 /************************************************************************/
-/*                         GDALRegister_PNM()                           */
+/*                       PNMDriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_PNM()
+static void PNMDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "PNM" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "PNM" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "Portable Pixmap Format (netpbm)" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#PNM" );
@@ -429,11 +422,28 @@ void GDALRegister_PNM()
 "<CreationOptionList>"
 "   <Option name='MAXVAL' type='unsigned int' description='Maximum color value'/>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                         GDALRegister_PNM()                           */
+/************************************************************************/
+
+void GDALRegister_PNM()
+
+{
+    if( GDALGetDriverByName( "PNM" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "PNM" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = PNMDataset::Open;
     poDriver->pfnCreate = PNMDataset::Create;
     poDriver->pfnIdentify = PNMDataset::Identify;
+    poDriver->pfnInitMetadata = PNMDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -849,6 +849,18 @@ ROIPACRasterBand::ROIPACRasterBand( GDALDataset *poDSIn, int nBandIn, void *fpRa
 {
 }
 
+/************************************************************************/
+/*                      ROIPACDriverInitMetadata()                      */
+/************************************************************************/
+
+static void ROIPACDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ROI_PAC raster" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "frmt_various.html#ROI_PAC" );
+}
+
 /************************************************************************/
 /*                        GDALRegister_ROIPAC()                         */
 /************************************************************************/
@@ -864,15 +876,13 @@ void GDALRegister_ROIPAC()
     GDALDriver *poDriver = new GDALDriver();
 
     poDriver->SetDescription( "ROI_PAC" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ROI_PAC raster" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "frmt_various.html#ROI_PAC" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ROIPACDataset::Open;
     poDriver->pfnIdentify = ROIPACDataset::Identify;
     poDriver->pfnCreate = ROIPACDataset::Create;
+    poDriver->pfnInitMetadata = ROIPACDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
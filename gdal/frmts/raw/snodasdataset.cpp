@@ -483,6 +483,19 @@ GDALDataset *SNODASDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                      SNODASDriverInitMetadata()                      */
+/************************************************************************/
+
+static void SNODASDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Snow Data Assimilation System" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#SNODAS" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "hdr" );
+}
+
 /************************************************************************/
 /*                       GDALRegister_SNODAS()                          */
 /************************************************************************/
@@ -497,14 +510,11 @@ void GDALRegister_SNODAS()
 
     poDriver->SetDescription( "SNODAS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Snow Data Assimilation System" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#SNODAS" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "hdr" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = SNODASDataset::Open;
     poDriver->pfnIdentify = SNODASDataset::Identify;
+    poDriver->pfnInitMetadata = SNODASDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
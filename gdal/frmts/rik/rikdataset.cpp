@@ -1239,6 +1239,18 @@ GDALDataset *RIKDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                       RIKDriverInitMetadata()                        */
+/************************************************************************/
+
+static void RIKDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Swedish Grid RIK (.rik)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#RIK" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "rik" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_RIK()                          */
 /************************************************************************/
@@ -1253,13 +1265,11 @@ void GDALRegister_RIK()
 
     poDriver->SetDescription( "RIK" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Swedish Grid RIK (.rik)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#RIK" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "rik" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = RIKDataset::Open;
     poDriver->pfnIdentify = RIKDataset::Identify;
+    poDriver->pfnInitMetadata = RIKDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
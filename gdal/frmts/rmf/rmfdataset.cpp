@@ -1862,19 +1862,12 @@ GDALDataset *RMFDataset::Create( const char * pszFilename,
 }
 
 /************************************************************************/
-/*                        GDALRegister_RMF()                            */
+/*                       RMFDriverInitMetadata()                        */
 /************************************************************************/
 
-void GDALRegister_RMF()
+static void RMFDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "RMF" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "RMF" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Raster Matrix Format" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_rmf.html" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "rsw" );
@@ -1886,11 +1879,28 @@ void GDALRegister_RMF()
 "   <Option name='BLOCKXSIZE' type='int' description='Tile Width'/>"
 "   <Option name='BLOCKYSIZE' type='int' description='Tile Height'/>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                        GDALRegister_RMF()                            */
+/************************************************************************/
+
+void GDALRegister_RMF()
+
+{
+    if( GDALGetDriverByName( "RMF" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "RMF" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnIdentify = RMFDataset::Identify;
     poDriver->pfnOpen = RMFDataset::Open;
     poDriver->pfnCreate = RMFDataset::Create;
+    poDriver->pfnInitMetadata = RMFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1461,6 +1461,18 @@ char **RS2Dataset::GetMetadata( const char *pszDomain )
     return GDALDataset::GetMetadata( pszDomain );
 }
 
+/************************************************************************/
+/*                       RS2DriverInitMetadata()                        */
+/************************************************************************/
+
+static void RS2DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "RadarSat 2 XML Product" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_rs2.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_RS2()                          */
 /************************************************************************/
@@ -1475,12 +1487,10 @@ void GDALRegister_RS2()
 
     poDriver->SetDescription( "RS2" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "RadarSat 2 XML Product" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_rs2.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
 
     poDriver->pfnOpen = RS2Dataset::Open;
     poDriver->pfnIdentify = RS2Dataset::Identify;
+    poDriver->pfnInitMetadata = RS2DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1070,6 +1070,19 @@ char **SAFEDataset::GetMetadata( const char *pszDomain )
 }
 #endif
 
+/************************************************************************/
+/*                       SAFEDriverInitMetadata()                       */
+/************************************************************************/
+
+static void SAFEDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Sentinel-1 SAR SAFE Product" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_safe.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "NO" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_SAFE()                          */
 /************************************************************************/
@@ -1084,13 +1097,10 @@ void GDALRegister_SAFE()
     poDriver->SetDescription( "SAFE" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Sentinel-1 SAR SAFE Product" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_safe.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "NO" );
 
     poDriver->pfnOpen = SAFEDataset::Open;
     poDriver->pfnIdentify = SAFEDataset::Identify;
+    poDriver->pfnInitMetadata = SAFEDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1045,6 +1045,21 @@ GDALDataset *SAGADataset::CreateCopy( const char *pszFilename,
     return poDstDS;
 }
 
+/************************************************************************/
+/*                       SAGADriverInitMetadata()                       */
+/************************************************************************/
+
+static void SAGADriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "SAGA GIS Binary Grid (.sdat)" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#SAGA" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "sdat" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte Int16 "
+                               "UInt16 Int32 UInt32 Float32 Float64" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_SAGA()                         */
 /************************************************************************/
@@ -1059,18 +1074,13 @@ void GDALRegister_SAGA()
 
     poDriver->SetDescription( "SAGA" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "SAGA GIS Binary Grid (.sdat)" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#SAGA" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "sdat" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte Int16 "
-                               "UInt16 Int32 UInt32 Float32 Float64" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = SAGADataset::Open;
     poDriver->pfnCreate = SAGADataset::Create;
     poDriver->pfnCreateCopy = SAGADataset::CreateCopy;
+    poDriver->pfnInitMetadata = SAGADriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -381,6 +381,18 @@ const char *SDTSRasterBand::GetUnitType()
     return poRL->szUNITS;
 }
 
+/************************************************************************/
+/*                       SDTSDriverInitMetadata()                       */
+/************************************************************************/
+
+static void SDTSDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "SDTS Raster" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#SDTS" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ddf" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_SDTS()                          */
 /************************************************************************/
@@ -395,12 +407,10 @@ void GDALRegister_SDTS()
 
     poDriver->SetDescription( "SDTS" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "SDTS Raster" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#SDTS" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ddf" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = SDTSDataset::Open;
+    poDriver->pfnInitMetadata = SDTSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
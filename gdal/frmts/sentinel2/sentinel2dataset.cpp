@@ -3197,6 +3197,18 @@ GDALDataset* SENTINEL2Dataset::OpenL1CTileSubdataset( GDALOpenInfo * poOpenInfo
     return poDS;
 }
 
+/************************************************************************/
+/*                    SENTINEL2DriverInitMetadata()                     */
+/************************************************************************/
+
+static void SENTINEL2DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Sentinel 2" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_sentinel2.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+}
+
 /************************************************************************/
 /*                      GDALRegister_SENTINEL2()                        */
 /************************************************************************/
@@ -3213,9 +3225,6 @@ void GDALRegister_SENTINEL2()
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
 #endif
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Sentinel 2" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_sentinel2.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
 
 #ifdef GDAL_DMD_OPENOPTIONLIST
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
@@ -3226,6 +3235,7 @@ void GDALRegister_SENTINEL2()
 
     poDriver->pfnOpen = SENTINEL2Dataset::Open;
     poDriver->pfnIdentify = SENTINEL2Dataset::Identify;
+    poDriver->pfnInitMetadata = SENTINEL2DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
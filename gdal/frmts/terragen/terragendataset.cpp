@@ -1091,6 +1091,23 @@ GDALDataset *TerragenDataset::Open( GDALOpenInfo * poOpenInfo )
     return( poDS );
 }
 
+/************************************************************************/
+/*                     TerragenDriverInitMetadata()                     */
+/************************************************************************/
+
+static void TerragenDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ter" );
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Terragen heightfield" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_terragen.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
+"<CreationOptionList>"
+"   <Option name='MINUSERPIXELVALUE' type='float' description='Lowest logical elevation'/>"
+"   <Option name='MAXUSERPIXELVALUE' type='float' description='Highest logical elevation'/>"
+"</CreationOptionList>" );
+}
+
 /************************************************************************/
 /*                        GDALRegister_Terragen()                       */
 /************************************************************************/
@@ -1105,18 +1122,10 @@ void GDALRegister_Terragen()
 
     poDriver->SetDescription( "Terragen" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "ter" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Terragen heightfield" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_terragen.html" );
-
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
-"<CreationOptionList>"
-"   <Option name='MINUSERPIXELVALUE' type='float' description='Lowest logical elevation'/>"
-"   <Option name='MAXUSERPIXELVALUE' type='float' description='Highest logical elevation'/>"
-"</CreationOptionList>" );
 
     poDriver->pfnOpen = TerragenDataset::Open;
     poDriver->pfnCreate = TerragenDataset::Create;
+    poDriver->pfnInitMetadata = TerragenDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
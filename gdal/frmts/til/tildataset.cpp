@@ -479,6 +479,17 @@ char **TILDataset::GetFileList()
     return papszFileList;
 }
 
+/************************************************************************/
+/*                       TILDriverInitMetadata()                        */
+/************************************************************************/
+
+static void TILDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "EarthWatch .TIL" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_til.html" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_TIL()                          */
 /************************************************************************/
@@ -493,12 +504,11 @@ void GDALRegister_TIL()
 
     poDriver->SetDescription( "TIL" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "EarthWatch .TIL" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_til.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = TILDataset::Open;
     poDriver->pfnIdentify = TILDataset::Identify;
+    poDriver->pfnInitMetadata = TILDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -848,19 +848,12 @@ GDALDataset *USGSDEMDataset::Open( GDALOpenInfo * poOpenInfo )
 }
 
 /************************************************************************/
-/*                        GDALRegister_USGSDEM()                        */
+/*                     USGSDEMDriverInitMetadata()                      */
 /************************************************************************/
 
-void GDALRegister_USGSDEM()
+static void USGSDEMDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "USGSDEM" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "USGSDEM" );
-    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "dem" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "USGS Optional ASCII DEM (and CDED)" );
@@ -889,11 +882,28 @@ void GDALRegister_USGSDEM()
 "   <Option name='NTS' type='string' description='NTS Mapsheet name, used to derive TOPLEFT.'/>"
 "   <Option name='INTERNALNAME' type='string' description='Dataset name written into file header.'/>"
 "</CreationOptionList>" );
+}
+
+/************************************************************************/
+/*                        GDALRegister_USGSDEM()                        */
+/************************************************************************/
+
+void GDALRegister_USGSDEM()
+
+{
+    if( GDALGetDriverByName( "USGSDEM" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "USGSDEM" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = USGSDEMDataset::Open;
     poDriver->pfnCreateCopy = USGSDEMCreateCopy;
     poDriver->pfnIdentify = USGSDEMDataset::Identify;
+    poDriver->pfnInitMetadata = USGSDEMDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -351,6 +351,27 @@ VRTCreateCopy( const char * pszFilename,
     return poVRTDS;
 }
 
+/************************************************************************/
+/*                       VRTDriverInitMetadata()                        */
+/************************************************************************/
+
+static void VRTDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Virtual Raster" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "vrt" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "gdal_vrttut.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
+                               "Byte Int16 UInt16 Int32 UInt32 Float32 Float64 "
+                               "CInt16 CInt32 CFloat32 CFloat64" );
+    poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
+"<OptionList>"
+"  <on name='ROOT_PATH' type='string' description='Root path to evaluate "
+"relative paths inside the VRT. Mainly useful for inlined VRT, or in-memory "
+"VRT, where their own directory does not make sense'/>"
+"</OptionList>" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_VRT()                          */
 /************************************************************************/
@@ -365,12 +386,6 @@ void GDALRegister_VRT()
 
     poDriver->SetDescription( "VRT" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Virtual Raster" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "vrt" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "gdal_vrttut.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
-                               "Byte Int16 UInt16 Int32 UInt32 Float32 Float64 "
-                               "CInt16 CInt32 CFloat32 CFloat64" );
 
     poDriver->pfnOpen = VRTDataset::Open;
     poDriver->pfnCreateCopy = VRTCreateCopy;
@@ -378,19 +393,13 @@ void GDALRegister_VRT()
     poDriver->pfnIdentify = VRTDataset::Identify;
     poDriver->pfnDelete = VRTDataset::Delete;
 
-    poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
-"<OptionList>"
-"  <on name='ROOT_PATH' type='string' description='Root path to evaluate "
-"relative paths inside the VRT. Mainly useful for inlined VRT, or in-memory "
-"VRT, where their own directory does not make sense'/>"
-"</OptionList>" );
-
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->AddSourceParser( "SimpleSource", VRTParseCoreSources );
     poDriver->AddSourceParser( "ComplexSource", VRTParseCoreSources );
     poDriver->AddSourceParser( "AveragedSource", VRTParseCoreSources );
     poDriver->AddSourceParser( "KernelFilteredSource", VRTParseFilterSources );
+    poDriver->pfnInitMetadata = VRTDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
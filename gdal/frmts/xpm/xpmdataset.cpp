@@ -423,6 +423,20 @@ XPMCreateCopy( const char * pszFilename,
     return poDS;
 }
 
+/************************************************************************/
+/*                       XPMDriverInitMetadata()                        */
+/************************************************************************/
+
+static void XPMDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "X11 PixMap Format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#XPM" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "xpm" );
+    poDriver->SetMetadataItem( GDAL_DMD_MIMETYPE, "image/x-xpixmap" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte" );
+}
+
 /************************************************************************/
 /*                          GDALRegister_XPM()                          */
 /************************************************************************/
@@ -437,16 +451,12 @@ void GDALRegister_XPM()
 
     poDriver->SetDescription( "XPM" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "X11 PixMap Format" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#XPM" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "xpm" );
-    poDriver->SetMetadataItem( GDAL_DMD_MIMETYPE, "image/x-xpixmap" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES, "Byte" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = XPMDataset::Open;
     poDriver->pfnIdentify = XPMDataset::Identify;
     poDriver->pfnCreateCopy = XPMCreateCopy;
+    poDriver->pfnInitMetadata = XPMDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1238,6 +1238,23 @@ CPLErr XYZDataset::GetGeoTransform( double * padfTransform )
     return( CE_None );
 }
 
+/************************************************************************/
+/*                       XYZDriverInitMetadata()                        */
+/************************************************************************/
+
+static void XYZDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ASCII Gridded XYZ" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_xyz.html" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "xyz" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
+"<CreationOptionList>"
+"   <Option name='COLUMN_SEPARATOR' type='string' default=' ' description='Separator between fields.'/>"
+"   <Option name='ADD_HEADER_LINE' type='boolean' default='false' description='Add an header line with column names.'/>"
+"</CreationOptionList>");
+}
+
 /************************************************************************/
 /*                         GDALRegister_XYZ()                           */
 /************************************************************************/
@@ -1252,20 +1269,13 @@ void GDALRegister_XYZ()
 
     poDriver->SetDescription( "XYZ" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ASCII Gridded XYZ" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_xyz.html" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "xyz" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
-"<CreationOptionList>"
-"   <Option name='COLUMN_SEPARATOR' type='string' default=' ' description='Separator between fields.'/>"
-"   <Option name='ADD_HEADER_LINE' type='boolean' default='false' description='Add an header line with column names.'/>"
-"</CreationOptionList>");
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = XYZDataset::Open;
     poDriver->pfnIdentify = XYZDataset::Identify;
     poDriver->pfnCreateCopy = XYZDataset::CreateCopy;
+    poDriver->pfnInitMetadata = XYZDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
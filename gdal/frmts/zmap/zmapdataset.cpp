@@ -692,6 +692,18 @@ CPLErr ZMapDataset::GetGeoTransform( double * padfTransform )
     return( CE_None );
 }
 
+/************************************************************************/
+/*                       ZMapDriverInitMetadata()                       */
+/************************************************************************/
+
+static void ZMapDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ZMap Plus Grid" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#ZMap" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "dat" );
+}
+
 /************************************************************************/
 /*                         GDALRegister_ZMap()                          */
 /************************************************************************/
@@ -706,14 +718,12 @@ void GDALRegister_ZMap()
 
     poDriver->SetDescription( "ZMap" );
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ZMap Plus Grid" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_various.html#ZMap" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "dat" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = ZMapDataset::Open;
     poDriver->pfnIdentify = ZMapDataset::Identify;
     poDriver->pfnCreateCopy = ZMapDataset::CreateCopy;
+    poDriver->pfnInitMetadata = ZMapDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -272,6 +272,13 @@ typedef GIntBig GSpacing;
  */
 #define GDAL_DMD_EXTENSIONS "DMD_EXTENSIONS"
 
+/** List of (space separated) signatures, as hexadecimal strings, one of
+ * which the first bytes of any file opened by the driver must match. Used
+ * by GDALOpenEx() to skip the driver for files that do not match them.
+ * @since GDAL 2.2
+ */
+#define GDAL_DMD_SIGNATURES "DMD_SIGNATURES"
+
 /** XML snippet with creation options. */
 #define GDAL_DMD_CREATIONOPTIONLIST "DMD_CREATIONOPTIONLIST"
 
@@ -739,6 +746,15 @@ CPLErr CPL_DLL CPL_STDCALL GDALComputeRasterStatistics(
     GDALRasterBandH, int bApproxOK,
     double *pdfMin, double *pdfMax, double *pdfMean, double *pdfStdDev,
     GDALProgressFunc pfnProgress, void *pProgressData );
+CPLErr CPL_DLL CPL_STDCALL GDALComputeRasterSampledStatistics(
+    GDALRasterBandH, GIntBig nTargetSampleCount,
+    double *pdfMin, double *pdfMax, double *pdfMean, double *pdfStdDev,
+    double *pdfMeanError, double *pdfStdDevError,
+    GDALProgressFunc pfnProgress, void *pProgressData );
+CPLErr CPL_DLL CPL_STDCALL GDALGetRasterApproxQuantiles(
+    GDALRasterBandH, int nQuantiles, const double *padfProbabilities,
+    double *padfQuantiles, int bForce,
+    GDALProgressFunc pfnProgress, void *pProgressData );
 CPLErr CPL_DLL CPL_STDCALL GDALSetRasterStatistics(
     GDALRasterBandH hBand,
     double dfMin, double dfMax, double dfMean, double dfStdDev );
@@ -1061,6 +1077,51 @@ GIntBig CPL_DLL CPL_STDCALL GDALGetCacheUsed64(void);
 
 int CPL_DLL CPL_STDCALL GDALFlushCacheBlock(void);
 
+/*! Priority class of the blocks of a dataset in the block cache */
+typedef enum {
+    /*! Blocks evicted before those of the other classes */ GCPRIO_LOW = 0,
+    /*! Default priority */                                 GCPRIO_NORMAL = 1,
+    /*! Blocks evicted after those of the other classes */  GCPRIO_HIGH = 2
+} GDALCachePriority;
+
+void CPL_DLL GDALDatasetSetCacheQuota( GDALDatasetH hDS, GIntBig nQuotaInBytes );
+GIntBig CPL_DLL GDALDatasetGetCacheQuota( GDALDatasetH hDS );
+void CPL_DLL GDALDatasetSetCachePriority( GDALDatasetH hDS,
+                                          GDALCachePriority ePriority );
+GDALCachePriority CPL_DLL GDALDatasetGetCachePriority( GDALDatasetH hDS );
+GIntBig CPL_DLL GDALDatasetGetCacheUsed( GDALDatasetH hDS );
+
+/*! Block cache statistics, see GDALGetCacheStatistics() */
+typedef struct
+{
+    /*! Number of block requests served from the cache */
+    GIntBig nHits;
+    /*! Number of blocks loaded in the cache */
+    GIntBig nMisses;
+    /*! Number of bytes read by IReadBlock() to load blocks */
+    GIntBig nBytesRead;
+    /*! Number of blocks evicted from the cache to make room for others */
+    GIntBig nEvictions;
+    /*! Number of dirty blocks written back with IWriteBlock() */
+    GIntBig nDirtyFlushes;
+    /*! Time spent waiting for the locks of the cache, in microseconds.
+        Only measured when the GDAL_CACHE_STATS configuration option is set */
+    GIntBig nLockWaitMicroSec;
+} GDALCacheStatistics;
+
+void CPL_DLL GDALGetCacheStatistics( GDALCacheStatistics* psStats );
+void CPL_DLL GDALResetCacheStatistics( void );
+void CPL_DLL CPL_STDCALL GDALGetRasterBandCacheStatistics( GDALRasterBandH hBand,
+                                                           GDALCacheStatistics* psStats );
+const void CPL_DLL * CPL_STDCALL
+GDALRasterBandGetLockedWindow( GDALRasterBandH hBand,
+                               int nXOff, int nYOff,
+                               int nXSize, int nYSize,
+                               GSpacing* pnPixelSpace,
+                               GSpacing* pnLineSpace,
+                               void** phLock ) CPL_WARN_UNUSED_RESULT;
+void CPL_DLL CPL_STDCALL GDALRasterBandReleaseLockedWindow( void* hLock );
+
 /* ==================================================================== */
 /*      GDAL virtual memory                                             */
 /* ==================================================================== */
@@ -2317,6 +2317,7 @@ void GDALComposeGeoTransforms(const double *padfGT1, const double *padfGT2,
  *  --optfile filename: expand an option file into the argument list.
  *  --config key value: set system configuration option.
  *  --debug [on/off/value]: set debug level.
+ *  --cache-stats: report block cache statistics on exit (with --debug on).
  *  --mempreload dir: preload directory contents into /vsimem
  *  --pause: Pause for user input (allows time to attach debugger)
  *  --locale [locale]: Install a locale using setlocale() (debugging)
@@ -2486,6 +2487,14 @@ GDALGeneralCmdLineProcessor( int nArgc, char ***ppapszArgv, int nOptions )
             iArg += 1;
         }
 
+/* -------------------------------------------------------------------- */
+/*      --cache-stats                                                   */
+/* -------------------------------------------------------------------- */
+        else if( EQUAL(papszArgv[iArg],"--cache-stats") )
+        {
+            CPLSetConfigOption( "GDAL_CACHE_STATS", "YES" );
+        }
+
 /* -------------------------------------------------------------------- */
 /*      --optfile                                                       */
 /*                                                                      */
@@ -2738,6 +2747,7 @@ GDALGeneralCmdLineProcessor( int nArgc, char ***ppapszArgv, int nOptions )
             printf( "  --optfile filename: expand an option file into the argument list.\n" );
             printf( "  --config key value: set system configuration option.\n" );
             printf( "  --debug [on/off/value]: set debug level.\n" );
+            printf( "  --cache-stats: report block cache statistics on exit (with --debug on).\n" );
             printf( "  --pause: wait for user input, time to attach debugger\n" );
             printf( "  --locale [locale]: install locale for debugging "
                     "(i.e. en_US.UTF-8)\n" );
@@ -3438,3 +3448,23 @@ int GDALCanFileAcceptSidecarFile(const char* pszFilename)
         return FALSE;
     return TRUE;
 }
+
+/************************************************************************/
+/*                          GDALGetNumThreads()                         */
+/*                                                                      */
+/*      Number of worker threads requested with the GDAL_NUM_THREADS    */
+/*      configuration option (a number or ALL_CPUS), at most 128.      */
+/************************************************************************/
+
+int GDALGetNumThreads()
+{
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads;
+    if( EQUAL(pszNumThreads, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszNumThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    return nThreads;
+}
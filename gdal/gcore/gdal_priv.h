@@ -50,6 +50,7 @@ class GDALRasterAttributeTable;
 class GDALProxyDataset;
 class GDALProxyRasterBand;
 class GDALAsyncReader;
+struct GDALBlockPrefetchState;
 
 /* -------------------------------------------------------------------- */
 /*      Pull in the public declarations.  This gets the C apis, and     */
@@ -306,9 +307,17 @@ class CPL_DLL GDALDataset : public GDALMajorObject
     friend class GDALDefaultOverviews;
     friend class GDALProxyDataset;
     friend class GDALDriverManager;
+    friend class GDALRasterBlock;
+    friend class GDALBlockPrefetcher;
 
     void AddToDatasetOpenList();
 
+    void UpdateCacheUsed( GIntBig nDelta );
+
+    GDALBlockPrefetchState* GetPrefetchState();
+    void SetPrefetchState( GDALBlockPrefetchState* psState );
+    GDALDataset* GetFileHandleOwner();
+
     void           Init(int bForceCachedIO);
 
   protected:
@@ -334,6 +343,7 @@ class CPL_DLL GDALDataset : public GDALMajorObject
 
     void        RasterInitialize( int, int );
     void        SetBand( int, GDALRasterBand * );
+    void        SetFileHandleOwner( GDALDataset* poOwnerDS );
 
     GDALDefaultOverviews oOvManager;
 
@@ -481,6 +491,12 @@ class CPL_DLL GDALDataset : public GDALMajorObject
 
     char        **GetOpenOptions() { return papszOpenOptions; }
 
+    void          SetCacheQuota( GIntBig nQuotaInBytes );
+    GIntBig       GetCacheQuota();
+    void          SetCachePriority( GDALCachePriority ePriority );
+    GDALCachePriority GetCachePriority();
+    GIntBig       GetCacheUsed();
+
     static GDALDataset **GetOpenDatasets( int *pnDatasetCount );
 
     CPLErr BuildOverviews( const char *, int, int *,
@@ -574,6 +590,7 @@ private:
 class CPL_DLL GDALRasterBlock
 {
     friend class GDALAbstractBandBlockCache;
+    friend class GDALRasterBlockCachePolicy;
 
     GDALDataType        eType;
 
@@ -593,10 +610,38 @@ class CPL_DLL GDALRasterBlock
     GDALRasterBlock     *poNext;
     GDALRasterBlock     *poPrevious;
 
-    int                  bMustDetach;
+    /* Written with the lock of the cache shard held, and read with */
+    /* CPLAtomicAdd() by the lock-free cache hit path of TakeLock() */
+    volatile int         bMustDetach;
+
+    /* Private state of the eviction policy of the global block cache */
+    int                  nPolicyState;
 
+    /* Priority class under which the block is accounted in its cache */
+    /* shard, or -1 if it is not in the cache */
+    int                  nCachePriority;
+
+    /* TRUE if pData was allocated with CPLVirtualMemSharedPagesAlloc() */
+    int                  bSharedMemory;
+
+    /* Set with CPLAtomicCompareAndExchange() without the lock of the cache */
+    /* shard when the block is used again while cached (GDAL_RB_LOCK_FREE_HITS */
+    /* mode), and cleared the same way by the eviction policy under that lock */
+    volatile int         bTouchDeferred;
+
+    void        FreeData( void );
     void        Detach_unlocked( void );
     void        Touch_unlocked( void );
+    void        Attach_unlocked( void );
+    void        UpdateCachePriority_unlocked( void );
+    GIntBig     GetBandCacheId() const;
+    void        Evict_unlocked( void );
+
+    static int  EvictOverQuota( GDALDataset* poDS,
+                                GDALRasterBlock** papoBlocksToFree,
+                                int* pnBlocksToFree, int nMaxBlocksToFree );
+    static void FreeEvictedBlocks( GDALRasterBlock** papoBlocks, int nBlocks,
+                                   void** ppRecycledData, int nRecycledSize );
 
     void        RecycleFor( int nXOffIn, int nYOffIn );
 
@@ -621,6 +666,7 @@ class CPL_DLL GDALRasterBlock
     int         GetXSize() const { return nXSize; }
     int         GetYSize() const { return nYSize; }
     int         GetDirty() const { return bDirty; }
+    int         HasSharedMemory() const { return bSharedMemory; }
 
     void        *GetDataRef( void ) { return pData; }
     int          GetBlockSize() const {
@@ -628,6 +674,7 @@ class CPL_DLL GDALRasterBlock
 
     int          TakeLock();
     int          DropLockForRemovalFromStorage();
+    void         RecordCacheHit();
 
     /// @brief Accessor to source GDALRasterBand object.
     /// @return source raster band of the raster block.
@@ -636,6 +683,9 @@ class CPL_DLL GDALRasterBlock
     static void FlushDirtyBlocks();
     static int  FlushCacheBlock(int bDirtyBlocksOnly = FALSE);
     static void Verify();
+    static void GetCacheStatistics( GDALCacheStatistics* psStats );
+    static void ResetCacheStatistics();
+    static void EnforceCacheQuota( GDALDataset* poDS );
 
 #ifdef notdef
     static void CheckNonOrphanedBlocks(GDALRasterBand* poBand);
@@ -698,6 +748,20 @@ class CPL_DLL GDALAbstractBandBlockCache
         CPLMutex         *hCondMutex;
         volatile int      nKeepAliveCounter;
 
+        // Cache statistics of the band, updated with atomic operations
+        volatile GIntBig  nHits;
+        volatile GIntBig  nMisses;
+        volatile GIntBig  nBytesRead;
+        volatile GIntBig  nEvictions;
+        volatile GIntBig  nDirtyFlushes;
+        volatile GIntBig  nLockWaitMicroSec;
+
+        // Number of virtual memory views mapping the blocks of the band
+        volatile int      nSharedMemoryViews;
+
+        // Identifier of the band cache, never reused in the process
+        GIntBig           nId;
+
     protected:
         GDALRasterBand   *poBand;
 
@@ -712,6 +776,22 @@ class CPL_DLL GDALAbstractBandBlockCache
             GDALRasterBlock* CreateBlock(int nXBlockOff, int nYBlockOff);
             void             AddBlockToFreeList( GDALRasterBlock * );
 
+            void             RecordHit();
+            void             RecordMiss();
+            void             RecordBlockRead( int nBytes );
+            void             RecordEviction();
+            void             RecordDirtyFlush();
+            void             RecordLockWait( GIntBig nMicroSec );
+            void             GetStatistics( GDALCacheStatistics* psStats );
+
+            void             AddSharedMemoryView();
+            void             RemoveSharedMemoryView();
+            bool             HasSharedMemoryViews() const { return nSharedMemoryViews > 0; }
+            GIntBig          GetId() const { return nId; }
+
+            static void      RecordGlobalLockWait( GIntBig nMicroSec );
+            static void      GetGlobalStatistics( GDALCacheStatistics* psStats );
+
             virtual bool             Init() = 0;
             virtual bool             IsInitOK() = 0;
             virtual CPLErr           FlushCache() = 0;
@@ -726,6 +806,100 @@ class CPL_DLL GDALAbstractBandBlockCache
 GDALAbstractBandBlockCache* GDALArrayBandBlockCacheCreate(GDALRasterBand* poBand);
 GDALAbstractBandBlockCache* GDALHashSetBandBlockCacheCreate(GDALRasterBand* poBand);
 
+/* ******************************************************************** */
+/*                          GDALBlockPrefetcher                         */
+/* ******************************************************************** */
+
+//! Reads blocks into the block cache ahead of their use, from worker threads.
+// This is a private concept only used by GDALRasterBand, GDALDataset and
+// GDALDriverManager implementations.
+
+class CPL_DLL GDALBlockPrefetcher
+{
+        static void      ReadBlock( GDALBlockPrefetchState* psState,
+                                    GDALRasterBand* poBand,
+                                    int nXBlockOff, int nYBlockOff );
+        static void      JobFunc( void* pData );
+        static GDALBlockPrefetchState* GetState( GDALRasterBand* poBand );
+
+    public:
+        static bool      IsEnabled();
+        static void      PrefetchWindow( GDALRasterBand* poBand,
+                                         int nXOff, int nYOff,
+                                         int nXSize, int nYSize );
+        static void      NotifyRasterIO( GDALRasterBand* poBand,
+                                         int nXOff, int nYOff,
+                                         int nXSize, int nYSize );
+
+        static int       EnterDataset( GDALDataset* poDS );
+        static int       LeaveDataset( GDALDataset* poDS );
+        static void      CancelDataset( GDALDataset* poDS );
+        static void      DetachDataset( GDALDataset* poDS );
+        static void      ReleaseDataset( GDALDataset* poDS );
+
+        /* Should only be called by GDALDestroyDriverManager() */
+        static void      Cleanup();
+};
+
+/* ******************************************************************** */
+/*                       GDALRasterBlockAllocator                       */
+/* ******************************************************************** */
+
+//! Allocates the data buffers of the blocks of the block cache.
+// Either with VSIMalloc(), or from slabs grouped by size class when
+// GDAL_RB_ALLOCATOR=SLAB. This is a private concept only used by
+// GDALRasterBlock implementation.
+
+class CPL_DLL GDALRasterBlockAllocator
+{
+    public:
+        static void      Initialize();
+        static bool      IsSlabAllocator();
+        static size_t    GetAllocationSize( size_t nSize );
+        static void     *Alloc( size_t nSize );
+        static void      Free( void* pData, size_t nSize );
+        static void      GetStatistics( GIntBig* pnReserved, GIntBig* pnUsed,
+                                        GIntBig* pnRequested );
+
+        /* Should only be called by GDALRasterBlock::DestroyRBMutex() */
+        static void      Cleanup();
+};
+
+/* ******************************************************************** */
+/*                          GDALQuantileSketch                          */
+/* ******************************************************************** */
+
+//! Mergeable sketch of a stream of values, answering approximate quantiles.
+// This is a KLL sketch: values are kept in compactors whose items of level
+// h stand for 2^h values. The rank error is of the order of 1.7 / nK.
+// This is a private concept only used by GDALRasterBand implementations.
+
+class CPL_DLL GDALQuantileSketch
+{
+        int                                 nK;
+        GUIntBig                            nCount;
+        double                              dfMin;
+        double                              dfMax;
+        std::vector< std::vector<double> >  aadfLevels;
+        std::vector<int>                    anOffsets;
+
+        size_t           GetLevelCapacity( size_t iLevel ) const;
+        void             Compress();
+
+    public:
+        explicit         GDALQuantileSketch( int nK = 200 );
+
+        void             Reset();
+        void             Insert( double dfValue );
+        void             Merge( const GDALQuantileSketch& oOther );
+
+        GUIntBig         GetCount() const { return nCount; }
+        double           GetQuantile( double dfProbability ) const;
+
+        CPLString        Serialize() const;
+        bool             Deserialize( const char* pszSketch );
+};
+
 /* ******************************************************************** */
 /*                            GDALRasterBand                            */
 /* ******************************************************************** */
@@ -738,6 +912,8 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
     friend class GDALArrayBandBlockCache;
     friend class GDALHashSetBandBlockCache;
     friend class GDALRasterBlock;
+    friend class GDALBlockPrefetcher;
+    friend class GDALVirtualMemBlockMapper;
 
     CPLErr eFlushBlockErr;
     GDALAbstractBandBlockCache* poBandBlockCache;
@@ -842,7 +1018,13 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
 
     GDALRasterBlock *GetLockedBlockRef( int nXBlockOff, int nYBlockOff,
                                         int bJustInitialize = FALSE ) CPL_WARN_UNUSED_RESULT;
+    const void *GetLockedWindowRef( int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    GSpacing* pnPixelSpace,
+                                    GSpacing* pnLineSpace,
+                                    GDALRasterBlock** ppoBlock ) CPL_WARN_UNUSED_RESULT;
     CPLErr      FlushBlock( int, int, int bWriteDirtyBlock = TRUE );
+    void        GetCacheStatistics( GDALCacheStatistics* psStats );
 
     unsigned char*  GetIndexColorTranslationTo(/* const */ GDALRasterBand* poReferenceBand,
                                                unsigned char* pTranslationTable = NULL,
@@ -881,6 +1063,16 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
     virtual CPLErr SetStatistics( double dfMin, double dfMax,
                                   double dfMean, double dfStdDev );
     virtual CPLErr ComputeRasterMinMax( int, double* );
+    CPLErr ComputeSampledStatistics( GIntBig nTargetSampleCount,
+                                     double *pdfMin, double *pdfMax,
+                                     double *pdfMean, double *pdfStdDev,
+                                     double *pdfMeanError,
+                                     double *pdfStdDevError,
+                                     GDALProgressFunc, void *pProgressData );
+    CPLErr GetApproxQuantiles( int nQuantiles,
+                               const double *padfProbabilities,
+                               double *padfQuantiles, int bForce,
+                               GDALProgressFunc, void *pProgressData );
 
     virtual int HasArbitraryOverviews();
     virtual int GetOverviewCount();
@@ -1037,10 +1229,17 @@ class CPL_DLL GDALDriver : public GDALMajorObject
                         GDALDriver();
                         ~GDALDriver();
 
+    virtual CPLErr      SetMetadata( char ** papszMetadata,
+                                     const char * pszDomain = "" );
     virtual CPLErr      SetMetadataItem( const char * pszName,
                                  const char * pszValue,
                                  const char * pszDomain = "" );
 
+    virtual char      **GetMetadataDomainList();
+    virtual char      **GetMetadata( const char * pszDomain = "" );
+    virtual const char *GetMetadataItem( const char * pszName,
+                                         const char * pszDomain = "" );
+
 /* -------------------------------------------------------------------- */
 /*      Public C++ methods.                                             */
 /* -------------------------------------------------------------------- */
@@ -1104,9 +1303,21 @@ class CPL_DLL GDALDriver : public GDALMajorObject
     CPLErr              (*pfnDeleteDataSource)( GDALDriver*,
                                                  const char * pszName );
 
+    /** Deferred initialization of the descriptive metadata of the driver
+        (long name, help topic, extensions, creation and open option lists...).
+
+        Called at most once, the first time one of those items is requested,
+        so that GDALAllRegister() does not have to build them for all drivers.
+        Capability items (GDAL_DCAP_xxx) and GDAL_DMD_SIGNATURES are needed to
+        dispatch GDALOpenEx() and must still be set before registration.
+    */
+    void                (*pfnInitMetadata)( GDALDriver * );
+
 /* -------------------------------------------------------------------- */
 /*      Helper methods.                                                 */
 /* -------------------------------------------------------------------- */
+    void                InitMetadata();
+
     GDALDataset         *DefaultCreateCopy( const char *, GDALDataset *,
                                             int, char **,
                                             GDALProgressFunc pfnProgress,
@@ -1121,6 +1332,10 @@ class CPL_DLL GDALDriver : public GDALMajorObject
     CPLErr              DefaultCopyFiles( const char * pszNewName,
                                           const char * pszOldName );
 private:
+    // Set, with a memory barrier, once pfnInitMetadata has been run.
+    volatile int        nMetadataInitialized;
+    bool                bInitializingMetadata;
+
     CPL_DISALLOW_COPY_ASSIGN(GDALDriver);
 };
 
@@ -1147,6 +1362,17 @@ class CPL_DLL GDALDriverManager : public GDALMajorObject
     GDALDriver  *GetDriverByName_unlocked( const char * pszName )
             { return oMapNameToDrivers[CPLString(pszName).toupper()]; }
 
+    // Index of the GDAL_DMD_SIGNATURES of the drivers, by first byte,
+    // and whether each driver (in papoDrivers order) declares signatures.
+    std::vector< std::pair<std::string, GDALDriver*> > aoSignatureIndex[256];
+    std::vector<bool> abHasSignatures;
+
+    bool        IndexSignatures_unlocked( GDALDriver * );
+
+    // Whether GDALDriver::pfnInitMetadata is honoured lazily (default)
+    // or run at registration time (GDAL_LAZY_DRIVER_METADATA=NO).
+    bool        bLazyDriverMetadata;
+
  public:
                 GDALDriverManager();
                 ~GDALDriverManager();
@@ -1158,6 +1384,10 @@ class CPL_DLL GDALDriverManager : public GDALMajorObject
     int         RegisterDriver( GDALDriver * );
     void        DeregisterDriver( GDALDriver * );
 
+    void        GetOpenCandidateDrivers( const GByte* pabyHeader,
+                                         int nHeaderBytes,
+                                         std::vector<GDALDriver*>& apoDrivers );
+
     // AutoLoadDrivers is a no-op if compiled with GDAL_NO_AUTOLOAD defined.
     void        AutoLoadDrivers();
     void        AutoSkipDrivers();
@@ -1396,12 +1626,24 @@ void GDALRasterIOExtraArgSetResampleAlg(GDALRasterIOExtraArg* psExtraArg,
 GDALDataset CPL_DLL* GDALCreateOverviewDataset(GDALDataset* poDS, int nOvrLevel,
                                                int bThisLevelOnly, int bOwnDS);
 
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+/* Implemented in rasterioavx2.cpp. Only to be called if the CPU has AVX2 */
+int GDALCopyWordsAVX2( const void * CPL_RESTRICT pSrcData,
+                       GDALDataType eSrcType, int nSrcPixelStride,
+                       void * CPL_RESTRICT pDstData,
+                       GDALDataType eDstType, int nDstPixelStride,
+                       int nWordCount );
+#endif
+
 #define DIV_ROUND_UP(a, b) ( ((a) % (b)) == 0 ? ((a) / (b)) : (((a) / (b)) + 1) )
 
 // Number of data samples that will be used to compute approximate statistics
 // (minimum value, maximum value, etc.)
 #define GDALSTAT_APPROX_NUMSAMPLES 2500
 
+// Default number of pixels sampled by GDALRasterBand::ComputeSampledStatistics()
+#define GDALSTAT_SAMPLED_NUMSAMPLES 1000000
+
 CPL_C_START
 /* Caution: for technical reason this declaration is duplicated in gdal_crs.c */
 /* so any signature change should be reflected there too */
@@ -1420,4 +1662,16 @@ char** GDALDeserializeOpenOptionsFromXML( CPLXMLNode* psParentNode );
 
 int GDALCanFileAcceptSidecarFile(const char* pszFilename);
 
+int GDALGetNumThreads();
+
+/* Implemented in gdalmetadatasnapshot.cpp */
+CPLXMLNode CPL_DLL *GDALGetMetadataSnapshot( const char* pszFilename,
+                                             const char* pszKey );
+void CPL_DLL GDALSetMetadataSnapshot( const char* pszFilename,
+                                      const char* pszKey,
+                                      const CPLXMLNode* psSnapshot );
+void CPL_DLL GDALInvalidateMetadataSnapshots( const char* pszFilename );
+void CPL_DLL GDALFlushMetadataSnapshots();
+void GDALMetadataSnapshotsCleanup();
+
 #endif /* ndef GDAL_PRIV_H_INCLUDED */
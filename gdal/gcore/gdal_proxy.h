@@ -219,8 +219,6 @@ class CPL_DLL GDALProxyPoolDataset : public GDALProxyDataset
         CPLHashSet      *metadataSet;
         CPLHashSet      *metadataItemSet;
 
-        GDALProxyPoolCacheEntry* cacheEntry;
-
     protected:
         virtual GDALDataset *RefUnderlyingDataset();
         virtual void UnrefUnderlyingDataset(GDALDataset* poUnderlyingDataset);
@@ -391,6 +389,10 @@ void CPL_DLL GDALProxyPoolDatasetAddSrcBandDescription( GDALProxyPoolDatasetH hP
                                                         GDALDataType eDataType,
                                                         int nBlockXSize, int nBlockYSize);
 
+void CPL_DLL CPL_STDCALL GDALDatasetPoolGetStatistics( GIntBig* pnHits,
+                                                       GIntBig* pnMisses,
+                                                       GIntBig* pnReopens );
+
 CPL_C_END
 
 #endif /* GDAL_PROXY_H_INCLUDED */
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include "gdal_priv.h"
+#include "cpl_atomic_ops.h"
 #include "cpl_multiproc.h"
 #include <new>
 
@@ -37,6 +38,16 @@ CPL_CVSID("$Id$");
 static int nAllBandsKeptAlivedBlocks = 0;
 #endif
 
+/* Source of the identifiers of band caches */
+static volatile GIntBig nBandBlockCacheCounter = 0;
+
+/* Statistics of the global block cache, updated along with those of bands. */
+/* Hits and misses are counted by the cache shards, see GDALRasterBlock */
+static volatile GIntBig nGlobalBytesRead = 0;
+static volatile GIntBig nGlobalEvictions = 0;
+static volatile GIntBig nGlobalDirtyFlushes = 0;
+static volatile GIntBig nGlobalLockWaitMicroSec = 0;
+
 /************************************************************************/
 /*                       GDALArrayBandBlockCache()                      */
 /************************************************************************/
@@ -46,7 +57,15 @@ GDALAbstractBandBlockCache::GDALAbstractBandBlockCache(GDALRasterBand* poBandIn)
     psListBlocksToFree(NULL),
     hCond(CPLCreateCond()),
     hCondMutex(CPLCreateMutex()),
-    nKeepAliveCounter(0)
+    nKeepAliveCounter(0),
+    nHits(0),
+    nMisses(0),
+    nBytesRead(0),
+    nEvictions(0),
+    nDirtyFlushes(0),
+    nLockWaitMicroSec(0),
+    nSharedMemoryViews(0),
+    nId(CPLAtomicAdd64(&nBandBlockCacheCounter, 1))
 {
     poBand = poBandIn;
     if( hCondMutex )
@@ -188,3 +207,130 @@ GDALRasterBlock* GDALAbstractBandBlockCache::CreateBlock(int nXBlockOff,
             poBand, nXBlockOff, nYBlockOff );
     return poBlock;
 }
+
+/************************************************************************/
+/*                             RecordHit()                              */
+/*                                                                      */
+/*      The Record*() methods update the statistics of the band and of  */
+/*      the global block cache. They are called by GDALRasterBlock and  */
+/*      GDALRasterBand. Hits and misses are only counted here for the   */
+/*      band, GDALRasterBlock counts them in the shards of the cache.   */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::RecordHit()
+{
+    CPLAtomicAdd64(&nHits, 1);
+}
+
+/************************************************************************/
+/*                             RecordMiss()                             */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::RecordMiss()
+{
+    CPLAtomicAdd64(&nMisses, 1);
+}
+
+/************************************************************************/
+/*                          RecordBlockRead()                           */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::RecordBlockRead( int nBytes )
+{
+    CPLAtomicAdd64(&nBytesRead, nBytes);
+    CPLAtomicAdd64(&nGlobalBytesRead, nBytes);
+}
+
+/************************************************************************/
+/*                           RecordEviction()                           */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::RecordEviction()
+{
+    CPLAtomicAdd64(&nEvictions, 1);
+    CPLAtomicAdd64(&nGlobalEvictions, 1);
+}
+
+/************************************************************************/
+/*                          RecordDirtyFlush()                          */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::RecordDirtyFlush()
+{
+    CPLAtomicAdd64(&nDirtyFlushes, 1);
+    CPLAtomicAdd64(&nGlobalDirtyFlushes, 1);
+}
+
+/************************************************************************/
+/*                           RecordLockWait()                           */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::RecordLockWait( GIntBig nMicroSec )
+{
+    CPLAtomicAdd64(&nLockWaitMicroSec, nMicroSec);
+    CPLAtomicAdd64(&nGlobalLockWaitMicroSec, nMicroSec);
+}
+
+/************************************************************************/
+/*                        RecordGlobalLockWait()                        */
+/*                                                                      */
+/*      For lock waits that cannot be attributed to a band.             */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::RecordGlobalLockWait( GIntBig nMicroSec )
+{
+    CPLAtomicAdd64(&nGlobalLockWaitMicroSec, nMicroSec);
+}
+
+/************************************************************************/
+/*                            GetStatistics()                           */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::GetStatistics( GDALCacheStatistics* psStats )
+{
+    psStats->nHits = CPLAtomicAdd64(&nHits, 0);
+    psStats->nMisses = CPLAtomicAdd64(&nMisses, 0);
+    psStats->nBytesRead = CPLAtomicAdd64(&nBytesRead, 0);
+    psStats->nEvictions = CPLAtomicAdd64(&nEvictions, 0);
+    psStats->nDirtyFlushes = CPLAtomicAdd64(&nDirtyFlushes, 0);
+    psStats->nLockWaitMicroSec = CPLAtomicAdd64(&nLockWaitMicroSec, 0);
+}
+
+/************************************************************************/
+/*                        AddSharedMemoryView()                         */
+/*                                                                      */
+/*      While virtual memory views map the blocks of the band, their    */
+/*      data is allocated so that it can be mapped without copy.        */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::AddSharedMemoryView()
+{
+    CPLAtomicInc(&nSharedMemoryViews);
+}
+
+/************************************************************************/
+/*                       RemoveSharedMemoryView()                       */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::RemoveSharedMemoryView()
+{
+    CPLAtomicDec(&nSharedMemoryViews);
+}
+
+/************************************************************************/
+/*                         GetGlobalStatistics()                        */
+/*                                                                      */
+/*      Return the counters since the start of the process, except the  */
+/*      hits and misses which are left to 0.                            */
+/************************************************************************/
+
+void GDALAbstractBandBlockCache::GetGlobalStatistics(
+                                                GDALCacheStatistics* psStats )
+{
+    psStats->nHits = 0;
+    psStats->nMisses = 0;
+    psStats->nBytesRead = CPLAtomicAdd64(&nGlobalBytesRead, 0);
+    psStats->nEvictions = CPLAtomicAdd64(&nGlobalEvictions, 0);
+    psStats->nDirtyFlushes = CPLAtomicAdd64(&nGlobalDirtyFlushes, 0);
+    psStats->nLockWaitMicroSec = CPLAtomicAdd64(&nGlobalLockWaitMicroSec, 0);
+}
@@ -446,7 +446,13 @@ GDALRasterBlock *GDALArrayBandBlockCache::TryGetLockedBlockRef( int nXBlockOff,
             if( poBlock == NULL )
                 return NULL;
             if( poBlock->TakeLock() )
-                break;
+            {
+                // The block might have been evicted, and another one put in
+                // the slot, since we fetched it.
+                if( u.papoBlocks[nBlockIndex] == poBlock )
+                    break;
+                poBlock->DropLock();
+            }
         }
     }
     else
@@ -473,7 +479,11 @@ GDALRasterBlock *GDALArrayBandBlockCache::TryGetLockedBlockRef( int nXBlockOff,
             if( poBlock == NULL )
                 return NULL;
             if( poBlock->TakeLock() )
-                break;
+            {
+                if( papoSubBlockGrid[nBlockInSubBlock] == poBlock )
+                    break;
+                poBlock->DropLock();
+            }
         }
     }
 
@@ -0,0 +1,812 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Read blocks into the block cache ahead of their use
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_priv.h"
+#include "cpl_multiproc.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+CPL_CVSID("$Id$");
+
+/*
+ * The prefetcher reads blocks with IReadBlock() from the threads of a
+ * CPLWorkerThreadPool and adopts them in the block cache of their band, so
+ * that the block is already there when the consumer asks for it.
+ *
+ * It is enabled by setting GDAL_PREFETCH_NUM_THREADS to a number of threads
+ * (or ALL_CPUS). Blocks are then scheduled by AdviseRead(), and by
+ * GDALRasterBand::IRasterIO() when it detects that the windows requested on
+ * a band follow each other, top to bottom or left to right. The amount of
+ * data scheduled but not yet read is bounded by GDAL_PREFETCH_MAX_BYTES,
+ * which defaults to a quarter of GDAL_CACHEMAX. Blocks that do not fit are
+ * just not prefetched.
+ *
+ * Drivers are not thread-safe, so the worker threads and the thread using
+ * the dataset are serialized by a per-dataset lock, taken by
+ * GDALDataset::EnterReadWrite() on the side of the consumer. Datasets that
+ * share the file handle of another one (overviews and masks of a GeoTIFF
+ * file, ...) are declared with GDALDataset::SetFileHandleOwner(), and use
+ * the state and the lock of the owner of the handle. Only datasets
+ * opened in read-only mode are prefetched. The blocks are read while the
+ * consumer is busy with something else than I/O on the dataset, or while
+ * it uses other datasets (for example the other sources of a VRT).
+ *
+ * Pending reads are cancelled by GDALDataset::FlushCache(). GDALClose()
+ * detaches the dataset, before the driver starts destroying its bands: the
+ * pending reads are cancelled, the ones in progress are waited for, and no
+ * new ones can be scheduled. The state is released by the destructor of
+ * GDALDataset.
+ */
+
+typedef struct
+{
+    GDALRasterBand* poBand;
+    int             nXBlockOff;
+    int             nYBlockOff;
+} GDALBlockPrefetchKey;
+
+static bool operator< ( const GDALBlockPrefetchKey& a,
+                        const GDALBlockPrefetchKey& b )
+{
+    if( a.poBand != b.poBand )
+        return a.poBand < b.poBand;
+    if( a.nYBlockOff != b.nYBlockOff )
+        return a.nYBlockOff < b.nYBlockOff;
+    return a.nXBlockOff < b.nXBlockOff;
+}
+
+typedef struct
+{
+    /* Last window requested with RasterIO() */
+    int nXOff, nYOff, nXSize, nYSize;
+    /* Last window prefetched after it */
+    int nPrefetchXOff, nPrefetchYOff, nPrefetchXSize, nPrefetchYSize;
+} GDALBlockPrefetchWindow;
+
+struct GDALBlockPrefetchState
+{
+    /* NULL once the dataset has been detached. The dataset keeps pointing */
+    /* to the state until it is destroyed */
+    GDALDataset*    poDS;
+
+    /* One reference for the dataset, and one for each queued job */
+    int             nRefCount;
+
+    /* Set by CancelDataset(), reset when new blocks are scheduled */
+    bool            bCancelled;
+
+    /* Number of jobs that are using the dataset */
+    int             nBusyJobs;
+
+    /* Recursive lock serializing the jobs and the consumer */
+    GIntBig         nOwnerPID;
+    int             nLockDepth;
+    bool            bOwnerIsJob;
+
+    std::set<GDALBlockPrefetchKey>                   oQueuedBlocks;
+    std::map<GDALRasterBand*, GDALBlockPrefetchWindow> oLastWindows;
+};
+
+typedef struct
+{
+    GDALBlockPrefetchState* psState;
+    GDALBlockPrefetchKey    sKey;
+    int                     nBytes;
+} GDALBlockPrefetchJob;
+
+/* hPrefetchMutex protects all the members of GDALBlockPrefetchState, the */
+/* pointer to it in GDALDataset, and the below variables */
+static CPLMutex            *hPrefetchMutex = NULL;
+static CPLCond             *hPrefetchCond = NULL;
+static CPLWorkerThreadPool *poPrefetchPool = NULL;
+static GIntBig              nInFlightBytes = 0;
+static volatile int         nPrefetchThreads = -1;
+
+/************************************************************************/
+/*                             IsEnabled()                              */
+/************************************************************************/
+
+bool GDALBlockPrefetcher::IsEnabled()
+{
+    if( nPrefetchThreads < 0 )
+    {
+        const char* pszThreads =
+            CPLGetConfigOption("GDAL_PREFETCH_NUM_THREADS", "0");
+        if( EQUAL(pszThreads, "ALL_CPUS") )
+            nPrefetchThreads = CPLGetNumCPUs();
+        else
+            nPrefetchThreads = std::max(0, atoi(pszThreads));
+    }
+    return nPrefetchThreads > 0;
+}
+
+/************************************************************************/
+/*                              GetState()                              */
+/*                                                                      */
+/*      Return the prefetching state of the dataset owning the file     */
+/*      handle of a band, creating it, and the thread pool, if needed.  */
+/*      Returns NULL if the band cannot be prefetched. Must be called   */
+/*      with hPrefetchMutex held.                                       */
+/************************************************************************/
+
+GDALBlockPrefetchState* GDALBlockPrefetcher::GetState( GDALRasterBand* poBand )
+{
+    GDALDataset* poDS = poBand->GetDataset();
+    if( poDS == NULL || poDS->GetAccess() != GA_ReadOnly )
+        return NULL;
+
+    // Bands that are not owned by their dataset (mask bands, ...) might be
+    // destroyed behind our back.
+    const int nBand = poBand->GetBand();
+    if( nBand < 1 || nBand > poDS->GetRasterCount() ||
+        poDS->GetRasterBand(nBand) != poBand )
+        return NULL;
+
+    poDS = poDS->GetFileHandleOwner();
+    if( poDS->GetAccess() != GA_ReadOnly )
+        return NULL;
+
+    if( hPrefetchCond == NULL )
+        hPrefetchCond = CPLCreateCond();
+    if( poPrefetchPool == NULL )
+    {
+        poPrefetchPool = new CPLWorkerThreadPool();
+        if( !poPrefetchPool->Setup( nPrefetchThreads, NULL, NULL ) )
+        {
+            delete poPrefetchPool;
+            poPrefetchPool = NULL;
+            nPrefetchThreads = 0;
+            return NULL;
+        }
+        CPLDebug( "GDAL", "Prefetching blocks with %d thread(s)",
+                  nPrefetchThreads );
+    }
+
+    GDALBlockPrefetchState* psState = poDS->GetPrefetchState();
+    if( psState == NULL )
+    {
+        psState = new GDALBlockPrefetchState();
+        psState->poDS = poDS;
+        psState->nRefCount = 1;
+        psState->bCancelled = false;
+        psState->nBusyJobs = 0;
+        psState->nOwnerPID = 0;
+        psState->nLockDepth = 0;
+        psState->bOwnerIsJob = false;
+        poDS->SetPrefetchState( psState );
+    }
+    else if( psState->poDS == NULL )
+    {
+        // The dataset is being closed.
+        return NULL;
+    }
+    return psState;
+}
+
+/************************************************************************/
+/*                       GDALBlockPrefetchUnlock()                      */
+/*                                                                      */
+/*      Must be called with hPrefetchMutex held.                        */
+/************************************************************************/
+
+static void GDALBlockPrefetchUnlock( GDALBlockPrefetchState* psState )
+{
+    CPLAssert( psState->nLockDepth > 0 && psState->nOwnerPID == CPLGetPID() );
+    psState->nLockDepth --;
+    if( psState->nLockDepth == 0 )
+        CPLCondBroadcast( hPrefetchCond );
+}
+
+/************************************************************************/
+/*                            EnterDataset()                            */
+/************************************************************************/
+
+/* Called by GDALDataset::EnterReadWrite(). Returns TRUE if the lock of the */
+/* dataset has been taken, that is if blocks of it are being prefetched */
+int GDALBlockPrefetcher::EnterDataset( GDALDataset* poDS )
+{
+    if( !IsEnabled() )
+        return FALSE;
+
+    CPLMutexHolderD( &hPrefetchMutex );
+
+    GDALBlockPrefetchState* psState =
+        poDS->GetFileHandleOwner()->GetPrefetchState();
+    if( psState == NULL || psState->poDS == NULL )
+        return FALSE;
+
+    const GIntBig nPID = CPLGetPID();
+    while( psState->nLockDepth > 0 && psState->nOwnerPID != nPID )
+        CPLCondWait( hPrefetchCond, hPrefetchMutex );
+
+    if( psState->nLockDepth == 0 )
+        psState->bOwnerIsJob = false;
+    psState->nOwnerPID = nPID;
+    psState->nLockDepth ++;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                            LeaveDataset()                            */
+/************************************************************************/
+
+/* Called by GDALDataset::LeaveReadWrite(). Returns TRUE if the lock of the */
+/* dataset was held by the current thread, and has been released */
+int GDALBlockPrefetcher::LeaveDataset( GDALDataset* poDS )
+{
+    if( !IsEnabled() )
+        return FALSE;
+
+    CPLMutexHolderD( &hPrefetchMutex );
+
+    GDALBlockPrefetchState* psState =
+        poDS->GetFileHandleOwner()->GetPrefetchState();
+    if( psState == NULL || psState->nLockDepth == 0 ||
+        psState->nOwnerPID != CPLGetPID() )
+        return FALSE;
+
+    GDALBlockPrefetchUnlock( psState );
+    return TRUE;
+}
+
+/************************************************************************/
+/*                      GDALBlockPrefetchLockForJob()                   */
+/*                                                                      */
+/*      Same as EnterDataset(), except that it gives up if the reads of */
+/*      the dataset are cancelled meanwhile.                            */
+/************************************************************************/
+
+static bool GDALBlockPrefetchLockForJob( GDALBlockPrefetchState* psState )
+{
+    CPLMutexHolderD( &hPrefetchMutex );
+
+    const GIntBig nPID = CPLGetPID();
+    while( !psState->bCancelled && psState->poDS != NULL &&
+           psState->nLockDepth > 0 && psState->nOwnerPID != nPID )
+        CPLCondWait( hPrefetchCond, hPrefetchMutex );
+
+    if( psState->bCancelled || psState->poDS == NULL )
+        return false;
+
+    if( psState->nLockDepth == 0 )
+        psState->bOwnerIsJob = true;
+    psState->nOwnerPID = nPID;
+    psState->nLockDepth ++;
+    return true;
+}
+
+/************************************************************************/
+/*                      GDALBlockPrefetchDiscard()                      */
+/*                                                                      */
+/*      Destroy a block that has been internalized, but not adopted by  */
+/*      its band. It is listed in its cache shard, so it must be        */
+/*      detached while we still hold its lock: once unlocked, another   */
+/*      thread could evict it and clear the slot of the band at the     */
+/*      same coordinates, which might hold another block.               */
+/************************************************************************/
+
+static void GDALBlockPrefetchDiscard( GDALRasterBlock* poBlock )
+{
+    poBlock->Detach();
+    poBlock->DropLock();
+    delete poBlock;
+}
+
+/************************************************************************/
+/*                             ReadBlock()                              */
+/************************************************************************/
+
+void GDALBlockPrefetcher::ReadBlock( GDALBlockPrefetchState* psState,
+                                     GDALRasterBand* poBand,
+                                     int nXBlockOff, int nYBlockOff )
+{
+    GDALAbstractBandBlockCache* poBlockCache = poBand->poBandBlockCache;
+
+    GDALRasterBlock* poBlock =
+        poBlockCache->TryGetLockedBlockRef( nXBlockOff, nYBlockOff );
+    if( poBlock != NULL )
+    {
+        poBlock->DropLock();
+        return;
+    }
+
+    poBlock = poBlockCache->CreateBlock( nXBlockOff, nYBlockOff );
+    if( poBlock == NULL )
+        return;
+    poBlock->AddLock();
+
+    // Make room in the cache before taking the lock of the dataset, as this
+    // might require writing dirty blocks of other datasets.
+    if( poBlock->Internalize() != CE_None )
+    {
+        GDALBlockPrefetchDiscard( poBlock );
+        return;
+    }
+
+    if( !GDALBlockPrefetchLockForJob( psState ) )
+    {
+        GDALBlockPrefetchDiscard( poBlock );
+        return;
+    }
+
+    // The consumer might have read the block meanwhile.
+    GDALRasterBlock* poCachedBlock =
+        poBlockCache->TryGetLockedBlockRef( nXBlockOff, nYBlockOff );
+    if( poCachedBlock != NULL )
+    {
+        poCachedBlock->DropLock();
+    }
+    else if( poBand->IReadBlock( nXBlockOff, nYBlockOff,
+                                 poBlock->GetDataRef() ) == CE_None &&
+             poBand->AdoptBlock( poBlock ) == CE_None )
+    {
+        poBlockCache->RecordBlockRead( poBlock->GetBlockSize() );
+        poBlock->DropLock();
+        poBlock = NULL;
+    }
+
+    {
+        CPLMutexHolderD( &hPrefetchMutex );
+        GDALBlockPrefetchUnlock( psState );
+    }
+
+    if( poBlock != NULL )
+        GDALBlockPrefetchDiscard( poBlock );
+}
+
+/************************************************************************/
+/*                              JobFunc()                               */
+/************************************************************************/
+
+void GDALBlockPrefetcher::JobFunc( void* pData )
+{
+    GDALBlockPrefetchJob* psJob = static_cast<GDALBlockPrefetchJob*>(pData);
+    GDALBlockPrefetchState* psState = psJob->psState;
+
+    bool bRun;
+    {
+        CPLMutexHolderD( &hPrefetchMutex );
+        bRun = !psState->bCancelled && psState->poDS != NULL;
+        if( bRun )
+            psState->nBusyJobs ++;
+    }
+
+    if( bRun )
+    {
+        // Errors are those of the consumer, if it reads the block itself.
+        CPLPushErrorHandler( CPLQuietErrorHandler );
+        ReadBlock( psState, psJob->sKey.poBand,
+                   psJob->sKey.nXBlockOff, psJob->sKey.nYBlockOff );
+        CPLPopErrorHandler();
+    }
+
+    bool bDestroyState;
+    {
+        CPLMutexHolderD( &hPrefetchMutex );
+        if( bRun )
+        {
+            psState->nBusyJobs --;
+            CPLCondBroadcast( hPrefetchCond );
+        }
+        nInFlightBytes -= psJob->nBytes;
+        psState->oQueuedBlocks.erase( psJob->sKey );
+        psState->nRefCount --;
+        bDestroyState = ( psState->nRefCount == 0 );
+    }
+    if( bDestroyState )
+        delete psState;
+    delete psJob;
+}
+
+/************************************************************************/
+/*                           PrefetchWindow()                           */
+/************************************************************************/
+
+/**
+ * \brief Schedule the reading of the blocks intersecting a window.
+ *
+ * Blocks already in the cache or already scheduled are skipped. Scheduling
+ * stops once GDAL_PREFETCH_MAX_BYTES of blocks are waiting to be read.
+ *
+ * This does nothing if GDAL_PREFETCH_NUM_THREADS is not set, or if the band
+ * cannot be prefetched.
+ */
+
+void GDALBlockPrefetcher::PrefetchWindow( GDALRasterBand* poBand,
+                                          int nXOff, int nYOff,
+                                          int nXSize, int nYSize )
+{
+    if( !IsEnabled() )
+        return;
+
+    if( !poBand->InitBlockInfo() )
+        return;
+
+/* -------------------------------------------------------------------- */
+/*      Clip the window to the raster, and compute its blocks.          */
+/* -------------------------------------------------------------------- */
+    const int nRasterXSize = poBand->GetXSize();
+    const int nRasterYSize = poBand->GetYSize();
+    const int nXEnd = std::min(nRasterXSize, nXOff + nXSize);
+    const int nYEnd = std::min(nRasterYSize, nYOff + nYSize);
+    nXOff = std::max(0, nXOff);
+    nYOff = std::max(0, nYOff);
+    if( nXOff >= nXEnd || nYOff >= nYEnd )
+        return;
+
+    int nBlockXSize, nBlockYSize;
+    poBand->GetBlockSize( &nBlockXSize, &nBlockYSize );
+    const int nXBlockStart = nXOff / nBlockXSize;
+    const int nXBlockEnd = (nXEnd - 1) / nBlockXSize;
+    const int nYBlockStart = nYOff / nBlockYSize;
+    const int nYBlockEnd = (nYEnd - 1) / nBlockYSize;
+    const int nBlockBytes = nBlockXSize * nBlockYSize *
+        (GDALGetDataTypeSize(poBand->GetRasterDataType()) / 8);
+
+    GIntBig nMaxInFlightBytes = GDALGetCacheMax64() / 4;
+    const char* pszMaxBytes = CPLGetConfigOption("GDAL_PREFETCH_MAX_BYTES", NULL);
+    if( pszMaxBytes != NULL )
+        nMaxInFlightBytes = CPLAtoGIntBig(pszMaxBytes);
+
+    GDALAbstractBandBlockCache* poBlockCache = poBand->poBandBlockCache;
+    std::vector<void*> apJobs;
+    {
+        CPLMutexHolderD( &hPrefetchMutex );
+
+        GDALBlockPrefetchState* psState = GetState( poBand );
+        if( psState == NULL )
+            return;
+        psState->bCancelled = false;
+
+        for( int iYBlock = nYBlockStart; iYBlock <= nYBlockEnd; iYBlock++ )
+        {
+            for( int iXBlock = nXBlockStart; iXBlock <= nXBlockEnd; iXBlock++ )
+            {
+                GDALBlockPrefetchKey sKey;
+                sKey.poBand = poBand;
+                sKey.nXBlockOff = iXBlock;
+                sKey.nYBlockOff = iYBlock;
+                if( psState->oQueuedBlocks.find(sKey) !=
+                                            psState->oQueuedBlocks.end() )
+                    continue;
+
+                GDALRasterBlock* poBlock =
+                    poBlockCache->TryGetLockedBlockRef( iXBlock, iYBlock );
+                if( poBlock != NULL )
+                {
+                    poBlock->DropLock();
+                    continue;
+                }
+
+                if( nInFlightBytes + nBlockBytes > nMaxInFlightBytes )
+                    break;
+
+                GDALBlockPrefetchJob* psJob = new GDALBlockPrefetchJob;
+                psJob->psState = psState;
+                psJob->sKey = sKey;
+                psJob->nBytes = nBlockBytes;
+                psState->oQueuedBlocks.insert( sKey );
+                psState->nRefCount ++;
+                nInFlightBytes += nBlockBytes;
+                apJobs.push_back( psJob );
+            }
+        }
+    }
+
+    if( !apJobs.empty() )
+        poPrefetchPool->SubmitJobs( JobFunc, apJobs );
+}
+
+/************************************************************************/
+/*                           NotifyRasterIO()                           */
+/************************************************************************/
+
+/**
+ * \brief Record a window read on a band, and prefetch the next one if the
+ * windows read follow each other.
+ *
+ * Called by GDALRasterBand::IRasterIO() for non-resampled reads.
+ */
+
+void GDALBlockPrefetcher::NotifyRasterIO( GDALRasterBand* poBand,
+                                          int nXOff, int nYOff,
+                                          int nXSize, int nYSize )
+{
+    if( !IsEnabled() )
+        return;
+
+    int nBlockXSize, nBlockYSize;
+    poBand->GetBlockSize( &nBlockXSize, &nBlockYSize );
+    const int nRasterXSize = poBand->GetXSize();
+    const int nRasterYSize = poBand->GetYSize();
+
+    bool bPrefetch = false;
+    int nNextXOff = 0, nNextYOff = 0, nNextXEnd = 0, nNextYEnd = 0;
+    {
+        CPLMutexHolderD( &hPrefetchMutex );
+
+        // If the state of the dataset is created now, the current RasterIO()
+        // is not serialized with the worker threads, so nothing is prefetched
+        // before the next one.
+        GDALBlockPrefetchState* psState = GetState( poBand );
+        if( psState == NULL )
+            return;
+
+        std::map<GDALRasterBand*, GDALBlockPrefetchWindow>::iterator oIter =
+            psState->oLastWindows.find(poBand);
+        if( oIter == psState->oLastWindows.end() )
+        {
+            GDALBlockPrefetchWindow sWindow;
+            memset( &sWindow, 0, sizeof(sWindow) );
+            oIter = psState->oLastWindows.insert(
+                std::pair<GDALRasterBand*, GDALBlockPrefetchWindow>(
+                    poBand, sWindow)).first;
+        }
+        GDALBlockPrefetchWindow& sLast = oIter->second;
+
+        const bool bLocked = psState->nLockDepth > 0 &&
+                             psState->nOwnerPID == CPLGetPID();
+        if( bLocked && sLast.nXSize > 0 )
+        {
+            if( nXOff == sLast.nXOff && nXSize == sLast.nXSize &&
+                nYOff == sLast.nYOff + sLast.nYSize )
+            {
+                // Top to bottom.
+                nNextXOff = nXOff;
+                nNextXEnd = nXOff + nXSize;
+                nNextYOff = nYOff + nYSize;
+                nNextYEnd = nNextYOff + std::max(nYSize, nBlockYSize);
+                bPrefetch = true;
+            }
+            else if( nYOff == sLast.nYOff && nYSize == sLast.nYSize &&
+                     nXOff == sLast.nXOff + sLast.nXSize )
+            {
+                // Left to right, and then the next row of windows.
+                if( nXOff + nXSize < nRasterXSize )
+                {
+                    nNextXOff = nXOff + nXSize;
+                    nNextYOff = nYOff;
+                }
+                else
+                {
+                    nNextXOff = 0;
+                    nNextYOff = nYOff + nYSize;
+                }
+                nNextXEnd = nNextXOff + std::max(nXSize, nBlockXSize);
+                nNextYEnd = nNextYOff + nYSize;
+                bPrefetch = true;
+            }
+        }
+
+        sLast.nXOff = nXOff;
+        sLast.nYOff = nYOff;
+        sLast.nXSize = nXSize;
+        sLast.nYSize = nYSize;
+
+        if( bPrefetch )
+        {
+            // Extend the window to the block boundaries, so that the
+            // successive requests within the same blocks are skipped below.
+            nNextXEnd = std::min(nRasterXSize,
+                ((nNextXEnd + nBlockXSize - 1) / nBlockXSize) * nBlockXSize);
+            nNextYEnd = std::min(nRasterYSize,
+                ((nNextYEnd + nBlockYSize - 1) / nBlockYSize) * nBlockYSize);
+            if( nNextXOff >= nNextXEnd || nNextYOff >= nNextYEnd ||
+                (nNextXOff >= sLast.nPrefetchXOff &&
+                 nNextXEnd <= sLast.nPrefetchXOff + sLast.nPrefetchXSize &&
+                 nNextYOff >= sLast.nPrefetchYOff &&
+                 nNextYEnd <= sLast.nPrefetchYOff + sLast.nPrefetchYSize) )
+            {
+                bPrefetch = false;
+            }
+            else
+            {
+                sLast.nPrefetchXOff = nNextXOff;
+                sLast.nPrefetchYOff = nNextYOff;
+                sLast.nPrefetchXSize = nNextXEnd - nNextXOff;
+                sLast.nPrefetchYSize = nNextYEnd - nNextYOff;
+            }
+        }
+    }
+
+    if( bPrefetch )
+        PrefetchWindow( poBand, nNextXOff, nNextYOff,
+                        nNextXEnd - nNextXOff, nNextYEnd - nNextYOff );
+}
+
+/************************************************************************/
+/*                     GDALBlockPrefetchCancel()                        */
+/*                                                                      */
+/*      Cancel the scheduled reads of a state, and wait for the ones in */
+/*      progress. Must be called with hPrefetchMutex held.              */
+/************************************************************************/
+
+static void GDALBlockPrefetchCancel( GDALBlockPrefetchState* psState )
+{
+    psState->bCancelled = true;
+    psState->oQueuedBlocks.clear();
+    psState->oLastWindows.clear();
+
+    // Jobs waiting for the lock of the dataset give up when woken up.
+    // If we are a job ourselves (FlushCache() called from IReadBlock()),
+    // do not wait for our own completion.
+    CPLCondBroadcast( hPrefetchCond );
+    const int nSelf = ( psState->nLockDepth > 0 && psState->bOwnerIsJob &&
+                        psState->nOwnerPID == CPLGetPID() ) ? 1 : 0;
+    while( psState->nBusyJobs > nSelf )
+        CPLCondWait( hPrefetchCond, hPrefetchMutex );
+}
+
+/************************************************************************/
+/*                           CancelDataset()                            */
+/************************************************************************/
+
+/**
+ * \brief Cancel the scheduled reads of a dataset, and wait for the ones
+ * in progress.
+ *
+ * Called by GDALDataset::FlushCache(). The reads of all the datasets sharing
+ * the file handle of the dataset are cancelled.
+ */
+
+void GDALBlockPrefetcher::CancelDataset( GDALDataset* poDS )
+{
+    if( !IsEnabled() )
+        return;
+
+    CPLMutexHolderD( &hPrefetchMutex );
+
+    GDALBlockPrefetchState* psState =
+        poDS->GetFileHandleOwner()->GetPrefetchState();
+    if( psState != NULL && psState->poDS != NULL )
+        GDALBlockPrefetchCancel( psState );
+}
+
+/************************************************************************/
+/*                           DetachDataset()                            */
+/************************************************************************/
+
+/**
+ * \brief Stop prefetching the blocks of a dataset for good.
+ *
+ * Called by GDALClose() before the dataset is destroyed, so that no worker
+ * thread uses its bands while the driver destroys them.
+ */
+
+void GDALBlockPrefetcher::DetachDataset( GDALDataset* poDS )
+{
+    if( !IsEnabled() )
+        return;
+
+    CPLMutexHolderD( &hPrefetchMutex );
+
+    // The owner of the file handle keeps being prefetched, but none of the
+    // jobs using our bands must survive.
+    GDALDataset* poOwnerDS = poDS->GetFileHandleOwner();
+    if( poOwnerDS != poDS )
+    {
+        GDALBlockPrefetchState* psOwnerState = poOwnerDS->GetPrefetchState();
+        if( psOwnerState != NULL && psOwnerState->poDS != NULL )
+            GDALBlockPrefetchCancel( psOwnerState );
+        return;
+    }
+
+    GDALBlockPrefetchState* psState = poDS->GetPrefetchState();
+    if( psState == NULL )
+    {
+        // Prevent the reads done by the destructor from creating a state.
+        psState = new GDALBlockPrefetchState();
+        psState->poDS = NULL;
+        psState->nRefCount = 1;
+        psState->bCancelled = true;
+        psState->nBusyJobs = 0;
+        psState->nOwnerPID = 0;
+        psState->nLockDepth = 0;
+        psState->bOwnerIsJob = false;
+        poDS->SetPrefetchState( psState );
+    }
+    else if( psState->poDS != NULL )
+    {
+        GDALBlockPrefetchCancel( psState );
+        psState->poDS = NULL;
+    }
+}
+
+/************************************************************************/
+/*                           ReleaseDataset()                           */
+/************************************************************************/
+
+/* Called by the destructor of GDALDataset */
+void GDALBlockPrefetcher::ReleaseDataset( GDALDataset* poDS )
+{
+    // Nothing can have been prefetched since Cleanup()
+    if( hPrefetchMutex == NULL )
+        return;
+
+    GDALBlockPrefetchState* psState;
+    bool bDestroyState;
+    {
+        CPLMutexHolderD( &hPrefetchMutex );
+
+        // Datasets sharing the file handle of another one have no state,
+        // but jobs of the owner might use their bands.
+        GDALDataset* poOwnerDS = poDS->GetFileHandleOwner();
+        if( poOwnerDS != poDS )
+        {
+            psState = poOwnerDS->GetPrefetchState();
+            if( psState != NULL && psState->poDS != NULL )
+                GDALBlockPrefetchCancel( psState );
+            return;
+        }
+
+        psState = poDS->GetPrefetchState();
+        if( psState == NULL )
+            return;
+
+        // Datasets not closed with GDALClose()
+        if( psState->poDS != NULL )
+        {
+            GDALBlockPrefetchCancel( psState );
+            psState->poDS = NULL;
+        }
+        poDS->SetPrefetchState( NULL );
+        psState->nRefCount --;
+        bDestroyState = ( psState->nRefCount == 0 );
+    }
+    if( bDestroyState )
+        delete psState;
+}
+
+/************************************************************************/
+/*                              Cleanup()                               */
+/************************************************************************/
+
+void GDALBlockPrefetcher::Cleanup()
+{
+    // Remaining jobs, if any, belong to destroyed datasets and give up.
+    delete poPrefetchPool;
+    poPrefetchPool = NULL;
+
+    if( hPrefetchCond != NULL )
+    {
+        CPLDestroyCond( hPrefetchCond );
+        hPrefetchCond = NULL;
+    }
+    if( hPrefetchMutex != NULL )
+    {
+        CPLDestroyMutex( hPrefetchMutex );
+        hPrefetchMutex = NULL;
+    }
+    nInFlightBytes = 0;
+    nPrefetchThreads = -1;
+}
@@ -73,6 +73,19 @@ typedef struct
     CPLMutex* hMutex;
     int       nMutexTakenCount;
     GDALAllowReadWriteMutexState eStateReadWriteMutex;
+
+    /* Block cache quota, priority and accounting. See SetCacheQuota() */
+    CPLLock*          hCacheLock;
+    GIntBig           nCacheQuota;
+    GIntBig           nCacheUsed;
+    GDALCachePriority eCachePriority;
+
+    /* Set once blocks of the dataset have been scheduled for prefetching. */
+    /* Protected by the mutex of GDALBlockPrefetcher */
+    GDALBlockPrefetchState* psPrefetchState;
+
+    /* Dataset whose file handle we share, if any. See SetFileHandleOwner() */
+    GDALDataset*      poFileHandleOwner;
 } GDALDatasetPrivate;
 
 typedef struct
@@ -216,7 +229,11 @@ void GDALDataset::Init(int bForceCachedIOIn)
     m_poStyleTable = NULL;
     m_hPrivateData = VSI_CALLOC_VERBOSE(1, sizeof(GDALDatasetPrivate));
     GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
-    psPrivate->eStateReadWriteMutex = RW_MUTEX_STATE_UNKNOW;
+    if( psPrivate != NULL )
+    {
+        psPrivate->eStateReadWriteMutex = RW_MUTEX_STATE_UNKNOW;
+        psPrivate->eCachePriority = GCPRIO_NORMAL;
+    }
 }
 
 /************************************************************************/
@@ -241,6 +258,8 @@ void GDALDataset::Init(int bForceCachedIOIn)
 GDALDataset::~GDALDataset()
 
 {
+    GDALBlockPrefetcher::ReleaseDataset( this );
+
     // we don't want to report destruction of datasets that
     // were never really open or meant as internal
     if( !bIsInternal && ( nBands != 0 || !EQUAL(GetDescription(),"") ) )
@@ -324,6 +343,8 @@ GDALDataset::~GDALDataset()
     GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
     if( psPrivate != NULL && psPrivate->hMutex != NULL )
         CPLDestroyMutex( psPrivate->hMutex );
+    if( psPrivate != NULL && psPrivate->hCacheLock != NULL )
+        CPLDestroyLock( psPrivate->hCacheLock );
     CPLFree(psPrivate);
 
     CSLDestroy( papszOpenOptions );
@@ -373,6 +394,8 @@ void GDALDataset::AddToDatasetOpenList()
 void GDALDataset::FlushCache()
 
 {
+    GDALBlockPrefetcher::CancelDataset( this );
+
     // This sometimes happens if a dataset is destroyed before completely
     // built.
 
@@ -420,6 +443,323 @@ void CPL_STDCALL GDALFlushCache( GDALDatasetH hDS )
     ((GDALDataset *) hDS)->FlushCache();
 }
 
+/************************************************************************/
+/*                           SetCacheQuota()                            */
+/************************************************************************/
+
+/**
+ * \brief Set the maximum amount of block cache memory used by this dataset.
+ *
+ * Once the blocks of the raster bands of this dataset use more than
+ * nQuotaInBytes in the global block cache, the least recently used ones
+ * of them are evicted, whatever the room left in the cache. This makes it
+ * possible to prevent one dataset from starving the other open datasets.
+ * If the dataset already uses more than the new quota, blocks are evicted
+ * immediately.
+ *
+ * The quota can also be set with the CACHE_QUOTA open option of
+ * GDALOpenEx().
+ *
+ * This method is the same as the C function GDALDatasetSetCacheQuota().
+ *
+ * @param nQuotaInBytes maximum number of bytes, or 0 for no quota (the
+ * default).
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALDataset::SetCacheQuota( GIntBig nQuotaInBytes )
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate == NULL )
+        return;
+    if( nQuotaInBytes < 0 )
+        nQuotaInBytes = 0;
+    psPrivate->nCacheQuota = nQuotaInBytes;
+    if( nQuotaInBytes > 0 )
+        GDALRasterBlock::EnforceCacheQuota(this);
+}
+
+/************************************************************************/
+/*                      GDALDatasetSetCacheQuota()                      */
+/************************************************************************/
+
+/**
+ * \brief Set the maximum amount of block cache memory used by a dataset.
+ *
+ * @see GDALDataset::SetCacheQuota()
+ * @since GDAL 2.2
+ */
+
+void GDALDatasetSetCacheQuota( GDALDatasetH hDS, GIntBig nQuotaInBytes )
+{
+    VALIDATE_POINTER0( hDS, "GDALDatasetSetCacheQuota" );
+
+    ((GDALDataset *) hDS)->SetCacheQuota(nQuotaInBytes);
+}
+
+/************************************************************************/
+/*                           GetCacheQuota()                            */
+/************************************************************************/
+
+/**
+ * \brief Return the maximum amount of block cache memory used by this dataset.
+ *
+ * This method is the same as the C function GDALDatasetGetCacheQuota().
+ *
+ * @return the quota in bytes, or 0 if there is no quota.
+ *
+ * @since GDAL 2.2
+ */
+
+GIntBig GDALDataset::GetCacheQuota()
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    return psPrivate ? psPrivate->nCacheQuota : 0;
+}
+
+/************************************************************************/
+/*                      GDALDatasetGetCacheQuota()                      */
+/************************************************************************/
+
+/**
+ * \brief Return the maximum amount of block cache memory used by a dataset.
+ *
+ * @see GDALDataset::GetCacheQuota()
+ * @since GDAL 2.2
+ */
+
+GIntBig GDALDatasetGetCacheQuota( GDALDatasetH hDS )
+{
+    VALIDATE_POINTER1( hDS, "GDALDatasetGetCacheQuota", 0 );
+
+    return ((GDALDataset *) hDS)->GetCacheQuota();
+}
+
+/************************************************************************/
+/*                          SetCachePriority()                          */
+/************************************************************************/
+
+/**
+ * \brief Set the priority class of the blocks of this dataset in the cache.
+ *
+ * When the global block cache is full, the blocks of the datasets of
+ * the GCPRIO_LOW class are evicted first, then those of the GCPRIO_NORMAL
+ * class, and those of the GCPRIO_HIGH class last. Within a class, the
+ * order is determined by the eviction policy (see GDAL_RB_CACHE_POLICY).
+ *
+ * The new priority applies to the blocks loaded after the call, and to the
+ * blocks already cached as they are accessed again.
+ *
+ * The priority can also be set with the CACHE_PRIORITY open option of
+ * GDALOpenEx().
+ *
+ * This method is the same as the C function GDALDatasetSetCachePriority().
+ *
+ * @param ePriority the new priority class. Defaults to GCPRIO_NORMAL.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALDataset::SetCachePriority( GDALCachePriority ePriority )
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate == NULL )
+        return;
+    if( ePriority < GCPRIO_LOW || ePriority > GCPRIO_HIGH )
+    {
+        ReportError(CE_Failure, CPLE_IllegalArg,
+                    "Invalid cache priority: %d", (int)ePriority);
+        return;
+    }
+    psPrivate->eCachePriority = ePriority;
+}
+
+/************************************************************************/
+/*                     GDALDatasetSetCachePriority()                    */
+/************************************************************************/
+
+/**
+ * \brief Set the priority class of the blocks of a dataset in the cache.
+ *
+ * @see GDALDataset::SetCachePriority()
+ * @since GDAL 2.2
+ */
+
+void GDALDatasetSetCachePriority( GDALDatasetH hDS,
+                                  GDALCachePriority ePriority )
+{
+    VALIDATE_POINTER0( hDS, "GDALDatasetSetCachePriority" );
+
+    ((GDALDataset *) hDS)->SetCachePriority(ePriority);
+}
+
+/************************************************************************/
+/*                          GetCachePriority()                          */
+/************************************************************************/
+
+/**
+ * \brief Return the priority class of the blocks of this dataset.
+ *
+ * This method is the same as the C function GDALDatasetGetCachePriority().
+ *
+ * @since GDAL 2.2
+ */
+
+GDALCachePriority GDALDataset::GetCachePriority()
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    return psPrivate ? psPrivate->eCachePriority : GCPRIO_NORMAL;
+}
+
+/************************************************************************/
+/*                     GDALDatasetGetCachePriority()                    */
+/************************************************************************/
+
+/**
+ * \brief Return the priority class of the blocks of a dataset.
+ *
+ * @see GDALDataset::GetCachePriority()
+ * @since GDAL 2.2
+ */
+
+GDALCachePriority GDALDatasetGetCachePriority( GDALDatasetH hDS )
+{
+    VALIDATE_POINTER1( hDS, "GDALDatasetGetCachePriority", GCPRIO_NORMAL );
+
+    return ((GDALDataset *) hDS)->GetCachePriority();
+}
+
+/************************************************************************/
+/*                            GetCacheUsed()                            */
+/************************************************************************/
+
+/**
+ * \brief Return the amount of block cache memory used by this dataset.
+ *
+ * This is the size of the blocks of the raster bands of this dataset
+ * currently held in the global block cache.
+ *
+ * This method is the same as the C function GDALDatasetGetCacheUsed().
+ *
+ * @return the number of bytes.
+ *
+ * @since GDAL 2.2
+ */
+
+GIntBig GDALDataset::GetCacheUsed()
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate == NULL )
+        return 0;
+    CPLLockHolderD( &(psPrivate->hCacheLock), LOCK_SPIN );
+    return psPrivate->nCacheUsed;
+}
+
+/************************************************************************/
+/*                       GDALDatasetGetCacheUsed()                      */
+/************************************************************************/
+
+/**
+ * \brief Return the amount of block cache memory used by a dataset.
+ *
+ * @see GDALDataset::GetCacheUsed()
+ * @since GDAL 2.2
+ */
+
+GIntBig GDALDatasetGetCacheUsed( GDALDatasetH hDS )
+{
+    VALIDATE_POINTER1( hDS, "GDALDatasetGetCacheUsed", 0 );
+
+    return ((GDALDataset *) hDS)->GetCacheUsed();
+}
+
+/************************************************************************/
+/*                          UpdateCacheUsed()                           */
+/*                                                                      */
+/*      Called by GDALRasterBlock when a block of one of our bands      */
+/*      enters or leaves the global block cache.                        */
+/************************************************************************/
+
+void GDALDataset::UpdateCacheUsed( GIntBig nDelta )
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate == NULL )
+        return;
+    CPLLockHolderD( &(psPrivate->hCacheLock), LOCK_SPIN );
+    psPrivate->nCacheUsed += nDelta;
+}
+
+/************************************************************************/
+/*                          GetPrefetchState()                          */
+/*                                                                      */
+/*      Must be called with the mutex of GDALBlockPrefetcher held.      */
+/************************************************************************/
+
+GDALBlockPrefetchState* GDALDataset::GetPrefetchState()
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    return psPrivate ? psPrivate->psPrefetchState : NULL;
+}
+
+/************************************************************************/
+/*                          SetPrefetchState()                          */
+/*                                                                      */
+/*      Must be called with the mutex of GDALBlockPrefetcher held.      */
+/************************************************************************/
+
+void GDALDataset::SetPrefetchState( GDALBlockPrefetchState* psState )
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate )
+        psPrivate->psPrefetchState = psState;
+}
+
+/************************************************************************/
+/*                         SetFileHandleOwner()                         */
+/************************************************************************/
+
+/**
+ * \brief Declare that the dataset uses the file handle of another one.
+ *
+ * Drivers call this on the datasets that read through the handle of another
+ * dataset, such as the overview or mask datasets of a GeoTIFF file, so that
+ * the blocks prefetched for any of them are read under the lock of the
+ * owner of the handle. The owner must outlive the dataset.
+ *
+ * @param poOwnerDS the dataset owning the file handle.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALDataset::SetFileHandleOwner( GDALDataset* poOwnerDS )
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate )
+        psPrivate->poFileHandleOwner = poOwnerDS;
+}
+
+/************************************************************************/
+/*                         GetFileHandleOwner()                         */
+/*                                                                      */
+/*      Return the dataset owning the file handle we use, following     */
+/*      the chain of owners, or ourselves.                              */
+/************************************************************************/
+
+GDALDataset* GDALDataset::GetFileHandleOwner()
+{
+    GDALDataset* poOwnerDS = this;
+    while( true )
+    {
+        GDALDatasetPrivate* psPrivate =
+            (GDALDatasetPrivate* )poOwnerDS->m_hPrivateData;
+        if( psPrivate == NULL || psPrivate->poFileHandleOwner == NULL ||
+            psPrivate->poFileHandleOwner == poOwnerDS )
+            return poOwnerDS;
+        poOwnerDS = psPrivate->poFileHandleOwner;
+    }
+}
+
 /************************************************************************/
 /*                        BlockBasedFlushCache()                        */
 /*                                                                      */
@@ -434,6 +774,8 @@ void CPL_STDCALL GDALFlushCache( GDALDatasetH hDS )
 void GDALDataset::BlockBasedFlushCache()
 
 {
+    GDALBlockPrefetcher::CancelDataset( this );
+
     GDALRasterBand *poBand1 = GetRasterBand( 1 );
     if( poBand1 == NULL )
     {
@@ -2529,6 +2871,69 @@ GDALOpen( const char * pszFilename, GDALAccess eAccess )
 }
 
 
+/************************************************************************/
+/*                       GDALIsGenericOpenOption()                      */
+/*                                                                      */
+/*      Returns whether pszKey is an open option handled by GDALOpenEx()*/
+/*      for all drivers, and not declared by the driver as one of its   */
+/*      specific open options.                                          */
+/************************************************************************/
+
+static const char* const apszGenericOpenOptions[] =
+    { "OVERVIEW_LEVEL", "CACHE_QUOTA", "CACHE_PRIORITY", NULL };
+
+static bool GDALIsGenericOpenOption( GDALDriver* poDriver, const char* pszKey )
+{
+    const char* pszOptionList =
+        poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST);
+    return pszOptionList == NULL ||
+           CPLString(pszOptionList).ifind(pszKey) == std::string::npos;
+}
+
+/************************************************************************/
+/*                      GDALApplyCacheOpenOptions()                     */
+/************************************************************************/
+
+static void GDALApplyCacheOpenOptions( GDALDataset* poDS,
+                                       GDALDriver* poDriver,
+                                       const char* const* papszOpenOptions )
+{
+    const char* pszQuota =
+        CSLFetchNameValue((char**) papszOpenOptions, "CACHE_QUOTA");
+    if( pszQuota != NULL && GDALIsGenericOpenOption(poDriver, "CACHE_QUOTA") )
+    {
+        GIntBig nQuota;
+        if( strchr(pszQuota, '%') != NULL )
+            nQuota = static_cast<GIntBig>(
+                GDALGetCacheMax64() * CPLAtof(pszQuota) / 100.0);
+        else
+            nQuota = CPLAtoGIntBig(pszQuota) * 1024 * 1024;
+        if( nQuota < 0 )
+        {
+            CPLError(CE_Warning, CPLE_IllegalArg,
+                     "Invalid value for CACHE_QUOTA: %s", pszQuota);
+        }
+        else
+            poDS->SetCacheQuota(nQuota);
+    }
+
+    const char* pszPriority =
+        CSLFetchNameValue((char**) papszOpenOptions, "CACHE_PRIORITY");
+    if( pszPriority != NULL &&
+        GDALIsGenericOpenOption(poDriver, "CACHE_PRIORITY") )
+    {
+        if( EQUAL(pszPriority, "LOW") )
+            poDS->SetCachePriority(GCPRIO_LOW);
+        else if( EQUAL(pszPriority, "NORMAL") )
+            poDS->SetCachePriority(GCPRIO_NORMAL);
+        else if( EQUAL(pszPriority, "HIGH") )
+            poDS->SetCachePriority(GCPRIO_HIGH);
+        else
+            CPLError(CE_Warning, CPLE_IllegalArg,
+                     "Invalid value for CACHE_PRIORITY: %s", pszPriority);
+    }
+}
+
 /************************************************************************/
 /*                             GDALOpenEx()                             */
 /************************************************************************/
@@ -2597,6 +3002,11 @@ GDALOpen( const char * pszFilename, GDALAccess eAccess )
  * OVERVIEW_LEVEL=level, to select a particular overview level of a dataset.
  * The level index starts at 0. The level number can be suffixed by "only" to specify that
  * only this overview level must be visible, and not sub-levels.
+ * Since GDAL 2.2, two other options exist for all drivers:
+ * CACHE_QUOTA=value, to set the maximum amount of block cache memory used by
+ * the dataset (expressed in MB, or as x% of GDAL_CACHEMAX), and
+ * CACHE_PRIORITY=LOW/NORMAL/HIGH, to set the priority class of its blocks
+ * (see GDALDataset::SetCacheQuota() and GDALDataset::SetCachePriority()).
  * Open options are validated by default, and a warning is emitted in case the
  * option is not recognized. In some scenarios, it might be not desirable (e.g.
  * when not knowing which driver will open the file), so the special open option
@@ -2608,6 +3018,11 @@ GDALOpen( const char * pszFilename, GDALAccess eAccess )
  * filenames that are auxiliary to the main filename. If NULL is passed, a probing
  * of the file system will be done.
  *
+ * Since GDAL 2.2, drivers that declare signatures with the GDAL_DMD_SIGNATURES
+ * metadata item are not tried on files whose first bytes match none of them.
+ * The GDAL_OPEN_USE_SIGNATURES configuration option can be set to NO to
+ * try all drivers.
+ *
  * @return A GDALDatasetH handle or NULL on failure.  For C++ applications
  * this handle can be cast to a GDALDataset *.
  *
@@ -2705,7 +3120,21 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char* pszFilename,
 
     oOpenInfo.papszOpenOptions = papszOpenOptionsCleaned;
 
-    for( iDriver = -1; iDriver < poDM->GetDriverCount(); iDriver++ )
+/* -------------------------------------------------------------------- */
+/*      If the file has header bytes, only probe the drivers whose      */
+/*      signatures, if they declare any, match them.                    */
+/* -------------------------------------------------------------------- */
+    std::vector<GDALDriver*> apoCandidateDrivers;
+    const bool bUseSignatures = oOpenInfo.nHeaderBytes > 0 &&
+        CPLTestBool(CPLGetConfigOption("GDAL_OPEN_USE_SIGNATURES", "YES"));
+    if( bUseSignatures )
+        poDM->GetOpenCandidateDrivers( oOpenInfo.pabyHeader,
+                                       oOpenInfo.nHeaderBytes,
+                                       apoCandidateDrivers );
+    const int nDriverCount = bUseSignatures ?
+        static_cast<int>(apoCandidateDrivers.size()) : poDM->GetDriverCount();
+
+    for( iDriver = -1; iDriver < nDriverCount; iDriver++ )
     {
         GDALDriver      *poDriver;
         GDALDataset     *poDS;
@@ -2714,7 +3143,8 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char* pszFilename,
             poDriver = GDALGetAPIPROXYDriver();
         else
         {
-            poDriver = poDM->GetDriver( iDriver );
+            poDriver = bUseSignatures ? apoCandidateDrivers[iDriver] :
+                                        poDM->GetDriver( iDriver );
             if (papszAllowedDrivers != NULL &&
                 CSLFindString((char**)papszAllowedDrivers, GDALGetDriverShortName(poDriver)) == -1)
                 continue;
@@ -2729,21 +3159,30 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char* pszFilename,
             poDriver->GetMetadataItem(GDAL_DCAP_VECTOR) == NULL )
             continue;
 
-        /* Remove general OVERVIEW_LEVEL open options from list before */
-        /* passing it to the driver, if it isn't a driver specific option already */
+        /* Remove general OVERVIEW_LEVEL, CACHE_QUOTA and CACHE_PRIORITY */
+        /* open options from list before passing it to the driver, if they */
+        /* aren't driver specific options already */
         char** papszTmpOpenOptions = NULL;
         char** papszTmpOpenOptionsToValidate = NULL;
         char** papszOptionsToValidate = (char**) papszOpenOptions;
-        if( CSLFetchNameValue(papszOpenOptionsCleaned, "OVERVIEW_LEVEL") != NULL &&
-            (poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST) == NULL ||
-             CPLString(poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST)).ifind("OVERVIEW_LEVEL") == std::string::npos) )
+        bool bOpenOptionsDuplicated = false;
+        for( int iOption = 0; apszGenericOpenOptions[iOption] != NULL; iOption++ )
         {
-            papszTmpOpenOptions = CSLDuplicate(papszOpenOptionsCleaned);
-            papszTmpOpenOptions = CSLSetNameValue(papszTmpOpenOptions, "OVERVIEW_LEVEL", NULL);
+            const char* pszKey = apszGenericOpenOptions[iOption];
+            if( CSLFetchNameValue(papszOpenOptionsCleaned, pszKey) == NULL ||
+                !GDALIsGenericOpenOption(poDriver, pszKey) )
+                continue;
+
+            if( !bOpenOptionsDuplicated )
+            {
+                papszTmpOpenOptions = CSLDuplicate(papszOpenOptionsCleaned);
+                papszOptionsToValidate = CSLDuplicate(papszOptionsToValidate);
+                bOpenOptionsDuplicated = true;
+            }
+            papszTmpOpenOptions = CSLSetNameValue(papszTmpOpenOptions, pszKey, NULL);
             oOpenInfo.papszOpenOptions = papszTmpOpenOptions;
 
-            papszOptionsToValidate = CSLDuplicate(papszOptionsToValidate);
-            papszOptionsToValidate = CSLSetNameValue(papszOptionsToValidate, "OVERVIEW_LEVEL", NULL);
+            papszOptionsToValidate = CSLSetNameValue(papszOptionsToValidate, pszKey, NULL);
             papszTmpOpenOptionsToValidate = papszOptionsToValidate;
         }
 
@@ -2826,11 +3265,13 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char* pszFilename,
                 }
             }
 
+            /* Deal with generic CACHE_QUOTA and CACHE_PRIORITY open options */
+            GDALApplyCacheOpenOptions(poDS, poDriver, papszOpenOptions);
+
             /* Deal with generic OVERVIEW_LEVEL open option, unless it is */
             /* driver specific */
             if( CSLFetchNameValue((char**) papszOpenOptions, "OVERVIEW_LEVEL") != NULL &&
-                (poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST) == NULL ||
-                CPLString(poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST)).ifind("OVERVIEW_LEVEL") == std::string::npos) )
+                GDALIsGenericOpenOption(poDriver, "OVERVIEW_LEVEL") )
             {
                 CPLString osVal(CSLFetchNameValue((char**) papszOpenOptions, "OVERVIEW_LEVEL"));
                 int nOvrLevel = atoi(osVal);
@@ -2977,13 +3418,17 @@ void CPL_STDCALL GDALClose( GDALDatasetH hDS )
         if( poDS->Dereference() > 0 )
             return;
 
+        GDALBlockPrefetcher::DetachDataset( poDS );
         delete poDS;
         return;
     }
 
 /* -------------------------------------------------------------------- */
 /*      This is not shared dataset, so directly delete it.              */
+/*      Reads ahead of the dataset must be stopped before the driver    */
+/*      destructor starts releasing its resources.                      */
 /* -------------------------------------------------------------------- */
+    GDALBlockPrefetcher::DetachDataset( poDS );
     delete poDS;
 }
 
@@ -6086,6 +6531,11 @@ int GDALDataset::EnterReadWrite(GDALRWFlag eRWFlag)
             return TRUE;
         }
     }
+    else if( psPrivate != NULL )
+    {
+        // Serialize with the threads reading blocks ahead of us, if any.
+        return GDALBlockPrefetcher::EnterDataset(this);
+    }
     return FALSE;
 }
 
@@ -6096,6 +6546,11 @@ int GDALDataset::EnterReadWrite(GDALRWFlag eRWFlag)
 void GDALDataset::LeaveReadWrite()
 {
     GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate && eAccess != GA_Update &&
+        GDALBlockPrefetcher::LeaveDataset(this) )
+    {
+        return;
+    }
     if( psPrivate )
     {
         psPrivate->nMutexTakenCount --;
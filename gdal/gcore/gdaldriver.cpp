@@ -29,6 +29,7 @@
  ****************************************************************************/
 
 #include "gdal_priv.h"
+#include "cpl_atomic_ops.h"
 #include "ogrsf_frmts.h"
 
 CPL_CVSID("$Id$");
@@ -56,6 +57,9 @@ GDALDriver::GDALDriver()
     pfnOpenWithDriverArg = NULL;
     pfnCreateVectorOnly = NULL;
     pfnDeleteDataSource = NULL;
+    pfnInitMetadata = NULL;
+    nMetadataInitialized = FALSE;
+    bInitializingMetadata = false;
 }
 
 /************************************************************************/
@@ -1893,6 +1897,36 @@ GDALIdentifyDriver( const char * pszFilename,
     return NULL;
 }
 
+/************************************************************************/
+/*                   GDALDriverIsDeferredMetadataItem()                 */
+/************************************************************************/
+
+/* Capabilities and signatures are set at registration time (they drive */
+/* GDALOpenEx()), so querying them must not materialize the rest. */
+static bool GDALDriverIsDeferredMetadataItem( const char * pszName,
+                                              const char * pszDomain )
+{
+    if( pszDomain != NULL && pszDomain[0] != '\0' )
+        return true;
+    if( pszName == NULL )
+        return true;
+    return !STARTS_WITH_CI(pszName, "DCAP_") &&
+           !EQUAL(pszName, GDAL_DMD_SIGNATURES);
+}
+
+/************************************************************************/
+/*                            SetMetadata()                             */
+/************************************************************************/
+
+CPLErr GDALDriver::SetMetadata( char ** papszMetadata,
+                                const char * pszDomain )
+
+{
+    // Items set before the deferred metadata must not be overwritten by it.
+    InitMetadata();
+    return GDALMajorObject::SetMetadata( papszMetadata, pszDomain );
+}
+
 /************************************************************************/
 /*                          SetMetadataItem()                           */
 /************************************************************************/
@@ -1902,6 +1936,10 @@ CPLErr GDALDriver::SetMetadataItem( const char * pszName,
                                     const char * pszDomain )
 
 {
+    // Items set before the deferred metadata must not be overwritten by it.
+    if( GDALDriverIsDeferredMetadataItem( pszName, pszDomain ) )
+        InitMetadata();
+
     if( pszDomain == NULL || pszDomain[0] == '\0' )
     {
         /* Automatically sets GDAL_DMD_EXTENSIONS from GDAL_DMD_EXTENSION */
@@ -1913,3 +1951,88 @@ CPLErr GDALDriver::SetMetadataItem( const char * pszName,
     }
     return GDALMajorObject::SetMetadataItem(pszName, pszValue, pszDomain);
 }
+
+/************************************************************************/
+/*                            InitMetadata()                            */
+/************************************************************************/
+
+/**
+ * \brief Materialize the deferred metadata of the driver.
+ *
+ * Invokes pfnInitMetadata if the driver defines it and it has not yet been
+ * run. This is done automatically by GetMetadata(), GetMetadataItem(),
+ * GetMetadataDomainList(), SetMetadata() and SetMetadataItem() when needed,
+ * so there is normally no need to call it explicitly.
+ *
+ * The metadata is built with the mutex of the driver manager held. Once it
+ * is built, it is read without locking.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALDriver::InitMetadata()
+
+{
+    // pfnInitMetadata is only set before registration, so it can be read
+    // without locking. The flag is read with a memory barrier, so that the
+    // metadata built by another thread is visible once it is set.
+    if( pfnInitMetadata == NULL || CPLAtomicAdd(&nMetadataInitialized, 0) )
+        return;
+
+    CPLMutexHolderD( GDALGetphDMMutex() );
+
+    /* Another thread might have done the job while we were waiting, */
+    /* and the callback itself might query its own metadata. */
+    if( nMetadataInitialized || bInitializingMetadata )
+        return;
+
+    bInitializingMetadata = true;
+    pfnInitMetadata( this );
+    bInitializingMetadata = false;
+    CPLAtomicAdd( &nMetadataInitialized, 1 );
+}
+
+/************************************************************************/
+/*                       GetMetadataDomainList()                        */
+/************************************************************************/
+
+char **GDALDriver::GetMetadataDomainList()
+
+{
+    InitMetadata();
+    return GDALMajorObject::GetMetadataDomainList();
+}
+
+/************************************************************************/
+/*                            GetMetadata()                             */
+/************************************************************************/
+
+char **GDALDriver::GetMetadata( const char * pszDomain )
+
+{
+    InitMetadata();
+    return GDALMajorObject::GetMetadata( pszDomain );
+}
+
+/************************************************************************/
+/*                          GetMetadataItem()                           */
+/************************************************************************/
+
+const char *GDALDriver::GetMetadataItem( const char * pszName,
+                                         const char * pszDomain )
+
+{
+    if( GDALDriverIsDeferredMetadataItem( pszName, pszDomain ) )
+    {
+        InitMetadata();
+    }
+    else if( pfnInitMetadata != NULL &&
+             !CPLAtomicAdd(&nMetadataInitialized, 0) )
+    {
+        // Capabilities do not need the deferred metadata, but must not be
+        // looked up while another thread builds it.
+        CPLMutexHolderD( GDALGetphDMMutex() );
+        return GDALMajorObject::GetMetadataItem( pszName, pszDomain );
+    }
+    return GDALMajorObject::GetMetadataItem( pszName, pszDomain );
+}
@@ -35,6 +35,8 @@
 #include "gdal_priv.h"
 #include "ogr_srs_api.h"
 
+#include <algorithm>
+
 #ifdef _MSC_VER
 #  ifdef MSVC_USE_VLD
 #    include <wchar.h>
@@ -98,6 +100,9 @@ GDALDriverManager::GDALDriverManager() :
 {
     CPLAssert( poDM == NULL );
 
+    bLazyDriverMetadata =
+        CPLTestBool(CPLGetConfigOption("GDAL_LAZY_DRIVER_METADATA", "YES"));
+
 /* -------------------------------------------------------------------- */
 /*      We want to push a location to search for data files             */
 /*      supporting GDAL/OGR such as EPSG csv files, S-57 definition     */
@@ -205,6 +210,11 @@ GDALDriverManager::~GDALDriverManager()
 /* -------------------------------------------------------------------- */
     PamCleanProxyDB();
 
+/* -------------------------------------------------------------------- */
+/*      Cleanup the snapshots of metadata of files.                     */
+/* -------------------------------------------------------------------- */
+    GDALMetadataSnapshotsCleanup();
+
 /* -------------------------------------------------------------------- */
 /*      Blow away all the finder hints paths.  We really should not     */
 /*      be doing all of them, but it is currently hard to keep track    */
@@ -252,6 +262,7 @@ GDALDriverManager::~GDALDriverManager()
 /* -------------------------------------------------------------------- */
 /*      Cleanup raster block mutex                                      */
 /* -------------------------------------------------------------------- */
+    GDALBlockPrefetcher::Cleanup();
     GDALRasterBlock::DestroyRBMutex();
 
 /* -------------------------------------------------------------------- */
@@ -377,6 +388,11 @@ GDALDriverH CPL_STDCALL GDALGetDriver( int iDriver )
  * is returned.  Otherwise the driver list is extended, and the new driver
  * is added at the end.
  *
+ * If the driver defines GDALDriver::pfnInitMetadata, its descriptive
+ * metadata is only built the first time it is requested. Setting the
+ * GDAL_LAZY_DRIVER_METADATA configuration option to NO (before the driver
+ * manager is created) builds it at registration time instead.
+ *
  * @param poDriver the driver to register.
  *
  * @return the index of the new installed driver.
@@ -439,7 +455,13 @@ int GDALDriverManager::RegisterDriver( GDALDriver * poDriver )
         poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     }
 
-    if( poDriver->GetMetadataItem( GDAL_DMD_OPENOPTIONLIST ) != NULL &&
+    if( !bLazyDriverMetadata )
+        poDriver->InitMetadata();
+
+    /* Only look at the metadata set at registration time, so as not to */
+    /* materialize deferred metadata */
+    if( poDriver->GDALMajorObject::GetMetadataItem(
+                                        GDAL_DMD_OPENOPTIONLIST ) != NULL &&
         poDriver->pfnIdentify == NULL &&
         !STARTS_WITH_CI(poDriver->GetDescription(), "Interlis") )
     {
@@ -450,6 +472,8 @@ int GDALDriverManager::RegisterDriver( GDALDriver * poDriver )
 
     oMapNameToDrivers[CPLString(poDriver->GetDescription()).toupper()] = poDriver;
 
+    abHasSignatures.push_back( IndexSignatures_unlocked( poDriver ) );
+
     int iResult = nDrivers - 1;
 
     return iResult;
@@ -504,6 +528,19 @@ void GDALDriverManager::DeregisterDriver( GDALDriver * poDriver )
         return;
 
     oMapNameToDrivers.erase(CPLString(poDriver->GetDescription()).toupper());
+    abHasSignatures.erase(abHasSignatures.begin() + i);
+    for( int iByte = 0; iByte < 256; iByte++ )
+    {
+        std::vector< std::pair<std::string, GDALDriver*> >& aoEntries =
+                                                    aoSignatureIndex[iByte];
+        for( size_t j = 0; j < aoEntries.size(); )
+        {
+            if( aoEntries[j].second == poDriver )
+                aoEntries.erase(aoEntries.begin() + j);
+            else
+                j++;
+        }
+    }
     nDrivers--;
     // Move all following drivers down by one to pack the list.
     while( i < nDrivers )
@@ -513,6 +550,95 @@ void GDALDriverManager::DeregisterDriver( GDALDriver * poDriver )
     }
 }
 
+/************************************************************************/
+/*                      IndexSignatures_unlocked()                      */
+/*                                                                      */
+/*      Add the GDAL_DMD_SIGNATURES of the driver to the dispatch       */
+/*      index, and return whether it declares any.                      */
+/************************************************************************/
+
+bool GDALDriverManager::IndexSignatures_unlocked( GDALDriver * poDriver )
+
+{
+    const char* pszSignatures = poDriver->GetMetadataItem( GDAL_DMD_SIGNATURES );
+    if( pszSignatures == NULL )
+        return false;
+
+    char** papszSignatures = CSLTokenizeString( pszSignatures );
+    bool bHasSignatures = false;
+    for( char** papszIter = papszSignatures; *papszIter; ++papszIter )
+    {
+        int nBytes = 0;
+        GByte* pabySignature = CPLHexToBinary( *papszIter, &nBytes );
+        if( nBytes > 0 )
+        {
+            aoSignatureIndex[pabySignature[0]].push_back(
+                std::pair<std::string, GDALDriver*>(
+                    std::string((const char*)pabySignature, nBytes), poDriver) );
+            bHasSignatures = true;
+        }
+        else
+        {
+            CPLDebug( "GDAL", "Invalid signature '%s' for driver %s",
+                      *papszIter, poDriver->GetDescription() );
+        }
+        CPLFree( pabySignature );
+    }
+    CSLDestroy( papszSignatures );
+
+    return bHasSignatures;
+}
+
+/************************************************************************/
+/*                      GetOpenCandidateDrivers()                       */
+/************************************************************************/
+
+/**
+ * \brief Fetch the drivers that may open a file with the given header.
+ *
+ * Drivers that declare GDAL_DMD_SIGNATURES are only returned if the header
+ * starts with one of their signatures. All other drivers are returned. The
+ * drivers are returned in registration order.
+ *
+ * @param pabyHeader the first bytes of the file.
+ * @param nHeaderBytes the number of bytes in pabyHeader.
+ * @param apoDrivers the vector to fill with the candidate drivers.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALDriverManager::GetOpenCandidateDrivers( const GByte* pabyHeader,
+                                                 int nHeaderBytes,
+                                                 std::vector<GDALDriver*>& apoDrivers )
+
+{
+    CPLMutexHolderD( &hDMMutex );
+
+    std::vector<GDALDriver*> apoMatchingDrivers;
+    if( nHeaderBytes > 0 )
+    {
+        const std::vector< std::pair<std::string, GDALDriver*> >& aoEntries =
+                                            aoSignatureIndex[pabyHeader[0]];
+        for( size_t i = 0; i < aoEntries.size(); i++ )
+        {
+            const std::string& osSignature = aoEntries[i].first;
+            if( (int)osSignature.size() <= nHeaderBytes &&
+                memcmp(pabyHeader, osSignature.data(), osSignature.size()) == 0 )
+                apoMatchingDrivers.push_back(aoEntries[i].second);
+        }
+    }
+
+    apoDrivers.clear();
+    apoDrivers.reserve(nDrivers);
+    for( int i = 0; i < nDrivers; i++ )
+    {
+        if( !abHasSignatures[i] ||
+            std::find(apoMatchingDrivers.begin(), apoMatchingDrivers.end(),
+                      papoDrivers[i]) != apoMatchingDrivers.end() )
+            apoDrivers.push_back(papoDrivers[i]);
+    }
+}
+
 /************************************************************************/
 /*                        GDALDeregisterDriver()                        */
 /************************************************************************/
@@ -293,10 +293,16 @@ GDALRasterBlock *GDALHashSetBandBlockCache::TryGetLockedBlockRef( int nXBlockOff
         }
         if( poBlock == NULL )
             return NULL;
-        if( poBlock->TakeLock()  )
-            break;
+        if( poBlock->TakeLock() )
+        {
+            // The block might have been evicted, and the lookup entry
+            // reused by another block, since we looked it up.
+            if( poBlock->GetXOff() == nXBlockOff &&
+                poBlock->GetYOff() == nYBlockOff )
+                break;
+            poBlock->DropLock();
+        }
     }
 
-    poBlock->Touch();
     return poBlock;
 }
@@ -0,0 +1,285 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Process-wide cache of metadata resolved from files, so that
+ *           reopening a file does not parse it again.
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_priv.h"
+#include "cpl_multiproc.h"
+
+#include <list>
+#include <map>
+
+CPL_CVSID("$Id$");
+
+/* Snapshots of a file, valid as long as its size and modification time */
+/* do not change */
+typedef struct
+{
+    vsi_l_offset nSize;
+    time_t       nMTime;
+    std::map<CPLString, CPLXMLNode*>* poMapSnapshots;
+    /* Position of the file in poSnapshotLRU */
+    std::list<CPLString>::iterator oIterLRU;
+} GDALFileSnapshots;
+
+static CPLMutex *hSnapshotMutex = NULL;
+static std::map<CPLString, GDALFileSnapshots> *poSnapshotCache = NULL;
+/* Files of the cache, from the most to the least recently used */
+static std::list<CPLString> *poSnapshotLRU = NULL;
+static volatile int bSnapshotCacheUsed = FALSE;
+
+/* Maximum number of files in the cache, beyond which the least recently */
+/* used one is discarded */
+#define MAX_SNAPSHOT_FILES  1024
+
+/************************************************************************/
+/*                     GDALIsMetadataSnapshotEnabled()                  */
+/************************************************************************/
+
+static int GDALIsMetadataSnapshotEnabled()
+{
+    return CPLTestBool(
+        CPLGetConfigOption("GDAL_METADATA_SNAPSHOT_CACHE", "NO"));
+}
+
+/************************************************************************/
+/*                    GDALRemoveFileSnapshots_unlocked()                */
+/************************************************************************/
+
+static void GDALRemoveFileSnapshots_unlocked(
+    std::map<CPLString, GDALFileSnapshots>::iterator oIter )
+{
+    std::map<CPLString, CPLXMLNode*>* poMap = oIter->second.poMapSnapshots;
+    for( std::map<CPLString, CPLXMLNode*>::iterator oIterSnapshot =
+                                                            poMap->begin();
+         oIterSnapshot != poMap->end(); ++oIterSnapshot )
+    {
+        CPLDestroyXMLNode( oIterSnapshot->second );
+    }
+    delete poMap;
+    poSnapshotLRU->erase( oIter->second.oIterLRU );
+    poSnapshotCache->erase( oIter );
+}
+
+/************************************************************************/
+/*                       GDALGetMetadataSnapshot()                      */
+/************************************************************************/
+
+/**
+ * \brief Returns a snapshot of metadata resolved from a file.
+ *
+ * Drivers store with GDALSetMetadataSnapshot() the result of expensive
+ * parsing of a file, like the resolution of its coordinate system or of its
+ * .aux.xml, and get it back the next time the file is opened, as long as the
+ * size and the modification time of the file have not changed. This is only
+ * active if the GDAL_METADATA_SNAPSHOT_CACHE configuration option is set to
+ * YES.
+ *
+ * @param pszFilename file from which the metadata was resolved.
+ * @param pszKey name of the snapshot, that must identify the driver and
+ * what was resolved.
+ *
+ * @return a copy of the snapshot, to free with CPLDestroyXMLNode(), or NULL.
+ *
+ * @since GDAL 2.2
+ */
+
+CPLXMLNode* GDALGetMetadataSnapshot( const char* pszFilename,
+                                     const char* pszKey )
+{
+    if( !bSnapshotCacheUsed || !GDALIsMetadataSnapshotEnabled() )
+        return NULL;
+
+    VSIStatBufL sStat;
+    const int bStatOK = VSIStatL( pszFilename, &sStat ) == 0;
+
+    CPLMutexHolderD( &hSnapshotMutex );
+    if( poSnapshotCache == NULL )
+        return NULL;
+    std::map<CPLString, GDALFileSnapshots>::iterator oIter =
+        poSnapshotCache->find( pszFilename );
+    if( oIter == poSnapshotCache->end() )
+        return NULL;
+    if( !bStatOK || oIter->second.nSize != static_cast<vsi_l_offset>(sStat.st_size) ||
+        oIter->second.nMTime != sStat.st_mtime )
+    {
+        GDALRemoveFileSnapshots_unlocked( oIter );
+        return NULL;
+    }
+
+    std::map<CPLString, CPLXMLNode*>::iterator oIterSnapshot =
+        oIter->second.poMapSnapshots->find( pszKey );
+    if( oIterSnapshot == oIter->second.poMapSnapshots->end() )
+        return NULL;
+    poSnapshotLRU->splice( poSnapshotLRU->begin(), *poSnapshotLRU,
+                           oIter->second.oIterLRU );
+    return CPLCloneXMLTree( oIterSnapshot->second );
+}
+
+/************************************************************************/
+/*                       GDALSetMetadataSnapshot()                      */
+/************************************************************************/
+
+/**
+ * \brief Stores a snapshot of metadata resolved from a file.
+ *
+ * Does nothing if the GDAL_METADATA_SNAPSHOT_CACHE configuration option is
+ * not set to YES.
+ *
+ * @param pszFilename file from which the metadata was resolved.
+ * @param pszKey name of the snapshot.
+ * @param psSnapshot the snapshot, that is copied.
+ *
+ * @see GDALGetMetadataSnapshot()
+ * @since GDAL 2.2
+ */
+
+void GDALSetMetadataSnapshot( const char* pszFilename, const char* pszKey,
+                              const CPLXMLNode* psSnapshot )
+{
+    if( psSnapshot == NULL || !GDALIsMetadataSnapshotEnabled() )
+        return;
+
+    VSIStatBufL sStat;
+    if( VSIStatL( pszFilename, &sStat ) != 0 )
+        return;
+
+    CPLMutexHolderD( &hSnapshotMutex );
+    if( poSnapshotCache == NULL )
+    {
+        poSnapshotCache = new std::map<CPLString, GDALFileSnapshots>();
+        poSnapshotLRU = new std::list<CPLString>();
+    }
+
+    std::map<CPLString, GDALFileSnapshots>::iterator oIter =
+        poSnapshotCache->find( pszFilename );
+    if( oIter != poSnapshotCache->end() &&
+        (oIter->second.nSize != static_cast<vsi_l_offset>(sStat.st_size) ||
+         oIter->second.nMTime != sStat.st_mtime) )
+    {
+        GDALRemoveFileSnapshots_unlocked( oIter );
+        oIter = poSnapshotCache->end();
+    }
+    if( oIter == poSnapshotCache->end() )
+    {
+        if( poSnapshotCache->size() >= MAX_SNAPSHOT_FILES )
+            GDALRemoveFileSnapshots_unlocked(
+                poSnapshotCache->find( poSnapshotLRU->back() ) );
+
+        poSnapshotLRU->push_front( pszFilename );
+        GDALFileSnapshots sSnapshots;
+        sSnapshots.nSize = static_cast<vsi_l_offset>(sStat.st_size);
+        sSnapshots.nMTime = sStat.st_mtime;
+        sSnapshots.poMapSnapshots = new std::map<CPLString, CPLXMLNode*>();
+        sSnapshots.oIterLRU = poSnapshotLRU->begin();
+        oIter = poSnapshotCache->insert(
+            std::pair<CPLString, GDALFileSnapshots>(pszFilename,
+                                                    sSnapshots) ).first;
+    }
+    else
+    {
+        poSnapshotLRU->splice( poSnapshotLRU->begin(), *poSnapshotLRU,
+                               oIter->second.oIterLRU );
+    }
+
+    std::map<CPLString, CPLXMLNode*>& oMap = *(oIter->second.poMapSnapshots);
+    std::map<CPLString, CPLXMLNode*>::iterator oIterSnapshot =
+        oMap.find( pszKey );
+    if( oIterSnapshot != oMap.end() )
+        CPLDestroyXMLNode( oIterSnapshot->second );
+    oMap[pszKey] = CPLCloneXMLTree( const_cast<CPLXMLNode*>(psSnapshot) );
+    bSnapshotCacheUsed = TRUE;
+}
+
+/************************************************************************/
+/*                   GDALInvalidateMetadataSnapshots()                  */
+/************************************************************************/
+
+/**
+ * \brief Discards the snapshots of a file.
+ *
+ * To be called by drivers when they modify a file, as its modification time
+ * only has a resolution of a second.
+ *
+ * @param pszFilename file whose snapshots must be discarded.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALInvalidateMetadataSnapshots( const char* pszFilename )
+{
+    if( !bSnapshotCacheUsed )
+        return;
+
+    CPLMutexHolderD( &hSnapshotMutex );
+    if( poSnapshotCache == NULL )
+        return;
+    std::map<CPLString, GDALFileSnapshots>::iterator oIter =
+        poSnapshotCache->find( pszFilename );
+    if( oIter != poSnapshotCache->end() )
+        GDALRemoveFileSnapshots_unlocked( oIter );
+}
+
+/************************************************************************/
+/*                     GDALFlushMetadataSnapshots()                     */
+/************************************************************************/
+
+/**
+ * \brief Discards all the snapshots of metadata.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALFlushMetadataSnapshots()
+{
+    CPLMutexHolderD( &hSnapshotMutex );
+    if( poSnapshotCache != NULL )
+    {
+        while( !poSnapshotCache->empty() )
+            GDALRemoveFileSnapshots_unlocked( poSnapshotCache->begin() );
+        delete poSnapshotCache;
+        poSnapshotCache = NULL;
+        delete poSnapshotLRU;
+        poSnapshotLRU = NULL;
+    }
+    bSnapshotCacheUsed = FALSE;
+}
+
+/************************************************************************/
+/*                    GDALMetadataSnapshotsCleanup()                    */
+/************************************************************************/
+
+void GDALMetadataSnapshotsCleanup()
+{
+    GDALFlushMetadataSnapshots();
+    if( hSnapshotMutex != NULL )
+    {
+        CPLDestroyMutex( hSnapshotMutex );
+        hSnapshotMutex = NULL;
+    }
+}
@@ -589,6 +589,28 @@ int GDALPamDataset::IsPamFilenameAPotentialSiblingFile()
     return bIsSiblingPamFile;
 }
 
+/************************************************************************/
+/*                        GDALPamParseXMLFile()                         */
+/*                                                                      */
+/*      Parses a .aux.xml file, or gets it from the snapshots of        */
+/*      metadata if GDAL_METADATA_SNAPSHOT_CACHE is set.                */
+/************************************************************************/
+
+static CPLXMLNode *GDALPamParseXMLFile( const char* pszPamFilename )
+{
+    CPLXMLNode *psTree = GDALGetMetadataSnapshot( pszPamFilename, "PAM" );
+    if( psTree != NULL )
+        return psTree;
+
+    CPLErrorReset();
+    CPLPushErrorHandler( CPLQuietErrorHandler );
+    psTree = CPLParseXMLFile( pszPamFilename );
+    CPLPopErrorHandler();
+
+    GDALSetMetadataSnapshot( pszPamFilename, "PAM", psTree );
+    return psTree;
+}
+
 /************************************************************************/
 /*                             TryLoadXML()                             */
 /************************************************************************/
@@ -628,22 +650,14 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
             CSLFindString( papszSiblingFiles,
                            CPLGetFilename(psPam->pszPamFilename) );
         if( iSibling >= 0 )
-        {
-            CPLErrorReset();
-            CPLPushErrorHandler( CPLQuietErrorHandler );
-            psTree = CPLParseXMLFile( psPam->pszPamFilename );
-            CPLPopErrorHandler();
-        }
+            psTree = GDALPamParseXMLFile( psPam->pszPamFilename );
     }
     else
     if( VSIStatExL( psPam->pszPamFilename, &sStatBuf,
                     VSI_STAT_EXISTS_FLAG | VSI_STAT_NATURE_FLAG ) == 0
         && VSI_ISREG( sStatBuf.st_mode ) )
     {
-        CPLErrorReset();
-        CPLPushErrorHandler( CPLQuietErrorHandler );
-        psTree = CPLParseXMLFile( psPam->pszPamFilename );
-        CPLPopErrorHandler();
+        psTree = GDALPamParseXMLFile( psPam->pszPamFilename );
     }
 
 /* -------------------------------------------------------------------- */
@@ -727,6 +741,7 @@ CPLErr GDALPamDataset::TrySaveXML()
         CPLPushErrorHandler( CPLQuietErrorHandler );
         VSIUnlink(psPam->pszPamFilename);
         CPLPopErrorHandler();
+        GDALInvalidateMetadataSnapshots( psPam->pszPamFilename );
         return CE_None;
     }
 
@@ -791,6 +806,11 @@ CPLErr GDALPamDataset::TrySaveXML()
         CPLSerializeXMLTreeToFile( psTree, psPam->pszPamFilename );
     CPLPopErrorHandler();
 
+    /* Only once the file is written, so that a concurrent open cannot */
+    /* snapshot its previous content again */
+    if( bSaved )
+        GDALInvalidateMetadataSnapshots( psPam->pszPamFilename );
+
 /* -------------------------------------------------------------------- */
 /*      If it fails, check if we have a proxy directory for auxiliary    */
 /*      metadata to be stored in, and try to save there.                */
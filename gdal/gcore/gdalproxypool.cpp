@@ -31,25 +31,38 @@
 #include "gdal_proxy.h"
 #include "cpl_multiproc.h"
 
+#include <map>
+#include <set>
+
 CPL_CVSID("$Id$");
 
-/* We *must* share the same mutex as the gdaldataset.cpp file, as we are */
-/* doing GDALOpen() calls that can indirectly call GDALOpenShared() on */
-/* an auxiliary dataset ... */
-/* Then we could get dead-locks in multi-threaded use case */
+/* The pool is split in shards, selected by the hash of the file name, */
+/* that each have their own mutex and LRU list, so that threads using */
+/* different underlying datasets do not serialize on a single lock. */
+/* No lock of the pool is held while an underlying dataset is opened or */
+/* closed : GDALOpen() can indirectly call GDALOpenShared() on an */
+/* auxiliary dataset, and doing it with a lock of the pool held would */
+/* cause dead-locks with threads that hold the mutex of gdaldataset.cpp */
+/* and call into the pool. The singleton itself is still created and */
+/* destroyed under the mutex of gdaldataset.cpp */
 
 /* ******************************************************************** */
 /*                         GDALDatasetPool                              */
 /* ******************************************************************** */
 
 /* This class is a singleton that maintains a pool of opened datasets */
-/* The cache uses a LRU strategy */
+/* The cache uses a LRU strategy within each shard */
 
 class GDALDatasetPool;
 static GDALDatasetPool* singleton = NULL;
 
 void GDALNullifyProxyPoolSingleton() { singleton = NULL; }
 
+/* Statistics of the pools that have been destroyed */
+static GIntBig nPoolHitsOfDestroyedPools = 0;
+static GIntBig nPoolMissesOfDestroyedPools = 0;
+static GIntBig nPoolReopensOfDestroyedPools = 0;
+
 struct _GDALProxyPoolCacheEntry
 {
     GIntBig       responsiblePID;
@@ -59,10 +72,39 @@ struct _GDALProxyPoolCacheEntry
     /* Ref count of the cached dataset */
     int           refCount;
 
+    /* Thread that opened the dataset, for GDAL_DATASET_POOL_PER_THREAD */
+    GIntBig       threadID;
+
+    /* Set while the dataset is opened, outside of the lock of the shard */
+    int           bOpening;
+
+    int           iShard;
+
     GDALProxyPoolCacheEntry* prev;
     GDALProxyPoolCacheEntry* next;
 };
 
+struct GDALDatasetPoolShard
+{
+    CPLMutex* hMutex;
+
+    /* Signaled when an entry has finished being opened */
+    CPLCond*  hCond;
+
+    GDALProxyPoolCacheEntry* firstEntry;
+    GDALProxyPoolCacheEntry* lastEntry;
+    int       currentSize;
+
+    std::map<GDALDataset*, GDALProxyPoolCacheEntry*> oMapDSToEntry;
+
+    /* Files whose dataset was closed to make room for another one */
+    std::set<CPLString> oSetEvictedFileNames;
+
+    GIntBig   nHits;
+    GIntBig   nMisses;
+    GIntBig   nReopens;
+};
+
 class GDALDatasetPool
 {
     private:
@@ -72,10 +114,17 @@ class GDALDatasetPool
         /* between toplevel and inner GDALProxyPoolDataset */
         int refCount;
 
+        /* Maximum number of opened datasets over all the shards. A shard */
+        /* that has no unused dataset to close can temporarily exceed it, */
+        /* up to twice its value */
         int maxSize;
-        int currentSize;
-        GDALProxyPoolCacheEntry* firstEntry;
-        GDALProxyPoolCacheEntry* lastEntry;
+        volatile int currentSize;
+
+        int nShards;
+        GDALDatasetPoolShard* pasShards;
+
+        /* If set, a dataset is only reused by the thread that opened it */
+        int bPerThread;
 
         /* This variable prevents a dataset that is going to be opened in GDALDatasetPool::_RefDataset */
         /* from increasing refCount if, during its opening, it creates a GDALProxyPoolDataset */
@@ -83,20 +132,34 @@ class GDALDatasetPool
         /* The typical use case is a VRT made of simple sources that are VRT */
         /* We don't want the "inner" VRT to take a reference on the pool, otherwise there is */
         /* a high chance that this reference will not be dropped and the pool remain ghost */
+        /* As datasets are opened and closed without the mutex of the pool held, the */
+        /* count is kept for each thread, in addition to the global one set by */
+        /* PreventDestroy() */
         int refCountOfDisableRefCount;
 
-        /* Caution : to be sure that we don't run out of entries, size must be at */
-        /* least greater or equal than the maximum number of threads */
-        GDALDatasetPool(int maxSize);
+        GDALDatasetPool(int maxSize, int nShards, int bPerThread);
         ~GDALDatasetPool();
         GDALProxyPoolCacheEntry* _RefDataset(const char* pszFileName,
                                              GDALAccess eAccess,
                                              char** papszOpenOptions,
                                              int bShared);
+        void _UnrefDataset(GDALProxyPoolCacheEntry* cacheEntry);
         void _CloseDataset(const char* pszFileName, GDALAccess eAccess);
+        void _GetStatistics(GIntBig* pnHits, GIntBig* pnMisses,
+                            GIntBig* pnReopens);
+
+        int  GetShard(const char* pszFileName) const;
+        static int  IsRefCountDisabledForThisThread();
+        static void DisableRefCountForThisThread(int nDelta);
+        static void CloseUnderlyingDataset(GDALDataset* poDS,
+                                           GIntBig responsiblePID);
+        void Unlink(GDALDatasetPoolShard* psShard,
+                    GDALProxyPoolCacheEntry* cur);
+        void Prepend(GDALDatasetPoolShard* psShard,
+                     GDALProxyPoolCacheEntry* cur);
 
         void ShowContent();
-        void CheckLinks();
+        void CheckLinks(GDALDatasetPoolShard* psShard);
 
     public:
         static void Ref();
@@ -106,7 +169,10 @@ class GDALDatasetPool
                                                    char** papszOpenOptions,
                                                    int bShared);
         static void UnrefDataset(GDALProxyPoolCacheEntry* cacheEntry);
+        static void UnrefDataset(const char* pszFileName, GDALDataset* poDS);
         static void CloseDataset(const char* pszFileName, GDALAccess eAccess);
+        static void GetStatistics(GIntBig* pnHits, GIntBig* pnMisses,
+                                  GIntBig* pnReopens);
 
         static void PreventDestroy();
         static void ForceDestroy();
@@ -117,14 +183,28 @@ class GDALDatasetPool
 /*                         GDALDatasetPool()                            */
 /************************************************************************/
 
-GDALDatasetPool::GDALDatasetPool(int maxSizeIn)
+GDALDatasetPool::GDALDatasetPool(int maxSizeIn, int nShardsIn,
+                                 int bPerThreadIn)
 {
     maxSize = maxSizeIn;
     currentSize = 0;
-    firstEntry = NULL;
-    lastEntry = NULL;
+    nShards = nShardsIn;
+    bPerThread = bPerThreadIn;
     refCount = 0;
     refCountOfDisableRefCount = 0;
+
+    pasShards = new GDALDatasetPoolShard[nShards];
+    for( int i = 0; i < nShards; i++ )
+    {
+        pasShards[i].hMutex = NULL;
+        pasShards[i].hCond = CPLCreateCond();
+        pasShards[i].firstEntry = NULL;
+        pasShards[i].lastEntry = NULL;
+        pasShards[i].currentSize = 0;
+        pasShards[i].nHits = 0;
+        pasShards[i].nMisses = 0;
+        pasShards[i].nReopens = 0;
+    }
 }
 
 /************************************************************************/
@@ -133,22 +213,52 @@ GDALDatasetPool::GDALDatasetPool(int maxSizeIn)
 
 GDALDatasetPool::~GDALDatasetPool()
 {
-    GDALProxyPoolCacheEntry* cur = firstEntry;
     GIntBig responsiblePID = GDALGetResponsiblePIDForCurrentThread();
-    while(cur)
+    for( int i = 0; i < nShards; i++ )
     {
-        GDALProxyPoolCacheEntry* next = cur->next;
-        CPLFree(cur->pszFileName);
-        CPLAssert(cur->refCount == 0);
-        if (cur->poDS)
+        /* Detach the list first, as closing a dataset may close inner */
+        /* proxy datasets that look for their own entries */
+        GDALDatasetPoolShard* psShard = &pasShards[i];
+        GDALProxyPoolCacheEntry* cur = psShard->firstEntry;
+        psShard->firstEntry = NULL;
+        psShard->lastEntry = NULL;
+        psShard->currentSize = 0;
+        psShard->oMapDSToEntry.clear();
+        while(cur)
         {
-            GDALSetResponsiblePIDForCurrentThread(cur->responsiblePID);
-            GDALClose(cur->poDS);
+            GDALProxyPoolCacheEntry* next = cur->next;
+            CPLFree(cur->pszFileName);
+            CPLAssert(cur->refCount == 0);
+            if (cur->poDS)
+            {
+                GDALSetResponsiblePIDForCurrentThread(cur->responsiblePID);
+                GDALClose(cur->poDS);
+            }
+            CPLFree(cur);
+            cur = next;
         }
-        CPLFree(cur);
-        cur = next;
     }
     GDALSetResponsiblePIDForCurrentThread(responsiblePID);
+
+    for( int i = 0; i < nShards; i++ )
+    {
+        GDALDatasetPoolShard* psShard = &pasShards[i];
+        nPoolHitsOfDestroyedPools += psShard->nHits;
+        nPoolMissesOfDestroyedPools += psShard->nMisses;
+        nPoolReopensOfDestroyedPools += psShard->nReopens;
+
+        if( psShard->hMutex )
+            CPLDestroyMutex(psShard->hMutex);
+        if( psShard->hCond )
+            CPLDestroyCond(psShard->hCond);
+    }
+
+    CPLDebug("GDAL", "Dataset pool: " CPL_FRMT_GIB " hits, " CPL_FRMT_GIB
+             " misses, " CPL_FRMT_GIB " reopens",
+             nPoolHitsOfDestroyedPools, nPoolMissesOfDestroyedPools,
+             nPoolReopensOfDestroyedPools);
+
+    delete[] pasShards;
 }
 
 /************************************************************************/
@@ -157,14 +267,18 @@ GDALDatasetPool::~GDALDatasetPool()
 
 void GDALDatasetPool::ShowContent()
 {
-    GDALProxyPoolCacheEntry* cur = firstEntry;
-    int i = 0;
-    while(cur)
+    for( int iShard = 0; iShard < nShards; iShard++ )
     {
-        printf("[%d] pszFileName=%s, refCount=%d, responsiblePID=%d\n",
-               i, cur->pszFileName, cur->refCount, (int)cur->responsiblePID);
-        i++;
-        cur = cur->next;
+        GDALProxyPoolCacheEntry* cur = pasShards[iShard].firstEntry;
+        int i = 0;
+        while(cur)
+        {
+            printf("[%d][%d] pszFileName=%s, refCount=%d, responsiblePID=%d\n",
+                   iShard, i, cur->pszFileName, cur->refCount,
+                   (int)cur->responsiblePID);
+            i++;
+            cur = cur->next;
+        }
     }
 }
 
@@ -172,19 +286,107 @@ void GDALDatasetPool::ShowContent()
 /*                             CheckLinks()                             */
 /************************************************************************/
 
-void GDALDatasetPool::CheckLinks()
+void GDALDatasetPool::CheckLinks(GDALDatasetPoolShard* psShard)
 {
-    GDALProxyPoolCacheEntry* cur = firstEntry;
+    GDALProxyPoolCacheEntry* cur = psShard->firstEntry;
     int i = 0;
     while(cur)
     {
-        CPLAssert(cur == firstEntry || cur->prev->next == cur);
-        CPLAssert(cur == lastEntry || cur->next->prev == cur);
+        CPLAssert(cur == psShard->firstEntry || cur->prev->next == cur);
+        CPLAssert(cur == psShard->lastEntry || cur->next->prev == cur);
         i++;
-	CPLAssert(cur->next != NULL || cur == lastEntry);
+        CPLAssert(cur->next != NULL || cur == psShard->lastEntry);
         cur = cur->next;
     }
-    CPLAssert(i == currentSize);
+    CPLAssert(i == psShard->currentSize);
+}
+
+/************************************************************************/
+/*                              GetShard()                              */
+/************************************************************************/
+
+int GDALDatasetPool::GetShard(const char* pszFileName) const
+{
+    return static_cast<int>(CPLHashSetHashStr(pszFileName) % nShards);
+}
+
+/************************************************************************/
+/*                  IsRefCountDisabledForThisThread()                   */
+/************************************************************************/
+
+int GDALDatasetPool::IsRefCountDisabledForThisThread()
+{
+    int* pnCount = (int*) CPLGetTLS( CTLS_GDALDATASETPOOL_DISABLEREFCOUNT );
+    return pnCount != NULL && *pnCount > 0;
+}
+
+/************************************************************************/
+/*                    DisableRefCountForThisThread()                    */
+/************************************************************************/
+
+void GDALDatasetPool::DisableRefCountForThisThread(int nDelta)
+{
+    int* pnCount = (int*) CPLGetTLS( CTLS_GDALDATASETPOOL_DISABLEREFCOUNT );
+    if( pnCount == NULL )
+    {
+        pnCount = (int*) CPLCalloc(1, sizeof(int));
+        CPLSetTLS( CTLS_GDALDATASETPOOL_DISABLEREFCOUNT, pnCount, TRUE );
+    }
+    *pnCount += nDelta;
+}
+
+/************************************************************************/
+/*                       CloseUnderlyingDataset()                       */
+/************************************************************************/
+
+void GDALDatasetPool::CloseUnderlyingDataset(GDALDataset* poDS,
+                                             GIntBig responsiblePIDOfDS)
+{
+    /* Close by pretending we are the thread that GDALOpen'ed this */
+    /* dataset */
+    GIntBig responsiblePID = GDALGetResponsiblePIDForCurrentThread();
+    GDALSetResponsiblePIDForCurrentThread(responsiblePIDOfDS);
+
+    DisableRefCountForThisThread(1);
+    GDALClose(poDS);
+    DisableRefCountForThisThread(-1);
+
+    GDALSetResponsiblePIDForCurrentThread(responsiblePID);
+}
+
+/************************************************************************/
+/*                               Unlink()                               */
+/************************************************************************/
+
+void GDALDatasetPool::Unlink(GDALDatasetPoolShard* psShard,
+                             GDALProxyPoolCacheEntry* cur)
+{
+    if (cur->next)
+        cur->next->prev = cur->prev;
+    else
+        psShard->lastEntry = cur->prev;
+    if (cur->prev)
+        cur->prev->next = cur->next;
+    else
+        psShard->firstEntry = cur->next;
+    cur->prev = NULL;
+    cur->next = NULL;
+}
+
+/************************************************************************/
+/*                              Prepend()                               */
+/************************************************************************/
+
+void GDALDatasetPool::Prepend(GDALDatasetPoolShard* psShard,
+                              GDALProxyPoolCacheEntry* cur)
+{
+    cur->prev = NULL;
+    cur->next = psShard->firstEntry;
+    if (psShard->firstEntry)
+        psShard->firstEntry->prev = cur;
+    else
+        psShard->lastEntry = cur;
+    psShard->firstEntry = cur;
 }
 
 /************************************************************************/
@@ -196,159 +398,215 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
                                                       char** papszOpenOptions,
                                                       int bShared)
 {
-    GDALProxyPoolCacheEntry* cur = firstEntry;
+    const int iShard = GetShard(pszFileName);
+    GDALDatasetPoolShard* psShard = &pasShards[iShard];
     GIntBig responsiblePID = GDALGetResponsiblePIDForCurrentThread();
-    GDALProxyPoolCacheEntry* lastEntryWithZeroRefCount = NULL;
+    GIntBig threadID = CPLGetPID();
 
-    while(cur)
+    CPLMutexHolderD( &(psShard->hMutex) );
+
+    GDALProxyPoolCacheEntry* cur;
+    GDALProxyPoolCacheEntry* lastEntryWithZeroRefCount;
+    bool bRetry;
+    do
     {
-        GDALProxyPoolCacheEntry* next = cur->next;
+        bRetry = false;
+        cur = psShard->firstEntry;
+        lastEntryWithZeroRefCount = NULL;
 
-        if (strcmp(cur->pszFileName, pszFileName) == 0 &&
-            ((bShared && cur->responsiblePID == responsiblePID) ||
-             (!bShared && cur->refCount == 0)) )
+        while(cur)
         {
-            if (cur != firstEntry)
+            GDALProxyPoolCacheEntry* next = cur->next;
+
+            if (strcmp(cur->pszFileName, pszFileName) == 0 &&
+                ((bShared && cur->responsiblePID == responsiblePID) ||
+                 (!bShared && cur->refCount == 0)) &&
+                (!bPerThread || cur->threadID == threadID) )
             {
-                /* Move to begin */
-                if (cur->next)
-                    cur->next->prev = cur->prev;
-                else
-                    lastEntry = cur->prev;
-                cur->prev->next = cur->next;
-                cur->prev = NULL;
-                firstEntry->prev = cur;
-                cur->next = firstEntry;
-                firstEntry = cur;
+                /* Wait for the thread that opens it to be done */
+                if (cur->bOpening)
+                {
+                    CPLCondWait(psShard->hCond, psShard->hMutex);
+                    bRetry = true;
+                    break;
+                }
+
+                if (cur != psShard->firstEntry)
+                {
+                    /* Move to begin */
+                    Unlink(psShard, cur);
+                    Prepend(psShard, cur);
 
 #ifdef DEBUG_PROXY_POOL
-                CheckLinks();
+                    CheckLinks(psShard);
 #endif
-            }
-
-            cur->refCount ++;
-            return cur;
-        }
+                }
 
-        if (cur->refCount == 0)
-            lastEntryWithZeroRefCount = cur;
+                cur->refCount ++;
+                psShard->nHits ++;
+                return cur;
+            }
 
-        cur = next;
-    }
+            if (cur->refCount == 0)
+                lastEntryWithZeroRefCount = cur;
 
-    if (currentSize == maxSize)
-    {
-        if (lastEntryWithZeroRefCount == NULL)
-        {
-            CPLError(CE_Failure, CPLE_AppDefined,
-                     "Too many threads are running for the current value of the dataset pool size (%d).\n"
-                     "or too many proxy datasets are opened in a cascaded way.\n"
-                     "Try increasing GDAL_MAX_DATASET_POOL_SIZE.", maxSize);
-            return NULL;
+            cur = next;
         }
+    } while( bRetry );
 
-        lastEntryWithZeroRefCount->pszFileName[0] = '\0';
-        if (lastEntryWithZeroRefCount->poDS)
-        {
-            /* Close by pretending we are the thread that GDALOpen'ed this */
-            /* dataset */
-            GDALSetResponsiblePIDForCurrentThread(lastEntryWithZeroRefCount->responsiblePID);
+    psShard->nMisses ++;
+    if( psShard->oSetEvictedFileNames.find(pszFileName) !=
+                                    psShard->oSetEvictedFileNames.end() )
+        psShard->nReopens ++;
 
-            refCountOfDisableRefCount ++;
-            GDALClose(lastEntryWithZeroRefCount->poDS);
-            refCountOfDisableRefCount --;
-
-            lastEntryWithZeroRefCount->poDS = NULL;
-            GDALSetResponsiblePIDForCurrentThread(responsiblePID);
-        }
-        CPLFree(lastEntryWithZeroRefCount->pszFileName);
-
-        /* Recycle this entry for the to-be-opened dataset and */
-        /* moves it to the top of the list */
-        if (lastEntryWithZeroRefCount->prev)
-            lastEntryWithZeroRefCount->prev->next = lastEntryWithZeroRefCount->next;
-        else {
-            CPLAssert(0);
-        }
-        if (lastEntryWithZeroRefCount->next)
-            lastEntryWithZeroRefCount->next->prev = lastEntryWithZeroRefCount->prev;
-        else
+    GDALDataset* poDSToClose = NULL;
+    GIntBig responsiblePIDOfDSToClose = 0;
+    if (currentSize >= maxSize && lastEntryWithZeroRefCount != NULL)
+    {
+        /* Recycle this entry for the to-be-opened dataset. Its dataset */
+        /* is closed once the lock is released */
+        cur = lastEntryWithZeroRefCount;
+        if (cur->poDS)
         {
-            CPLAssert(lastEntryWithZeroRefCount == lastEntry);
-            lastEntry->prev->next = NULL;
-            lastEntry = lastEntry->prev;
+            poDSToClose = cur->poDS;
+            responsiblePIDOfDSToClose = cur->responsiblePID;
+            psShard->oMapDSToEntry.erase(cur->poDS);
+            psShard->oSetEvictedFileNames.insert(cur->pszFileName);
+            cur->poDS = NULL;
         }
-        lastEntryWithZeroRefCount->prev = NULL;
-        lastEntryWithZeroRefCount->next = firstEntry;
-        firstEntry->prev = lastEntryWithZeroRefCount;
-        cur = firstEntry = lastEntryWithZeroRefCount;
-#ifdef DEBUG_PROXY_POOL
-        CheckLinks();
-#endif
+        CPLFree(cur->pszFileName);
+        Unlink(psShard, cur);
+    }
+    else if (currentSize >= 2 * maxSize)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Too many threads are running for the current value of the dataset pool size (%d).\n"
+                 "or too many proxy datasets are opened in a cascaded way.\n"
+                 "Try increasing GDAL_MAX_DATASET_POOL_SIZE.", maxSize);
+        return NULL;
     }
     else
     {
-        /* Prepend */
         cur = (GDALProxyPoolCacheEntry*) CPLMalloc(sizeof(GDALProxyPoolCacheEntry));
-        if (lastEntry == NULL)
-            lastEntry = cur;
-        cur->prev = NULL;
-        cur->next = firstEntry;
-        if (firstEntry)
-            firstEntry->prev = cur;
-        firstEntry = cur;
-        currentSize ++;
+        cur->iShard = iShard;
+        psShard->currentSize ++;
+        CPLAtomicInc(&currentSize);
+    }
+
+    /* Prepend */
+    Prepend(psShard, cur);
 #ifdef DEBUG_PROXY_POOL
-        CheckLinks();
+    CheckLinks(psShard);
 #endif
-    }
 
     cur->pszFileName = CPLStrdup(pszFileName);
     cur->responsiblePID = responsiblePID;
+    cur->threadID = threadID;
     cur->refCount = 1;
+    cur->poDS = NULL;
+    cur->bOpening = TRUE;
+
+    CPLReleaseMutex(psShard->hMutex);
 
-    refCountOfDisableRefCount ++;
+    if (poDSToClose)
+        CloseUnderlyingDataset(poDSToClose, responsiblePIDOfDSToClose);
+
+    DisableRefCountForThisThread(1);
     int nFlag = ((eAccess == GA_Update) ? GDAL_OF_UPDATE : GDAL_OF_READONLY) | GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR;
-    cur->poDS = (GDALDataset*) GDALOpenEx( pszFileName, nFlag, NULL,
+    GDALDataset* poDS = (GDALDataset*) GDALOpenEx( pszFileName, nFlag, NULL,
                            (const char* const* )papszOpenOptions, NULL );
-    refCountOfDisableRefCount --;
+    DisableRefCountForThisThread(-1);
+
+    CPLAcquireMutex(psShard->hMutex, 1000.0);
+    cur->poDS = poDS;
+    cur->bOpening = FALSE;
+    if (poDS)
+        psShard->oMapDSToEntry[poDS] = cur;
+    CPLCondBroadcast(psShard->hCond);
 
     return cur;
 }
 
+/************************************************************************/
+/*                           _UnrefDataset()                            */
+/************************************************************************/
+
+void GDALDatasetPool::_UnrefDataset(GDALProxyPoolCacheEntry* cacheEntry)
+{
+    GDALDatasetPoolShard* psShard = &pasShards[cacheEntry->iShard];
+    GDALDataset* poDSToClose = NULL;
+    GIntBig responsiblePIDOfDSToClose = 0;
+    {
+        CPLMutexHolderD( &(psShard->hMutex) );
+        cacheEntry->refCount --;
+
+        /* Give back the datasets opened over the maximum size of the pool */
+        if (cacheEntry->refCount == 0 && currentSize > maxSize &&
+            cacheEntry->poDS != NULL)
+        {
+            poDSToClose = cacheEntry->poDS;
+            responsiblePIDOfDSToClose = cacheEntry->responsiblePID;
+            psShard->oMapDSToEntry.erase(cacheEntry->poDS);
+            Unlink(psShard, cacheEntry);
+            CPLFree(cacheEntry->pszFileName);
+            CPLFree(cacheEntry);
+            psShard->currentSize --;
+            CPLAtomicDec(&currentSize);
+        }
+    }
+    if (poDSToClose)
+        CloseUnderlyingDataset(poDSToClose, responsiblePIDOfDSToClose);
+}
+
 /************************************************************************/
 /*                       _CloseDataset()                                */
 /************************************************************************/
 
 void GDALDatasetPool::_CloseDataset(const char* pszFileName, CPL_UNUSED GDALAccess eAccess)
 {
-    GDALProxyPoolCacheEntry* cur = firstEntry;
-    GIntBig responsiblePID = GDALGetResponsiblePIDForCurrentThread();
-
-    while(cur)
+    GDALDatasetPoolShard* psShard = &pasShards[GetShard(pszFileName)];
+    GDALDataset* poDSToClose = NULL;
+    GIntBig responsiblePIDOfDSToClose = 0;
     {
-        GDALProxyPoolCacheEntry* next = cur->next;
+        CPLMutexHolderD( &(psShard->hMutex) );
+        GDALProxyPoolCacheEntry* cur = psShard->firstEntry;
 
-        CPLAssert(cur->pszFileName);
-        if (strcmp(cur->pszFileName, pszFileName) == 0 && cur->refCount == 0 &&
-            cur->poDS != NULL )
+        while(cur)
         {
-            /* Close by pretending we are the thread that GDALOpen'ed this */
-            /* dataset */
-            GDALSetResponsiblePIDForCurrentThread(cur->responsiblePID);
-
-            refCountOfDisableRefCount ++;
-            GDALClose(cur->poDS);
-            refCountOfDisableRefCount --;
+            GDALProxyPoolCacheEntry* next = cur->next;
 
-            GDALSetResponsiblePIDForCurrentThread(responsiblePID);
+            CPLAssert(cur->pszFileName);
+            if (strcmp(cur->pszFileName, pszFileName) == 0 && cur->refCount == 0 &&
+                cur->poDS != NULL )
+            {
+                poDSToClose = cur->poDS;
+                responsiblePIDOfDSToClose = cur->responsiblePID;
+                psShard->oMapDSToEntry.erase(cur->poDS);
+                cur->poDS = NULL;
+                cur->pszFileName[0] = '\0';
+                break;
+            }
 
-            cur->poDS = NULL;
-            cur->pszFileName[0] = '\0';
-            break;
+            cur = next;
         }
+    }
+    if (poDSToClose)
+        CloseUnderlyingDataset(poDSToClose, responsiblePIDOfDSToClose);
+}
+
+/************************************************************************/
+/*                          _GetStatistics()                            */
+/************************************************************************/
 
-        cur = next;
+void GDALDatasetPool::_GetStatistics(GIntBig* pnHits, GIntBig* pnMisses,
+                                     GIntBig* pnReopens)
+{
+    for( int i = 0; i < nShards; i++ )
+    {
+        CPLMutexHolderD( &(pasShards[i].hMutex) );
+        *pnHits += pasShards[i].nHits;
+        *pnMisses += pasShards[i].nMisses;
+        *pnReopens += pasShards[i].nReopens;
     }
 }
 
@@ -364,9 +622,15 @@ void GDALDatasetPool::Ref()
         int l_maxSize = atoi(CPLGetConfigOption("GDAL_MAX_DATASET_POOL_SIZE", "100"));
         if (l_maxSize < 2 || l_maxSize > 1000)
             l_maxSize = 100;
-        singleton = new GDALDatasetPool(l_maxSize);
+        int l_nShards = atoi(CPLGetConfigOption("GDAL_DATASET_POOL_SHARDS", "8"));
+        if (l_nShards < 1 || l_nShards > 64)
+            l_nShards = 8;
+        const int l_bPerThread = CPLTestBool(
+            CPLGetConfigOption("GDAL_DATASET_POOL_PER_THREAD", "NO"));
+        singleton = new GDALDatasetPool(l_maxSize, l_nShards, l_bPerThread);
     }
-    if (singleton->refCountOfDisableRefCount == 0)
+    if (singleton->refCountOfDisableRefCount == 0 &&
+        !IsRefCountDisabledForThisThread())
       singleton->refCount++;
 }
 
@@ -400,7 +664,8 @@ void GDALDatasetPool::Unref()
         CPLAssert(0);
         return;
     }
-    if (singleton->refCountOfDisableRefCount == 0)
+    if (singleton->refCountOfDisableRefCount == 0 &&
+        !IsRefCountDisabledForThisThread())
     {
       singleton->refCount--;
       if (singleton->refCount == 0)
@@ -441,7 +706,8 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::RefDataset(const char* pszFileName,
                                                      char** papszOpenOptions,
                                                      int bShared)
 {
-    CPLMutexHolderD( GDALGetphDLMutex() );
+    /* The singleton is alive as long as the caller holds a reference */
+    /* on it, so no need to take the mutex of gdaldataset.cpp */
     return singleton->_RefDataset(pszFileName, eAccess, papszOpenOptions, bShared);
 }
 
@@ -451,8 +717,26 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::RefDataset(const char* pszFileName,
 
 void GDALDatasetPool::UnrefDataset(GDALProxyPoolCacheEntry* cacheEntry)
 {
-    CPLMutexHolderD( GDALGetphDLMutex() );
-    cacheEntry->refCount --;
+    singleton->_UnrefDataset(cacheEntry);
+}
+
+/* Finds the entry from the underlying dataset, as a GDALProxyPoolDataset */
+/* can be used by several threads, each with its own entry */
+void GDALDatasetPool::UnrefDataset(const char* pszFileName, GDALDataset* poDS)
+{
+    GDALDatasetPoolShard* psShard =
+        &(singleton->pasShards[singleton->GetShard(pszFileName)]);
+    GDALProxyPoolCacheEntry* cacheEntry = NULL;
+    {
+        CPLMutexHolderD( &(psShard->hMutex) );
+        std::map<GDALDataset*, GDALProxyPoolCacheEntry*>::iterator oIter =
+            psShard->oMapDSToEntry.find(poDS);
+        if( oIter != psShard->oMapDSToEntry.end() )
+            cacheEntry = oIter->second;
+    }
+    CPLAssert(cacheEntry != NULL);
+    if( cacheEntry != NULL )
+        singleton->_UnrefDataset(cacheEntry);
 }
 
 /************************************************************************/
@@ -461,10 +745,56 @@ void GDALDatasetPool::UnrefDataset(GDALProxyPoolCacheEntry* cacheEntry)
 
 void GDALDatasetPool::CloseDataset(const char* pszFileName, GDALAccess eAccess)
 {
-    CPLMutexHolderD( GDALGetphDLMutex() );
     singleton->_CloseDataset(pszFileName, eAccess);
 }
 
+/************************************************************************/
+/*                          GetStatistics()                             */
+/************************************************************************/
+
+void GDALDatasetPool::GetStatistics(GIntBig* pnHits, GIntBig* pnMisses,
+                                    GIntBig* pnReopens)
+{
+    CPLMutexHolderD( GDALGetphDLMutex() );
+    *pnHits = nPoolHitsOfDestroyedPools;
+    *pnMisses = nPoolMissesOfDestroyedPools;
+    *pnReopens = nPoolReopensOfDestroyedPools;
+    if( singleton )
+        singleton->_GetStatistics(pnHits, pnMisses, pnReopens);
+}
+
+/************************************************************************/
+/*                    GDALDatasetPoolGetStatistics()                    */
+/************************************************************************/
+
+/**
+ * \brief Returns the statistics of the pool of datasets used by proxy
+ * datasets, such as the sources of VRT datasets.
+ *
+ * The counts are cumulated since the start of the process.
+ *
+ * @param pnHits pointer to the number of times an opened dataset was reused.
+ * @param pnMisses pointer to the number of times a dataset had to be opened.
+ * @param pnReopens pointer to the number of times a dataset had to be opened
+ * again after being closed to make room in the pool.
+ *
+ * @since GDAL 2.2
+ */
+
+void CPL_STDCALL GDALDatasetPoolGetStatistics( GIntBig* pnHits,
+                                               GIntBig* pnMisses,
+                                               GIntBig* pnReopens )
+{
+    GIntBig nHits, nMisses, nReopens;
+    GDALDatasetPool::GetStatistics(&nHits, &nMisses, &nReopens);
+    if( pnHits )
+        *pnHits = nHits;
+    if( pnMisses )
+        *pnMisses = nMisses;
+    if( pnReopens )
+        *pnReopens = nReopens;
+}
+
 CPL_C_START
 
 typedef struct
@@ -596,7 +926,6 @@ GDALProxyPoolDataset::GDALProxyPoolDataset(const char* pszSourceDatasetDescripti
     pasGCPList = NULL;
     metadataSet = NULL;
     metadataItemSet = NULL;
-    cacheEntry = NULL;
 }
 
 /************************************************************************/
@@ -668,8 +997,9 @@ GDALDataset* GDALProxyPoolDataset::RefUnderlyingDataset()
     /* a VRT of GeoTIFFs that have associated .aux files */
     GIntBig curResponsiblePID = GDALGetResponsiblePIDForCurrentThread();
     GDALSetResponsiblePIDForCurrentThread(responsiblePID);
-    cacheEntry = GDALDatasetPool::RefDataset(GetDescription(), eAccess, papszOpenOptions,
-                                             GetShared());
+    GDALProxyPoolCacheEntry* cacheEntry =
+        GDALDatasetPool::RefDataset(GetDescription(), eAccess, papszOpenOptions,
+                                    GetShared());
     GDALSetResponsiblePIDForCurrentThread(curResponsiblePID);
     if (cacheEntry != NULL)
     {
@@ -685,14 +1015,10 @@ GDALDataset* GDALProxyPoolDataset::RefUnderlyingDataset()
 /*                    UnrefUnderlyingDataset()                        */
 /************************************************************************/
 
-void GDALProxyPoolDataset::UnrefUnderlyingDataset(CPL_UNUSED GDALDataset* poUnderlyingDataset)
+void GDALProxyPoolDataset::UnrefUnderlyingDataset(GDALDataset* poUnderlyingDataset)
 {
-    if (cacheEntry != NULL)
-    {
-        CPLAssert(cacheEntry->poDS == poUnderlyingDataset);
-        if (cacheEntry->poDS != NULL)
-            GDALDatasetPool::UnrefDataset(cacheEntry);
-    }
+    if (poUnderlyingDataset != NULL)
+        GDALDatasetPool::UnrefDataset(GetDescription(), poUnderlyingDataset);
 }
 
 /************************************************************************/
@@ -0,0 +1,299 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Implementation of GDALQuantileSketch, a mergeable sketch used
+ *           to answer approximate quantiles of raster values.
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_priv.h"
+
+#include <algorithm>
+
+CPL_CVSID("$Id$");
+
+/* Version tag of the serialized form */
+#define KLL_SIGNATURE   "KLL1"
+
+/************************************************************************/
+/*                         GDALQuantileSketch()                         */
+/************************************************************************/
+
+/**
+ * \brief Constructor.
+ *
+ * @param nKIn accuracy parameter: the sketch retains in the order of 3 * nKIn
+ * values, and the rank error of the quantiles is in the order of 1.7 / nKIn.
+ */
+
+GDALQuantileSketch::GDALQuantileSketch( int nKIn ) :
+    nK(MAX(8, nKIn)), nCount(0), dfMin(0.0), dfMax(0.0)
+{
+    Reset();
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+void GDALQuantileSketch::Reset()
+{
+    nCount = 0;
+    dfMin = 0.0;
+    dfMax = 0.0;
+    aadfLevels.clear();
+    aadfLevels.resize(1);
+    anOffsets.clear();
+    anOffsets.resize(1);
+}
+
+/************************************************************************/
+/*                          GetLevelCapacity()                          */
+/*                                                                      */
+/*      The top level has a capacity of nK, and each level below has    */
+/*      2/3 of the capacity of the level above it.                      */
+/************************************************************************/
+
+size_t GDALQuantileSketch::GetLevelCapacity( size_t iLevel ) const
+{
+    const size_t nDepth = aadfLevels.size() - 1 - iLevel;
+    const double dfCapacity = nK * pow( 2.0 / 3.0, static_cast<double>(nDepth) );
+    return static_cast<size_t>( MAX( 2.0, ceil(dfCapacity) ) );
+}
+
+/************************************************************************/
+/*                              Compress()                              */
+/*                                                                      */
+/*      Compacts the levels over their capacity: the sorted items of    */
+/*      the level are paired, and one item of each pair is promoted to  */
+/*      the level above. Which one alternates from one compaction of    */
+/*      the level to the next, so that results are reproducible.        */
+/************************************************************************/
+
+void GDALQuantileSketch::Compress()
+{
+    for( size_t iLevel = 0; iLevel < aadfLevels.size(); iLevel++ )
+    {
+        if( aadfLevels[iLevel].size() < GetLevelCapacity(iLevel) )
+            continue;
+
+        if( iLevel + 1 == aadfLevels.size() )
+        {
+            aadfLevels.resize( aadfLevels.size() + 1 );
+            anOffsets.resize( anOffsets.size() + 1 );
+        }
+
+        std::vector<double>& adfLevel = aadfLevels[iLevel];
+        std::vector<double>& adfUpper = aadfLevels[iLevel + 1];
+        std::sort( adfLevel.begin(), adfLevel.end() );
+
+        // With an odd number of items, the smallest one stays in place
+        const size_t nKept = adfLevel.size() % 2;
+        for( size_t i = nKept + anOffsets[iLevel]; i < adfLevel.size(); i += 2 )
+            adfUpper.push_back( adfLevel[i] );
+        anOffsets[iLevel] = 1 - anOffsets[iLevel];
+        adfLevel.resize( nKept );
+    }
+}
+
+/************************************************************************/
+/*                               Insert()                               */
+/************************************************************************/
+
+void GDALQuantileSketch::Insert( double dfValue )
+{
+    if( nCount == 0 )
+    {
+        dfMin = dfValue;
+        dfMax = dfValue;
+    }
+    else if( dfValue < dfMin )
+        dfMin = dfValue;
+    else if( dfValue > dfMax )
+        dfMax = dfValue;
+    nCount++;
+
+    aadfLevels[0].push_back( dfValue );
+    if( aadfLevels[0].size() >= GetLevelCapacity(0) )
+        Compress();
+}
+
+/************************************************************************/
+/*                               Merge()                                */
+/************************************************************************/
+
+void GDALQuantileSketch::Merge( const GDALQuantileSketch& oOther )
+{
+    if( oOther.nCount == 0 )
+        return;
+    if( nCount == 0 )
+    {
+        dfMin = oOther.dfMin;
+        dfMax = oOther.dfMax;
+    }
+    else
+    {
+        dfMin = MIN(dfMin, oOther.dfMin);
+        dfMax = MAX(dfMax, oOther.dfMax);
+    }
+    nCount += oOther.nCount;
+
+    if( aadfLevels.size() < oOther.aadfLevels.size() )
+    {
+        aadfLevels.resize( oOther.aadfLevels.size() );
+        anOffsets.resize( oOther.anOffsets.size() );
+    }
+    for( size_t iLevel = 0; iLevel < oOther.aadfLevels.size(); iLevel++ )
+    {
+        aadfLevels[iLevel].insert( aadfLevels[iLevel].end(),
+                                   oOther.aadfLevels[iLevel].begin(),
+                                   oOther.aadfLevels[iLevel].end() );
+    }
+    Compress();
+}
+
+/************************************************************************/
+/*                            GetQuantile()                             */
+/************************************************************************/
+
+/**
+ * \brief Returns the approximate value of a quantile.
+ *
+ * @param dfProbability probability of the quantile, between 0 and 1. 0 and 1
+ * return the exact minimum and maximum.
+ *
+ * @return the value of the quantile, or 0 if the sketch is empty.
+ */
+
+double GDALQuantileSketch::GetQuantile( double dfProbability ) const
+{
+    if( nCount == 0 )
+        return 0.0;
+    if( dfProbability <= 0.0 )
+        return dfMin;
+    if( dfProbability >= 1.0 )
+        return dfMax;
+
+    std::vector< std::pair<double, GUIntBig> > aoItems;
+    for( size_t iLevel = 0; iLevel < aadfLevels.size(); iLevel++ )
+    {
+        const GUIntBig nWeight = static_cast<GUIntBig>(1) << iLevel;
+        for( size_t i = 0; i < aadfLevels[iLevel].size(); i++ )
+            aoItems.push_back( std::pair<double, GUIntBig>(
+                                    aadfLevels[iLevel][i], nWeight ) );
+    }
+    std::sort( aoItems.begin(), aoItems.end() );
+
+    const double dfRank = dfProbability * static_cast<double>(nCount);
+    GUIntBig nCumulated = 0;
+    for( size_t i = 0; i < aoItems.size(); i++ )
+    {
+        nCumulated += aoItems[i].second;
+        if( static_cast<double>(nCumulated) >= dfRank )
+            return aoItems[i].first;
+    }
+    return dfMax;
+}
+
+/************************************************************************/
+/*                             Serialize()                              */
+/*                                                                      */
+/*      "KLL1 k count min max nlevels", followed for each level by its  */
+/*      compaction offset, its number of items and the items.           */
+/************************************************************************/
+
+CPLString GDALQuantileSketch::Serialize() const
+{
+    CPLString osSketch;
+    osSketch.Printf( "%s %d " CPL_FRMT_GUIB " %.17g %.17g %d",
+                     KLL_SIGNATURE, nK, nCount, dfMin, dfMax,
+                     static_cast<int>(aadfLevels.size()) );
+    for( size_t iLevel = 0; iLevel < aadfLevels.size(); iLevel++ )
+    {
+        osSketch += CPLSPrintf( " %d %d", anOffsets[iLevel],
+                                static_cast<int>(aadfLevels[iLevel].size()) );
+        for( size_t i = 0; i < aadfLevels[iLevel].size(); i++ )
+            osSketch += CPLSPrintf( " %.17g", aadfLevels[iLevel][i] );
+    }
+    return osSketch;
+}
+
+/************************************************************************/
+/*                            Deserialize()                             */
+/************************************************************************/
+
+bool GDALQuantileSketch::Deserialize( const char* pszSketch )
+{
+    Reset();
+
+    char** papszTokens = CSLTokenizeString2( pszSketch, " ", 0 );
+    const int nTokens = CSLCount( papszTokens );
+    int iToken = 0;
+    bool bOK = nTokens >= 6 && EQUAL(papszTokens[0], KLL_SIGNATURE);
+    if( bOK )
+    {
+        nK = MAX(8, atoi(papszTokens[1]));
+        nCount = CPLScanUIntBig( papszTokens[2],
+                                 static_cast<int>(strlen(papszTokens[2])) );
+        dfMin = CPLAtof( papszTokens[3] );
+        dfMax = CPLAtof( papszTokens[4] );
+        const int nLevels = atoi( papszTokens[5] );
+        iToken = 6;
+        bOK = nLevels >= 1 && nLevels <= 64;
+        if( bOK )
+        {
+            aadfLevels.resize( nLevels );
+            anOffsets.resize( nLevels );
+        }
+        GUIntBig nWeight = 0;
+        for( int iLevel = 0; bOK && iLevel < nLevels; iLevel++ )
+        {
+            if( iToken + 2 > nTokens )
+            {
+                bOK = false;
+                break;
+            }
+            anOffsets[iLevel] = atoi( papszTokens[iToken++] ) ? 1 : 0;
+            const int nItems = atoi( papszTokens[iToken++] );
+            if( nItems < 0 || nItems > nTokens - iToken )
+            {
+                bOK = false;
+                break;
+            }
+            for( int i = 0; i < nItems; i++ )
+                aadfLevels[iLevel].push_back( CPLAtof(papszTokens[iToken++]) );
+            nWeight += static_cast<GUIntBig>(nItems) << iLevel;
+        }
+        bOK = bOK && iToken == nTokens && nWeight == nCount;
+    }
+    CSLDestroy( papszTokens );
+
+    if( !bOK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined, "Invalid quantile sketch" );
+        Reset();
+    }
+    return bOK;
+}
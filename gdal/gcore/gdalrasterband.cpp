@@ -32,6 +32,17 @@
 #include "gdal_priv.h"
 #include "gdal_rat.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <vector>
+
+#if defined(__x86_64) || defined(_M_X64)
+#define USE_SSE2
+#endif
+
+#ifdef USE_SSE2
+#include <emmintrin.h>
+#endif
 
 CPL_CVSID("$Id$");
 
@@ -970,6 +981,61 @@ CPLErr GDALRasterBand::FlushBlock( int nXBlockOff, int nYBlockOff,
     return poBandBlockCache->FlushBlock( nXBlockOff, nYBlockOff, bWriteDirtyBlock );
 }
 
+/************************************************************************/
+/*                         GetCacheStatistics()                         */
+/************************************************************************/
+
+/**
+ * \brief Return the block cache statistics of this band.
+ *
+ * The statistics are accumulated since the block cache of the band has
+ * been initialized, that is to say since the first access to one of its
+ * blocks. They are all zero if the band has never used the block cache.
+ *
+ * This method is the same as the C function
+ * GDALGetRasterBandCacheStatistics().
+ *
+ * @param psStats structure to fill.
+ *
+ * @see GDALRasterBlock::GetCacheStatistics()
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALRasterBand::GetCacheStatistics( GDALCacheStatistics* psStats )
+
+{
+    if( poBandBlockCache == NULL )
+    {
+        memset( psStats, 0, sizeof(GDALCacheStatistics) );
+        return;
+    }
+    poBandBlockCache->GetStatistics( psStats );
+}
+
+/************************************************************************/
+/*                  GDALGetRasterBandCacheStatistics()                  */
+/************************************************************************/
+
+/**
+ * \brief Return the block cache statistics of a band.
+ *
+ * @see GDALRasterBand::GetCacheStatistics()
+ *
+ * @since GDAL 2.2
+ */
+
+void CPL_STDCALL GDALGetRasterBandCacheStatistics( GDALRasterBandH hBand,
+                                                   GDALCacheStatistics* psStats )
+
+{
+    VALIDATE_POINTER0( hBand, "GDALGetRasterBandCacheStatistics" );
+    VALIDATE_POINTER0( psStats, "GDALGetRasterBandCacheStatistics" );
+
+    GDALRasterBand *poBand = static_cast<GDALRasterBand*>(hBand);
+    poBand->GetCacheStatistics( psStats );
+}
+
 /************************************************************************/
 /*                        TryGetLockedBlockRef()                        */
 /************************************************************************/
@@ -1024,7 +1090,11 @@ GDALRasterBlock *GDALRasterBand::TryGetLockedBlockRef( int nXBlockOff,
         return( NULL );
     }
 
-    return poBandBlockCache->TryGetLockedBlockRef(nXBlockOff, nYBlockOff);
+    GDALRasterBlock* poBlock =
+        poBandBlockCache->TryGetLockedBlockRef(nXBlockOff, nYBlockOff);
+    if( poBlock != NULL )
+        poBlock->RecordCacheHit();
+    return poBlock;
 }
 
 /************************************************************************/
@@ -1131,8 +1201,33 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
             return( NULL );
         }
 
+        /* Blocks of read-only datasets might be read ahead by the */
+        /* threads of GDALBlockPrefetcher. Serialize with them, and check */
+        /* if they have read our block meanwhile. */
+        const bool bCallLeaveReadWrite =
+            poDS != NULL && poDS->GetAccess() == GA_ReadOnly &&
+            CPL_TO_BOOL(EnterReadWrite(GF_Read));
+        if( bCallLeaveReadWrite )
+        {
+            GDALRasterBlock* poPrefetchedBlock =
+                poBandBlockCache->TryGetLockedBlockRef( nXBlockOff, nYBlockOff );
+            if( poPrefetchedBlock != NULL )
+            {
+                LeaveReadWrite();
+                // Our block is listed in its cache shard since
+                // Internalize(): detach it while it is locked, so that it
+                // cannot be evicted in place of the prefetched one.
+                poBlock->Detach();
+                poBlock->DropLock();
+                delete poBlock;
+                poPrefetchedBlock->RecordCacheHit();
+                return poPrefetchedBlock;
+            }
+        }
+
         if ( AdoptBlock( poBlock ) != CE_None )
         {
+            if( bCallLeaveReadWrite ) LeaveReadWrite();
             poBlock->DropLock();
             delete poBlock;
             return( NULL );
@@ -1141,6 +1236,7 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
         if( !bJustInitialize
          && IReadBlock(nXBlockOff,nYBlockOff,poBlock->GetDataRef()) != CE_None)
         {
+            if( bCallLeaveReadWrite ) LeaveReadWrite();
             poBlock->DropLock();
             FlushBlock( nXBlockOff, nYBlockOff );
             ReportError( CE_Failure, CPLE_AppDefined,
@@ -1148,9 +1244,11 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
                 nXBlockOff, nYBlockOff );
             return( NULL );
         }
+        if( bCallLeaveReadWrite ) LeaveReadWrite();
 
         if( !bJustInitialize )
         {
+            poBandBlockCache->RecordBlockRead( poBlock->GetBlockSize() );
             nBlockReads++;
             if( static_cast<GIntBig>(nBlockReads) == static_cast<GIntBig>(nBlocksPerRow) * nBlocksPerColumn + 1
                 && nBand == 1 && poDS != NULL )
@@ -1164,6 +1262,148 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
     return poBlock;
 }
 
+/************************************************************************/
+/*                         GetLockedWindowRef()                         */
+/************************************************************************/
+
+/**
+ * \brief Fetch a read-only pointer to a window of an internally cached block.
+ *
+ * This method gives direct access to the pixels of a window of the band,
+ * at full resolution and in the native data type of the band, without
+ * copying them into a caller buffer as RasterIO() does. This is only possible
+ * when the window is entirely contained in a single block. Otherwise NULL is
+ * returned, without error, and the caller should fall back to RasterIO().
+ *
+ * The block holding the window is fetched with GetLockedBlockRef(), and
+ * thus read from the driver if it is not already cached. If a non-NULL value
+ * is returned, *ppoBlock is set to the block, on which a lock has been
+ * acquired on behalf of the caller. The returned pointer remains valid until
+ * the caller releases this lock with GDALRasterBlock::DropLock(), which
+ * it must absolutely do. The pixels must not be modified through the
+ * returned pointer.
+ *
+ * This method is the same as the C function GDALRasterBandGetLockedWindow().
+ *
+ * @param nXOff The pixel offset to the top left corner of the window.
+ * @param nYOff The line offset to the top left corner of the window.
+ * @param nXSize The width of the window in pixels.
+ * @param nYSize The height of the window in lines.
+ * @param pnPixelSpace Pointer to a variable set to the byte offset between
+ * two consecutive pixels of a line of the window.
+ * @param pnLineSpace Pointer to a variable set to the byte offset between
+ * the start of two consecutive lines of the window.
+ * @param ppoBlock Pointer to a variable set to the locked block, or NULL.
+ *
+ * @return a pointer to the top left pixel of the window, or NULL if the window
+ * does not fit in a single block or in case of error.
+ *
+ * @since GDAL 2.2
+ */
+
+const void *GDALRasterBand::GetLockedWindowRef( int nXOff, int nYOff,
+                                                int nXSize, int nYSize,
+                                                GSpacing* pnPixelSpace,
+                                                GSpacing* pnLineSpace,
+                                                GDALRasterBlock** ppoBlock )
+
+{
+    *ppoBlock = NULL;
+
+    if( nXOff < 0 || nYOff < 0 || nXSize < 1 || nYSize < 1 ||
+        nXOff > nRasterXSize - nXSize || nYOff > nRasterYSize - nYSize )
+    {
+        ReportError( CE_Failure, CPLE_IllegalArg,
+                     "Illegal window (%d,%d,%d,%d) in "
+                     "GDALRasterBand::GetLockedWindowRef()",
+                     nXOff, nYOff, nXSize, nYSize );
+        return NULL;
+    }
+
+    if( !InitBlockInfo() )
+        return NULL;
+
+    const int nXBlockOff = nXOff / nBlockXSize;
+    const int nYBlockOff = nYOff / nBlockYSize;
+    if( (nXOff + nXSize - 1) / nBlockXSize != nXBlockOff ||
+        (nYOff + nYSize - 1) / nBlockYSize != nYBlockOff )
+        return NULL;
+
+    GDALRasterBlock *poBlock = GetLockedBlockRef( nXBlockOff, nYBlockOff );
+    if( poBlock == NULL )
+        return NULL;
+
+    const int nDTSize = GDALGetDataTypeSize(eDataType) / 8;
+    *pnPixelSpace = nDTSize;
+    *pnLineSpace = static_cast<GSpacing>(nDTSize) * nBlockXSize;
+    *ppoBlock = poBlock;
+
+    const GPtrDiff_t nOffset =
+        (static_cast<GPtrDiff_t>(nYOff - nYBlockOff * nBlockYSize) * nBlockXSize +
+         (nXOff - nXBlockOff * nBlockXSize)) * nDTSize;
+    return static_cast<const GByte*>(poBlock->GetDataRef()) + nOffset;
+}
+
+/************************************************************************/
+/*                   GDALRasterBandGetLockedWindow()                    */
+/************************************************************************/
+
+/**
+ * \brief Fetch a read-only pointer to a window of an internally cached block.
+ *
+ * If a non-NULL value is returned, *phLock is set to a handle that must be
+ * released with GDALRasterBandReleaseLockedWindow() once the caller is done
+ * with the pixels.
+ *
+ * @see GDALRasterBand::GetLockedWindowRef()
+ *
+ * @since GDAL 2.2
+ */
+
+const void * CPL_STDCALL
+GDALRasterBandGetLockedWindow( GDALRasterBandH hBand,
+                               int nXOff, int nYOff,
+                               int nXSize, int nYSize,
+                               GSpacing* pnPixelSpace,
+                               GSpacing* pnLineSpace,
+                               void** phLock )
+
+{
+    VALIDATE_POINTER1( hBand, "GDALRasterBandGetLockedWindow", NULL );
+    VALIDATE_POINTER1( pnPixelSpace, "GDALRasterBandGetLockedWindow", NULL );
+    VALIDATE_POINTER1( pnLineSpace, "GDALRasterBandGetLockedWindow", NULL );
+    VALIDATE_POINTER1( phLock, "GDALRasterBandGetLockedWindow", NULL );
+
+    GDALRasterBand *poBand = static_cast<GDALRasterBand*>(hBand);
+    GDALRasterBlock *poBlock = NULL;
+    const void* pData = poBand->GetLockedWindowRef( nXOff, nYOff,
+                                                    nXSize, nYSize,
+                                                    pnPixelSpace, pnLineSpace,
+                                                    &poBlock );
+    *phLock = poBlock;
+    return pData;
+}
+
+/************************************************************************/
+/*                 GDALRasterBandReleaseLockedWindow()                  */
+/************************************************************************/
+
+/**
+ * \brief Release a window obtained with GDALRasterBandGetLockedWindow().
+ *
+ * @param hLock the handle set by GDALRasterBandGetLockedWindow(). NULL is
+ * accepted and does nothing.
+ *
+ * @since GDAL 2.2
+ */
+
+void CPL_STDCALL GDALRasterBandReleaseLockedWindow( void* hLock )
+
+{
+    if( hLock != NULL )
+        static_cast<GDALRasterBlock*>(hLock)->DropLock();
+}
+
 /************************************************************************/
 /*                               Fill()                                 */
 /************************************************************************/
@@ -2636,245 +2876,1725 @@ GDALDatasetH CPL_STDCALL GDALGetBandDataset( GDALRasterBandH hBand )
 }
 
 /************************************************************************/
-/*                            GetHistogram()                            */
+/* ==================================================================== */
+/*               Statistics, min/max and histogram kernels              */
+/* ==================================================================== */
+/*                                                                      */
+/*      GetHistogram(), ComputeStatistics() and ComputeRasterMinMax()   */
+/*      hand each sampled block to the per data type kernels below.     */
+/*      Blocks are grouped into jobs of about GDALSTAT_PIXELS_PER_JOB   */
+/*      pixels. When GDAL_NUM_THREADS is greater than 1, the calling    */
+/*      thread reads the blocks of a batch of jobs while a pool of      */
+/*      worker threads processes the previous batch. The partial result */
+/*      of each job is merged by the calling thread in block order, so  */
+/*      results do not depend on the number of threads.                 */
+/*                                                                      */
+/*      Pixels masked out by a per-dataset or alpha mask band are       */
+/*      ignored. The blocks that have such a mask are converted to      */
+/*      Float64 (CFloat64 for complex types), with masked pixels set to */
+/*      NaN, and are then processed by the generic kernels.             */
 /************************************************************************/
 
-/**
- * \brief Compute raster histogram.
- *
- * Note that the bucket size is (dfMax-dfMin) / nBuckets.
- *
- * For example to compute a simple 256 entry histogram of eight bit data,
- * the following would be suitable.  The unusual bounds are to ensure that
- * bucket boundaries don't fall right on integer values causing possible errors
- * due to rounding after scaling.
-<pre>
-    GUIntBig anHistogram[256];
-
-    poBand->GetHistogram( -0.5, 255.5, 256, anHistogram, FALSE, FALSE,
-                          GDALDummyProgress, NULL );
-</pre>
- *
- * Note that setting bApproxOK will generally result in a subsampling of the
- * file, and will utilize overviews if available.  It should generally
- * produce a representative histogram for the data that is suitable for use
- * in generating histogram based luts for instance.  Generally bApproxOK is
- * much faster than an exactly computed histogram.
- *
- * This method is the same as the C functions GDALGetRasterHistogram() and
- * GDALGetRasterHistogramEx().
- *
- * @param dfMin the lower bound of the histogram.
- * @param dfMax the upper bound of the histogram.
- * @param nBuckets the number of buckets in panHistogram.
- * @param panHistogram array into which the histogram totals are placed.
- * @param bIncludeOutOfRange if TRUE values below the histogram range will
- * mapped into panHistogram[0], and values above will be mapped into
- * panHistogram[nBuckets-1] otherwise out of range values are discarded.
- * @param bApproxOK TRUE if an approximate, or incomplete histogram OK.
- * @param pfnProgress function to report progress to completion.
- * @param pProgressData application data to pass to pfnProgress.
- *
- * @return CE_None on success, or CE_Failure if something goes wrong.
- */
+#define GDALSTAT_PIXELS_PER_JOB     (256 * 1024)
 
-CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
-                                     int nBuckets, GUIntBig *panHistogram,
-                                     int bIncludeOutOfRange, int bApproxOK,
-                                     GDALProgressFunc pfnProgress,
-                                     void *pProgressData )
+/************************************************************************/
+/*                            GDALStatsAccum                            */
+/*                                                                      */
+/*      Count, extrema, mean and sum of squared differences to the      */
+/*      mean of a set of samples.                                       */
+/************************************************************************/
 
+struct GDALStatsAccum
 {
-    CPLAssert( NULL != panHistogram );
-
-    if( pfnProgress == NULL )
-        pfnProgress = GDALDummyProgress;
-
-/* -------------------------------------------------------------------- */
-/*      If we have overviews, use them for the histogram.               */
-/* -------------------------------------------------------------------- */
-    if( bApproxOK && GetOverviewCount() > 0 && !HasArbitraryOverviews() )
+    GUIntBig    nCount;
+    double      dfMin;
+    double      dfMax;
+    double      dfMean;
+    double      dfM2;
+
+    GDALStatsAccum() : nCount(0), dfMin(0.0), dfMax(0.0),
+                       dfMean(0.0), dfM2(0.0) {}
+
+    /* Combines with the samples of sOther, with the pairwise formula of */
+    /* Chan et al. ( http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance ) */
+    void Merge( const GDALStatsAccum& sOther )
     {
-        // FIXME: should we use the most reduced overview here or use some
-        // minimum number of samples like GDALRasterBand::ComputeStatistics()
-        // does?
-        GDALRasterBand *poBestOverview = GetRasterSampleOverview( 0 );
-
-        if( poBestOverview != this )
+        if( sOther.nCount == 0 )
+            return;
+        if( nCount == 0 )
         {
-            return poBestOverview->GetHistogram( dfMin, dfMax, nBuckets,
-                                                 panHistogram,
-                                                 bIncludeOutOfRange, bApproxOK,
-                                                 pfnProgress, pProgressData );
+            *this = sOther;
+            return;
         }
+        dfMin = MIN(dfMin, sOther.dfMin);
+        dfMax = MAX(dfMax, sOther.dfMax);
+        const double dfCount = static_cast<double>(nCount);
+        const double dfOtherCount = static_cast<double>(sOther.nCount);
+        const double dfTotalCount = dfCount + dfOtherCount;
+        const double dfDelta = sOther.dfMean - dfMean;
+        dfMean += dfDelta * dfOtherCount / dfTotalCount;
+        dfM2 += sOther.dfM2 +
+                dfDelta * dfDelta * dfCount * dfOtherCount / dfTotalCount;
+        nCount += sOther.nCount;
     }
+};
 
-/* -------------------------------------------------------------------- */
-/*      Read actual data and build histogram.                           */
-/* -------------------------------------------------------------------- */
-    if( !pfnProgress( 0.0, "Compute Histogram", pProgressData ) )
-    {
-        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-        return CE_Failure;
-    }
-
-    GDALRasterIOExtraArg sExtraArg;
-    INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+/************************************************************************/
+/*                            GDALIntMoments                            */
+/*                                                                      */
+/*      For 8 and 16 bit data types, values are shifted to be unsigned  */
+/*      and their sum and sum of squares are accumulated exactly as     */
+/*      integers. This cannot overflow for less than 2^32 values.       */
+/************************************************************************/
 
-    const double dfScale = nBuckets / (dfMax - dfMin);
-    memset( panHistogram, 0, sizeof(GUIntBig) * nBuckets );
+struct GDALIntMoments
+{
+    GUIntBig    nCount;
+    GUIntBig    nSum;
+    GUIntBig    nSumSq;
+    GUInt32     nMin;
+    GUInt32     nMax;
+};
+
+static void GDALIntMomentsToAccum( const GDALIntMoments& sMoments,
+                                   int nOffset, GDALStatsAccum& sAccum )
+{
+    sAccum = GDALStatsAccum();
+    if( sMoments.nCount == 0 )
+        return;
+
+    /* M2 = nSumSq - nSum^2 / nCount. With nSum = nQuot * nCount + nRem, */
+    /* the integer part of it is computed exactly. */
+    const GUIntBig nCount = sMoments.nCount;
+    const GUIntBig nQuot = sMoments.nSum / nCount;
+    const GUIntBig nRem = sMoments.nSum % nCount;
+    const GUIntBig nM2 =
+        sMoments.nSumSq - nQuot * nQuot * nCount - 2 * nQuot * nRem;
+
+    sAccum.nCount = nCount;
+    sAccum.dfMin = static_cast<double>(sMoments.nMin) - nOffset;
+    sAccum.dfMax = static_cast<double>(sMoments.nMax) - nOffset;
+    sAccum.dfMean = static_cast<double>(sMoments.nSum) / nCount - nOffset;
+    sAccum.dfM2 = MAX( 0.0, static_cast<double>(nM2) -
+                    static_cast<double>(nRem) * static_cast<double>(nRem) /
+                                                                    nCount );
+}
 
-    int bGotNoDataValue;
-    const double dfNoDataValue = GetNoDataValue( &bGotNoDataValue );
-    bGotNoDataValue = bGotNoDataValue && !CPLIsNan(dfNoDataValue);
-    /* Not advertized. May be removed at any time. Just as a provision if the */
-    /* old behaviour made sense somethimes... */
-    bGotNoDataValue = bGotNoDataValue &&
-        !CPLTestBool(CPLGetConfigOption("GDAL_NODATA_IN_HISTOGRAM", "NO"));
+/************************************************************************/
+/*                       GDALComputeIntMoments()                        */
+/************************************************************************/
 
-    const char* pszPixelType = GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
-    const bool bSignedByte = (pszPixelType != NULL && EQUAL(pszPixelType, "SIGNEDBYTE"));
+template<class T>
+static void GDALComputeIntMoments( const T* pData,
+                                   int nXCheck, int nYCheck,
+                                   int nLineStride, int nPixelStride,
+                                   bool bHasNoData, T tNoData, int nOffset,
+                                   GDALIntMoments& sMoments )
+{
+    GUIntBig nCount = 0;
+    GUIntBig nSum = 0;
+    GUIntBig nSumSq = 0;
+    GUInt32 nMin = 0xFFFFFFFFU;
+    GUInt32 nMax = 0;
 
-    if ( bApproxOK && HasArbitraryOverviews() )
+    for( int iY = 0; iY < nYCheck; iY++ )
     {
-/* -------------------------------------------------------------------- */
-/*      Figure out how much the image should be reduced to get an       */
-/*      approximate value.                                              */
-/* -------------------------------------------------------------------- */
-        double  dfReduction = sqrt(
-            (double)nRasterXSize * nRasterYSize / GDALSTAT_APPROX_NUMSAMPLES );
+        const T* pLine = pData + static_cast<size_t>(iY) * nLineStride;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            const T tValue = pLine[static_cast<size_t>(iX) * nPixelStride];
+            if( bHasNoData && tValue == tNoData )
+                continue;
+            const GUInt32 nValue = static_cast<GUInt32>(tValue + nOffset);
+            if( nValue < nMin )
+                nMin = nValue;
+            if( nValue > nMax )
+                nMax = nValue;
+            nCount++;
+            nSum += nValue;
+            nSumSq += static_cast<GUIntBig>(nValue) * nValue;
+        }
+    }
 
-        int     nXReduced, nYReduced;
+    sMoments.nCount = nCount;
+    sMoments.nSum = nSum;
+    sMoments.nSumSq = nSumSq;
+    sMoments.nMin = nMin;
+    sMoments.nMax = nMax;
+}
 
-        if ( dfReduction > 1.0 )
+#ifdef USE_SSE2
+
+/************************************************************************/
+/*                     GDALComputeByteMomentsSSE2()                     */
+/************************************************************************/
+
+static void GDALComputeByteMomentsSSE2( const GByte* pabyData,
+                                        int nXCheck, int nYCheck,
+                                        int nLineStride,
+                                        bool bHasNoData, GByte byNoData,
+                                        GDALIntMoments& sMoments )
+{
+    const __m128i xmmZero = _mm_setzero_si128();
+    const __m128i xmmOne = _mm_set1_epi8(1);
+    const __m128i xmmNoData = _mm_set1_epi8(static_cast<char>(byNoData));
+    __m128i xmmMin = _mm_set1_epi8(static_cast<char>(255));
+    __m128i xmmMax = xmmZero;
+
+    GUIntBig nSum = 0;
+    GUIntBig nSumSq = 0;
+    GUIntBig nNoDataCount = 0;
+    GUInt32 nMin = 255;
+    GUInt32 nMax = 0;
+
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const GByte* pabyLine = pabyData + static_cast<size_t>(iY) * nLineStride;
+        int iX = 0;
+        while( iX + 16 <= nXCheck )
         {
-            nXReduced = (int)( nRasterXSize / dfReduction );
-            nYReduced = (int)( nRasterYSize / dfReduction );
+            /* The 32 bit lanes of the sum of squares cannot overflow */
+            /* before 16512 iterations */
+            const int nIters = MIN( (nXCheck - iX) / 16, 16384 );
+            __m128i xmmSum = xmmZero;
+            __m128i xmmSumSq = xmmZero;
+            __m128i xmmNoDataCount = xmmZero;
+            for( int i = 0; i < nIters; i++, iX += 16 )
+            {
+                __m128i xmmValues = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(pabyLine + iX) );
+                if( bHasNoData )
+                {
+                    /* Nodata values become 255 for the minimum, and 0 */
+                    /* for the maximum and the sums */
+                    const __m128i xmmMask =
+                        _mm_cmpeq_epi8(xmmValues, xmmNoData);
+                    xmmMin = _mm_min_epu8(xmmMin,
+                                          _mm_or_si128(xmmValues, xmmMask));
+                    xmmValues = _mm_andnot_si128(xmmMask, xmmValues);
+                    xmmNoDataCount = _mm_add_epi64(xmmNoDataCount,
+                        _mm_sad_epu8(_mm_and_si128(xmmMask, xmmOne), xmmZero));
+                }
+                else
+                {
+                    xmmMin = _mm_min_epu8(xmmMin, xmmValues);
+                }
+                xmmMax = _mm_max_epu8(xmmMax, xmmValues);
+                xmmSum = _mm_add_epi64(xmmSum,
+                                       _mm_sad_epu8(xmmValues, xmmZero));
+                const __m128i xmmLo = _mm_unpacklo_epi8(xmmValues, xmmZero);
+                const __m128i xmmHi = _mm_unpackhi_epi8(xmmValues, xmmZero);
+                xmmSumSq = _mm_add_epi32(xmmSumSq, _mm_madd_epi16(xmmLo, xmmLo));
+                xmmSumSq = _mm_add_epi32(xmmSumSq, _mm_madd_epi16(xmmHi, xmmHi));
+            }
 
-            // Catch the case of huge resizing ratios here
-            if ( nXReduced == 0 )
-                nXReduced = 1;
-            if ( nYReduced == 0 )
-                nYReduced = 1;
+            GUIntBig anSum[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(anSum), xmmSum);
+            nSum += anSum[0] + anSum[1];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(anSum), xmmNoDataCount);
+            nNoDataCount += anSum[0] + anSum[1];
+            GUInt32 anSumSq[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(anSumSq), xmmSumSq);
+            nSumSq += static_cast<GUIntBig>(anSumSq[0]) + anSumSq[1] +
+                      anSumSq[2] + anSumSq[3];
         }
-        else
+
+        for( ; iX < nXCheck; iX++ )
         {
-            nXReduced = nRasterXSize;
-            nYReduced = nRasterYSize;
+            const GUInt32 nValue = pabyLine[iX];
+            if( bHasNoData && nValue == byNoData )
+            {
+                nNoDataCount++;
+                continue;
+            }
+            if( nValue < nMin )
+                nMin = nValue;
+            if( nValue > nMax )
+                nMax = nValue;
+            nSum += nValue;
+            nSumSq += nValue * nValue;
         }
+    }
 
-        void *pData =
-            CPLMalloc(GDALGetDataTypeSize(eDataType)/8 * nXReduced * nYReduced);
+    GByte abyMin[16], abyMax[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(abyMin), xmmMin);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(abyMax), xmmMax);
+    for( int i = 0; i < 16; i++ )
+    {
+        nMin = MIN(nMin, abyMin[i]);
+        nMax = MAX(nMax, abyMax[i]);
+    }
 
-        CPLErr eErr = IRasterIO( GF_Read, 0, 0, nRasterXSize, nRasterYSize, pData,
-                   nXReduced, nYReduced, eDataType, 0, 0, &sExtraArg );
-        if ( eErr != CE_None )
-        {
-            CPLFree(pData);
-            return eErr;
-        }
+    sMoments.nCount =
+        static_cast<GUIntBig>(nXCheck) * nYCheck - nNoDataCount;
+    sMoments.nSum = nSum;
+    sMoments.nSumSq = nSumSq;
+    sMoments.nMin = nMin;
+    sMoments.nMax = nMax;
+}
+
+/************************************************************************/
+/*                    GDALComputeUInt16MomentsSSE2()                    */
+/************************************************************************/
 
-        /* this isn't the fastest way to do this, but is easier for now */
-        for( int iY = 0; iY < nYReduced; iY++ )
+static void GDALComputeUInt16MomentsSSE2( const GUInt16* panData,
+                                          int nXCheck, int nYCheck,
+                                          int nLineStride,
+                                          bool bHasNoData, GUInt16 nNoData,
+                                          GDALIntMoments& sMoments )
+{
+    /* SSE2 has no unsigned 16 bit min/max: they are done on values */
+    /* biased by 32768 with the signed instructions */
+    const __m128i xmmZero = _mm_setzero_si128();
+    const __m128i xmmBias = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128i xmmNoData = _mm_set1_epi16(static_cast<short>(nNoData));
+    __m128i xmmMin = _mm_set1_epi16(0x7FFF);
+    __m128i xmmMax = xmmBias;
+
+    GUIntBig nSum = 0;
+    GUIntBig nSumSq = 0;
+    GUIntBig nNoDataCount = 0;
+    GUInt32 nMin = 65535;
+    GUInt32 nMax = 0;
+
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const GUInt16* panLine = panData + static_cast<size_t>(iY) * nLineStride;
+        int iX = 0;
+        while( iX + 8 <= nXCheck )
         {
-            for( int iX = 0; iX < nXReduced; iX++ )
+            /* The 32 bit lanes of the sum cannot overflow before 32768 */
+            /* iterations */
+            const int nIters = MIN( (nXCheck - iX) / 8, 16384 );
+            __m128i xmmSum = xmmZero;
+            __m128i xmmSumSq = xmmZero;
+            __m128i xmmNoDataCount = xmmZero;
+            for( int i = 0; i < nIters; i++, iX += 8 )
             {
-                int    iOffset = iX + iY * nXReduced;
-                double dfValue = 0.0;
-
-                switch( eDataType )
+                __m128i xmmValues = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(panLine + iX) );
+                if( bHasNoData )
                 {
-                  case GDT_Byte:
-                  {
-                    if (bSignedByte)
-                        dfValue = ((signed char *)pData)[iOffset];
-                    else
-                        dfValue = ((GByte *)pData)[iOffset];
-                    break;
-                  }
-                  case GDT_UInt16:
-                    dfValue = ((GUInt16 *)pData)[iOffset];
-                    break;
-                  case GDT_Int16:
-                    dfValue = ((GInt16 *)pData)[iOffset];
-                    break;
-                  case GDT_UInt32:
-                    dfValue = ((GUInt32 *)pData)[iOffset];
-                    break;
-                  case GDT_Int32:
-                    dfValue = ((GInt32 *)pData)[iOffset];
-                    break;
-                  case GDT_Float32:
-                    dfValue = ((float *)pData)[iOffset];
-                    if (CPLIsNan(dfValue))
-                        continue;
+                    const __m128i xmmMask =
+                        _mm_cmpeq_epi16(xmmValues, xmmNoData);
+                    xmmMin = _mm_min_epi16(xmmMin, _mm_xor_si128(
+                                _mm_or_si128(xmmValues, xmmMask), xmmBias));
+                    xmmValues = _mm_andnot_si128(xmmMask, xmmValues);
+                    xmmNoDataCount = _mm_sub_epi16(xmmNoDataCount, xmmMask);
+                }
+                else
+                {
+                    xmmMin = _mm_min_epi16(xmmMin,
+                                           _mm_xor_si128(xmmValues, xmmBias));
+                }
+                xmmMax = _mm_max_epi16(xmmMax,
+                                       _mm_xor_si128(xmmValues, xmmBias));
+
+                xmmSum = _mm_add_epi32(xmmSum, _mm_add_epi32(
+                            _mm_unpacklo_epi16(xmmValues, xmmZero),
+                            _mm_unpackhi_epi16(xmmValues, xmmZero)));
+
+                /* 32 bit squares, accumulated in 64 bit lanes */
+                const __m128i xmmSqLow = _mm_mullo_epi16(xmmValues, xmmValues);
+                const __m128i xmmSqHigh = _mm_mulhi_epu16(xmmValues, xmmValues);
+                const __m128i xmmSq0 = _mm_unpacklo_epi16(xmmSqLow, xmmSqHigh);
+                const __m128i xmmSq1 = _mm_unpackhi_epi16(xmmSqLow, xmmSqHigh);
+                xmmSumSq = _mm_add_epi64(xmmSumSq,
+                                         _mm_unpacklo_epi32(xmmSq0, xmmZero));
+                xmmSumSq = _mm_add_epi64(xmmSumSq,
+                                         _mm_unpackhi_epi32(xmmSq0, xmmZero));
+                xmmSumSq = _mm_add_epi64(xmmSumSq,
+                                         _mm_unpacklo_epi32(xmmSq1, xmmZero));
+                xmmSumSq = _mm_add_epi64(xmmSumSq,
+                                         _mm_unpackhi_epi32(xmmSq1, xmmZero));
+            }
+
+            GUInt32 anSum[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(anSum), xmmSum);
+            nSum += static_cast<GUIntBig>(anSum[0]) + anSum[1] +
+                    anSum[2] + anSum[3];
+            GUIntBig anSumSq[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(anSumSq), xmmSumSq);
+            nSumSq += anSumSq[0] + anSumSq[1];
+            GUInt16 anNoDataCount[8];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(anNoDataCount),
+                             xmmNoDataCount);
+            for( int i = 0; i < 8; i++ )
+                nNoDataCount += anNoDataCount[i];
+        }
+
+        for( ; iX < nXCheck; iX++ )
+        {
+            const GUInt32 nValue = panLine[iX];
+            if( bHasNoData && nValue == nNoData )
+            {
+                nNoDataCount++;
+                continue;
+            }
+            if( nValue < nMin )
+                nMin = nValue;
+            if( nValue > nMax )
+                nMax = nValue;
+            nSum += nValue;
+            nSumSq += static_cast<GUIntBig>(nValue) * nValue;
+        }
+    }
+
+    GUInt16 anMin[8], anMax[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(anMin),
+                     _mm_xor_si128(xmmMin, xmmBias));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(anMax),
+                     _mm_xor_si128(xmmMax, xmmBias));
+    for( int i = 0; i < 8; i++ )
+    {
+        nMin = MIN(nMin, anMin[i]);
+        nMax = MAX(nMax, anMax[i]);
+    }
+
+    sMoments.nCount =
+        static_cast<GUIntBig>(nXCheck) * nYCheck - nNoDataCount;
+    sMoments.nSum = nSum;
+    sMoments.nSumSq = nSumSq;
+    sMoments.nMin = nMin;
+    sMoments.nMax = nMax;
+}
+
+#endif /* USE_SSE2 */
+
+/************************************************************************/
+/*                      GDALComputeGenericStats()                       */
+/*                                                                      */
+/*      32 bit integer and floating point data types: two passes, the   */
+/*      second one computing M2 and a correction of the mean.           */
+/************************************************************************/
+
+template<class T> static inline bool GDALStatsIsNan( T ) { return false; }
+static inline bool GDALStatsIsNan( float fValue ) { return CPLIsNan(fValue); }
+static inline bool GDALStatsIsNan( double dfValue ) { return CPLIsNan(dfValue); }
+
+template<class T>
+static void GDALComputeGenericStats( const T* pData,
+                                     int nXCheck, int nYCheck,
+                                     int nLineStride, int nPixelStride,
+                                     bool bHasNoData, double dfNoData,
+                                     bool bMoments, GDALStatsAccum& sAccum )
+{
+    GUIntBig nCount = 0;
+    double dfMin = 0.0;
+    double dfMax = 0.0;
+    double dfSum = 0.0;
+
+    sAccum = GDALStatsAccum();
+
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* pLine = pData + static_cast<size_t>(iY) * nLineStride;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            const T tValue = pLine[static_cast<size_t>(iX) * nPixelStride];
+            if( GDALStatsIsNan(tValue) )
+                continue;
+            const double dfValue = tValue;
+            if( bHasNoData && ARE_REAL_EQUAL(dfValue, dfNoData) )
+                continue;
+            if( nCount == 0 )
+                dfMin = dfMax = dfValue;
+            else if( dfValue < dfMin )
+                dfMin = dfValue;
+            else if( dfValue > dfMax )
+                dfMax = dfValue;
+            dfSum += dfValue;
+            nCount++;
+        }
+    }
+
+    if( nCount == 0 )
+        return;
+
+    sAccum.nCount = nCount;
+    sAccum.dfMin = dfMin;
+    sAccum.dfMax = dfMax;
+    sAccum.dfMean = dfSum / nCount;
+    if( !bMoments )
+        return;
+
+    double dfSumDelta = 0.0;
+    double dfSumDeltaSq = 0.0;
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* pLine = pData + static_cast<size_t>(iY) * nLineStride;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            const T tValue = pLine[static_cast<size_t>(iX) * nPixelStride];
+            if( GDALStatsIsNan(tValue) )
+                continue;
+            const double dfValue = tValue;
+            if( bHasNoData && ARE_REAL_EQUAL(dfValue, dfNoData) )
+                continue;
+            const double dfDelta = dfValue - sAccum.dfMean;
+            dfSumDelta += dfDelta;
+            dfSumDeltaSq += dfDelta * dfDelta;
+        }
+    }
+    sAccum.dfMean += dfSumDelta / nCount;
+    sAccum.dfM2 = MAX(0.0, dfSumDeltaSq - dfSumDelta * dfSumDelta / nCount);
+}
+
+/************************************************************************/
+/*                       GDALGetIntegerNoData()                         */
+/*                                                                      */
+/*      Returns the integer value of the data type that matches the     */
+/*      nodata value, if any.                                           */
+/************************************************************************/
+
+template<class T>
+static bool GDALGetIntegerNoData( double dfNoData, double dfTypeMin,
+                                  double dfTypeMax, T& tNoData )
+{
+    const double dfRounded = floor(dfNoData + 0.5);
+    if( !(dfRounded >= dfTypeMin && dfRounded <= dfTypeMax) ||
+        !ARE_REAL_EQUAL(dfRounded, dfNoData) )
+        return false;
+    tNoData = static_cast<T>(dfRounded);
+    return true;
+}
+
+/************************************************************************/
+/*                        GDALComputeBlockStats()                       */
+/*                                                                      */
+/*      Statistics of a block (of the real part for complex types).     */
+/*      nLineStride is in pixels.                                       */
+/************************************************************************/
+
+static void GDALComputeBlockStats( const void* pData, GDALDataType eDataType,
+                                   bool bSignedByte,
+                                   int nXCheck, int nYCheck, int nLineStride,
+                                   bool bHasNoData, double dfNoData,
+                                   bool bMoments, GDALStatsAccum& sAccum )
+{
+    GDALIntMoments sMoments;
+    int nOffset = 0;
+
+    switch( eDataType )
+    {
+      case GDT_Byte:
+      {
+        if( bSignedByte )
+        {
+            signed char chNoData = 0;
+            const bool bNoData = bHasNoData &&
+                GDALGetIntegerNoData(dfNoData, -128, 127, chNoData);
+            nOffset = 128;
+            GDALComputeIntMoments( static_cast<const signed char*>(pData),
+                                   nXCheck, nYCheck, nLineStride, 1,
+                                   bNoData, chNoData, nOffset, sMoments );
+            break;
+        }
+        GByte byNoData = 0;
+        const bool bNoData = bHasNoData &&
+            GDALGetIntegerNoData(dfNoData, 0, 255, byNoData);
+#ifdef USE_SSE2
+        GDALComputeByteMomentsSSE2( static_cast<const GByte*>(pData),
+                                    nXCheck, nYCheck, nLineStride,
+                                    bNoData, byNoData, sMoments );
+#else
+        GDALComputeIntMoments( static_cast<const GByte*>(pData),
+                               nXCheck, nYCheck, nLineStride, 1,
+                               bNoData, byNoData, nOffset, sMoments );
+#endif
+        break;
+      }
+
+      case GDT_UInt16:
+      {
+        GUInt16 nNoData = 0;
+        const bool bNoData = bHasNoData &&
+            GDALGetIntegerNoData(dfNoData, 0, 65535, nNoData);
+#ifdef USE_SSE2
+        GDALComputeUInt16MomentsSSE2( static_cast<const GUInt16*>(pData),
+                                      nXCheck, nYCheck, nLineStride,
+                                      bNoData, nNoData, sMoments );
+#else
+        GDALComputeIntMoments( static_cast<const GUInt16*>(pData),
+                               nXCheck, nYCheck, nLineStride, 1,
+                               bNoData, nNoData, nOffset, sMoments );
+#endif
+        break;
+      }
+
+      case GDT_Int16:
+      case GDT_CInt16:
+      {
+        GInt16 nNoData = 0;
+        const bool bNoData = bHasNoData &&
+            GDALGetIntegerNoData(dfNoData, -32768, 32767, nNoData);
+        const int nComponents = (eDataType == GDT_CInt16) ? 2 : 1;
+        nOffset = 32768;
+        GDALComputeIntMoments( static_cast<const GInt16*>(pData),
+                               nXCheck, nYCheck, nLineStride * nComponents,
+                               nComponents, bNoData, nNoData, nOffset,
+                               sMoments );
+        break;
+      }
+
+      case GDT_UInt32:
+        GDALComputeGenericStats( static_cast<const GUInt32*>(pData),
+                                 nXCheck, nYCheck, nLineStride, 1,
+                                 bHasNoData, dfNoData, bMoments, sAccum );
+        return;
+
+      case GDT_Int32:
+      case GDT_CInt32:
+      {
+        const int nComponents = (eDataType == GDT_CInt32) ? 2 : 1;
+        GDALComputeGenericStats( static_cast<const GInt32*>(pData),
+                                 nXCheck, nYCheck, nLineStride * nComponents,
+                                 nComponents, bHasNoData, dfNoData,
+                                 bMoments, sAccum );
+        return;
+      }
+
+      case GDT_Float32:
+      case GDT_CFloat32:
+      {
+        const int nComponents = (eDataType == GDT_CFloat32) ? 2 : 1;
+        GDALComputeGenericStats( static_cast<const float*>(pData),
+                                 nXCheck, nYCheck, nLineStride * nComponents,
+                                 nComponents, bHasNoData, dfNoData,
+                                 bMoments, sAccum );
+        return;
+      }
+
+      case GDT_Float64:
+      case GDT_CFloat64:
+      {
+        const int nComponents = (eDataType == GDT_CFloat64) ? 2 : 1;
+        GDALComputeGenericStats( static_cast<const double*>(pData),
+                                 nXCheck, nYCheck, nLineStride * nComponents,
+                                 nComponents, bHasNoData, dfNoData,
+                                 bMoments, sAccum );
+        return;
+      }
+
+      default:
+        CPLAssert( FALSE );
+        sAccum = GDALStatsAccum();
+        return;
+    }
+
+    GDALIntMomentsToAccum( sMoments, nOffset, sAccum );
+}
+
+/************************************************************************/
+/*                          GDALHistogramParams                         */
+/************************************************************************/
+
+struct GDALHistogramParams
+{
+    double      dfMin;
+    double      dfScale;
+    int         nBuckets;
+    bool        bIncludeOutOfRange;
+    bool        bHasNoData;
+    double      dfNoData;
+    bool        bSignedByte;
+
+    /* For 16 bit data types, bucket of each value (shifted by 32768 for */
+    /* GDT_Int16), or -1 if it is ignored. */
+    const int  *panBucketOfValue;
+};
+
+/************************************************************************/
+/*                       GDALGetHistogramBucket()                       */
+/*                                                                      */
+/*      Returns the bucket of a value, or -1 if it is ignored.          */
+/************************************************************************/
+
+static CPL_INLINE int GDALGetHistogramBucket( double dfValue,
+                                              const GDALHistogramParams& sParams )
+{
+    if( sParams.bHasNoData && ARE_REAL_EQUAL(dfValue, sParams.dfNoData) )
+        return -1;
+
+    const int nIndex =
+        static_cast<int>(floor((dfValue - sParams.dfMin) * sParams.dfScale));
+    if( nIndex < 0 )
+        return sParams.bIncludeOutOfRange ? 0 : -1;
+    if( nIndex >= sParams.nBuckets )
+        return sParams.bIncludeOutOfRange ? sParams.nBuckets - 1 : -1;
+    return nIndex;
+}
+
+/************************************************************************/
+/*                    GDALComputeGenericHistogram()                     */
+/************************************************************************/
+
+template<class T>
+static void GDALComputeGenericHistogram( const T* pData,
+                                         int nXCheck, int nYCheck,
+                                         int nLineStride,
+                                         const GDALHistogramParams& sParams,
+                                         GUIntBig* panHistogram )
+{
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* pLine = pData + static_cast<size_t>(iY) * nLineStride;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            if( GDALStatsIsNan(pLine[iX]) )
+                continue;
+            const int nBucket = GDALGetHistogramBucket( pLine[iX], sParams );
+            if( nBucket >= 0 )
+                panHistogram[nBucket]++;
+        }
+    }
+}
+
+/************************************************************************/
+/*                    GDALComputeComplexHistogram()                     */
+/*                                                                      */
+/*      Histogram of the magnitude of complex values.                   */
+/************************************************************************/
+
+template<class T>
+static void GDALComputeComplexHistogram( const T* pData,
+                                         int nXCheck, int nYCheck,
+                                         int nLineStride,
+                                         const GDALHistogramParams& sParams,
+                                         GUIntBig* panHistogram )
+{
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* pLine = pData + static_cast<size_t>(iY) * nLineStride * 2;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            const double dfReal = pLine[iX*2];
+            const double dfImag = pLine[iX*2+1];
+            if( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
+                continue;
+            const int nBucket = GDALGetHistogramBucket(
+                sqrt( dfReal * dfReal + dfImag * dfImag ), sParams );
+            if( nBucket >= 0 )
+                panHistogram[nBucket]++;
+        }
+    }
+}
+
+/************************************************************************/
+/*                    GDALComputeInt16Histogram()                       */
+/************************************************************************/
+
+template<class T>
+static void GDALComputeInt16Histogram( const T* pData,
+                                       int nXCheck, int nYCheck,
+                                       int nLineStride, int nOffset,
+                                       const GDALHistogramParams& sParams,
+                                       GUIntBig* panHistogram )
+{
+    const int* panBucketOfValue = sParams.panBucketOfValue + nOffset;
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* pLine = pData + static_cast<size_t>(iY) * nLineStride;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            const int nBucket = panBucketOfValue[pLine[iX]];
+            if( nBucket >= 0 )
+                panHistogram[nBucket]++;
+        }
+    }
+}
+
+/************************************************************************/
+/*                     GDALComputeBlockHistogram()                      */
+/*                                                                      */
+/*      Adds the values of a block to a histogram. nLineStride is in    */
+/*      pixels.                                                         */
+/************************************************************************/
+
+static void GDALComputeBlockHistogram( const void* pData,
+                                       GDALDataType eDataType,
+                                       int nXCheck, int nYCheck,
+                                       int nLineStride,
+                                       const GDALHistogramParams& sParams,
+                                       GUIntBig* panHistogram )
+{
+    switch( eDataType )
+    {
+      case GDT_Byte:
+      {
+        /* Count the occurrences of each value, and then add them to */
+        /* their bucket */
+        GUInt32 anCounts[256];
+        memset( anCounts, 0, sizeof(anCounts) );
+        const GByte* pabyData = static_cast<const GByte*>(pData);
+        for( int iY = 0; iY < nYCheck; iY++ )
+        {
+            const GByte* pabyLine =
+                pabyData + static_cast<size_t>(iY) * nLineStride;
+            for( int iX = 0; iX < nXCheck; iX++ )
+                anCounts[pabyLine[iX]]++;
+        }
+        for( int i = 0; i < 256; i++ )
+        {
+            if( anCounts[i] == 0 )
+                continue;
+            const double dfValue = sParams.bSignedByte ?
+                static_cast<double>(static_cast<signed char>(i)) : i;
+            const int nBucket = GDALGetHistogramBucket( dfValue, sParams );
+            if( nBucket >= 0 )
+                panHistogram[nBucket] += anCounts[i];
+        }
+        break;
+      }
+
+      case GDT_UInt16:
+        GDALComputeInt16Histogram( static_cast<const GUInt16*>(pData),
+                                   nXCheck, nYCheck, nLineStride, 0,
+                                   sParams, panHistogram );
+        break;
+
+      case GDT_Int16:
+        GDALComputeInt16Histogram( static_cast<const GInt16*>(pData),
+                                   nXCheck, nYCheck, nLineStride, 32768,
+                                   sParams, panHistogram );
+        break;
+
+      case GDT_UInt32:
+        GDALComputeGenericHistogram( static_cast<const GUInt32*>(pData),
+                                     nXCheck, nYCheck, nLineStride,
+                                     sParams, panHistogram );
+        break;
+
+      case GDT_Int32:
+        GDALComputeGenericHistogram( static_cast<const GInt32*>(pData),
+                                     nXCheck, nYCheck, nLineStride,
+                                     sParams, panHistogram );
+        break;
+
+      case GDT_Float32:
+        GDALComputeGenericHistogram( static_cast<const float*>(pData),
+                                     nXCheck, nYCheck, nLineStride,
+                                     sParams, panHistogram );
+        break;
+
+      case GDT_Float64:
+        GDALComputeGenericHistogram( static_cast<const double*>(pData),
+                                     nXCheck, nYCheck, nLineStride,
+                                     sParams, panHistogram );
+        break;
+
+      case GDT_CInt16:
+        GDALComputeComplexHistogram( static_cast<const GInt16*>(pData),
+                                     nXCheck, nYCheck, nLineStride,
+                                     sParams, panHistogram );
+        break;
+
+      case GDT_CInt32:
+        GDALComputeComplexHistogram( static_cast<const GInt32*>(pData),
+                                     nXCheck, nYCheck, nLineStride,
+                                     sParams, panHistogram );
+        break;
+
+      case GDT_CFloat32:
+        GDALComputeComplexHistogram( static_cast<const float*>(pData),
+                                     nXCheck, nYCheck, nLineStride,
+                                     sParams, panHistogram );
+        break;
+
+      case GDT_CFloat64:
+        GDALComputeComplexHistogram( static_cast<const double*>(pData),
+                                     nXCheck, nYCheck, nLineStride,
+                                     sParams, panHistogram );
+        break;
+
+      default:
+        CPLAssert( FALSE );
+        break;
+    }
+}
+
+/************************************************************************/
+/*                        GDALGetSweepMaskBand()                        */
+/*                                                                      */
+/*      Returns the mask band whose masked pixels must be ignored by    */
+/*      statistics, or NULL if only nodata (and NaN) values are.        */
+/************************************************************************/
+
+static GDALRasterBand* GDALGetSweepMaskBand( GDALRasterBand* poBand )
+{
+    const int nMaskFlags = poBand->GetMaskFlags();
+    if( (nMaskFlags & (GMF_ALL_VALID | GMF_NODATA)) != 0 ||
+        poBand->GetColorInterpretation() == GCI_AlphaBand )
+        return NULL;
+    return poBand->GetMaskBand();
+}
+
+/************************************************************************/
+/*                            GDALMaskBlock()                           */
+/*                                                                      */
+/*      Returns a Float64 (or CFloat64) copy of the block in adfBuffer, */
+/*      where the pixels masked by pabyMask (with the same line stride) */
+/*      are NaN, and updates eDataType and bSignedByte accordingly.     */
+/************************************************************************/
+
+static const void* GDALMaskBlock( std::vector<double>& adfBuffer,
+                                  const void* pData, const GByte* pabyMask,
+                                  GDALDataType& eDataType, bool& bSignedByte,
+                                  int nLineStride, int nXCheck, int nYCheck )
+{
+    const int nComponents = GDALDataTypeIsComplex(eDataType) ? 2 : 1;
+    adfBuffer.resize( static_cast<size_t>(nLineStride) * nYCheck * nComponents );
+
+    const int nDTSize = GDALGetDataTypeSize(eDataType) / 8;
+    const double dfNaN = CPLAtof("nan");
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const size_t nLineOffset = static_cast<size_t>(iY) * nLineStride;
+        double* padfLine = &adfBuffer[nLineOffset * nComponents];
+        const GByte* pabyLine =
+            static_cast<const GByte*>(pData) + nLineOffset * nDTSize;
+        if( bSignedByte )
+        {
+            for( int iX = 0; iX < nXCheck; iX++ )
+                padfLine[iX] = reinterpret_cast<const signed char*>(pabyLine)[iX];
+        }
+        else
+        {
+            GDALCopyWords( pabyLine, eDataType, nDTSize,
+                           padfLine, nComponents == 2 ? GDT_CFloat64 : GDT_Float64,
+                           static_cast<int>(sizeof(double)) * nComponents,
+                           nXCheck );
+        }
+        const GByte* pabyMaskLine = pabyMask + nLineOffset;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            if( pabyMaskLine[iX] == 0 )
+            {
+                for( int iComp = 0; iComp < nComponents; iComp++ )
+                    padfLine[iX * nComponents + iComp] = dfNaN;
+            }
+        }
+    }
+
+    eDataType = nComponents == 2 ? GDT_CFloat64 : GDT_Float64;
+    bSignedByte = false;
+    return &adfBuffer[0];
+}
+
+/************************************************************************/
+/*                        GDALReadReducedMask()                         */
+/*                                                                      */
+/*      Reads the mask band that applies to poBand, if any, at the      */
+/*      resolution of an approximate computation. abyMask is left       */
+/*      empty if there is no such mask.                                 */
+/************************************************************************/
+
+static CPLErr GDALReadReducedMask( GDALRasterBand* poBand,
+                                   int nXReduced, int nYReduced,
+                                   std::vector<GByte>& abyMask )
+{
+    GDALRasterBand* poMaskBand = GDALGetSweepMaskBand( poBand );
+    if( poMaskBand == NULL )
+        return CE_None;
+    abyMask.resize( static_cast<size_t>(nXReduced) * nYReduced );
+    return poMaskBand->RasterIO( GF_Read, 0, 0,
+                                 poBand->GetXSize(), poBand->GetYSize(),
+                                 &abyMask[0], nXReduced, nYReduced,
+                                 GDT_Byte, 0, 0, NULL );
+}
+
+/************************************************************************/
+/*                          GDALBlockSweepTask                          */
+/*                                                                      */
+/*      Work done on the blocks by GDALSweepBlocks(). ProcessBlock() is */
+/*      called by the worker threads and accumulates a block, of index  */
+/*      iBlock in the list of swept blocks, into a slot. pabyMask, if   */
+/*      not NULL, is the mask of the block, with the same line stride.  */
+/*      MergeSlot() is called by the calling thread, in block order, to */
+/*      merge a slot into the result and reset it.                      */
+/************************************************************************/
+
+class GDALBlockSweepTask
+{
+    std::vector< std::vector<double> >  aadfMaskedBlocks;
+
+  protected:
+    const void*     ApplyMask( int iSlot, const void* pData,
+                               const GByte* pabyMask, GDALDataType& eDataType,
+                               bool& bSignedByte, int nLineStride,
+                               int nXCheck, int nYCheck );
+
+  public:
+    virtual        ~GDALBlockSweepTask() {}
+
+    void            AllocateMaskSlots( int nSlots )
+                                    { aadfMaskedBlocks.resize( nSlots ); }
+    virtual bool    AllocateSlots( int nSlots ) = 0;
+    virtual void    ProcessBlock( int iSlot, int iBlock, const void* pData,
+                                  const GByte* pabyMask,
+                                  int nXCheck, int nYCheck ) = 0;
+    virtual void    MergeSlot( int iSlot ) = 0;
+};
+
+/************************************************************************/
+/*                     GDALBlockSweepTask::ApplyMask()                  */
+/*                                                                      */
+/*      AllocateMaskSlots() must have been called.                      */
+/************************************************************************/
+
+const void* GDALBlockSweepTask::ApplyMask( int iSlot, const void* pData,
+                                           const GByte* pabyMask,
+                                           GDALDataType& eDataType,
+                                           bool& bSignedByte, int nLineStride,
+                                           int nXCheck, int nYCheck )
+{
+    if( pabyMask == NULL )
+        return pData;
+
+    CPLAssert( iSlot < static_cast<int>(aadfMaskedBlocks.size()) );
+    return GDALMaskBlock( aadfMaskedBlocks[iSlot], pData, pabyMask,
+                          eDataType, bSignedByte, nLineStride,
+                          nXCheck, nYCheck );
+}
+
+struct GDALBlockSweepJob
+{
+    GDALBlockSweepTask              *poTask;
+    int                              iSlot;
+    std::vector<GDALRasterBlock*>    apoBlocks;
+    std::vector<int>                 anBlocks;
+    std::vector<int>                 anXCheck;
+    std::vector<int>                 anYCheck;
+    // Masks of the blocks, one block size apart, if a mask band is used
+    std::vector<GByte>               abyMasks;
+    int                              nBlockPixels;
+};
+
+static void GDALBlockSweepJobFunc( void* pData )
+{
+    GDALBlockSweepJob* psJob = static_cast<GDALBlockSweepJob*>(pData);
+    for( size_t i = 0; i < psJob->apoBlocks.size(); i++ )
+    {
+        const GByte* pabyMask = psJob->abyMasks.empty() ? NULL :
+            &psJob->abyMasks[i * psJob->nBlockPixels];
+        psJob->poTask->ProcessBlock( psJob->iSlot, psJob->anBlocks[i],
+                                     psJob->apoBlocks[i]->GetDataRef(),
+                                     pabyMask,
+                                     psJob->anXCheck[i], psJob->anYCheck[i] );
+    }
+}
+
+/* Merges the result of a processed job if bMerge, and releases its blocks */
+static void GDALBlockSweepJobRelease( GDALBlockSweepJob* psJob, bool bMerge )
+{
+    if( bMerge )
+        psJob->poTask->MergeSlot( psJob->iSlot );
+    for( size_t i = 0; i < psJob->apoBlocks.size(); i++ )
+        psJob->apoBlocks[i]->DropLock();
+    psJob->apoBlocks.clear();
+    psJob->anBlocks.clear();
+    psJob->anXCheck.clear();
+    psJob->anYCheck.clear();
+    psJob->abyMasks.clear();
+}
+
+/************************************************************************/
+/*                        GDALGetSampledBlocks()                        */
+/*                                                                      */
+/*      Returns the indices of one block every nSampleRate blocks.      */
+/************************************************************************/
+
+static std::vector<int> GDALGetSampledBlocks( int nTotalBlocks,
+                                              int nSampleRate )
+{
+    std::vector<int> anBlocks;
+    anBlocks.reserve( (nTotalBlocks + nSampleRate - 1) / nSampleRate );
+    for( int iSampleBlock = 0; iSampleBlock < nTotalBlocks;
+         iSampleBlock += nSampleRate )
+        anBlocks.push_back( iSampleBlock );
+    return anBlocks;
+}
+
+/************************************************************************/
+/*                           GDALSweepBlocks()                          */
+/*                                                                      */
+/*      Runs poTask on the blocks whose indices (in row major order)    */
+/*      are listed in anBlocks. Blocks that cannot be read are skipped  */
+/*      if bSkipMissingBlocks, and are an error otherwise.              */
+/*                                                                      */
+/*      The number of blocks locked at once is bounded by half of the   */
+/*      block cache, by reducing the size of the jobs, and then the     */
+/*      number of threads.                                              */
+/************************************************************************/
+
+static CPLErr GDALSweepBlocks( GDALRasterBand* poBand, int nBlocksPerRow,
+                               const std::vector<int>& anBlocks,
+                               bool bSkipMissingBlocks,
+                               GDALBlockSweepTask* poTask,
+                               const char* pszMessage,
+                               GDALProgressFunc pfnProgress,
+                               void* pProgressData )
+{
+    int nBlockXSize, nBlockYSize;
+    poBand->GetBlockSize( &nBlockXSize, &nBlockYSize );
+    const int nXSize = poBand->GetXSize();
+    const int nYSize = poBand->GetYSize();
+    const int nSampledBlocks = static_cast<int>(anBlocks.size());
+    GDALRasterBand* poMaskBand = GDALGetSweepMaskBand( poBand );
+
+    const GIntBig nBlockBytes = static_cast<GIntBig>(nBlockXSize) *
+        nBlockYSize * (GDALGetDataTypeSize(poBand->GetRasterDataType()) / 8);
+    const GIntBig nMaxLockedBlocks =
+        MAX( 1, GDALGetCacheMax64() / 2 / MAX(1, nBlockBytes) );
+
+    /* The size of the jobs must not depend on the number of threads */
+    const int nBlocksPerJob = static_cast<int>(MIN( MAX( 1, nMaxLockedBlocks / 2 ),
+        MAX( 1.0, GDALSTAT_PIXELS_PER_JOB /
+                    (static_cast<double>(nBlockXSize) * nBlockYSize) ) ));
+    const int nJobs = (nSampledBlocks + nBlocksPerJob - 1) / nBlocksPerJob;
+
+/* -------------------------------------------------------------------- */
+/*      Jobs are processed in batches of one job per thread. With       */
+/*      threads, two batches are alive: the one whose blocks are being  */
+/*      read, and the one being processed.                              */
+/* -------------------------------------------------------------------- */
+    const int nThreads = static_cast<int>(MIN( MIN( GDALGetNumThreads(), nJobs ),
+        MAX( 1, nMaxLockedBlocks / (2 * nBlocksPerJob) ) ));
+
+    CPLWorkerThreadPool* poPool = NULL;
+    if( nThreads > 1 )
+    {
+        poPool = new CPLWorkerThreadPool();
+        if( !poPool->Setup( nThreads, NULL, NULL ) )
+        {
+            delete poPool;
+            poPool = NULL;
+        }
+    }
+    const int nBatchSize = poPool ? nThreads : 1;
+    const int nBatches = poPool ? 2 : 1;
+
+    if( poMaskBand != NULL )
+        poTask->AllocateMaskSlots( nBatchSize * nBatches );
+    if( !poTask->AllocateSlots( nBatchSize * nBatches ) )
+    {
+        delete poPool;
+        poBand->ReportError( CE_Failure, CPLE_OutOfMemory,
+                             "Out of memory in %s", pszMessage );
+        return CE_Failure;
+    }
+
+    std::vector<GDALBlockSweepJob> asJobs( nBatchSize * nBatches );
+    for( size_t i = 0; i < asJobs.size(); i++ )
+    {
+        asJobs[i].poTask = poTask;
+        asJobs[i].iSlot = static_cast<int>(i);
+        asJobs[i].nBlockPixels = nBlockXSize * nBlockYSize;
+    }
+
+    CPLErr eErr = CE_None;
+    int iSampleBlock = 0;
+    int iBatch = 0;
+    int nPendingJobs = 0;
+
+    while( true )
+    {
+/* -------------------------------------------------------------------- */
+/*      Read the blocks of the next batch.                              */
+/* -------------------------------------------------------------------- */
+        GDALBlockSweepJob* pasBatch = &asJobs[iBatch * nBatchSize];
+        int nBatchJobs = 0;
+        while( eErr == CE_None && nBatchJobs < nBatchSize &&
+               iSampleBlock < nSampledBlocks )
+        {
+            GDALBlockSweepJob* psJob = &pasBatch[nBatchJobs];
+            while( static_cast<int>(psJob->apoBlocks.size()) < nBlocksPerJob &&
+                   iSampleBlock < nSampledBlocks )
+            {
+                if( !pfnProgress( iSampleBlock / static_cast<double>(nSampledBlocks),
+                                  pszMessage, pProgressData ) )
+                {
+                    poBand->ReportError( CE_Failure, CPLE_UserInterrupt,
+                                         "User terminated" );
+                    eErr = CE_Failure;
                     break;
-                  case GDT_Float64:
-                    dfValue = ((double *)pData)[iOffset];
-                    if (CPLIsNan(dfValue))
+                }
+
+                const int iBlock = anBlocks[iSampleBlock];
+                const int iYBlock = iBlock / nBlocksPerRow;
+                const int iXBlock = iBlock - nBlocksPerRow * iYBlock;
+                iSampleBlock++;
+
+                GDALRasterBlock *poBlock =
+                    poBand->GetLockedBlockRef( iXBlock, iYBlock );
+                if( poBlock == NULL )
+                {
+                    if( bSkipMissingBlocks )
                         continue;
+                    eErr = CE_Failure;
                     break;
-                  case GDT_CInt16:
-                    {
-                        double dfReal = ((GInt16 *)pData)[iOffset*2];
-                        double dfImag = ((GInt16 *)pData)[iOffset*2+1];
-                        if ( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
-                            continue;
-                        dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
-                    }
-                    break;
-                  case GDT_CInt32:
-                    {
-                        double dfReal = ((GInt32 *)pData)[iOffset*2];
-                        double dfImag = ((GInt32 *)pData)[iOffset*2+1];
-                        if ( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
-                            continue;
-                        dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
-                    }
-                    break;
-                  case GDT_CFloat32:
-                    {
-                        double dfReal = ((float *)pData)[iOffset*2];
-                        double dfImag = ((float *)pData)[iOffset*2+1];
-                        if ( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
-                            continue;
-                        dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
-                    }
-                    break;
-                  case GDT_CFloat64:
+                }
+
+                const int nXCheck =
+                    MIN(nBlockXSize, nXSize - iXBlock * nBlockXSize);
+                const int nYCheck =
+                    MIN(nBlockYSize, nYSize - iYBlock * nBlockYSize);
+                if( poMaskBand != NULL )
+                {
+                    const size_t nMaskOffset = psJob->abyMasks.size();
+                    psJob->abyMasks.resize(
+                        nMaskOffset + static_cast<size_t>(psJob->nBlockPixels) );
+                    if( poMaskBand->RasterIO( GF_Read,
+                            iXBlock * nBlockXSize, iYBlock * nBlockYSize,
+                            nXCheck, nYCheck, &psJob->abyMasks[nMaskOffset],
+                            nXCheck, nYCheck, GDT_Byte,
+                            1, nBlockXSize, NULL ) != CE_None )
                     {
-                        double dfReal = ((double *)pData)[iOffset*2];
-                        double dfImag = ((double *)pData)[iOffset*2+1];
-                        if ( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
-                            continue;
-                        dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
+                        psJob->abyMasks.resize( nMaskOffset );
+                        poBlock->DropLock();
+                        eErr = CE_Failure;
+                        break;
                     }
-                    break;
-                  default:
-                    CPLAssert( FALSE );
                 }
 
-                if( bGotNoDataValue && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
-                    continue;
+                psJob->apoBlocks.push_back( poBlock );
+                psJob->anBlocks.push_back( iSampleBlock - 1 );
+                psJob->anXCheck.push_back( nXCheck );
+                psJob->anYCheck.push_back( nYCheck );
+            }
+            if( !psJob->apoBlocks.empty() )
+                nBatchJobs++;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Wait for the previous batch, and merge it in order.             */
+/* -------------------------------------------------------------------- */
+        if( nPendingJobs > 0 )
+        {
+            poPool->WaitCompletion();
+            GDALBlockSweepJob* pasPrevBatch = &asJobs[(1 - iBatch) * nBatchSize];
+            for( int i = 0; i < nPendingJobs; i++ )
+                GDALBlockSweepJobRelease( &pasPrevBatch[i], true );
+            nPendingJobs = 0;
+        }
+
+        if( eErr != CE_None )
+        {
+            for( int i = 0; i < nBatchJobs; i++ )
+                GDALBlockSweepJobRelease( &pasBatch[i], false );
+            break;
+        }
+        if( nBatchJobs == 0 )
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      Process the batch.                                              */
+/* -------------------------------------------------------------------- */
+        if( poPool == NULL )
+        {
+            GDALBlockSweepJobFunc( &pasBatch[0] );
+            GDALBlockSweepJobRelease( &pasBatch[0], true );
+            continue;
+        }
+
+        for( int i = 0; i < nBatchJobs; i++ )
+        {
+            if( !poPool->SubmitJob( GDALBlockSweepJobFunc, &pasBatch[i] ) )
+                GDALBlockSweepJobFunc( &pasBatch[i] );
+        }
+        nPendingJobs = nBatchJobs;
+        iBatch = 1 - iBatch;
+    }
+
+    delete poPool;
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                          GDALStatsSweepTask                          */
+/************************************************************************/
+
+class GDALStatsSweepTask : public GDALBlockSweepTask
+{
+    GDALDataType                 eDataType;
+    bool                         bSignedByte;
+    int                          nLineStride;
+    bool                         bHasNoData;
+    double                       dfNoData;
+    bool                         bMoments;
+    std::vector<GDALStatsAccum>  asSlots;
+    GDALStatsAccum               sResult;
+
+  public:
+    GDALStatsSweepTask( GDALDataType eDataTypeIn, bool bSignedByteIn,
+                        int nLineStrideIn, bool bHasNoDataIn,
+                        double dfNoDataIn, bool bMomentsIn ) :
+        eDataType(eDataTypeIn), bSignedByte(bSignedByteIn),
+        nLineStride(nLineStrideIn), bHasNoData(bHasNoDataIn),
+        dfNoData(dfNoDataIn), bMoments(bMomentsIn) {}
+
+    virtual bool AllocateSlots( int nSlots )
+    {
+        asSlots.resize( nSlots );
+        return true;
+    }
+
+    virtual void ProcessBlock( int iSlot, int /* iBlock */, const void* pData,
+                               const GByte* pabyMask,
+                               int nXCheck, int nYCheck )
+    {
+        GDALDataType eBlockDataType = eDataType;
+        bool bBlockSignedByte = bSignedByte;
+        pData = ApplyMask( iSlot, pData, pabyMask, eBlockDataType,
+                           bBlockSignedByte, nLineStride, nXCheck, nYCheck );
+        GDALStatsAccum sBlock;
+        GDALComputeBlockStats( pData, eBlockDataType, bBlockSignedByte,
+                               nXCheck, nYCheck, nLineStride,
+                               bHasNoData, dfNoData, bMoments, sBlock );
+        asSlots[iSlot].Merge( sBlock );
+    }
+
+    virtual void MergeSlot( int iSlot )
+    {
+        sResult.Merge( asSlots[iSlot] );
+        asSlots[iSlot] = GDALStatsAccum();
+    }
+
+    const GDALStatsAccum& GetResult() const { return sResult; }
+};
+
+/************************************************************************/
+/*                        GDALHistogramSweepTask                        */
+/************************************************************************/
+
+class GDALHistogramSweepTask : public GDALBlockSweepTask
+{
+    GDALDataType                 eDataType;
+    int                          nLineStride;
+    const GDALHistogramParams   &sParams;
+    GUIntBig                    *panHistogram;
+    GUIntBig                    *panSlots;
+
+  public:
+    GDALHistogramSweepTask( GDALDataType eDataTypeIn, int nLineStrideIn,
+                            const GDALHistogramParams& sParamsIn,
+                            GUIntBig* panHistogramIn ) :
+        eDataType(eDataTypeIn), nLineStride(nLineStrideIn),
+        sParams(sParamsIn), panHistogram(panHistogramIn), panSlots(NULL) {}
+
+    virtual ~GDALHistogramSweepTask() { CPLFree( panSlots ); }
+
+    virtual bool AllocateSlots( int nSlots )
+    {
+        panSlots = static_cast<GUIntBig*>(
+            VSI_CALLOC_VERBOSE( static_cast<size_t>(nSlots) * sParams.nBuckets,
+                                sizeof(GUIntBig) ));
+        return panSlots != NULL;
+    }
+
+    virtual void ProcessBlock( int iSlot, int /* iBlock */, const void* pData,
+                               const GByte* pabyMask,
+                               int nXCheck, int nYCheck )
+    {
+        GDALDataType eBlockDataType = eDataType;
+        bool bSignedByte = sParams.bSignedByte;
+        pData = ApplyMask( iSlot, pData, pabyMask, eBlockDataType,
+                           bSignedByte, nLineStride, nXCheck, nYCheck );
+        GDALComputeBlockHistogram( pData, eBlockDataType, nXCheck, nYCheck,
+                                   nLineStride, sParams,
+                                   panSlots + static_cast<size_t>(iSlot) *
+                                                            sParams.nBuckets );
+    }
+
+    virtual void MergeSlot( int iSlot )
+    {
+        GUIntBig* panSlot =
+            panSlots + static_cast<size_t>(iSlot) * sParams.nBuckets;
+        for( int i = 0; i < sParams.nBuckets; i++ )
+        {
+            panHistogram[i] += panSlot[i];
+            panSlot[i] = 0;
+        }
+    }
+};
+
+/************************************************************************/
+/*                      GDALSampledStatsSweepTask                       */
+/*                                                                      */
+/*      Statistics of each block, and quantile sketch of all values.    */
+/************************************************************************/
+
+class GDALSampledStatsSweepTask : public GDALBlockSweepTask
+{
+    GDALDataType                        eDataType;
+    bool                                bSignedByte;
+    int                                 nLineStride;
+    bool                                bHasNoData;
+    double                              dfNoData;
+    std::vector<GDALStatsAccum>         asBlocks;
+    std::vector<GDALQuantileSketch>     aoSlots;
+    std::vector< std::vector<double> >  aadfLines;
+    GDALQuantileSketch                  oSketch;
+
+  public:
+    GDALSampledStatsSweepTask( GDALDataType eDataTypeIn, bool bSignedByteIn,
+                               int nLineStrideIn, bool bHasNoDataIn,
+                               double dfNoDataIn, int nBlocks ) :
+        eDataType(eDataTypeIn), bSignedByte(bSignedByteIn),
+        nLineStride(nLineStrideIn), bHasNoData(bHasNoDataIn),
+        dfNoData(dfNoDataIn), asBlocks(nBlocks) {}
+
+    virtual bool AllocateSlots( int nSlots )
+    {
+        aoSlots.resize( nSlots );
+        aadfLines.resize( nSlots );
+        return true;
+    }
+
+    virtual void ProcessBlock( int iSlot, int iBlock, const void* pData,
+                               const GByte* pabyMask,
+                               int nXCheck, int nYCheck )
+    {
+        GDALDataType eBlockDataType = eDataType;
+        bool bBlockSignedByte = bSignedByte;
+        pData = ApplyMask( iSlot, pData, pabyMask, eBlockDataType,
+                           bBlockSignedByte, nLineStride, nXCheck, nYCheck );
+        GDALComputeBlockStats( pData, eBlockDataType, bBlockSignedByte,
+                               nXCheck, nYCheck, nLineStride,
+                               bHasNoData, dfNoData, true, asBlocks[iBlock] );
+
+        /* Feed the valid values, or the real part of complex values, */
+        /* to the sketch */
+        std::vector<double>& adfLine = aadfLines[iSlot];
+        adfLine.resize( nXCheck );
+        const int nDTSize = GDALGetDataTypeSize(eBlockDataType) / 8;
+        for( int iY = 0; iY < nYCheck; iY++ )
+        {
+            const GByte* pabyLine = static_cast<const GByte*>(pData) +
+                static_cast<size_t>(iY) * nLineStride * nDTSize;
+            if( bBlockSignedByte )
+            {
+                for( int iX = 0; iX < nXCheck; iX++ )
+                    adfLine[iX] = reinterpret_cast<const signed char*>(pabyLine)[iX];
+            }
+            else
+            {
+                GDALCopyWords( pabyLine, eBlockDataType, nDTSize,
+                               &adfLine[0], GDT_Float64, sizeof(double),
+                               nXCheck );
+            }
+            for( int iX = 0; iX < nXCheck; iX++ )
+            {
+                const double dfValue = adfLine[iX];
+                if( CPLIsNan(dfValue) ||
+                    (bHasNoData && ARE_REAL_EQUAL(dfValue, dfNoData)) )
+                    continue;
+                aoSlots[iSlot].Insert( dfValue );
+            }
+        }
+    }
+
+    virtual void MergeSlot( int iSlot )
+    {
+        oSketch.Merge( aoSlots[iSlot] );
+        aoSlots[iSlot].Reset();
+    }
+
+    const std::vector<GDALStatsAccum>& GetBlockStats() const { return asBlocks; }
+    const GDALQuantileSketch& GetSketch() const { return oSketch; }
+};
+
+/************************************************************************/
+/*                         GDALGetRandomBlocks()                        */
+/*                                                                      */
+/*      Returns the sorted indices of nBlocks blocks picked at random   */
+/*      among nTotalBlocks, by selection sampling (Knuth's algorithm    */
+/*      S). The generator has a fixed seed, so that results are         */
+/*      reproducible.                                                   */
+/************************************************************************/
+
+static std::vector<int> GDALGetRandomBlocks( int nTotalBlocks, int nBlocks )
+{
+    std::vector<int> anBlocks;
+    anBlocks.reserve( nBlocks );
+
+    /* xorshift64 */
+    GUIntBig nState = (static_cast<GUIntBig>(0x9E3779B9U) << 32) | 0x7F4A7C15U;
+    for( int iBlock = 0;
+         iBlock < nTotalBlocks && static_cast<int>(anBlocks.size()) < nBlocks;
+         iBlock++ )
+    {
+        nState ^= nState << 13;
+        nState ^= nState >> 7;
+        nState ^= nState << 17;
+        const double dfRandom =
+            static_cast<double>(nState >> 11) / 9007199254740992.0;
+        const int nRemaining = nBlocks - static_cast<int>(anBlocks.size());
+        if( dfRandom * (nTotalBlocks - iBlock) < nRemaining )
+            anBlocks.push_back( iBlock );
+    }
+    return anBlocks;
+}
+
+/************************************************************************/
+/*                      GDALComputeSamplingErrors()                     */
+/*                                                                      */
+/*      Half-widths of the 95% confidence intervals of the mean and of  */
+/*      the standard deviation, estimated from a random sample of       */
+/*      blocks. The blocks are the sampling units (cluster sampling),   */
+/*      and the mean and the variance are ratio estimators.             */
+/************************************************************************/
+
+static void GDALComputeSamplingErrors( const std::vector<GDALStatsAccum>& asBlocks,
+                                       const GDALStatsAccum& sStats,
+                                       double dfSampledFraction,
+                                       double* pdfMeanError,
+                                       double* pdfStdDevError )
+{
+    *pdfMeanError = 0.0;
+    *pdfStdDevError = 0.0;
+
+    const size_t nBlocks = asBlocks.size();
+    if( dfSampledFraction >= 1.0 || nBlocks < 2 || sStats.nCount == 0 )
+        return;
+
+    const double dfVariance = sStats.dfM2 / sStats.nCount;
+    double dfSumMeanDev2 = 0.0;
+    double dfSumVarianceDev2 = 0.0;
+    for( size_t i = 0; i < nBlocks; i++ )
+    {
+        const double dfCount = static_cast<double>(asBlocks[i].nCount);
+        if( dfCount == 0.0 )
+            continue;
+        const double dfDelta = asBlocks[i].dfMean - sStats.dfMean;
+        const double dfMeanDev = dfCount * dfDelta;
+        const double dfVarianceDev =
+            asBlocks[i].dfM2 + dfCount * dfDelta * dfDelta - dfVariance * dfCount;
+        dfSumMeanDev2 += dfMeanDev * dfMeanDev;
+        dfSumVarianceDev2 += dfVarianceDev * dfVarianceDev;
+    }
+
+    const double dfMeanCount = static_cast<double>(sStats.nCount) / nBlocks;
+    const double dfFactor = (1.0 - dfSampledFraction) /
+        (nBlocks * (nBlocks - 1) * dfMeanCount * dfMeanCount);
+    const double dfZ95 = 1.96;
+    *pdfMeanError = dfZ95 * sqrt( dfFactor * dfSumMeanDev2 );
+    const double dfStdDev = sqrt( dfVariance );
+    if( dfStdDev > 0.0 )
+        *pdfStdDevError =
+            dfZ95 * sqrt( dfFactor * dfSumVarianceDev2 ) / (2.0 * dfStdDev);
+}
+
+/************************************************************************/
+/*                     GDALClearSampledStatistics()                     */
+/*                                                                      */
+/*      Remove the metadata items set by ComputeSampledStatistics(),    */
+/*      which no longer describe statistics computed again. Only        */
+/*      exact statistics remove STATISTICS_APPROXIMATE.                 */
+/************************************************************************/
+
+static void GDALClearSampledStatistics( GDALRasterBand* poBand,
+                                        bool bClearApproximate )
+{
+    if( bClearApproximate &&
+        poBand->GetMetadataItem("STATISTICS_APPROXIMATE") != NULL )
+        poBand->SetMetadataItem( "STATISTICS_APPROXIMATE", NULL );
+    if( poBand->GetMetadataItem("STATISTICS_MEAN_ERROR") != NULL )
+        poBand->SetMetadataItem( "STATISTICS_MEAN_ERROR", NULL );
+    if( poBand->GetMetadataItem("STATISTICS_STDDEV_ERROR") != NULL )
+        poBand->SetMetadataItem( "STATISTICS_STDDEV_ERROR", NULL );
+    if( poBand->GetMetadataItem("KLL", "STATISTICS_SKETCH") != NULL )
+        poBand->SetMetadataItem( "KLL", NULL, "STATISTICS_SKETCH" );
+}
+
+/************************************************************************/
+/*                            GetHistogram()                            */
+/************************************************************************/
+
+/**
+ * \brief Compute raster histogram.
+ *
+ * Note that the bucket size is (dfMax-dfMin) / nBuckets.
+ *
+ * For example to compute a simple 256 entry histogram of eight bit data,
+ * the following would be suitable.  The unusual bounds are to ensure that
+ * bucket boundaries don't fall right on integer values causing possible errors
+ * due to rounding after scaling.
+<pre>
+    GUIntBig anHistogram[256];
+
+    poBand->GetHistogram( -0.5, 255.5, 256, anHistogram, FALSE, FALSE,
+                          GDALDummyProgress, NULL );
+</pre>
+ *
+ * Note that setting bApproxOK will generally result in a subsampling of the
+ * file, and will utilize overviews if available.  It should generally
+ * produce a representative histogram for the data that is suitable for use
+ * in generating histogram based luts for instance.  Generally bApproxOK is
+ * much faster than an exactly computed histogram.
+ *
+ * Pixels masked out by a per-dataset mask or by an alpha band (see
+ * GetMaskFlags()) are not counted.
+ *
+ * The blocks can be processed by several threads, by setting the
+ * GDAL_NUM_THREADS configuration option to a number of threads or ALL_CPUS.
+ * The result does not depend on the number of threads.
+ *
+ * This method is the same as the C functions GDALGetRasterHistogram() and
+ * GDALGetRasterHistogramEx().
+ *
+ * @param dfMin the lower bound of the histogram.
+ * @param dfMax the upper bound of the histogram.
+ * @param nBuckets the number of buckets in panHistogram.
+ * @param panHistogram array into which the histogram totals are placed.
+ * @param bIncludeOutOfRange if TRUE values below the histogram range will
+ * mapped into panHistogram[0], and values above will be mapped into
+ * panHistogram[nBuckets-1] otherwise out of range values are discarded.
+ * @param bApproxOK TRUE if an approximate, or incomplete histogram OK.
+ * @param pfnProgress function to report progress to completion.
+ * @param pProgressData application data to pass to pfnProgress.
+ *
+ * @return CE_None on success, or CE_Failure if something goes wrong.
+ */
+
+CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
+                                     int nBuckets, GUIntBig *panHistogram,
+                                     int bIncludeOutOfRange, int bApproxOK,
+                                     GDALProgressFunc pfnProgress,
+                                     void *pProgressData )
+
+{
+    CPLAssert( NULL != panHistogram );
+
+    if( pfnProgress == NULL )
+        pfnProgress = GDALDummyProgress;
+
+/* -------------------------------------------------------------------- */
+/*      If we have overviews, use them for the histogram.               */
+/* -------------------------------------------------------------------- */
+    if( bApproxOK && GetOverviewCount() > 0 && !HasArbitraryOverviews() )
+    {
+        // FIXME: should we use the most reduced overview here or use some
+        // minimum number of samples like GDALRasterBand::ComputeStatistics()
+        // does?
+        GDALRasterBand *poBestOverview = GetRasterSampleOverview( 0 );
+
+        if( poBestOverview != this )
+        {
+            return poBestOverview->GetHistogram( dfMin, dfMax, nBuckets,
+                                                 panHistogram,
+                                                 bIncludeOutOfRange, bApproxOK,
+                                                 pfnProgress, pProgressData );
+        }
+    }
 
-                int nIndex = (int) floor((dfValue - dfMin) * dfScale);
+/* -------------------------------------------------------------------- */
+/*      Read actual data and build histogram.                           */
+/* -------------------------------------------------------------------- */
+    if( !pfnProgress( 0.0, "Compute Histogram", pProgressData ) )
+    {
+        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
 
-                if( nIndex < 0 )
-                {
-                    if( bIncludeOutOfRange )
-                        panHistogram[0]++;
-                }
-                else if( nIndex >= nBuckets )
-                {
-                    if( bIncludeOutOfRange )
-                        panHistogram[nBuckets-1]++;
-                }
-                else
-                {
-                    panHistogram[nIndex]++;
-                }
-            }
+    GDALRasterIOExtraArg sExtraArg;
+    INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+
+    memset( panHistogram, 0, sizeof(GUIntBig) * nBuckets );
+
+    int bGotNoDataValue;
+    const double dfNoDataValue = GetNoDataValue( &bGotNoDataValue );
+    bGotNoDataValue = bGotNoDataValue && !CPLIsNan(dfNoDataValue);
+    /* Not advertized. May be removed at any time. Just as a provision if the */
+    /* old behaviour made sense somethimes... */
+    bGotNoDataValue = bGotNoDataValue &&
+        !CPLTestBool(CPLGetConfigOption("GDAL_NODATA_IN_HISTOGRAM", "NO"));
+
+    const char* pszPixelType = GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+    const bool bSignedByte = (pszPixelType != NULL && EQUAL(pszPixelType, "SIGNEDBYTE"));
+
+    GDALHistogramParams sParams;
+    sParams.dfMin = dfMin;
+    sParams.dfScale = nBuckets / (dfMax - dfMin);
+    sParams.nBuckets = nBuckets;
+    sParams.bIncludeOutOfRange = CPL_TO_BOOL(bIncludeOutOfRange);
+    sParams.bHasNoData = CPL_TO_BOOL(bGotNoDataValue);
+    sParams.dfNoData = dfNoDataValue;
+    sParams.bSignedByte = bSignedByte;
+    sParams.panBucketOfValue = NULL;
+
+/* -------------------------------------------------------------------- */
+/*      For 16 bit data types, precompute the bucket of each value.     */
+/* -------------------------------------------------------------------- */
+    std::vector<int> anBucketOfValue;
+    if( eDataType == GDT_UInt16 || eDataType == GDT_Int16 )
+    {
+        anBucketOfValue.resize( 65536 );
+        for( int i = 0; i < 65536; i++ )
+        {
+            anBucketOfValue[i] = GDALGetHistogramBucket(
+                eDataType == GDT_Int16 ? i - 32768 : i, sParams );
+        }
+        sParams.panBucketOfValue = &anBucketOfValue[0];
+    }
+
+    if ( bApproxOK && HasArbitraryOverviews() )
+    {
+/* -------------------------------------------------------------------- */
+/*      Figure out how much the image should be reduced to get an       */
+/*      approximate value.                                              */
+/* -------------------------------------------------------------------- */
+        double  dfReduction = sqrt(
+            (double)nRasterXSize * nRasterYSize / GDALSTAT_APPROX_NUMSAMPLES );
+
+        int     nXReduced, nYReduced;
+
+        if ( dfReduction > 1.0 )
+        {
+            nXReduced = (int)( nRasterXSize / dfReduction );
+            nYReduced = (int)( nRasterYSize / dfReduction );
+
+            // Catch the case of huge resizing ratios here
+            if ( nXReduced == 0 )
+                nXReduced = 1;
+            if ( nYReduced == 0 )
+                nYReduced = 1;
+        }
+        else
+        {
+            nXReduced = nRasterXSize;
+            nYReduced = nRasterYSize;
+        }
+
+        void *pData =
+            CPLMalloc(GDALGetDataTypeSize(eDataType)/8 * nXReduced * nYReduced);
+
+        CPLErr eErr = IRasterIO( GF_Read, 0, 0, nRasterXSize, nRasterYSize, pData,
+                   nXReduced, nYReduced, eDataType, 0, 0, &sExtraArg );
+        if ( eErr != CE_None )
+        {
+            CPLFree(pData);
+            return eErr;
+        }
+
+        std::vector<GByte> abyMask;
+        eErr = GDALReadReducedMask( this, nXReduced, nYReduced, abyMask );
+        if ( eErr != CE_None )
+        {
+            CPLFree(pData);
+            return eErr;
         }
+        GDALDataType eReducedDataType = eDataType;
+        bool bReducedSignedByte = sParams.bSignedByte;
+        std::vector<double> adfMasked;
+        const void* pReduced = abyMask.empty() ? pData :
+            GDALMaskBlock( adfMasked, pData, &abyMask[0], eReducedDataType,
+                           bReducedSignedByte, nXReduced, nXReduced, nYReduced );
+
+        GDALComputeBlockHistogram( pReduced, eReducedDataType,
+                                   nXReduced, nYReduced,
+                                   nXReduced, sParams, panHistogram );
 
         CPLFree( pData );
     }
@@ -2907,165 +4627,14 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
 /* -------------------------------------------------------------------- */
 /*      Read the blocks, and add to histogram.                          */
 /* -------------------------------------------------------------------- */
-        for( int iSampleBlock = 0;
-             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-             iSampleBlock += nSampleRate )
-        {
-            int  nXCheck, nYCheck;
-
-            if( !pfnProgress( iSampleBlock
-                              / ((double)nBlocksPerRow * nBlocksPerColumn),
-                              "Compute Histogram", pProgressData ) )
-                return CE_Failure;
-
-            int iYBlock = iSampleBlock / nBlocksPerRow;
-            int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-            GDALRasterBlock *poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-            if( poBlock == NULL )
-                return CE_Failure;
-
-            void *pData = poBlock->GetDataRef();
-
-            if( (iXBlock+1) * nBlockXSize > GetXSize() )
-                nXCheck = GetXSize() - iXBlock * nBlockXSize;
-            else
-                nXCheck = nBlockXSize;
-
-            if( (iYBlock+1) * nBlockYSize > GetYSize() )
-                nYCheck = GetYSize() - iYBlock * nBlockYSize;
-            else
-                nYCheck = nBlockYSize;
-
-            /* this is a special case for a common situation */
-            if( eDataType == GDT_Byte && !bSignedByte
-                && dfScale == 1.0 && (dfMin >= -0.5 && dfMin <= 0.5)
-                && nYCheck == nBlockYSize && nXCheck == nBlockXSize
-                && nBuckets == 256 )
-            {
-                int    nPixels = nXCheck * nYCheck;
-                GByte  *pabyData = (GByte *) pData;
-
-                for( int i = 0; i < nPixels; i++ )
-                    if (! (bGotNoDataValue && (pabyData[i] == (GByte)dfNoDataValue)))
-                    {
-                        panHistogram[pabyData[i]]++;
-                    }
-
-                poBlock->DropLock();
-                continue; /* to next sample block */
-            }
-
-            /* this isn't the fastest way to do this, but is easier for now */
-            for( int iY = 0; iY < nYCheck; iY++ )
-            {
-                for( int iX = 0; iX < nXCheck; iX++ )
-                {
-                    int    iOffset = iX + iY * nBlockXSize;
-                    int    nIndex;
-                    double dfValue = 0.0;
-
-                    switch( eDataType )
-                    {
-                      case GDT_Byte:
-                      {
-                        if (bSignedByte)
-                            dfValue = ((signed char *) pData)[iOffset];
-                        else
-                            dfValue = ((GByte *) pData)[iOffset];
-                        break;
-                      }
-                      case GDT_UInt16:
-                        dfValue = ((GUInt16 *) pData)[iOffset];
-                        break;
-                      case GDT_Int16:
-                        dfValue = ((GInt16 *) pData)[iOffset];
-                        break;
-                      case GDT_UInt32:
-                        dfValue = ((GUInt32 *) pData)[iOffset];
-                        break;
-                      case GDT_Int32:
-                        dfValue = ((GInt32 *) pData)[iOffset];
-                        break;
-                      case GDT_Float32:
-                        dfValue = ((float *) pData)[iOffset];
-                        if (CPLIsNan(dfValue))
-                            continue;
-                        break;
-                      case GDT_Float64:
-                        dfValue = ((double *) pData)[iOffset];
-                        if (CPLIsNan(dfValue))
-                            continue;
-                        break;
-                      case GDT_CInt16:
-                        {
-                            double  dfReal =
-                                ((GInt16 *) pData)[iOffset*2];
-                            double  dfImag =
-                                ((GInt16 *) pData)[iOffset*2+1];
-                            dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
-                        }
-                        break;
-                      case GDT_CInt32:
-                        {
-                            double  dfReal =
-                                ((GInt32 *) pData)[iOffset*2];
-                            double  dfImag =
-                                ((GInt32 *) pData)[iOffset*2+1];
-                            dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
-                        }
-                        break;
-                      case GDT_CFloat32:
-                        {
-                            double  dfReal =
-                                ((float *) pData)[iOffset*2];
-                            double  dfImag =
-                                ((float *) pData)[iOffset*2+1];
-                            if ( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
-                                continue;
-                            dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
-                        }
-                        break;
-                      case GDT_CFloat64:
-                        {
-                            double  dfReal =
-                                ((double *) pData)[iOffset*2];
-                            double  dfImag =
-                                ((double *) pData)[iOffset*2+1];
-                            if ( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
-                                continue;
-                            dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
-                        }
-                        break;
-                      default:
-                        CPLAssert( FALSE );
-                        return CE_Failure;
-                    }
-
-                    if( bGotNoDataValue && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
-                        continue;
-
-                    nIndex = (int) floor((dfValue - dfMin) * dfScale);
-
-                    if( nIndex < 0 )
-                    {
-                        if( bIncludeOutOfRange )
-                            panHistogram[0]++;
-                    }
-                    else if( nIndex >= nBuckets )
-                    {
-                        if( bIncludeOutOfRange )
-                            panHistogram[nBuckets-1]++;
-                    }
-                    else
-                    {
-                        panHistogram[nIndex]++;
-                    }
-                }
-            }
-
-            poBlock->DropLock();
-        }
+        GDALHistogramSweepTask oTask( eDataType, nBlockXSize, sParams,
+                                      panHistogram );
+        const CPLErr eErr = GDALSweepBlocks( this, nBlocksPerRow,
+                GDALGetSampledBlocks( nBlocksPerRow * nBlocksPerColumn,
+                                      nSampleRate ),
+                false, &oTask, "Compute Histogram", pfnProgress, pProgressData );
+        if( eErr != CE_None )
+            return eErr;
     }
 
     pfnProgress( 1.0, "Compute Histogram", pProgressData );
@@ -3357,6 +4926,11 @@ CPLErr CPL_STDCALL GDALGetDefaultHistogramEx( GDALRasterBandH hBand,
  * Many drivers just ignore the AdviseRead() call, but it can dramatically
  * accelerate access via some drivers.
  *
+ * When the GDAL_PREFETCH_NUM_THREADS configuration option is set, the
+ * default implementation schedules the reading of the blocks of a full
+ * resolution region in background threads, up to GDAL_PREFETCH_MAX_BYTES
+ * of blocks waiting to be read (a quarter of the block cache by default).
+ *
  * @param nXOff The pixel offset to the top left corner of the region
  * of the band to be accessed.  This would be zero to start from the left side.
  *
@@ -3385,11 +4959,17 @@ CPLErr CPL_STDCALL GDALGetDefaultHistogramEx( GDALRasterBandH hBand,
  */
 
 CPLErr GDALRasterBand::AdviseRead(
-    CPL_UNUSED int nXOff, CPL_UNUSED int nYOff,
-    CPL_UNUSED int nXSize, CPL_UNUSED int nYSize,
-    CPL_UNUSED int nBufXSize, CPL_UNUSED int nBufYSize,
+    int nXOff, int nYOff, int nXSize, int nYSize,
+    int nBufXSize, int nBufYSize,
     CPL_UNUSED GDALDataType eBufType, CPL_UNUSED char **papszOptions )
 {
+    // Only full resolution requests are known to read the blocks of the
+    // band, the other ones might be served by overviews.
+    if( nXSize == nBufXSize && nYSize == nBufYSize )
+    {
+        GDALBlockPrefetcher::PrefetchWindow( this, nXOff, nYOff,
+                                             nXSize, nYSize );
+    }
     return CE_None;
 }
 
@@ -3471,7 +5051,9 @@ CPLErr GDALRasterBand::GetStatistics( int bApproxOK, int bForce,
 /* -------------------------------------------------------------------- */
 /*      Do we already have metadata items for the requested values?     */
 /* -------------------------------------------------------------------- */
-    if( (pdfMin == NULL || GetMetadataItem("STATISTICS_MINIMUM") != NULL)
+    const char* pszApproximate = GetMetadataItem("STATISTICS_APPROXIMATE");
+    if( (bApproxOK || pszApproximate == NULL || !CPLTestBool(pszApproximate))
+     && (pdfMin == NULL || GetMetadataItem("STATISTICS_MINIMUM") != NULL)
      && (pdfMax == NULL || GetMetadataItem("STATISTICS_MAXIMUM") != NULL)
      && (pdfMean == NULL || GetMetadataItem("STATISTICS_MEAN") != NULL)
      && (pdfStdDev == NULL || GetMetadataItem("STATISTICS_STDDEV") != NULL) )
@@ -3556,6 +5138,13 @@ CPLErr CPL_STDCALL GDALGetRasterStatistics(
  * Once computed, the statistics will generally be "set" back on the
  * raster band using SetStatistics().
  *
+ * Nodata values, and pixels masked out by a per-dataset mask or by an alpha
+ * band (see GetMaskFlags()), are ignored.
+ *
+ * The blocks can be processed by several threads, by setting the
+ * GDAL_NUM_THREADS configuration option to a number of threads or ALL_CPUS.
+ * The result does not depend on the number of threads.
+ *
  * This method is the same as the C function GDALComputeRasterStatistics().
  *
  * @param bApproxOK If TRUE statistics may be computed based on overviews
@@ -3607,16 +5196,6 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
 /* -------------------------------------------------------------------- */
 /*      Read actual data and compute statistics.                        */
 /* -------------------------------------------------------------------- */
-    double      dfMin = 0.0, dfMax = 0.0;
-    bool bFirstValue = true;
-    /* Using Welford algorithm ( http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance ) */
-    /* to compute standard deviation in a more numerically robust way than */
-    /* the difference of the sum of square values with the square of the sum */
-    /* dfMean and dfM2 are updated at each sample */
-    /* dfM2 is the sum of square of differences to the current mean */
-    double      dfMean = 0.0, dfM2 = 0.0;
-    GIntBig     nSampleCount = 0;
-
     GDALRasterIOExtraArg sExtraArg;
     INIT_RASTERIO_EXTRA_ARG(sExtraArg);
 
@@ -3633,6 +5212,13 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
     const char* pszPixelType = GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
     int bSignedByte = (pszPixelType != NULL && EQUAL(pszPixelType, "SIGNEDBYTE"));
 
+    /* The mean and the sum of squares of differences to the mean (M2) of */
+    /* each block are combined with the formula of Chan et al. */
+    /* ( http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance ) */
+    /* which is numerically more robust than the difference of the sum of */
+    /* square values with the square of the sum */
+    GDALStatsAccum sStats;
+
     if ( bApproxOK && HasArbitraryOverviews() )
     {
 /* -------------------------------------------------------------------- */
@@ -3672,86 +5258,24 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
             return eErr;
         }
 
-        /* this isn't the fastest way to do this, but is easier for now */
-        for( int iY = 0; iY < nYReduced; iY++ )
+        std::vector<GByte> abyMask;
+        eErr = GDALReadReducedMask( this, nXReduced, nYReduced, abyMask );
+        if ( eErr != CE_None )
         {
-            for( int iX = 0; iX < nXReduced; iX++ )
-            {
-                int    iOffset = iX + iY * nXReduced;
-                double dfValue = 0.0;
-
-                switch( eDataType )
-                {
-                  case GDT_Byte:
-                  {
-                    if (bSignedByte)
-                        dfValue = ((signed char *)pData)[iOffset];
-                    else
-                        dfValue = ((GByte *)pData)[iOffset];
-                    break;
-                  }
-                  case GDT_UInt16:
-                    dfValue = ((GUInt16 *)pData)[iOffset];
-                    break;
-                  case GDT_Int16:
-                    dfValue = ((GInt16 *)pData)[iOffset];
-                    break;
-                  case GDT_UInt32:
-                    dfValue = ((GUInt32 *)pData)[iOffset];
-                    break;
-                  case GDT_Int32:
-                    dfValue = ((GInt32 *)pData)[iOffset];
-                    break;
-                  case GDT_Float32:
-                    dfValue = ((float *)pData)[iOffset];
-                    if (CPLIsNan(dfValue))
-                        continue;
-                    break;
-                  case GDT_Float64:
-                    dfValue = ((double *)pData)[iOffset];
-                    if (CPLIsNan(dfValue))
-                        continue;
-                    break;
-                  case GDT_CInt16:
-                    dfValue = ((GInt16 *)pData)[iOffset*2];
-                    break;
-                  case GDT_CInt32:
-                    dfValue = ((GInt32 *)pData)[iOffset*2];
-                    break;
-                  case GDT_CFloat32:
-                    dfValue = ((float *)pData)[iOffset*2];
-                    if( CPLIsNan(dfValue) )
-                        continue;
-                    break;
-                  case GDT_CFloat64:
-                    dfValue = ((double *)pData)[iOffset*2];
-                    if( CPLIsNan(dfValue) )
-                        continue;
-                    break;
-                  default:
-                    CPLAssert( FALSE );
-                }
-
-                if( bGotNoDataValue && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
-                    continue;
-
-                if( bFirstValue )
-                {
-                    dfMin = dfMax = dfValue;
-                    bFirstValue = false;
-                }
-                else
-                {
-                    dfMin = MIN(dfMin,dfValue);
-                    dfMax = MAX(dfMax,dfValue);
-                }
-
-                nSampleCount++;
-                double dfDelta = dfValue - dfMean;
-                dfMean += dfDelta / nSampleCount;
-                dfM2 += dfDelta * (dfValue - dfMean);
-            }
+            CPLFree(pData);
+            return eErr;
         }
+        GDALDataType eReducedDataType = eDataType;
+        bool bReducedSignedByte = CPL_TO_BOOL(bSignedByte);
+        std::vector<double> adfMasked;
+        const void* pReduced = abyMask.empty() ? pData :
+            GDALMaskBlock( adfMasked, pData, &abyMask[0], eReducedDataType,
+                           bReducedSignedByte, nXReduced, nXReduced, nYReduced );
+
+        GDALComputeBlockStats( pReduced, eReducedDataType, bReducedSignedByte,
+                               nXReduced, nYReduced, nXReduced,
+                               CPL_TO_BOOL(bGotNoDataValue), dfNoDataValue,
+                               true, sStats );
 
         CPLFree( pData );
     }
@@ -3769,134 +5293,26 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
         if ( bApproxOK )
         {
             nSampleRate =
-                (int)MAX( 1, sqrt((double)nBlocksPerRow * nBlocksPerColumn) );
-            // We want to avoid probing only the first column of blocks for
-            // a square shaped raster, because it is not unlikely that it may
-            // be padding only (#6378)
-            if( nSampleRate == nBlocksPerRow && nBlocksPerRow > 1 )
-              nSampleRate += 1;
-        }
-        else
-            nSampleRate = 1;
-
-        for( int iSampleBlock = 0;
-             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-             iSampleBlock += nSampleRate )
-        {
-            int  iXBlock, iYBlock, nXCheck, nYCheck;
-            GDALRasterBlock *poBlock;
-            void* pData;
-
-            iYBlock = iSampleBlock / nBlocksPerRow;
-            iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-            poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-            if( poBlock == NULL )
-                continue;
-
-            pData = poBlock->GetDataRef();
-
-            if( (iXBlock+1) * nBlockXSize > GetXSize() )
-                nXCheck = GetXSize() - iXBlock * nBlockXSize;
-            else
-                nXCheck = nBlockXSize;
-
-            if( (iYBlock+1) * nBlockYSize > GetYSize() )
-                nYCheck = GetYSize() - iYBlock * nBlockYSize;
-            else
-                nYCheck = nBlockYSize;
-
-            /* this isn't the fastest way to do this, but is easier for now */
-            for( int iY = 0; iY < nYCheck; iY++ )
-            {
-                for( int iX = 0; iX < nXCheck; iX++ )
-                {
-                    int    iOffset = iX + iY * nBlockXSize;
-                    double dfValue = 0.0;
-
-                    switch( eDataType )
-                    {
-                      case GDT_Byte:
-                      {
-                        if (bSignedByte)
-                            dfValue = ((signed char *)pData)[iOffset];
-                        else
-                            dfValue = ((GByte *)pData)[iOffset];
-                        break;
-                      }
-                      case GDT_UInt16:
-                        dfValue = ((GUInt16 *)pData)[iOffset];
-                        break;
-                      case GDT_Int16:
-                        dfValue = ((GInt16 *)pData)[iOffset];
-                        break;
-                      case GDT_UInt32:
-                        dfValue = ((GUInt32 *)pData)[iOffset];
-                        break;
-                      case GDT_Int32:
-                        dfValue = ((GInt32 *)pData)[iOffset];
-                        break;
-                      case GDT_Float32:
-                        dfValue = ((float *)pData)[iOffset];
-                        if (CPLIsNan(dfValue))
-                            continue;
-                        break;
-                      case GDT_Float64:
-                        dfValue = ((double *)pData)[iOffset];
-                        if (CPLIsNan(dfValue))
-                            continue;
-                        break;
-                      case GDT_CInt16:
-                        dfValue = ((GInt16 *)pData)[iOffset*2];
-                        break;
-                      case GDT_CInt32:
-                        dfValue = ((GInt32 *)pData)[iOffset*2];
-                        break;
-                      case GDT_CFloat32:
-                        dfValue = ((float *)pData)[iOffset*2];
-                        if( CPLIsNan(dfValue) )
-                            continue;
-                        break;
-                      case GDT_CFloat64:
-                        dfValue = ((double *)pData)[iOffset*2];
-                        if( CPLIsNan(dfValue) )
-                            continue;
-                        break;
-                      default:
-                        CPLAssert( FALSE );
-                    }
-
-                    if( bGotNoDataValue && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
-                        continue;
-
-                    if( bFirstValue )
-                    {
-                        dfMin = dfMax = dfValue;
-                        bFirstValue = false;
-                    }
-                    else
-                    {
-                        dfMin = MIN(dfMin,dfValue);
-                        dfMax = MAX(dfMax,dfValue);
-                    }
-
-                    nSampleCount++;
-                    double dfDelta = dfValue - dfMean;
-                    dfMean += dfDelta / nSampleCount;
-                    dfM2 += dfDelta * (dfValue - dfMean);
-                }
-            }
-
-            poBlock->DropLock();
-
-            if ( !pfnProgress(iSampleBlock
-                              / ((double)(nBlocksPerRow*nBlocksPerColumn)),
-                              "Compute Statistics", pProgressData) )
-            {
-                ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-                return CE_Failure;
-            }
+                (int)MAX( 1, sqrt((double)nBlocksPerRow * nBlocksPerColumn) );
+            // We want to avoid probing only the first column of blocks for
+            // a square shaped raster, because it is not unlikely that it may
+            // be padding only (#6378)
+            if( nSampleRate == nBlocksPerRow && nBlocksPerRow > 1 )
+              nSampleRate += 1;
         }
+        else
+            nSampleRate = 1;
+
+        GDALStatsSweepTask oTask( eDataType, CPL_TO_BOOL(bSignedByte),
+                                  nBlockXSize, CPL_TO_BOOL(bGotNoDataValue),
+                                  dfNoDataValue, true );
+        const CPLErr eErr = GDALSweepBlocks( this, nBlocksPerRow,
+                GDALGetSampledBlocks( nBlocksPerRow * nBlocksPerColumn,
+                                      nSampleRate ),
+                true, &oTask, "Compute Statistics", pfnProgress, pProgressData );
+        if( eErr != CE_None )
+            return eErr;
+        sStats = oTask.GetResult();
     }
 
     if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
@@ -3905,14 +5321,25 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
         return CE_Failure;
     }
 
+    const GIntBig nSampleCount = static_cast<GIntBig>(sStats.nCount);
+    const double dfMin = sStats.dfMin;
+    const double dfMax = sStats.dfMax;
+    const double dfMean = sStats.dfMean;
+    const double dfM2 = sStats.dfM2;
+
 /* -------------------------------------------------------------------- */
 /*      Save computed information.                                      */
 /* -------------------------------------------------------------------- */
     const double dfStdDev = (nSampleCount > 0) ? sqrt(dfM2 / nSampleCount) : 0.0;
 
     if( nSampleCount > 0 )
+    {
         SetStatistics( dfMin, dfMax, dfMean, dfStdDev );
 
+        /* Replace statistics set by ComputeSampledStatistics() */
+        GDALClearSampledStatistics( this, !bApproxOK );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Record results.                                                 */
 /* -------------------------------------------------------------------- */
@@ -4042,11 +5469,16 @@ CPLErr CPL_STDCALL GDALSetRasterStatistics(
  * If approximate is OK, then the band's GetMinimum()/GetMaximum() will
  * be trusted.  If it doesn't work, a subsample of blocks will be read to
  * get an approximate min/max.  If the band has a nodata value it will
- * be excluded from the minimum and maximum.
+ * be excluded from the minimum and maximum, as well as pixels masked out by
+ * a per-dataset mask or by an alpha band (see GetMaskFlags()).
  *
  * If bApprox is FALSE, then all pixels will be read and used to compute
  * an exact range.
  *
+ * The blocks can be processed by several threads, by setting the
+ * GDAL_NUM_THREADS configuration option to a number of threads or ALL_CPUS.
+ * The result does not depend on the number of threads.
+ *
  * This method is the same as the C function GDALComputeRasterMinMax().
  *
  * @param bApproxOK TRUE if an approximate (faster) answer is OK, otherwise
@@ -4098,7 +5530,6 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
 /*      Read actual data and compute minimum and maximum.               */
 /* -------------------------------------------------------------------- */
     int bGotNoDataValue;
-    bool bFirstValue = true;
 
     const double dfNoDataValue = GetNoDataValue( &bGotNoDataValue );
     bGotNoDataValue = bGotNoDataValue && !CPLIsNan(dfNoDataValue);
@@ -4109,6 +5540,8 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
     GDALRasterIOExtraArg sExtraArg;
     INIT_RASTERIO_EXTRA_ARG(sExtraArg);
 
+    GDALStatsAccum sStats;
+
     if ( bApproxOK && HasArbitraryOverviews() )
     {
 /* -------------------------------------------------------------------- */
@@ -4148,81 +5581,24 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
             return eErr;
         }
 
-        /* this isn't the fastest way to do this, but is easier for now */
-        for( int iY = 0; iY < nYReduced; iY++ )
+        std::vector<GByte> abyMask;
+        eErr = GDALReadReducedMask( this, nXReduced, nYReduced, abyMask );
+        if ( eErr != CE_None )
         {
-            for( int iX = 0; iX < nXReduced; iX++ )
-            {
-                int    iOffset = iX + iY * nXReduced;
-                double dfValue = 0.0;
-
-                switch( eDataType )
-                {
-                  case GDT_Byte:
-                  {
-                    if (bSignedByte)
-                        dfValue = ((signed char *)pData)[iOffset];
-                    else
-                        dfValue = ((GByte *)pData)[iOffset];
-                    break;
-                  }
-                  case GDT_UInt16:
-                    dfValue = ((GUInt16 *)pData)[iOffset];
-                    break;
-                  case GDT_Int16:
-                    dfValue = ((GInt16 *)pData)[iOffset];
-                    break;
-                  case GDT_UInt32:
-                    dfValue = ((GUInt32 *)pData)[iOffset];
-                    break;
-                  case GDT_Int32:
-                    dfValue = ((GInt32 *)pData)[iOffset];
-                    break;
-                  case GDT_Float32:
-                    dfValue = ((float *)pData)[iOffset];
-                    if (CPLIsNan(dfValue))
-                        continue;
-                    break;
-                  case GDT_Float64:
-                    dfValue = ((double *)pData)[iOffset];
-                    if (CPLIsNan(dfValue))
-                        continue;
-                    break;
-                  case GDT_CInt16:
-                    dfValue = ((GInt16 *)pData)[iOffset*2];
-                    break;
-                  case GDT_CInt32:
-                    dfValue = ((GInt32 *)pData)[iOffset*2];
-                    break;
-                  case GDT_CFloat32:
-                    dfValue = ((float *)pData)[iOffset*2];
-                    if( CPLIsNan(dfValue) )
-                        continue;
-                    break;
-                  case GDT_CFloat64:
-                    dfValue = ((double *)pData)[iOffset*2];
-                    if( CPLIsNan(dfValue) )
-                        continue;
-                    break;
-                  default:
-                    CPLAssert( FALSE );
-                }
-
-                if( bGotNoDataValue && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
-                    continue;
-
-                if( bFirstValue )
-                {
-                    dfMin = dfMax = dfValue;
-                    bFirstValue = false;
-                }
-                else
-                {
-                    dfMin = MIN(dfMin,dfValue);
-                    dfMax = MAX(dfMax,dfValue);
-                }
-            }
+            CPLFree(pData);
+            return eErr;
         }
+        GDALDataType eReducedDataType = eDataType;
+        bool bReducedSignedByte = CPL_TO_BOOL(bSignedByte);
+        std::vector<double> adfMasked;
+        const void* pReduced = abyMask.empty() ? pData :
+            GDALMaskBlock( adfMasked, pData, &abyMask[0], eReducedDataType,
+                           bReducedSignedByte, nXReduced, nXReduced, nYReduced );
+
+        GDALComputeBlockStats( pReduced, eReducedDataType, bReducedSignedByte,
+                               nXReduced, nYReduced, nXReduced,
+                               CPL_TO_BOOL(bGotNoDataValue), dfNoDataValue,
+                               false, sStats );
 
         CPLFree( pData );
     }
@@ -4251,114 +5627,25 @@ CPLErr GDALRasterBand::ComputeRasterMinMax( int bApproxOK,
         else
             nSampleRate = 1;
 
-        for( int iSampleBlock = 0;
-             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-             iSampleBlock += nSampleRate )
-        {
-            int iYBlock = iSampleBlock / nBlocksPerRow;
-            int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-            GDALRasterBlock *poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-            if( poBlock == NULL )
-                continue;
-
-            void *pData = poBlock->GetDataRef();
-
-            int nXCheck, nYCheck;
-            if( (iXBlock+1) * nBlockXSize > GetXSize() )
-                nXCheck = GetXSize() - iXBlock * nBlockXSize;
-            else
-                nXCheck = nBlockXSize;
-
-            if( (iYBlock+1) * nBlockYSize > GetYSize() )
-                nYCheck = GetYSize() - iYBlock * nBlockYSize;
-            else
-                nYCheck = nBlockYSize;
-
-            /* this isn't the fastest way to do this, but is easier for now */
-            for( int iY = 0; iY < nYCheck; iY++ )
-            {
-                for( int iX = 0; iX < nXCheck; iX++ )
-                {
-                    int    iOffset = iX + iY * nBlockXSize;
-                    double dfValue = 0.0;
-
-                    switch( eDataType )
-                    {
-                      case GDT_Byte:
-                      {
-                        if (bSignedByte)
-                            dfValue = ((signed char *) pData)[iOffset];
-                        else
-                            dfValue = ((GByte *) pData)[iOffset];
-                        break;
-                      }
-                      case GDT_UInt16:
-                        dfValue = ((GUInt16 *) pData)[iOffset];
-                        break;
-                      case GDT_Int16:
-                        dfValue = ((GInt16 *) pData)[iOffset];
-                        break;
-                      case GDT_UInt32:
-                        dfValue = ((GUInt32 *) pData)[iOffset];
-                        break;
-                      case GDT_Int32:
-                        dfValue = ((GInt32 *) pData)[iOffset];
-                        break;
-                      case GDT_Float32:
-                        dfValue = ((float *) pData)[iOffset];
-                        if( CPLIsNan(dfValue) )
-                            continue;
-                        break;
-                      case GDT_Float64:
-                        dfValue = ((double *) pData)[iOffset];
-                        if( CPLIsNan(dfValue) )
-                            continue;
-                        break;
-                      case GDT_CInt16:
-                        dfValue = ((GInt16 *) pData)[iOffset*2];
-                        break;
-                      case GDT_CInt32:
-                        dfValue = ((GInt32 *) pData)[iOffset*2];
-                        break;
-                      case GDT_CFloat32:
-                        dfValue = ((float *) pData)[iOffset*2];
-                        if( CPLIsNan(dfValue) )
-                            continue;
-                        break;
-                      case GDT_CFloat64:
-                        dfValue = ((double *) pData)[iOffset*2];
-                        if( CPLIsNan(dfValue) )
-                            continue;
-                        break;
-                      default:
-                        CPLAssert( FALSE );
-                    }
-
-                    if( bGotNoDataValue && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
-                        continue;
-
-                    if( bFirstValue )
-                    {
-                        dfMin = dfMax = dfValue;
-                        bFirstValue = false;
-                    }
-                    else
-                    {
-                        dfMin = MIN(dfMin,dfValue);
-                        dfMax = MAX(dfMax,dfValue);
-                    }
-                }
-            }
-
-            poBlock->DropLock();
-        }
+        GDALStatsSweepTask oTask( eDataType, CPL_TO_BOOL(bSignedByte),
+                                  nBlockXSize, CPL_TO_BOOL(bGotNoDataValue),
+                                  dfNoDataValue, false );
+        const CPLErr eErr = GDALSweepBlocks( this, nBlocksPerRow,
+                GDALGetSampledBlocks( nBlocksPerRow * nBlocksPerColumn,
+                                      nSampleRate ),
+                true, &oTask, "Compute Min/Max", GDALDummyProgress, NULL );
+        if( eErr != CE_None )
+            return eErr;
+        sStats = oTask.GetResult();
     }
 
+    dfMin = sStats.dfMin;
+    dfMax = sStats.dfMax;
+
     adfMinMax[0] = dfMin;
     adfMinMax[1] = dfMax;
 
-    if (bFirstValue)
+    if( sStats.nCount == 0 )
     {
         ReportError( CE_Failure, CPLE_AppDefined,
             "Failed to compute min/max, no valid pixels found in sampling." );
@@ -4391,6 +5678,319 @@ GDALComputeRasterMinMax( GDALRasterBandH hBand, int bApproxOK,
     poBand->ComputeRasterMinMax( bApproxOK, adfMinMax );
 }
 
+/************************************************************************/
+/*                      ComputeSampledStatistics()                      */
+/************************************************************************/
+
+/**
+ * \brief Compute approximate image statistics with error bounds.
+ *
+ * Computes the minimum, maximum, mean and standard deviation of the pixel
+ * values of a random sample of blocks, with about nTargetSampleCount pixels.
+ * Unlike the bApproxOK mode of ComputeStatistics(), the blocks are picked at
+ * random (with a fixed seed, so that results are reproducible), which allows
+ * to estimate the sampling error: the half-widths of the 95% confidence
+ * intervals of the mean and of the standard deviation are returned in
+ * pdfMeanError and pdfStdDevError. They are 0 when all blocks are read.
+ * The minimum and maximum are those of the sample.
+ *
+ * The statistics are set back on the raster band with SetStatistics(),
+ * along with the STATISTICS_MEAN_ERROR and STATISTICS_STDDEV_ERROR metadata
+ * items, and with STATISTICS_APPROXIMATE=YES if some blocks were not read,
+ * in which case GetStatistics() does not return them when bApproxOK is FALSE.
+ * ComputeStatistics() removes those items. A quantile sketch of the sampled values is
+ * also stored in the KLL metadata item of the STATISTICS_SKETCH domain, from
+ * which GetApproxQuantiles() answers. Formats using PAM save them in the
+ * .aux.xml file.
+ *
+ * The blocks can be processed by several threads, by setting the
+ * GDAL_NUM_THREADS configuration option to a number of threads or ALL_CPUS.
+ *
+ * This method is the same as the C function
+ * GDALComputeRasterSampledStatistics().
+ *
+ * @param nTargetSampleCount number of pixels to sample, or 0 for the default
+ * of 1,000,000. At least two blocks are read.
+ *
+ * @param pdfMin Location into which to load the minimum (may be NULL).
+ *
+ * @param pdfMax Location into which to load the maximum (may be NULL).
+ *
+ * @param pdfMean Location into which to load the mean (may be NULL).
+ *
+ * @param pdfStdDev Location into which to load the standard deviation
+ * (may be NULL).
+ *
+ * @param pdfMeanError Location into which to load the half-width of the 95%
+ * confidence interval of the mean (may be NULL).
+ *
+ * @param pdfStdDevError Location into which to load the half-width of the
+ * 95% confidence interval of the standard deviation (may be NULL).
+ *
+ * @param pfnProgress a function to call to report progress, or NULL.
+ *
+ * @param pProgressData application data to pass to the progress function.
+ *
+ * @return CE_None on success, or CE_Failure if an error occurs or processing
+ * is terminated by the user.
+ *
+ * @since GDAL 2.2
+ */
+
+CPLErr
+GDALRasterBand::ComputeSampledStatistics( GIntBig nTargetSampleCount,
+                                          double *pdfMin, double *pdfMax,
+                                          double *pdfMean, double *pdfStdDev,
+                                          double *pdfMeanError,
+                                          double *pdfStdDevError,
+                                          GDALProgressFunc pfnProgress,
+                                          void *pProgressData )
+
+{
+    if( pfnProgress == NULL )
+        pfnProgress = GDALDummyProgress;
+    if( nTargetSampleCount <= 0 )
+        nTargetSampleCount = GDALSTAT_SAMPLED_NUMSAMPLES;
+
+    if( !InitBlockInfo() )
+        return CE_Failure;
+
+    if( !pfnProgress( 0.0, "Compute Statistics", pProgressData ) )
+    {
+        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
+
+    int bGotNoDataValue;
+    const double dfNoDataValue = GetNoDataValue( &bGotNoDataValue );
+    bGotNoDataValue = bGotNoDataValue && !CPLIsNan(dfNoDataValue);
+
+    const char* pszPixelType = GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+    const bool bSignedByte =
+        pszPixelType != NULL && EQUAL(pszPixelType, "SIGNEDBYTE");
+
+/* -------------------------------------------------------------------- */
+/*      Pick enough blocks to reach the target number of pixels. At     */
+/*      least two are needed to estimate the sampling error.            */
+/* -------------------------------------------------------------------- */
+    const int nTotalBlocks = nBlocksPerRow * nBlocksPerColumn;
+    const double dfBlocks = ceil( static_cast<double>(nTargetSampleCount) /
+                    (static_cast<double>(nBlockXSize) * nBlockYSize) );
+    const int nSampledBlocks = static_cast<int>(
+        MIN( static_cast<double>(nTotalBlocks), MAX( 2.0, dfBlocks ) ) );
+
+    GDALSampledStatsSweepTask oTask( eDataType, bSignedByte, nBlockXSize,
+                                     CPL_TO_BOOL(bGotNoDataValue),
+                                     dfNoDataValue, nSampledBlocks );
+    const CPLErr eErr = GDALSweepBlocks( this, nBlocksPerRow,
+                GDALGetRandomBlocks( nTotalBlocks, nSampledBlocks ),
+                true, &oTask, "Compute Statistics", pfnProgress, pProgressData );
+    if( eErr != CE_None )
+        return eErr;
+
+    if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
+    {
+        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Combine the statistics of the blocks.                           */
+/* -------------------------------------------------------------------- */
+    const std::vector<GDALStatsAccum>& asBlocks = oTask.GetBlockStats();
+    GDALStatsAccum sStats;
+    for( size_t i = 0; i < asBlocks.size(); i++ )
+        sStats.Merge( asBlocks[i] );
+
+    if( sStats.nCount == 0 )
+    {
+        ReportError( CE_Failure, CPLE_AppDefined,
+        "Failed to compute statistics, no valid pixels found in sampling." );
+        return CE_Failure;
+    }
+
+    const double dfStdDev = sqrt( sStats.dfM2 / sStats.nCount );
+    double dfMeanError, dfStdDevError;
+    GDALComputeSamplingErrors( asBlocks, sStats,
+                               static_cast<double>(nSampledBlocks) / nTotalBlocks,
+                               &dfMeanError, &dfStdDevError );
+
+/* -------------------------------------------------------------------- */
+/*      Save computed information.                                      */
+/* -------------------------------------------------------------------- */
+    SetStatistics( sStats.dfMin, sStats.dfMax, sStats.dfMean, dfStdDev );
+
+    char szValue[128] = { 0 };
+    SetMetadataItem( "STATISTICS_APPROXIMATE",
+                     nSampledBlocks < nTotalBlocks ? "YES" : NULL );
+
+    CPLsnprintf( szValue, sizeof(szValue), "%.14g", dfMeanError );
+    SetMetadataItem( "STATISTICS_MEAN_ERROR", szValue );
+
+    CPLsnprintf( szValue, sizeof(szValue), "%.14g", dfStdDevError );
+    SetMetadataItem( "STATISTICS_STDDEV_ERROR", szValue );
+
+    SetMetadataItem( "KLL", oTask.GetSketch().Serialize(), "STATISTICS_SKETCH" );
+
+/* -------------------------------------------------------------------- */
+/*      Record results.                                                 */
+/* -------------------------------------------------------------------- */
+    if( pdfMin != NULL )
+        *pdfMin = sStats.dfMin;
+    if( pdfMax != NULL )
+        *pdfMax = sStats.dfMax;
+    if( pdfMean != NULL )
+        *pdfMean = sStats.dfMean;
+    if( pdfStdDev != NULL )
+        *pdfStdDev = dfStdDev;
+    if( pdfMeanError != NULL )
+        *pdfMeanError = dfMeanError;
+    if( pdfStdDevError != NULL )
+        *pdfStdDevError = dfStdDevError;
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                 GDALComputeRasterSampledStatistics()                 */
+/************************************************************************/
+
+/**
+  * \brief Compute approximate image statistics with error bounds.
+  *
+  * @see GDALRasterBand::ComputeSampledStatistics()
+  *
+  * @since GDAL 2.2
+  */
+
+CPLErr CPL_STDCALL GDALComputeRasterSampledStatistics(
+        GDALRasterBandH hBand, GIntBig nTargetSampleCount,
+        double *pdfMin, double *pdfMax, double *pdfMean, double *pdfStdDev,
+        double *pdfMeanError, double *pdfStdDevError,
+        GDALProgressFunc pfnProgress, void *pProgressData )
+
+{
+    VALIDATE_POINTER1( hBand, "GDALComputeRasterSampledStatistics",
+                       CE_Failure );
+
+    GDALRasterBand *poBand = static_cast<GDALRasterBand*>(hBand);
+
+    return poBand->ComputeSampledStatistics(
+        nTargetSampleCount, pdfMin, pdfMax, pdfMean, pdfStdDev,
+        pdfMeanError, pdfStdDevError, pfnProgress, pProgressData );
+}
+
+/************************************************************************/
+/*                         GetApproxQuantiles()                         */
+/************************************************************************/
+
+/**
+ * \brief Fetch approximate quantiles of the pixel values.
+ *
+ * The quantiles are answered from the sketch stored by
+ * ComputeSampledStatistics() in the STATISTICS_SKETCH metadata domain.
+ * Their rank error is in the order of 1%, on top of the sampling error.
+ *
+ * If bForce is FALSE and no sketch is available, the method will return
+ * CE_Warning without issuing a warning. If bForce is TRUE,
+ * ComputeSampledStatistics() is run with its default sample size.
+ *
+ * This method is the same as the C function GDALGetRasterApproxQuantiles().
+ *
+ * @param nQuantiles number of quantiles.
+ *
+ * @param padfProbabilities array of nQuantiles probabilities between 0 and 1,
+ * e.g. 0.5 for the median.
+ *
+ * @param padfQuantiles array of nQuantiles values into which to load the
+ * quantiles.
+ *
+ * @param bForce If FALSE, quantiles will only be returned if they can be
+ * without scanning the image.
+ *
+ * @param pfnProgress a function to call to report progress, or NULL.
+ *
+ * @param pProgressData application data to pass to the progress function.
+ *
+ * @return CE_None on success, CE_Warning if no values returned,
+ * CE_Failure if an error occurs.
+ *
+ * @since GDAL 2.2
+ */
+
+CPLErr GDALRasterBand::GetApproxQuantiles( int nQuantiles,
+                                           const double *padfProbabilities,
+                                           double *padfQuantiles,
+                                           int bForce,
+                                           GDALProgressFunc pfnProgress,
+                                           void *pProgressData )
+
+{
+    for( int i = 0; i < nQuantiles; i++ )
+    {
+        if( !(padfProbabilities[i] >= 0.0 && padfProbabilities[i] <= 1.0) )
+        {
+            ReportError( CE_Failure, CPLE_IllegalArg,
+                         "Invalid probability: %g", padfProbabilities[i] );
+            return CE_Failure;
+        }
+    }
+
+    const char* pszSketch = GetMetadataItem( "KLL", "STATISTICS_SKETCH" );
+    if( pszSketch == NULL )
+    {
+        if( !bForce )
+            return CE_Warning;
+
+        const CPLErr eErr = ComputeSampledStatistics( 0, NULL, NULL, NULL, NULL,
+                                                      NULL, NULL,
+                                                      pfnProgress,
+                                                      pProgressData );
+        if( eErr != CE_None )
+            return eErr;
+
+        pszSketch = GetMetadataItem( "KLL", "STATISTICS_SKETCH" );
+        if( pszSketch == NULL )
+            return CE_Failure;
+    }
+
+    GDALQuantileSketch oSketch;
+    if( !oSketch.Deserialize( pszSketch ) )
+        return CE_Failure;
+
+    for( int i = 0; i < nQuantiles; i++ )
+        padfQuantiles[i] = oSketch.GetQuantile( padfProbabilities[i] );
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                    GDALGetRasterApproxQuantiles()                    */
+/************************************************************************/
+
+/**
+  * \brief Fetch approximate quantiles of the pixel values.
+  *
+  * @see GDALRasterBand::GetApproxQuantiles()
+  *
+  * @since GDAL 2.2
+  */
+
+CPLErr CPL_STDCALL GDALGetRasterApproxQuantiles(
+        GDALRasterBandH hBand, int nQuantiles,
+        const double *padfProbabilities, double *padfQuantiles, int bForce,
+        GDALProgressFunc pfnProgress, void *pProgressData )
+
+{
+    VALIDATE_POINTER1( hBand, "GDALGetRasterApproxQuantiles", CE_Failure );
+
+    GDALRasterBand *poBand = static_cast<GDALRasterBand*>(hBand);
+
+    return poBand->GetApproxQuantiles( nQuantiles, padfProbabilities,
+                                       padfQuantiles, bForce,
+                                       pfnProgress, pProgressData );
+}
+
 /************************************************************************/
 /*                        SetDefaultHistogram()                         */
 /************************************************************************/
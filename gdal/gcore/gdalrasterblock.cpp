@@ -31,26 +31,627 @@
 
 #include "gdal_priv.h"
 #include "cpl_multiproc.h"
+#include "cpl_virtualmem.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include <algorithm>
+#include <deque>
+#include <map>
 
 CPL_CVSID("$Id$");
 
+//#define ENABLE_DEBUG
+
 static bool bCacheMaxInitialized = false;
 static GIntBig nCacheMax = 40 * 1024*1024; /* Will later be overridden by the default 5% if GDAL_CACHEMAX not defined */
-static volatile GIntBig nCacheUsed = 0;
 
-static GDALRasterBlock *poOldest = NULL;    /* tail */
-static GDALRasterBlock *poNewest = NULL;    /* head */
+/* Upper bound for the GDAL_RB_CACHE_SHARDS configuration option */
+#define GDAL_RB_MAX_SHARDS 256
 
-#if 0
-static CPLMutex *hRBLock = NULL;
-#define INITIALIZE_LOCK         CPLMutexHolderD( &hRBLock )
-#define TAKE_LOCK               CPLMutexHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK            CPLDestroyMutex( hRBLock )
-#else
+/************************************************************************/
+/* ==================================================================== */
+/*                      GDALRasterBlockCachePolicy                      */
+/* ==================================================================== */
+/************************************************************************/
+
+/* -------------------------------------------------------------------- */
+/*      An eviction policy keeps track of the blocks of one cache       */
+/*      shard and decides in which order they are evicted. All its      */
+/*      methods are called with the lock of the shard held.             */
+/*                                                                      */
+/*      The policy links the blocks through their poNext/poPrevious     */
+/*      members, and may store any per-block state in nPolicyState.     */
+/*                                                                      */
+/*      If GDAL_RB_LOCK_FREE_HITS is set to YES, cache hits do not take */
+/*      the lock of the shard to call Touch(), but only set the         */
+/*      bTouchDeferred flag of the block. LockCandidate() applies those */
+/*      deferred touches when it meets such blocks. A block used again  */
+/*      is then only moved when it reaches the eviction end, so the     */
+/*      order of the blocks used again since then is not their order   */
+/*      of use anymore: LRU degrades into a second chance algorithm.    */
+/*                                                                      */
+/*      This mode is off by default, since it changes the eviction      */
+/*      order, and it only removes the lock of the shard: the hashset   */
+/*      band block cache still takes its own lock on lookups. Evicted   */
+/*      blocks are not recycled, nor reclaimed by epochs: as with the   */
+/*      locked path, they go to the free list of their band with        */
+/*      AddBlockToFreeList(), and are deleted by FreeDanglingBlocks()   */
+/*      in the thread using the band. The band block caches only check  */
+/*      that the block referenced is still the one of the slot.         */
+/* -------------------------------------------------------------------- */
+
+class GDALRasterBlockCachePolicy
+{
+  protected:
+    // Doubly linked list helpers. poHead is the most recently inserted
+    // block, and poNext goes from the head towards the tail.
+    static void ListPushFront( GDALRasterBlock*& poHead,
+                               GDALRasterBlock*& poTail,
+                               GDALRasterBlock* poBlock );
+    static void ListRemove( GDALRasterBlock*& poHead,
+                            GDALRasterBlock*& poTail,
+                            GDALRasterBlock* poBlock );
+    static GDALRasterBlock* Next( GDALRasterBlock* poBlock )
+                                            { return poBlock->poNext; }
+    static GDALRasterBlock* Previous( GDALRasterBlock* poBlock )
+                                            { return poBlock->poPrevious; }
+    static void SetNext( GDALRasterBlock* poBlock, GDALRasterBlock* poNext )
+                                            { poBlock->poNext = poNext; }
+    static void SetPrevious( GDALRasterBlock* poBlock, GDALRasterBlock* poPrevious )
+                                            { poBlock->poPrevious = poPrevious; }
+    static int  GetState( const GDALRasterBlock* poBlock )
+                                            { return poBlock->nPolicyState; }
+    static void SetState( GDALRasterBlock* poBlock, int nState )
+                                            { poBlock->nPolicyState = nState; }
+    static GIntBig GetBandCacheId( const GDALRasterBlock* poBlock )
+                                            { return poBlock->GetBandCacheId(); }
+
+  public:
+    virtual ~GDALRasterBlockCachePolicy() {}
+
+    virtual const char* GetName() const = 0;
+
+    /** Called when a block enters the cache. */
+    virtual void Insert( GDALRasterBlock* poBlock ) = 0;
+
+    /** Called when an already cached block is used again. */
+    virtual void Touch( GDALRasterBlock* poBlock ) = 0;
+
+    /** Called when a block leaves the cache. */
+    virtual void Remove( GDALRasterBlock* poBlock ) = 0;
+
+    /** Called just before Remove() when a block is evicted to make room. */
+    virtual void RecordEviction( GDALRasterBlock* /* poBlock */ ) {}
+
+    /** Called for an eviction candidate whose touch has been deferred.
+        Return poBlock if it remains a candidate, or the candidate that
+        follows it otherwise. */
+    virtual GDALRasterBlock* ApplyDeferredTouch( GDALRasterBlock* poBlock )
+    {
+        GDALRasterBlock* poNextCandidate = GetNextCandidate(poBlock);
+        Touch(poBlock);
+        return poNextCandidate;
+    }
+
+    /** Return the preferred eviction candidate. nCapacity is the size in
+        bytes of the cache shard. Locked blocks may be returned, in which case
+        the caller will ask for the next candidate. */
+    virtual GDALRasterBlock* GetFirstCandidate( GIntBig nCapacity ) = 0;
+
+    /** Return the candidate following poBlock, or NULL when all blocks have
+        been proposed. Must be called before poBlock is removed. */
+    virtual GDALRasterBlock* GetNextCandidate( GDALRasterBlock* poBlock ) = 0;
+
+    virtual void Verify() {}
+
+    GDALRasterBlock* LockCandidate( GIntBig nCapacity, int nBlocks,
+                                    int nPriority, bool bDirtyBlocksOnly,
+                                    GDALDataset* poDS );
+};
+
+/************************************************************************/
+/*                            ListPushFront()                           */
+/************************************************************************/
+
+void GDALRasterBlockCachePolicy::ListPushFront( GDALRasterBlock*& poHead,
+                                                GDALRasterBlock*& poTail,
+                                                GDALRasterBlock* poBlock )
+{
+    poBlock->poPrevious = NULL;
+    poBlock->poNext = poHead;
+    if( poHead != NULL )
+    {
+        CPLAssert( poHead->poPrevious == NULL );
+        poHead->poPrevious = poBlock;
+    }
+    poHead = poBlock;
+    if( poTail == NULL )
+        poTail = poBlock;
+}
+
+/************************************************************************/
+/*                              ListRemove()                            */
+/************************************************************************/
+
+void GDALRasterBlockCachePolicy::ListRemove( GDALRasterBlock*& poHead,
+                                             GDALRasterBlock*& poTail,
+                                             GDALRasterBlock* poBlock )
+{
+    if( poTail == poBlock )
+        poTail = poBlock->poPrevious;
+    if( poHead == poBlock )
+        poHead = poBlock->poNext;
+    if( poBlock->poPrevious != NULL )
+        poBlock->poPrevious->poNext = poBlock->poNext;
+    if( poBlock->poNext != NULL )
+        poBlock->poNext->poPrevious = poBlock->poPrevious;
+    poBlock->poPrevious = NULL;
+    poBlock->poNext = NULL;
+}
+
+/************************************************************************/
+/*                            LockCandidate()                           */
+/*                                                                      */
+/*      Return the first candidate, in eviction order, of the priority  */
+/*      class nPriority that can be locked for eviction, optionally     */
+/*      restricted to dirty blocks and to the blocks of poDS.           */
+/*                                                                      */
+/*      Deferred touches are applied to at most nBlocks (the number of  */
+/*      blocks of the shard) candidates, so that readers touching the   */
+/*      blocks again behind our back cannot make us loop forever.       */
+/************************************************************************/
+
+GDALRasterBlock* GDALRasterBlockCachePolicy::LockCandidate(
+    GIntBig nCapacity, int nBlocks, int nPriority, bool bDirtyBlocksOnly,
+    GDALDataset* poDS )
+{
+    int nDeferredTouchesLeft = nBlocks;
+    for( GDALRasterBlock* poBlock = GetFirstCandidate(nCapacity);
+         poBlock != NULL;
+         poBlock = GetNextCandidate(poBlock) )
+    {
+        while( poBlock != NULL && nDeferredTouchesLeft > 0 &&
+               poBlock->bTouchDeferred &&
+               CPLAtomicCompareAndExchange(&(poBlock->bTouchDeferred),
+                                           TRUE, FALSE) )
+        {
+            nDeferredTouchesLeft --;
+            poBlock->UpdateCachePriority_unlocked();
+            GDALRasterBlock* poNextCandidate = ApplyDeferredTouch(poBlock);
+            if( poNextCandidate == poBlock )
+                break;
+            poBlock = poNextCandidate;
+        }
+        if( poBlock == NULL )
+            break;
+        if( poBlock->nCachePriority != nPriority )
+            continue;
+        if( bDirtyBlocksOnly && !poBlock->bDirty )
+            continue;
+        if( poDS != NULL && poBlock->poBand->GetDataset() != poDS )
+            continue;
+        if( CPLAtomicCompareAndExchange(&(poBlock->nLockCount), 0, -1) )
+            return poBlock;
+    }
+    return NULL;
+}
+
+/************************************************************************/
+/*                      GDALRasterBlockLRUPolicy                        */
+/*                                                                      */
+/*      Strict least recently used order. This is the default.          */
+/************************************************************************/
+
+class GDALRasterBlockLRUPolicy CPL_FINAL : public GDALRasterBlockCachePolicy
+{
+    GDALRasterBlock *poNewest;    /* head */
+    GDALRasterBlock *poOldest;    /* tail */
+
+  public:
+    GDALRasterBlockLRUPolicy() : poNewest(NULL), poOldest(NULL) {}
+
+    virtual const char* GetName() const { return "LRU"; }
+
+    virtual void Insert( GDALRasterBlock* poBlock )
+    {
+        ListPushFront(poNewest, poOldest, poBlock);
+    }
+
+    virtual void Touch( GDALRasterBlock* poBlock )
+    {
+        if( poNewest == poBlock )
+            return;
+        ListRemove(poNewest, poOldest, poBlock);
+        ListPushFront(poNewest, poOldest, poBlock);
+    }
+
+    virtual void Remove( GDALRasterBlock* poBlock )
+    {
+        ListRemove(poNewest, poOldest, poBlock);
+    }
+
+    virtual GDALRasterBlock* GetFirstCandidate( GIntBig /* nCapacity */ )
+    {
+        return poOldest;
+    }
+
+    virtual GDALRasterBlock* GetNextCandidate( GDALRasterBlock* poBlock )
+    {
+        return Previous(poBlock);
+    }
+
+#ifdef ENABLE_DEBUG
+    virtual void Verify()
+    {
+        CPLAssert( (poNewest == NULL && poOldest == NULL)
+                || (poNewest != NULL && poOldest != NULL) );
+
+        if( poNewest != NULL )
+        {
+            CPLAssert( Previous(poNewest) == NULL );
+            CPLAssert( Next(poOldest) == NULL );
+
+            GDALRasterBlock* poLast = NULL;
+            for( GDALRasterBlock *poBlock = poNewest;
+                 poBlock != NULL;
+                 poBlock = Next(poBlock) )
+            {
+                CPLAssert( Previous(poBlock) == poLast );
+
+                poLast = poBlock;
+            }
+
+            CPLAssert( poOldest == poLast );
+        }
+    }
+#endif
+};
+
+/************************************************************************/
+/*                     GDALRasterBlockClockPolicy                       */
+/*                                                                      */
+/*      CLOCK (second chance) algorithm. The blocks are kept in a ring  */
+/*      and a hand sweeps over it, skipping (and clearing the reference */
+/*      bit of) the blocks that have been used since the last sweep.    */
+/*      Touch() only sets the reference bit and never relinks blocks.   */
+/************************************************************************/
+
+class GDALRasterBlockClockPolicy CPL_FINAL : public GDALRasterBlockCachePolicy
+{
+    GDALRasterBlock *poHand;
+    int              nCount;
+    int              nStepsLeft;
+
+    GDALRasterBlock* Sweep( GDALRasterBlock* poBlock )
+    {
+        while( nStepsLeft > 0 )
+        {
+            nStepsLeft --;
+            if( GetState(poBlock) == 0 )
+            {
+                poHand = poBlock;
+                return poBlock;
+            }
+            // Second chance
+            SetState(poBlock, 0);
+            poBlock = Next(poBlock);
+        }
+        poHand = poBlock;
+        return NULL;
+    }
+
+  public:
+    GDALRasterBlockClockPolicy() : poHand(NULL), nCount(0), nStepsLeft(0) {}
+
+    virtual const char* GetName() const { return "CLOCK"; }
+
+    virtual void Insert( GDALRasterBlock* poBlock )
+    {
+        // Insert just before the hand, so that the new block is the last one
+        // to be examined by the current sweep.
+        SetState(poBlock, 0);
+        if( poHand == NULL )
+        {
+            SetNext(poBlock, poBlock);
+            SetPrevious(poBlock, poBlock);
+            poHand = poBlock;
+        }
+        else
+        {
+            GDALRasterBlock* poBefore = Previous(poHand);
+            SetNext(poBlock, poHand);
+            SetPrevious(poBlock, poBefore);
+            SetNext(poBefore, poBlock);
+            SetPrevious(poHand, poBlock);
+        }
+        nCount ++;
+    }
+
+    virtual void Touch( GDALRasterBlock* poBlock )
+    {
+        SetState(poBlock, 1);
+    }
+
+    virtual void Remove( GDALRasterBlock* poBlock )
+    {
+        if( Next(poBlock) == poBlock )
+        {
+            CPLAssert( poHand == poBlock );
+            poHand = NULL;
+        }
+        else
+        {
+            if( poHand == poBlock )
+                poHand = Next(poBlock);
+            SetPrevious(Next(poBlock), Previous(poBlock));
+            SetNext(Previous(poBlock), Next(poBlock));
+        }
+        SetNext(poBlock, NULL);
+        SetPrevious(poBlock, NULL);
+        nCount --;
+    }
+
+    virtual GDALRasterBlock* GetFirstCandidate( GIntBig /* nCapacity */ )
+    {
+        if( poHand == NULL )
+            return NULL;
+        // Two revolutions are enough to find an unreferenced block, if any
+        // is not locked.
+        nStepsLeft = 2 * nCount;
+        return Sweep(poHand);
+    }
+
+    virtual GDALRasterBlock* GetNextCandidate( GDALRasterBlock* poBlock )
+    {
+        if( Next(poBlock) == poBlock )
+            return NULL;
+        return Sweep(Next(poBlock));
+    }
+};
+
+/************************************************************************/
+/*                      GDALRasterBlock2QPolicy                         */
+/*                                                                      */
+/*      Scan resistant "2Q" algorithm (T. Johnson and D. Shasha, 1994). */
+/*      Newly cached blocks enter the A1in FIFO queue, and are evicted  */
+/*      from there first as long as A1in holds more than 25% of the     */
+/*      cache. The keys of blocks evicted from A1in are remembered in   */
+/*      the A1out ghost queue. A block that is loaded again while its   */
+/*      key is in A1out enters the Am LRU queue, which holds the blocks */
+/*      that are really reused, and are thus not flushed by one-time    */
+/*      scans of big rasters.                                           */
+/************************************************************************/
+
+class GDALRasterBlock2QPolicy CPL_FINAL : public GDALRasterBlockCachePolicy
+{
+    enum
+    {
+        QUEUE_A1IN = 0,
+        QUEUE_AM = 1
+    };
+
+    // Ghosts identify the band by the id of its block cache rather than by
+    // its address, which may be reused by a band created afterwards.
+    struct GhostKey
+    {
+        GIntBig               nBandCacheId;
+        int                   nXOff;
+        int                   nYOff;
+
+        GhostKey( const GDALRasterBlock* poBlock ) :
+            nBandCacheId(GetBandCacheId(poBlock)),
+            nXOff(poBlock->GetXOff()), nYOff(poBlock->GetYOff()) {}
+
+        bool operator< ( const GhostKey& oOther ) const
+        {
+            if( nBandCacheId != oOther.nBandCacheId )
+                return nBandCacheId < oOther.nBandCacheId;
+            if( nYOff != oOther.nYOff )
+                return nYOff < oOther.nYOff;
+            return nXOff < oOther.nXOff;
+        }
+    };
+
+    GDALRasterBlock *poA1inHead;
+    GDALRasterBlock *poA1inTail;
+    GIntBig          nA1inBytes;
+
+    GDALRasterBlock *poAmHead;
+    GDALRasterBlock *poAmTail;
+
+    // A1out: ghost keys, with the sequence number of their last eviction
+    // so that stale FIFO entries can be recognized.
+    std::map<GhostKey, GUIntBig>                  oMapGhosts;
+    std::deque< std::pair<GhostKey, GUIntBig> >   oGhostFIFO;
+    GUIntBig                                      nGhostSeq;
+    size_t                                        nMaxGhosts;
+
+    bool             bIterOtherQueueVisited;
+
+    GDALRasterBlock* GetTail( int nQueue )
+        { return nQueue == QUEUE_A1IN ? poA1inTail : poAmTail; }
+
+  public:
+    GDALRasterBlock2QPolicy() :
+        poA1inHead(NULL), poA1inTail(NULL), nA1inBytes(0),
+        poAmHead(NULL), poAmTail(NULL), nGhostSeq(0), nMaxGhosts(1024),
+        bIterOtherQueueVisited(false) {}
+
+    virtual const char* GetName() const { return "2Q"; }
+
+    virtual void Insert( GDALRasterBlock* poBlock )
+    {
+        std::map<GhostKey, GUIntBig>::iterator oIter =
+            oMapGhosts.find(GhostKey(poBlock));
+        if( oIter != oMapGhosts.end() )
+        {
+            oMapGhosts.erase(oIter);
+            SetState(poBlock, QUEUE_AM);
+            ListPushFront(poAmHead, poAmTail, poBlock);
+        }
+        else
+        {
+            SetState(poBlock, QUEUE_A1IN);
+            ListPushFront(poA1inHead, poA1inTail, poBlock);
+            nA1inBytes += poBlock->GetBlockSize();
+        }
+    }
+
+    virtual void Touch( GDALRasterBlock* poBlock )
+    {
+        // Blocks in A1in are not promoted on hits, since correlated
+        // references (e.g. reading a strip line by line) are expected
+        // right after a block has been loaded.
+        if( GetState(poBlock) == QUEUE_AM && poAmHead != poBlock )
+        {
+            ListRemove(poAmHead, poAmTail, poBlock);
+            ListPushFront(poAmHead, poAmTail, poBlock);
+        }
+    }
+
+    virtual void Remove( GDALRasterBlock* poBlock )
+    {
+        if( GetState(poBlock) == QUEUE_AM )
+            ListRemove(poAmHead, poAmTail, poBlock);
+        else
+        {
+            ListRemove(poA1inHead, poA1inTail, poBlock);
+            nA1inBytes -= poBlock->GetBlockSize();
+        }
+    }
 
+    virtual GDALRasterBlock* ApplyDeferredTouch( GDALRasterBlock* poBlock )
+    {
+        // Touch() does not move blocks of A1in
+        if( GetState(poBlock) == QUEUE_A1IN )
+            return poBlock;
+        return GDALRasterBlockCachePolicy::ApplyDeferredTouch(poBlock);
+    }
+
+    virtual void RecordEviction( GDALRasterBlock* poBlock )
+    {
+        if( GetState(poBlock) != QUEUE_A1IN )
+            return;
+
+        GhostKey oKey(poBlock);
+        nGhostSeq ++;
+        oMapGhosts[oKey] = nGhostSeq;
+        oGhostFIFO.push_back(std::pair<GhostKey, GUIntBig>(oKey, nGhostSeq));
+        while( oGhostFIFO.size() > nMaxGhosts )
+        {
+            std::map<GhostKey, GUIntBig>::iterator oIter =
+                oMapGhosts.find(oGhostFIFO.front().first);
+            if( oIter != oMapGhosts.end() &&
+                oIter->second == oGhostFIFO.front().second )
+            {
+                oMapGhosts.erase(oIter);
+            }
+            oGhostFIFO.pop_front();
+        }
+    }
+
+    virtual GDALRasterBlock* GetFirstCandidate( GIntBig nCapacity )
+    {
+        // A1out remembers about as many blocks as half the cache can hold.
+        const GDALRasterBlock* poAny = poA1inTail ? poA1inTail : poAmTail;
+        if( poAny != NULL && poAny->GetBlockSize() > 0 )
+        {
+            nMaxGhosts = static_cast<size_t>(
+                std::max(static_cast<GIntBig>(16),
+                         nCapacity / 2 / poAny->GetBlockSize()));
+        }
+
+        bIterOtherQueueVisited = false;
+        if( poA1inTail != NULL &&
+            (nA1inBytes > nCapacity / 4 || poAmTail == NULL) )
+            return poA1inTail;
+        if( poAmTail != NULL )
+            return poAmTail;
+        return poA1inTail;
+    }
+
+    virtual GDALRasterBlock* GetNextCandidate( GDALRasterBlock* poBlock )
+    {
+        GDALRasterBlock* poCandidate = Previous(poBlock);
+        if( poCandidate == NULL && !bIterOtherQueueVisited )
+        {
+            bIterOtherQueueVisited = true;
+            poCandidate = GetTail( GetState(poBlock) == QUEUE_A1IN ?
+                                                QUEUE_AM : QUEUE_A1IN );
+        }
+        return poCandidate;
+    }
+};
+
+/************************************************************************/
+/*                    GDALRasterBlockCachePolicyCreate()                */
+/************************************************************************/
+
+static GDALRasterBlockCachePolicy* GDALRasterBlockCachePolicyCreate(
+    const char* pszPolicy )
+{
+    if( EQUAL(pszPolicy, "CLOCK") )
+        return new GDALRasterBlockClockPolicy();
+    if( EQUAL(pszPolicy, "2Q") )
+        return new GDALRasterBlock2QPolicy();
+    if( !EQUAL(pszPolicy, "LRU") )
+    {
+        CPLError(CE_Warning, CPLE_NotSupported,
+                 "GDAL_RB_CACHE_POLICY=%s not supported. Falling back to LRU",
+                 pszPolicy);
+    }
+    return new GDALRasterBlockLRUPolicy();
+}
+
+/* -------------------------------------------------------------------- */
+/*      The global block cache is split into nShards independent        */
+/*      partitions. Each one has its own eviction policy, its own lock  */
+/*      and its own slice (nCacheMax / nShards) of the cache memory. A  */
+/*      block always belongs to the same shard, determined by a hash    */
+/*      of its band and of its block coordinates.                       */
+/* -------------------------------------------------------------------- */
+typedef struct
+{
+    CPLLock                    *hLock;
+    GDALRasterBlockCachePolicy *poPolicy;
+    volatile GIntBig            nCacheUsed;
+
+    // Number of blocks of each GDALCachePriority class.
+    int                         anBlocksPerPriority[GCPRIO_HIGH + 1];
+
+    // Statistics of the global block cache, summed over the shards by
+    // GetCacheStatistics(). Misses are counted with the lock held, hits
+    // with CPLAtomicAdd64() as the lock-free hit path does not take it.
+    // They are never reset, see ResetCacheStatistics().
+    volatile GIntBig            nHits;
+    GIntBig                     nMisses;
+} GDALRasterBlockCacheShard;
+
+static GDALRasterBlockCacheShard asShards[GDAL_RB_MAX_SHARDS];
+/* 0 means not yet initialized. Published with CPLMemoryBarrier() once */
+/* asShards is filled, see GDALRasterBlockGetShardCount() */
+static volatile int nShards = 0;
+static volatile int nFlushShardCounter = 0;
+
+/* hRBLock only protects the initialization of the shards. */
 static CPLLock* hRBLock = NULL;
+
+/* Value of the statistics at the last ResetCacheStatistics(), protected */
+/* by hStatsLock */
+static GDALCacheStatistics sStatsAtReset = { 0, 0, 0, 0, 0, 0 };
+static CPLLock* hStatsLock = NULL;
 static int bDebugContention = FALSE;
 static bool bSleepsForBockCacheDebug = false;
+static bool bCacheStats = false; /* GDAL_CACHE_STATS */
+static bool bLockFreeHits = false; /* GDAL_RB_LOCK_FREE_HITS */
 static CPLLockType GetLockType()
 {
     static int nLockType = -1;
@@ -77,12 +678,203 @@ static CPLLockType GetLockType()
 
 #define INITIALIZE_LOCK         CPLLockHolderD( &hRBLock, GetLockType() ); \
                                 CPLLockSetDebugPerf(hRBLock, bDebugContention)
-#define TAKE_LOCK               CPLLockHolderOptionalLockD( hRBLock )
+#define TAKE_LOCK(psShard, poBlockCache) \
+        GDALRasterBlockShardLockHolder oHolder( psShard, poBlockCache )
 #define DESTROY_LOCK            CPLDestroyLock( hRBLock )
 
+/************************************************************************/
+/*                      GDALRasterBlockGetMicroSec()                    */
+/************************************************************************/
+
+static GIntBig GDALRasterBlockGetMicroSec()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER nFrequency = { 0 };
+    if( nFrequency.QuadPart == 0 )
+        QueryPerformanceFrequency(&nFrequency);
+    LARGE_INTEGER nCounter;
+    QueryPerformanceCounter(&nCounter);
+    return static_cast<GIntBig>(
+        nCounter.QuadPart * 1000000.0 / nFrequency.QuadPart);
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<GIntBig>(tv.tv_sec) * 1000000 + tv.tv_usec;
 #endif
+}
 
-//#define ENABLE_DEBUG
+/* -------------------------------------------------------------------- */
+/*      Holder of the lock of a shard. When GDAL_CACHE_STATS is set,    */
+/*      the time spent waiting for the lock is added to the cache       */
+/*      statistics, and to the ones of the band owning the block being  */
+/*      handled, when there is one.                                     */
+/* -------------------------------------------------------------------- */
+class GDALRasterBlockShardLockHolder
+{
+    CPLLock* hLock;
+
+  public:
+    GDALRasterBlockShardLockHolder( GDALRasterBlockCacheShard* psShard,
+                                    GDALAbstractBandBlockCache* poBlockCache ) :
+        hLock(psShard->hLock)
+    {
+        if( hLock == NULL )
+            return;
+        if( !bCacheStats )
+        {
+            CPLAcquireLock(hLock);
+            return;
+        }
+        const GIntBig nStart = GDALRasterBlockGetMicroSec();
+        CPLAcquireLock(hLock);
+        const GIntBig nWait = GDALRasterBlockGetMicroSec() - nStart;
+        if( nWait > 0 )
+        {
+            if( poBlockCache != NULL )
+                poBlockCache->RecordLockWait(nWait);
+            else
+                GDALAbstractBandBlockCache::RecordGlobalLockWait(nWait);
+        }
+    }
+
+    ~GDALRasterBlockShardLockHolder()
+    {
+        if( hLock != NULL )
+            CPLReleaseLock(hLock);
+    }
+};
+
+/************************************************************************/
+/*                      GDALRasterBlockGetShardCount()                  */
+/*                                                                      */
+/*      Return nShards, or 0 if the shards are not initialized yet.     */
+/*      When it is not 0, the barrier makes the content of asShards     */
+/*      written before nShards was set visible to the caller.           */
+/************************************************************************/
+
+static int GDALRasterBlockGetShardCount()
+{
+    const int nCurShards = nShards;
+    if( nCurShards > 0 )
+        CPLMemoryBarrier();
+    return nCurShards;
+}
+
+/************************************************************************/
+/*                        GDALRasterBlockInitShards()                   */
+/************************************************************************/
+
+static void GDALRasterBlockInitShards()
+{
+    if( GDALRasterBlockGetShardCount() > 0 )
+        return;
+
+    INITIALIZE_LOCK;
+    if( nShards > 0 )
+        return;
+
+    int nNewShards = atoi(CPLGetConfigOption("GDAL_RB_CACHE_SHARDS", "1"));
+    if( nNewShards < 1 || nNewShards > GDAL_RB_MAX_SHARDS )
+    {
+        CPLError(CE_Warning, CPLE_NotSupported,
+                 "GDAL_RB_CACHE_SHARDS should be in [1,%d] range. Using 1",
+                 GDAL_RB_MAX_SHARDS);
+        nNewShards = 1;
+    }
+
+    const char* pszPolicy = CPLGetConfigOption("GDAL_RB_CACHE_POLICY", "LRU");
+    for( int i = 0; i < nNewShards; i++ )
+    {
+        asShards[i].hLock = CPLCreateLock(GetLockType());
+        if( asShards[i].hLock )
+            CPLLockSetDebugPerf(asShards[i].hLock, bDebugContention);
+        asShards[i].poPolicy = GDALRasterBlockCachePolicyCreate(pszPolicy);
+        asShards[i].nCacheUsed = 0;
+        for( int j = GCPRIO_LOW; j <= GCPRIO_HIGH; j++ )
+            asShards[i].anBlocksPerPriority[j] = 0;
+    }
+    bCacheStats = CPLTestBool(CPLGetConfigOption("GDAL_CACHE_STATS", "NO"));
+    bLockFreeHits =
+        CPLTestBool(CPLGetConfigOption("GDAL_RB_LOCK_FREE_HITS", "NO"));
+    GDALRasterBlockAllocator::Initialize();
+    if( nNewShards > 1 )
+        CPLDebug("GDAL", "Using %d block cache shards", nNewShards);
+    if( !EQUAL(asShards[0].poPolicy->GetName(), "LRU") )
+        CPLDebug("GDAL", "Using %s block cache eviction policy",
+                 asShards[0].poPolicy->GetName());
+
+    // Other threads read nShards without taking hRBLock.
+    CPLMemoryBarrier();
+    nShards = nNewShards;
+}
+
+/************************************************************************/
+/*                        GDALRasterBlockGetShard()                     */
+/************************************************************************/
+
+static GDALRasterBlockCacheShard* GDALRasterBlockGetShard(
+    const GDALRasterBand* poBand, int nXOff, int nYOff )
+{
+    GDALRasterBlockInitShards();
+    if( nShards == 1 )
+        return &asShards[0];
+
+    // Blocks of a same band are spread over the shards, so that concurrent
+    // readers of a single band also benefit from the partitioning.
+    GUIntBig nHash = static_cast<GUIntBig>(reinterpret_cast<size_t>(poBand)) >> 4;
+    nHash ^= static_cast<GUIntBig>(static_cast<unsigned int>(nXOff)) * 73856093U;
+    nHash ^= static_cast<GUIntBig>(static_cast<unsigned int>(nYOff)) * 19349663U;
+    return &asShards[nHash % static_cast<unsigned int>(nShards)];
+}
+
+/************************************************************************/
+/*                      GDALRasterBlockGetShardCacheMax()               */
+/************************************************************************/
+
+static GIntBig GDALRasterBlockGetShardCacheMax( GIntBig nCurCacheMax )
+{
+    return nCurCacheMax / nShards;
+}
+
+/************************************************************************/
+/*                 GDALRasterBlockLockEvictionCandidate()               */
+/*                                                                      */
+/*      Find and lock (with a -1 lock count) the next block to evict    */
+/*      from a shard. The blocks of the lowest priority class go first. */
+/*      Must be called with the lock of the shard held.                 */
+/************************************************************************/
+
+static GDALRasterBlock* GDALRasterBlockLockEvictionCandidate(
+    GDALRasterBlockCacheShard* psShard, GIntBig nShardCacheMax,
+    bool bDirtyBlocksOnly, GDALDataset* poDS )
+{
+    int nBlocks = 0;
+    for( int nPriority = GCPRIO_LOW; nPriority <= GCPRIO_HIGH; nPriority++ )
+        nBlocks += psShard->anBlocksPerPriority[nPriority];
+
+    for( int nPriority = GCPRIO_LOW; nPriority <= GCPRIO_HIGH; nPriority++ )
+    {
+        if( psShard->anBlocksPerPriority[nPriority] == 0 )
+            continue;
+        GDALRasterBlock* poTarget = psShard->poPolicy->LockCandidate(
+            nShardCacheMax, nBlocks, nPriority, bDirtyBlocksOnly, poDS );
+        if( poTarget != NULL )
+            return poTarget;
+    }
+    return NULL;
+}
+
+/************************************************************************/
+/*                      GDALRasterBlockIsOverQuota()                    */
+/************************************************************************/
+
+static bool GDALRasterBlockIsOverQuota( GDALDataset* poDS )
+{
+    if( poDS == NULL )
+        return false;
+    const GIntBig nQuota = poDS->GetCacheQuota();
+    return nQuota > 0 && poDS->GetCacheUsed() > nQuota;
+}
 
 /************************************************************************/
 /*                          GDALSetCacheMax()                           */
@@ -145,13 +937,13 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
 /*      Flush blocks till we are under the new limit or till we         */
 /*      can't seem to flush anymore.                                    */
 /* -------------------------------------------------------------------- */
-    while( nCacheUsed > nCacheMax )
+    while( GDALGetCacheUsed64() > nCacheMax )
     {
-        GIntBig nOldCacheUsed = nCacheUsed;
+        GIntBig nOldCacheUsed = GDALGetCacheUsed64();
 
         GDALFlushCacheBlock();
 
-        if( nCacheUsed == nOldCacheUsed )
+        if( GDALGetCacheUsed64() == nOldCacheUsed )
             break;
     }
 }
@@ -221,9 +1013,7 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 {
     if( !bCacheMaxInitialized )
     {
-        {
-            INITIALIZE_LOCK;
-        }
+        GDALRasterBlockInitShards();
         bSleepsForBockCacheDebug = CPLTestBool(CPLGetConfigOption("GDAL_DEBUG_BLOCK_CACHE", "NO"));
 
         const char* pszCacheMax = CPLGetConfigOption("GDAL_CACHEMAX","5%");
@@ -286,6 +1076,7 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 
 int CPL_STDCALL GDALGetCacheUsed()
 {
+    const GIntBig nCacheUsed = GDALGetCacheUsed64();
     if (nCacheUsed > INT_MAX)
     {
         static bool bHasWarned = false;
@@ -316,6 +1107,10 @@ int CPL_STDCALL GDALGetCacheUsed()
 
 GIntBig CPL_STDCALL GDALGetCacheUsed64()
 {
+    GIntBig nCacheUsed = 0;
+    const int nCurShards = GDALRasterBlockGetShardCount();
+    for( int i = 0; i < nCurShards; i++ )
+        nCacheUsed += asShards[i].nCacheUsed;
     return nCacheUsed;
 }
 
@@ -356,6 +1151,13 @@ int CPL_STDCALL GDALFlushCacheBlock()
  * a least recently used (LRU) list and an upper cache limit (see
  * GDALSetCacheMax()) under which the cache size is normally kept.
  *
+ * Starting with GDAL 2.2, the global cache can be split into several
+ * independent partitions ("shards") with the GDAL_RB_CACHE_SHARDS
+ * configuration option (default 1, maximum 256). Each shard has its own LRU
+ * list, its own lock and an equal share of the cache limit, which reduces
+ * lock contention when many threads read through the block cache.  As a
+ * consequence, the LRU order is only maintained within each shard.
+ *
  * Some blocks in the cache may be modified relative to the state on disk
  * (they are marked "Dirty") and must be flushed to disk before they can
  * be discarded.  Other (Clean) blocks may just be discarded if their memory
@@ -396,31 +1198,35 @@ int CPL_STDCALL GDALFlushCacheBlock()
 int GDALRasterBlock::FlushCacheBlock(int bDirtyBlocksOnly)
 
 {
-    GDALRasterBlock *poTarget;
+    GDALRasterBlock *poTarget = NULL;
 
-    {
-        INITIALIZE_LOCK;
-        poTarget = poOldest;
+    GDALRasterBlockInitShards();
 
-        while( poTarget != NULL )
-        {
-            if( !bDirtyBlocksOnly || poTarget->GetDirty() )
-            {
-                if( CPLAtomicCompareAndExchange(&(poTarget->nLockCount), 0, -1) )
-                    break;
-            }
-            poTarget = poTarget->poPrevious;
-        }
+    // Start from a different shard at each call, so that successive calls
+    // do not always drain the same partition of the cache.
+    const int nFirstShard = ( nShards == 1 ) ? 0 :
+        static_cast<int>(static_cast<unsigned int>(
+            CPLAtomicInc(&nFlushShardCounter)) % nShards);
+    for( int iShard = 0; poTarget == NULL && iShard < nShards; iShard++ )
+    {
+        GDALRasterBlockCacheShard* psShard =
+            &asShards[(nFirstShard + iShard) % nShards];
+        TAKE_LOCK(psShard, NULL);
+        poTarget = GDALRasterBlockLockEvictionCandidate(
+            psShard, GDALRasterBlockGetShardCacheMax(GDALGetCacheMax64()),
+            CPL_TO_BOOL(bDirtyBlocksOnly), NULL);
 
         if( poTarget == NULL )
-            return FALSE;
+            continue;
         if( bSleepsForBockCacheDebug )
             CPLSleep(CPLAtof(CPLGetConfigOption("GDAL_RB_FLUSHBLOCK_SLEEP_AFTER_DROP_LOCK", "0")));
 
-        poTarget->Detach_unlocked();
-        poTarget->GetBand()->UnreferenceBlock(poTarget);
+        poTarget->Evict_unlocked();
     }
 
+    if( poTarget == NULL )
+        return FALSE;
+
     if( bSleepsForBockCacheDebug )
         CPLSleep(CPLAtof(CPLGetConfigOption("GDAL_RB_FLUSHBLOCK_SLEEP_AFTER_RB_LOCK", "0")));
 
@@ -434,8 +1240,7 @@ int GDALRasterBlock::FlushCacheBlock(int bDirtyBlocksOnly)
         }
     }
 
-    VSIFree(poTarget->pData);
-    poTarget->pData = NULL;
+    poTarget->FreeData();
     poTarget->GetBand()->AddBlockToFreeList(poTarget);
 
     return TRUE;
@@ -506,6 +1311,10 @@ GDALRasterBlock::GDALRasterBlock( GDALRasterBand *poBandIn,
     nXOff = nXOffIn;
     nYOff = nYOffIn;
     bMustDetach = TRUE;
+    nPolicyState = 0;
+    nCachePriority = -1;
+    bSharedMemory = FALSE;
+    bTouchDeferred = FALSE;
 }
 
 /************************************************************************/
@@ -541,6 +1350,10 @@ GDALRasterBlock::GDALRasterBlock( int nXOffIn, int nYOffIn )
     nXOff = nXOffIn;
     nYOff = nYOffIn;
     bMustDetach = FALSE;
+    nPolicyState = 0;
+    nCachePriority = -1;
+    bSharedMemory = FALSE;
+    bTouchDeferred = FALSE;
 }
 
 /************************************************************************/
@@ -565,6 +1378,10 @@ void GDALRasterBlock::RecycleFor( int nXOffIn, int nYOffIn )
     nXOff = nXOffIn;
     nYOff = nYOffIn;
     bMustDetach = TRUE;
+    nPolicyState = 0;
+    nCachePriority = -1;
+    bSharedMemory = FALSE;
+    bTouchDeferred = FALSE;
 }
 
 /************************************************************************/
@@ -582,10 +1399,7 @@ GDALRasterBlock::~GDALRasterBlock()
 {
     Detach();
 
-    if( pData != NULL )
-    {
-        VSIFree( pData );
-    }
+    FreeData();
 
     CPLAssert( nLockCount <= 0 );
 
@@ -594,6 +1408,21 @@ GDALRasterBlock::~GDALRasterBlock()
 #endif
 }
 
+/************************************************************************/
+/*                              FreeData()                              */
+/************************************************************************/
+
+void GDALRasterBlock::FreeData()
+
+{
+    if( bSharedMemory )
+        CPLVirtualMemSharedPagesFree( pData, GetBlockSize() );
+    else
+        GDALRasterBlockAllocator::Free( pData, GetBlockSize() );
+    pData = NULL;
+    bSharedMemory = FALSE;
+}
+
 /************************************************************************/
 /*                               Detach()                               */
 /************************************************************************/
@@ -612,39 +1441,61 @@ void GDALRasterBlock::Detach()
 {
     if( bMustDetach )
     {
-        TAKE_LOCK;
+        GDALRasterBlockCacheShard* psShard =
+            GDALRasterBlockGetShard(poBand, nXOff, nYOff);
+        TAKE_LOCK(psShard, poBand->poBandBlockCache);
         Detach_unlocked();
     }
 }
 
 void GDALRasterBlock::Detach_unlocked()
 {
-    if( poOldest == this )
-        poOldest = poPrevious;
+    GDALRasterBlockCacheShard* psShard =
+        GDALRasterBlockGetShard(poBand, nXOff, nYOff);
 
-    if( poNewest == this )
+    psShard->poPolicy->Remove(this);
+    bMustDetach = FALSE;
+    bTouchDeferred = FALSE;
+
+    if( nCachePriority >= 0 )
     {
-        poNewest = poNext;
+        psShard->anBlocksPerPriority[nCachePriority] --;
+        nCachePriority = -1;
     }
 
-    if( poPrevious != NULL )
-        poPrevious->poNext = poNext;
-
-    if( poNext != NULL )
-        poNext->poPrevious = poPrevious;
-
-    poPrevious = NULL;
-    poNext = NULL;
-    bMustDetach = FALSE;
-
     if( pData )
-        nCacheUsed -= GetBlockSize();
+    {
+        psShard->nCacheUsed -= GetBlockSize();
+        GDALDataset* poDS = poBand->GetDataset();
+        if( poDS != NULL )
+            poDS->UpdateCacheUsed(-GetBlockSize());
+    }
 
 #ifdef ENABLE_DEBUG
     Verify();
 #endif
 }
 
+/************************************************************************/
+/*                           Evict_unlocked()                           */
+/*                                                                      */
+/*      Detach a block, locked for eviction with a -1 lock count, from  */
+/*      the cache to make room, and unreference it from its band. The   */
+/*      caller is in charge of writing it if it is dirty, and of giving */
+/*      it back to the band with AddBlockToFreeList().                  */
+/************************************************************************/
+
+void GDALRasterBlock::Evict_unlocked()
+{
+    GDALRasterBlockCacheShard* psShard =
+        GDALRasterBlockGetShard(poBand, nXOff, nYOff);
+
+    psShard->poPolicy->RecordEviction(this);
+    Detach_unlocked();
+    poBand->poBandBlockCache->RecordEviction();
+    poBand->UnreferenceBlock(this);
+}
+
 /************************************************************************/
 /*                               Verify()                               */
 /************************************************************************/
@@ -658,27 +1509,11 @@ void GDALRasterBlock::Detach_unlocked()
 void GDALRasterBlock::Verify()
 
 {
-    TAKE_LOCK;
-
-    CPLAssert( (poNewest == NULL && poOldest == NULL)
-               || (poNewest != NULL && poOldest != NULL) );
-
-    if( poNewest != NULL )
+    for( int iShard = 0; iShard < nShards; iShard++ )
     {
-        CPLAssert( poNewest->poPrevious == NULL );
-        CPLAssert( poOldest->poNext == NULL );
-
-        GDALRasterBlock* poLast = NULL;
-        for( GDALRasterBlock *poBlock = poNewest;
-             poBlock != NULL;
-             poBlock = poBlock->poNext )
-        {
-            CPLAssert( poBlock->poPrevious == poLast );
-
-            poLast = poBlock;
-        }
-
-        CPLAssert( poOldest == poLast );
+        GDALRasterBlockCacheShard* psShard = &asShards[iShard];
+        TAKE_LOCK(psShard, NULL);
+        psShard->poPolicy->Verify();
     }
 }
 
@@ -689,10 +1524,13 @@ void GDALRasterBlock::Verify() {}
 #if 0
 void GDALRasterBlock::CheckNonOrphanedBlocks(GDALRasterBand* poBand)
 {
-    TAKE_LOCK;
-    for( GDALRasterBlock *poBlock = poNewest;
+  for( int iShard = 0; iShard < nShards; iShard++ )
+  {
+    TAKE_LOCK(&asShards[iShard], NULL);
+    GDALRasterBlockCachePolicy* poPolicy = asShards[iShard].poPolicy;
+    for( GDALRasterBlock *poBlock = poPolicy->GetFirstCandidate(0);
                           poBlock != NULL;
-                          poBlock = poBlock->poNext )
+                          poBlock = poPolicy->GetNextCandidate(poBlock) )
     {
         if ( poBlock->GetBand() == poBand )
         {
@@ -709,6 +1547,7 @@ void GDALRasterBlock::CheckNonOrphanedBlocks(GDALRasterBand* poBand)
                 printf("Dataset : %s\n", poBand->GetDataset()->GetDescription());
         }
     }
+  }
 }
 #endif
 
@@ -739,6 +1578,8 @@ CPLErr GDALRasterBlock::Write()
 
     if (poBand->eFlushBlockErr == CE_None)
     {
+        if( poBand->poBandBlockCache != NULL )
+            poBand->poBandBlockCache->RecordDirtyFlush();
         int bCallLeaveReadWrite = poBand->EnterReadWrite(GF_Write);
         CPLErr eErr = poBand->IWriteBlock( nXOff, nYOff, pData );
         if( bCallLeaveReadWrite ) poBand->LeaveReadWrite();
@@ -756,13 +1597,16 @@ CPLErr GDALRasterBlock::Write()
  * Push block to top of LRU (least-recently used) list.
  *
  * This method is normally called when a block is used to keep track
- * that it has been recently used.
+ * that it has been recently used. With the CLOCK and 2Q eviction policies
+ * (see GDAL_RB_CACHE_POLICY), the block is not necessarily moved.
  */
 
 void GDALRasterBlock::Touch()
 
 {
-    TAKE_LOCK;
+    GDALRasterBlockCacheShard* psShard =
+        GDALRasterBlockGetShard(poBand, nXOff, nYOff);
+    TAKE_LOCK(psShard, poBand->poBandBlockCache);
     Touch_unlocked();
 }
 
@@ -770,46 +1614,83 @@ void GDALRasterBlock::Touch()
 void GDALRasterBlock::Touch_unlocked()
 
 {
-    if( poNewest == this )
-        return;
+    GDALRasterBlockCacheShard* psShard =
+        GDALRasterBlockGetShard(poBand, nXOff, nYOff);
 
     // In theory, we should not try to touch a block that has been detached
     CPLAssert(bMustDetach);
+    bTouchDeferred = FALSE;
     if( !bMustDetach )
     {
         if( pData )
-            nCacheUsed += GetBlockSize();
+        {
+            psShard->nCacheUsed += GetBlockSize();
+            GDALDataset* poDS = poBand->GetDataset();
+            if( poDS != NULL )
+                poDS->UpdateCacheUsed(GetBlockSize());
+        }
 
         bMustDetach = TRUE;
+        Attach_unlocked();
+    }
+    else
+    {
+        UpdateCachePriority_unlocked();
+        psShard->poPolicy->Touch(this);
     }
+#ifdef ENABLE_DEBUG
+    Verify();
+#endif
+}
 
-    if( poOldest == this )
-        poOldest = this->poPrevious;
+/************************************************************************/
+/*                           GetBandCacheId()                           */
+/************************************************************************/
 
-    if( poPrevious != NULL )
-        poPrevious->poNext = poNext;
+GIntBig GDALRasterBlock::GetBandCacheId() const
+{
+    return poBand->poBandBlockCache->GetId();
+}
 
-    if( poNext != NULL )
-        poNext->poPrevious = poPrevious;
+/************************************************************************/
+/*                     UpdateCachePriority_unlocked()                   */
+/*                                                                      */
+/*      Move a cached block to the current priority class of its        */
+/*      dataset, in case it has been changed since the block was        */
+/*      attached.                                                       */
+/************************************************************************/
 
-    poPrevious = NULL;
-    poNext = poNewest;
+void GDALRasterBlock::UpdateCachePriority_unlocked()
+{
+    GDALDataset* poDS = poBand->GetDataset();
+    const int nPriority =
+        ( poDS != NULL ) ? poDS->GetCachePriority() : GCPRIO_NORMAL;
+    if( nCachePriority < 0 || nCachePriority == nPriority )
+        return;
 
-    if( poNewest != NULL )
-    {
-        CPLAssert( poNewest->poPrevious == NULL );
-        poNewest->poPrevious = this;
-    }
-    poNewest = this;
+    GDALRasterBlockCacheShard* psShard =
+        GDALRasterBlockGetShard(poBand, nXOff, nYOff);
+    psShard->anBlocksPerPriority[nCachePriority] --;
+    nCachePriority = nPriority;
+    psShard->anBlocksPerPriority[nCachePriority] ++;
+}
 
-    if( poOldest == NULL )
-    {
-        CPLAssert( poPrevious == NULL && poNext == NULL );
-        poOldest = this;
-    }
-#ifdef ENABLE_DEBUG
-    Verify();
-#endif
+/************************************************************************/
+/*                           Attach_unlocked()                          */
+/*                                                                      */
+/*      Hand the block over to the eviction policy of its shard, under  */
+/*      the priority class of its dataset.                              */
+/************************************************************************/
+
+void GDALRasterBlock::Attach_unlocked()
+{
+    GDALRasterBlockCacheShard* psShard =
+        GDALRasterBlockGetShard(poBand, nXOff, nYOff);
+
+    GDALDataset* poDS = poBand->GetDataset();
+    nCachePriority = ( poDS != NULL ) ? poDS->GetCachePriority() : GCPRIO_NORMAL;
+    psShard->anBlocksPerPriority[nCachePriority] ++;
+    psShard->poPolicy->Insert(this);
 }
 
 /************************************************************************/
@@ -821,6 +1702,9 @@ void GDALRasterBlock::Touch_unlocked()
  *
  * This method allocates memory for the block, and attempts to flush other
  * blocks, if necessary, to bring the total cache size back within the limits.
+ * Blocks of datasets with a low cache priority are flushed first, and blocks
+ * of the dataset of the block are flushed if it exceeds its cache quota
+ * (see GDALDataset::SetCacheQuota() and GDALDataset::SetCachePriority()).
  * The newly allocated block is touched and will be considered most recently
  * used in the LRU list.
  *
@@ -835,114 +1719,119 @@ CPLErr GDALRasterBlock::Internalize()
 
     CPLAssert( pData == NULL );
 
-    // This call will initialize the hRBLock mutex. Other call places can
+    // This call will initialize the block cache shards. Other call places can
     // only be called if we have go through there.
     GIntBig     nCurCacheMax = GDALGetCacheMax64();
 
+    // Only the blocks of our own shard are candidates for eviction, unless
+    // our dataset exceeds its quota.
+    GDALRasterBlockCacheShard* psShard =
+        GDALRasterBlockGetShard(poBand, nXOff, nYOff);
+    const GIntBig nShardCacheMax = GDALRasterBlockGetShardCacheMax(nCurCacheMax);
+
     /* No risk of overflow as it is checked in GDALRasterBand::InitBlockInfo() */
     nSizeInBytes = GetBlockSize();
 
+    const bool bSharedMemoryWanted =
+        poBand->poBandBlockCache->HasSharedMemoryViews() &&
+        CPLGetPageSize() != 0 && (nSizeInBytes % CPLGetPageSize()) == 0;
+
 /* -------------------------------------------------------------------- */
 /*      Flush old blocks if we are nearing our memory limit.            */
 /* -------------------------------------------------------------------- */
+    GDALDataset* poDS = poBand->GetDataset();
     bool bFirstIter = true;
+    bool bInserted = false;
     bool bLoopAgain = false;
     do
     {
         bLoopAgain = false;
         GDALRasterBlock* apoBlocksToFree[64];
         int nBlocksToFree = 0;
+        if( !bInserted )
         {
-            TAKE_LOCK;
+            TAKE_LOCK(psShard, poBand->poBandBlockCache);
 
             if( bFirstIter )
-                nCacheUsed += nSizeInBytes;
-            GDALRasterBlock *poTarget = poOldest;
-            while( nCacheUsed > nCurCacheMax )
             {
-                while( poTarget != NULL )
-                {
-                    if( CPLAtomicCompareAndExchange(&(poTarget->nLockCount), 0, -1) )
-                        break;
-                    poTarget = poTarget->poPrevious;
-                }
+                psShard->nCacheUsed += nSizeInBytes;
+                if( poDS != NULL )
+                    poDS->UpdateCacheUsed(nSizeInBytes);
+            }
+            while( psShard->nCacheUsed > nShardCacheMax )
+            {
+                GDALRasterBlock* poTarget =
+                    GDALRasterBlockLockEvictionCandidate(
+                        psShard, nShardCacheMax, false, NULL);
+                if( poTarget == NULL )
+                    break;
+
+                if( bSleepsForBockCacheDebug )
+                    CPLSleep(CPLAtof(CPLGetConfigOption("GDAL_RB_INTERNALIZE_SLEEP_AFTER_DROP_LOCK", "0")));
 
-                if( poTarget != NULL )
+                poTarget->Evict_unlocked();
+
+                apoBlocksToFree[nBlocksToFree++] = poTarget;
+                if( poTarget->GetDirty() )
                 {
-                    if( bSleepsForBockCacheDebug )
-                        CPLSleep(CPLAtof(CPLGetConfigOption("GDAL_RB_INTERNALIZE_SLEEP_AFTER_DROP_LOCK", "0")));
-
-                    GDALRasterBlock* _poPrevious = poTarget->poPrevious;
-
-                    poTarget->Detach_unlocked();
-                    poTarget->GetBand()->UnreferenceBlock(poTarget);
-
-                    apoBlocksToFree[nBlocksToFree++] = poTarget;
-                    if( poTarget->GetDirty() )
-                    {
-                        // Only free one dirty block at a time so that
-                        // other dirty blocks of other bands with the same coordinates
-                        // can be found with TryGetLockedBlock()
-                        bLoopAgain = ( nCacheUsed > nCurCacheMax );
-                        break;
-                    }
-                    if( nBlocksToFree == 64 )
-                    {
-                        bLoopAgain = ( nCacheUsed > nCurCacheMax );
-                        break;
-                    }
-
-                    poTarget = _poPrevious;
+                    // Only free one dirty block at a time so that
+                    // other dirty blocks of other bands with the same coordinates
+                    // can be found with TryGetLockedBlock()
+                    bLoopAgain = ( psShard->nCacheUsed > nShardCacheMax );
+                    break;
                 }
-                else
+                if( nBlocksToFree == 64 )
+                {
+                    bLoopAgain = ( psShard->nCacheUsed > nShardCacheMax );
                     break;
+                }
             }
 
         /* -------------------------------------------------------------------- */
         /*      Add this block to the list.                                     */
         /* -------------------------------------------------------------------- */
             if( !bLoopAgain )
-                Touch_unlocked();
-        }
-
-        bFirstIter = false;
-
-        /* Now free blocks we have detached and removed from their band */
-        for(int i=0;i<nBlocksToFree;i++)
-        {
-            GDALRasterBlock *poBlock = apoBlocksToFree[i];
-
-            if( poBlock->GetDirty() )
             {
-                CPLErr eErr = poBlock->Write();
-                if( eErr != CE_None )
-                {
-                    /* Save the error for later reporting */
-                    poBlock->GetBand()->SetFlushBlockErr(eErr);
-                }
+                poBand->poBandBlockCache->RecordMiss();
+                psShard->nMisses ++;
+                Attach_unlocked();
+                bInserted = true;
             }
+        }
 
-            /* Try to recycle the data of an existing block */
-            void* pDataBlock = poBlock->pData;
-            if( pNewData == NULL && pDataBlock != NULL &&
-                poBlock->GetBlockSize() == nSizeInBytes )
-            {
-                pNewData = pDataBlock;
-            }
+    /* -------------------------------------------------------------------- */
+    /*      Then evict other blocks of our dataset if it is over its quota, */
+    /*      once the blocks evicted from our shard have been freed.         */
+    /* -------------------------------------------------------------------- */
+        if( bInserted && GDALRasterBlockIsOverQuota(poDS) )
+        {
+            if( nBlocksToFree == 0 )
+                bLoopAgain = CPL_TO_BOOL(EvictOverQuota(
+                    poDS, apoBlocksToFree, &nBlocksToFree, 64));
             else
-            {
-                VSIFree(poBlock->pData);
-            }
-            poBlock->pData = NULL;
-
-            poBlock->GetBand()->AddBlockToFreeList(poBlock);
+                bLoopAgain = true;
         }
+
+        bFirstIter = false;
+
+        /* Now free blocks we have detached and removed from their band */
+        FreeEvictedBlocks(apoBlocksToFree, nBlocksToFree,
+                          bSharedMemoryWanted ? NULL : &pNewData,
+                          nSizeInBytes);
     }
     while(bLoopAgain);
 
+    /* Blocks mapped by virtual memory views must be in memory that can be */
+    /* mapped without copy. Fall back to the heap if there is none left. */
+    if( bSharedMemoryWanted )
+    {
+        pNewData = CPLVirtualMemSharedPagesAlloc( nSizeInBytes );
+        bSharedMemory = (pNewData != NULL);
+    }
+
     if( pNewData == NULL )
     {
-        pNewData = VSI_MALLOC_VERBOSE( nSizeInBytes );
+        pNewData = GDALRasterBlockAllocator::Alloc( nSizeInBytes );
         if( pNewData == NULL )
         {
             return( CE_Failure );
@@ -954,6 +1843,125 @@ CPLErr GDALRasterBlock::Internalize()
     return( CE_None );
 }
 
+/************************************************************************/
+/*                           EvictOverQuota()                           */
+/*                                                                      */
+/*      Detach blocks of poDS from the cache, in the eviction order of  */
+/*      each shard, until the dataset is within its quota, and add them */
+/*      to papoBlocksToFree. Returns TRUE if the caller must call again */
+/*      once those blocks are freed, because a dirty block was met or   */
+/*      nMaxBlocksToFree was reached.                                   */
+/************************************************************************/
+
+int GDALRasterBlock::EvictOverQuota( GDALDataset* poDS,
+                                     GDALRasterBlock** papoBlocksToFree,
+                                     int* pnBlocksToFree,
+                                     int nMaxBlocksToFree )
+{
+    const GIntBig nShardCacheMax =
+        GDALRasterBlockGetShardCacheMax(GDALGetCacheMax64());
+    const int nFirstShard = ( nShards == 1 ) ? 0 :
+        static_cast<int>(static_cast<unsigned int>(
+            CPLAtomicInc(&nFlushShardCounter)) % nShards);
+    for( int iShard = 0; iShard < nShards; iShard++ )
+    {
+        GDALRasterBlockCacheShard* psShard =
+            &asShards[(nFirstShard + iShard) % nShards];
+        TAKE_LOCK(psShard, NULL);
+        while( GDALRasterBlockIsOverQuota(poDS) )
+        {
+            GDALRasterBlock* poTarget = GDALRasterBlockLockEvictionCandidate(
+                psShard, nShardCacheMax, false, poDS);
+            if( poTarget == NULL )
+                break;
+
+            poTarget->Evict_unlocked();
+
+            papoBlocksToFree[(*pnBlocksToFree)++] = poTarget;
+            if( poTarget->GetDirty() || *pnBlocksToFree == nMaxBlocksToFree )
+                return GDALRasterBlockIsOverQuota(poDS);
+        }
+    }
+    return FALSE;
+}
+
+/************************************************************************/
+/*                          FreeEvictedBlocks()                         */
+/*                                                                      */
+/*      Write the dirty blocks among blocks detached by Internalize()   */
+/*      or EvictOverQuota(), and give them back to their band. The data */
+/*      buffer of one of them may be recycled into *ppRecycledData.     */
+/************************************************************************/
+
+void GDALRasterBlock::FreeEvictedBlocks( GDALRasterBlock** papoBlocks,
+                                         int nBlocks,
+                                         void** ppRecycledData,
+                                         int nRecycledSize )
+{
+    for(int i=0;i<nBlocks;i++)
+    {
+        GDALRasterBlock *poBlock = papoBlocks[i];
+
+        if( poBlock->GetDirty() )
+        {
+            CPLErr eErr = poBlock->Write();
+            if( eErr != CE_None )
+            {
+                /* Save the error for later reporting */
+                poBlock->GetBand()->SetFlushBlockErr(eErr);
+            }
+        }
+
+        /* Try to recycle the data of an existing block */
+        void* pDataBlock = poBlock->pData;
+        if( ppRecycledData != NULL && *ppRecycledData == NULL &&
+            pDataBlock != NULL && !poBlock->bSharedMemory &&
+            poBlock->GetBlockSize() == nRecycledSize )
+        {
+            *ppRecycledData = pDataBlock;
+            poBlock->pData = NULL;
+        }
+        else
+        {
+            poBlock->FreeData();
+        }
+
+        poBlock->GetBand()->AddBlockToFreeList(poBlock);
+    }
+}
+
+/************************************************************************/
+/*                          EnforceCacheQuota()                         */
+/************************************************************************/
+
+/**
+ * Evict blocks of a dataset until it is within its cache quota.
+ *
+ * This is normally called by GDALDataset::SetCacheQuota(). Afterwards,
+ * the quota is enforced each time a block of the dataset enters the cache.
+ *
+ * @param poDS the dataset.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALRasterBlock::EnforceCacheQuota( GDALDataset* poDS )
+{
+    if( GDALRasterBlockGetShardCount() == 0 )
+        return;
+
+    bool bLoopAgain;
+    do
+    {
+        GDALRasterBlock* apoBlocksToFree[64];
+        int nBlocksToFree = 0;
+        bLoopAgain = CPL_TO_BOOL(EvictOverQuota(
+            poDS, apoBlocksToFree, &nBlocksToFree, 64));
+        FreeEvictedBlocks(apoBlocksToFree, nBlocksToFree, NULL, 0);
+    }
+    while( bLoopAgain );
+}
+
 /************************************************************************/
 /*                             MarkDirty()                              */
 /************************************************************************/
@@ -989,15 +1997,226 @@ void GDALRasterBlock::MarkClean()
     bDirty = FALSE;
 }
 
+/************************************************************************/
+/*                       RecordCacheHit()                               */
+/************************************************************************/
+
+/**
+ * Count a request for the block that was served from the cache.
+ *
+ * Should only be used by GDALRasterBand::TryGetLockedBlockRef() and
+ * GDALRasterBand::GetLockedBlockRef()
+ */
+
+void GDALRasterBlock::RecordCacheHit()
+{
+    poBand->poBandBlockCache->RecordHit();
+    CPLAtomicAdd64(&(GDALRasterBlockGetShard(poBand, nXOff, nYOff)->nHits), 1);
+}
+
+/************************************************************************/
+/*                GDALRasterBlockGetStatisticsSinceStart()              */
+/************************************************************************/
+
+static void GDALRasterBlockGetStatisticsSinceStart(
+                                                GDALCacheStatistics* psStats )
+{
+    GDALAbstractBandBlockCache::GetGlobalStatistics(psStats);
+
+    // Shards no longer in use after a DestroyRBMutex() keep their counts.
+    const int nActiveShards = GDALRasterBlockGetShardCount();
+    for( int i = 0; i < GDAL_RB_MAX_SHARDS; i++ )
+    {
+        GDALRasterBlockCacheShard* psShard = &asShards[i];
+        psStats->nHits += CPLAtomicAdd64(&(psShard->nHits), 0);
+        if( i < nActiveShards )
+        {
+            TAKE_LOCK(psShard, NULL);
+            psStats->nMisses += psShard->nMisses;
+        }
+        else
+            psStats->nMisses += psShard->nMisses;
+    }
+}
+
+/************************************************************************/
+/*                         GetCacheStatistics()                         */
+/************************************************************************/
+
+/**
+ * \brief Return the statistics of the global block cache.
+ *
+ * A hit is a request for a block (through GDALRasterBand::GetLockedBlockRef()
+ * or TryGetLockedBlockRef()) that was found in the cache, and a miss is
+ * a block that had to be loaded (or initialized) into the cache. Evictions
+ * are the blocks that have been discarded to remain under the cache limit
+ * or the quota of their dataset, or by GDALFlushCacheBlock().
+ *
+ * The time spent waiting for the locks of the cache is only measured when
+ * the GDAL_CACHE_STATS configuration option is set to YES. In that case,
+ * the statistics are also reported as debug messages (CPL_DEBUG=ON) when
+ * GDALDestroyDriverManager() is called.
+ *
+ * The statistics of a band are returned by
+ * GDALRasterBand::GetCacheStatistics().
+ *
+ * This method is the same as the C function GDALGetCacheStatistics().
+ *
+ * @param psStats structure to fill.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALRasterBlock::GetCacheStatistics( GDALCacheStatistics* psStats )
+{
+    GDALCacheStatistics sStats;
+    GDALRasterBlockGetStatisticsSinceStart( &sStats );
+
+    CPLLockHolderD( &hStatsLock, LOCK_SPIN );
+    psStats->nHits = sStats.nHits - sStatsAtReset.nHits;
+    psStats->nMisses = sStats.nMisses - sStatsAtReset.nMisses;
+    psStats->nBytesRead = sStats.nBytesRead - sStatsAtReset.nBytesRead;
+    psStats->nEvictions = sStats.nEvictions - sStatsAtReset.nEvictions;
+    psStats->nDirtyFlushes =
+        sStats.nDirtyFlushes - sStatsAtReset.nDirtyFlushes;
+    psStats->nLockWaitMicroSec =
+        sStats.nLockWaitMicroSec - sStatsAtReset.nLockWaitMicroSec;
+}
+
+/************************************************************************/
+/*                       GDALGetCacheStatistics()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the statistics of the global block cache.
+ *
+ * @see GDALRasterBlock::GetCacheStatistics()
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALGetCacheStatistics( GDALCacheStatistics* psStats )
+{
+    VALIDATE_POINTER0( psStats, "GDALGetCacheStatistics" );
+
+    GDALRasterBlock::GetCacheStatistics(psStats);
+}
+
+/************************************************************************/
+/*                        ResetCacheStatistics()                        */
+/************************************************************************/
+
+/**
+ * \brief Reset the statistics of the global block cache.
+ *
+ * The statistics of the bands are not affected. The counters keep running:
+ * GetCacheStatistics() then returns their increase since the reset, so the
+ * requests done by other threads meanwhile are not lost.
+ *
+ * This method is the same as the C function GDALResetCacheStatistics().
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALRasterBlock::ResetCacheStatistics()
+{
+    // The counters are only read: resetting them would lose the increments
+    // done meanwhile by other threads.
+    GDALCacheStatistics sStats;
+    GDALRasterBlockGetStatisticsSinceStart( &sStats );
+
+    CPLLockHolderD( &hStatsLock, LOCK_SPIN );
+    sStatsAtReset = sStats;
+}
+
+/************************************************************************/
+/*                      GDALResetCacheStatistics()                      */
+/************************************************************************/
+
+/**
+ * \brief Reset the statistics of the global block cache.
+ *
+ * @see GDALRasterBlock::ResetCacheStatistics()
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALResetCacheStatistics()
+{
+    GDALRasterBlock::ResetCacheStatistics();
+}
+
 /************************************************************************/
 /*                          DestroyRBMutex()                           */
 /************************************************************************/
 
 void GDALRasterBlock::DestroyRBMutex()
 {
+    if( nShards > 0 )
+    {
+        GDALCacheStatistics sStats;
+        GetCacheStatistics( &sStats );
+        const GIntBig nRequests = sStats.nHits + sStats.nMisses;
+        if( bCacheStats )
+        {
+            CPLDebug( "GDAL", "Block cache statistics:" );
+            CPLDebug( "GDAL", "  Policy: %s, %d shard(s), max: " CPL_FRMT_GIB
+                      " bytes", asShards[0].poPolicy->GetName(), nShards,
+                      GDALGetCacheMax64() );
+            CPLDebug( "GDAL", "  Hits: " CPL_FRMT_GIB, sStats.nHits );
+            CPLDebug( "GDAL", "  Misses: " CPL_FRMT_GIB, sStats.nMisses );
+            CPLDebug( "GDAL", "  Hit rate: %.1f %%",
+                      nRequests ? 100.0 * sStats.nHits / nRequests : 0.0 );
+            CPLDebug( "GDAL", "  Bytes read: " CPL_FRMT_GIB,
+                      sStats.nBytesRead );
+            CPLDebug( "GDAL", "  Evictions: " CPL_FRMT_GIB,
+                      sStats.nEvictions );
+            CPLDebug( "GDAL", "  Dirty flushes: " CPL_FRMT_GIB,
+                      sStats.nDirtyFlushes );
+            CPLDebug( "GDAL", "  Lock wait time: %.3f s",
+                      sStats.nLockWaitMicroSec / 1e6 );
+            if( GDALRasterBlockAllocator::IsSlabAllocator() )
+            {
+                GIntBig nReserved = 0;
+                GIntBig nUsed = 0;
+                GIntBig nRequested = 0;
+                GDALRasterBlockAllocator::GetStatistics(&nReserved, &nUsed,
+                                                        &nRequested);
+                CPLDebug( "GDAL", "  Slabs: " CPL_FRMT_GIB " bytes, "
+                          CPL_FRMT_GIB " in use, " CPL_FRMT_GIB " requested",
+                          nReserved, nUsed, nRequested );
+            }
+        }
+        else if( nRequests > 0 )
+        {
+            CPLDebug( "GDAL", "Block cache (%s policy): " CPL_FRMT_GIB " hits, "
+                      CPL_FRMT_GIB " misses (hit rate %.1f %%), "
+                      CPL_FRMT_GIB " evictions",
+                      asShards[0].poPolicy->GetName(), sStats.nHits,
+                      sStats.nMisses, 100.0 * sStats.nHits / nRequests,
+                      sStats.nEvictions );
+        }
+    }
+
+    for( int i = 0; i < nShards; i++ )
+    {
+        if( asShards[i].hLock != NULL )
+            CPLDestroyLock( asShards[i].hLock );
+        asShards[i].hLock = NULL;
+        delete asShards[i].poPolicy;
+        asShards[i].poPolicy = NULL;
+    }
+    nShards = 0;
+
+    GDALRasterBlockAllocator::Cleanup();
+
     if( hRBLock != NULL )
         DESTROY_LOCK;
     hRBLock = NULL;
+
+    if( hStatsLock != NULL )
+        CPLDestroyLock( hStatsLock );
+    hStatsLock = NULL;
 }
 
 /************************************************************************/
@@ -1010,6 +2229,14 @@ void GDALRasterBlock::DestroyRBMutex()
  * Should only be used by GDALArrayBandBlockCache::TryGetLockedBlockRef()
  * and GDALHashSetBandBlockCache::TryGetLockedBlockRef()
  *
+ * The block is also touched. If the GDAL_RB_LOCK_FREE_HITS configuration
+ * option is set to YES, this is done without taking the lock of the block
+ * cache: the touch is only recorded in the block, and taken into account by
+ * the eviction policy when the block becomes a candidate for eviction. This
+ * scales better with many threads reading the same cached blocks, but the
+ * eviction order is then only an approximation of the least recently used
+ * one, which is why this is not the default.
+ *
  * @return TRUE if the lock has been successfully acquired. If FALSE, this
  *         should be reattempted after fetching again from the raster band
  *         block storage.
@@ -1033,11 +2260,26 @@ int GDALRasterBlock::TakeLock()
         DropLock();
 
         // wait for the block having been unreferenced
-        TAKE_LOCK;
+        TAKE_LOCK(GDALRasterBlockGetShard(poBand, nXOff, nYOff),
+                  poBand->poBandBlockCache);
 
         return FALSE;
     }
-    Touch();
+
+    // Cache hit fast path. As we hold a lock on the block, it cannot be
+    // evicted, so the touch can be left to the eviction policy, which will
+    // apply it the next time it looks for a block to evict.
+    if( bLockFreeHits && CPLAtomicAdd(&bMustDetach, 0) )
+    {
+        if( !bTouchDeferred )
+            CPLAtomicCompareAndExchange(&bTouchDeferred, FALSE, TRUE);
+        return TRUE;
+    }
+
+    GDALRasterBlockCacheShard* psShard =
+        GDALRasterBlockGetShard(poBand, nXOff, nYOff);
+    TAKE_LOCK(psShard, poBand->poBandBlockCache);
+    Touch_unlocked();
     return TRUE;
 }
 
@@ -1067,7 +2309,8 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 #endif
 
     // Wait for the block for having been unreferenced
-    TAKE_LOCK;
+    TAKE_LOCK(GDALRasterBlockGetShard(poBand, nXOff, nYOff),
+              poBand->poBandBlockCache);
 
     return FALSE;
 }
@@ -1076,14 +2319,18 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 void GDALRasterBlock::DumpAll()
 {
     int iBlock = 0;
-    for( GDALRasterBlock *poBlock = poNewest;
-                            poBlock != NULL;
-                            poBlock = poBlock->poNext )
+    for( int iShard = 0; iShard < nShards; iShard++ )
     {
-        printf("Block %d\n", iBlock);
-        poBlock->DumpBlock();
-        printf("\n");
-        iBlock ++;
+        GDALRasterBlockCachePolicy* poPolicy = asShards[iShard].poPolicy;
+        for( GDALRasterBlock *poBlock = poPolicy->GetFirstCandidate(0);
+                                poBlock != NULL;
+                                poBlock = poPolicy->GetNextCandidate(poBlock) )
+        {
+            printf("Block %d (shard %d)\n", iBlock, iShard);
+            poBlock->DumpBlock();
+            printf("\n");
+            iBlock ++;
+        }
     }
 }
 
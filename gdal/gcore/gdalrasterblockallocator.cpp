@@ -0,0 +1,516 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Allocator of the data buffers of the blocks of the block cache
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_priv.h"
+#include "cpl_multiproc.h"
+
+#include <map>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#if defined(MADV_HUGEPAGE)
+#define HAVE_HUGE_PAGES
+#endif
+#endif
+
+CPL_CVSID("$Id$");
+
+/*
+ * By default (GDAL_RB_ALLOCATOR=MALLOC), the data buffers of the blocks are
+ * allocated with VSIMalloc() and freed with VSIFree().
+ *
+ * With GDAL_RB_ALLOCATOR=SLAB, they are carved out of slabs of
+ * GDAL_RB_SLAB_SIZE bytes (2 MB by default), dedicated to a size class.
+ * Sizes are rounded up to a size class, with classes spaced by an eighth of
+ * the previous power of two, so that at most 12.5 % of a buffer is wasted.
+ * A freed buffer goes back to its slab and is reused by the next allocation
+ * of the same size class, which avoids the malloc churn and fragmentation
+ * caused by the cache continuously evicting and loading blocks. Each size
+ * class keeps at most one completely free slab; other slabs are given back
+ * to the system as soon as they become free.
+ *
+ * With GDAL_RB_HUGE_PAGES=YES (Linux only), slabs are aligned on, and
+ * rounded up to, 2 MB, and advised for transparent huge pages.
+ *
+ * The options are read when the block cache is initialized.
+ */
+
+#define GDAL_RB_HUGE_PAGE_SIZE      (2 * 1024 * 1024)
+#define GDAL_RB_MIN_GRANULE         64
+
+struct GDALRasterBlockSizeClass;
+
+typedef struct GDALRasterBlockSlab
+{
+    GByte*                      pabyBase;
+    size_t                      nSize;
+    /* Start and size of the mapping when it is larger than the slab */
+    /* because of the alignment on huge pages, NULL if allocated with */
+    /* VSIMalloc() */
+    void*                       pMapping;
+    size_t                      nMappingSize;
+    GDALRasterBlockSizeClass*   psClass;
+    int                         nChunks;
+    /* Number of chunks handed out at least once, in address order */
+    int                         nCarved;
+    int                         nUsed;
+    /* Chunks given back, linked through their first bytes */
+    void*                       pFreeList;
+    /* List of the slabs of the class that have free chunks */
+    GDALRasterBlockSlab*        psPrevPartial;
+    GDALRasterBlockSlab*        psNextPartial;
+} GDALRasterBlockSlab;
+
+struct GDALRasterBlockSizeClass
+{
+    size_t                      nChunkSize;
+    GDALRasterBlockSlab*        psPartial;
+    int                         nEmptySlabs;
+};
+
+static bool bSlabAllocator = false;         /* GDAL_RB_ALLOCATOR */
+static bool bHugePages = false;             /* GDAL_RB_HUGE_PAGES */
+static size_t nSlabSize = GDAL_RB_HUGE_PAGE_SIZE; /* GDAL_RB_SLAB_SIZE */
+
+/* hAllocatorMutex protects all the following variables */
+static CPLMutex* hAllocatorMutex = NULL;
+static std::map<size_t, GDALRasterBlockSizeClass>* poMapClasses = NULL;
+static std::map<GByte*, GDALRasterBlockSlab*>* poMapSlabs = NULL;
+static GIntBig nReservedBytes = 0;
+static GIntBig nUsedBytes = 0;
+static GIntBig nRequestedBytes = 0;
+
+/************************************************************************/
+/*                             Initialize()                             */
+/************************************************************************/
+
+/**
+ * Read the configuration of the allocator.
+ *
+ * Should only be called by the initialization of the block cache, before
+ * any block is allocated.
+ */
+
+void GDALRasterBlockAllocator::Initialize()
+{
+    const char* pszAllocator = CPLGetConfigOption("GDAL_RB_ALLOCATOR", "MALLOC");
+    bSlabAllocator = EQUAL(pszAllocator, "SLAB");
+    if( !bSlabAllocator && !EQUAL(pszAllocator, "MALLOC") )
+    {
+        CPLError(CE_Warning, CPLE_NotSupported,
+                 "GDAL_RB_ALLOCATOR=%s not supported. Falling back to MALLOC",
+                 pszAllocator);
+    }
+    if( !bSlabAllocator )
+        return;
+
+    nSlabSize = GDAL_RB_HUGE_PAGE_SIZE;
+    const char* pszSlabSize = CPLGetConfigOption("GDAL_RB_SLAB_SIZE", NULL);
+    if( pszSlabSize != NULL )
+    {
+        const GIntBig nVal = CPLAtoGIntBig(pszSlabSize);
+        if( nVal < 4096 || nVal > 1024 * 1024 * 1024 )
+        {
+            CPLError(CE_Warning, CPLE_NotSupported,
+                     "GDAL_RB_SLAB_SIZE should be in [4096,1073741824] "
+                     "range. Using %d", GDAL_RB_HUGE_PAGE_SIZE);
+        }
+        else
+            nSlabSize = static_cast<size_t>(nVal);
+    }
+
+    bHugePages = CPLTestBool(CPLGetConfigOption("GDAL_RB_HUGE_PAGES", "NO"));
+#ifndef HAVE_HUGE_PAGES
+    if( bHugePages )
+    {
+        CPLDebug("GDAL", "GDAL_RB_HUGE_PAGES not supported on this platform");
+        bHugePages = false;
+    }
+#endif
+
+    CPLDebug("GDAL", "Using slab allocator for the block cache "
+             "(slabs of " CPL_FRMT_GUIB " bytes%s)",
+             static_cast<GUIntBig>(nSlabSize),
+             bHugePages ? ", huge pages" : "");
+}
+
+/************************************************************************/
+/*                          GetAllocationSize()                         */
+/************************************************************************/
+
+/**
+ * Return the number of bytes actually reserved for a buffer of nSize bytes.
+ *
+ * Buffers whose requested sizes have the same allocation size can be
+ * exchanged.
+ */
+
+size_t GDALRasterBlockAllocator::GetAllocationSize( size_t nSize )
+{
+    if( !bSlabAllocator )
+        return nSize;
+    if( nSize <= GDAL_RB_MIN_GRANULE )
+        return GDAL_RB_MIN_GRANULE;
+
+    size_t nPow2 = 1;
+    while( nPow2 <= (nSize - 1) / 2 )
+        nPow2 *= 2;
+    size_t nGranule = nPow2 / 8;
+    if( nGranule < GDAL_RB_MIN_GRANULE )
+        nGranule = GDAL_RB_MIN_GRANULE;
+    return ((nSize + nGranule - 1) / nGranule) * nGranule;
+}
+
+/************************************************************************/
+/*                         GDALRasterBlockSlabNew()                     */
+/************************************************************************/
+
+static GDALRasterBlockSlab* GDALRasterBlockSlabNew(
+    GDALRasterBlockSizeClass* psClass )
+{
+    size_t nChunks = nSlabSize / psClass->nChunkSize;
+    if( nChunks == 0 )
+        nChunks = 1;
+    size_t nSize = nChunks * psClass->nChunkSize;
+
+    void* pMapping = NULL;
+    size_t nMappingSize = 0;
+    GByte* pabyBase = NULL;
+#ifdef HAVE_HUGE_PAGES
+    if( bHugePages )
+    {
+        nSize = ((nSize + GDAL_RB_HUGE_PAGE_SIZE - 1) /
+                            GDAL_RB_HUGE_PAGE_SIZE) * GDAL_RB_HUGE_PAGE_SIZE;
+        nChunks = nSize / psClass->nChunkSize;
+        // Over-allocate so that the slab can be aligned on a huge page
+        nMappingSize = nSize + GDAL_RB_HUGE_PAGE_SIZE;
+        pMapping = mmap(NULL, nMappingSize, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if( pMapping == MAP_FAILED )
+            return NULL;
+        const GUIntBig nAddr =
+            static_cast<GUIntBig>(reinterpret_cast<size_t>(pMapping));
+        const GUIntBig nAligned =
+            ((nAddr + GDAL_RB_HUGE_PAGE_SIZE - 1) / GDAL_RB_HUGE_PAGE_SIZE) *
+                                                        GDAL_RB_HUGE_PAGE_SIZE;
+        pabyBase = static_cast<GByte*>(pMapping) + (nAligned - nAddr);
+        madvise(pabyBase, nSize, MADV_HUGEPAGE);
+    }
+    else
+#endif
+    {
+        pabyBase = static_cast<GByte*>(VSIMalloc(nSize));
+        if( pabyBase == NULL )
+            return NULL;
+    }
+
+    GDALRasterBlockSlab* psSlab = new GDALRasterBlockSlab;
+    psSlab->pabyBase = pabyBase;
+    psSlab->nSize = nSize;
+    psSlab->pMapping = pMapping;
+    psSlab->nMappingSize = nMappingSize;
+    psSlab->psClass = psClass;
+    psSlab->nChunks = static_cast<int>(nChunks);
+    psSlab->nCarved = 0;
+    psSlab->nUsed = 0;
+    psSlab->pFreeList = NULL;
+    psSlab->psPrevPartial = NULL;
+    psSlab->psNextPartial = NULL;
+
+    (*poMapSlabs)[pabyBase] = psSlab;
+    nReservedBytes += nSize;
+    return psSlab;
+}
+
+/************************************************************************/
+/*                        GDALRasterBlockSlabFree()                     */
+/************************************************************************/
+
+static void GDALRasterBlockSlabFree( GDALRasterBlockSlab* psSlab )
+{
+    poMapSlabs->erase(psSlab->pabyBase);
+    nReservedBytes -= psSlab->nSize;
+#ifdef HAVE_HUGE_PAGES
+    if( psSlab->pMapping != NULL )
+        munmap(psSlab->pMapping, psSlab->nMappingSize);
+    else
+#endif
+        VSIFree(psSlab->pabyBase);
+    delete psSlab;
+}
+
+/************************************************************************/
+/*                     Partial slab list management                     */
+/************************************************************************/
+
+static void GDALRasterBlockSlabAddPartial( GDALRasterBlockSlab* psSlab )
+{
+    GDALRasterBlockSizeClass* psClass = psSlab->psClass;
+    psSlab->psPrevPartial = NULL;
+    psSlab->psNextPartial = psClass->psPartial;
+    if( psClass->psPartial != NULL )
+        psClass->psPartial->psPrevPartial = psSlab;
+    psClass->psPartial = psSlab;
+}
+
+static void GDALRasterBlockSlabRemovePartial( GDALRasterBlockSlab* psSlab )
+{
+    GDALRasterBlockSizeClass* psClass = psSlab->psClass;
+    if( psSlab->psPrevPartial != NULL )
+        psSlab->psPrevPartial->psNextPartial = psSlab->psNextPartial;
+    else
+        psClass->psPartial = psSlab->psNextPartial;
+    if( psSlab->psNextPartial != NULL )
+        psSlab->psNextPartial->psPrevPartial = psSlab->psPrevPartial;
+    psSlab->psPrevPartial = NULL;
+    psSlab->psNextPartial = NULL;
+}
+
+/************************************************************************/
+/*                                Alloc()                               */
+/************************************************************************/
+
+/**
+ * Allocate the data buffer of a block.
+ *
+ * @param nSize size in bytes of the buffer.
+ * @return the buffer, to free with Free(), or NULL in case of error (an
+ *         error is emitted).
+ */
+
+void* GDALRasterBlockAllocator::Alloc( size_t nSize )
+{
+    if( !bSlabAllocator )
+        return VSI_MALLOC_VERBOSE(nSize);
+
+    const size_t nChunkSize = GetAllocationSize(nSize);
+
+    CPLMutexHolderD( &hAllocatorMutex );
+    if( poMapClasses == NULL )
+    {
+        poMapClasses = new std::map<size_t, GDALRasterBlockSizeClass>();
+        poMapSlabs = new std::map<GByte*, GDALRasterBlockSlab*>();
+    }
+
+    std::map<size_t, GDALRasterBlockSizeClass>::iterator oIter =
+        poMapClasses->find(nChunkSize);
+    if( oIter == poMapClasses->end() )
+    {
+        GDALRasterBlockSizeClass sClass;
+        sClass.nChunkSize = nChunkSize;
+        sClass.psPartial = NULL;
+        sClass.nEmptySlabs = 0;
+        oIter = poMapClasses->insert(
+            std::pair<size_t, GDALRasterBlockSizeClass>(nChunkSize, sClass)).first;
+    }
+    GDALRasterBlockSizeClass* psClass = &(oIter->second);
+
+    GDALRasterBlockSlab* psSlab = psClass->psPartial;
+    if( psSlab == NULL )
+    {
+        psSlab = GDALRasterBlockSlabNew(psClass);
+        if( psSlab == NULL )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate slab for blocks of " CPL_FRMT_GUIB
+                     " bytes", static_cast<GUIntBig>(nSize));
+            return NULL;
+        }
+        GDALRasterBlockSlabAddPartial(psSlab);
+    }
+    else if( psSlab->nUsed == 0 )
+    {
+        psClass->nEmptySlabs --;
+    }
+
+    void* pRet;
+    if( psSlab->pFreeList != NULL )
+    {
+        pRet = psSlab->pFreeList;
+        psSlab->pFreeList = *static_cast<void**>(pRet);
+    }
+    else
+    {
+        // Hand out never used chunks last, so that their pages are only
+        // committed when needed
+        CPLAssert( psSlab->nCarved < psSlab->nChunks );
+        pRet = psSlab->pabyBase + psSlab->nCarved * nChunkSize;
+        psSlab->nCarved ++;
+    }
+    psSlab->nUsed ++;
+    if( psSlab->nUsed == psSlab->nChunks )
+        GDALRasterBlockSlabRemovePartial(psSlab);
+
+    nUsedBytes += nChunkSize;
+    nRequestedBytes += nSize;
+    return pRet;
+}
+
+/************************************************************************/
+/*                                 Free()                               */
+/************************************************************************/
+
+/**
+ * Free a buffer allocated with Alloc().
+ *
+ * @param pData the buffer, or NULL.
+ * @param nSize the size that was passed to Alloc().
+ */
+
+void GDALRasterBlockAllocator::Free( void* pData, size_t nSize )
+{
+    if( !bSlabAllocator )
+    {
+        VSIFree(pData);
+        return;
+    }
+    if( pData == NULL )
+        return;
+
+    const size_t nChunkSize = GetAllocationSize(nSize);
+
+    CPLMutexHolderD( &hAllocatorMutex );
+    std::map<GByte*, GDALRasterBlockSlab*>::iterator oIter =
+        poMapSlabs->upper_bound(static_cast<GByte*>(pData));
+    CPLAssert( oIter != poMapSlabs->begin() );
+    --oIter;
+    GDALRasterBlockSlab* psSlab = oIter->second;
+    CPLAssert( static_cast<GByte*>(pData) < psSlab->pabyBase + psSlab->nSize );
+    CPLAssert( psSlab->psClass->nChunkSize == nChunkSize );
+
+    *static_cast<void**>(pData) = psSlab->pFreeList;
+    psSlab->pFreeList = pData;
+    if( psSlab->nUsed == psSlab->nChunks )
+        GDALRasterBlockSlabAddPartial(psSlab);
+    psSlab->nUsed --;
+
+    nUsedBytes -= nChunkSize;
+    nRequestedBytes -= nSize;
+
+    if( psSlab->nUsed == 0 )
+    {
+        // Keep one free slab per size class for the next allocations
+        GDALRasterBlockSizeClass* psClass = psSlab->psClass;
+        if( psClass->nEmptySlabs > 0 )
+        {
+            GDALRasterBlockSlabRemovePartial(psSlab);
+            GDALRasterBlockSlabFree(psSlab);
+        }
+        else
+            psClass->nEmptySlabs ++;
+    }
+}
+
+/************************************************************************/
+/*                            GetStatistics()                           */
+/************************************************************************/
+
+/**
+ * Return the memory usage of the allocator.
+ *
+ * @param pnReserved number of bytes of the slabs, or NULL.
+ * @param pnUsed number of bytes of the slabs handed out, or NULL.
+ * @param pnRequested number of bytes requested by the blocks, or NULL.
+ *
+ * All values are 0 if the slab allocator is not used.
+ */
+
+void GDALRasterBlockAllocator::GetStatistics( GIntBig* pnReserved,
+                                              GIntBig* pnUsed,
+                                              GIntBig* pnRequested )
+{
+    CPLMutexHolderD( &hAllocatorMutex );
+    if( pnReserved )
+        *pnReserved = nReservedBytes;
+    if( pnUsed )
+        *pnUsed = nUsedBytes;
+    if( pnRequested )
+        *pnRequested = nRequestedBytes;
+}
+
+/************************************************************************/
+/*                          IsSlabAllocator()                           */
+/************************************************************************/
+
+/** Return whether GDAL_RB_ALLOCATOR=SLAB is in effect. */
+
+bool GDALRasterBlockAllocator::IsSlabAllocator()
+{
+    return bSlabAllocator;
+}
+
+/************************************************************************/
+/*                               Cleanup()                              */
+/************************************************************************/
+
+/**
+ * Give the free slabs back to the system.
+ *
+ * Slabs that still have buffers in use, which should not happen once all
+ * the datasets are closed, are kept.
+ */
+
+void GDALRasterBlockAllocator::Cleanup()
+{
+    if( hAllocatorMutex == NULL )
+        return;
+
+    {
+        CPLMutexHolderD( &hAllocatorMutex );
+        if( poMapSlabs != NULL )
+        {
+            std::map<GByte*, GDALRasterBlockSlab*>::iterator oIter =
+                poMapSlabs->begin();
+            while( oIter != poMapSlabs->end() )
+            {
+                GDALRasterBlockSlab* psSlab = oIter->second;
+                ++oIter;
+                if( psSlab->nUsed == 0 )
+                {
+                    GDALRasterBlockSlabRemovePartial(psSlab);
+                    psSlab->psClass->nEmptySlabs --;
+                    GDALRasterBlockSlabFree(psSlab);
+                }
+            }
+            if( !poMapSlabs->empty() )
+            {
+                CPLDebug("GDAL", CPL_FRMT_GIB " bytes of block buffers "
+                         "still in use", nUsedBytes);
+                return;
+            }
+            delete poMapSlabs;
+            poMapSlabs = NULL;
+            delete poMapClasses;
+            poMapClasses = NULL;
+        }
+    }
+
+    CPLDestroyMutex( hAllocatorMutex );
+    hAllocatorMutex = NULL;
+}
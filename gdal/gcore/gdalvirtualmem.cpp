@@ -33,10 +33,160 @@
 #include "cpl_virtualmem.h"
 #include "gdal_priv.h"
 
+#include <vector>
+
 /* To be changed if we go to 64-bit RasterIO coordinates and spacing */
 typedef int coord_type;
 typedef int spacing_type;
 
+/************************************************************************/
+/*                      GDALVirtualMemBlockMapper                       */
+/*                                                                      */
+/*      Maps pages of a view onto the data of the blocks of the block   */
+/*      cache, when a page coincides with a block. While the mapper is  */
+/*      alive, new blocks of its bands are allocated in memory that can */
+/*      be mapped, and a block stays locked while it is mapped.         */
+/************************************************************************/
+
+class GDALVirtualMemBlockMapper
+{
+    std::vector<GDALRasterBand*> apoBands;
+
+  public:
+    explicit GDALVirtualMemBlockMapper( const std::vector<GDALRasterBand*>& apoBandsIn );
+            ~GDALVirtualMemBlockMapper();
+
+    GDALRasterBand* GetBand( int i ) const { return apoBands[i]; }
+
+    static std::vector<GDALRasterBand*> GetMappableBands( GDALDatasetH hDS,
+                                                  GDALRasterBandH hBand,
+                                                  int nBandCount,
+                                                  const int* panBandMap,
+                                                  GDALDataType eBufType,
+                                                  int nBlockXSize,
+                                                  int nBlockYSize,
+                                                  size_t nPageSize );
+    static void*    GetBlockPage( GDALRasterBand* poBand,
+                                  int nXBlockOff, int nYBlockOff,
+                                  size_t nPageSize, void** ppPageHandle );
+    static void     ReleaseBlockPage( void* pPageHandle, int bDirty );
+};
+
+/************************************************************************/
+/*                      GDALVirtualMemBlockMapper()                     */
+/************************************************************************/
+
+GDALVirtualMemBlockMapper::GDALVirtualMemBlockMapper(
+                        const std::vector<GDALRasterBand*>& apoBandsIn ) :
+    apoBands(apoBandsIn)
+{
+    for( size_t i = 0; i < apoBands.size(); i++ )
+        apoBands[i]->poBandBlockCache->AddSharedMemoryView();
+}
+
+/************************************************************************/
+/*                     ~GDALVirtualMemBlockMapper()                     */
+/************************************************************************/
+
+GDALVirtualMemBlockMapper::~GDALVirtualMemBlockMapper()
+{
+    for( size_t i = 0; i < apoBands.size(); i++ )
+        apoBands[i]->poBandBlockCache->RemoveSharedMemoryView();
+}
+
+/************************************************************************/
+/*                            GetBlockPage()                            */
+/************************************************************************/
+
+void* GDALVirtualMemBlockMapper::GetBlockPage( GDALRasterBand* poBand,
+                                               int nXBlockOff, int nYBlockOff,
+                                               size_t nPageSize,
+                                               void** ppPageHandle )
+{
+    GDALRasterBlock* poBlock = poBand->GetLockedBlockRef( nXBlockOff, nYBlockOff );
+    if( poBlock == NULL )
+        return NULL;
+
+    /* A block loaded before the mapper was created is reloaded in memory */
+    /* that can be mapped, unless it has pending modifications */
+    if( !poBlock->HasSharedMemory() && !poBlock->GetDirty() )
+    {
+        poBlock->DropLock();
+        poBand->FlushBlock( nXBlockOff, nYBlockOff, FALSE );
+        poBlock = poBand->GetLockedBlockRef( nXBlockOff, nYBlockOff );
+        if( poBlock == NULL )
+            return NULL;
+    }
+
+    if( !poBlock->HasSharedMemory() ||
+        static_cast<size_t>(poBlock->GetBlockSize()) != nPageSize )
+    {
+        poBlock->DropLock();
+        return NULL;
+    }
+
+    *ppPageHandle = poBlock;
+    return poBlock->GetDataRef();
+}
+
+/************************************************************************/
+/*                          ReleaseBlockPage()                          */
+/************************************************************************/
+
+void GDALVirtualMemBlockMapper::ReleaseBlockPage( void* pPageHandle, int bDirty )
+{
+    GDALRasterBlock* poBlock = static_cast<GDALRasterBlock*>(pPageHandle);
+    if( bDirty )
+        poBlock->MarkDirty();
+    poBlock->DropLock();
+}
+
+/************************************************************************/
+/*                          GetMappableBands()                          */
+/*                                                                      */
+/*      Returns the bands of a view if pages can be mapped onto their   */
+/*      blocks, i.e. if their blocks are nBlockXSize x nBlockYSize      */
+/*      pixels of type eBufType, and nPageSize bytes. Returns an empty  */
+/*      vector otherwise.                                               */
+/************************************************************************/
+
+std::vector<GDALRasterBand*>
+GDALVirtualMemBlockMapper::GetMappableBands( GDALDatasetH hDS,
+                                             GDALRasterBandH hBand,
+                                             int nBandCount,
+                                             const int* panBandMap,
+                                             GDALDataType eBufType,
+                                             int nBlockXSize,
+                                             int nBlockYSize,
+                                             size_t nPageSize )
+{
+    std::vector<GDALRasterBand*> apoBands;
+    const size_t nSystemPageSize = CPLGetPageSize();
+    if( nSystemPageSize == 0 || (nPageSize % nSystemPageSize) != 0 ||
+        static_cast<size_t>(nBlockXSize) * nBlockYSize *
+            (GDALGetDataTypeSize(eBufType) / 8) != nPageSize )
+        return apoBands;
+
+    for( int i = 0; i < ((hDS != NULL) ? nBandCount : 1); i++ )
+    {
+        GDALRasterBand* poBand = (hDS != NULL) ?
+            static_cast<GDALDataset*>(hDS)->GetRasterBand(
+                        panBandMap ? panBandMap[i] : i + 1 ) :
+            static_cast<GDALRasterBand*>(hBand);
+        int nBandBlockXSize, nBandBlockYSize;
+        poBand->GetBlockSize( &nBandBlockXSize, &nBandBlockYSize );
+        if( poBand->GetRasterDataType() != eBufType ||
+            nBandBlockXSize != nBlockXSize || nBandBlockYSize != nBlockYSize ||
+            !poBand->InitBlockInfo() )
+        {
+            apoBands.clear();
+            break;
+        }
+        apoBands.push_back( poBand );
+    }
+    return apoBands;
+}
+
 /************************************************************************/
 /*                            GDALVirtualMem                            */
 /************************************************************************/
@@ -61,6 +211,12 @@ class GDALVirtualMem
     int     bIsCompact;
     int     bIsBandSequential;
 
+    /* Set when pages are mapped onto blocks, that are then strips of */
+    /* the whole width of the raster */
+    GDALVirtualMemBlockMapper* poMapper;
+    int     nYBlockOff;
+    size_t  nBlockPageSize;
+
     int  IsCompact() const { return bIsCompact; }
     int  IsBandSequential() const { return bIsBandSequential; }
 
@@ -100,6 +256,16 @@ public:
                                               const void* pPageToBeEvicted,
                                               size_t nToEvicted, void* pUserData);
 
+    static void* GetSharedPageBandSequential(CPLVirtualMem* ctxt, size_t nOffset,
+                                             void** ppPageHandle,
+                                             void* pUserData);
+    static void ReleaseSharedPage(CPLVirtualMem* ctxt, size_t nOffset,
+                                  void* pPageHandle, int bDirty,
+                                  void* pUserData);
+
+    void SetBlockMapper( GDALVirtualMemBlockMapper* poMapperIn,
+                         int nYBlockOffIn, size_t nBlockPageSizeIn );
+
     static void Destroy(void* pUserData);
 };
 
@@ -121,7 +287,7 @@ GDALVirtualMem::GDALVirtualMem( GDALDatasetH hDSIn,
     hDS(hDSIn), hBand(hBandIn), nXOff(nXOffIn), nYOff(nYOffIn), /*nXSize(nXSize), nYSize(nYSize),*/
     nBufXSize(nBufXSizeIn), nBufYSize(nBufYSizeIn), eBufType(eBufTypeIn),
     nBandCount(nBandCountIn), nPixelSpace(nPixelSpaceIn), nLineSpace(nLineSpaceIn),
-    nBandSpace(nBandSpaceIn)
+    nBandSpace(nBandSpaceIn), poMapper(NULL), nYBlockOff(0), nBlockPageSize(0)
 {
     if( hDS != NULL )
     {
@@ -165,6 +331,20 @@ GDALVirtualMem::GDALVirtualMem( GDALDatasetH hDSIn,
 GDALVirtualMem::~GDALVirtualMem()
 {
     CPLFree(panBandMap);
+    delete poMapper;
+}
+
+/************************************************************************/
+/*                           SetBlockMapper()                           */
+/************************************************************************/
+
+void GDALVirtualMem::SetBlockMapper( GDALVirtualMemBlockMapper* poMapperIn,
+                                     int nYBlockOffIn, size_t nBlockPageSizeIn )
+{
+    delete poMapper;
+    poMapper = poMapperIn;
+    nYBlockOff = nYBlockOffIn;
+    nBlockPageSize = nBlockPageSizeIn;
 }
 
 /************************************************************************/
@@ -572,6 +752,39 @@ void GDALVirtualMem::SaveFromCachePixelInterleaved(CPLVirtualMem*,
     psParms->DoIOPixelInterleaved(GF_Write, nOffset, (void*)pPageToBeEvicted, nToEvicted);
 }
 
+/************************************************************************/
+/*                    GetSharedPageBandSequential()                     */
+/************************************************************************/
+
+void* GDALVirtualMem::GetSharedPageBandSequential(CPLVirtualMem*,
+                  size_t nOffset,
+                  void** ppPageHandle,
+                  void* pUserData)
+{
+    const GDALVirtualMem* psParms = (const GDALVirtualMem* )pUserData;
+    const int iBand = static_cast<int>(nOffset / psParms->nBandSpace);
+    const size_t nOffsetInBand =
+        nOffset - static_cast<size_t>(iBand * psParms->nBandSpace);
+    return GDALVirtualMemBlockMapper::GetBlockPage(
+                psParms->poMapper->GetBand(iBand), 0,
+                psParms->nYBlockOff +
+                    static_cast<int>(nOffsetInBand / psParms->nBlockPageSize),
+                psParms->nBlockPageSize, ppPageHandle);
+}
+
+/************************************************************************/
+/*                          ReleaseSharedPage()                         */
+/************************************************************************/
+
+void GDALVirtualMem::ReleaseSharedPage(CPLVirtualMem*,
+                  size_t /* nOffset */,
+                  void* pPageHandle,
+                  int bDirty,
+                  void* /* pUserData */)
+{
+    GDALVirtualMemBlockMapper::ReleaseBlockPage(pPageHandle, bDirty);
+}
+
 /************************************************************************/
 /*                                Destroy()                             */
 /************************************************************************/
@@ -634,9 +847,9 @@ static CPLVirtualMem* GDALGetVirtualMem( GDALDatasetH hDS,
                                          size_t nCacheSize,
                                          size_t nPageSizeHint,
                                          int bSingleThreadUsage,
-                                         char ** /*papszOptions*/ )
+                                         char **papszOptions )
 {
-    CPLVirtualMem* view;
+    CPLVirtualMem* view = NULL;
     GDALVirtualMem* psParams;
     GUIntBig nReqMem;
 
@@ -739,6 +952,56 @@ static CPLVirtualMem* GDALGetVirtualMem( GDALDatasetH hDS,
                                nLineSpace,
                                nBandSpace);
 
+/* -------------------------------------------------------------------- */
+/*      If the view is made of strips of the whole width of the raster, */
+/*      with the layout of the blocks, map its pages onto the blocks.   */
+/* -------------------------------------------------------------------- */
+    if( bIsBandSequential && nXOff == 0 && nXSize == nRasterXSize &&
+        eBufType == ((hDS) ? GDALGetRasterDataType(GDALGetRasterBand(hDS,
+                                    panBandMap ? panBandMap[0] : 1)) :
+                             GDALGetRasterDataType(hBand)) &&
+        nPixelSpace == nDataTypeSize &&
+        nLineSpace == (GIntBig)nXSize * nDataTypeSize &&
+        CPLTestBool(CSLFetchNameValueDef(papszOptions, "ZERO_COPY", "YES")) )
+    {
+        int nBlockXSize, nBlockYSize;
+        GDALGetBlockSize( (hDS) ? GDALGetRasterBand(hDS,
+                                    panBandMap ? panBandMap[0] : 1) : hBand,
+                          &nBlockXSize, &nBlockYSize );
+        const size_t nBlockPageSize = (size_t)nLineSpace * nBlockYSize;
+        std::vector<GDALRasterBand*> apoBands;
+        if( nBlockXSize == nRasterXSize && (nYOff % nBlockYSize) == 0 &&
+            (nBandCount == 1 || (nBandSpace % nBlockPageSize) == 0) )
+        {
+            apoBands = GDALVirtualMemBlockMapper::GetMappableBands(
+                hDS, hBand, nBandCount, panBandMap, eBufType,
+                nBlockXSize, nBlockYSize, nBlockPageSize );
+        }
+        if( !apoBands.empty() )
+        {
+            psParams->SetBlockMapper( new GDALVirtualMemBlockMapper(apoBands),
+                                      nYOff / nBlockYSize, nBlockPageSize );
+
+            /* Fall back silently to a separate cache if not possible */
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            view = CPLVirtualMemSharedNew((size_t)nReqMem,
+                         nCacheSize,
+                         nBlockPageSize,
+                         bSingleThreadUsage,
+                         (eRWFlag == GF_Read) ? VIRTUALMEM_READONLY_ENFORCED : VIRTUALMEM_READWRITE,
+                         GDALVirtualMem::GetSharedPageBandSequential,
+                         GDALVirtualMem::ReleaseSharedPage,
+                         GDALVirtualMem::FillCacheBandSequential,
+                         GDALVirtualMem::SaveFromCacheBandSequential,
+                         GDALVirtualMem::Destroy,
+                         psParams);
+            CPLPopErrorHandler();
+            if( view != NULL )
+                return view;
+            psParams->SetBlockMapper( NULL, 0, 0 );
+        }
+    }
+
     view = CPLVirtualMemNew((size_t)nReqMem,
                          nCacheSize,
                          nPageSizeHint,
@@ -867,7 +1130,14 @@ static CPLVirtualMem* GDALGetVirtualMem( GDALDatasetH hDS,
  *                           optimize performance a bit. If set to FALSE,
  *                           CPLVirtualMemDeclareThread() must be called.
  *
- * @param papszOptions NULL terminated list of options. Unused for now.
+ * @param papszOptions NULL terminated list of options, or NULL. The only
+ *                     option is ZERO_COPY=YES/NO (default YES): if the view
+ *                     is made of strips of the whole width of the raster,
+ *                     of the data type and block layout of the bands, and
+ *                     the block size is a multiple of the page size, the
+ *                     pages of the view are mapped onto the buffers of the
+ *                     block cache instead of being copied in a separate
+ *                     cache. nPageSizeHint is then ignored.
  *
  * @return a virtual memory object that must be freed by CPLVirtualMemFree(),
  *         or NULL in case of failure.
@@ -991,7 +1261,14 @@ CPLVirtualMem* GDALDatasetGetVirtualMem( GDALDatasetH hDS,
  *                           optimize performance a bit. If set to FALSE,
  *                           CPLVirtualMemDeclareThread() must be called.
  *
- * @param papszOptions NULL terminated list of options. Unused for now.
+ * @param papszOptions NULL terminated list of options, or NULL. The only
+ *                     option is ZERO_COPY=YES/NO (default YES): if the view
+ *                     is made of strips of the whole width of the raster,
+ *                     of the data type and block layout of the bands, and
+ *                     the block size is a multiple of the page size, the
+ *                     pages of the view are mapped onto the buffers of the
+ *                     block cache instead of being copied in a separate
+ *                     cache. nPageSizeHint is then ignored.
  *
  * @return a virtual memory object that must be freed by CPLVirtualMemFree(),
  *         or NULL in case of failure.
@@ -1039,6 +1316,9 @@ class GDALTiledVirtualMem
     int* panBandMap;
     GDALTileOrganization eTileOrganization;
 
+    /* Set when pages are mapped onto blocks, that are then tiles */
+    GDALVirtualMemBlockMapper* poMapper;
+
     void DoIO( GDALRWFlag eRWFlag, size_t nOffset,
                void* pPage, size_t nBytes ) const;
 
@@ -1060,6 +1340,14 @@ public:
                                              const void* pPageToBeEvicted,
                                              size_t nToEvicted, void* pUserData);
 
+    static void* GetSharedPage(CPLVirtualMem* ctxt, size_t nOffset,
+                               void** ppPageHandle, void* pUserData);
+    static void ReleaseSharedPage(CPLVirtualMem* ctxt, size_t nOffset,
+                                  void* pPageHandle, int bDirty,
+                                  void* pUserData);
+
+    void SetBlockMapper( GDALVirtualMemBlockMapper* poMapperIn );
+
     static void Destroy(void* pUserData);
 };
 
@@ -1077,7 +1365,8 @@ GDALTiledVirtualMem::GDALTiledVirtualMem( GDALDatasetH hDSIn,
                                   GDALTileOrganization eTileOrganizationIn ):
     hDS(hDSIn), hBand(hBandIn), nXOff(nXOffIn), nYOff(nYOffIn), nXSize(nXSizeIn), nYSize(nYSizeIn),
     nTileXSize(nTileXSizeIn), nTileYSize(nTileYSizeIn), eBufType(eBufTypeIn),
-    nBandCount(nBandCountIn), eTileOrganization(eTileOrganizationIn)
+    nBandCount(nBandCountIn), eTileOrganization(eTileOrganizationIn),
+    poMapper(NULL)
 {
     if( hDS != NULL )
     {
@@ -1107,6 +1396,17 @@ GDALTiledVirtualMem::GDALTiledVirtualMem( GDALDatasetH hDSIn,
 GDALTiledVirtualMem::~GDALTiledVirtualMem()
 {
     CPLFree(panBandMap);
+    delete poMapper;
+}
+
+/************************************************************************/
+/*                           SetBlockMapper()                           */
+/************************************************************************/
+
+void GDALTiledVirtualMem::SetBlockMapper( GDALVirtualMemBlockMapper* poMapperIn )
+{
+    delete poMapper;
+    poMapper = poMapperIn;
 }
 
 /************************************************************************/
@@ -1210,6 +1510,53 @@ void GDALTiledVirtualMem::SaveFromCache(CPLVirtualMem*,  size_t nOffset,
     psParms->DoIO(GF_Write, nOffset, (void*)pPageToBeEvicted, nToEvicted);
 }
 
+/************************************************************************/
+/*                           GetSharedPage()                            */
+/************************************************************************/
+
+void* GDALTiledVirtualMem::GetSharedPage(CPLVirtualMem*, size_t nOffset,
+                                         void** ppPageHandle, void* pUserData)
+{
+    const GDALTiledVirtualMem* psParms = (const GDALTiledVirtualMem* )pUserData;
+    const size_t nPageSize = static_cast<size_t>(psParms->nTileXSize) *
+        psParms->nTileYSize * (GDALGetDataTypeSize(psParms->eBufType) / 8);
+    const int nTilesPerRow =
+        (psParms->nXSize + psParms->nTileXSize - 1) / psParms->nTileXSize;
+    const int nTilesPerCol =
+        (psParms->nYSize + psParms->nTileYSize - 1) / psParms->nTileYSize;
+    const size_t nTilesPerBand = static_cast<size_t>(nTilesPerRow) * nTilesPerCol;
+
+    const int iBand = static_cast<int>(nOffset / (nPageSize * nTilesPerBand));
+    const size_t nTile = nOffset / nPageSize - iBand * nTilesPerBand;
+    const int nYTile = static_cast<int>(nTile / nTilesPerRow);
+    const int nXTile = static_cast<int>(nTile - static_cast<size_t>(nYTile) * nTilesPerRow);
+
+    /* Partial tiles at the right and bottom of the view are padded with */
+    /* zeroes, not with the content of the block */
+    if( (nXTile + 1) * psParms->nTileXSize > psParms->nXSize ||
+        (nYTile + 1) * psParms->nTileYSize > psParms->nYSize )
+        return NULL;
+
+    return GDALVirtualMemBlockMapper::GetBlockPage(
+                psParms->poMapper->GetBand(iBand),
+                psParms->nXOff / psParms->nTileXSize + nXTile,
+                psParms->nYOff / psParms->nTileYSize + nYTile,
+                nPageSize, ppPageHandle);
+}
+
+/************************************************************************/
+/*                          ReleaseSharedPage()                         */
+/************************************************************************/
+
+void GDALTiledVirtualMem::ReleaseSharedPage(CPLVirtualMem*,
+                  size_t /* nOffset */,
+                  void* pPageHandle,
+                  int bDirty,
+                  void* /* pUserData */)
+{
+    GDALVirtualMemBlockMapper::ReleaseBlockPage(pPageHandle, bDirty);
+}
+
 /************************************************************************/
 /*                                Destroy()                             */
 /************************************************************************/
@@ -1235,9 +1582,9 @@ static CPLVirtualMem* GDALGetTiledVirtualMem( GDALDatasetH hDS,
                                               GDALTileOrganization eTileOrganization,
                                               size_t nCacheSize,
                                               int bSingleThreadUsage,
-                                              char ** /* papszOptions */ )
+                                              char ** papszOptions )
 {
-    CPLVirtualMem* view;
+    CPLVirtualMem* view = NULL;
     GDALTiledVirtualMem* psParams;
 
     size_t nPageSize = CPLGetPageSize();
@@ -1292,6 +1639,42 @@ static CPLVirtualMem* GDALGetTiledVirtualMem( GDALDatasetH hDS,
                                        nBandCount, panBandMap,
                                        eTileOrganization);
 
+/* -------------------------------------------------------------------- */
+/*      If the tiles of the view are the blocks of the bands, map its   */
+/*      pages onto the blocks.                                          */
+/* -------------------------------------------------------------------- */
+    if( (eTileOrganization == GTO_BSQ || nBandCount == 1) &&
+        CPLTestBool(CSLFetchNameValueDef(papszOptions, "ZERO_COPY", "YES")) &&
+        (nXOff % nTileXSize) == 0 && (nYOff % nTileYSize) == 0 )
+    {
+        std::vector<GDALRasterBand*> apoBands =
+            GDALVirtualMemBlockMapper::GetMappableBands(
+                hDS, hBand, nBandCount, panBandMap, eBufType,
+                nTileXSize, nTileYSize, nPageSizeHint );
+        if( !apoBands.empty() )
+        {
+            psParams->SetBlockMapper( new GDALVirtualMemBlockMapper(apoBands) );
+
+            /* Fall back silently to a separate cache if not possible */
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            view = CPLVirtualMemSharedNew((size_t)nReqMem,
+                         nCacheSize,
+                         nPageSizeHint,
+                         bSingleThreadUsage,
+                         (eRWFlag == GF_Read) ? VIRTUALMEM_READONLY_ENFORCED : VIRTUALMEM_READWRITE,
+                         GDALTiledVirtualMem::GetSharedPage,
+                         GDALTiledVirtualMem::ReleaseSharedPage,
+                         GDALTiledVirtualMem::FillCache,
+                         GDALTiledVirtualMem::SaveFromCache,
+                         GDALTiledVirtualMem::Destroy,
+                         psParams);
+            CPLPopErrorHandler();
+            if( view != NULL )
+                return view;
+            psParams->SetBlockMapper( NULL );
+        }
+    }
+
     view = CPLVirtualMemNew((size_t)nReqMem,
                          nCacheSize,
                          nPageSizeHint,
@@ -1416,7 +1799,13 @@ static CPLVirtualMem* GDALGetTiledVirtualMem( GDALDatasetH hDS,
  *                           optimize performance a bit. If set to FALSE,
  *                           CPLVirtualMemDeclareThread() must be called.
  *
- * @param papszOptions NULL terminated list of options. Unused for now.
+ * @param papszOptions NULL terminated list of options, or NULL. The only
+ *                     option is ZERO_COPY=YES/NO (default YES): if the tiles
+ *                     of the view are the blocks of the bands, with their
+ *                     data type, and the tile size is a multiple of the page
+ *                     size, the pages of the view are mapped onto the
+ *                     buffers of the block cache instead of being copied in
+ *                     a separate cache.
  *
  * @return a virtual memory object that must be freed by CPLVirtualMemFree(),
  *         or NULL in case of failure.
@@ -1527,7 +1916,13 @@ CPLVirtualMem* GDALDatasetGetTiledVirtualMem( GDALDatasetH hDS,
  *                           optimize performance a bit. If set to FALSE,
  *                           CPLVirtualMemDeclareThread() must be called.
  *
- * @param papszOptions NULL terminated list of options. Unused for now.
+ * @param papszOptions NULL terminated list of options, or NULL. The only
+ *                     option is ZERO_COPY=YES/NO (default YES): if the tiles
+ *                     of the view are the blocks of the bands, with their
+ *                     data type, and the tile size is a multiple of the page
+ *                     size, the pages of the view are mapped onto the
+ *                     buffers of the block cache instead of being copied in
+ *                     a separate cache.
  *
  * @return a virtual memory object that must be freed by CPLVirtualMemFree(),
  *         or NULL in case of failure.
@@ -28,10 +28,13 @@
  * DEALINGS IN THE SOFTWARE.
  ****************************************************************************/
 
+#include <deque>
 #include <limits>
+#include <vector>
 
 #include "gdal_priv.h"
 #include "gdalwarper.h"
+#include "cpl_worker_thread_pool.h"
 
 CPL_CVSID("$Id$");
 
@@ -1939,6 +1942,14 @@ GDALResampleChunkC32R( int nSrcWidth, int nSrcHeight,
     return eErr;
 }
 
+static bool GDALOvrCanStream( GDALRasterBand *poSrcBand,
+                              int nOverviews, GDALRasterBand **papoOvrBands,
+                              const char * pszResampling );
+static CPLErr GDALRegenerateOverviewsStreaming(
+    GDALRasterBand *poSrcBand, int nOverviews, GDALRasterBand **papoOvrBands,
+    const char * pszResampling,
+    GDALProgressFunc pfnProgress, void * pProgressData );
+
 /************************************************************************/
 /*                  GDALRegenerateCascadingOverviews()                  */
 /*                                                                      */
@@ -1973,6 +1984,19 @@ GDALRegenerateCascadingOverviews(
         }
     }
 
+/* -------------------------------------------------------------------- */
+/*      When possible, compute all the levels while reading the        */
+/*      source once, instead of reading back each level from the        */
+/*      overview band after having written it.                          */
+/* -------------------------------------------------------------------- */
+    if( GDALOvrCanStream( poSrcBand, nOverviews, papoOvrBands,
+                          pszResampling ) )
+        return GDALRegenerateOverviewsStreaming( poSrcBand,
+                                                 nOverviews, papoOvrBands,
+                                                 pszResampling,
+                                                 pfnProgress,
+                                                 pProgressData );
+
 /* -------------------------------------------------------------------- */
 /*      Count total pixels so we can prepare appropriate scaled         */
 /*      progress functions.                                             */
@@ -2253,6 +2277,958 @@ GDALDataType GDALGetOvrWorkDataType(const char* pszResampling,
         return GDT_Float32;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                          GDALOvrBufferBand                           */
+/* ==================================================================== */
+/*                                                                      */
+/*      Band with the dimensions and data type of an overview band,     */
+/*      that is given to the resampling functions by the worker         */
+/*      threads. It captures the lines written in a window of the       */
+/*      overview, that the calling thread then writes into the real     */
+/*      overview band, so that only the calling thread does I/O.        */
+/*      The values are converted to the overview data type with         */
+/*      GDALCopyWords(), as a write in the overview band would do.      */
+/************************************************************************/
+
+class GDALOvrBufferBand : public GDALRasterBand
+{
+    GByte      *pabyData;
+    size_t      nAllocSize;
+    int         nDTSize;
+    int         nWinXOff;
+    int         nWinYOff;
+    int         nWinXSize;
+    int         nWinYSize;
+
+  protected:
+    virtual CPLErr IReadBlock( int, int, void * );
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              GSpacing, GSpacing, GDALRasterIOExtraArg* );
+
+  public:
+    explicit    GDALOvrBufferBand( GDALRasterBand* poOvrBand );
+    virtual    ~GDALOvrBufferBand();
+
+    bool        SetWindow( int nXOff, int nYOff, int nXSize, int nYSize );
+    CPLErr      WriteWindow( GDALRasterBand* poOvrBand );
+    const GByte *GetWindowData() const { return pabyData; }
+};
+
+GDALOvrBufferBand::GDALOvrBufferBand( GDALRasterBand* poOvrBand ) :
+    GDALRasterBand(FALSE),
+    pabyData(NULL),
+    nAllocSize(0),
+    nDTSize(GDALGetDataTypeSize(poOvrBand->GetRasterDataType()) / 8),
+    nWinXOff(0),
+    nWinYOff(0),
+    nWinXSize(0),
+    nWinYSize(0)
+{
+    nRasterXSize = poOvrBand->GetXSize();
+    nRasterYSize = poOvrBand->GetYSize();
+    eDataType = poOvrBand->GetRasterDataType();
+    nBlockXSize = nRasterXSize;
+    nBlockYSize = 1;
+
+    // Used by GDALResampleChunk32R_Convolution()
+    const char* pszNBITS =
+        poOvrBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+    if( pszNBITS )
+        SetMetadataItem("NBITS", pszNBITS, "IMAGE_STRUCTURE");
+}
+
+GDALOvrBufferBand::~GDALOvrBufferBand()
+{
+    VSIFree(pabyData);
+}
+
+bool GDALOvrBufferBand::SetWindow( int nXOff, int nYOff,
+                                   int nXSize, int nYSize )
+{
+    const size_t nSize = static_cast<size_t>(nXSize) * nYSize * nDTSize;
+    if( nSize > nAllocSize )
+    {
+        VSIFree(pabyData);
+        pabyData = static_cast<GByte*>(VSI_MALLOC_VERBOSE(nSize));
+        nAllocSize = pabyData ? nSize : 0;
+        if( pabyData == NULL )
+            return false;
+    }
+    nWinXOff = nXOff;
+    nWinYOff = nYOff;
+    nWinXSize = nXSize;
+    nWinYSize = nYSize;
+    return true;
+}
+
+CPLErr GDALOvrBufferBand::WriteWindow( GDALRasterBand* poOvrBand )
+{
+    if( nWinXSize == 0 || nWinYSize == 0 )
+        return CE_None;
+    return poOvrBand->RasterIO( GF_Write, nWinXOff, nWinYOff,
+                                nWinXSize, nWinYSize,
+                                pabyData, nWinXSize, nWinYSize, eDataType,
+                                0, 0, NULL );
+}
+
+CPLErr GDALOvrBufferBand::IReadBlock( int, int, void * )
+{
+    CPLError( CE_Failure, CPLE_NotSupported,
+              "GDALOvrBufferBand::IReadBlock() not supported" );
+    return CE_Failure;
+}
+
+CPLErr GDALOvrBufferBand::IRasterIO( GDALRWFlag eRWFlag,
+                                     int nXOff, int nYOff,
+                                     int nXSize, int nYSize,
+                                     void * pData,
+                                     int nBufXSize, int nBufYSize,
+                                     GDALDataType eBufType,
+                                     GSpacing nPixelSpace,
+                                     GSpacing nLineSpace,
+                                     GDALRasterIOExtraArg* )
+{
+    if( eRWFlag != GF_Write || nXSize != nBufXSize || nYSize != nBufYSize ||
+        nXOff < nWinXOff || nXOff + nXSize > nWinXOff + nWinXSize ||
+        nYOff < nWinYOff || nYOff + nYSize > nWinYOff + nWinYSize )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "GDALOvrBufferBand::IRasterIO(): unexpected request" );
+        return CE_Failure;
+    }
+
+    for( int iLine = 0; iLine < nYSize; iLine++ )
+    {
+        GDALCopyWords( static_cast<GByte*>(pData) + iLine * nLineSpace,
+                       eBufType, static_cast<int>(nPixelSpace),
+                       pabyData + (static_cast<size_t>(nYOff + iLine - nWinYOff)
+                                        * nWinXSize + nXOff - nWinXOff) * nDTSize,
+                       eDataType, nDTSize, nXSize );
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                           GDALOvrJobQueue                            */
+/* ==================================================================== */
+/*                                                                      */
+/*      Pool of worker threads resampling chunks submitted by the       */
+/*      calling thread, which waits for each of them before writing     */
+/*      its result.                                                     */
+/************************************************************************/
+
+class GDALOvrJobQueue;
+
+struct GDALOvrJob
+{
+    GDALOvrJobQueue *poQueue;
+    volatile bool    bPending;
+    CPLErr           eErr;
+
+    GDALOvrJob() : poQueue(NULL), bPending(false), eErr(CE_None) {}
+};
+
+class GDALOvrJobQueue
+{
+    CPLWorkerThreadPool  oPool;
+    CPLMutex            *hMutex;
+    CPLCond             *hCond;
+
+  public:
+                GDALOvrJobQueue();
+               ~GDALOvrJobQueue();
+
+    bool        Setup( int nThreads );
+    bool        Submit( CPLThreadFunc pfnFunc, GDALOvrJob* psJob );
+    CPLErr      Wait( GDALOvrJob* psJob );
+    void        Done( GDALOvrJob* psJob );
+};
+
+GDALOvrJobQueue::GDALOvrJobQueue() : hMutex(NULL), hCond(NULL)
+{
+}
+
+GDALOvrJobQueue::~GDALOvrJobQueue()
+{
+    oPool.WaitCompletion();
+    if( hCond )
+        CPLDestroyCond(hCond);
+    if( hMutex )
+        CPLDestroyMutex(hMutex);
+}
+
+bool GDALOvrJobQueue::Setup( int nThreads )
+{
+    hMutex = CPLCreateMutex();
+    if( hMutex == NULL )
+        return false;
+    CPLReleaseMutex(hMutex);
+    hCond = CPLCreateCond();
+    return hCond != NULL && oPool.Setup(nThreads, NULL, NULL);
+}
+
+bool GDALOvrJobQueue::Submit( CPLThreadFunc pfnFunc, GDALOvrJob* psJob )
+{
+    psJob->poQueue = this;
+    psJob->eErr = CE_None;
+    psJob->bPending = true;
+    if( !oPool.SubmitJob(pfnFunc, psJob) )
+    {
+        psJob->bPending = false;
+        return false;
+    }
+    return true;
+}
+
+CPLErr GDALOvrJobQueue::Wait( GDALOvrJob* psJob )
+{
+    CPLAcquireMutex(hMutex, 1000.0);
+    while( psJob->bPending )
+        CPLCondWait(hCond, hMutex);
+    CPLReleaseMutex(hMutex);
+    return psJob->eErr;
+}
+
+void GDALOvrJobQueue::Done( GDALOvrJob* psJob )
+{
+    CPLAcquireMutex(hMutex, 1000.0);
+    psJob->bPending = false;
+    CPLCondBroadcast(hCond);
+    CPLReleaseMutex(hMutex);
+}
+
+/************************************************************************/
+/*                         GDALOvrChunkParams                           */
+/*                                                                      */
+/*      Parameters of GDALRegenerateOverviews() shared by all the       */
+/*      chunks of the source band.                                      */
+/************************************************************************/
+
+typedef struct
+{
+    GDALResampleFunction pfnResampleFn;
+    const char         *pszResampling;
+    GDALDataType        eType;
+    int                 nWidth;
+    int                 nHeight;
+    int                 nOverviewCount;
+    GDALRasterBand    **papoOvrBands;
+    int                 bHasNoData;
+    float               fNoDataValue;
+    GDALColorTable     *poColorTable;
+    GDALDataType        eSrcDataType;
+} GDALOvrChunkParams;
+
+/************************************************************************/
+/*                     GDALOvrGetChunkLinesQueried()                    */
+/*                                                                      */
+/*      Source lines to read for a chunk, including the margin needed   */
+/*      by the resampling kernel.                                       */
+/************************************************************************/
+
+static void GDALOvrGetChunkLinesQueried( int nHeight,
+                                         int nChunkYOff, int nFullResYChunk,
+                                         int nMargin,
+                                         int* pnChunkYOffQueried,
+                                         int* pnChunkYSizeQueried )
+{
+    int nChunkYOffQueried = nChunkYOff - nMargin;
+    int nChunkYSizeQueried = nFullResYChunk + 2 * nMargin;
+    if( nChunkYOffQueried < 0 )
+    {
+        nChunkYSizeQueried += nChunkYOffQueried;
+        nChunkYOffQueried = 0;
+    }
+    if( nChunkYOffQueried + nChunkYSizeQueried > nHeight )
+        nChunkYSizeQueried = nHeight - nChunkYOffQueried;
+    *pnChunkYOffQueried = nChunkYOffQueried;
+    *pnChunkYSizeQueried = nChunkYSizeQueried;
+}
+
+/************************************************************************/
+/*                         GDALOvrGetDstLines()                         */
+/************************************************************************/
+
+static void GDALOvrGetDstLines( const GDALOvrChunkParams* psParams,
+                                int iOverview,
+                                int nChunkYOff, int nFullResYChunk,
+                                int* pnDstYOff, int* pnDstYOff2 )
+{
+    const int nDstHeight = psParams->papoOvrBands[iOverview]->GetYSize();
+    const double dfYRatioDstToSrc = (double)psParams->nHeight / nDstHeight;
+
+/* -------------------------------------------------------------------- */
+/*      Figure out the line to start writing to, and the first line     */
+/*      to not write to.  In theory this approach should ensure that    */
+/*      every output line will be written if all input chunks are       */
+/*      processed.                                                      */
+/* -------------------------------------------------------------------- */
+    *pnDstYOff = (int) (0.5 + nChunkYOff/dfYRatioDstToSrc);
+    *pnDstYOff2 = (int)
+        (0.5 + (nChunkYOff+nFullResYChunk)/dfYRatioDstToSrc);
+
+    if( nChunkYOff + nFullResYChunk == psParams->nHeight )
+        *pnDstYOff2 = nDstHeight;
+    //CPLDebug("GDAL", "nDstYOff=%d, nDstYOff2=%d", *pnDstYOff, *pnDstYOff2);
+}
+
+/************************************************************************/
+/*                    GDALRegenerateOverviewsChunk()                    */
+/*                                                                      */
+/*      Resample a chunk of full width source lines into all the        */
+/*      overviews. papoDstBands are either the overview bands, or       */
+/*      GDALOvrBufferBand with the same dimensions.                     */
+/************************************************************************/
+
+static CPLErr GDALRegenerateOverviewsChunk( const GDALOvrChunkParams* psParams,
+                                            void* pChunk,
+                                            GByte* pabyChunkNodataMask,
+                                            int nChunkYOff, int nFullResYChunk,
+                                            int nChunkYOffQueried,
+                                            int nChunkYSizeQueried,
+                                            GDALRasterBand** papoDstBands )
+{
+    const int nWidth = psParams->nWidth;
+    const int nHeight = psParams->nHeight;
+    const GDALDataType eType = psParams->eType;
+    CPLErr eErr = CE_None;
+
+    /* special case to promote 1bit data to 8bit 0/255 values */
+    if( EQUAL(psParams->pszResampling,"AVERAGE_BIT2GRAYSCALE") )
+    {
+        if (eType == GDT_Float32)
+        {
+            float* pafChunk = (float*)pChunk;
+            for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
+            {
+                if( pafChunk[i] == 1.0 )
+                    pafChunk[i] = 255.0;
+            }
+        }
+        else if (eType == GDT_Byte)
+        {
+            GByte* pabyChunk = (GByte*)pChunk;
+            for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
+            {
+                if( pabyChunk[i] == 1 )
+                    pabyChunk[i] = 255;
+            }
+        }
+        else if (eType == GDT_UInt16)
+        {
+            GUInt16* pasChunk = (GUInt16*)pChunk;
+            for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
+            {
+                if( pasChunk[i] == 1 )
+                    pasChunk[i] = 255;
+            }
+        }
+        else {
+            CPLAssert(0);
+        }
+    }
+    else if( EQUAL(psParams->pszResampling,"AVERAGE_BIT2GRAYSCALE_MINISWHITE") )
+    {
+        if (eType == GDT_Float32)
+        {
+            float* pafChunk = (float*)pChunk;
+            for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
+            {
+                if( pafChunk[i] == 1.0 )
+                    pafChunk[i] = 0.0;
+                else if( pafChunk[i] == 0.0 )
+                    pafChunk[i] = 255.0;
+            }
+        }
+        else if (eType == GDT_Byte)
+        {
+            GByte* pabyChunk = (GByte*)pChunk;
+            for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
+            {
+                if( pabyChunk[i] == 1 )
+                    pabyChunk[i] = 0;
+                else if( pabyChunk[i] == 0 )
+                    pabyChunk[i] = 255;
+            }
+        }
+        else if (eType == GDT_UInt16)
+        {
+            GUInt16* pasChunk = (GUInt16*)pChunk;
+            for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
+            {
+                if( pasChunk[i] == 1 )
+                    pasChunk[i] = 0;
+                else if( pasChunk[i] == 0 )
+                    pasChunk[i] = 255;
+            }
+        }
+        else {
+            CPLAssert(0);
+        }
+    }
+
+    for( int iOverview = 0; iOverview < psParams->nOverviewCount && eErr == CE_None; iOverview++ )
+    {
+        const int nDstWidth = psParams->papoOvrBands[iOverview]->GetXSize();
+        const int nDstHeight = psParams->papoOvrBands[iOverview]->GetYSize();
+
+        const double dfXRatioDstToSrc = (double)nWidth / nDstWidth;
+        const double dfYRatioDstToSrc = (double)nHeight / nDstHeight;
+
+        int nDstYOff, nDstYOff2;
+        GDALOvrGetDstLines( psParams, iOverview, nChunkYOff, nFullResYChunk,
+                            &nDstYOff, &nDstYOff2 );
+
+        if( eType == GDT_Byte || eType == GDT_UInt16 || eType == GDT_Float32 )
+            eErr = psParams->pfnResampleFn(dfXRatioDstToSrc, dfYRatioDstToSrc,
+                                   0.0, 0.0,
+                                          eType,
+                                          pChunk,
+                                          pabyChunkNodataMask,
+                                          0, nWidth,
+                                          nChunkYOffQueried, nChunkYSizeQueried,
+                                          0, nDstWidth,
+                                          nDstYOff, nDstYOff2,
+                                          papoDstBands[iOverview],
+                                          psParams->pszResampling,
+                                          psParams->bHasNoData,
+                                          psParams->fNoDataValue,
+                                          psParams->poColorTable,
+                                          psParams->eSrcDataType);
+        else
+            eErr = GDALResampleChunkC32R(nWidth, nHeight,
+                                           (float*)pChunk,
+                                           nChunkYOffQueried, nChunkYSizeQueried,
+                                           nDstYOff, nDstYOff2,
+                                           papoDstBands[iOverview],
+                                           psParams->pszResampling);
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                 GDALRegenerateOverviewsMultiThread()                 */
+/*                                                                      */
+/*      Variant of the chunk loop of GDALRegenerateOverviews() where    */
+/*      the calling thread reads the chunks and writes the resampled    */
+/*      lines in order, while worker threads resample the chunks. The   */
+/*      output is the same as the one of the single threaded loop.      */
+/************************************************************************/
+
+struct GDALOvrChunkJob : public GDALOvrJob
+{
+    const GDALOvrChunkParams       *psParams;
+    void                           *pChunk;
+    GByte                          *pabyChunkNodataMask;
+    int                             nChunkYOff;
+    int                             nFullResYChunk;
+    int                             nChunkYOffQueried;
+    int                             nChunkYSizeQueried;
+    std::vector<GDALRasterBand*>    apoBufferBands;
+
+    GDALOvrChunkJob() : psParams(NULL), pChunk(NULL),
+                        pabyChunkNodataMask(NULL), nChunkYOff(0),
+                        nFullResYChunk(0), nChunkYOffQueried(0),
+                        nChunkYSizeQueried(0) {}
+};
+
+static void GDALOvrChunkJobFunc( void* pData )
+{
+    GDALOvrChunkJob* psJob = static_cast<GDALOvrChunkJob*>(pData);
+    psJob->eErr = GDALRegenerateOverviewsChunk( psJob->psParams,
+                                                psJob->pChunk,
+                                                psJob->pabyChunkNodataMask,
+                                                psJob->nChunkYOff,
+                                                psJob->nFullResYChunk,
+                                                psJob->nChunkYOffQueried,
+                                                psJob->nChunkYSizeQueried,
+                                                &psJob->apoBufferBands[0] );
+    psJob->poQueue->Done( psJob );
+}
+
+static CPLErr GDALOvrWriteChunkJob( GDALOvrJobQueue* poQueue,
+                                    GDALOvrChunkJob* psJob )
+{
+    CPLErr eErr = poQueue->Wait( psJob );
+    for( int iOverview = 0;
+         iOverview < psJob->psParams->nOverviewCount && eErr == CE_None;
+         iOverview++ )
+    {
+        eErr = static_cast<GDALOvrBufferBand*>(
+            psJob->apoBufferBands[iOverview])->WriteWindow(
+                psJob->psParams->papoOvrBands[iOverview] );
+    }
+    return eErr;
+}
+
+static CPLErr
+GDALRegenerateOverviewsMultiThread( const GDALOvrChunkParams* psParams,
+                                    int nThreads,
+                                    GDALRasterBand* poSrcBand,
+                                    GDALRasterBand* poMaskBand,
+                                    int nFullResYChunk,
+                                    int nMaxChunkYSizeQueried,
+                                    int nMargin,
+                                    GDALProgressFunc pfnProgress,
+                                    void * pProgressData )
+{
+    const int nWidth = psParams->nWidth;
+    const int nHeight = psParams->nHeight;
+    const int nOverviewCount = psParams->nOverviewCount;
+
+    // One job being read by the calling thread, and one per worker thread.
+    const int nJobs = nThreads + 1;
+    std::vector<GDALOvrChunkJob> asJobs(nJobs);
+    GDALOvrJobQueue oQueue;
+    CPLErr eErr = oQueue.Setup(nThreads) ? CE_None : CE_Failure;
+
+    for( int i = 0; i < nJobs && eErr == CE_None; i++ )
+    {
+        GDALOvrChunkJob* psJob = &asJobs[i];
+        psJob->psParams = psParams;
+        psJob->pChunk = VSI_MALLOC3_VERBOSE(
+            (GDALGetDataTypeSize(psParams->eType)/8), nMaxChunkYSizeQueried, nWidth );
+        if( psJob->pChunk == NULL )
+            eErr = CE_Failure;
+        if( poMaskBand != NULL )
+        {
+            psJob->pabyChunkNodataMask =
+                (GByte*) VSI_MALLOC2_VERBOSE( nMaxChunkYSizeQueried, nWidth );
+            if( psJob->pabyChunkNodataMask == NULL )
+                eErr = CE_Failure;
+        }
+        for( int iOverview = 0; iOverview < nOverviewCount; iOverview++ )
+        {
+            psJob->apoBufferBands.push_back(
+                new GDALOvrBufferBand(psParams->papoOvrBands[iOverview]) );
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Loop over image operating on chunks.                            */
+/* -------------------------------------------------------------------- */
+    int nSubmittedJobs = 0;
+    for( int nChunkYOff = 0;
+         nChunkYOff < nHeight && eErr == CE_None;
+         nChunkYOff += nFullResYChunk )
+    {
+        if( !pfnProgress( nChunkYOff / (double) nHeight,
+                          NULL, pProgressData ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+            break;
+        }
+
+        if( nFullResYChunk + nChunkYOff > nHeight )
+            nFullResYChunk = nHeight - nChunkYOff;
+
+        // Write the result of the previous user of the job buffers.
+        GDALOvrChunkJob* psJob = &asJobs[nSubmittedJobs % nJobs];
+        if( nSubmittedJobs >= nJobs )
+        {
+            eErr = GDALOvrWriteChunkJob( &oQueue, psJob );
+            if( eErr != CE_None )
+                break;
+        }
+
+        int nChunkYOffQueried, nChunkYSizeQueried;
+        GDALOvrGetChunkLinesQueried( nHeight, nChunkYOff, nFullResYChunk,
+                                     nMargin,
+                                     &nChunkYOffQueried, &nChunkYSizeQueried );
+
+        eErr = poSrcBand->RasterIO( GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
+                                    psJob->pChunk, nWidth, nChunkYSizeQueried,
+                                    psParams->eType,
+                                    0, 0, NULL );
+        if (eErr == CE_None && poMaskBand != NULL)
+            eErr = poMaskBand->RasterIO( GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
+                                psJob->pabyChunkNodataMask, nWidth, nChunkYSizeQueried, GDT_Byte,
+                                0, 0, NULL );
+
+        for( int iOverview = 0;
+             iOverview < nOverviewCount && eErr == CE_None;
+             iOverview++ )
+        {
+            int nDstYOff, nDstYOff2;
+            GDALOvrGetDstLines( psParams, iOverview, nChunkYOff, nFullResYChunk,
+                                &nDstYOff, &nDstYOff2 );
+            if( !static_cast<GDALOvrBufferBand*>(
+                    psJob->apoBufferBands[iOverview])->SetWindow(
+                        0, nDstYOff,
+                        psParams->papoOvrBands[iOverview]->GetXSize(),
+                        nDstYOff2 - nDstYOff) )
+                eErr = CE_Failure;
+        }
+        if( eErr != CE_None )
+            break;
+
+        psJob->nChunkYOff = nChunkYOff;
+        psJob->nFullResYChunk = nFullResYChunk;
+        psJob->nChunkYOffQueried = nChunkYOffQueried;
+        psJob->nChunkYSizeQueried = nChunkYSizeQueried;
+        if( !oQueue.Submit( GDALOvrChunkJobFunc, psJob ) )
+        {
+            eErr = CE_Failure;
+            break;
+        }
+        nSubmittedJobs ++;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the remaining chunks in order, or just wait for them in   */
+/*      case of error.                                                  */
+/* -------------------------------------------------------------------- */
+    for( int i = MAX(0, nSubmittedJobs - nJobs); i < nSubmittedJobs; i++ )
+    {
+        GDALOvrChunkJob* psJob = &asJobs[i % nJobs];
+        if( eErr == CE_None )
+            eErr = GDALOvrWriteChunkJob( &oQueue, psJob );
+        else
+            oQueue.Wait( psJob );
+    }
+
+    for( int i = 0; i < nJobs; i++ )
+    {
+        VSIFree( asJobs[i].pChunk );
+        VSIFree( asJobs[i].pabyChunkNodataMask );
+        for( size_t j = 0; j < asJobs[i].apoBufferBands.size(); j++ )
+            delete asJobs[i].apoBufferBands[j];
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                          GDALOvrCanStream()                          */
+/*                                                                      */
+/*      Whether GDALRegenerateOverviewsStreaming() can replace the      */
+/*      cascading generation of the (sorted) overviews. Each level must */
+/*      be computed as GDALRegenerateOverviews() would do it from the   */
+/*      previous one, so cases involving a mask band, a color table or  */
+/*      complex values are left to the level by level generation. So    */
+/*      is the multi-threaded mode. GDAL_OVR_STREAMING=NO can be used   */
+/*      to disable it.                                                  */
+/*                                                                      */
+/*      The cascading generation computes each level from the values    */
+/*      read back from the previous one, so the overviews must store    */
+/*      exactly the values written: lossy compressions (JPEG, LERC with */
+/*      a MAX_Z_ERROR, ...) and NBITS lower than the data type size are */
+/*      left to it as well.                                             */
+/************************************************************************/
+
+static bool GDALOvrIsLossless( GDALRasterBand *poOvrBand )
+{
+    const char* pszNBits =
+        poOvrBand->GetMetadataItem( "NBITS", "IMAGE_STRUCTURE" );
+    if( pszNBits != NULL && atoi(pszNBits) <
+            GDALGetDataTypeSize(poOvrBand->GetRasterDataType()) )
+        return false;
+
+    const char* pszCompression =
+        poOvrBand->GetMetadataItem( "COMPRESSION", "IMAGE_STRUCTURE" );
+    GDALDataset* poOvrDS = poOvrBand->GetDataset();
+    if( pszCompression == NULL && poOvrDS != NULL )
+        pszCompression =
+            poOvrDS->GetMetadataItem( "COMPRESSION", "IMAGE_STRUCTURE" );
+
+    // The LERC max error of the overviews is not exposed, so assume it is
+    // lossy.
+    return pszCompression == NULL ||
+           EQUAL(pszCompression, "LZW") ||
+           EQUAL(pszCompression, "DEFLATE") ||
+           EQUAL(pszCompression, "PACKBITS") ||
+           EQUAL(pszCompression, "LZMA") ||
+           EQUAL(pszCompression, "ZSTD") ||
+           STARTS_WITH_CI(pszCompression, "CCITT");
+}
+
+static bool GDALOvrCanStream( GDALRasterBand *poSrcBand,
+                              int nOverviews, GDALRasterBand **papoOvrBands,
+                              const char * pszResampling )
+{
+    // AVERAGE_MP corrects each level after having written it
+    if( nOverviews < 2 || GDALGetNumThreads() > 1 ||
+        EQUAL(pszResampling, "AVERAGE_MP") ||
+        !CPLTestBool(CPLGetConfigOption("GDAL_OVR_STREAMING", "YES")) )
+        return false;
+
+    for( int i = 0; i < nOverviews; i++ )
+    {
+        GDALRasterBand* poBaseBand = (i == 0) ? poSrcBand : papoOvrBands[i-1];
+        if( GDALDataTypeIsComplex(poBaseBand->GetRasterDataType()) ||
+            poBaseBand->GetColorInterpretation() == GCI_PaletteIndex ||
+            poBaseBand->GetColorInterpretation() == GCI_AlphaBand )
+            return false;
+        if( !STARTS_WITH_CI(pszResampling, "NEAR") &&
+            (poBaseBand->GetMaskFlags() & GMF_ALL_VALID) == 0 )
+            return false;
+        if( papoOvrBands[i]->GetXSize() > poBaseBand->GetXSize() ||
+            papoOvrBands[i]->GetYSize() > poBaseBand->GetYSize() )
+            return false;
+        // The last level is not read back by the cascading generation
+        if( i + 1 < nOverviews && !GDALOvrIsLossless(papoOvrBands[i]) )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                  GDALRegenerateOverviewsStreaming()                  */
+/*                                                                      */
+/*      Generate a list of overviews sorted from largest to smallest,   */
+/*      computing each from the next larger, like                       */
+/*      GDALRegenerateCascadingOverviews(), but reading the source      */
+/*      only once. The lines of each level are kept in memory until     */
+/*      the next level no longer needs them. Each level is processed    */
+/*      with the chunks GDALRegenerateOverviews() would use, so the     */
+/*      result is the same as the one of the cascading generation.      */
+/************************************************************************/
+
+typedef struct
+{
+    GDALRasterBand     *poBaseBand;
+    GDALOvrChunkParams  sParams;
+    int                 nFullResYChunk;
+    int                 nMargin;
+    void               *pChunk;
+    GDALOvrBufferBand  *poBufferBand;
+
+    // Next chunk to process, in lines of the base band.
+    int                 nNextChunkYOff;
+
+    // Lines of this level already computed, and the ones of them kept in
+    // the overview data type for the computation of the next level, the
+    // first one being line nLinesYOff.
+    int                 nComputedLines;
+    std::deque< std::vector<GByte> > aabyLines;
+    int                 nLinesYOff;
+} GDALOvrStreamLevel;
+
+static CPLErr GDALOvrStreamLevels( std::vector<GDALOvrStreamLevel>& asLevels,
+                                   size_t iLevel,
+                                   GDALProgressFunc pfnProgress,
+                                   void * pProgressData )
+{
+    GDALOvrStreamLevel& sLevel = asLevels[iLevel];
+    const GDALOvrChunkParams* psParams = &sLevel.sParams;
+    const int nWidth = psParams->nWidth;
+    const int nHeight = psParams->nHeight;
+    const int nWrkDTSize = GDALGetDataTypeSize(psParams->eType) / 8;
+    GDALRasterBand* poOvrBand = psParams->papoOvrBands[0];
+    const GDALDataType eOvrDataType = poOvrBand->GetRasterDataType();
+    const int nOvrDTSize = GDALGetDataTypeSize(eOvrDataType) / 8;
+    const int nDstWidth = poOvrBand->GetXSize();
+    const bool bKeepLines = iLevel + 1 < asLevels.size();
+    CPLErr eErr = CE_None;
+
+    while( sLevel.nNextChunkYOff < nHeight && eErr == CE_None )
+    {
+        const int nChunkYOff = sLevel.nNextChunkYOff;
+        const int nFullResYChunk = MIN(sLevel.nFullResYChunk,
+                                       nHeight - nChunkYOff);
+        int nChunkYOffQueried, nChunkYSizeQueried;
+        GDALOvrGetChunkLinesQueried( nHeight, nChunkYOff,
+                                     nFullResYChunk, sLevel.nMargin,
+                                     &nChunkYOffQueried, &nChunkYSizeQueried );
+
+/* -------------------------------------------------------------------- */
+/*      Fetch the source lines, either from the source band, or from    */
+/*      the lines of the previous level when they are all computed.     */
+/* -------------------------------------------------------------------- */
+        if( iLevel == 0 )
+        {
+            if( !pfnProgress( nChunkYOff / (double) nHeight,
+                              NULL, pProgressData ) )
+            {
+                CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+                return CE_Failure;
+            }
+
+            eErr = sLevel.poBaseBand->RasterIO(
+                GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
+                sLevel.pChunk, nWidth, nChunkYSizeQueried, psParams->eType,
+                0, 0, NULL );
+            if( eErr != CE_None )
+                return eErr;
+        }
+        else
+        {
+            const GDALOvrStreamLevel& sPrevLevel = asLevels[iLevel-1];
+            if( nChunkYOffQueried + nChunkYSizeQueried >
+                                            sPrevLevel.nComputedLines )
+                break;
+
+            const GDALDataType ePrevDataType =
+                sPrevLevel.sParams.papoOvrBands[0]->GetRasterDataType();
+            const int nPrevDTSize = GDALGetDataTypeSize(ePrevDataType) / 8;
+            CPLAssert( nChunkYOffQueried >= sPrevLevel.nLinesYOff );
+            for( int iLine = 0; iLine < nChunkYSizeQueried; iLine++ )
+            {
+                GDALCopyWords( &sPrevLevel.aabyLines[
+                        nChunkYOffQueried + iLine - sPrevLevel.nLinesYOff][0],
+                    ePrevDataType, nPrevDTSize,
+                    (GByte*)sLevel.pChunk + (size_t)iLine * nWidth * nWrkDTSize,
+                    psParams->eType, nWrkDTSize, nWidth );
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Compute and write the lines of the overview.                    */
+/* -------------------------------------------------------------------- */
+        int nDstYOff, nDstYOff2;
+        GDALOvrGetDstLines( psParams, 0, nChunkYOff, nFullResYChunk,
+                            &nDstYOff, &nDstYOff2 );
+        CPLAssert( nDstYOff == sLevel.nComputedLines );
+        if( !sLevel.poBufferBand->SetWindow( 0, nDstYOff, nDstWidth,
+                                             nDstYOff2 - nDstYOff ) )
+            return CE_Failure;
+        GDALRasterBand* poBufferBand = sLevel.poBufferBand;
+        eErr = GDALRegenerateOverviewsChunk( psParams, sLevel.pChunk, NULL,
+                                             nChunkYOff, nFullResYChunk,
+                                             nChunkYOffQueried,
+                                             nChunkYSizeQueried,
+                                             &poBufferBand );
+        if( eErr == CE_None )
+            eErr = sLevel.poBufferBand->WriteWindow( poOvrBand );
+        if( eErr != CE_None )
+            return eErr;
+
+        if( bKeepLines )
+        {
+            const GByte* pabyData = sLevel.poBufferBand->GetWindowData();
+            const size_t nLineBytes = (size_t)nDstWidth * nOvrDTSize;
+            for( int iLine = nDstYOff; iLine < nDstYOff2; iLine++ )
+            {
+                sLevel.aabyLines.push_back( std::vector<GByte>(
+                    pabyData, pabyData + nLineBytes ) );
+                pabyData += nLineBytes;
+            }
+        }
+        sLevel.nComputedLines = nDstYOff2;
+        sLevel.nNextChunkYOff += sLevel.nFullResYChunk;
+
+/* -------------------------------------------------------------------- */
+/*      Discard the lines of the previous level that the next chunks    */
+/*      do not need anymore.                                            */
+/* -------------------------------------------------------------------- */
+        if( iLevel > 0 && sLevel.nNextChunkYOff < nHeight )
+        {
+            GDALOvrStreamLevel& sPrevLevel = asLevels[iLevel-1];
+            GDALOvrGetChunkLinesQueried( nHeight, sLevel.nNextChunkYOff,
+                                         sLevel.nFullResYChunk, sLevel.nMargin,
+                                         &nChunkYOffQueried,
+                                         &nChunkYSizeQueried );
+            while( sPrevLevel.nLinesYOff < nChunkYOffQueried )
+            {
+                sPrevLevel.aabyLines.pop_front();
+                sPrevLevel.nLinesYOff++;
+            }
+        }
+
+        if( bKeepLines )
+        {
+            eErr = GDALOvrStreamLevels( asLevels, iLevel + 1,
+                                        pfnProgress, pProgressData );
+        }
+    }
+
+    return eErr;
+}
+
+static CPLErr GDALRegenerateOverviewsStreaming(
+    GDALRasterBand *poSrcBand, int nOverviews, GDALRasterBand **papoOvrBands,
+    const char * pszResampling,
+    GDALProgressFunc pfnProgress, void * pProgressData )
+{
+    int nKernelRadius;
+    GDALResampleFunction pfnResampleFn
+        = GDALGetResampleFunction(pszResampling, &nKernelRadius);
+    if (pfnResampleFn == NULL)
+        return CE_Failure;
+
+    CPLErr eErr = CE_None;
+    std::vector<GDALOvrStreamLevel> asLevels(nOverviews);
+    for( int i = 0; i < nOverviews; i++ )
+    {
+        GDALOvrStreamLevel& sLevel = asLevels[i];
+        GDALRasterBand* poBaseBand = (i == 0) ? poSrcBand : papoOvrBands[i-1];
+        sLevel.poBaseBand = poBaseBand;
+
+        // Same chunking as in GDALRegenerateOverviews()
+        int nFRXBlockSize, nFRYBlockSize;
+        poBaseBand->GetBlockSize( &nFRXBlockSize, &nFRYBlockSize );
+        if( nFRYBlockSize < 16 || nFRYBlockSize > 256 )
+            sLevel.nFullResYChunk = 64;
+        else
+            sLevel.nFullResYChunk = nFRYBlockSize;
+
+        const int nWidth = poBaseBand->GetXSize();
+        const int nHeight = poBaseBand->GetYSize();
+        const int nDstWidth = papoOvrBands[i]->GetXSize();
+        const int nDstHeight = papoOvrBands[i]->GetYSize();
+        int nOvrFactor = 1;
+        nOvrFactor = MAX( nOvrFactor, (int)((double)nWidth / nDstWidth + 0.5) );
+        nOvrFactor = MAX( nOvrFactor, (int)((double)nHeight / nDstHeight + 0.5) );
+        sLevel.nMargin = nKernelRadius * nOvrFactor;
+
+        GDALOvrChunkParams* psParams = &sLevel.sParams;
+        psParams->pfnResampleFn = pfnResampleFn;
+        // We only do the bit2grayscale promotion on the base band
+        psParams->pszResampling =
+            (i > 0 && STARTS_WITH_CI(pszResampling,"AVERAGE_BIT2G")) ?
+                                                "AVERAGE" : pszResampling;
+        psParams->eType = GDALGetOvrWorkDataType(psParams->pszResampling,
+                                            poBaseBand->GetRasterDataType());
+        psParams->nWidth = nWidth;
+        psParams->nHeight = nHeight;
+        psParams->nOverviewCount = 1;
+        psParams->papoOvrBands = papoOvrBands + i;
+        psParams->bHasNoData = FALSE;
+        psParams->fNoDataValue =
+            (float) poBaseBand->GetNoDataValue(&psParams->bHasNoData);
+        psParams->poColorTable = NULL;
+        psParams->eSrcDataType = poBaseBand->GetRasterDataType();
+
+        sLevel.pChunk = VSI_MALLOC3_VERBOSE(
+            GDALGetDataTypeSize(psParams->eType) / 8,
+            sLevel.nFullResYChunk + 2 * sLevel.nMargin, nWidth );
+        if( sLevel.pChunk == NULL )
+            eErr = CE_Failure;
+        sLevel.poBufferBand = new GDALOvrBufferBand(papoOvrBands[i]);
+        sLevel.nNextChunkYOff = 0;
+        sLevel.nComputedLines = 0;
+        sLevel.nLinesYOff = 0;
+    }
+
+    if( eErr == CE_None )
+        eErr = GDALOvrStreamLevels( asLevels, 0, pfnProgress, pProgressData );
+
+    for( int i = 0; i < nOverviews; i++ )
+    {
+        if( eErr == CE_None &&
+            asLevels[i].nComputedLines != papoOvrBands[i]->GetYSize() )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Not all lines of overview %d have been computed", i );
+            eErr = CE_Failure;
+        }
+        VSIFree( asLevels[i].pChunk );
+        delete asLevels[i].poBufferBand;
+        if( eErr == CE_None )
+            papoOvrBands[i]->FlushCache();
+    }
+
+    if( eErr == CE_None )
+        pfnProgress( 1.0, NULL, pProgressData );
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                      GDALRegenerateOverviews()                       */
 /************************************************************************/
@@ -2271,6 +3247,12 @@ GDALDataType GDALGetOvrWorkDataType(const char* pszResampling,
  * The full set of resampling algorithms is documented in
  * GDALDataset::BuildOverviews().
  *
+ * The GDAL_NUM_THREADS configuration option can be set to a number of
+ * threads, or ALL_CPUS, so that the resampling is done by worker threads,
+ * while the reading of the source and the writing of the overviews stay in
+ * the calling thread. The result is the same as with a single thread.
+ * (GDAL >= 2.2)
+ *
  * This function will honour properly NODATA_VALUES tuples (special dataset metadata) so
  * that only a given RGB triplet (in case of a RGB image) will be considered as the
  * nodata value and not each value of the triplet independently per band.
@@ -2428,185 +3410,101 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     }
     const int nMaxChunkYSizeQueried = nFullResYChunk + 2 * nKernelRadius * nMaxOvrFactor;
 
-    GByte *pabyChunkNodataMask = NULL;
-    void *pChunk =
-        VSI_MALLOC3_VERBOSE((GDALGetDataTypeSize(eType)/8), nMaxChunkYSizeQueried, nWidth );
-    if (bUseNoDataMask)
-    {
-        pabyChunkNodataMask =
-            (GByte*) VSI_MALLOC2_VERBOSE( nMaxChunkYSizeQueried, nWidth );
-    }
-
-    if( pChunk == NULL || (bUseNoDataMask && pabyChunkNodataMask == NULL))
-    {
-        CPLFree(pChunk);
-        CPLFree(pabyChunkNodataMask);
-        return CE_Failure;
-    }
-
     int bHasNoData;
     const float fNoDataValue = (float) poSrcBand->GetNoDataValue(&bHasNoData);
 
-/* -------------------------------------------------------------------- */
-/*      Loop over image operating on chunks.                            */
-/* -------------------------------------------------------------------- */
-    int  nChunkYOff = 0;
+    GDALOvrChunkParams sParams;
+    sParams.pfnResampleFn = pfnResampleFn;
+    sParams.pszResampling = pszResampling;
+    sParams.eType = eType;
+    sParams.nWidth = nWidth;
+    sParams.nHeight = nHeight;
+    sParams.nOverviewCount = nOverviewCount;
+    sParams.papoOvrBands = papoOvrBands;
+    sParams.bHasNoData = bHasNoData;
+    sParams.fNoDataValue = fNoDataValue;
+    sParams.poColorTable = poColorTable;
+    sParams.eSrcDataType = poSrcBand->GetRasterDataType();
+
     CPLErr eErr = CE_None;
 
-    for( nChunkYOff = 0;
-         nChunkYOff < nHeight && eErr == CE_None;
-         nChunkYOff += nFullResYChunk )
+/* -------------------------------------------------------------------- */
+/*      Resample the chunks in worker threads if asked to.              */
+/* -------------------------------------------------------------------- */
+    const int nThreads = GDALGetNumThreads();
+    if( nThreads > 1 && nHeight > nFullResYChunk )
     {
-        if( !pfnProgress( nChunkYOff / (double) nHeight,
-                          NULL, pProgressData ) )
+        eErr = GDALRegenerateOverviewsMultiThread( &sParams, nThreads,
+                                    poSrcBand,
+                                    bUseNoDataMask ? poMaskBand : NULL,
+                                    nFullResYChunk, nMaxChunkYSizeQueried,
+                                    nKernelRadius * nMaxOvrFactor,
+                                    pfnProgress, pProgressData );
+    }
+    else
+    {
+        GByte *pabyChunkNodataMask = NULL;
+        void *pChunk =
+            VSI_MALLOC3_VERBOSE((GDALGetDataTypeSize(eType)/8), nMaxChunkYSizeQueried, nWidth );
+        if (bUseNoDataMask)
         {
-            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-            eErr = CE_Failure;
+            pabyChunkNodataMask =
+                (GByte*) VSI_MALLOC2_VERBOSE( nMaxChunkYSizeQueried, nWidth );
         }
 
-        if( nFullResYChunk + nChunkYOff > nHeight )
-            nFullResYChunk = nHeight - nChunkYOff;
-
-        int nChunkYOffQueried = nChunkYOff - nKernelRadius * nMaxOvrFactor;
-        int nChunkYSizeQueried = nFullResYChunk + 2 * nKernelRadius * nMaxOvrFactor;
-        if( nChunkYOffQueried < 0 )
+        if( pChunk == NULL || (bUseNoDataMask && pabyChunkNodataMask == NULL))
         {
-            nChunkYSizeQueried += nChunkYOffQueried;
-            nChunkYOffQueried = 0;
+            CPLFree(pChunk);
+            CPLFree(pabyChunkNodataMask);
+            return CE_Failure;
         }
-        if( nChunkYOffQueried + nChunkYSizeQueried > nHeight )
-            nChunkYSizeQueried = nHeight - nChunkYOffQueried;
 
-        /* read chunk */
-        if (eErr == CE_None)
-            eErr = poSrcBand->RasterIO( GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
-                                pChunk, nWidth, nChunkYSizeQueried, eType,
-                                0, 0, NULL );
-        if (eErr == CE_None && bUseNoDataMask)
-            eErr = poMaskBand->RasterIO( GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
-                                pabyChunkNodataMask, nWidth, nChunkYSizeQueried, GDT_Byte,
-                                0, 0, NULL );
+    /* -------------------------------------------------------------------- */
+    /*      Loop over image operating on chunks.                            */
+    /* -------------------------------------------------------------------- */
+        int  nChunkYOff = 0;
 
-        /* special case to promote 1bit data to 8bit 0/255 values */
-        if( EQUAL(pszResampling,"AVERAGE_BIT2GRAYSCALE") )
+        for( nChunkYOff = 0;
+             nChunkYOff < nHeight && eErr == CE_None;
+             nChunkYOff += nFullResYChunk )
         {
-            if (eType == GDT_Float32)
-            {
-                float* pafChunk = (float*)pChunk;
-                for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
-                {
-                    if( pafChunk[i] == 1.0 )
-                        pafChunk[i] = 255.0;
-                }
-            }
-            else if (eType == GDT_Byte)
-            {
-                GByte* pabyChunk = (GByte*)pChunk;
-                for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
-                {
-                    if( pabyChunk[i] == 1 )
-                        pabyChunk[i] = 255;
-                }
-            }
-            else if (eType == GDT_UInt16)
-            {
-                GUInt16* pasChunk = (GUInt16*)pChunk;
-                for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
-                {
-                    if( pasChunk[i] == 1 )
-                        pasChunk[i] = 255;
-                }
-            }
-            else {
-                CPLAssert(0);
-            }
-        }
-        else if( EQUAL(pszResampling,"AVERAGE_BIT2GRAYSCALE_MINISWHITE") )
-        {
-            if (eType == GDT_Float32)
-            {
-                float* pafChunk = (float*)pChunk;
-                for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
-                {
-                    if( pafChunk[i] == 1.0 )
-                        pafChunk[i] = 0.0;
-                    else if( pafChunk[i] == 0.0 )
-                        pafChunk[i] = 255.0;
-                }
-            }
-            else if (eType == GDT_Byte)
-            {
-                GByte* pabyChunk = (GByte*)pChunk;
-                for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
-                {
-                    if( pabyChunk[i] == 1 )
-                        pabyChunk[i] = 0;
-                    else if( pabyChunk[i] == 0 )
-                        pabyChunk[i] = 255;
-                }
-            }
-            else if (eType == GDT_UInt16)
+            if( !pfnProgress( nChunkYOff / (double) nHeight,
+                              NULL, pProgressData ) )
             {
-                GUInt16* pasChunk = (GUInt16*)pChunk;
-                for( int i = nChunkYSizeQueried*nWidth - 1; i >= 0; i-- )
-                {
-                    if( pasChunk[i] == 1 )
-                        pasChunk[i] = 0;
-                    else if( pasChunk[i] == 0 )
-                        pasChunk[i] = 255;
-                }
-            }
-            else {
-                CPLAssert(0);
+                CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+                eErr = CE_Failure;
             }
-        }
-
-        for( int iOverview = 0; iOverview < nOverviewCount && eErr == CE_None; iOverview++ )
-        {
-            const int nDstWidth = papoOvrBands[iOverview]->GetXSize();
-            const int nDstHeight = papoOvrBands[iOverview]->GetYSize();
 
-            const double dfXRatioDstToSrc = (double)nWidth / nDstWidth;
-            const double dfYRatioDstToSrc = (double)nHeight / nDstHeight;
-
-/* -------------------------------------------------------------------- */
-/*      Figure out the line to start writing to, and the first line     */
-/*      to not write to.  In theory this approach should ensure that    */
-/*      every output line will be written if all input chunks are       */
-/*      processed.                                                      */
-/* -------------------------------------------------------------------- */
-            int nDstYOff = (int) (0.5 + nChunkYOff/dfYRatioDstToSrc);
-            int nDstYOff2 = (int)
-                (0.5 + (nChunkYOff+nFullResYChunk)/dfYRatioDstToSrc);
-
-            if( nChunkYOff + nFullResYChunk == nHeight )
-                nDstYOff2 = nDstHeight;
-            //CPLDebug("GDAL", "nDstYOff=%d, nDstYOff2=%d", nDstYOff, nDstYOff2);
-
-            if( eType == GDT_Byte || eType == GDT_UInt16 || eType == GDT_Float32 )
-                eErr = pfnResampleFn(dfXRatioDstToSrc, dfYRatioDstToSrc,
-                                       0.0, 0.0,
-                                              eType,
-                                              pChunk,
-                                              pabyChunkNodataMask,
-                                              0, nWidth,
-                                              nChunkYOffQueried, nChunkYSizeQueried,
-                                              0, nDstWidth,
-                                              nDstYOff, nDstYOff2,
-                                              papoOvrBands[iOverview], pszResampling,
-                                              bHasNoData, fNoDataValue, poColorTable,
-                                              poSrcBand->GetRasterDataType());
-            else
-                eErr = GDALResampleChunkC32R(nWidth, nHeight,
-                                               (float*)pChunk,
-                                               nChunkYOffQueried, nChunkYSizeQueried,
-                                               nDstYOff, nDstYOff2,
-                                               papoOvrBands[iOverview], pszResampling);
+            if( nFullResYChunk + nChunkYOff > nHeight )
+                nFullResYChunk = nHeight - nChunkYOff;
+
+            int nChunkYOffQueried, nChunkYSizeQueried;
+            GDALOvrGetChunkLinesQueried( nHeight, nChunkYOff, nFullResYChunk,
+                                         nKernelRadius * nMaxOvrFactor,
+                                         &nChunkYOffQueried, &nChunkYSizeQueried );
+
+            /* read chunk */
+            if (eErr == CE_None)
+                eErr = poSrcBand->RasterIO( GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
+                                    pChunk, nWidth, nChunkYSizeQueried, eType,
+                                    0, 0, NULL );
+            if (eErr == CE_None && bUseNoDataMask)
+                eErr = poMaskBand->RasterIO( GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
+                                    pabyChunkNodataMask, nWidth, nChunkYSizeQueried, GDT_Byte,
+                                    0, 0, NULL );
+
+            if (eErr == CE_None)
+                eErr = GDALRegenerateOverviewsChunk( &sParams,
+                                                     pChunk, pabyChunkNodataMask,
+                                                     nChunkYOff, nFullResYChunk,
+                                                     nChunkYOffQueried,
+                                                     nChunkYSizeQueried,
+                                                     papoOvrBands );
         }
-    }
 
-    VSIFree( pChunk );
-    VSIFree( pabyChunkNodataMask );
+        VSIFree( pChunk );
+        VSIFree( pabyChunkNodataMask );
+    }
 
 /* -------------------------------------------------------------------- */
 /*      Renormalized overview mean / stddev if needed.                  */
@@ -2637,6 +3535,104 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
 
 
 
+/************************************************************************/
+/*                        GDALOvrMultiBandJob                           */
+/*                                                                      */
+/*      Source chunks of all the bands for one block of an overview     */
+/*      level of GDALRegenerateOverviewsMultiBand(), and the bands the  */
+/*      resampled block is written into.                                */
+/************************************************************************/
+
+struct GDALOvrMultiBandJob : public GDALOvrJob
+{
+    GDALResampleFunction            pfnResampleFn;
+    const char                     *pszResampling;
+    GDALDataType                    eWrkDataType;
+    GDALDataType                    eSrcDataType;
+    const int                      *pabHasNoData;
+    const float                    *pafNoDataValue;
+    double                          dfXRatioDstToSrc;
+    double                          dfYRatioDstToSrc;
+
+    std::vector<void*>              apChunk;
+    GByte                          *pabyChunkNoDataMask;
+    int                             nChunkXOffQueried;
+    int                             nChunkXSizeQueried;
+    int                             nChunkYOffQueried;
+    int                             nChunkYSizeQueried;
+    int                             nDstXOff;
+    int                             nDstXCount;
+    int                             nDstYOff;
+    int                             nDstYCount;
+
+    // Overview bands, or GDALOvrBufferBand in multi-threaded mode.
+    std::vector<GDALRasterBand*>    apoDstBands;
+    std::vector<GDALOvrBufferBand*> apoBufferBands;
+
+    GDALOvrMultiBandJob() : pfnResampleFn(NULL), pszResampling(NULL),
+                            eWrkDataType(GDT_Unknown),
+                            eSrcDataType(GDT_Unknown),
+                            pabHasNoData(NULL), pafNoDataValue(NULL),
+                            dfXRatioDstToSrc(0.0), dfYRatioDstToSrc(0.0),
+                            pabyChunkNoDataMask(NULL),
+                            nChunkXOffQueried(0), nChunkXSizeQueried(0),
+                            nChunkYOffQueried(0), nChunkYSizeQueried(0),
+                            nDstXOff(0), nDstXCount(0),
+                            nDstYOff(0), nDstYCount(0) {}
+};
+
+static CPLErr GDALOvrResampleMultiBandBlock( GDALOvrMultiBandJob* psJob )
+{
+    CPLErr eErr = CE_None;
+    for( size_t iBand = 0;
+         iBand < psJob->apoDstBands.size() && eErr == CE_None; iBand++ )
+    {
+        eErr = psJob->pfnResampleFn( psJob->dfXRatioDstToSrc,
+                                     psJob->dfYRatioDstToSrc,
+                                     0.0, 0.0,
+                                     psJob->eWrkDataType,
+                                     psJob->apChunk[iBand],
+                                     psJob->pabyChunkNoDataMask,
+                                     psJob->nChunkXOffQueried,
+                                     psJob->nChunkXSizeQueried,
+                                     psJob->nChunkYOffQueried,
+                                     psJob->nChunkYSizeQueried,
+                                     psJob->nDstXOff,
+                                     psJob->nDstXOff + psJob->nDstXCount,
+                                     psJob->nDstYOff,
+                                     psJob->nDstYOff + psJob->nDstYCount,
+                                     psJob->apoDstBands[iBand],
+                                     psJob->pszResampling,
+                                     psJob->pabHasNoData[iBand],
+                                     psJob->pafNoDataValue[iBand],
+                                     /*poColorTable*/ NULL,
+                                     psJob->eSrcDataType );
+    }
+    return eErr;
+}
+
+static void GDALOvrMultiBandJobFunc( void* pData )
+{
+    GDALOvrMultiBandJob* psJob = static_cast<GDALOvrMultiBandJob*>(pData);
+    psJob->eErr = GDALOvrResampleMultiBandBlock( psJob );
+    psJob->poQueue->Done( psJob );
+}
+
+static CPLErr GDALOvrWriteMultiBandJob( GDALOvrJobQueue* poQueue,
+                                        GDALOvrMultiBandJob* psJob,
+                                        GDALRasterBand*** papapoOverviewBands,
+                                        int iOverview )
+{
+    CPLErr eErr = poQueue->Wait( psJob );
+    for( size_t iBand = 0;
+         iBand < psJob->apoBufferBands.size() && eErr == CE_None; iBand++ )
+    {
+        eErr = psJob->apoBufferBands[iBand]->WriteWindow(
+                            papapoOverviewBands[iBand][iOverview] );
+    }
+    return eErr;
+}
+
 /************************************************************************/
 /*            GDALRegenerateOverviewsMultiBand()                        */
 /************************************************************************/
@@ -2664,6 +3660,12 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
  *               read the source data of size deltax * deltay for all the bands
  *               generate the corresponding overview block for all the bands
  *
+ * The GDAL_NUM_THREADS configuration option can be set to a number of
+ * threads, or ALL_CPUS, so that the resampling is done by worker threads,
+ * while the reading of the source and the writing of the overviews stay in
+ * the calling thread. The result is the same as with a single thread.
+ * (GDAL >= 2.2)
+ *
  * This function will honour properly NODATA_VALUES tuples (special dataset metadata) so
  * that only a given RGB triplet (in case of a RGB image) will be considered as the
  * nodata value and not each value of the triplet independently per band.
@@ -2799,9 +3801,16 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
         pafNoDataValue[iBand] = (float) papoSrcBands[iBand]->GetNoDataValue(&pabHasNoData[iBand]);
     }
 
+    /* Jobs are resampled by worker threads when GDAL_NUM_THREADS > 1 */
+    const int nThreads = GDALGetNumThreads();
+    const int nJobs = nThreads > 1 ? nThreads + 1 : 1;
+    GDALOvrJobQueue oQueue;
+    CPLErr eErr = CE_None;
+    if( nThreads > 1 && !oQueue.Setup(nThreads) )
+        eErr = CE_Failure;
+
     /* Second pass to do the real job ! */
     double dfCurPixelCount = 0;
-    CPLErr eErr = CE_None;
     for(int iOverview=0;iOverview<nOverviews && eErr == CE_None;iOverview++)
     {
         int iSrcOverview = -1; /* -1 means the source bands */
@@ -2835,43 +3844,43 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
         int nFullResXChunkQueried = nFullResXChunk + 2 * nKernelRadius * nOvrFactor;
         int nFullResYChunkQueried = nFullResYChunk + 2 * nKernelRadius * nOvrFactor;
 
-        void** papaChunk = (void**) VSI_MALLOC_VERBOSE(nBands * sizeof(void*));
-        if( papaChunk == NULL )
+        std::vector<GDALOvrMultiBandJob> asJobs(nJobs);
+        for( int iJob = 0; iJob < nJobs; iJob++ )
         {
-            CPLFree(pabHasNoData);
-            CPLFree(pafNoDataValue);
-            return CE_Failure;
-        }
-        GByte* pabyChunkNoDataMask = NULL;
-        for(int iBand=0;iBand<nBands;iBand++)
-        {
-            papaChunk[iBand] = VSI_MALLOC3_VERBOSE(nFullResXChunkQueried, nFullResYChunkQueried, GDALGetDataTypeSize(eWrkDataType) / 8);
-            if( papaChunk[iBand] == NULL )
-            {
-                while ( --iBand >= 0)
-                    CPLFree(papaChunk[iBand]);
-                CPLFree(papaChunk);
-                CPLFree(pabHasNoData);
-                CPLFree(pafNoDataValue);
-                return CE_Failure;
-            }
-        }
-        if (bUseNoDataMask)
-        {
-            pabyChunkNoDataMask = (GByte*) VSI_MALLOC2_VERBOSE(nFullResXChunkQueried, nFullResYChunkQueried);
-            if( pabyChunkNoDataMask == NULL )
+            GDALOvrMultiBandJob* psJob = &asJobs[iJob];
+            psJob->pfnResampleFn = pfnResampleFn;
+            psJob->pszResampling = pszResampling;
+            psJob->eWrkDataType = eWrkDataType;
+            psJob->eSrcDataType = eDataType;
+            psJob->pabHasNoData = pabHasNoData;
+            psJob->pafNoDataValue = pafNoDataValue;
+            psJob->dfXRatioDstToSrc = dfXRatioDstToSrc;
+            psJob->dfYRatioDstToSrc = dfYRatioDstToSrc;
+            for(int iBand=0;iBand<nBands;iBand++)
             {
-                for(int iBand=0;iBand<nBands;iBand++)
+                void* pChunk = VSI_MALLOC3_VERBOSE(nFullResXChunkQueried, nFullResYChunkQueried, GDALGetDataTypeSize(eWrkDataType) / 8);
+                if( pChunk == NULL )
+                    eErr = CE_Failure;
+                psJob->apChunk.push_back(pChunk);
+                if( nThreads > 1 )
                 {
-                    CPLFree(papaChunk[iBand]);
+                    GDALOvrBufferBand* poBufferBand =
+                        new GDALOvrBufferBand(papapoOverviewBands[iBand][iOverview]);
+                    psJob->apoBufferBands.push_back(poBufferBand);
+                    psJob->apoDstBands.push_back(poBufferBand);
                 }
-                CPLFree(papaChunk);
-                CPLFree(pabHasNoData);
-                CPLFree(pafNoDataValue);
-                return CE_Failure;
+                else
+                    psJob->apoDstBands.push_back(papapoOverviewBands[iBand][iOverview]);
+            }
+            if (bUseNoDataMask)
+            {
+                psJob->pabyChunkNoDataMask = (GByte*) VSI_MALLOC2_VERBOSE(nFullResXChunkQueried, nFullResYChunkQueried);
+                if( psJob->pabyChunkNoDataMask == NULL )
+                    eErr = CE_Failure;
             }
         }
 
+        int nSubmittedJobs = 0;
         int nDstYOff;
         /* Iterate on destination overview, block by block */
         for( nDstYOff = 0; nDstYOff < nDstHeight && eErr == CE_None; nDstYOff += nDstBlockYSize )
@@ -2938,6 +3947,17 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
                          nChunkXOff, nChunkYOff, nXCount, nYCount,
                          nDstXOff, nDstYOff, nDstXCount, nDstYCount);*/
 
+                /* Write the result of the previous user of the job buffers */
+                GDALOvrMultiBandJob* psJob = &asJobs[nSubmittedJobs % nJobs];
+                if( nThreads > 1 && nSubmittedJobs >= nJobs )
+                {
+                    eErr = GDALOvrWriteMultiBandJob( &oQueue, psJob,
+                                                     papapoOverviewBands,
+                                                     iOverview );
+                    if( eErr != CE_None )
+                        break;
+                }
+
                 /* Read the source buffers for all the bands */
                 for(int iBand=0;iBand<nBands && eErr == CE_None;iBand++)
                 {
@@ -2949,7 +3969,7 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
                     eErr = poSrcBand->RasterIO( GF_Read,
                                                 nChunkXOffQueried, nChunkYOffQueried,
                                                 nChunkXSizeQueried, nChunkYSizeQueried,
-                                                papaChunk[iBand],
+                                                psJob->apChunk[iBand],
                                                 nChunkXSizeQueried, nChunkYSizeQueried,
                                                 eWrkDataType, 0, 0, NULL );
                 }
@@ -2964,44 +3984,73 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
                     eErr = poSrcBand->GetMaskBand()->RasterIO( GF_Read,
                                                                nChunkXOffQueried, nChunkYOffQueried,
                                                                nChunkXSizeQueried, nChunkYSizeQueried,
-                                                               pabyChunkNoDataMask,
+                                                               psJob->pabyChunkNoDataMask,
                                                                nChunkXSizeQueried, nChunkYSizeQueried,
                                                                GDT_Byte, 0, 0, NULL );
                 }
+                if( eErr != CE_None )
+                    break;
+
+                psJob->nChunkXOffQueried = nChunkXOffQueried;
+                psJob->nChunkXSizeQueried = nChunkXSizeQueried;
+                psJob->nChunkYOffQueried = nChunkYOffQueried;
+                psJob->nChunkYSizeQueried = nChunkYSizeQueried;
+                psJob->nDstXOff = nDstXOff;
+                psJob->nDstXCount = nDstXCount;
+                psJob->nDstYOff = nDstYOff;
+                psJob->nDstYCount = nDstYCount;
 
                 /* Compute the resulting overview block */
-                for(int iBand=0;iBand<nBands && eErr == CE_None;iBand++)
+                if( nThreads > 1 )
                 {
-                    eErr = pfnResampleFn(   dfXRatioDstToSrc, dfYRatioDstToSrc,
-                                            0.0, 0.0,
-                                            eWrkDataType,
-                                            papaChunk[iBand],
-                                            pabyChunkNoDataMask,
-                                            nChunkXOffQueried, nChunkXSizeQueried,
-                                            nChunkYOffQueried, nChunkYSizeQueried,
-                                            nDstXOff, nDstXOff + nDstXCount,
-                                            nDstYOff, nDstYOff + nDstYCount,
-                                            papapoOverviewBands[iBand][iOverview],
-                                            pszResampling,
-                                            pabHasNoData[iBand],
-                                            pafNoDataValue[iBand],
-                                            /*poColorTable*/ NULL,
-                                            eDataType);
+                    for(int iBand=0;iBand<nBands && eErr == CE_None;iBand++)
+                    {
+                        if( !psJob->apoBufferBands[iBand]->SetWindow(
+                                nDstXOff, nDstYOff, nDstXCount, nDstYCount) )
+                            eErr = CE_Failure;
+                    }
+                    if( eErr == CE_None &&
+                        !oQueue.Submit( GDALOvrMultiBandJobFunc, psJob ) )
+                        eErr = CE_Failure;
                 }
+                else
+                    eErr = GDALOvrResampleMultiBandBlock( psJob );
+                if( eErr == CE_None )
+                    nSubmittedJobs ++;
             }
 
             dfCurPixelCount += (double)nYCount * nSrcWidth;
         }
 
+        /* Write the remaining blocks in order, or just wait for them in */
+        /* case of error */
+        for( int i = MAX(0, nSubmittedJobs - nJobs);
+             nThreads > 1 && i < nSubmittedJobs; i++ )
+        {
+            GDALOvrMultiBandJob* psJob = &asJobs[i % nJobs];
+            if( eErr == CE_None )
+                eErr = GDALOvrWriteMultiBandJob( &oQueue, psJob,
+                                                 papapoOverviewBands,
+                                                 iOverview );
+            else
+                oQueue.Wait( psJob );
+        }
+
+        for( int iJob = 0; iJob < nJobs; iJob++ )
+        {
+            GDALOvrMultiBandJob* psJob = &asJobs[iJob];
+            for( size_t i = 0; i < psJob->apChunk.size(); i++ )
+                CPLFree(psJob->apChunk[i]);
+            for( size_t i = 0; i < psJob->apoBufferBands.size(); i++ )
+                delete psJob->apoBufferBands[i];
+            CPLFree(psJob->pabyChunkNoDataMask);
+        }
+
         /* Flush the data to overviews */
         for(int iBand=0;iBand<nBands;iBand++)
         {
-            CPLFree(papaChunk[iBand]);
             papapoOverviewBands[iBand][iOverview]->FlushCache();
         }
-        CPLFree(papaChunk);
-        CPLFree(pabyChunkNoDataMask);
-
     }
 
     CPLFree(pabHasNoData);
@@ -34,6 +34,7 @@
 #include "vrtdataset.h"
 #include "memdataset.h"
 #include "gdalwarper.h"
+#include "cpl_worker_thread_pool.h"
 
 #include <stdexcept>
 #include <limits>
@@ -77,6 +78,15 @@ CPLErr GDALRasterBand::IRasterIO( GDALRWFlag eRWFlag,
         return CE_Failure;
     }
 
+    /* Schedule the reading of the next window if the requests follow */
+    /* each other */
+    if( eRWFlag == GF_Read && nXSize == nBufXSize && nYSize == nBufYSize &&
+        GDALBlockPrefetcher::IsEnabled() )
+    {
+        GDALBlockPrefetcher::NotifyRasterIO( this, nXOff, nYOff,
+                                             nXSize, nYSize );
+    }
+
 /* ==================================================================== */
 /*      A common case is the data requested with the destination        */
 /*      is packed, and the block width is the raster width.             */
@@ -2196,6 +2206,127 @@ static inline void GDALFastByteCopy(GByte* CPL_RESTRICT pabyDest,
     }
 }
 
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+
+/************************************************************************/
+/*                        GDALHaveRuntimeAVX2()                         */
+/************************************************************************/
+
+#define CPUID_OSXSAVE_ECX_BIT   27
+#define CPUID_AVX_ECX_BIT       28
+#define CPUID_AVX2_EBX_BIT      5
+
+#define BIT_XMM_STATE           (1 << 1)
+#define BIT_YMM_STATE           (2 << 1)
+
+#if defined(__GNUC__) && (defined(__i386__) ||defined(__x86_64))
+
+#if defined(__x86_64)
+#define GDAL_CPUID(level, subleaf, a, b, c, d)  \
+  __asm__ ("xchgq %%rbx, %q1\n"                 \
+           "cpuid\n"                            \
+           "xchgq %%rbx, %q1"                   \
+       : "=a" (a), "=r" (b), "=c" (c), "=d" (d) \
+       : "0" (level), "2" (subleaf))
+#else
+#define GDAL_CPUID(level, subleaf, a, b, c, d)  \
+  __asm__ ("xchgl %%ebx, %1\n"                  \
+           "cpuid\n"                            \
+           "xchgl %%ebx, %1"                    \
+       : "=a" (a), "=r" (b), "=c" (c), "=d" (d) \
+       : "0" (level), "2" (subleaf))
+#endif
+
+static bool GDALHaveRuntimeAVX2()
+{
+    int cpuinfo[4] = {0,0,0,0};
+    GDAL_CPUID(0, 0, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+    if( cpuinfo[0] < 7 )
+        return false;
+
+    /* Check OSXSAVE and AVX features */
+    GDAL_CPUID(1, 0, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+    if( (cpuinfo[2] & (1 << CPUID_OSXSAVE_ECX_BIT)) == 0 ||
+        (cpuinfo[2] & (1 << CPUID_AVX_ECX_BIT)) == 0 )
+    {
+        return false;
+    }
+
+    /* Issue XGETBV and check the XMM and YMM state bit */
+    unsigned int nXCRLow;
+    unsigned int nXCRHigh;
+    __asm__ ("xgetbv" : "=a" (nXCRLow), "=d" (nXCRHigh) : "c" (0));
+    if( (nXCRLow & ( BIT_XMM_STATE | BIT_YMM_STATE )) !=
+                   ( BIT_XMM_STATE | BIT_YMM_STATE ) )
+    {
+        return false;
+    }
+
+    /* Check AVX2 feature */
+    GDAL_CPUID(7, 0, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+    return (cpuinfo[1] & (1 << CPUID_AVX2_EBX_BIT)) != 0;
+}
+
+#elif defined(_MSC_FULL_VER) && (_MSC_FULL_VER >= 160040219) && (defined(_M_IX86) || defined(_M_X64))
+
+#include <intrin.h>
+
+static bool GDALHaveRuntimeAVX2()
+{
+    int cpuinfo[4] = {0,0,0,0};
+    __cpuid(cpuinfo, 0);
+    if( cpuinfo[0] < 7 )
+        return false;
+
+    /* Check OSXSAVE and AVX features */
+    __cpuid(cpuinfo, 1);
+    if( (cpuinfo[2] & (1 << CPUID_OSXSAVE_ECX_BIT)) == 0 ||
+        (cpuinfo[2] & (1 << CPUID_AVX_ECX_BIT)) == 0 )
+    {
+        return false;
+    }
+
+    /* Issue XGETBV and check the XMM and YMM state bit */
+    unsigned __int64 xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+    if( (xcrFeatureMask & ( BIT_XMM_STATE | BIT_YMM_STATE )) !=
+                          ( BIT_XMM_STATE | BIT_YMM_STATE ) )
+    {
+        return false;
+    }
+
+    /* Check AVX2 feature */
+    __cpuidex(cpuinfo, 7, 0);
+    return (cpuinfo[1] & (1 << CPUID_AVX2_EBX_BIT)) != 0;
+}
+
+#else
+
+static bool GDALHaveRuntimeAVX2()
+{
+    return false;
+}
+
+#endif
+
+/************************************************************************/
+/*                       GDALCopyWordsUseAVX2()                         */
+/************************************************************************/
+
+/* The AVX2 code path can be disabled with GDAL_USE_AVX2=NO, for example */
+/* to compare performance with the non-AVX2 code path. */
+static bool GDALCopyWordsUseAVX2()
+{
+    static int nUseAVX2 = -1;
+    if( nUseAVX2 < 0 )
+    {
+        nUseAVX2 = GDALHaveRuntimeAVX2() &&
+                   CPLTestBool(CPLGetConfigOption("GDAL_USE_AVX2", "YES"));
+    }
+    return nUseAVX2 != 0;
+}
+
+#endif /* HAVE_AVX2_AT_COMPILE_TIME */
+
 /************************************************************************/
 /*                           GDALCopyWords()                            */
 /************************************************************************/
@@ -2333,6 +2464,24 @@ GDALCopyWords( const void * CPL_RESTRICT pSrcData, GDALDataType eSrcType, int nS
         }
     }
 
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+    // Convert as many words as possible with AVX2, and let the generic code
+    // below deal with the remaining ones.
+    if( nWordCount >= 16 && eSrcType != eDstType && GDALCopyWordsUseAVX2() )
+    {
+        const int nDone = GDALCopyWordsAVX2(pSrcData, eSrcType, nSrcPixelStride,
+                                            pDstData, eDstType, nDstPixelStride,
+                                            nWordCount);
+        if( nDone == nWordCount )
+            return;
+        pSrcData = static_cast<const GByte*>(pSrcData) +
+                                    static_cast<GPtrDiff_t>(nDone) * nSrcPixelStride;
+        pDstData = static_cast<GByte*>(pDstData) +
+                                    static_cast<GPtrDiff_t>(nDone) * nDstPixelStride;
+        nWordCount -= nDone;
+    }
+#endif
+
     // Handle the more general case -- deals with conversion of data types
     // directly.
     switch (eSrcType)
@@ -3160,7 +3309,8 @@ static void GDALCopyWholeRasterGetSwathSize(GDALRasterBand *poSrcPrototypeBand,
                                             GDALRasterBand *poDstPrototypeBand,
                                             int nBandCount,
                                             int bDstIsCompressed, int bInterleave,
-                                            int* pnSwathCols, int *pnSwathLines)
+                                            int* pnSwathCols, int *pnSwathLines,
+                                            int nSwathBufferCount = 1)
 {
     GDALDataType eDT = poDstPrototypeBand->GetRasterDataType();
     int nSrcBlockXSize, nSrcBlockYSize;
@@ -3198,8 +3348,10 @@ static void GDALCopyWholeRasterGetSwathSize(GDALRasterBand *poSrcPrototypeBand,
         nTargetSwathSize = atoi(pszSwathSize);
     else
     {
-        /* As a default, take one 1/4 of the cache size */
-        nTargetSwathSize = (int)MIN(INT_MAX, GDALGetCacheMax64() / 4);
+        /* As a default, take one 1/4 of the cache size, shared by all */
+        /* the swath buffers in flight in the pipelined case */
+        nTargetSwathSize = (int)MIN(INT_MAX,
+                            GDALGetCacheMax64() / 4 / nSwathBufferCount);
 
         /* but if the minimum idal swath buf size is less, then go for it to */
         /* avoid unnecessarily abusing RAM usage */
@@ -3351,6 +3503,329 @@ static void GDALCopyWholeRasterGetSwathSize(GDALRasterBand *poSrcPrototypeBand,
     *pnSwathLines = nSwathLines;
 }
 
+/************************************************************************/
+/*                    GDALCopyWholeRasterPipelined()                    */
+/*                                                                      */
+/*      Pipelined variant of GDALDatasetCopyWholeRaster(). A reader     */
+/*      thread reads the swaths of the source dataset into a ring of    */
+/*      swath buffers, a pool of worker threads converts them to the    */
+/*      target data type if needed, and the calling thread writes them  */
+/*      in order into the target dataset. Each dataset is thus only     */
+/*      accessed by a single thread at a time.                          */
+/************************************************************************/
+
+typedef struct
+{
+    int nBand; /* 0 for all bands (interleaved case) */
+    int nXOff;
+    int nYOff;
+    int nXSize;
+    int nYSize;
+} GDALCopySwath;
+
+typedef enum
+{
+    COPY_SWATH_FREE,
+    COPY_SWATH_READ,
+    COPY_SWATH_READY
+} GDALCopySwathState;
+
+typedef struct
+{
+    CPLErr      eErrClass;
+    CPLErrorNum nErrNo;
+    CPLString   osMsg;
+} GDALCopyError;
+
+struct GDALCopyPipeline;
+
+typedef struct
+{
+    GDALCopyPipeline*            psPipeline;
+    int                          iSwath;
+    volatile GDALCopySwathState  eState;
+    void*                        pSrcBuf; /* NULL if no conversion */
+    void*                        pDstBuf;
+} GDALCopySlot;
+
+struct GDALCopyPipeline
+{
+    GDALDataset*                poSrcDS;
+    int                         nBandCount;
+    GDALDataType                eSrcDT;
+    GDALDataType                eDT;
+    std::vector<GDALCopySwath>  asSwaths;
+    std::vector<GDALCopySlot>   asSlots;
+    CPLWorkerThreadPool*        poPool;
+    CPLMutex*                   hMutex;
+    CPLCond*                    hCond;
+    volatile bool               bStop;
+    volatile bool               bReadError;
+    std::vector<GDALCopyError>  asReadErrors;
+};
+
+/* Errors emitted by the reader thread are collected, and re-emitted in the */
+/* calling thread, so that they reach its error handlers. */
+static void CPL_STDCALL GDALCopyPipelineErrorHandler( CPLErr eErrClass,
+                                                      CPLErrorNum nErrNo,
+                                                      const char* pszMsg )
+{
+    GDALCopyPipeline* psPipeline =
+        (GDALCopyPipeline*) CPLGetErrorHandlerUserData();
+    if( eErrClass == CE_Debug )
+    {
+        CPLDefaultErrorHandler( eErrClass, nErrNo, pszMsg );
+        return;
+    }
+    GDALCopyError sError;
+    sError.eErrClass = eErrClass;
+    sError.nErrNo = nErrNo;
+    sError.osMsg = pszMsg;
+    CPLMutexHolderD( &(psPipeline->hMutex) );
+    psPipeline->asReadErrors.push_back(sError);
+}
+
+static void GDALCopyPipelineConvertJob( void* pData )
+{
+    GDALCopySlot* psSlot = (GDALCopySlot*) pData;
+    GDALCopyPipeline* psPipeline = psSlot->psPipeline;
+    const GDALCopySwath& sSwath = psPipeline->asSwaths[psSlot->iSwath];
+
+    const int nWords = sSwath.nXSize * sSwath.nYSize *
+                       (sSwath.nBand == 0 ? psPipeline->nBandCount : 1);
+    GDALCopyWords( psSlot->pSrcBuf, psPipeline->eSrcDT,
+                   GDALGetDataTypeSize(psPipeline->eSrcDT) / 8,
+                   psSlot->pDstBuf, psPipeline->eDT,
+                   GDALGetDataTypeSize(psPipeline->eDT) / 8,
+                   nWords );
+
+    CPLAcquireMutex( psPipeline->hMutex, 1000.0 );
+    psSlot->eState = COPY_SWATH_READY;
+    CPLCondBroadcast( psPipeline->hCond );
+    CPLReleaseMutex( psPipeline->hMutex );
+}
+
+static void GDALCopyPipelineReaderThread( void* pData )
+{
+    GDALCopyPipeline* psPipeline = (GDALCopyPipeline*) pData;
+    const size_t nSlots = psPipeline->asSlots.size();
+
+    CPLPushErrorHandlerEx( GDALCopyPipelineErrorHandler, psPipeline );
+
+    for( size_t i = 0; i < psPipeline->asSwaths.size(); i++ )
+    {
+        GDALCopySlot* psSlot = &(psPipeline->asSlots[i % nSlots]);
+
+        CPLAcquireMutex( psPipeline->hMutex, 1000.0 );
+        while( !psPipeline->bStop && psSlot->eState != COPY_SWATH_FREE )
+            CPLCondWait( psPipeline->hCond, psPipeline->hMutex );
+        const bool bStop = psPipeline->bStop;
+        CPLReleaseMutex( psPipeline->hMutex );
+        if( bStop )
+            break;
+
+        const GDALCopySwath& sSwath = psPipeline->asSwaths[i];
+        const bool bConvert = psSlot->pSrcBuf != NULL;
+        int nBand = sSwath.nBand;
+        CPLErr eErr = psPipeline->poSrcDS->RasterIO( GF_Read,
+                            sSwath.nXOff, sSwath.nYOff,
+                            sSwath.nXSize, sSwath.nYSize,
+                            bConvert ? psSlot->pSrcBuf : psSlot->pDstBuf,
+                            sSwath.nXSize, sSwath.nYSize,
+                            bConvert ? psPipeline->eSrcDT : psPipeline->eDT,
+                            nBand == 0 ? psPipeline->nBandCount : 1,
+                            nBand == 0 ? NULL : &nBand,
+                            0, 0, 0, NULL );
+
+        CPLAcquireMutex( psPipeline->hMutex, 1000.0 );
+        psSlot->iSwath = static_cast<int>(i);
+        if( eErr != CE_None )
+            psPipeline->bReadError = true;
+        else
+            psSlot->eState = bConvert ? COPY_SWATH_READ : COPY_SWATH_READY;
+        CPLCondBroadcast( psPipeline->hCond );
+        CPLReleaseMutex( psPipeline->hMutex );
+
+        if( eErr != CE_None )
+            break;
+        if( bConvert )
+            psPipeline->poPool->SubmitJob( GDALCopyPipelineConvertJob, psSlot );
+    }
+
+    CPLPopErrorHandler();
+}
+
+static CPLErr GDALCopyWholeRasterPipelined( GDALDataset* poSrcDS,
+                                            GDALDataset* poDstDS,
+                                            GDALDataType eSrcDT,
+                                            GDALDataType eDT,
+                                            int bInterleave,
+                                            int nSwathCols, int nSwathLines,
+                                            int nConvertThreads,
+                                            GDALProgressFunc pfnProgress,
+                                            void *pProgressData )
+{
+    const int nXSize = poDstDS->GetRasterXSize();
+    const int nYSize = poDstDS->GetRasterYSize();
+
+    GDALCopyPipeline sPipeline;
+    sPipeline.poSrcDS = poSrcDS;
+    sPipeline.nBandCount = poDstDS->GetRasterCount();
+    sPipeline.eSrcDT = eSrcDT;
+    sPipeline.eDT = eDT;
+    sPipeline.poPool = NULL;
+    sPipeline.hMutex = NULL;
+    sPipeline.hCond = NULL;
+    sPipeline.bStop = false;
+    sPipeline.bReadError = false;
+
+/* -------------------------------------------------------------------- */
+/*      Enumerate the swaths in the order of the serial implementation. */
+/* -------------------------------------------------------------------- */
+    const int nBandIterations = bInterleave ? 1 : sPipeline.nBandCount;
+    for( int iBand = 0; iBand < nBandIterations; iBand++ )
+    {
+        for( int iY = 0; iY < nYSize; iY += nSwathLines )
+        {
+            for( int iX = 0; iX < nXSize; iX += nSwathCols )
+            {
+                GDALCopySwath sSwath;
+                sSwath.nBand = bInterleave ? 0 : iBand + 1;
+                sSwath.nXOff = iX;
+                sSwath.nYOff = iY;
+                sSwath.nXSize = MIN(nSwathCols, nXSize - iX);
+                sSwath.nYSize = MIN(nSwathLines, nYSize - iY);
+                sPipeline.asSwaths.push_back(sSwath);
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Allocate the ring of swath buffers: one being read, one being   */
+/*      written, and one per conversion thread.                         */
+/* -------------------------------------------------------------------- */
+    const bool bConvert = eSrcDT != eDT;
+    const int nBandsPerSwath = bInterleave ? sPipeline.nBandCount : 1;
+    const int nSlots = nConvertThreads + 2;
+    CPLErr eErr = CE_None;
+    sPipeline.asSlots.resize(nSlots);
+    for( int i = 0; i < nSlots; i++ )
+    {
+        GDALCopySlot* psSlot = &(sPipeline.asSlots[i]);
+        psSlot->psPipeline = &sPipeline;
+        psSlot->iSwath = -1;
+        psSlot->eState = COPY_SWATH_FREE;
+        psSlot->pSrcBuf = NULL;
+        psSlot->pDstBuf = VSI_MALLOC3_VERBOSE(nSwathCols, nSwathLines,
+                            nBandsPerSwath * (GDALGetDataTypeSize(eDT) / 8));
+        if( psSlot->pDstBuf == NULL )
+            eErr = CE_Failure;
+        else if( bConvert )
+        {
+            psSlot->pSrcBuf = VSI_MALLOC3_VERBOSE(nSwathCols, nSwathLines,
+                            nBandsPerSwath * (GDALGetDataTypeSize(eSrcDT) / 8));
+            if( psSlot->pSrcBuf == NULL )
+                eErr = CE_Failure;
+        }
+    }
+
+    if( eErr == CE_None && bConvert )
+    {
+        sPipeline.poPool = new CPLWorkerThreadPool();
+        if( !sPipeline.poPool->Setup(nConvertThreads, NULL, NULL) )
+            eErr = CE_Failure;
+    }
+
+    CPLJoinableThread* hReaderThread = NULL;
+    if( eErr == CE_None )
+    {
+        sPipeline.hMutex = CPLCreateMutex();
+        CPLReleaseMutex(sPipeline.hMutex);
+        sPipeline.hCond = CPLCreateCond();
+        hReaderThread = CPLCreateJoinableThread(GDALCopyPipelineReaderThread,
+                                                &sPipeline);
+        if( hReaderThread == NULL )
+            eErr = CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the swaths in order as soon as they are ready.            */
+/* -------------------------------------------------------------------- */
+    const int nTotalBlocks = static_cast<int>(sPipeline.asSwaths.size());
+    for( int i = 0; i < nTotalBlocks && eErr == CE_None; i++ )
+    {
+        GDALCopySlot* psSlot = &(sPipeline.asSlots[i % nSlots]);
+
+        CPLAcquireMutex( sPipeline.hMutex, 1000.0 );
+        while( psSlot->eState != COPY_SWATH_READY && !sPipeline.bReadError )
+            CPLCondWait( sPipeline.hCond, sPipeline.hMutex );
+        const bool bReadError = sPipeline.bReadError;
+        CPLReleaseMutex( sPipeline.hMutex );
+        if( bReadError )
+        {
+            eErr = CE_Failure;
+            break;
+        }
+
+        const GDALCopySwath& sSwath = sPipeline.asSwaths[i];
+        int nBand = sSwath.nBand;
+        eErr = poDstDS->RasterIO( GF_Write,
+                                  sSwath.nXOff, sSwath.nYOff,
+                                  sSwath.nXSize, sSwath.nYSize,
+                                  psSlot->pDstBuf,
+                                  sSwath.nXSize, sSwath.nYSize,
+                                  eDT,
+                                  nBand == 0 ? sPipeline.nBandCount : 1,
+                                  nBand == 0 ? NULL : &nBand,
+                                  0, 0, 0, NULL );
+
+        CPLAcquireMutex( sPipeline.hMutex, 1000.0 );
+        psSlot->eState = COPY_SWATH_FREE;
+        CPLCondBroadcast( sPipeline.hCond );
+        CPLReleaseMutex( sPipeline.hMutex );
+
+        if( eErr == CE_None
+            && !pfnProgress( (i + 1) / (double)nTotalBlocks,
+                             NULL, pProgressData ) )
+        {
+            eErr = CE_Failure;
+            CPLError( CE_Failure, CPLE_UserInterrupt,
+                      "User terminated CreateCopy()" );
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Stop the reader (in case of error), and wait for all threads.   */
+/* -------------------------------------------------------------------- */
+    if( hReaderThread != NULL )
+    {
+        CPLAcquireMutex( sPipeline.hMutex, 1000.0 );
+        sPipeline.bStop = true;
+        CPLCondBroadcast( sPipeline.hCond );
+        CPLReleaseMutex( sPipeline.hMutex );
+        CPLJoinThread( hReaderThread );
+    }
+    delete sPipeline.poPool;
+
+    for( size_t i = 0; i < sPipeline.asReadErrors.size(); i++ )
+    {
+        const GDALCopyError& sError = sPipeline.asReadErrors[i];
+        CPLError( sError.eErrClass, sError.nErrNo, "%s", sError.osMsg.c_str() );
+    }
+
+    for( int i = 0; i < nSlots; i++ )
+    {
+        CPLFree( sPipeline.asSlots[i].pSrcBuf );
+        CPLFree( sPipeline.asSlots[i].pDstBuf );
+    }
+    if( sPipeline.hCond != NULL )
+        CPLDestroyCond( sPipeline.hCond );
+    if( sPipeline.hMutex != NULL )
+        CPLDestroyMutex( sPipeline.hMutex );
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                     GDALDatasetCopyWholeRaster()                     */
 /************************************************************************/
@@ -3373,6 +3848,17 @@ static void GDALCopyWholeRasterGetSwathSize(GDALRasterBand *poSrcPrototypeBand,
  * on target dataset block sizes to achieve best compression.  More options may be supported in
  * the future.
  *
+ * Starting with GDAL 2.2, "NUM_THREADS=number_of_threads" or
+ * "NUM_THREADS=ALL_CPUS" can be used to pipeline the copy when it is set to
+ * at least 2. The GDAL_NUM_THREADS configuration option is not taken into
+ * account, so the pipeline is only used when the caller asks for it.
+ * The source dataset is then read in a dedicated thread while the
+ * calling thread writes the previous swaths into the target dataset, and
+ * the conversion between the source and target data types is done by
+ * NUM_THREADS - 2 additional worker threads. The source and target datasets
+ * must not share any underlying object (file handle, ...), as they will
+ * be accessed concurrently.
+ *
  * @param hSrcDS the source dataset
  * @param hDstDS the destination dataset
  * @param papszOptions transfer hints in "StringList" Name=Value format.
@@ -3466,6 +3952,40 @@ CPLErr CPL_STDCALL GDALDatasetCopyWholeRaster(
     if (pszDstCompressed != NULL && CPLTestBool(pszDstCompressed))
         bDstIsCompressed = TRUE;
 
+/* -------------------------------------------------------------------- */
+/*      Do we want to pipeline reading, conversion and writing ?        */
+/* -------------------------------------------------------------------- */
+    /* Only done on explicit request of the caller, as it knows whether */
+    /* the source and target datasets can be accessed concurrently */
+    const char* pszNumThreads =
+        CSLFetchNameValueDef( papszOptions, "NUM_THREADS", "1" );
+    int nThreads;
+    if( EQUAL(pszNumThreads, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszNumThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+
+    /* Conversion can only be delegated to the worker threads if all */
+    /* source bands share the same data type */
+    GDALDataType eSrcDT = poSrcPrototypeBand->GetRasterDataType();
+    for( int iBand = 1; iBand < nBandCount; iBand++ )
+    {
+        if( poSrcDS->GetRasterBand(iBand + 1)->GetRasterDataType() != eSrcDT )
+            eSrcDT = eDT;
+    }
+    int nConvertThreads = 0;
+    int nSwathBufferCount = 1;
+    if( nThreads >= 2 )
+    {
+        if( eSrcDT != eDT )
+            nConvertThreads = nThreads - 2;
+        if( nConvertThreads == 0 )
+            eSrcDT = eDT;
+        nSwathBufferCount = (nConvertThreads + 2) * (eSrcDT != eDT ? 2 : 1);
+    }
+
 /* -------------------------------------------------------------------- */
 /*      What will our swath size be?                                    */
 /* -------------------------------------------------------------------- */
@@ -3475,17 +3995,8 @@ CPLErr CPL_STDCALL GDALDatasetCopyWholeRaster(
                                     poDstPrototypeBand,
                                     nBandCount,
                                     bDstIsCompressed, bInterleave,
-                                    &nSwathCols, &nSwathLines);
-
-    int nPixelSize = (GDALGetDataTypeSize(eDT) / 8);
-    if( bInterleave)
-        nPixelSize *= nBandCount;
-
-    void *pSwathBuf = VSI_MALLOC3_VERBOSE(nSwathCols, nSwathLines, nPixelSize );
-    if( pSwathBuf == NULL )
-    {
-        return CE_Failure;
-    }
+                                    &nSwathCols, &nSwathLines,
+                                    nSwathBufferCount);
 
     CPLDebug( "GDAL",
             "GDALDatasetCopyWholeRaster(): %d*%d swaths, bInterleave=%d",
@@ -3497,6 +4008,28 @@ CPLErr CPL_STDCALL GDALDatasetCopyWholeRaster(
         poSrcDS->AdviseRead(0, 0, nXSize, nYSize, nXSize, nYSize, eDT, nBandCount, NULL, NULL);
     }
 
+    if( nThreads >= 2 )
+    {
+        CPLDebug( "GDAL",
+                  "GDALDatasetCopyWholeRaster(): pipelined copy with %d "
+                  "conversion thread(s)", nConvertThreads );
+        return GDALCopyWholeRasterPipelined( poSrcDS, poDstDS, eSrcDT, eDT,
+                                             bInterleave,
+                                             nSwathCols, nSwathLines,
+                                             nConvertThreads,
+                                             pfnProgress, pProgressData );
+    }
+
+    int nPixelSize = (GDALGetDataTypeSize(eDT) / 8);
+    if( bInterleave)
+        nPixelSize *= nBandCount;
+
+    void *pSwathBuf = VSI_MALLOC3_VERBOSE(nSwathCols, nSwathLines, nPixelSize );
+    if( pSwathBuf == NULL )
+    {
+        return CE_Failure;
+    }
+
 /* ==================================================================== */
 /*      Band oriented (uninterleaved) case.                             */
 /* ==================================================================== */
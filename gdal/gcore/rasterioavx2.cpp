@@ -0,0 +1,578 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  AVX2 implementation of the most common GDALCopyWords() cases
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_priv.h"
+
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+
+#include <immintrin.h>
+#include <limits>
+#include "gdal_priv_templates.hpp"
+
+CPL_CVSID("$Id$");
+
+/*
+ * This file is compiled with AVX2 code generation enabled, and must only be
+ * called after having checked that the CPU supports AVX2 (see GDALCopyWords()
+ * in rasterio.cpp).
+ *
+ * It handles conversions between Byte, UInt16, Int16, Int32, Float32 and
+ * Float64, with packed or strided (pixel-interleaved) source and destination
+ * buffers, 8 words at a time. The clamping and rounding rules are the ones
+ * of GDALCopyWord() in gdal_priv_templates.hpp, and of GDALCopy4Words() for
+ * the Float32 to Byte, UInt16 and Int16 cases. Values are converted to
+ * 32 bit integers and then truncated to the output type, so that the result
+ * is the same as the static_cast<> of the non-vectorized code, including for
+ * NaN.
+ */
+
+typedef struct
+{
+    __m256d lo;
+    __m256d hi;
+} GDALAVX2Double8;
+
+template<class T> struct GDALAVX2Lanes { typedef __m256i Type; };
+template<> struct GDALAVX2Lanes<float> { typedef __m256 Type; };
+template<> struct GDALAVX2Lanes<double> { typedef GDALAVX2Double8 Type; };
+
+/************************************************************************/
+/*                            Packed loads                              */
+/************************************************************************/
+
+static inline void GDALAVX2Load( const GByte* p, __m256i& v )
+{
+    v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+static inline void GDALAVX2Load( const GUInt16* p, __m256i& v )
+{
+    v = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+static inline void GDALAVX2Load( const GInt16* p, __m256i& v )
+{
+    v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+static inline void GDALAVX2Load( const GInt32* p, __m256i& v )
+{
+    v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+static inline void GDALAVX2Load( const float* p, __m256& v )
+{
+    v = _mm256_loadu_ps(p);
+}
+
+static inline void GDALAVX2Load( const double* p, GDALAVX2Double8& v )
+{
+    v.lo = _mm256_loadu_pd(p);
+    v.hi = _mm256_loadu_pd(p + 4);
+}
+
+/************************************************************************/
+/*                            Strided loads                             */
+/*                                                                      */
+/*      ymm_offsets contains the byte offsets of the 8 words. Words     */
+/*      smaller than 32 bits are read with 32 bit gathers, so the       */
+/*      caller must make sure that up to 3 bytes after the word can be  */
+/*      read.                                                           */
+/************************************************************************/
+
+static inline void GDALAVX2Gather( const GByte* p, __m256i ymm_offsets,
+                                   __m256i& v )
+{
+    v = _mm256_and_si256(
+            _mm256_i32gather_epi32(reinterpret_cast<const int*>(p), ymm_offsets, 1),
+            _mm256_set1_epi32(0xFF));
+}
+
+static inline void GDALAVX2Gather( const GUInt16* p, __m256i ymm_offsets,
+                                   __m256i& v )
+{
+    v = _mm256_and_si256(
+            _mm256_i32gather_epi32(reinterpret_cast<const int*>(p), ymm_offsets, 1),
+            _mm256_set1_epi32(0xFFFF));
+}
+
+static inline void GDALAVX2Gather( const GInt16* p, __m256i ymm_offsets,
+                                   __m256i& v )
+{
+    v = _mm256_srai_epi32(_mm256_slli_epi32(
+            _mm256_i32gather_epi32(reinterpret_cast<const int*>(p), ymm_offsets, 1),
+            16), 16);
+}
+
+static inline void GDALAVX2Gather( const GInt32* p, __m256i ymm_offsets,
+                                   __m256i& v )
+{
+    v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(p), ymm_offsets, 1);
+}
+
+static inline void GDALAVX2Gather( const float* p, __m256i ymm_offsets,
+                                   __m256& v )
+{
+    v = _mm256_i32gather_ps(p, ymm_offsets, 1);
+}
+
+static inline void GDALAVX2Gather( const double* p, __m256i ymm_offsets,
+                                   GDALAVX2Double8& v )
+{
+    v.lo = _mm256_i32gather_pd(p, _mm256_castsi256_si128(ymm_offsets), 1);
+    v.hi = _mm256_i32gather_pd(p, _mm256_extracti128_si256(ymm_offsets, 1), 1);
+}
+
+/************************************************************************/
+/*                               Stores                                 */
+/*                                                                      */
+/*      Integer stores keep the low order bits of each 32 bit lane.     */
+/************************************************************************/
+
+static inline void GDALAVX2Store( __m256i v, GByte* p )
+{
+    const __m256i ymm_shuffle = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    v = _mm256_shuffle_epi8(v, ymm_shuffle);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p),
+                     _mm_unpacklo_epi32(_mm256_castsi256_si128(v),
+                                        _mm256_extracti128_si256(v, 1)));
+}
+
+static inline void GDALAVX2Store16( __m256i v, void* p )
+{
+    const __m256i ymm_shuffle = _mm256_setr_epi8(
+        0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    v = _mm256_shuffle_epi8(v, ymm_shuffle);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                     _mm_unpacklo_epi64(_mm256_castsi256_si128(v),
+                                        _mm256_extracti128_si256(v, 1)));
+}
+
+static inline void GDALAVX2Store( __m256i v, GUInt16* p )
+{
+    GDALAVX2Store16(v, p);
+}
+
+static inline void GDALAVX2Store( __m256i v, GInt16* p )
+{
+    GDALAVX2Store16(v, p);
+}
+
+static inline void GDALAVX2Store( __m256i v, GInt32* p )
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+static inline void GDALAVX2Store( __m256 v, float* p )
+{
+    _mm256_storeu_ps(p, v);
+}
+
+static inline void GDALAVX2Store( const GDALAVX2Double8& v, double* p )
+{
+    _mm256_storeu_pd(p, v.lo);
+    _mm256_storeu_pd(p + 4, v.hi);
+}
+
+/************************************************************************/
+/*                     Conversions from integer types                   */
+/************************************************************************/
+
+template<class Tin, class Tout>
+static inline void GDALAVX2Convert( __m256i v, const Tin*, Tout* p )
+{
+    Tin tMaxVal, tMinVal;
+    GDALGetDataLimits<Tin, Tout>(tMaxVal, tMinVal);
+    v = _mm256_max_epi32(v, _mm256_set1_epi32(static_cast<int>(tMinVal)));
+    v = _mm256_min_epi32(v, _mm256_set1_epi32(static_cast<int>(tMaxVal)));
+    GDALAVX2Store(v, p);
+}
+
+template<class Tin>
+static inline void GDALAVX2Convert( __m256i v, const Tin*, float* p )
+{
+    GDALAVX2Store(_mm256_cvtepi32_ps(v), p);
+}
+
+template<class Tin>
+static inline void GDALAVX2Convert( __m256i v, const Tin*, double* p )
+{
+    GDALAVX2Double8 vd;
+    vd.lo = _mm256_cvtepi32_pd(_mm256_castsi256_si128(v));
+    vd.hi = _mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1));
+    GDALAVX2Store(vd, p);
+}
+
+/************************************************************************/
+/*                        Conversions from Float32                      */
+/************************************************************************/
+
+/* Same as GDALCopy4WordsSSE() */
+template<class Tout>
+static inline __m256i GDALAVX2FloatToSmallInt( __m256 v )
+{
+    float fMaxVal, fMinVal;
+    GDALGetDataLimits<float, Tout>(fMaxVal, fMinVal);
+    v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(fMinVal)),
+                      _mm256_set1_ps(fMaxVal));
+    const __m256 p0d5 = _mm256_set1_ps(0.5f);
+    if( std::numeric_limits<Tout>::is_signed )
+    {
+        const __m256 mask = _mm256_cmp_ps(v, p0d5, _CMP_GE_OQ);
+        v = _mm256_add_ps(v, _mm256_blendv_ps(_mm256_set1_ps(-0.5f), p0d5, mask));
+    }
+    else
+    {
+        v = _mm256_add_ps(v, p0d5);
+    }
+    return _mm256_cvttps_epi32(v);
+}
+
+static inline void GDALAVX2Convert( __m256 v, const float*, GByte* p )
+{
+    GDALAVX2Store(GDALAVX2FloatToSmallInt<GByte>(v), p);
+}
+
+static inline void GDALAVX2Convert( __m256 v, const float*, GUInt16* p )
+{
+    GDALAVX2Store(GDALAVX2FloatToSmallInt<GUInt16>(v), p);
+}
+
+static inline void GDALAVX2Convert( __m256 v, const float*, GInt16* p )
+{
+    GDALAVX2Store(GDALAVX2FloatToSmallInt<GInt16>(v), p);
+}
+
+/* Same as GDALCopyWord(const float, int&) */
+static inline void GDALAVX2Convert( __m256 v, const float*, GInt32* p )
+{
+    const __m256 mask_pos = _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GT_OQ);
+    const __m256 v_rounded = _mm256_blendv_ps(
+        _mm256_sub_ps(v, _mm256_set1_ps(0.5f)),
+        _mm256_add_ps(v, _mm256_set1_ps(0.5f)), mask_pos);
+    __m256i v_int = _mm256_cvttps_epi32(v_rounded);
+
+    const __m256 fMax = _mm256_set1_ps(
+        static_cast<float>(std::numeric_limits<int>::max()));
+    const __m256 fMin = _mm256_set1_ps(
+        static_cast<float>(std::numeric_limits<int>::min()));
+    v_int = _mm256_blendv_epi8(v_int,
+        _mm256_set1_epi32(std::numeric_limits<int>::max()),
+        _mm256_castps_si256(_mm256_cmp_ps(v, fMax, _CMP_GE_OQ)));
+    v_int = _mm256_blendv_epi8(v_int,
+        _mm256_set1_epi32(std::numeric_limits<int>::min()),
+        _mm256_castps_si256(_mm256_cmp_ps(v, fMin, _CMP_LE_OQ)));
+    GDALAVX2Store(v_int, p);
+}
+
+/* Never reached (same type), but needed for the template instantiations */
+static inline void GDALAVX2Convert( __m256 v, const float*, float* p )
+{
+    GDALAVX2Store(v, p);
+}
+
+static inline void GDALAVX2Convert( __m256 v, const float*, double* p )
+{
+    GDALAVX2Double8 vd;
+    vd.lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+    vd.hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+    GDALAVX2Store(vd, p);
+}
+
+/************************************************************************/
+/*                        Conversions from Float64                      */
+/************************************************************************/
+
+/* Same as GDALClampValue(): NaN is left unchanged */
+static inline __m256d GDALAVX2Clamp( __m256d v, double dfMaxVal, double dfMinVal )
+{
+    const __m256d ymm_max = _mm256_set1_pd(dfMaxVal);
+    const __m256d ymm_min = _mm256_set1_pd(dfMinVal);
+    v = _mm256_blendv_pd(v, ymm_max, _mm256_cmp_pd(v, ymm_max, _CMP_GT_OQ));
+    return _mm256_blendv_pd(v, ymm_min, _mm256_cmp_pd(v, ymm_min, _CMP_LT_OQ));
+}
+
+/* Add 0.5 to values for which the comparison with zero is true, and */
+/* subtract it from the others */
+static inline __m256d GDALAVX2RoundSigned( __m256d v, int nCmp )
+{
+    __m256d mask;
+    if( nCmp == _CMP_GT_OQ )
+        mask = _mm256_cmp_pd(v, _mm256_setzero_pd(), _CMP_GT_OQ);
+    else
+        mask = _mm256_cmp_pd(v, _mm256_setzero_pd(), _CMP_GE_OQ);
+    return _mm256_blendv_pd(_mm256_sub_pd(v, _mm256_set1_pd(0.5)),
+                            _mm256_add_pd(v, _mm256_set1_pd(0.5)), mask);
+}
+
+static inline __m256i GDALAVX2Truncate( __m256d lo, __m256d hi )
+{
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm256_cvttpd_epi32(lo)),
+        _mm256_cvttpd_epi32(hi), 1);
+}
+
+/* Same as the generic GDALCopyWord(const double, Tout&) */
+template<class Tout>
+static inline __m256i GDALAVX2DoubleToUnsigned( const GDALAVX2Double8& v )
+{
+    double dfMaxVal, dfMinVal;
+    GDALGetDataLimits<double, Tout>(dfMaxVal, dfMinVal);
+    const __m256d p0d5 = _mm256_set1_pd(0.5);
+    return GDALAVX2Truncate(
+        GDALAVX2Clamp(_mm256_add_pd(v.lo, p0d5), dfMaxVal, dfMinVal),
+        GDALAVX2Clamp(_mm256_add_pd(v.hi, p0d5), dfMaxVal, dfMinVal));
+}
+
+static inline void GDALAVX2Convert( const GDALAVX2Double8& v, const double*,
+                                    GByte* p )
+{
+    GDALAVX2Store(GDALAVX2DoubleToUnsigned<GByte>(v), p);
+}
+
+static inline void GDALAVX2Convert( const GDALAVX2Double8& v, const double*,
+                                    GUInt16* p )
+{
+    GDALAVX2Store(GDALAVX2DoubleToUnsigned<GUInt16>(v), p);
+}
+
+/* Same as GDALCopyWord(const double, short&) */
+static inline void GDALAVX2Convert( const GDALAVX2Double8& v, const double*,
+                                    GInt16* p )
+{
+    const double dfMaxVal = std::numeric_limits<short>::max();
+    const double dfMinVal = std::numeric_limits<short>::min();
+    GDALAVX2Store(GDALAVX2Truncate(
+        GDALAVX2Clamp(GDALAVX2RoundSigned(v.lo, _CMP_GT_OQ), dfMaxVal, dfMinVal),
+        GDALAVX2Clamp(GDALAVX2RoundSigned(v.hi, _CMP_GT_OQ), dfMaxVal, dfMinVal)),
+        p);
+}
+
+/* Same as GDALCopyWord(const double, int&) */
+static inline void GDALAVX2Convert( const GDALAVX2Double8& v, const double*,
+                                    GInt32* p )
+{
+    const double dfMaxVal = std::numeric_limits<int>::max();
+    const double dfMinVal = std::numeric_limits<int>::min();
+    GDALAVX2Store(GDALAVX2Truncate(
+        GDALAVX2Clamp(GDALAVX2RoundSigned(v.lo, _CMP_GE_OQ), dfMaxVal, dfMinVal),
+        GDALAVX2Clamp(GDALAVX2RoundSigned(v.hi, _CMP_GE_OQ), dfMaxVal, dfMinVal)),
+        p);
+}
+
+/* Never reached (same type), but needed for the template instantiations */
+static inline void GDALAVX2Convert( const GDALAVX2Double8& v, const double*,
+                                    double* p )
+{
+    GDALAVX2Store(v, p);
+}
+
+static inline void GDALAVX2Convert( const GDALAVX2Double8& v, const double*,
+                                    float* p )
+{
+    GDALAVX2Store(_mm256_insertf128_ps(
+        _mm256_castps128_ps256(_mm256_cvtpd_ps(v.lo)),
+        _mm256_cvtpd_ps(v.hi), 1), p);
+}
+
+/************************************************************************/
+/*                         GDALCopyWordsAVX2T()                         */
+/************************************************************************/
+
+template<class Tin, class Tout, bool bSrcPacked, bool bDstPacked>
+static int GDALCopyWordsAVX2T( const Tin* const CPL_RESTRICT pSrcData,
+                               int nSrcPixelStride,
+                               Tout* const CPL_RESTRICT pDstData,
+                               int nDstPixelStride,
+                               int nWordCount )
+{
+    const GByte* const pabySrc = reinterpret_cast<const GByte*>(pSrcData);
+    GByte* const pabyDst = reinterpret_cast<GByte*>(pDstData);
+    const __m256i ymm_offsets = _mm256_mullo_epi32(
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32(nSrcPixelStride));
+
+    // With gathers, make sure that the 32 bit read of the last word of
+    // an iteration does not go beyond the last source word.
+    int nIters = nWordCount / 8;
+    if( !bSrcPacked && sizeof(Tin) < 4 )
+    {
+        while( nIters > 0 &&
+               (GIntBig)(nIters * 8 - 1) * nSrcPixelStride + 4 >
+               (GIntBig)(nWordCount - 1) * nSrcPixelStride + (int)sizeof(Tin) )
+        {
+            nIters --;
+        }
+    }
+
+    typename GDALAVX2Lanes<Tin>::Type v;
+    for( int i = 0; i < nIters; i++ )
+    {
+        const std::ptrdiff_t n = static_cast<std::ptrdiff_t>(i) * 8;
+        const Tin* pSrc = reinterpret_cast<const Tin*>(pabySrc + n * nSrcPixelStride);
+        if( bSrcPacked )
+            GDALAVX2Load(pSrc, v);
+        else
+            GDALAVX2Gather(pSrc, ymm_offsets, v);
+
+        Tout* pDst = reinterpret_cast<Tout*>(pabyDst + n * nDstPixelStride);
+        if( bDstPacked )
+            GDALAVX2Convert(v, pSrc, pDst);
+        else
+        {
+            Tout atTmp[8];
+            GDALAVX2Convert(v, pSrc, atTmp);
+            for( int j = 0; j < 8; j++ )
+                *reinterpret_cast<Tout*>(
+                    reinterpret_cast<GByte*>(pDst) + j * nDstPixelStride) = atTmp[j];
+        }
+    }
+    return nIters * 8;
+}
+
+template<class Tin, class Tout>
+static int GDALCopyWordsAVX2T( const Tin* const CPL_RESTRICT pSrcData,
+                               int nSrcPixelStride,
+                               Tout* const CPL_RESTRICT pDstData,
+                               int nDstPixelStride,
+                               int nWordCount )
+{
+    const bool bSrcPacked = nSrcPixelStride == (int)sizeof(Tin);
+    const bool bDstPacked = nDstPixelStride == (int)sizeof(Tout);
+    if( bSrcPacked && bDstPacked )
+        return GDALCopyWordsAVX2T<Tin, Tout, true, true>(
+            pSrcData, nSrcPixelStride, pDstData, nDstPixelStride, nWordCount);
+    if( bSrcPacked )
+        return GDALCopyWordsAVX2T<Tin, Tout, true, false>(
+            pSrcData, nSrcPixelStride, pDstData, nDstPixelStride, nWordCount);
+    if( bDstPacked )
+        return GDALCopyWordsAVX2T<Tin, Tout, false, true>(
+            pSrcData, nSrcPixelStride, pDstData, nDstPixelStride, nWordCount);
+    return GDALCopyWordsAVX2T<Tin, Tout, false, false>(
+        pSrcData, nSrcPixelStride, pDstData, nDstPixelStride, nWordCount);
+}
+
+template<class Tin>
+static int GDALCopyWordsAVX2FromT( const Tin* const CPL_RESTRICT pSrcData,
+                                   int nSrcPixelStride,
+                                   void* CPL_RESTRICT pDstData,
+                                   GDALDataType eDstType, int nDstPixelStride,
+                                   int nWordCount )
+{
+    switch( eDstType )
+    {
+        case GDT_Byte:
+            return GDALCopyWordsAVX2T(pSrcData, nSrcPixelStride,
+                                      static_cast<GByte*>(pDstData),
+                                      nDstPixelStride, nWordCount);
+        case GDT_UInt16:
+            return GDALCopyWordsAVX2T(pSrcData, nSrcPixelStride,
+                                      static_cast<GUInt16*>(pDstData),
+                                      nDstPixelStride, nWordCount);
+        case GDT_Int16:
+            return GDALCopyWordsAVX2T(pSrcData, nSrcPixelStride,
+                                      static_cast<GInt16*>(pDstData),
+                                      nDstPixelStride, nWordCount);
+        case GDT_Int32:
+            return GDALCopyWordsAVX2T(pSrcData, nSrcPixelStride,
+                                      static_cast<GInt32*>(pDstData),
+                                      nDstPixelStride, nWordCount);
+        case GDT_Float32:
+            return GDALCopyWordsAVX2T(pSrcData, nSrcPixelStride,
+                                      static_cast<float*>(pDstData),
+                                      nDstPixelStride, nWordCount);
+        case GDT_Float64:
+            return GDALCopyWordsAVX2T(pSrcData, nSrcPixelStride,
+                                      static_cast<double*>(pDstData),
+                                      nDstPixelStride, nWordCount);
+        default:
+            return 0;
+    }
+}
+
+/************************************************************************/
+/*                          GDALCopyWordsAVX2()                         */
+/*                                                                      */
+/*      Returns the number of words that have been copied, which is a   */
+/*      multiple of 8 and might be 0 if the case is not handled. The    */
+/*      caller is responsible for copying the remaining words.          */
+/************************************************************************/
+
+int GDALCopyWordsAVX2( const void * CPL_RESTRICT pSrcData,
+                       GDALDataType eSrcType, int nSrcPixelStride,
+                       void * CPL_RESTRICT pDstData,
+                       GDALDataType eDstType, int nDstPixelStride,
+                       int nWordCount )
+{
+    // Same data type copies are already dealt with memcpy() and the like,
+    // and the strides must fit in the 32 bit offsets of gathers.
+    if( eSrcType == eDstType ||
+        nSrcPixelStride <= 0 || nSrcPixelStride > INT_MAX / 8 ||
+        nDstPixelStride <= 0 || nDstPixelStride > INT_MAX / 8 )
+        return 0;
+
+    // 64 bit gathers are slower than the scalar code.
+    if( eSrcType == GDT_Float64 && nSrcPixelStride != 8 )
+        return 0;
+
+    switch( eSrcType )
+    {
+        case GDT_Byte:
+            return GDALCopyWordsAVX2FromT(static_cast<const GByte*>(pSrcData),
+                                          nSrcPixelStride, pDstData, eDstType,
+                                          nDstPixelStride, nWordCount);
+        case GDT_UInt16:
+            return GDALCopyWordsAVX2FromT(static_cast<const GUInt16*>(pSrcData),
+                                          nSrcPixelStride, pDstData, eDstType,
+                                          nDstPixelStride, nWordCount);
+        case GDT_Int16:
+            return GDALCopyWordsAVX2FromT(static_cast<const GInt16*>(pSrcData),
+                                          nSrcPixelStride, pDstData, eDstType,
+                                          nDstPixelStride, nWordCount);
+        case GDT_Int32:
+            return GDALCopyWordsAVX2FromT(static_cast<const GInt32*>(pSrcData),
+                                          nSrcPixelStride, pDstData, eDstType,
+                                          nDstPixelStride, nWordCount);
+        case GDT_Float32:
+            return GDALCopyWordsAVX2FromT(static_cast<const float*>(pSrcData),
+                                          nSrcPixelStride, pDstData, eDstType,
+                                          nDstPixelStride, nWordCount);
+        case GDT_Float64:
+            return GDALCopyWordsAVX2FromT(static_cast<const double*>(pSrcData),
+                                          nSrcPixelStride, pDstData, eDstType,
+                                          nDstPixelStride, nWordCount);
+        default:
+            return 0;
+    }
+}
+
+#endif /* HAVE_AVX2_AT_COMPILE_TIME */
@@ -62,6 +62,17 @@ static GDALDataset *OGRAeronavFAADriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                  OGRAeronavFAADriverInitMetadata()                   */
+/************************************************************************/
+
+static void OGRAeronavFAADriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Aeronav FAA" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_aeronavfaa.html" );
+}
+
 /************************************************************************/
 /*                        RegisterOGRAeronavFAA()                       */
 /************************************************************************/
@@ -76,11 +87,10 @@ void RegisterOGRAeronavFAA()
 
     poDriver->SetDescription( "AeronavFAA" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Aeronav FAA" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_aeronavfaa.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRAeronavFAADriverOpen;
+    poDriver->pfnInitMetadata = OGRAeronavFAADriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
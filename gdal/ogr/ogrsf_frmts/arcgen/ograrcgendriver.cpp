@@ -105,6 +105,17 @@ static GDALDataset *OGRARCGENDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                    OGRARCGENDriverInitMetadata()                     */
+/************************************************************************/
+
+static void OGRARCGENDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Arc/Info Generate" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_arcgen.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRARCGEN()                           */
 /************************************************************************/
@@ -119,10 +130,9 @@ void RegisterOGRARCGEN()
 
     poDriver->SetDescription( "ARCGEN" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Arc/Info Generate" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_arcgen.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->pfnOpen = OGRARCGENDriverOpen;
+    poDriver->pfnInitMetadata = OGRARCGENDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -93,6 +93,17 @@ static GDALDataset *OGRAVCBinDriverOpen( GDALOpenInfo* poOpenInfo )
 /*                           RegisterOGRAVC()                           */
 /************************************************************************/
 
+/************************************************************************/
+/*                    OGRAVCBinDriverInitMetadata()                     */
+/************************************************************************/
+
+static void OGRAVCBinDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Arc/Info Binary Coverage" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_avcbin.html" );
+}
+
 void RegisterOGRAVCBin()
 
 {
@@ -103,10 +114,9 @@ void RegisterOGRAVCBin()
 
     poDriver->SetDescription( "AVCBin" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Arc/Info Binary Coverage" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_avcbin.html" );
 
     poDriver->pfnOpen = OGRAVCBinDriverOpen;
+    poDriver->pfnInitMetadata = OGRAVCBinDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -61,6 +61,19 @@ static GDALDataset *OGRAVCE00DriverOpen( GDALOpenInfo* poOpenInfo )
 /*                           RegisterOGRAVC()                           */
 /************************************************************************/
 
+/************************************************************************/
+/*                    OGRAVCE00DriverInitMetadata()                     */
+/************************************************************************/
+
+static void OGRAVCE00DriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Arc/Info E00 (ASCII) Coverage" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "e00" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_avce00.html" );
+}
+
 void RegisterOGRAVCE00()
 
 {
@@ -71,12 +84,9 @@ void RegisterOGRAVCE00()
 
     poDriver->SetDescription( "AVCE00" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Arc/Info E00 (ASCII) Coverage" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "e00" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_avce00.html" );
 
     poDriver->pfnOpen = OGRAVCE00DriverOpen;
+    poDriver->pfnInitMetadata = OGRAVCE00DriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -101,6 +101,20 @@ static CPLErr OGRBNADriverDelete( const char *pszFilename )
     return CE_Failure;
 }
 
+/************************************************************************/
+/*                      OGRBNADriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRBNADriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Atlas BNA" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "bna" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_bna.html" );
+    poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
+                               "<LayerCreationOptionList/>");
+}
+
 /************************************************************************/
 /*                           RegisterOGRBNA()                           */
 /************************************************************************/
@@ -115,9 +129,6 @@ void RegisterOGRBNA()
 
     poDriver->SetDescription( "BNA" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Atlas BNA" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "bna" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_bna.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
@@ -140,12 +151,11 @@ void RegisterOGRBNA()
 "  <Option name='NB_PAIRS_PER_LINE' type='int' description='Maximum number of coordinate pair per line in multiline format'/>"
 "  <Option name='COORDINATE_PRECISION' type='int' description='Number of decimal for coordinates' default='10'/>"
 "</CreationOptionList>");
-    poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
-                               "<LayerCreationOptionList/>");
 
     poDriver->pfnOpen = OGRBNADriverOpen;
     poDriver->pfnCreate = OGRBNADriverCreate;
     poDriver->pfnDelete = OGRBNADriverDelete;
+    poDriver->pfnInitMetadata = OGRBNADriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
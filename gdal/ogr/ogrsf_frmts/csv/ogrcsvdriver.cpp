@@ -282,31 +282,22 @@ static void OGRCSVDriverUnload( GDALDriver* )
 }
 
 /************************************************************************/
-/*                           RegisterOGRCSV()                           */
+/*                      OGRCSVDriverInitMetadata()                      */
 /************************************************************************/
 
-void RegisterOGRCSV()
+static void OGRCSVDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "CSV" ) != NULL )
-        return;
-
-    GDALDriver  *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "CSV" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "Comma Separated Value (.csv)" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "csv" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_csv.html" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "  <Option name='GEOMETRY' type='string-select' description='how to encode geometry fields'>"
 "    <Value>AS_WKT</Value>"
 "  </Option>"
 "</CreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
 "<LayerCreationOptionList>"
 "  <Option name='SEPARATOR' type='string-select' description='field separator' default='COMMA'>"
@@ -333,7 +324,6 @@ void RegisterOGRCSV()
 "  <Option name='WRITE_BOM' type='boolean' description='whether to write a UTF-8 BOM prefix' default='NO'/>"
 "  <Option name='GEOMETRY_NAME' type='string' description='Name of geometry column. Only used if GEOMETRY=AS_WKT' default='WKT'/>"
 "</LayerCreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
 #if 0
@@ -367,17 +357,34 @@ void RegisterOGRCSV()
 "  </Option>"
 "  <Option name='EMPTY_STRING_AS_NULL' type='boolean' description='Whether to consider empty strings as null fields on reading' default='NO'/>"
 "</OpenOptionList>");
-
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
                                "Integer Integer64 Real String Date DateTime "
                                "Time" );
+}
+
+/************************************************************************/
+/*                           RegisterOGRCSV()                           */
+/************************************************************************/
+
+void RegisterOGRCSV()
+
+{
+    if( GDALGetDriverByName( "CSV" ) != NULL )
+        return;
+
+    GDALDriver  *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "CSV" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRCSVDriverOpen;
     poDriver->pfnIdentify = OGRCSVDriverIdentify;
     poDriver->pfnCreate = OGRCSVDriverCreate;
     poDriver->pfnDelete = OGRCSVDriverDelete;
     poDriver->pfnUnloadDriver = OGRCSVDriverUnload;
+    poDriver->pfnInitMetadata = OGRCSVDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -95,23 +95,15 @@ static GDALDataset *OGRDGNDriverCreate( const char * pszName,
 }
 
 /************************************************************************/
-/*                          RegisterOGRDGN()                            */
+/*                      OGRDGNDriverInitMetadata()                      */
 /************************************************************************/
 
-void RegisterOGRDGN()
+static void OGRDGNDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "DGN" ) != NULL )
-        return;
-
-    GDALDriver  *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "DGN" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Microstation DGN" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "dgn" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_dgn.html" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "  <Option name='3D' type='boolean' description='whether 2D (seed_2d.dgn) or 3D (seed_3d.dgn) seed file should be used. This option is ignored if the SEED option is provided'/>"
@@ -126,13 +118,29 @@ void RegisterOGRDGN()
 "  <Option name='UOR_PER_SUB_UNIT' type='int' description='Override the number of UORs (Units of Resolution) per sub unit. By default the seed file value is used.'/>"
 "  <Option name='ORIGIN' type='string' description='Value as x,y,z. Override the origin of the design plane. By default the origin from the seed file is used.'/>"
 "</CreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
                                "<LayerCreationOptionList/>" );
+}
+
+/************************************************************************/
+/*                          RegisterOGRDGN()                            */
+/************************************************************************/
+
+void RegisterOGRDGN()
+
+{
+    if( GDALGetDriverByName( "DGN" ) != NULL )
+        return;
+
+    GDALDriver  *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "DGN" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
 
     poDriver->pfnOpen = OGRDGNDriverOpen;
     poDriver->pfnIdentify = OGRDGNDriverIdentify;
     poDriver->pfnCreate = OGRDGNDriverCreate;
+    poDriver->pfnInitMetadata = OGRDGNDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
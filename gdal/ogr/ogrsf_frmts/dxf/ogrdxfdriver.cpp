@@ -120,38 +120,46 @@ static GDALDataset *OGRDXFDriverCreate( const char * pszName,
 }
 
 /************************************************************************/
-/*                           RegisterOGRDXF()                           */
+/*                      OGRDXFDriverInitMetadata()                      */
 /************************************************************************/
 
-void RegisterOGRDXF()
+static void OGRDXFDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "DXF" ) != NULL )
-        return;
-
-    GDALDriver  *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "DXF" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "AutoCAD DXF" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "dxf" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_dxf.html" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "  <Option name='HEADER' type='string' description='Template header file' default='header.dxf'/>"
 "  <Option name='TRAILER' type='string' description='Template trailer file' default='trailer.dxf'/>"
 "  <Option name='FIRST_ENTITY' type='int' description='Identifier of first entity'/>"
 "</CreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
                                "<LayerCreationOptionList/>" );
+}
+
+/************************************************************************/
+/*                           RegisterOGRDXF()                           */
+/************************************************************************/
+
+void RegisterOGRDXF()
+
+{
+    if( GDALGetDriverByName( "DXF" ) != NULL )
+        return;
+
+    GDALDriver  *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "DXF" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRDXFDriverOpen;
     poDriver->pfnIdentify = OGRDXFDriverIdentify;
     poDriver->pfnCreate = OGRDXFDriverCreate;
+    poDriver->pfnInitMetadata = OGRDXFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
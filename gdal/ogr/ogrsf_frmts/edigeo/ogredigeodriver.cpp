@@ -69,6 +69,19 @@ static GDALDataset *OGREDIGEODriverOpen( GDALOpenInfo * poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                    OGREDIGEODriverInitMetadata()                     */
+/************************************************************************/
+
+static void OGREDIGEODriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "French EDIGEO exchange format" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "thf" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_edigeo.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGREDIGEO()                        */
 /************************************************************************/
@@ -83,15 +96,12 @@ void RegisterOGREDIGEO()
 
     poDriver->SetDescription( "EDIGEO" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "French EDIGEO exchange format" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "thf" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_edigeo.html" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGREDIGEODriverOpen;
     poDriver->pfnIdentify = OGREDIGEODriverIdentify;
+    poDriver->pfnInitMetadata = OGREDIGEODriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
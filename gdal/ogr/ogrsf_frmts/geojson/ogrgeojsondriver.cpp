@@ -494,25 +494,15 @@ static CPLErr OGRGeoJSONDriverDelete( const char *pszFilename )
 }
 
 /************************************************************************/
-/*                           RegisterOGRGeoJSON()                       */
+/*                    OGRGeoJSONDriverInitMetadata()                    */
 /************************************************************************/
 
-void RegisterOGRGeoJSON()
-{
-    if( !GDAL_CHECK_VERSION("OGR/GeoJSON driver") )
-        return;
-
-    if( GDALGetDriverByName( "GeoJSON" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
+static void OGRGeoJSONDriverInitMetadata( GDALDriver* poDriver )
 
-    poDriver->SetDescription( "GeoJSON" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+{
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GeoJSON" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "json geojson topojson" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_geojson.html" );
-
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
 "  <Option name='FLATTEN_NESTED_ATTRIBUTES' type='boolean' description='Whether to recursively explore nested objects and produce flatten OGR attributes' default='NO'/>"
@@ -521,10 +511,8 @@ void RegisterOGRGeoJSON()
 "  <Option name='NATIVE_DATA' type='boolean' description='Whether to store the native JSon representation at FeatureCollection and Feature level' default='NO'/>"
 "  <Option name='ARRAY_AS_STRING' type='boolean' description='Whether to expose JSon arrays of strings, integers or reals as a OGR String' default='NO'/>"
 "</OpenOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
                                "<CreationOptionList/>");
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
 "<LayerCreationOptionList>"
 "  <Option name='WRITE_BBOX' type='boolean' description='whether to write a bbox property with the bounding box of the geometries at the feature and feature collection level' default='NO'/>"
@@ -533,16 +521,35 @@ void RegisterOGRGeoJSON()
 "  <Option name='NATIVE_DATA' type='string' description='FeatureCollection level elements.'/>"
 "  <Option name='NATIVE_MEDIA_TYPE' type='string' description='Format of NATIVE_DATA. Must be \"application/vnd.geo+json\", otherwise NATIVE_DATA will be ignored.'/>"
 "</LayerCreationOptionList>");
-
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
                                "Integer Integer64 Real String IntegerList "
                                "Integer64List RealList StringList" );
+}
+
+/************************************************************************/
+/*                           RegisterOGRGeoJSON()                       */
+/************************************************************************/
+
+void RegisterOGRGeoJSON()
+{
+    if( !GDAL_CHECK_VERSION("OGR/GeoJSON driver") )
+        return;
+
+    if( GDALGetDriverByName( "GeoJSON" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "GeoJSON" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRGeoJSONDriverOpen;
     poDriver->pfnIdentify = OGRGeoJSONDriverIdentify;
     poDriver->pfnCreate = OGRGeoJSONDriverCreate;
     poDriver->pfnDelete = OGRGeoJSONDriverDelete;
+    poDriver->pfnInitMetadata = OGRGeoJSONDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -94,25 +94,14 @@ static CPLErr OGRGeoRSSDriverDelete( const char *pszFilename )
 }
 
 /************************************************************************/
-/*                           RegisterOGRGeoRSS()                           */
+/*                    OGRGeoRSSDriverInitMetadata()                     */
 /************************************************************************/
 
-void RegisterOGRGeoRSS()
+static void OGRGeoRSSDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if (! GDAL_CHECK_VERSION("OGR/GeoRSS driver"))
-        return;
-
-    if( GDALGetDriverByName( "GeoRSS" ) != NULL )
-        return;
-
-    GDALDriver  *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "GeoRSS" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GeoRSS" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_georss.html" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "  <Option name='FORMAT' type='string-select' description='whether the document must be in RSS 2.0 or Atom 1.0 format' default='RSS'>"
@@ -136,11 +125,32 @@ void RegisterOGRGeoRSS()
 "</CreationOptionList>");
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
                                "<LayerCreationOptionList/>");
+}
+
+/************************************************************************/
+/*                           RegisterOGRGeoRSS()                           */
+/************************************************************************/
+
+void RegisterOGRGeoRSS()
+
+{
+    if (! GDAL_CHECK_VERSION("OGR/GeoRSS driver"))
+        return;
+
+    if( GDALGetDriverByName( "GeoRSS" ) != NULL )
+        return;
+
+    GDALDriver  *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "GeoRSS" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRGeoRSSDriverOpen;
     poDriver->pfnCreate = OGRGeoRSSDriverCreate;
     poDriver->pfnDelete = OGRGeoRSSDriverDelete;
+    poDriver->pfnInitMetadata = OGRGeoRSSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
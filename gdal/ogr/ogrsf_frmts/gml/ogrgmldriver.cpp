@@ -139,25 +139,17 @@ static GDALDataset *OGRGMLDriverCreate( const char * pszName,
 }
 
 /************************************************************************/
-/*                           RegisterOGRGML()                           */
+/*                      OGRGMLDriverInitMetadata()                      */
 /************************************************************************/
 
-void RegisterOGRGML()
+static void OGRGMLDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "GML" ) != NULL )
-        return;
-
-    GDALDriver  *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "GML" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "Geography Markup Language (GML)" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gml" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "gml xml" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_gml.html" );
-
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
 "  <Option name='XSD' type='string' description='Name of the related application schema file (.xsd).'/>"
@@ -190,7 +182,6 @@ void RegisterOGRGML()
 "  <Option name='DOWNLOAD_SCHEMA' type='boolean' description='Whether to download the remote application schema if needed (only for WFS currently)' default='YES'/>"
 "  <Option name='REGISTRY' type='string' description='Filename of the registry with application schemas.'/>"
 "</OpenOptionList>" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "  <Option name='XSISCHEMAURI' type='string' description='URI to be inserted as the schema location.'/>"
@@ -220,9 +211,25 @@ void RegisterOGRGML()
 "  <Option name='NAME' type='string' description='Content of GML name element'/>"
 "  <Option name='DESCRIPTION' type='string' description='Content of GML description element'/>"
 "</CreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST, "<LayerCreationOptionList/>");
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES, "Integer Integer64 Real String Date DateTime IntegerList Integer64List RealList StringList" );
+}
+
+/************************************************************************/
+/*                           RegisterOGRGML()                           */
+/************************************************************************/
+
+void RegisterOGRGML()
+
+{
+    if( GDALGetDriverByName( "GML" ) != NULL )
+        return;
+
+    GDALDriver  *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "GML" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
     poDriver->SetMetadataItem( GDAL_DCAP_NOTNULL_FIELDS, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_NOTNULL_GEOMFIELDS, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
@@ -231,6 +238,7 @@ void RegisterOGRGML()
     poDriver->pfnIdentify = OGRGMLDriverIdentify;
     poDriver->pfnCreate = OGRGMLDriverCreate;
     poDriver->pfnUnloadDriver = OGRGMLDriverUnload;
+    poDriver->pfnInitMetadata = OGRGMLDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
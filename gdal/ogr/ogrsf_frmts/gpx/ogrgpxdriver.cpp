@@ -91,6 +91,23 @@ static CPLErr OGRGPXDriverDelete( const char *pszFilename )
         return CE_Failure;
 }
 
+/************************************************************************/
+/*                      OGRGPXDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRGPXDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GPX" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gpx" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_gpx.html" );
+    poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
+"<LayerCreationOptionList>"
+"  <Option name='FORCE_GPX_TRACK' type='boolean' description='Whether to force layers with geometries of type wkbLineString as tracks' default='NO'/>"
+"  <Option name='FORCE_GPX_ROUTE' type='boolean' description='Whether to force layers with geometries of type wkbMultiLineString (with single line string in them) as routes' default='NO'/>"
+"</LayerCreationOptionList>");
+}
+
 /************************************************************************/
 /*                           RegisterOGRGPX()                           */
 /************************************************************************/
@@ -108,9 +125,6 @@ void RegisterOGRGPX()
 
     poDriver->SetDescription( "GPX" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GPX" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gpx" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_gpx.html" );
 
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
@@ -127,17 +141,12 @@ void RegisterOGRGPX()
 "  <Option name='GPX_EXTENSIONS_NS_URL' type='string' description='Namespace URI' default='http://osgeo.org/gdal'/>"
 "</CreationOptionList>");
 
-    poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
-"<LayerCreationOptionList>"
-"  <Option name='FORCE_GPX_TRACK' type='boolean' description='Whether to force layers with geometries of type wkbLineString as tracks' default='NO'/>"
-"  <Option name='FORCE_GPX_ROUTE' type='boolean' description='Whether to force layers with geometries of type wkbMultiLineString (with single line string in them) as routes' default='NO'/>"
-"</LayerCreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRGPXDriverOpen;
     poDriver->pfnCreate = OGRGPXDriverCreate;
     poDriver->pfnDelete = OGRGPXDriverDelete;
+    poDriver->pfnInitMetadata = OGRGPXDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
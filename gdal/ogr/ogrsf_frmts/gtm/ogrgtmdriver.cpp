@@ -95,6 +95,18 @@ static GDALDataset *OGRGTMDriverCreate( const char * pszName,
     return poDS;
 }
 
+/************************************************************************/
+/*                      OGRGTMDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRGTMDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GPSTrackMaker" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "gtm gtz" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_gtm.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRGTM()                           */
 /************************************************************************/
@@ -108,13 +120,11 @@ void RegisterOGRGTM()
 
     poDriver->SetDescription( "GPSTrackMaker" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "GPSTrackMaker" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "gtm gtz" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_gtm.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRGTMDriverOpen;
     poDriver->pfnCreate = OGRGTMDriverCreate;
+    poDriver->pfnInitMetadata = OGRGTMDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
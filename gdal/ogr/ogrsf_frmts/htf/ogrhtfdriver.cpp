@@ -59,6 +59,18 @@ static GDALDataset *OGRHTFDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                      OGRHTFDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRHTFDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                                   "Hydrographic Transfer Vector" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_htf.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRHTF()                           */
 /************************************************************************/
@@ -73,12 +85,10 @@ void RegisterOGRHTF()
 
     poDriver->SetDescription( "HTF" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                                   "Hydrographic Transfer Vector" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_htf.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRHTFDriverOpen;
+    poDriver->pfnInitMetadata = OGRHTFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -201,39 +201,46 @@ OGRLayer * OGRJMLDataset::ICreateLayer( const char * pszLayerName,
 }
 
 /************************************************************************/
-/*                         RegisterOGRJML()                             */
+/*                      OGRJMLDriverInitMetadata()                      */
 /************************************************************************/
 
-void RegisterOGRJML()
-{
-    if( GDALGetDriverByName( "JML" ) != NULL )
-        return;
-
-    GDALDriver  *poDriver = new GDALDriver();
+static void OGRJMLDriverInitMetadata( GDALDriver* poDriver )
 
-    poDriver->SetDescription( "JML" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+{
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "OpenJUMP JML" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "jml" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_jml.html" );
-
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
 "<LayerCreationOptionList>"
 "   <Option name='CREATE_R_G_B_FIELD' type='boolean' description='Whether to create a R_G_B field' default='YES'/>"
 "   <Option name='CREATE_OGR_STYLE_FIELD' type='boolean' description='Whether to create a OGR_STYLE field' default='NO'/>"
 "</LayerCreationOptionList>" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
                                "<CreationOptionList/>" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
                                "Integer Integer64 Real String Date DateTime" );
+}
+
+/************************************************************************/
+/*                         RegisterOGRJML()                             */
+/************************************************************************/
+
+void RegisterOGRJML()
+{
+    if( GDALGetDriverByName( "JML" ) != NULL )
+        return;
+
+    GDALDriver  *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "JML" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRJMLDataset::Open;
     poDriver->pfnIdentify = OGRJMLDataset::Identify;
     poDriver->pfnCreate = OGRJMLDataset::Create;
+    poDriver->pfnInitMetadata = OGRJMLDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
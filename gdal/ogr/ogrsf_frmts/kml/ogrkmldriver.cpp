@@ -111,23 +111,16 @@ static GDALDataset *OGRKMLDriverCreate( const char * pszName,
 }
 
 /************************************************************************/
-/*                           RegisterOGRKML()                           */
+/*                      OGRKMLDriverInitMetadata()                      */
 /************************************************************************/
 
-void RegisterOGRKML()
-{
-    if( GDALGetDriverByName( "KML" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
+static void OGRKMLDriverInitMetadata( GDALDriver* poDriver )
 
-    poDriver->SetDescription( "KML" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+{
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "Keyhole Markup Language (KML)" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "kml" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_kml.html" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "  <Option name='GPX_USE_EXTENSIONS' type='boolean' description='Whether to write non-GPX attributes in an <extensions> tag' default='NO'/>"
@@ -139,16 +132,32 @@ void RegisterOGRKML()
 "    <Value>absolute</Value>"
 "  </Option>"
 "</CreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
                                "<LayerCreationOptionList/>" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
                                "Integer Real String" );
+}
+
+/************************************************************************/
+/*                           RegisterOGRKML()                           */
+/************************************************************************/
+
+void RegisterOGRKML()
+{
+    if( GDALGetDriverByName( "KML" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "KML" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRKMLDriverOpen;
     poDriver->pfnIdentify = OGRKMLDriverIdentify;
     poDriver->pfnCreate = OGRKMLDriverCreate;
+    poDriver->pfnInitMetadata = OGRKMLDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
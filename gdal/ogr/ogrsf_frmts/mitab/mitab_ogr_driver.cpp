@@ -242,25 +242,20 @@ static void OGRTABDriverUnload(CPL_UNUSED GDALDriver* poDriver)
 extern "C"
 {
 
-void RegisterOGRTAB()
-
-{
-    if( GDALGetDriverByName( "MapInfo File" ) != NULL )
-        return;
+/************************************************************************/
+/*                      OGRTABDriverInitMetadata()                      */
+/************************************************************************/
 
-    GDALDriver *poDriver = new GDALDriver();
+static void OGRTABDriverInitMetadata( GDALDriver* poDriver )
 
-    poDriver->SetDescription( "MapInfo File" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+{
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "MapInfo File" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "tab mif mid" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_mitab.html" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
 "<LayerCreationOptionList>"
 "  <Option name='BOUNDS' type='string' description='Custom bounds. Expect format is xmin,ymin,xmax,ymax'/>"
 "</LayerCreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "  <Option name='FORMAT' type='string-select' description='type of MapInfo format'>"
@@ -273,15 +268,28 @@ void RegisterOGRTAB()
 "  </Option>"
 "  <Option name='BLOCKSIZE' type='int' description='.map block size' min='512' max='32256' default='512'/>"
 "</CreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
                                "Integer Real String Date DateTime Time" );
+}
+
+void RegisterOGRTAB()
+
+{
+    if( GDALGetDriverByName( "MapInfo File" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "MapInfo File" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRTABDriverOpen;
     poDriver->pfnIdentify = OGRTABDriverIdentify;
     poDriver->pfnCreate = OGRTABDriverCreate;
     poDriver->pfnDelete = OGRTABDriverDelete;
     poDriver->pfnUnloadDriver = OGRTABDriverUnload;
+    poDriver->pfnInitMetadata = OGRTABDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -84,6 +84,17 @@ static GDALDataset *OGRNTFDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                      OGRNTFDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRNTFDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "UK .NTF" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_ntf.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRNTF()                           */
 /************************************************************************/
@@ -98,10 +109,9 @@ void RegisterOGRNTF()
 
     poDriver->SetDescription( "UK .NTF" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "UK .NTF" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_ntf.html" );
 
     poDriver->pfnOpen = OGRNTFDriverOpen;
+    poDriver->pfnInitMetadata = OGRNTFDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -103,6 +103,17 @@ static GDALDataset *OGROpenAirDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                    OGROpenAirDriverInitMetadata()                    */
+/************************************************************************/
+
+static void OGROpenAirDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "OpenAir" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_openair.html" );
+}
+
 /************************************************************************/
 /*                         RegisterOGROpenAir()                         */
 /************************************************************************/
@@ -117,11 +128,10 @@ void RegisterOGROpenAir()
 
     poDriver->SetDescription( "OpenAir" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "OpenAir" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_openair.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGROpenAirDriverOpen;
+    poDriver->pfnInitMetadata = OGROpenAirDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
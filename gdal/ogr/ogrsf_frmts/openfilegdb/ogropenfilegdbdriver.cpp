@@ -201,6 +201,18 @@ static GDALDataset* OGROpenFileGDBDriverOpen( GDALOpenInfo* poOpenInfo )
     return NULL;
 }
 
+/************************************************************************/
+/*                  OGROpenFileGDBDriverInitMetadata()                  */
+/************************************************************************/
+
+static void OGROpenFileGDBDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ESRI FileGDB" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gdb" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_openfilegdb.html" );
+}
+
 /***********************************************************************/
 /*                       RegisterOGROpenFileGDB()                      */
 /***********************************************************************/
@@ -218,13 +230,11 @@ void RegisterOGROpenFileGDB()
 
     poDriver->SetDescription( "OpenFileGDB" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ESRI FileGDB" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "gdb" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_openfilegdb.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGROpenFileGDBDriverOpen;
     poDriver->pfnIdentify = OGROpenFileGDBDriverIdentify;
+    poDriver->pfnInitMetadata = OGROpenFileGDBDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -62,6 +62,18 @@ static GDALDataset *OGRPDSDriverOpen( GDALOpenInfo* poOpenInfo )
 }
 
 
+/************************************************************************/
+/*                      OGRPDSDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRPDSDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Planetary Data Systems TABLE" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_pds.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRPDS()                           */
 /************************************************************************/
@@ -76,12 +88,10 @@ void RegisterOGRPDS()
 
     poDriver->SetDescription( "OGR_PDS" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Planetary Data Systems TABLE" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_pds.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRPDSDriverOpen;
+    poDriver->pfnInitMetadata = OGRPDSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -59,23 +59,15 @@ static GDALDataset* OGRPGDumpDriverCreate( const char * pszName,
 }
 
 /************************************************************************/
-/*                        RegisterOGRPGDump()                           */
+/*                    OGRPGDumpDriverInitMetadata()                     */
 /************************************************************************/
 
-void RegisterOGRPGDump()
+static void OGRPGDumpDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "PGDUMP" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "PGDUMP" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "PostgreSQL SQL dump" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_pgdump.html" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "sql" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
     "<CreationOptionList>"
     #ifdef WIN32
@@ -87,7 +79,6 @@ void RegisterOGRPGDump()
     "    <Value>LF</Value>"
     "  </Option>"
     "</CreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
     "<LayerCreationOptionList>"
     "  <Option name='GEOM_TYPE' type='string-select' description='Format of geometry columns' default='geometry'>"
@@ -123,11 +114,27 @@ void RegisterOGRPGDump()
     "  <Option name='POSTGIS_VERSION' type='string' description='Can be set to 2.0 or 2.2 for PostGIS 2.0/2.2 compatibility. Important to set it correctly if using non-linear geometry types'/>"
     "  <Option name='DESCRIPTION' type='string' description='Description string to put in the pg_description system table'/>"
     "</LayerCreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
                                "Integer Integer64 Real String Date DateTime "
                                "Time IntegerList Integer64List RealList "
                                "StringList Binary" );
+}
+
+/************************************************************************/
+/*                        RegisterOGRPGDump()                           */
+/************************************************************************/
+
+void RegisterOGRPGDump()
+
+{
+    if( GDALGetDriverByName( "PGDUMP" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "PGDUMP" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
     poDriver->SetMetadataItem( GDAL_DCAP_NOTNULL_FIELDS, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_DEFAULT_FIELDS, "YES" );
     poDriver->SetMetadataItem( GDAL_DCAP_NOTNULL_GEOMFIELDS, "YES" );
@@ -135,6 +142,7 @@ void RegisterOGRPGDump()
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnCreate = OGRPGDumpDriverCreate;
+    poDriver->pfnInitMetadata = OGRPGDumpDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -63,6 +63,17 @@ static GDALDataset *OGRRECDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                      OGRRECDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRRECDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "rec" );
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "EPIInfo .REC " );
+}
+
 /************************************************************************/
 /*                           RegisterOGRREC()                          */
 /************************************************************************/
@@ -77,10 +88,9 @@ void RegisterOGRREC()
 
     poDriver->SetDescription( "REC" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "rec" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "EPIInfo .REC " );
 
     poDriver->pfnOpen = OGRRECDriverOpen;
+    poDriver->pfnInitMetadata = OGRRECDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -70,6 +70,17 @@ static GDALDataset *OGRSDTSDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                     OGRSDTSDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRSDTSDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "SDTS" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_sdts.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRSDTS()                          */
 /************************************************************************/
@@ -84,10 +95,9 @@ void RegisterOGRSDTS()
 
     poDriver->SetDescription( "OGR_SDTS" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "SDTS" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_sdts.html" );
 
     poDriver->pfnOpen = OGRSDTSDriverOpen;
+    poDriver->pfnInitMetadata = OGRSDTSDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -58,6 +58,17 @@ static GDALDataset *OGRSEGUKOOADriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                   OGRSEGUKOOADriverInitMetadata()                    */
+/************************************************************************/
+
+static void OGRSEGUKOOADriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "SEG-P1 / UKOOA P1/90" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_segukooa.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRSEGUKOOA()                       */
 /************************************************************************/
@@ -72,11 +83,10 @@ void RegisterOGRSEGUKOOA()
 
     poDriver->SetDescription( "SEGUKOOA" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "SEG-P1 / UKOOA P1/90" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_segukooa.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRSEGUKOOADriverOpen;
+    poDriver->pfnInitMetadata = OGRSEGUKOOADriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
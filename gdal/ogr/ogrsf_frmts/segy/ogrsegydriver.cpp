@@ -155,6 +155,17 @@ static GDALDataset *OGRSEGYDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                     OGRSEGYDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRSEGYDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "SEG-Y" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_segy.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRSEGY()                           */
 /************************************************************************/
@@ -169,11 +180,10 @@ void RegisterOGRSEGY()
 
     poDriver->SetDescription( "SEGY" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "SEG-Y" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_segy.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRSEGYDriverOpen;
+    poDriver->pfnInitMetadata = OGRSEGYDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -255,24 +255,16 @@ static CPLErr OGRShapeDriverDelete( const char *pszDataSource )
 }
 
 /************************************************************************/
-/*                          RegisterOGRShape()                          */
+/*                     OGRShapeDriverInitMetadata()                     */
 /************************************************************************/
 
-void RegisterOGRShape()
+static void OGRShapeDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "ESRI Shapefile" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "ESRI Shapefile" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "ESRI Shapefile" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "shp" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "shp dbf" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_shape.html" );
-
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
 "  <Option name='ENCODING' type='string' description='to override the encoding interpretation of the DBF with any encoding supported by CPLRecode or to \"\" to avoid any recoding'/>"
@@ -284,7 +276,6 @@ void RegisterOGRShape()
 "    <Value>ALL_SHAPES</Value>"
 "  </Option>"
 "</OpenOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
                                "<CreationOptionList/>" );
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
@@ -315,15 +306,32 @@ void RegisterOGRShape()
 "  <Option name='SPATIAL_INDEX' type='boolean' description='To create a spatial index.' default='NO'/>"
 "  <Option name='DBF_DATE_LAST_UPDATE' type='string' description='Modification date to write in DBF header with YYYY-MM-DD format'/>"
 "</LayerCreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
                                "Integer Integer64 Real String Date DateTime" );
+}
+
+/************************************************************************/
+/*                          RegisterOGRShape()                          */
+/************************************************************************/
+
+void RegisterOGRShape()
+
+{
+    if( GDALGetDriverByName( "ESRI Shapefile" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "ESRI Shapefile" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRShapeDriverOpen;
     poDriver->pfnIdentify = OGRShapeDriverIdentify;
     poDriver->pfnCreate = OGRShapeDriverCreate;
     poDriver->pfnDelete = OGRShapeDriverDelete;
+    poDriver->pfnInitMetadata = OGRShapeDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -99,6 +99,20 @@ static GDALDataset *OGRSUADriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                      OGRSUADriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRSUADriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "Tim Newport-Peace's Special Use Airspace "
+                               "Format" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
+                               "drv_sua.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRSUA()                           */
 /************************************************************************/
@@ -113,15 +127,11 @@ void RegisterOGRSUA()
 
     poDriver->SetDescription( "SUA" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "Tim Newport-Peace's Special Use Airspace "
-                               "Format" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC,
-                               "drv_sua.html" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRSUADriverOpen;
+    poDriver->pfnInitMetadata = OGRSUADriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -62,6 +62,18 @@ static GDALDataset *OGRSVGDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                      OGRSVGDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRSVGDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Scalable Vector Graphics" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "svg" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_svg.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRSVG()                           */
 /************************************************************************/
@@ -79,12 +91,10 @@ void RegisterOGRSVG()
 
     poDriver->SetDescription( "SVG" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Scalable Vector Graphics" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "svg" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_svg.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRSVGDriverOpen;
+    poDriver->pfnInitMetadata = OGRSVGDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -104,6 +104,17 @@ static GDALDataset *OGRTigerDriverCreate( const char * pszName,
     }
 }
 
+/************************************************************************/
+/*                     OGRTigerDriverInitMetadata()                     */
+/************************************************************************/
+
+static void OGRTigerDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "U.S. Census TIGER/Line" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_tiger.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRTiger()                         */
 /************************************************************************/
@@ -118,12 +129,11 @@ void RegisterOGRTiger()
 
     poDriver->SetDescription( "TIGER" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "U.S. Census TIGER/Line" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_tiger.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRTigerDriverOpen;
     poDriver->pfnCreate = OGRTigerDriverCreate;
+    poDriver->pfnInitMetadata = OGRTigerDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -1805,33 +1805,23 @@ GDALDataset* OGRVDVDataSource::Create( const char * pszName,
 }
 
 /************************************************************************/
-/*                         RegisterOGRVDV()                             */
+/*                      OGRVDVDriverInitMetadata()                      */
 /************************************************************************/
 
-void RegisterOGRVDV()
+static void OGRVDVDriverInitMetadata( GDALDriver* poDriver )
 
 {
-    if( GDALGetDriverByName( "VDV" ) != NULL )
-        return;
-
-    GDALDriver *poDriver = new GDALDriver();
-
-    poDriver->SetDescription( "VDV" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
                                "VDV-451/VDV-452/INTREST Data Format" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_vdv.html" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "txt x10");
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
                                "Integer Integer64 String" );
-
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
 "<CreationOptionList>"
 "  <Option name='SINGLE_FILE' type='boolean' description='Whether several layers "
 "should be put in the same file. If no, the name is assumed to be a directory name' default='YES'/>"
 "</CreationOptionList>");
-
     poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
 "<LayerCreationOptionList>"
 "  <Option name='EXTENSION' type='string' description='Layer file extension. Only used for SINGLE_FILE=NO' default='x10'/>"
@@ -1855,9 +1845,28 @@ void RegisterOGRVDV()
 "  <Option name='HEADER_FFT' type='string' description='Value of the fft header field' default=''/>"
 "  <Option name='HEADER_*' type='string' description='Value of another header field'/>"
 "</LayerCreationOptionList>");
+}
+
+/************************************************************************/
+/*                         RegisterOGRVDV()                             */
+/************************************************************************/
+
+void RegisterOGRVDV()
+
+{
+    if( GDALGetDriverByName( "VDV" ) != NULL )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "VDV" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
+
     poDriver->pfnIdentify = OGRVDVDriverIdentify;
     poDriver->pfnOpen = OGRVDVDataSource::Open;
     poDriver->pfnCreate = OGRVDVDataSource::Create;
+    poDriver->pfnInitMetadata = OGRVDVDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
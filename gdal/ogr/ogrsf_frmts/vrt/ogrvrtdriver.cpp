@@ -184,6 +184,18 @@ static GDALDataset *OGRVRTDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                      OGRVRTDriverInitMetadata()                      */
+/************************************************************************/
+
+static void OGRVRTDriverInitMetadata( GDALDriver* poDriver )
+
+{
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "VRT - Virtual Datasource" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "vrt" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_vrt.html" );
+}
+
 /************************************************************************/
 /*                           RegisterOGRVRT()                           */
 /************************************************************************/
@@ -198,13 +210,11 @@ void RegisterOGRVRT()
 
     poDriver->SetDescription( "OGR_VRT" );
     poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "VRT - Virtual Datasource" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "vrt" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_vrt.html" );
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
 
     poDriver->pfnOpen = OGRVRTDriverOpen;
     poDriver->pfnIdentify = OGRVRTDriverIdentify;
+    poDriver->pfnInitMetadata = OGRVRTDriverInitMetadata;
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
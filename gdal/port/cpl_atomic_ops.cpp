@@ -168,3 +168,87 @@ int CPLAtomicCompareAndExchange(volatile int* ptr, int oldval, int newval)
 }
 
 #endif
+
+/************************************************************************/
+/*                           CPLAtomicAdd64()                           */
+/************************************************************************/
+
+#if defined(__MACH__) && defined(__APPLE__)
+
+GIntBig CPLAtomicAdd64(volatile GIntBig* ptr, GIntBig increment)
+{
+  return OSAtomicAdd64(increment, (int64_t*)(ptr));
+}
+
+#elif defined(_MSC_VER) && (_MSC_VER > 1200) && (defined(_M_IX86) || defined(_M_X64))
+
+GIntBig CPLAtomicAdd64(volatile GIntBig* ptr, GIntBig increment)
+{
+  return InterlockedExchangeAdd64((volatile LONGLONG*)(ptr), (LONGLONG)(increment)) + increment;
+}
+
+#elif defined(__GNUC__) && defined(__x86_64__)
+
+GIntBig CPLAtomicAdd64(volatile GIntBig* ptr, GIntBig increment)
+{
+  GIntBig temp = increment;
+  __asm__ __volatile__("lock; xaddq %0,%1"
+                       : "+r" (temp), "+m" (*ptr)
+                       : : "memory");
+  return temp + increment;
+}
+
+#elif defined(HAVE_GCC_ATOMIC_BUILTINS) && defined(__LP64__)
+
+GIntBig CPLAtomicAdd64(volatile GIntBig* ptr, GIntBig increment)
+{
+  return __sync_add_and_fetch(ptr, increment);
+}
+
+#else
+
+#include "cpl_multiproc.h"
+
+static CPLLock *hAtomicOp64Lock = NULL;
+
+// Slow, but safe, implementation using a lock. Also used on 32 bit x86,
+// where 64 bit GCC builtins require at least -march=i586.
+GIntBig CPLAtomicAdd64(volatile GIntBig* ptr, GIntBig increment)
+{
+    CPLLockHolderD(&hAtomicOp64Lock, LOCK_SPIN);
+    (*ptr) += increment;
+    return *ptr;
+}
+
+#endif
+
+/************************************************************************/
+/*                          CPLMemoryBarrier()                          */
+/************************************************************************/
+
+#if defined(__MACH__) && defined(__APPLE__)
+
+void CPLMemoryBarrier()
+{
+    OSMemoryBarrier();
+}
+
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+
+void CPLMemoryBarrier()
+{
+    MemoryBarrier();
+}
+
+#else
+
+// The locked instructions and the GCC builtins used by CPLAtomicAdd() are
+// full barriers, and so is the mutex of the fallback implementation. The
+// variable is local, so that concurrent callers do not share a cache line.
+void CPLMemoryBarrier()
+{
+    volatile int nDummy = 0;
+    CPLAtomicAdd(&nDummy, 0);
+}
+
+#endif
@@ -60,6 +60,26 @@ CPL_C_START
   */
 int CPL_DLL CPLAtomicAdd(volatile int* ptr, int increment);
 
+/** Add a value to a pointed 64 bit integer in a thread and SMP-safe way
+  * and return the resulting value of the operation.
+  *
+  * This is the 64 bit version of CPLAtomicAdd(), typically used to maintain
+  * counters that could overflow a 32 bit integer. An efficient implementation
+  * exists on MacOSX, MS Windows, x86_64 with GCC and 64 bit platforms
+  * supported by GCC 4.1 or higher. On other platforms, including 32 bit
+  * x86 with GCC, the atomicity is done with a lock.
+  *
+  * A consistent value of the pointed integer can be read with
+  * CPLAtomicAdd64(ptr, 0) on platforms where 64 bit loads are not atomic.
+  *
+  * @param ptr a pointer to a 64 bit integer to increment (aligned on a 64 bit
+  *            boundary)
+  * @param increment the amount to add to the pointed integer
+  * @return the pointed value AFTER the result of the addition
+  * @since GDAL 2.2
+  */
+GIntBig CPL_DLL CPLAtomicAdd64(volatile GIntBig* ptr, GIntBig increment);
+
 /** Increment of 1 the pointed integer in a thread and SMP-safe way
   * and return the resulting value of the operation.
   *
@@ -101,6 +121,21 @@ int CPL_DLL CPLAtomicAdd(volatile int* ptr, int increment);
   */
 int CPLAtomicCompareAndExchange(volatile int* ptr, int oldval, int newval);
 
+/** Full memory barrier: the memory accesses issued before the call are
+  * visible to the other threads before the ones issued after it.
+  *
+  * This is typically used to publish a structure initialized without a lock:
+  * the writer fills the structure, calls CPLMemoryBarrier(), then sets the
+  * flag (or pointer) telling that it is ready. A reader seeing the flag set
+  * calls CPLMemoryBarrier() before accessing the structure.
+  *
+  * Unlike CPLAtomicAdd(ptr, 0), this does not write to any shared memory
+  * location, so it does not make the threads reading a same flag contend.
+  *
+  * @since GDAL 2.2
+  */
+void CPL_DLL CPLMemoryBarrier(void);
+
 CPL_C_END
 
 #endif /* CPL_ATOMIC_OPS_INCLUDED */
@@ -172,6 +172,10 @@ typedef struct
     CPLVirtualMemCachePageCbk     pfnCachePage;       /* called when a page is mapped */
     CPLVirtualMemUnCachePageCbk   pfnUnCachePage;     /* called when a (writable) page is unmapped */
 
+    CPLVirtualMemGetSharedPageCbk     pfnGetSharedPage;     /* returns memory to map without copy */
+    CPLVirtualMemReleaseSharedPageCbk pfnReleaseSharedPage; /* called when such a page is unmapped */
+    void       **papSharedPageHandles;   /* handles of pages mapped without copy, by LRU index */
+
 #ifndef HAVE_5ARGS_MREMAP
     CPLMutex               *hMutexThreadArray;
     int                     nThreads;
@@ -435,6 +439,136 @@ CPLVirtualMem* CPLVirtualMemNew(size_t nSize,
     return (CPLVirtualMem*) ctxt;
 }
 
+/************************************************************************/
+/*                        CPLVirtualMemSharedNew()                      */
+/************************************************************************/
+
+CPLVirtualMem* CPLVirtualMemSharedNew(size_t nSize,
+                                      size_t nCacheSize,
+                                      size_t nPageSize,
+                                      int bSingleThreadUsage,
+                                      CPLVirtualMemAccessMode eAccessMode,
+                                      CPLVirtualMemGetSharedPageCbk pfnGetSharedPage,
+                                      CPLVirtualMemReleaseSharedPageCbk pfnReleaseSharedPage,
+                                      CPLVirtualMemCachePageCbk pfnCachePage,
+                                      CPLVirtualMemUnCachePageCbk pfnUnCachePage,
+                                      CPLVirtualMemFreeUserData pfnFreeUserData,
+                                      void *pCbkUserData)
+{
+#ifndef HAVE_5ARGS_MREMAP
+    (void)nSize;
+    (void)nCacheSize;
+    (void)nPageSize;
+    (void)bSingleThreadUsage;
+    (void)eAccessMode;
+    (void)pfnGetSharedPage;
+    (void)pfnReleaseSharedPage;
+    (void)pfnCachePage;
+    (void)pfnUnCachePage;
+    (void)pfnFreeUserData;
+    (void)pCbkUserData;
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "CPLVirtualMemSharedNew() unsupported on "
+             "this operating system / configuration");
+    return NULL;
+#else
+    IGNORE_OR_ASSERT_IN_DEBUG(pfnGetSharedPage != NULL);
+    IGNORE_OR_ASSERT_IN_DEBUG(pfnReleaseSharedPage != NULL);
+
+    /* Writes into a shared page are not lost, so they must be tracked */
+    if( eAccessMode == VIRTUALMEM_READONLY ||
+        nPageSize == 0 || (nPageSize % CPLGetPageSize()) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "CPLVirtualMemSharedNew(): unsupported access mode or "
+                 "page size");
+        return NULL;
+    }
+
+    CPLVirtualMemVMA* ctxt = reinterpret_cast<CPLVirtualMemVMA*>(
+        CPLVirtualMemNew( nSize, nCacheSize, nPageSize, bSingleThreadUsage,
+                          eAccessMode, pfnCachePage, pfnUnCachePage,
+                          NULL, NULL ) );
+    if( ctxt == NULL )
+        return NULL;
+
+    /* The page size may have been increased to limit the number of */
+    /* mappings, but shared pages cannot be gathered */
+    if( ctxt->sBase.nPageSize != nPageSize )
+    {
+        CPLVirtualMemFree( (CPLVirtualMem*)ctxt );
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "CPLVirtualMemSharedNew(): cache too large for page size");
+        return NULL;
+    }
+
+    ctxt->papSharedPageHandles = static_cast<void**>(
+        VSI_CALLOC_VERBOSE(ctxt->nCacheMaxSizeInPages, sizeof(void*)));
+    if( ctxt->papSharedPageHandles == NULL )
+    {
+        CPLVirtualMemFree( (CPLVirtualMem*)ctxt );
+        return NULL;
+    }
+    ctxt->sBase.pfnFreeUserData = pfnFreeUserData;
+    ctxt->sBase.pCbkUserData = pCbkUserData;
+    ctxt->pfnReleaseSharedPage = pfnReleaseSharedPage;
+    /* Set last, as it enables the mapping of shared pages */
+    ctxt->pfnGetSharedPage = pfnGetSharedPage;
+
+    return (CPLVirtualMem*) ctxt;
+#endif
+}
+
+/************************************************************************/
+/*                   CPLVirtualMemSharedPagesAlloc()                    */
+/************************************************************************/
+
+/* Each allocation is a mapping of its own, so only a part of the */
+/* mappings allowed by the kernel are used for them */
+static volatile int nSharedPagesAllocations = 0;
+
+void* CPLVirtualMemSharedPagesAlloc(size_t nSize)
+{
+#ifdef HAVE_5ARGS_MREMAP
+    if( nSize == 0 || (nSize % CPLGetPageSize()) != 0 )
+        return NULL;
+    if( CPLAtomicInc(&nSharedPagesAllocations) > MAXIMUM_COUNT_OF_MAPPINGS / 4 )
+    {
+        CPLAtomicDec(&nSharedPagesAllocations);
+        return NULL;
+    }
+    void* pData = mmap(NULL, nSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if( pData == MAP_FAILED )
+    {
+        CPLAtomicDec(&nSharedPagesAllocations);
+        return NULL;
+    }
+    return pData;
+#else
+    (void)nSize;
+    return NULL;
+#endif
+}
+
+/************************************************************************/
+/*                    CPLVirtualMemSharedPagesFree()                    */
+/************************************************************************/
+
+void CPLVirtualMemSharedPagesFree(void* pData, size_t nSize)
+{
+#ifdef HAVE_5ARGS_MREMAP
+    if( pData == NULL )
+        return;
+    const int nRet = munmap(pData, nSize);
+    IGNORE_OR_ASSERT_IN_DEBUG(nRet == 0);
+    CPLAtomicDec(&nSharedPagesAllocations);
+#else
+    (void)pData;
+    (void)nSize;
+#endif
+}
+
 /************************************************************************/
 /*                       CPLVirtualMemFreeVMA()                         */
 /************************************************************************/
@@ -445,6 +579,21 @@ static void CPLVirtualMemFreeFileMemoryMapped(CPLVirtualMemVMA* ctxt)
 
     size_t nRoundedMappingSize = ((ctxt->sBase.nSize + 2 * ctxt->sBase.nPageSize - 1) /
                                             ctxt->sBase.nPageSize) * ctxt->sBase.nPageSize;
+    if( ctxt->papSharedPageHandles != NULL )
+    {
+        for( int i = 0; i < ctxt->nLRUSize; i++ )
+        {
+            if( ctxt->papSharedPageHandles[i] == NULL )
+                continue;
+            const int iPage = ctxt->panLRUPageIndices[i];
+            const int bDirty = TEST_BIT(ctxt->pabitRWMappedPages, iPage) != 0;
+            UNSET_BIT(ctxt->pabitRWMappedPages, iPage);
+            ctxt->pfnReleaseSharedPage((CPLVirtualMem*)ctxt,
+                                       iPage * ctxt->sBase.nPageSize,
+                                       ctxt->papSharedPageHandles[i], bDirty,
+                                       ctxt->sBase.pCbkUserData);
+        }
+    }
     if( ctxt->sBase.eAccessMode == VIRTUALMEM_READWRITE &&
         ctxt->pabitRWMappedPages != NULL &&
         ctxt->pfnUnCachePage != NULL )
@@ -467,6 +616,7 @@ static void CPLVirtualMemFreeFileMemoryMapped(CPLVirtualMemVMA* ctxt)
     CPLFree(ctxt->pabitMappedPages);
     CPLFree(ctxt->pabitRWMappedPages);
     CPLFree(ctxt->panLRUPageIndices);
+    CPLFree(ctxt->papSharedPageHandles);
 #ifndef HAVE_5ARGS_MREMAP
     if( !ctxt->sBase.bSingleThreadUsage )
     {
@@ -603,9 +753,11 @@ void* CPLVirtualMemGetPageToFill(CPLVirtualMemVMA* ctxt, void* start_page_addr)
 /*                        CPLVirtualMemAddPage()                        */
 /************************************************************************/
 
+/* If pSharedHandle is not NULL, the page returned by pfnGetSharedPage has */
+/* already been mapped at target_addr, and pPageToFill is unused */
 static
 void CPLVirtualMemAddPage(CPLVirtualMemVMA* ctxt, void* target_addr, void* pPageToFill,
-                       OpType opType, pthread_t hRequesterThread)
+                       void* pSharedHandle, OpType opType, pthread_t hRequesterThread)
 {
     int iPage = static_cast<int>(((char*)target_addr - (char*)ctxt->sBase.pData) / ctxt->sBase.nPageSize);
     if( ctxt->nLRUSize == ctxt->nCacheMaxSizeInPages )
@@ -615,7 +767,11 @@ void CPLVirtualMemAddPage(CPLVirtualMemVMA* ctxt, void* target_addr, void* pPage
 #endif
         int nOldPage = ctxt->panLRUPageIndices[ctxt->iLRUStart];
         void* addr = (char*)ctxt->sBase.pData + nOldPage * ctxt->sBase.nPageSize;
-        if( ctxt->sBase.eAccessMode == VIRTUALMEM_READWRITE &&
+        void* pOldSharedHandle = (ctxt->papSharedPageHandles != NULL) ?
+                        ctxt->papSharedPageHandles[ctxt->iLRUStart] : NULL;
+        const int bOldPageDirty = TEST_BIT(ctxt->pabitRWMappedPages, nOldPage) != 0;
+        if( pOldSharedHandle == NULL &&
+            ctxt->sBase.eAccessMode == VIRTUALMEM_READWRITE &&
             ctxt->pfnUnCachePage != NULL &&
             TEST_BIT(ctxt->pabitRWMappedPages, nOldPage) )
         {
@@ -637,7 +793,19 @@ void CPLVirtualMemAddPage(CPLVirtualMemVMA* ctxt, void* target_addr, void* pPage
         const void * const pRet = mmap(addr, ctxt->sBase.nPageSize, PROT_NONE,
                     MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
         IGNORE_OR_ASSERT_IN_DEBUG(pRet == addr);
+        /* The content of a shared page is already in the memory of its */
+        /* owner, which can now get it back */
+        if( pOldSharedHandle != NULL )
+        {
+            ctxt->papSharedPageHandles[ctxt->iLRUStart] = NULL;
+            ctxt->pfnReleaseSharedPage((CPLVirtualMem*)ctxt,
+                                       nOldPage * ctxt->sBase.nPageSize,
+                                       pOldSharedHandle, bOldPageDirty,
+                                       ctxt->sBase.pCbkUserData);
+        }
     }
+    if( ctxt->papSharedPageHandles != NULL )
+        ctxt->papSharedPageHandles[ctxt->iLRUStart] = pSharedHandle;
     ctxt->panLRUPageIndices[ctxt->iLRUStart] = iPage;
     ctxt->iLRUStart = (ctxt->iLRUStart + 1) % ctxt->nCacheMaxSizeInPages;
     if( ctxt->nLRUSize < ctxt->nCacheMaxSizeInPages )
@@ -646,6 +814,25 @@ void CPLVirtualMemAddPage(CPLVirtualMemVMA* ctxt, void* target_addr, void* pPage
     }
     SET_BIT(ctxt->pabitMappedPages, iPage);
 
+    if( pSharedHandle != NULL )
+    {
+        (void)pPageToFill;
+        (void)hRequesterThread;
+
+        /* The page is mapped read-write, as the memory it comes from */
+        if( opType == OP_STORE && ctxt->sBase.eAccessMode == VIRTUALMEM_READWRITE )
+        {
+            SET_BIT(ctxt->pabitRWMappedPages, iPage);
+        }
+        else
+        {
+            const int nRet =
+                mprotect(target_addr, ctxt->sBase.nPageSize, PROT_READ);
+            IGNORE_OR_ASSERT_IN_DEBUG(nRet == 0);
+        }
+        return;
+    }
+
     if( ctxt->sBase.bSingleThreadUsage )
     {
         if( opType == OP_STORE && ctxt->sBase.eAccessMode == VIRTUALMEM_READWRITE )
@@ -769,6 +956,52 @@ void CPLVirtualMemAddPage(CPLVirtualMemVMA* ctxt, void* target_addr, void* pPage
     }
 }
 
+/************************************************************************/
+/*                     CPLVirtualMemMapSharedPage()                     */
+/*                                                                      */
+/*      Asks the pfnGetSharedPage callback for the memory of the page,  */
+/*      and maps it at the location of the page. Returns false if the   */
+/*      page must be filled by the pfnCachePage callback instead.       */
+/************************************************************************/
+
+static
+bool CPLVirtualMemMapSharedPage(CPLVirtualMemVMA* ctxt, void* target_addr,
+                                OpType opType, pthread_t hRequesterThread)
+{
+#ifdef HAVE_5ARGS_MREMAP
+    const size_t nOffset = (char*)target_addr - (char*)ctxt->sBase.pData;
+    void* pSharedHandle = NULL;
+    void* pSharedPage = ctxt->pfnGetSharedPage((CPLVirtualMem*)ctxt, nOffset,
+                                               &pSharedHandle,
+                                               ctxt->sBase.pCbkUserData);
+    if( pSharedPage == NULL )
+        return false;
+
+    /* With an old size of 0, mremap() creates a second mapping of the */
+    /* pages of the shared mapping */
+    const void * const pRet =
+        mremap( pSharedPage, 0, ctxt->sBase.nPageSize,
+                MREMAP_MAYMOVE | MREMAP_FIXED, target_addr );
+    if( pRet != target_addr )
+    {
+        ctxt->pfnReleaseSharedPage((CPLVirtualMem*)ctxt, nOffset,
+                                   pSharedHandle, FALSE,
+                                   ctxt->sBase.pCbkUserData);
+        return false;
+    }
+
+    CPLVirtualMemAddPage(ctxt, target_addr, NULL, pSharedHandle,
+                         opType, hRequesterThread);
+    return true;
+#else
+    (void)ctxt;
+    (void)target_addr;
+    (void)opType;
+    (void)hRequesterThread;
+    return false;
+#endif
+}
+
 /************************************************************************/
 /*                    CPLVirtualMemGetOpTypeImm()                       */
 /************************************************************************/
@@ -1764,6 +1997,13 @@ static void CPLVirtualMemManagerThread(void* unused_param)
 #endif
                     }
                 }
+                else if( ctxt->pfnGetSharedPage != NULL &&
+                         CPLVirtualMemMapSharedPage(ctxt, start_page_addr,
+                                                    msg.opType,
+                                                    msg.hRequesterThread) )
+                {
+                    /* Mapped without copy */
+                }
                 else
                 {
                     void * const pPageToFill =
@@ -1783,7 +2023,7 @@ static void CPLVirtualMemManagerThread(void* unused_param)
                     /* Now remap this page to its target address and */
                     /* register it in the LRU */
                     CPLVirtualMemAddPage(ctxt, start_page_addr, pPageToFill,
-                                      msg.opType, msg.hRequesterThread);
+                                      NULL, msg.opType, msg.hRequesterThread);
                 }
             }
 
@@ -1917,6 +2157,31 @@ CPLVirtualMem *CPLVirtualMemNew( size_t /* nSize */,
     return NULL;
 }
 
+CPLVirtualMem *CPLVirtualMemSharedNew( size_t /* nSize */,
+                                 size_t /* nCacheSize */,
+                                 size_t /* nPageSize */,
+                                 int /* bSingleThreadUsage */,
+                                 CPLVirtualMemAccessMode /* eAccessMode */,
+                                 CPLVirtualMemGetSharedPageCbk /* pfnGetSharedPage */,
+                                 CPLVirtualMemReleaseSharedPageCbk /* pfnReleaseSharedPage */,
+                                 CPLVirtualMemCachePageCbk /* pfnCachePage */,
+                                 CPLVirtualMemUnCachePageCbk /* pfnUnCachePage */,
+                                 CPLVirtualMemFreeUserData /* pfnFreeUserData */,
+                                 void * /* pCbkUserData  */)
+{
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "CPLVirtualMemSharedNew() unsupported on "
+             "this operating system / configuration");
+    return NULL;
+}
+
+void* CPLVirtualMemSharedPagesAlloc( size_t /* nSize */ )
+{
+    return NULL;
+}
+
+void CPLVirtualMemSharedPagesFree( void* /* pData */, size_t /* nSize */ ) {}
+
 void CPLVirtualMemDeclareThread( CPLVirtualMem* /* ctxt */ ) {}
 
 void CPLVirtualMemUnDeclareThread( CPLVirtualMem* /* ctxt */ ) {}
@@ -91,6 +91,42 @@ typedef void (*CPLVirtualMemUnCachePageCbk)(CPLVirtualMem* ctxt,
                                       size_t nToBeEvicted,
                                       void* pUserData);
 
+/** Callback triggered when a still unmapped page of a virtual memory mapping
+  * created with CPLVirtualMemSharedNew() is accessed.
+  * The callback may return the address of memory allocated with
+  * CPLVirtualMemSharedPagesAlloc() that holds the content of the page, and
+  * that will be mapped at the location of the page without copy. That memory
+  * must remain valid until the pfnReleaseSharedPage callback is called with
+  * the handle set in *ppPageHandle. If the callback returns NULL, the page
+  * is filled with the pfnCachePage callback.
+  *
+  * @param ctxt virtual memory handle.
+  * @param nOffset offset of the page in the memory mapping.
+  * @param ppPageHandle location into which to store a handle of the page.
+  * @param pUserData user data that was passed to CPLVirtualMemSharedNew().
+  * @return the address of the memory of the page, or NULL.
+  */
+typedef void* (*CPLVirtualMemGetSharedPageCbk)(CPLVirtualMem* ctxt,
+                                               size_t nOffset,
+                                               void** ppPageHandle,
+                                               void* pUserData);
+
+/** Callback triggered when a page returned by the pfnGetSharedPage callback
+  * is unmapped (saturation of cache, or termination of the virtual memory
+  * mapping).
+  *
+  * @param ctxt virtual memory handle.
+  * @param nOffset offset of the page in the memory mapping.
+  * @param pPageHandle handle set by the pfnGetSharedPage callback.
+  * @param bDirty TRUE if the page may have been modified through the mapping.
+  * @param pUserData user data that was passed to CPLVirtualMemSharedNew().
+  */
+typedef void (*CPLVirtualMemReleaseSharedPageCbk)(CPLVirtualMem* ctxt,
+                                                  size_t nOffset,
+                                                  void* pPageHandle,
+                                                  int bDirty,
+                                                  void* pUserData);
+
 /** Callback triggered when a virtual memory mapping is destroyed.
   * @param pUserData user data that was passed to CPLVirtualMemNew().
  */
@@ -174,6 +210,77 @@ CPLVirtualMem CPL_DLL *CPLVirtualMemNew(size_t nSize,
                                         void *pCbkUserData);
 
 
+/** Create a new virtual memory mapping whose pages may be mapped without copy
+ * onto memory provided by the caller.
+ *
+ * This is similar to CPLVirtualMemNew(), except that when a page is accessed,
+ * the pfnGetSharedPage callback is first invited to return memory holding the
+ * content of the page, typically a buffer of a cache owned by the caller,
+ * which is then mapped at the location of the page. Writes through the
+ * mapping go directly to that memory. Pages for which pfnGetSharedPage
+ * returns NULL are handled as with CPLVirtualMemNew().
+ *
+ * Only supported on Linux, with a mremap() supporting 5 arguments.
+ *
+ * @param nSize size in bytes of the virtual memory mapping.
+ * @param nCacheSize   size in bytes of the maximum memory that will be mapped.
+ * @param nPageSize page size. Must be a multiple of the system page size,
+ *                  returned by CPLGetPageSize(). Unlike CPLVirtualMemNew(),
+ *                  it is never adjusted.
+ * @param bSingleThreadUsage set to TRUE if there will be no concurrent threads
+ *                           that will access the virtual memory mapping.
+ * @param eAccessMode permission to use for the virtual memory mapping. Must be
+ *                    VIRTUALMEM_READONLY_ENFORCED or VIRTUALMEM_READWRITE.
+ * @param pfnGetSharedPage callback returning the memory to map for a page.
+ * @param pfnReleaseSharedPage callback triggered when such a page is unmapped.
+ * @param pfnCachePage callback filling the other pages.
+ * @param pfnUnCachePage callback triggered when a dirty page, other than the
+ *                       ones returned by pfnGetSharedPage, is going to be
+ *                       freed. Might be NULL.
+ * @param pfnFreeUserData callback that can be used to free pCbkUserData. Might be
+ *                        NULL
+ * @param pCbkUserData user data passed to the callbacks.
+ * @return a virtual memory object that must be freed by CPLVirtualMemFree(),
+ *         or NULL in case of failure.
+ * @since GDAL 2.2
+ */
+CPLVirtualMem CPL_DLL *CPLVirtualMemSharedNew(size_t nSize,
+                                    size_t nCacheSize,
+                                    size_t nPageSize,
+                                    int bSingleThreadUsage,
+                                    CPLVirtualMemAccessMode eAccessMode,
+                                    CPLVirtualMemGetSharedPageCbk pfnGetSharedPage,
+                                    CPLVirtualMemReleaseSharedPageCbk pfnReleaseSharedPage,
+                                    CPLVirtualMemCachePageCbk pfnCachePage,
+                                    CPLVirtualMemUnCachePageCbk pfnUnCachePage,
+                                    CPLVirtualMemFreeUserData pfnFreeUserData,
+                                    void *pCbkUserData);
+
+/** Allocate memory that can be returned by the pfnGetSharedPage callback of
+ * CPLVirtualMemSharedNew().
+ *
+ * The number of such allocations alive at the same time is limited, since
+ * each of them consumes a memory mapping of the process.
+ *
+ * @param nSize size in bytes, multiple of CPLGetPageSize().
+ * @return page aligned memory, initialized to 0, to free with
+ *         CPLVirtualMemSharedPagesFree(), or NULL if it cannot be allocated
+ *         or is not supported.
+ * @since GDAL 2.2
+ */
+void CPL_DLL *CPLVirtualMemSharedPagesAlloc(size_t nSize);
+
+/** Free memory allocated with CPLVirtualMemSharedPagesAlloc().
+ *
+ * Mappings of that memory through CPLVirtualMemSharedNew() remain valid until
+ * they are unmapped.
+ *
+ * @param pData memory returned by CPLVirtualMemSharedPagesAlloc().
+ * @param nSize the size passed to CPLVirtualMemSharedPagesAlloc().
+ * @since GDAL 2.2
+ */
+void CPL_DLL CPLVirtualMemSharedPagesFree(void* pData, size_t nSize);
+
 /** Return if virtual memory mapping of a file is available.
  *
  * @return TRUE if virtual memory mapping of a file is available.
@@ -889,6 +889,9 @@ VSILFILE *VSIFileFromMemBuffer( const char *pszFilename,
         poFile->nRefCount++;
     }
 
+    // The file may have been created
+    VSIInvalidateReadDirCache( osFilename );
+
     return (VSILFILE *) poHandler->Open( osFilename, "r+" );
 }
 
@@ -946,6 +949,8 @@ GByte *VSIGetMemFileBuffer( const char *pszFilename,
         poHandler->oFileList.erase( poHandler->oFileList.find(osFilename) );
         --(poFile->nRefCount);
         delete poFile;
+
+        VSIInvalidateReadDirCache( osFilename );
     }
 
     return pabyData;
@@ -34,6 +34,8 @@
 #include "cpl_vsi_virtual.h"
 
 #include <cassert>
+#include <ctime>
+#include <map>
 #include <string>
 
 CPL_CVSID("$Id$");
@@ -103,6 +105,167 @@ char **VSIReadDirEx(const char *pszPath, int nMaxFiles)
     return poFSHandler->ReadDirEx( pszPath, nMaxFiles );
 }
 
+/************************************************************************/
+/*                          VSIReadDirCached()                          */
+/************************************************************************/
+
+typedef struct
+{
+    char  **papszFiles;
+    int     nMaxFiles;
+    time_t  nTime;
+} VSIReadDirCacheEntry;
+
+static CPLMutex *hReadDirCacheMutex = NULL;
+static std::map<CPLString, VSIReadDirCacheEntry> *poReadDirCache = NULL;
+// Incremented on each invalidation, so that a listing read concurrently
+// with a change of the directory is not cached.
+static GUIntBig nReadDirCacheGeneration = 0;
+
+static void VSIReadDirCacheRemove_unlocked(
+    std::map<CPLString, VSIReadDirCacheEntry>::iterator oIter )
+{
+    CSLDestroy( oIter->second.papszFiles );
+    poReadDirCache->erase( oIter );
+}
+
+/**
+ * \brief Read names in a directory, from a process-wide cache.
+ *
+ * Same as VSIReadDirEx(), except that when the GDAL_READDIR_CACHE_TTL
+ * configuration option is set to a number of seconds, the listing is kept
+ * in a cache shared by all threads and reused during that time, so that
+ * opening many files of the same directory does not read it again and again.
+ *
+ * Entries are invalidated when a file of the directory is created (opened
+ * for writing or appending), renamed or deleted through the VSI API, or
+ * when a sub-directory is created or deleted through it. Changes made by
+ * other processes or outside of the VSI API are only seen once the entry
+ * has expired.
+ *
+ * @param pszPath the relative, or absolute path of a directory to read.
+ * UTF-8 encoded.
+ * @param nMaxFiles maximum number of files after which to stop, or 0 for no limit.
+ * @return The list of entries in the directory, or NULL if the directory
+ * doesn't exist.  Filenames are returned in UTF-8 encoding.
+ * @since GDAL 2.2
+ */
+
+char **VSIReadDirCached( const char *pszPath, int nMaxFiles )
+{
+    const int nTTL =
+        atoi(CPLGetConfigOption("GDAL_READDIR_CACHE_TTL", "0"));
+    if( nTTL <= 0 )
+        return VSIReadDirEx( pszPath, nMaxFiles );
+
+    const time_t nNow = time(NULL);
+    GUIntBig nGeneration;
+    {
+        CPLMutexHolderD( &hReadDirCacheMutex );
+        if( poReadDirCache != NULL )
+        {
+            std::map<CPLString, VSIReadDirCacheEntry>::iterator oIter =
+                poReadDirCache->find( pszPath );
+            if( oIter != poReadDirCache->end() )
+            {
+                if( oIter->second.nMaxFiles == nMaxFiles &&
+                    nNow >= oIter->second.nTime &&
+                    nNow - oIter->second.nTime < nTTL )
+                {
+                    return CSLDuplicate( oIter->second.papszFiles );
+                }
+                VSIReadDirCacheRemove_unlocked( oIter );
+            }
+        }
+        nGeneration = nReadDirCacheGeneration;
+    }
+
+    char** papszFiles = VSIReadDirEx( pszPath, nMaxFiles );
+
+    {
+        CPLMutexHolderD( &hReadDirCacheMutex );
+        if( nGeneration != nReadDirCacheGeneration )
+            return papszFiles;
+        if( poReadDirCache == NULL )
+            poReadDirCache = new std::map<CPLString, VSIReadDirCacheEntry>();
+
+        // Bound the size of the cache, first by discarding expired entries.
+        const size_t nMaxEntries = 1024;
+        if( poReadDirCache->size() >= nMaxEntries )
+        {
+            std::map<CPLString, VSIReadDirCacheEntry>::iterator oIter =
+                poReadDirCache->begin();
+            while( oIter != poReadDirCache->end() )
+            {
+                std::map<CPLString, VSIReadDirCacheEntry>::iterator oCur =
+                                                                oIter++;
+                if( nNow < oCur->second.nTime ||
+                    nNow - oCur->second.nTime >= nTTL )
+                    VSIReadDirCacheRemove_unlocked( oCur );
+            }
+            if( poReadDirCache->size() >= nMaxEntries )
+                VSIReadDirCacheRemove_unlocked( poReadDirCache->begin() );
+        }
+
+        VSIReadDirCacheEntry sEntry;
+        sEntry.papszFiles = CSLDuplicate( papszFiles );
+        sEntry.nMaxFiles = nMaxFiles;
+        sEntry.nTime = nNow;
+        (*poReadDirCache)[pszPath] = sEntry;
+    }
+
+    return papszFiles;
+}
+
+/************************************************************************/
+/*                     VSIInvalidateReadDirCache()                      */
+/*                                                                      */
+/*      Invalidate the cached listings of the directory of pszPath,     */
+/*      and of pszPath itself in case it is a directory.                */
+/*                                                                      */
+/*      The generation must be incremented even if nothing is cached    */
+/*      yet, since a listing may be being read by another thread.       */
+/************************************************************************/
+
+void VSIInvalidateReadDirCache( const char* pszPath )
+{
+    CPLMutexHolderD( &hReadDirCacheMutex );
+    nReadDirCacheGeneration ++;
+    if( poReadDirCache == NULL )
+        return;
+
+    std::map<CPLString, VSIReadDirCacheEntry>::iterator oIter =
+        poReadDirCache->find( CPLGetDirname(pszPath) );
+    if( oIter != poReadDirCache->end() )
+        VSIReadDirCacheRemove_unlocked( oIter );
+    oIter = poReadDirCache->find( pszPath );
+    if( oIter != poReadDirCache->end() )
+        VSIReadDirCacheRemove_unlocked( oIter );
+}
+
+/************************************************************************/
+/*                        VSIFlushReadDirCache()                        */
+/************************************************************************/
+
+/**
+ * \brief Empty the cache of directory listings of VSIReadDirCached().
+ *
+ * @since GDAL 2.2
+ */
+
+void VSIFlushReadDirCache()
+{
+    CPLMutexHolderD( &hReadDirCacheMutex );
+    nReadDirCacheGeneration ++;
+    if( poReadDirCache != NULL )
+    {
+        while( !poReadDirCache->empty() )
+            VSIReadDirCacheRemove_unlocked( poReadDirCache->begin() );
+        delete poReadDirCache;
+        poReadDirCache = NULL;
+    }
+}
+
 /************************************************************************/
 /*                             VSIReadRecursive()                       */
 /************************************************************************/
@@ -305,7 +468,9 @@ int VSIMkdir( const char *pszPathname, long mode )
     VSIFilesystemHandler *poFSHandler =
         VSIFileManager::GetHandler( pszPathname );
 
-    return poFSHandler->Mkdir( pszPathname, mode );
+    const int nRet = poFSHandler->Mkdir( pszPathname, mode );
+    VSIInvalidateReadDirCache( pszPathname );
+    return nRet;
 }
 
 /************************************************************************/
@@ -333,7 +498,9 @@ int VSIUnlink( const char * pszFilename )
     VSIFilesystemHandler *poFSHandler =
         VSIFileManager::GetHandler( pszFilename );
 
-    return poFSHandler->Unlink( pszFilename );
+    const int nRet = poFSHandler->Unlink( pszFilename );
+    VSIInvalidateReadDirCache( pszFilename );
+    return nRet;
 }
 
 /************************************************************************/
@@ -364,7 +531,10 @@ int VSIRename( const char * oldpath, const char * newpath )
     VSIFilesystemHandler *poFSHandler =
         VSIFileManager::GetHandler( oldpath );
 
-    return poFSHandler->Rename( oldpath, newpath );
+    const int nRet = poFSHandler->Rename( oldpath, newpath );
+    VSIInvalidateReadDirCache( oldpath );
+    VSIInvalidateReadDirCache( newpath );
+    return nRet;
 }
 
 /************************************************************************/
@@ -393,7 +563,9 @@ int VSIRmdir( const char * pszDirname )
     VSIFilesystemHandler *poFSHandler =
         VSIFileManager::GetHandler( pszDirname );
 
-    return poFSHandler->Rmdir( pszDirname );
+    const int nRet = poFSHandler->Rmdir( pszDirname );
+    VSIInvalidateReadDirCache( pszDirname );
+    return nRet;
 }
 
 /************************************************************************/
@@ -553,6 +725,10 @@ VSILFILE *VSIFOpenL( const char * pszFilename, const char * pszAccess )
 
     VSIDebug3( "VSIFOpenL(%s,%s) = %p", pszFilename, pszAccess, fp );
 
+    // The file may have been created
+    if( strchr(pszAccess, 'w') || strchr(pszAccess, 'a') )
+        VSIInvalidateReadDirCache( pszFilename );
+
     return fp;
 }
 
@@ -1323,6 +1499,13 @@ void VSICleanupFileManager()
         CPLDestroyMutex(hVSIFileManagerMutex);
         hVSIFileManagerMutex = NULL;
     }
+
+    VSIFlushReadDirCache();
+    if( hReadDirCacheMutex != NULL )
+    {
+        CPLDestroyMutex(hReadDirCacheMutex);
+        hReadDirCacheMutex = NULL;
+    }
 }
 
 /************************************************************************/